@@ -25,6 +25,7 @@
 #include "index/index_factory.h"
 #include "storage/data_table.h"
 #include "storage/tile_group.h"
+#include "tcop/plan_cache.h"
 #include "wire/packet_manager.h"
 
 namespace peloton {
@@ -390,6 +391,8 @@ void IndexTuner::AddIndexes(
         for (auto pm : wire::PacketManager::GetPacketManagers()) {
           pm->InvalidatePreparedStatements(index->GetMetadata()->GetTableOid());
         }  // FOR
+        tcop::PlanCache::GetInstance().InvalidateTable(
+            index->GetMetadata()->GetTableOid());
       }
     }
   }
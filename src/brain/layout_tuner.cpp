@@ -20,6 +20,8 @@
 #include "common/logger.h"
 #include "common/timer.h"
 #include "storage/data_table.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
 
 namespace peloton {
 namespace brain {
@@ -29,9 +31,7 @@ LayoutTuner& LayoutTuner::GetInstance() {
   return layout_tuner;
 }
 
-LayoutTuner::LayoutTuner() {
-  // Nothing to do here !
-}
+LayoutTuner::LayoutTuner() : layout_tuning_stop(false) {}
 
 LayoutTuner::~LayoutTuner() {}
 
@@ -150,22 +150,85 @@ void LayoutTuner::UpdateDefaultPartition(storage::DataTable* table) {
   table->SetDefaultLayout(layout);
 }
 
+void LayoutTuner::TransformTileGroups(storage::DataTable* table,
+                                      bool decay) {
+  oid_t column_count = table->GetSchema()->GetColumnCount();
+  storage::column_map_type row_layout, column_layout;
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    row_layout[column_itr] = std::make_pair(0, column_itr);
+    column_layout[column_itr] = std::make_pair(column_itr, 0);
+  }
+  auto default_layout = table->GetDefaultLayout();
+  if (default_layout != row_layout) {
+    column_layout = default_layout;
+  }
+
+  Timer<std::micro> timer;
+  auto tile_group_count = table->GetTileGroupCount();
+  for (oid_t tile_group_offset = 0; tile_group_offset < tile_group_count;
+       tile_group_offset++) {
+    if (layout_tuning_stop == true) {
+      return;
+    }
+
+    auto tile_group = table->GetTileGroup(tile_group_offset);
+    if (tile_group == nullptr) {
+      continue;
+    }
+    auto tile_group_header = tile_group->GetHeader();
+    auto write_count = tile_group_header->GetWriteCount();
+    auto read_count = tile_group_header->GetReadCount();
+    if (decay == true) {
+      tile_group_header->DecayAccessCounts();
+    }
+
+    const storage::column_map_type* layout = nullptr;
+    if (write_count >= hot_write_count) {
+      layout = &row_layout;
+    } else if (read_count >= cold_read_count) {
+      layout = &column_layout;
+    } else {
+      continue;
+    }
+
+    timer.Reset();
+    timer.Start();
+    auto new_tile_group =
+        table->TransformTileGroup(tile_group_offset, *layout, theta);
+    timer.Stop();
+
+    if (new_tile_group != nullptr) {
+      LOG_TRACE("Transformed tile group at offset %u to %s layout",
+                tile_group_offset, layout == &row_layout ? "row" : "column");
+
+      // Stay within the budget
+      auto idle_duration = timer.GetDuration() * (1 - cpu_budget) / cpu_budget;
+      std::this_thread::sleep_for(
+          std::chrono::microseconds(static_cast<int64_t>(idle_duration)));
+    }
+  }
+}
+
 void LayoutTuner::Tune() {
-  Timer<std::milli> timer;
+  last_decay_time = std::chrono::steady_clock::now();
+
   // Continue till signal is not false
   while (layout_tuning_stop == false) {
+    auto now = std::chrono::steady_clock::now();
+    bool decay =
+        (now - last_decay_time >= std::chrono::milliseconds(decay_period));
+    if (decay == true) {
+      last_decay_time = now;
+    }
+
     // Go over all tables
     for (auto table : tables) {
-      // Transform
-      auto tile_group_count = table->GetTileGroupCount();
-      auto tile_group_offset = rand() % tile_group_count;
-
-      LOG_TRACE("Transforming tile group at offset: %lu", tile_group_offset);
-      table->TransformTileGroup(tile_group_offset, theta);
-
       // Update partitioning periodically
       UpdateDefaultPartition(table);
 
+      // Transform the tile groups whose accesses changed
+      TransformTileGroups(table, decay);
+
       // Sleep a bit
       std::this_thread::sleep_for(std::chrono::microseconds(sleep_duration));
     }
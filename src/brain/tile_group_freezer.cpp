@@ -0,0 +1,108 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_group_freezer.cpp
+//
+// Identification: src/brain/tile_group_freezer.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "brain/tile_group_freezer.h"
+
+#include <chrono>
+
+#include "catalog/catalog.h"
+#include "common/logger.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "storage/data_table.h"
+#include "storage/database.h"
+
+namespace peloton {
+namespace brain {
+
+TileGroupFreezer &TileGroupFreezer::GetInstance() {
+  static TileGroupFreezer tile_group_freezer;
+  return tile_group_freezer;
+}
+
+TileGroupFreezer::TileGroupFreezer() {
+  // Nothing to do here !
+}
+
+TileGroupFreezer::~TileGroupFreezer() {}
+
+void TileGroupFreezer::Start() {
+  // Set signal
+  freezing_stop = false;
+
+  // Launch thread
+  freezer_thread = std::thread(&brain::TileGroupFreezer::Freeze, this);
+
+  LOG_INFO("Started tile group freezer");
+}
+
+void TileGroupFreezer::Freeze() {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto catalog = catalog::Catalog::GetInstance();
+
+  // Continue till signal is not false
+  while (freezing_stop == false) {
+    size_t frozen_count = 0;
+
+    auto database_count = catalog->GetDatabaseCount();
+    for (oid_t database_offset = 0; database_offset < database_count;
+         database_offset++) {
+      auto database = catalog->GetDatabaseWithOffset(database_offset);
+      if (database->GetDBName() == CATALOG_DATABASE_NAME) {
+        continue;
+      }
+
+      auto table_count = database->GetTableCount();
+      for (oid_t table_offset = 0; table_offset < table_count;
+           table_offset++) {
+        auto table = database->GetTable(table_offset);
+        frozen_count +=
+            FreezeTable(table, txn_manager.GetMaxCommittedCid());
+      }
+    }
+
+    if (frozen_count > 0) {
+      LOG_DEBUG("Froze %lu tile groups", frozen_count);
+    }
+
+    // Sleep a bit
+    std::this_thread::sleep_for(std::chrono::milliseconds(sleep_duration));
+  }
+}
+
+void TileGroupFreezer::Stop() {
+  // Stop freezing
+  freezing_stop = true;
+
+  // Stop thread
+  freezer_thread.join();
+
+  LOG_INFO("Stopped tile group freezer");
+}
+
+size_t TileGroupFreezer::FreezeTable(storage::DataTable *table,
+                                     const cid_t max_cid) {
+  size_t frozen_count = 0;
+
+  // The last tile groups still receive inserts, FreezeTileGroup skips the
+  // ones that are not full
+  auto tile_group_count = table->GetTileGroupCount();
+  for (oid_t tile_group_offset = 0; tile_group_offset < tile_group_count;
+       tile_group_offset++) {
+    if (table->FreezeTileGroup(tile_group_offset, max_cid) != nullptr) {
+      frozen_count++;
+    }
+  }
+  return frozen_count;
+}
+
+}  // End brain namespace
+}  // End peloton namespace
@@ -19,6 +19,7 @@
 #include "expression/string_functions.h"
 #include "expression/date_functions.h"
 #include "index/index_factory.h"
+#include "tcop/plan_cache.h"
 #include "util/string_util.h"
 
 namespace peloton {
@@ -62,6 +63,11 @@ void Catalog::CreateMetricsCatalog() {
   auto query_metrics_catalog = CreateMetricsCatalog(default_db_oid,
       QUERY_METRIC_NAME);
   default_db->AddTable(query_metrics_catalog.release(), true);
+
+  // Create table for the statistics ANALYZE collects
+  auto column_stats_catalog = CreateMetricsCatalog(default_db_oid,
+      COLUMN_STATS_NAME);
+  default_db->AddTable(column_stats_catalog.release(), true);
   LOG_TRACE("Metrics tables created");
 }
 
@@ -332,6 +338,9 @@ ResultType Catalog::DropDatabaseWithName(std::string database_name,
     // Drop the database
     LOG_TRACE("Deleting database from database vector");
     databases_.erase(databases_.begin() + database_offset);
+
+    // Cached plans only know the oids of their tables
+    tcop::PlanCache::GetInstance().Clear();
   } catch (CatalogException &e) {
     LOG_TRACE("Database is not found!");
     return ResultType::FAILURE;
@@ -362,6 +371,9 @@ void Catalog::DropDatabaseWithOid(const oid_t database_oid) {
     // Drop the database
     LOG_TRACE("Deleting database from database vector");
     databases_.erase(databases_.begin() + database_offset);
+
+    // Cached plans only know the oids of their tables
+    tcop::PlanCache::GetInstance().Clear();
   } catch (CatalogException &e) {
     LOG_TRACE("Database is not found!");
   }
@@ -519,6 +531,8 @@ std::unique_ptr<storage::DataTable> Catalog::CreateMetricsCatalog(
     schema = InitializeDatabaseMetricsSchema().release();
   } else if (table_name == INDEX_METRIC_NAME) {
     schema = InitializeIndexMetricsSchema().release();
+  } else if (table_name == COLUMN_STATS_NAME) {
+    schema = InitializeColumnStatsSchema().release();
   }
 
   std::unique_ptr<storage::DataTable> table(
@@ -744,6 +758,61 @@ std::unique_ptr<catalog::Schema> Catalog::InitializeQueryMetricsSchema() {
   return database_schema;
 }
 
+// Initialize column statistics schema
+std::unique_ptr<catalog::Schema> Catalog::InitializeColumnStatsSchema() {
+  const std::string not_null_constraint_name = "not_null";
+  catalog::Constraint not_null_constraint(ConstraintType::NOTNULL,
+      not_null_constraint_name);
+  oid_t integer_type_size = type::Type::GetTypeSize(type::Type::INTEGER);
+  oid_t bigint_type_size = type::Type::GetTypeSize(type::Type::BIGINT);
+  oid_t decimal_type_size = type::Type::GetTypeSize(type::Type::DECIMAL);
+  oid_t varchar_type_size = type::Type::GetTypeSize(type::Type::VARCHAR);
+
+  type::Type::TypeId integer_type = type::Type::INTEGER;
+  type::Type::TypeId bigint_type = type::Type::BIGINT;
+  type::Type::TypeId decimal_type = type::Type::DECIMAL;
+  type::Type::TypeId varchar_type = type::Type::VARCHAR;
+
+  // The table id comes first, the rows of a table are deleted by it
+  auto table_id_column = catalog::Column(integer_type, integer_type_size,
+      "table_id", true);
+  table_id_column.AddConstraint(not_null_constraint);
+  auto database_id_column = catalog::Column(integer_type, integer_type_size,
+      "database_id", true);
+  database_id_column.AddConstraint(not_null_constraint);
+  auto column_id_column = catalog::Column(integer_type, integer_type_size,
+      "column_id", true);
+  column_id_column.AddConstraint(not_null_constraint);
+
+  auto num_rows_column = catalog::Column(bigint_type, bigint_type_size,
+      "num_rows", true);
+  num_rows_column.AddConstraint(not_null_constraint);
+  auto modification_count_column = catalog::Column(bigint_type,
+      bigint_type_size, "modification_count", true);
+  modification_count_column.AddConstraint(not_null_constraint);
+  auto null_frac_column = catalog::Column(decimal_type, decimal_type_size,
+      "null_frac", true);
+  null_frac_column.AddConstraint(not_null_constraint);
+  auto num_distinct_column = catalog::Column(decimal_type, decimal_type_size,
+      "num_distinct", true);
+  num_distinct_column.AddConstraint(not_null_constraint);
+
+  // Lists of values, see optimizer::StatsStorage for the format
+  auto most_common_vals_column = catalog::Column(varchar_type,
+      varchar_type_size, "most_common_vals", false);
+  auto most_common_freqs_column = catalog::Column(varchar_type,
+      varchar_type_size, "most_common_freqs", false);
+  auto histogram_bounds_column = catalog::Column(varchar_type,
+      varchar_type_size, "histogram_bounds", false);
+
+  std::unique_ptr<catalog::Schema> column_stats_schema(new catalog::Schema( {
+      table_id_column, database_id_column, column_id_column, num_rows_column,
+      modification_count_column, null_frac_column, num_distinct_column,
+      most_common_vals_column, most_common_freqs_column,
+      histogram_bounds_column }));
+  return column_stats_schema;
+}
+
 void Catalog::PrintCatalogs() {
 }
 
@@ -267,5 +267,42 @@ std::unique_ptr<storage::Tuple> GetTableCatalogTuple(
   tuple->SetValue(3, val4, pool);
   return std::move(tuple);
 }
+
+/**
+ * Generate a column statistics tuple
+ * Input: The table schema, the analyzed table and column, and the statistics
+ * of the column
+ * Returns: The generated tuple
+ */
+std::unique_ptr<storage::Tuple> GetColumnStatsCatalogTuple(
+    const catalog::Schema *schema, oid_t table_id, oid_t database_id,
+    oid_t column_id, int64_t num_rows, int64_t modification_count,
+    double null_frac, double num_distinct,
+    const std::string &most_common_vals,
+    const std::string &most_common_freqs,
+    const std::string &histogram_bounds, type::AbstractPool *pool) {
+  std::unique_ptr<storage::Tuple> tuple(new storage::Tuple(schema, true));
+  auto val1 = type::ValueFactory::GetIntegerValue(table_id);
+  auto val2 = type::ValueFactory::GetIntegerValue(database_id);
+  auto val3 = type::ValueFactory::GetIntegerValue(column_id);
+  auto val4 = type::ValueFactory::GetBigIntValue(num_rows);
+  auto val5 = type::ValueFactory::GetBigIntValue(modification_count);
+  auto val6 = type::ValueFactory::GetDecimalValue(null_frac);
+  auto val7 = type::ValueFactory::GetDecimalValue(num_distinct);
+  auto val8 = type::ValueFactory::GetVarcharValue(most_common_vals, nullptr);
+  auto val9 = type::ValueFactory::GetVarcharValue(most_common_freqs, nullptr);
+  auto val10 = type::ValueFactory::GetVarcharValue(histogram_bounds, nullptr);
+  tuple->SetValue(0, val1, nullptr);
+  tuple->SetValue(1, val2, nullptr);
+  tuple->SetValue(2, val3, nullptr);
+  tuple->SetValue(3, val4, nullptr);
+  tuple->SetValue(4, val5, nullptr);
+  tuple->SetValue(5, val6, nullptr);
+  tuple->SetValue(6, val7, nullptr);
+  tuple->SetValue(7, val8, pool);
+  tuple->SetValue(8, val9, pool);
+  tuple->SetValue(9, val10, pool);
+  return std::move(tuple);
+}
 }
 }
@@ -0,0 +1,99 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// arena.cpp
+//
+// Identification: src/common/arena.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/arena.h"
+
+#include <algorithm>
+#include <new>
+
+namespace peloton {
+
+namespace {
+
+thread_local Arena *active_arena = nullptr;
+
+// Every ArenaAllocated object is preceded by the arena it lives in, so that
+// delete can tell arena objects from heap objects
+struct AllocationHeader {
+  Arena *arena;
+  char padding[Arena::alignment - sizeof(Arena *)];
+};
+
+static_assert(sizeof(AllocationHeader) == Arena::alignment,
+              "allocation header breaks the alignment");
+
+}  // namespace
+
+Arena::Arena(size_t block_size, size_t max_block_size)
+    : block_size_(block_size),
+      max_block_size_(std::max(block_size, max_block_size)) {}
+
+Arena::~Arena() {
+  for (auto block : blocks_) {
+    delete[] block;
+  }
+}
+
+void *Arena::Allocate(size_t size) {
+  size = (size + alignment - 1) & ~(alignment - 1);
+  if (size > block_remaining_) {
+    // Large requests get a block of their own, the current one stays usable
+    if (size > block_size_ / 4) {
+      blocks_.push_back(new char[size]);
+      allocated_bytes_ += size;
+      return blocks_.back();
+    }
+    if (blocks_.empty() == false) {
+      block_size_ = std::min(block_size_ * 2, max_block_size_);
+    }
+    blocks_.push_back(new char[block_size_]);
+    block_ptr_ = blocks_.back();
+    block_remaining_ = block_size_;
+  }
+
+  void *ptr = block_ptr_;
+  block_ptr_ += size;
+  block_remaining_ -= size;
+  allocated_bytes_ += size;
+  return ptr;
+}
+
+Arena *Arena::GetActive() { return active_arena; }
+
+Arena::Scope::Scope(Arena *arena) : previous_(active_arena) {
+  active_arena = arena;
+}
+
+Arena::Scope::~Scope() { active_arena = previous_; }
+
+void *ArenaAllocated::operator new(size_t size) {
+  auto arena = Arena::GetActive();
+  size_t total_size = sizeof(AllocationHeader) + size;
+  void *ptr = (arena != nullptr) ? arena->Allocate(total_size)
+                                 : ::operator new(total_size);
+
+  auto header = static_cast<AllocationHeader *>(ptr);
+  header->arena = arena;
+  return header + 1;
+}
+
+void ArenaAllocated::operator delete(void *ptr) {
+  if (ptr == nullptr) {
+    return;
+  }
+  auto header = static_cast<AllocationHeader *>(ptr) - 1;
+  if (header->arena == nullptr) {
+    ::operator delete(header);
+  }
+}
+
+}  // End peloton namespace
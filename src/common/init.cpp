@@ -18,6 +18,7 @@
 
 #include "brain/index_tuner.h"
 #include "brain/layout_tuner.h"
+#include "brain/tile_group_freezer.h"
 #include "concurrency/epoch_manager_factory.h"
 #include "gc/gc_manager_factory.h"
 #include "storage/data_table.h"
@@ -36,8 +37,10 @@ void PelotonInit::Initialize() {
   GC_THREAD_COUNT = 1;
   EPOCH_THREAD_COUNT = 1;
 
-  // set max thread number.
-  thread_pool.Initialize(0, std::thread::hardware_concurrency() + 3);
+  // set max thread number. the pool threads execute the statements of the
+  // network connections.
+  thread_pool.Initialize(QUERY_THREAD_COUNT,
+                         std::thread::hardware_concurrency() + 3);
 
   int parallelism = (std::thread::hardware_concurrency() + 1) / 2;
   storage::DataTable::SetActiveTileGroupCount(parallelism);
@@ -63,6 +66,12 @@ void PelotonInit::Initialize() {
     layout_tuner.Start();
   }
 
+  // start tile group freezer
+  if (FLAGS_tile_group_freezer == true) {
+    auto& tile_group_freezer = brain::TileGroupFreezer::GetInstance();
+    tile_group_freezer.Start();
+  }
+
   // initialize the catalog and add the default database, so we don't do this on
   // the first query
   catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, nullptr);
@@ -81,6 +90,12 @@ void PelotonInit::Shutdown() {
     layout_tuner.Stop();
   }
 
+  // shut down tile group freezer
+  if (FLAGS_tile_group_freezer == true) {
+    auto& tile_group_freezer = brain::TileGroupFreezer::GetInstance();
+    tile_group_freezer.Stop();
+  }
+
   // shut down GC.
   gc::GCManagerFactory::GetInstance().StopGC();
 
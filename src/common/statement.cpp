@@ -13,13 +13,16 @@
 #include "common/statement.h"
 #include <cstdio>
 #include "common/logger.h"
+#include "executor/plan_executor.h"
 #include "planner/abstract_plan.h"
 
 namespace peloton {
 
 Statement::Statement(const std::string& statement_name,
                      const std::string& query_string)
-    : statement_name_(statement_name), query_string_(query_string) {
+    : statement_name_(statement_name),
+      query_string_(query_string),
+      executor_trees_(new bridge::ExecutorTreeCache()) {
   ParseQueryType(query_string_, query_type_);
 }
 
@@ -61,6 +64,8 @@ void Statement::SetTupleDescriptor(
 }
 
 void Statement::SetPlanTree(std::shared_ptr<planner::AbstractPlan> plan_tree) {
+  // The executors point to the nodes of the old plan
+  executor_trees_->Clear();
   plan_tree_ = std::move(plan_tree);
 }
 
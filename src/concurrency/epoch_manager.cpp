@@ -11,11 +11,300 @@
 //===----------------------------------------------------------------------===//
 
 
+#include <algorithm>
+
 #include "concurrency/epoch_manager.h"
 
 namespace peloton {
 namespace concurrency {
 
-//  volatile cid_t EpochManager::curr_epoch_ = 1;
+const size_t EpochManager::safety_interval_;
+const size_t EpochManager::max_slot_count_;
+const size_t EpochManager::max_epoch_;
+
+namespace {
+
+// The epoch slot of the current thread, released when the thread exits or
+// moves on to another manager
+struct ThreadEpochSlot {
+  std::shared_ptr<EpochSlotArray> slot_array;
+  EpochSlot *slot = nullptr;
+  size_t slot_id = 0;
+
+  // False if the slot is shared with other threads
+  bool owned = false;
+
+  void Release() {
+    if (slot != nullptr && owned == true) {
+      slot->in_use_ = false;
+    }
+    slot_array.reset();
+    slot = nullptr;
+    owned = false;
+  }
+
+  ~ThreadEpochSlot() { Release(); }
+};
+
+thread_local ThreadEpochSlot thread_epoch_slot;
+
+}
+
+EpochSlot::EpochSlot()
+    : rw_epoch_(std::numeric_limits<size_t>::max()),
+      ro_epoch_(std::numeric_limits<size_t>::max()),
+      history_head_(0),
+      in_use_(false) {
+  for (size_t i = 0; i < EPOCH_SLOT_HISTORY_SIZE; ++i) {
+    history_epochs_[i] = std::numeric_limits<size_t>::max();
+    history_cids_[i] = 0;
+  }
+}
+
+EpochSlotArray::EpochSlotArray() : slot_count_(0) {
+  for (auto &slot : slots_) {
+    slot = nullptr;
+  }
+}
+
+EpochSlotArray::~EpochSlotArray() {
+  for (auto &slot : slots_) {
+    delete slot.load();
+  }
+}
+
+EpochManager::EpochManager()
+    : slot_array_(std::make_shared<EpochSlotArray>()),
+      current_epoch_(0),
+      queue_tail_(0),
+      reclaim_tail_(0),
+      tails_epoch_(0),
+      tails_token_(true),
+      max_cid_ro_(READ_ONLY_START_CID),
+      max_cid_gc_(0),
+      is_running_(false) {}
+
+EpochManager::~EpochManager() {}
+
+size_t EpochManager::EnterEpoch(cid_t begin_cid) {
+  size_t slot_id;
+  auto slot = GetThreadSlot(slot_id);
+  auto epoch = current_epoch_.load();
+
+  slot->lock_.Lock();
+  slot->rw_epochs_.push_back(epoch);
+  if (epoch < slot->rw_epoch_.load(std::memory_order_relaxed)) {
+    slot->rw_epoch_.store(epoch);
+  }
+  RecordMaxCid(slot, epoch, begin_cid);
+  slot->lock_.Unlock();
+
+  return GetEpochId(epoch, slot_id);
+}
+
+size_t EpochManager::EnterReadOnlyEpoch(UNUSED_ATTRIBUTE cid_t begin_cid) {
+  size_t slot_id;
+  auto slot = GetThreadSlot(slot_id);
+
+  // Read-only txns live in the queue tail epoch, their begin cid is never
+  // larger than the cids already recorded for older epochs
+  auto epoch = queue_tail_.load();
+
+  slot->lock_.Lock();
+  slot->ro_epochs_.push_back(epoch);
+  if (epoch < slot->ro_epoch_.load(std::memory_order_relaxed)) {
+    slot->ro_epoch_.store(epoch);
+  }
+  slot->lock_.Unlock();
+
+  return GetEpochId(epoch, slot_id);
+}
+
+void EpochManager::ExitEpoch(size_t epoch_id) {
+  auto slot = slot_array_->slots_[epoch_id % max_slot_count_].load();
+  auto epoch = epoch_id / max_slot_count_;
+  PL_ASSERT(slot != nullptr);
+
+  slot->lock_.Lock();
+  auto &epochs = slot->rw_epochs_;
+  auto itr = std::find(epochs.begin(), epochs.end(), epoch);
+  PL_ASSERT(itr != epochs.end());
+  *itr = epochs.back();
+  epochs.pop_back();
+  slot->rw_epoch_.store(epochs.empty()
+                            ? max_epoch_
+                            : *std::min_element(epochs.begin(), epochs.end()));
+  slot->lock_.Unlock();
+}
+
+void EpochManager::ExitReadOnlyEpoch(size_t epoch_id) {
+  auto slot = slot_array_->slots_[epoch_id % max_slot_count_].load();
+  auto epoch = epoch_id / max_slot_count_;
+  PL_ASSERT(slot != nullptr);
+
+  slot->lock_.Lock();
+  auto &epochs = slot->ro_epochs_;
+  auto itr = std::find(epochs.begin(), epochs.end(), epoch);
+  PL_ASSERT(itr != epochs.end());
+  *itr = epochs.back();
+  epochs.pop_back();
+  slot->ro_epoch_.store(epochs.empty()
+                            ? max_epoch_
+                            : *std::min_element(epochs.begin(), epochs.end()));
+  slot->lock_.Unlock();
+}
+
+void EpochManager::Running() {
+
+  PL_ASSERT(is_running_ == true);
+
+  while (is_running_ == true) {
+    // the epoch advances every EPOCH_LENGTH milliseconds.
+    std::this_thread::sleep_for(std::chrono::milliseconds(EPOCH_LENGTH));
+
+    current_epoch_++;
+
+    IncreaseTails();
+  }
+}
+
+void EpochManager::IncreaseTails() {
+  bool expect = true, desired = false;
+  if (!tails_token_.compare_exchange_weak(expect, desired)) {
+    // someone now is increasing tails
+    return;
+  }
+
+  auto current = current_epoch_.load();
+
+  // Find the oldest epochs that still have running txns
+  size_t oldest_rw_epoch = max_epoch_, oldest_ro_epoch = max_epoch_;
+  auto slot_count = std::min(slot_array_->slot_count_.load(), max_slot_count_);
+  for (size_t slot_itr = 0; slot_itr < slot_count; ++slot_itr) {
+    auto slot = slot_array_->slots_[slot_itr].load();
+    if (slot == nullptr) {
+      continue;
+    }
+    oldest_rw_epoch = std::min(oldest_rw_epoch, slot->rw_epoch_.load());
+    oldest_ro_epoch = std::min(oldest_ro_epoch, slot->ro_epoch_.load());
+  }
+
+  // rw txns of the epochs older than the queue tail have all finished
+  size_t queue_tail = (current > safety_interval_)
+                          ? current - safety_interval_ : 0;
+  queue_tail = std::min(queue_tail, oldest_rw_epoch);
+  queue_tail_ = queue_tail;
+
+  // so did all txns of the epochs older than the reclaim tail
+  size_t reclaim_tail = (queue_tail > safety_interval_)
+                            ? queue_tail - safety_interval_ : 0;
+  reclaim_tail = std::min(reclaim_tail, oldest_ro_epoch);
+  reclaim_tail_ = reclaim_tail;
+
+  AtomicMax(max_cid_ro_, GetMaxCidBefore(queue_tail));
+  AtomicMax(max_cid_gc_, GetMaxCidBefore(reclaim_tail));
+  tails_epoch_ = current;
+
+  expect = false;
+  desired = true;
+  tails_token_.compare_exchange_weak(expect, desired);
+}
+
+cid_t EpochManager::GetMaxCidBefore(const size_t epoch) const {
+  cid_t max_cid = 0;
+  auto slot_count = std::min(slot_array_->slot_count_.load(), max_slot_count_);
+  for (size_t slot_itr = 0; slot_itr < slot_count; ++slot_itr) {
+    auto slot = slot_array_->slots_[slot_itr].load();
+    if (slot == nullptr) {
+      continue;
+    }
+    for (size_t i = 0; i < EPOCH_SLOT_HISTORY_SIZE; ++i) {
+      auto entry_epoch = slot->history_epochs_[i].load();
+      if (entry_epoch >= epoch) {
+        continue;
+      }
+      auto entry_cid = slot->history_cids_[i].load();
+      // Skip entries that were reused while we were reading them
+      if (slot->history_epochs_[i].load() != entry_epoch) {
+        continue;
+      }
+      max_cid = std::max(max_cid, entry_cid);
+    }
+  }
+  return max_cid;
+}
+
+void EpochManager::RecordMaxCid(EpochSlot *slot, const size_t epoch,
+                                const cid_t begin_cid) {
+  auto head = slot->history_head_;
+  auto head_epoch = slot->history_epochs_[head].load(std::memory_order_relaxed);
+
+  if (head_epoch != max_epoch_ && epoch <= head_epoch) {
+    // Same epoch as the last txn of this slot, or an older one when the slot
+    // is shared. Every entry covering this epoch has to include the cid.
+    for (size_t i = 0; i < EPOCH_SLOT_HISTORY_SIZE; ++i) {
+      auto entry_epoch =
+          slot->history_epochs_[i].load(std::memory_order_relaxed);
+      if (entry_epoch != max_epoch_ && entry_epoch >= epoch &&
+          slot->history_cids_[i].load(std::memory_order_relaxed) <
+              begin_cid) {
+        slot->history_cids_[i].store(begin_cid);
+      }
+    }
+    return;
+  }
+
+  // Start a new entry, overwriting the oldest one
+  auto max_cid = std::max(
+      begin_cid, slot->history_cids_[head].load(std::memory_order_relaxed));
+  head = (head + 1) % EPOCH_SLOT_HISTORY_SIZE;
+  slot->history_epochs_[head].store(epoch);
+  slot->history_cids_[head].store(max_cid);
+  slot->history_head_ = head;
+}
+
+EpochSlot *EpochManager::GetThreadSlot(size_t &slot_id) {
+  if (thread_epoch_slot.slot_array != slot_array_) {
+    thread_epoch_slot.Release();
+    thread_epoch_slot.slot_id = AcquireSlot(thread_epoch_slot.owned);
+    thread_epoch_slot.slot_array = slot_array_;
+    thread_epoch_slot.slot =
+        slot_array_->slots_[thread_epoch_slot.slot_id].load();
+  }
+  slot_id = thread_epoch_slot.slot_id;
+  return thread_epoch_slot.slot;
+}
+
+size_t EpochManager::AcquireSlot(bool &owned) {
+  owned = true;
+
+  // Reuse the slot of an exited thread
+  auto slot_count = std::min(slot_array_->slot_count_.load(), max_slot_count_);
+  for (size_t slot_itr = 0; slot_itr < slot_count; ++slot_itr) {
+    auto slot = slot_array_->slots_[slot_itr].load();
+    bool expect = false;
+    if (slot != nullptr && slot->in_use_.compare_exchange_strong(expect, true)) {
+      return slot_itr;
+    }
+  }
+
+  auto slot_id = slot_array_->slot_count_.fetch_add(1);
+  if (slot_id >= max_slot_count_) {
+    // Out of slots, share one with another thread
+    LOG_TRACE("Sharing epoch slot");
+    owned = false;
+    slot_id %= max_slot_count_;
+    while (slot_array_->slots_[slot_id].load() == nullptr) {
+      _mm_pause();
+    }
+    return slot_id;
+  }
+
+  auto slot = new EpochSlot();
+  slot->in_use_ = true;
+  slot_array_->slots_[slot_id] = slot;
+  return slot_id;
+}
+
 }
 }
@@ -494,6 +494,8 @@ void TimestampOrderingTransactionManager::PerformInsert(
   // Write down the head pointer's address in tile group header
   tile_group_header->SetIndirection(tuple_id, index_entry_ptr);
 
+  tile_group_header->IncrementWriteCount();
+
   // Increment table insert op stats
   if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
     stats::BackendStatsContext::GetInstance()->IncrementTableInserts(
@@ -588,6 +590,9 @@ void TimestampOrderingTransactionManager::PerformUpdate(
   // Add the old tuple into the update set
   current_txn->RecordUpdate(old_location);
 
+  tile_group_header->IncrementWriteCount();
+  new_tile_group_header->IncrementWriteCount();
+
   // Increment table update op stats
   if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
     stats::BackendStatsContext::GetInstance()->IncrementTableUpdates(
@@ -617,6 +622,8 @@ void TimestampOrderingTransactionManager::PerformUpdate(
     current_txn->RecordUpdate(old_location);
   }
 
+  tile_group_header->IncrementWriteCount();
+
   // Increment table update op stats
   if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
     stats::BackendStatsContext::GetInstance()->IncrementTableUpdates(
@@ -709,6 +716,9 @@ void TimestampOrderingTransactionManager::PerformDelete(
 
   current_txn->RecordDelete(old_location);
 
+  tile_group_header->IncrementWriteCount();
+  new_tile_group_header->IncrementWriteCount();
+
   // Increment table delete op stats
   if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
     stats::BackendStatsContext::GetInstance()->IncrementTableDeletes(
@@ -742,6 +752,8 @@ void TimestampOrderingTransactionManager::PerformDelete(
     current_txn->RecordDelete(location);
   }
 
+  tile_group_header->IncrementWriteCount();
+
   // Increment table delete op stats
   if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
     stats::BackendStatsContext::GetInstance()->IncrementTableDeletes(
@@ -785,6 +797,8 @@ ResultType TimestampOrderingTransactionManager::CommitTransaction(
     oid_t tile_group_id = tile_group_entry.first;
     auto tile_group = manager.GetTileGroup(tile_group_id);
     auto tile_group_header = tile_group->GetHeader();
+    // inserts into the tile group are logged together
+    std::vector<oid_t> inserted_tuple_slots;
     for (auto &tuple_entry : tile_group_entry.second) {
       auto tuple_slot = tuple_entry.first;
       if (tuple_entry.second == RWType::READ_OWN) {
@@ -876,8 +890,7 @@ ResultType TimestampOrderingTransactionManager::CommitTransaction(
         // nothing to be added to gc set.
 
         // add to log manager
-        log_manager.LogInsert(end_commit_id,
-                              ItemPointer(tile_group_id, tuple_slot));
+        inserted_tuple_slots.push_back(tuple_slot);
 
       } else if (tuple_entry.second == RWType::INS_DEL) {
         PL_ASSERT(tile_group_header->GetTransactionId(tuple_slot) ==
@@ -898,6 +911,7 @@ ResultType TimestampOrderingTransactionManager::CommitTransaction(
         // no log is needed for this case
       }
     }
+    log_manager.LogInserts(end_commit_id, tile_group_id, inserted_tuple_slots);
   }
 
   ResultType result = current_txn->GetResult();
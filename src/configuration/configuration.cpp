@@ -37,6 +37,9 @@ void PrintConfiguration(){
   LOG_INFO("%30s: %10s","Socket Family", FLAGS_socket_family.c_str());
   LOG_INFO("%30s: %10lu","Statistics", FLAGS_stats_mode);
   LOG_INFO("%30s: %10lu","Max Connections", FLAGS_max_connections);
+  LOG_INFO("%30s: %10lu","Acceptors", FLAGS_acceptor_count);
+  LOG_INFO("%30s: %10lu","Query Memory Limit", FLAGS_query_memory_limit);
+  LOG_INFO("%30s: %10s","Spill Directory", FLAGS_spill_directory.c_str());
 
   LOG_INFO(" ");
   LOG_INFO("%30s", "//===---------------------------------------------------===//");
@@ -66,10 +69,25 @@ DEFINE_string(socket_family,
               "AF_INET",
               "Socket family (default: AF_INET)");
 
+DEFINE_uint64(acceptor_count,
+              1,
+              "Number of threads accepting connections, each on its own "
+              "SO_REUSEPORT socket (default: 1)");
+
 //===----------------------------------------------------------------------===//
 // RESOURCE USAGE
 //===----------------------------------------------------------------------===//
 
+DEFINE_uint64(query_memory_limit,
+              1UL << 30,
+              "Bytes of memory the hash joins and aggregations of a query may "
+              "use before they spill to disk (default: 1 GB)");
+
+DEFINE_string(spill_directory,
+              "/tmp",
+              "Directory of the temporary files of spilling operators "
+              "(default: /tmp)");
+
 //===----------------------------------------------------------------------===//
 // WRITE AHEAD LOG
 //===----------------------------------------------------------------------===//
@@ -106,6 +124,10 @@ DEFINE_bool(layout_tuner,
             false,
             "Enable layout tuner (default: false)");
 
+DEFINE_bool(tile_group_freezer,
+            false,
+            "Compress cold tile groups in the background (default: false)");
+
 // Layout mode
 int peloton_layout_mode = peloton::LAYOUT_TYPE_ROW;
 
@@ -10,6 +10,10 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+
 #include "type/value.h"
 #include "common/logger.h"
 #include "executor/abstract_executor.h"
@@ -90,11 +94,64 @@ bool AbstractExecutor::Execute() {
   // TODO In the future, we might want to pass some kind of executor state to
   // GetNextTile. e.g. params for prepared plans.
 
+  if (executor_context_ == nullptr ||
+      executor_context_->IsProfilingEnabled() == false) {
+    return DExecute();
+  }
+
+  auto start = std::chrono::steady_clock::now();
   bool status = DExecute();
+  auto end = std::chrono::steady_clock::now();
+
+  profile_.execute_time_ns +=
+      std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+          .count();
+  profile_.execute_calls++;
+  if (status == true && output.get() != nullptr) {
+    profile_.tiles_out++;
+    profile_.rows_out += output->GetTupleCount();
+  }
 
   return status;
 }
 
+uint64_t AbstractExecutor::GetRowsIn() const {
+  uint64_t rows_in = 0;
+  for (auto child : children_) {
+    rows_in += child->GetProfile().rows_out;
+  }
+  return rows_in;
+}
+
+/**
+ * @brief Renders the profile of this executor and its children.
+ *
+ * Each executor gets one line, indented by its depth in the tree.
+ */
+std::string AbstractExecutor::GetProfileInfo(int depth) const {
+  std::ostringstream os;
+
+  os << std::string(depth * 2, ' ') << "-> "
+     << PlanNodeTypeToString(node_->GetPlanNodeType()) << " (time="
+     << std::fixed << std::setprecision(3)
+     << profile_.execute_time_ns / 1000000.0 << " ms"
+     << " rows_in=" << GetRowsIn() << " rows_out=" << profile_.rows_out
+     << " tiles=" << profile_.tiles_out << " calls=" << profile_.execute_calls;
+  if (profile_.hash_table_entries != 0) {
+    os << " hash_entries=" << profile_.hash_table_entries;
+  }
+  if (profile_.spill_bytes != 0) {
+    os << " spill_bytes=" << profile_.spill_bytes;
+  }
+  os << ")" << std::endl;
+
+  for (auto child : children_) {
+    os << child->GetProfileInfo(depth + 1);
+  }
+
+  return os.str();
+}
+
 void AbstractExecutor::SetContext(type::Value &value) {
   executor_context_->SetParams(value);
 }
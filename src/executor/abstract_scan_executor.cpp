@@ -18,18 +18,68 @@
 #include <vector>
 
 #include "type/types.h"
+#include "type/value_factory.h"
 #include "executor/logical_tile.h"
 #include "executor/logical_tile_factory.h"
+#include "executor/runtime_filter.h"
 #include "expression/abstract_expression.h"
+#include "expression/tuple_value_expression.h"
 #include "common/container_tuple.h"
 #include "storage/data_table.h"
 #include "storage/tile_group.h"
+#include "storage/zone_map.h"
 
 #include "common/logger.h"
 
 namespace peloton {
 namespace executor {
 
+namespace {
+
+void GetConjuncts(
+    const expression::AbstractExpression *expr,
+    std::vector<const expression::AbstractExpression *> &conjuncts) {
+  if (expr->GetExpressionType() == ExpressionType::CONJUNCTION_AND) {
+    for (size_t child = 0; child < expr->GetChildrenSize(); child++) {
+      GetConjuncts(expr->GetChild(child), conjuncts);
+    }
+  } else {
+    conjuncts.push_back(expr);
+  }
+}
+
+bool IsConstant(const expression::AbstractExpression *expr) {
+  return expr->GetExpressionType() == ExpressionType::VALUE_CONSTANT ||
+         expr->GetExpressionType() == ExpressionType::VALUE_PARAMETER;
+}
+
+bool IsColumn(const expression::AbstractExpression *expr) {
+  return expr->GetExpressionType() == ExpressionType::VALUE_TUPLE;
+}
+
+oid_t GetColumnId(const expression::AbstractExpression *expr) {
+  return static_cast<const expression::TupleValueExpression *>(expr)
+      ->GetColumnId();
+}
+
+// "constant <comparison> column" is "column <mirrored> constant"
+ExpressionType MirrorComparison(const ExpressionType comparison) {
+  switch (comparison) {
+    case ExpressionType::COMPARE_LESSTHAN:
+      return ExpressionType::COMPARE_GREATERTHAN;
+    case ExpressionType::COMPARE_GREATERTHAN:
+      return ExpressionType::COMPARE_LESSTHAN;
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      return ExpressionType::COMPARE_GREATERTHANOREQUALTO;
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      return ExpressionType::COMPARE_LESSTHANOREQUALTO;
+    default:
+      return comparison;
+  }
+}
+
+}  // namespace
+
 /**
  * @brief Constructor
  * @param node AbstractScanNode node corresponding to this executor.
@@ -54,8 +104,125 @@ bool AbstractScanExecutor::DInit() {
 
   column_ids_ = std::move(node.GetColumnIds());
 
+  // Split the predicate into the conjuncts that compare a column with a
+  // constant or a parameter
+  column_comparisons_.clear();
+  only_column_comparisons_ = false;
+  if (predicate_ != nullptr) {
+    std::vector<const expression::AbstractExpression *> conjuncts;
+    GetConjuncts(predicate_, conjuncts);
+
+    only_column_comparisons_ = true;
+    for (auto conjunct : conjuncts) {
+      auto comparison = conjunct->GetExpressionType();
+      if (comparison == ExpressionType::OPERATOR_IS_NULL &&
+          IsColumn(conjunct->GetChild(0))) {
+        column_comparisons_.push_back(
+            {GetColumnId(conjunct->GetChild(0)), comparison,
+             type::ValueFactory::GetNullValueByType(type::Type::BOOLEAN)});
+        continue;
+      }
+      if (conjunct->GetChildrenSize() != 2) {
+        only_column_comparisons_ = false;
+        continue;
+      }
+
+      auto left = conjunct->GetChild(0);
+      auto right = conjunct->GetChild(1);
+      if (IsConstant(left) && IsColumn(right)) {
+        std::swap(left, right);
+        comparison = MirrorComparison(comparison);
+      }
+      if (IsColumn(left) == false || IsConstant(right) == false) {
+        only_column_comparisons_ = false;
+        continue;
+      }
+
+      auto constant = right->Evaluate(nullptr, nullptr, executor_context_);
+      column_comparisons_.push_back(
+          {GetColumnId(left), comparison, constant});
+    }
+  }
+
+  return true;
+}
+
+bool AbstractScanExecutor::MayMatch(storage::TileGroup *tile_group) const {
+  auto zone_map = tile_group->GetZoneMap();
+  for (auto &column_comparison : column_comparisons_) {
+    if (zone_map->MayMatch(column_comparison.column_id,
+                           column_comparison.comparison,
+                           column_comparison.constant) == false) {
+      return false;
+    }
+  }
+
+  // The keys of the tile group must overlap the ones of the join
+  if (runtime_filter_ != nullptr) {
+    if (runtime_filter_->GetKeyCount() == 0) return false;
+
+    type::Value min_value, max_value;
+    for (oid_t key_offset = 0; key_offset < runtime_filter_column_ids_.size();
+         key_offset++) {
+      if (runtime_filter_->GetRange(key_offset, min_value, max_value) ==
+          false) {
+        continue;
+      }
+      auto column_id = runtime_filter_column_ids_[key_offset];
+      if (zone_map->MayMatch(column_id,
+                             ExpressionType::COMPARE_GREATERTHANOREQUALTO,
+                             min_value) == false ||
+          zone_map->MayMatch(column_id,
+                             ExpressionType::COMPARE_LESSTHANOREQUALTO,
+                             max_value) == false) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool AbstractScanExecutor::SetRuntimeFilter(
+    std::shared_ptr<const RuntimeFilter> runtime_filter,
+    const std::vector<oid_t> &key_column_ids) {
+  runtime_filter_.reset();
+  runtime_filter_column_ids_.clear();
+
+  auto table = GetPlanNode<planner::AbstractScan>().GetTable();
+  if (runtime_filter == nullptr || table == nullptr ||
+      children_.empty() == false ||
+      key_column_ids.size() != runtime_filter->GetKeyTypes().size()) {
+    return false;
+  }
+
+  // Map the outputs of the scan to the columns of the table, the values of
+  // which must hash like the keys
+  auto schema = table->GetSchema();
+  std::vector<oid_t> column_ids;
+  for (oid_t key_offset = 0; key_offset < key_column_ids.size();
+       key_offset++) {
+    auto output_column_id = key_column_ids[key_offset];
+    auto column_id = column_ids_.empty() ? output_column_id
+                                         : column_ids_[output_column_id];
+    if (column_id >= schema->GetColumnCount() ||
+        runtime_filter->IsCompatible(key_offset, schema->GetType(column_id)) ==
+            false) {
+      LOG_TRACE("Runtime filter key %u can not be applied", key_offset);
+      return false;
+    }
+    column_ids.push_back(column_id);
+  }
+
+  runtime_filter_ = runtime_filter;
+  runtime_filter_column_ids_ = column_ids;
   return true;
 }
 
+bool AbstractScanExecutor::PassesRuntimeFilter(
+    const AbstractTuple *tuple) const {
+  return runtime_filter_ == nullptr ||
+         runtime_filter_->MayContain(tuple, runtime_filter_column_ids_);
+}
+
 }  // namespace executor
 }  // namespace peloton
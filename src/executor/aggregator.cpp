@@ -64,18 +64,44 @@ AbstractAttributeAggregator::~AbstractAttributeAggregator() {}
 
 void AbstractAttributeAggregator::Advance(const type::Value val) {
   if (is_distinct_) {
-    // Insert a deep copy
-    type::Value val_copy = (val.Copy());
-    distinct_set_.insert(val_copy);
+    if (val.IsNull()) return;
+
+    // Most groups have few values, their tables start with small blocks
+    if (distinct_values_ == nullptr) {
+      distinct_values_.reset(
+          new RowHashTable({val.GetTypeId()}, 0, 0, 1 << 10));
+    }
+    bool inserted;
+    distinct_values_->Insert(val, nullptr, inserted);
   } else {
     DAdvance(val);
   }
 }
 
 type::Value AbstractAttributeAggregator::Finalize() {
-  if (is_distinct_) {
-    for (auto val : distinct_set_) {
-      DAdvance(val);
+  if (is_distinct_ && distinct_values_ != nullptr) {
+    std::vector<type::Value> key;
+    for (auto entry : distinct_values_->GetEntries()) {
+      distinct_values_->GetKey(entry, key);
+      DAdvance(key[0]);
+    }
+
+    // Every spilled value is new the first time it is read back
+    for (size_t partition = 0; partition < RowHashTable::partition_count;
+         partition++) {
+      if (distinct_values_->IsPartitionSpilled(partition) == false) continue;
+
+      distinct_values_->LoadPartition(partition);
+      RowHashTable::Entry *entry;
+      const char *record;
+      bool inserted;
+      while ((entry = distinct_values_->NextRecord(record, inserted)) !=
+             nullptr) {
+        if (inserted) {
+          distinct_values_->GetKey(entry, key);
+          DAdvance(key[0]);
+        }
+      }
     }
   }
   return DFinalize();
@@ -155,12 +181,21 @@ HashAggregator::HashAggregator(const planner::AggregatePlan *node,
                                executor::ExecutorContext *econtext,
                                size_t num_input_columns)
     : AbstractAggregator(node, output_table, econtext),
-      num_input_columns(num_input_columns) {}
+      num_input_columns(num_input_columns) {
+  // The list, the values of the key and the first tuple, the aggregates and
+  // the node of the map
+  group_size_ = sizeof(AggregateList) +
+                (num_input_columns + node->GetGroupbyColIds().size()) *
+                    sizeof(type::Value) +
+                node->GetUniqueAggTerms().size() * 64 + 64;
+}
 //  group_by_key_values.resize(node->GetGroupbyColIds().size(),
 //      type::ValueFactory::GetNullValueByType(type::Type::INTEGER));
 //}
 
-HashAggregator::~HashAggregator() {
+HashAggregator::~HashAggregator() { FreeGroups(); }
+
+void HashAggregator::FreeGroups() {
   for (auto entry : aggregates_map) {
     // Clean up allocated storage
     for (size_t aggno = 0; aggno < node->GetUniqueAggTerms().size(); aggno++) {
@@ -169,6 +204,12 @@ HashAggregator::~HashAggregator() {
     delete[] entry.second->aggregates;
     delete entry.second;
   }
+  aggregates_map.clear();
+
+  if (executor_context != nullptr) {
+    executor_context->ReleaseMemory(reserved_memory_);
+  }
+  reserved_memory_ = 0;
 }
 
 bool HashAggregator::Advance(AbstractTuple *cur_tuple) {
@@ -187,6 +228,23 @@ bool HashAggregator::Advance(AbstractTuple *cur_tuple) {
 
   // Group not found. Make a new entry in the hash for this new group.
   if (map_itr == aggregates_map.end()) {
+    // Rows of new groups go to disk once the budget is used up
+    if (spilling_ == false && executor_context != nullptr &&
+        spill_depth_ < max_spill_depth) {
+      if (executor_context->ReserveMemory(group_size_) == false) {
+        LOG_DEBUG("Hash aggregation of %lu groups starts spilling",
+                  aggregates_map.size());
+        spilling_ = true;
+        spill_files_.resize(RowHashTable::partition_count);
+      } else {
+        reserved_memory_ += group_size_;
+      }
+    }
+    if (spilling_ == true) {
+      SpillTuple(cur_tuple);
+      return true;
+    }
+
     LOG_TRACE("Group-by key not found. Start a new group.");
     // Allocate new aggregate list
     aggregate_list = new AggregateList();
@@ -238,9 +296,50 @@ bool HashAggregator::Finalize() {
       return false;
     }
   }
+  FreeGroups();
+
+  // Every spilled partition holds all rows of its groups
+  auto spill_files = std::move(spill_files_);
+  auto depth = spill_depth_;
+  for (auto &file : spill_files) {
+    if (file == nullptr) continue;
+    if (FinalizePartition(*file, depth + 1) == false) {
+      return false;
+    }
+  }
   return true;
 }
 
+void HashAggregator::SpillTuple(AbstractTuple *tuple) {
+  if (spill_types_.empty() == true) {
+    for (size_t col_id = 0; col_id < num_input_columns; col_id++) {
+      spill_types_.push_back(tuple->GetValue(col_id).GetTypeId());
+    }
+  }
+
+  auto hash =
+      RowHashTable::HashKey(tuple, node->GetGroupbyColIds(), key_buffer_);
+  auto &file = spill_files_[(hash >> (60 - 4 * spill_depth_)) &
+                            (RowHashTable::partition_count - 1)];
+  if (file == nullptr) {
+    file.reset(new SpillFile());
+  }
+  file->WriteRow(tuple, num_input_columns);
+}
+
+bool HashAggregator::FinalizePartition(SpillFile &file, size_t depth) {
+  spilling_ = false;
+  spill_depth_ = depth;
+  spill_files_.clear();
+
+  file.Rewind();
+  expression::ContainerTuple<std::vector<type::Value>> tuple(&spill_values_);
+  while (file.ReadRow(spill_types_, spill_values_)) {
+    Advance(&tuple);
+  }
+  return Finalize();
+}
+
 //===--------------------------------------------------------------------===//
 // Sort Aggregator
 //===--------------------------------------------------------------------===//
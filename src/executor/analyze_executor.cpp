@@ -0,0 +1,51 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// analyze_executor.cpp
+//
+// Identification: src/executor/analyze_executor.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "executor/analyze_executor.h"
+
+#include "common/logger.h"
+#include "executor/executor_context.h"
+#include "optimizer/stats_storage.h"
+#include "storage/data_table.h"
+
+namespace peloton {
+namespace executor {
+
+AnalyzeExecutor::AnalyzeExecutor(const planner::AbstractPlan *node,
+                                 ExecutorContext *executor_context)
+    : AbstractExecutor(node, executor_context) {}
+
+bool AnalyzeExecutor::DInit() {
+  LOG_TRACE("Initializing Analyze Executor...");
+  return true;
+}
+
+bool AnalyzeExecutor::DExecute() {
+  LOG_TRACE("Executing Analyze...");
+  const planner::AnalyzePlan &node = GetPlanNode<planner::AnalyzePlan>();
+  auto current_txn = executor_context_->GetTransaction();
+  auto &stats_storage = optimizer::StatsStorage::GetInstance();
+
+  auto target_table = node.GetTargetTable();
+  if (target_table != nullptr) {
+    stats_storage.AnalyzeTable(target_table, current_txn);
+    LOG_TRACE("Analyzed table %s", target_table->GetName().c_str());
+  } else {
+    UNUSED_ATTRIBUTE auto analyzed_count =
+        stats_storage.AnalyzeStaleTables(current_txn);
+    LOG_TRACE("Analyzed %lu tables", analyzed_count);
+  }
+  return false;
+}
+
+}  // namespace executor
+}  // namespace peloton
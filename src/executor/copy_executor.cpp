@@ -20,6 +20,7 @@
 #include "executor/executor_context.h"
 #include "executor/logical_tile_factory.h"
 #include "planner/copy_plan.h"
+#include "storage/table_exporter.h"
 #include "storage/table_factory.h"
 #include "logging/logging_util.h"
 #include "common/exception.h"
@@ -45,11 +46,24 @@ CopyExecutor::~CopyExecutor() {}
  * @return true on success, false otherwise.
  */
 bool CopyExecutor::DInit() {
-  PL_ASSERT(children_.size() == 1);
+  PL_ASSERT(children_.size() <= 1);
 
   // Grab info from plan node and check it
   const planner::CopyPlan &node = GetPlanNode<planner::CopyPlan>();
 
+  // Tables without a child scan are streamed by the exporter
+  if (children_.size() == 0) {
+    PL_ASSERT(node.target_table != nullptr);
+    exporter_.reset(new storage::TableExporter(
+        node.target_table, node.copy_type, node.delimiter));
+    if (exporter_->Open(node.file_path) == false) {
+      throw ExecutorException("Failed to create file " + node.file_path +
+                              ". Try absolute path and make sure you have the "
+                              "permission to access this file.");
+    }
+    return true;
+  }
+
   bool success = logging::LoggingUtil::InitFileHandle(node.file_path.c_str(),
                                                       file_handle_, "w");
 
@@ -154,6 +168,20 @@ bool CopyExecutor::DExecute() {
     return false;
   }
 
+  if (exporter_ != nullptr) {
+    bool success = exporter_->Export(executor_context_->GetTransaction());
+    total_bytes_written = exporter_->GetBytesWritten();
+    done = true;
+    if (success == false) {
+      auto &transaction_manager =
+          concurrency::TransactionManagerFactory::GetInstance();
+      transaction_manager.SetTransactionResult(
+          executor_context_->GetTransaction(), ResultType::FAILURE);
+      return false;
+    }
+    return true;
+  }
+
   while (children_[0]->Execute() == true) {
     // Get input a tile
     std::unique_ptr<LogicalTile> logical_tile(children_[0]->GetOutput());
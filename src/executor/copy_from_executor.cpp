@@ -0,0 +1,397 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// copy_from_executor.cpp
+//
+// Identification: src/executor/copy_from_executor.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "executor/copy_from_executor.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+#include "common/exception.h"
+#include "common/logger.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/executor_context.h"
+#include "planner/copy_plan.h"
+#include "storage/data_table.h"
+#include "storage/tuple.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace executor {
+
+namespace {
+
+// Files smaller than this are not worth another parser thread
+const size_t min_chunk_size = 1 << 16;
+
+// Parsed batches a parser may run ahead of the inserts
+const size_t batches_per_parser = 2;
+
+// Deferred index entries are added once this many have piled up, which
+// bounds the memory of very large loads
+const size_t deferred_index_entry_limit = 1 << 20;
+
+// Position of the newline that ends the row at pos, or end if there is none.
+// A newline escaped by an odd number of backslashes is part of a field.
+size_t FindLineEnd(const char *data, size_t pos, size_t end) {
+  while (pos < end) {
+    auto newline =
+        static_cast<const char *>(memchr(data + pos, '\n', end - pos));
+    if (newline == nullptr) {
+      return end;
+    }
+
+    pos = newline - data;
+    size_t escape_count = 0;
+    while (escape_count < pos && data[pos - escape_count - 1] == '\\') {
+      escape_count++;
+    }
+    if (escape_count % 2 == 0) {
+      return pos;
+    }
+    pos++;
+  }
+  return end;
+}
+
+}  // namespace
+
+size_t CopyFromExecutor::parser_count_ = std::thread::hardware_concurrency();
+
+void CopyFromExecutor::SetParserCount(size_t parser_count) {
+  parser_count_ = parser_count;
+}
+
+/**
+ * @brief Constructor for Copy From executor.
+ * @param node Copy node corresponding to this executor.
+ */
+CopyFromExecutor::CopyFromExecutor(const planner::AbstractPlan *node,
+                                   ExecutorContext *executor_context)
+    : AbstractExecutor(node, executor_context), failed_(false) {}
+
+CopyFromExecutor::~CopyFromExecutor() { CloseFile(); }
+
+/**
+ * @brief Maps the input file into memory.
+ * @return true on success, false otherwise.
+ */
+bool CopyFromExecutor::DInit() {
+  PL_ASSERT(children_.size() == 0);
+
+  const planner::CopyPlan &node = GetPlanNode<planner::CopyPlan>();
+  target_table_ = node.target_table;
+  if (target_table_ == nullptr) {
+    throw ExecutorException("COPY FROM needs a target table");
+  }
+  schema_ = target_table_->GetSchema();
+  delimiter_ = node.delimiter;
+  defer_index_build_ = node.defer_index_build;
+
+  CloseFile();
+  file_descriptor_ = open(node.file_path.c_str(), O_RDONLY);
+  struct stat file_stat;
+  if (file_descriptor_ < 0 || fstat(file_descriptor_, &file_stat) < 0) {
+    CloseFile();
+    throw ExecutorException("Failed to open file " + node.file_path +
+                            ". Try absolute path and make sure you have the "
+                            "permission to access this file.");
+  }
+
+  file_size_ = file_stat.st_size;
+  if (file_size_ > 0) {
+    void *file_data = mmap(nullptr, file_size_, PROT_READ, MAP_PRIVATE,
+                           file_descriptor_, 0);
+    if (file_data == MAP_FAILED) {
+      CloseFile();
+      throw ExecutorException("Failed to map file " + node.file_path);
+    }
+    madvise(file_data, file_size_, MADV_SEQUENTIAL);
+    file_data_ = static_cast<const char *>(file_data);
+  }
+  LOG_DEBUG("Mapped copy input file: %s (%lu bytes)", node.file_path.c_str(),
+            file_size_);
+
+  done_ = false;
+  failed_ = false;
+  error_message_.clear();
+  batch_queue_.clear();
+  deferred_index_entries_.clear();
+  return true;
+}
+
+void CopyFromExecutor::CloseFile() {
+  if (file_data_ != nullptr) {
+    munmap(const_cast<char *>(file_data_), file_size_);
+    file_data_ = nullptr;
+  }
+  if (file_descriptor_ >= 0) {
+    close(file_descriptor_);
+    file_descriptor_ = -1;
+  }
+  file_size_ = 0;
+}
+
+/**
+ * @brief Parses the file on the parser threads and inserts the parsed
+ * batches as they come in.
+ * @return true on success, false if the transaction has to abort.
+ */
+bool CopyFromExecutor::DExecute() {
+  if (done_) {
+    return false;
+  }
+
+  // Cut the file at line ends into one chunk per parser
+  size_t chunk_count = std::max<size_t>(
+      1, std::min(parser_count_, file_size_ / min_chunk_size));
+  std::vector<size_t> chunk_bounds(1, 0);
+  for (size_t chunk_itr = 1; chunk_itr < chunk_count; chunk_itr++) {
+    size_t pos = std::max(chunk_bounds.back(),
+                          file_size_ * chunk_itr / chunk_count);
+    pos = FindLineEnd(file_data_, pos, file_size_);
+    chunk_bounds.push_back(std::min(pos + 1, file_size_));
+  }
+  chunk_bounds.push_back(file_size_);
+
+  max_queued_batches_ = chunk_count * batches_per_parser;
+  running_parser_count_ = chunk_count;
+  std::vector<std::thread> parsers;
+  for (size_t chunk_itr = 0; chunk_itr < chunk_count; chunk_itr++) {
+    parsers.emplace_back(&CopyFromExecutor::ParseChunk, this,
+                         chunk_bounds[chunk_itr], chunk_bounds[chunk_itr + 1]);
+  }
+
+  // Insert on this thread, all writes of the transaction stay on it
+  std::unique_ptr<TupleBatch> batch;
+  try {
+    while ((batch = PopBatch()) != nullptr) {
+      if (failed_ == false && InsertBatch(*batch) == false) {
+        SetError("Constraint violated while loading the rows");
+      }
+    }
+  } catch (...) {
+    // Stop the parsers and join them before the exception unwinds past them
+    SetError("Failed to insert the rows");
+    while (PopBatch() != nullptr) {
+    }
+    for (auto &parser : parsers) {
+      parser.join();
+    }
+    deferred_index_entries_.clear();
+    CloseFile();
+    done_ = true;
+    throw;
+  }
+  for (auto &parser : parsers) {
+    parser.join();
+  }
+
+  if (failed_ == false &&
+      target_table_->BuildIndexes(deferred_index_entries_,
+                                  executor_context_->GetTransaction()) ==
+          false) {
+    SetError("Index constraint violated while loading the rows");
+  }
+  deferred_index_entries_.clear();
+  CloseFile();
+  done_ = true;
+
+  if (failed_ == true) {
+    LOG_ERROR("COPY FROM failed: %s", error_message_.c_str());
+    auto &transaction_manager =
+        concurrency::TransactionManagerFactory::GetInstance();
+    transaction_manager.SetTransactionResult(
+        executor_context_->GetTransaction(), ResultType::FAILURE);
+    return false;
+  }
+
+  LOG_DEBUG("Copied %u rows into %s", executor_context_->num_processed,
+            target_table_->GetName().c_str());
+  return true;
+}
+
+void CopyFromExecutor::ParseChunk(size_t begin, size_t end) {
+  size_t batch_size = DEFAULT_TUPLES_PER_TILEGROUP;
+  std::unique_ptr<TupleBatch> batch(new TupleBatch());
+
+  size_t line_begin = begin;
+  while (line_begin < end && failed_ == false) {
+    size_t line_end = FindLineEnd(file_data_, line_begin, end);
+    const char *line = file_data_ + line_begin;
+    const char *line_stop = file_data_ + line_end;
+    if (line_stop > line && *(line_stop - 1) == '\r') {
+      line_stop--;
+    }
+
+    // Blank lines carry no row
+    if (line_stop > line) {
+      std::unique_ptr<storage::Tuple> tuple(new storage::Tuple(schema_, true));
+      if (ParseLine(line, line_stop, tuple.get(), &batch->pool_) == false) {
+        SetError("Malformed row at byte " + std::to_string(line_begin) +
+                 " of the input file");
+        break;
+      }
+      batch->tuples_.push_back(std::move(tuple));
+
+      if (batch->tuples_.size() == batch_size) {
+        PushBatch(std::move(batch));
+        batch.reset(new TupleBatch());
+      }
+    }
+    line_begin = line_end + 1;
+  }
+
+  if (batch->tuples_.empty() == false) {
+    PushBatch(std::move(batch));
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(batch_mutex_);
+    running_parser_count_--;
+  }
+  batch_cv_.notify_all();
+}
+
+/**
+ * Fields are split at the delimiter, a backslash makes the next character
+ * part of the field. An empty field or \N is NULL.
+ */
+bool CopyFromExecutor::ParseLine(const char *line, const char *line_end,
+                                 storage::Tuple *tuple,
+                                 type::AbstractPool *pool) {
+  auto column_count = schema_->GetColumnCount();
+  std::string field;
+  const char *ptr = line;
+
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    // Too few fields
+    if (ptr > line_end) {
+      return false;
+    }
+
+    const char *field_begin = ptr;
+    field.clear();
+    while (ptr < line_end && *ptr != delimiter_) {
+      if (*ptr == '\\' && ptr + 1 < line_end) {
+        ptr++;
+      }
+      field.push_back(*ptr++);
+    }
+    bool is_null = (ptr == field_begin) ||
+                   (ptr - field_begin == 2 && field_begin[0] == '\\' &&
+                    field_begin[1] == 'N');
+    // Skip the delimiter
+    ptr++;
+
+    auto column_type = schema_->GetType(column_itr);
+    try {
+      if (is_null == true) {
+        tuple->SetValue(column_itr,
+                        type::ValueFactory::GetNullValueByType(column_type),
+                        pool);
+      } else if (column_type == type::Type::VARCHAR) {
+        tuple->SetValue(column_itr, type::ValueFactory::GetVarcharValue(field),
+                        pool);
+      } else {
+        tuple->SetValue(
+            column_itr,
+            type::ValueFactory::GetVarcharValue(field).CastAs(column_type),
+            pool);
+      }
+    } catch (std::exception &e) {
+      LOG_TRACE("Failed to parse field %u: %s", column_itr, e.what());
+      return false;
+    }
+  }
+
+  // Too many fields
+  return ptr > line_end;
+}
+
+void CopyFromExecutor::PushBatch(std::unique_ptr<TupleBatch> batch) {
+  {
+    std::unique_lock<std::mutex> lock(batch_mutex_);
+    batch_cv_.wait(lock, [this] {
+      return batch_queue_.size() < max_queued_batches_ || failed_ == true;
+    });
+    if (failed_ == true) {
+      return;
+    }
+    batch_queue_.push_back(std::move(batch));
+  }
+  batch_cv_.notify_all();
+}
+
+std::unique_ptr<CopyFromExecutor::TupleBatch> CopyFromExecutor::PopBatch() {
+  std::unique_ptr<TupleBatch> batch;
+  {
+    std::unique_lock<std::mutex> lock(batch_mutex_);
+    batch_cv_.wait(lock, [this] {
+      return batch_queue_.empty() == false || running_parser_count_ == 0;
+    });
+    if (batch_queue_.empty() == true) {
+      return nullptr;
+    }
+    batch = std::move(batch_queue_.front());
+    batch_queue_.pop_front();
+  }
+  // A parser might wait for room in the queue
+  batch_cv_.notify_all();
+  return batch;
+}
+
+void CopyFromExecutor::SetError(const std::string &error_message) {
+  {
+    std::lock_guard<std::mutex> lock(batch_mutex_);
+    if (failed_ == false) {
+      error_message_ = error_message;
+      failed_ = true;
+    }
+  }
+  batch_cv_.notify_all();
+}
+
+bool CopyFromExecutor::InsertBatch(TupleBatch &batch) {
+  auto current_txn = executor_context_->GetTransaction();
+
+  std::vector<const storage::Tuple *> tuples;
+  tuples.reserve(batch.tuples_.size());
+  for (auto &tuple : batch.tuples_) {
+    tuples.push_back(tuple.get());
+  }
+
+  auto deferred_index_entries =
+      defer_index_build_ ? &deferred_index_entries_ : nullptr;
+  if (target_table_->InsertTuples(tuples, current_txn,
+                                  deferred_index_entries) == false) {
+    return false;
+  }
+  executor_context_->num_processed += tuples.size();
+
+  if (deferred_index_entries_.size() >= deferred_index_entry_limit) {
+    if (target_table_->BuildIndexes(deferred_index_entries_, current_txn) ==
+        false) {
+      return false;
+    }
+    deferred_index_entries_.clear();
+  }
+  return true;
+}
+
+}  // namespace executor
+}  // namespace peloton
@@ -11,25 +11,40 @@
 //===----------------------------------------------------------------------===//
 
 
+#include <algorithm>
+
 #include "type/value.h"
 #include "executor/executor_context.h"
 #include "concurrency/transaction.h"
+#include "configuration/configuration.h"
 
 namespace peloton {
 namespace executor {
 
 ExecutorContext::ExecutorContext(concurrency::Transaction *transaction)
-    : transaction_(transaction) {}
+    : transaction_(transaction), memory_budget_(FLAGS_query_memory_limit) {}
 
 ExecutorContext::ExecutorContext(concurrency::Transaction *transaction,
                                  const std::vector<type::Value> &params)
     : transaction_(transaction),
-      params_(params) {}
+      params_(params),
+      memory_budget_(FLAGS_query_memory_limit) {}
 
 ExecutorContext::~ExecutorContext() {
   // params will be freed automatically
 }
 
+void ExecutorContext::Reset(concurrency::Transaction *transaction,
+                            const std::vector<type::Value> &params) {
+  transaction_ = transaction;
+  params_ = params;
+  num_processed = 0;
+  memory_usage_ = 0;
+
+  // Free the varlen data of the previous execution
+  pool_.reset();
+}
+
 concurrency::Transaction *ExecutorContext::GetTransaction() const {
   return transaction_;
 }
@@ -46,6 +61,18 @@ void ExecutorContext::ClearParams() {
   params_.clear();
 }
 
+bool ExecutorContext::ReserveMemory(size_t bytes) {
+  if (bytes > memory_budget_ - std::min(memory_usage_, memory_budget_)) {
+    return false;
+  }
+  memory_usage_ += bytes;
+  return true;
+}
+
+void ExecutorContext::ReleaseMemory(size_t bytes) {
+  memory_usage_ -= std::min(bytes, memory_usage_);
+}
+
 type::EphemeralPool *ExecutorContext::GetPool() {
 
   // construct pool if needed
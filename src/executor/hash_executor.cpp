@@ -16,14 +16,26 @@
 
 #include "common/logger.h"
 #include "type/value.h"
+#include "executor/executor_context.h"
 #include "executor/logical_tile.h"
 #include "executor/hash_executor.h"
+#include "executor/row_hash_table.h"
 #include "planner/hash_plan.h"
 #include "expression/tuple_value_expression.h"
 
 namespace peloton {
 namespace executor {
 
+namespace {
+
+// Where a row whose key was spilled is
+struct SpilledRow {
+  size_t tile;
+  oid_t row;
+};
+
+}  // namespace
+
 /**
  * @brief Constructor
  */
@@ -31,6 +43,12 @@ HashExecutor::HashExecutor(const planner::AbstractPlan *node,
                            ExecutorContext *executor_context)
     : AbstractExecutor(node, executor_context) {}
 
+HashExecutor::~HashExecutor() {
+  if (executor_context_ != nullptr) {
+    executor_context_->ReleaseMemory(reserved_memory_);
+  }
+}
+
 /**
  * @brief Do some basic checks and initialize executor state.
  * @return true on success, false otherwise.
@@ -41,6 +59,14 @@ bool HashExecutor::DInit() {
   // Initialize executor state
   done_ = false;
   result_itr = 0;
+  runtime_filter_.reset();
+  hash_table_.clear();
+  column_ids_.clear();
+  overflowed_ = false;
+  if (executor_context_ != nullptr) {
+    executor_context_->ReleaseMemory(reserved_memory_);
+  }
+  reserved_memory_ = 0;
 
   return true;
 }
@@ -57,6 +83,14 @@ bool HashExecutor::DExecute() {
     }
 
     if (child_tiles_.size() == 0) {
+      // Nothing on the probe side can find a match
+      if (runtime_filter_enabled_ == true) {
+        std::vector<type::Type::TypeId> key_types;
+        for (auto &hashkey : node.GetHashKeys()) {
+          key_types.push_back(hashkey->GetValueType());
+        }
+        runtime_filter_.reset(new RuntimeFilter(key_types, 0));
+      }
       LOG_TRACE("Hash Executor : false -- no child tiles ");
       return false;
     }
@@ -78,27 +112,52 @@ bool HashExecutor::DExecute() {
       column_ids_.push_back(tuple_value->GetColumnId());
     }
 
-    // Construct the hash table by going over each child logical tile and
-    // hashing
-    for (size_t child_tile_itr = 0; child_tile_itr < child_tiles_.size();
-         child_tile_itr++) {
-      auto tile = child_tiles_[child_tile_itr].get();
-
-      // Go over all tuples in the logical tile
-      for (oid_t tuple_id : *tile) {
-        // Key : container tuple with a subset of tuple attributes
-        // Value : < child_tile offset, tuple offset >
-        auto key = HashMapType::key_type(tile, tuple_id, &column_ids_);
-        if (hash_table_.find(key) != hash_table_.end()){
-           //If data is already present, remove from output
-           //but leave data for hash joins.
-           tile->RemoveVisibility(tuple_id);
+    if (join_table_enabled_ == false) {
+      RemoveDuplicates();
+    } else if (ReserveJoinTable() == false) {
+      // The join partitions both sides instead
+      LOG_DEBUG("Join table of %lu tiles exceeds the memory budget",
+                child_tiles_.size());
+      overflowed_ = true;
+    } else {
+      // Construct the hash table by going over each child logical tile and
+      // hashing
+      for (size_t child_tile_itr = 0; child_tile_itr < child_tiles_.size();
+           child_tile_itr++) {
+        auto tile = child_tiles_[child_tile_itr].get();
+
+        // Go over all tuples in the logical tile
+        for (oid_t tuple_id : *tile) {
+          // Key : container tuple with a subset of tuple attributes
+          // Value : < child_tile offset, tuple offset >
+          auto key = HashMapType::key_type(tile, tuple_id, &column_ids_);
+          if (hash_table_.find(key) != hash_table_.end()){
+             //If data is already present, remove from output
+             //but leave data for hash joins.
+             tile->RemoveVisibility(tuple_id);
+          }
+          hash_table_[key].insert(
+                      std::make_pair(child_tile_itr, tuple_id));
         }
-        hash_table_[key].insert(
-                    std::make_pair(child_tile_itr, tuple_id));
       }
-    }
 
+      // Summarize the distinct keys for the probe side of the join
+      if (runtime_filter_enabled_ == true && hash_table_.empty() == false) {
+        std::vector<type::Type::TypeId> key_types;
+        auto &first_key = hash_table_.begin()->first;
+        for (auto column_id : column_ids_) {
+          key_types.push_back(first_key.GetValue(column_id).GetTypeId());
+        }
+        runtime_filter_.reset(new RuntimeFilter(key_types, hash_table_.size()));
+        for (auto &entry : hash_table_) {
+          runtime_filter_->Insert(&entry.first, column_ids_);
+        }
+        LOG_TRACE("Runtime filter of %lu keys",
+                  runtime_filter_->GetKeyCount());
+      }
+
+      profile_.hash_table_entries = hash_table_.size();
+    }
     done_ = true;
   }
 
@@ -118,5 +177,68 @@ bool HashExecutor::DExecute() {
   return false;
 }
 
+bool HashExecutor::ReserveJoinTable() {
+  if (executor_context_ == nullptr) {
+    return true;
+  }
+
+  size_t row_count = 0;
+  for (auto &child_tile : child_tiles_) {
+    row_count += child_tile->GetTupleCount();
+  }
+  size_t bytes = row_count * join_table_row_bytes;
+  if (executor_context_->ReserveMemory(bytes) == false) {
+    return false;
+  }
+  reserved_memory_ = bytes;
+  return true;
+}
+
+void HashExecutor::RemoveDuplicates() {
+  const planner::HashPlan &node = GetPlanNode<planner::HashPlan>();
+  std::vector<type::Type::TypeId> key_types;
+  for (auto &hashkey : node.GetHashKeys()) {
+    key_types.push_back(hashkey->GetValueType());
+  }
+
+  RowHashTable distinct_rows(key_types, 0, sizeof(SpilledRow));
+  distinct_rows.SetExecutorContext(executor_context_);
+  for (size_t child_tile_itr = 0; child_tile_itr < child_tiles_.size();
+       child_tile_itr++) {
+    auto tile = child_tiles_[child_tile_itr].get();
+    for (oid_t tuple_id : *tile) {
+      expression::ContainerTuple<LogicalTile> tuple(tile, tuple_id);
+      SpilledRow record = {child_tile_itr, tuple_id};
+      bool inserted;
+      auto entry =
+          distinct_rows.Insert(&tuple, column_ids_, &record, inserted);
+      if (entry != nullptr && inserted == false) {
+        tile->RemoveVisibility(tuple_id);
+      }
+    }
+  }
+  size_t distinct_count = distinct_rows.GetEntryCount();
+
+  // The first record of every key in a spilled partition is its first row
+  for (size_t partition = 0; partition < RowHashTable::partition_count;
+       partition++) {
+    if (distinct_rows.IsPartitionSpilled(partition) == false) continue;
+
+    distinct_rows.LoadPartition(partition);
+    const char *record;
+    bool inserted;
+    while (distinct_rows.NextRecord(record, inserted) != nullptr) {
+      if (inserted == false) {
+        SpilledRow spilled_row;
+        PL_MEMCPY(&spilled_row, record, sizeof(spilled_row));
+        child_tiles_[spilled_row.tile]->RemoveVisibility(spilled_row.row);
+      }
+    }
+    distinct_count += distinct_rows.GetEntryCount();
+  }
+
+  profile_.hash_table_entries = distinct_count;
+}
+
 } /* namespace executor */
 } /* namespace peloton */
@@ -15,10 +15,14 @@
 
 #include "type/types.h"
 #include "common/logger.h"
+#include "executor/executor_context.h"
 #include "executor/logical_tile_factory.h"
 #include "executor/hash_join_executor.h"
+#include "executor/row_hash_table.h"
 #include "expression/abstract_expression.h"
+#include "planner/hash_join_plan.h"
 #include "common/container_tuple.h"
+#include "storage/tile.h"
 
 namespace peloton {
 namespace executor {
@@ -31,6 +35,12 @@ HashJoinExecutor::HashJoinExecutor(const planner::AbstractPlan *node,
                                    ExecutorContext *executor_context)
     : AbstractJoinExecutor(node, executor_context) {}
 
+HashJoinExecutor::~HashJoinExecutor() {
+  if (executor_context_ != nullptr) {
+    executor_context_->ReleaseMemory(reserved_memory_);
+  }
+}
+
 bool HashJoinExecutor::DInit() {
   PL_ASSERT(children_.size() == 2);
 
@@ -41,6 +51,27 @@ bool HashJoinExecutor::DInit() {
             PlanNodeType::HASH);
 
   hash_executor_ = reinterpret_cast<HashExecutor *>(children_[1]);
+  hash_executor_->EnableJoinTable();
+
+  spilled_ = false;
+  pending_partitions_.clear();
+  if (partition_loaded_ == true) {
+    FinishPartition();
+  }
+
+  // Left rows without a match are only output by left and full outer
+  // joins, otherwise the scan of the left side may drop them early
+  probe_scan_ = nullptr;
+  auto probe_node = children_[0]->GetRawNode();
+  auto probe_type = probe_node != nullptr ? probe_node->GetPlanNodeType()
+                                          : PlanNodeType::INVALID;
+  if ((join_type_ == JoinType::INNER || join_type_ == JoinType::RIGHT) &&
+      (probe_type == PlanNodeType::SEQSCAN ||
+       probe_type == PlanNodeType::INDEXSCAN)) {
+    probe_scan_ = static_cast<AbstractScanExecutor *>(children_[0]);
+    probe_scan_->SetRuntimeFilter(nullptr, {});
+    hash_executor_->EnableRuntimeFilter();
+  }
 
   return true;
 }
@@ -53,6 +84,10 @@ bool HashJoinExecutor::DInit() {
 bool HashJoinExecutor::DExecute() {
   LOG_TRACE("********** Hash Join executor :: 2 children \n");
 
+  if (spilled_ == true) {
+    return ExecuteSpilled();
+  }
+
   // Loop until we have non-empty result tile or exit
   for (;;) {
     // Check if we have any buffered output tiles
@@ -78,6 +113,28 @@ bool HashJoinExecutor::DExecute() {
         BufferRightTile(children_[1]->GetOutput());
       }
       right_child_done_ = true;
+
+      // The hash table does not fit the memory budget, so both sides are
+      // partitioned to disk and joined a partition at a time
+      if (hash_executor_->HasOverflowed() == true) {
+        const planner::HashJoinPlan &node =
+            GetPlanNode<planner::HashJoinPlan>();
+        SpillInputs(node.GetOuterHashIds().empty()
+                        ? hash_executor_->GetHashKeyIds()
+                        : node.GetOuterHashIds());
+        return ExecuteSpilled();
+      }
+
+      // Push the keys of the right side into the scan of the left side
+      if (probe_scan_ != nullptr) {
+        const planner::HashJoinPlan &node =
+            GetPlanNode<planner::HashJoinPlan>();
+        auto &outer_col_ids = node.GetOuterHashIds().empty()
+                                  ? hash_executor_->GetHashKeyIds()
+                                  : node.GetOuterHashIds();
+        probe_scan_->SetRuntimeFilter(hash_executor_->GetRuntimeFilter(),
+                                      outer_col_ids);
+      }
     }
 
     // Get next tile from LEFT child
@@ -95,95 +152,384 @@ bool HashJoinExecutor::DExecute() {
       return BuildOuterJoinOutput();
     }
 
-    LogicalTile *left_tile = left_result_tiles_.back().get();
+    // The keys of the left side are the outer hash columns, or the hashed
+    // columns when the plan does not name them
+    auto &hashed_col_ids = hash_executor_->GetHashKeyIds();
+    const planner::HashJoinPlan &node = GetPlanNode<planner::HashJoinPlan>();
+    auto &outer_col_ids = node.GetOuterHashIds().empty()
+                              ? hashed_col_ids
+                              : node.GetOuterHashIds();
+    ProbeLeftTile(hash_executor_->GetHashTable(), outer_col_ids);
 
-    //===------------------------------------------------------------------===//
-    // Build Join Tile
-    //===------------------------------------------------------------------===//
+    // Check if we have any buffered output tiles
+    if (buffered_output_tiles.empty() == false) {
+      auto output_tile = buffered_output_tiles.front();
+      SetOutput(output_tile);
+      buffered_output_tiles.pop_front();
 
-    // Get the hash table from the hash executor
-    auto &hash_table = hash_executor_->GetHashTable();
-    auto &hashed_col_ids = hash_executor_->GetHashKeyIds();
+      return true;
+    } else {
+      // Try again
+      continue;
+    }
+  }
+}
+
+/**
+ * @brief Joins the last buffered left tile with the right rows of the hash
+ * table and buffers the output tiles.
+ */
+void HashJoinExecutor::ProbeLeftTile(HashExecutor::HashMapType &hash_table,
+                                     const std::vector<oid_t> &outer_col_ids) {
+  LogicalTile *left_tile = left_result_tiles_.back().get();
+
+  //===------------------------------------------------------------------===//
+  // Build Join Tile
+  //===------------------------------------------------------------------===//
+
+  oid_t prev_tile = INVALID_OID;
+  std::unique_ptr<LogicalTile> output_tile;
+  LogicalTile::PositionListsBuilder pos_lists_builder;
+
+  // Go over the left tile
+  for (auto left_tile_itr : *left_tile) {
+    const expression::ContainerTuple<executor::LogicalTile> left_tuple(
+        left_tile, left_tile_itr, &outer_col_ids);
+
+    // A NULL key never matches anything
+    bool has_null = false;
+    for (auto column_id : outer_col_ids) {
+      has_null = has_null || left_tuple.GetValue(column_id).IsNull();
+    }
+    if (has_null) continue;
+
+    // Find matching tuples in the hash table built on top of the right table
+    auto right_tuples = hash_table.find(left_tuple);
+
+    if (right_tuples != hash_table.end()) {
+      // Go over the matching right tuples
+      for (auto &location : right_tuples->second) {
+        LogicalTile *right_tile = right_result_tiles_[location.first].get();
+
+        // The residual join predicate is evaluated per pair
+        if (predicate_ != nullptr) {
+          const expression::ContainerTuple<executor::LogicalTile> left_row(
+              left_tile, left_tile_itr);
+          const expression::ContainerTuple<executor::LogicalTile> right_row(
+              right_tile, location.second);
+          auto eval =
+              predicate_->Evaluate(&left_row, &right_row, executor_context_);
+          if (eval.IsTrue() == false) continue;
+        }
+
+        // Check if we got a new right tile itr
+        if (prev_tile != location.first) {
+          // Check if we have any join tuples
+          if (pos_lists_builder.Size() > 0) {
+            LOG_TRACE("Join tile size : %lu \n", pos_lists_builder.Size());
+            output_tile->SetPositionListsAndVisibility(
+                pos_lists_builder.Release());
+            buffered_output_tiles.push_back(output_tile.release());
+          }
 
-    oid_t prev_tile = INVALID_OID;
-    std::unique_ptr<LogicalTile> output_tile;
-    LogicalTile::PositionListsBuilder pos_lists_builder;
+          // Build output logical tile
+          output_tile = BuildOutputLogicalTile(left_tile, right_tile);
 
-    // Go over the left tile
-    for (auto left_tile_itr : *left_tile) {
-      const expression::ContainerTuple<executor::LogicalTile> left_tuple(
-          left_tile, left_tile_itr, &hashed_col_ids);
+          // Build position lists
+          pos_lists_builder =
+              LogicalTile::PositionListsBuilder(left_tile, right_tile);
 
-      // Find matching tuples in the hash table built on top of the right table
-      auto right_tuples = hash_table.find(left_tuple);
+          pos_lists_builder.SetRightSource(
+              &right_result_tiles_[location.first]->GetPositionLists());
+        }
 
-      if (right_tuples != hash_table.end()) {
-    	// Not yet supported due to assertion in gettomg right_tuples->first
-//    	if (predicate_ != nullptr) {
-//    		auto eval = predicate_->Evaluate(&left_tuple, &right_tuples->first,
-//					executor_context_);
-//			if (eval.IsFalse())
-//				continue;
-//    	}
+        // Add join tuple
+        pos_lists_builder.AddRow(left_tile_itr, location.second);
 
         RecordMatchedLeftRow(left_result_tiles_.size() - 1, left_tile_itr);
+        RecordMatchedRightRow(location.first, location.second);
 
-        // Go over the matching right tuples
-        for (auto &location : right_tuples->second) {
-          // Check if we got a new right tile itr
-          if (prev_tile != location.first) {
-            // Check if we have any join tuples
-            if (pos_lists_builder.Size() > 0) {
-              LOG_TRACE("Join tile size : %lu \n", pos_lists_builder.Size());
-              output_tile->SetPositionListsAndVisibility(
-                  pos_lists_builder.Release());
-              buffered_output_tiles.push_back(output_tile.release());
-            }
-
-            // Get the logical tile from right child
-            LogicalTile *right_tile = right_result_tiles_[location.first].get();
-
-            // Build output logical tile
-            output_tile = BuildOutputLogicalTile(left_tile, right_tile);
-
-            // Build position lists
-            pos_lists_builder =
-                LogicalTile::PositionListsBuilder(left_tile, right_tile);
-
-            pos_lists_builder.SetRightSource(
-                &right_result_tiles_[location.first]->GetPositionLists());
-          }
+        // Cache prev logical tile itr
+        prev_tile = location.first;
+      }
+    }
+  }
 
-          // Add join tuple
-          pos_lists_builder.AddRow(left_tile_itr, location.second);
+  // Check if we have any join tuples
+  if (pos_lists_builder.Size() > 0) {
+    LOG_TRACE("Join tile size : %lu \n", pos_lists_builder.Size());
+    output_tile->SetPositionListsAndVisibility(pos_lists_builder.Release());
+    buffered_output_tiles.push_back(output_tile.release());
+  }
+}
 
-          RecordMatchedRightRow(location.first, location.second);
+//===----------------------------------------------------------------------===//
+// Grace hash join
+//===----------------------------------------------------------------------===//
 
-          // Cache prev logical tile itr
-          prev_tile = location.first;
-        }
-      }
+/**
+ * @brief Writes the rows of both sides to partitions by the top bits of the
+ * hash of their keys. Matching rows end up in the same partition, which is
+ * then joined on its own with a hash table of its right rows.
+ */
+void HashJoinExecutor::SpillInputs(const std::vector<oid_t> &outer_col_ids) {
+  left_key_ids_ = outer_col_ids;
+  right_key_ids_ = hash_executor_->GetHashKeyIds();
+
+  std::vector<SpillPartition> partitions(spill_partition_count);
+  size_t row_count = 0;
+  for (auto &right_tile : right_result_tiles_) {
+    if (right_schema_ == nullptr) {
+      right_schema_.reset(right_tile->GetPhysicalSchema());
     }
+    for (oid_t tuple_id : *right_tile) {
+      expression::ContainerTuple<LogicalTile> row(right_tile.get(), tuple_id);
+      SpillRow(partitions, &row, right_tile->GetColumnCount(), false);
+      row_count++;
+    }
+  }
+  right_result_tiles_.clear();
+  no_matching_right_row_sets_.clear();
 
-    // Check if we have any join tuples
-    if (pos_lists_builder.Size() > 0) {
-      LOG_TRACE("Join tile size : %lu \n", pos_lists_builder.Size());
-      output_tile->SetPositionListsAndVisibility(pos_lists_builder.Release());
-      buffered_output_tiles.push_back(output_tile.release());
+  while (children_[0]->Execute()) {
+    std::unique_ptr<LogicalTile> left_tile(children_[0]->GetOutput());
+    if (left_schema_ == nullptr) {
+      left_schema_.reset(left_tile->GetPhysicalSchema());
     }
+    for (oid_t tuple_id : *left_tile) {
+      expression::ContainerTuple<LogicalTile> row(left_tile.get(), tuple_id);
+      SpillRow(partitions, &row, left_tile->GetColumnCount(), true);
+      row_count++;
+    }
+  }
+  left_child_done_ = true;
 
-    // Check if we have any buffered output tiles
+  LOG_DEBUG("Hash join spilled %lu rows", row_count);
+  AddPartitions(partitions);
+  spilled_ = true;
+}
+
+void HashJoinExecutor::SpillRow(std::vector<SpillPartition> &partitions,
+                                const AbstractTuple *row, size_t column_count,
+                                bool left_side) {
+  auto &key_ids = left_side ? left_key_ids_ : right_key_ids_;
+  bool outer_side =
+      join_type_ == JoinType::OUTER ||
+      join_type_ == (left_side ? JoinType::LEFT : JoinType::RIGHT);
+
+  // A NULL key never matches, only outer joins output the row
+  bool has_null = false;
+  for (auto column_id : key_ids) {
+    has_null = has_null || row->GetValue(column_id).IsNull();
+  }
+  if (has_null == true && outer_side == false) return;
+
+  auto hash = RowHashTable::HashKey(row, key_ids, key_buffer_);
+  auto depth = partitions.front().depth;
+  auto &partition =
+      partitions[(hash >> (60 - 4 * depth)) & (spill_partition_count - 1)];
+
+  // The right rows are spilled first, left rows without any are only output
+  // by outer joins
+  if (left_side == true && partition.right_rows == 0 && outer_side == false) {
+    return;
+  }
+
+  auto &file = left_side ? partition.left_file : partition.right_file;
+  if (file == nullptr) {
+    file.reset(new SpillFile());
+  }
+  file->WriteRow(row, column_count);
+  (left_side ? partition.left_rows : partition.right_rows)++;
+}
+
+void HashJoinExecutor::AddPartitions(std::vector<SpillPartition> &partitions) {
+  bool left_outer =
+      join_type_ == JoinType::LEFT || join_type_ == JoinType::OUTER;
+  bool right_outer =
+      join_type_ == JoinType::RIGHT || join_type_ == JoinType::OUTER;
+  for (auto &partition : partitions) {
+    // Without rows on one side only the outer rows of the other are output
+    if (partition.left_rows == 0 &&
+        (partition.right_rows == 0 || right_outer == false)) {
+      continue;
+    }
+    if (partition.right_rows == 0 && left_outer == false) {
+      continue;
+    }
+    pending_partitions_.push_back(std::move(partition));
+  }
+}
+
+void HashJoinExecutor::Repartition(SpillPartition &partition) {
+  LOG_DEBUG("Hash join splits a partition of %lu right rows at depth %lu",
+            partition.right_rows, partition.depth);
+
+  std::vector<SpillPartition> partitions(spill_partition_count);
+  for (auto &child : partitions) {
+    child.depth = partition.depth + 1;
+  }
+
+  expression::ContainerTuple<std::vector<type::Value>> row(&row_values_);
+  std::vector<type::Type::TypeId> types;
+  if (partition.right_file != nullptr) {
+    for (oid_t column_id = 0; column_id < right_schema_->GetColumnCount();
+         column_id++) {
+      types.push_back(right_schema_->GetType(column_id));
+    }
+    partition.right_file->Rewind();
+    while (partition.right_file->ReadRow(types, row_values_)) {
+      SpillRow(partitions, &row, types.size(), false);
+    }
+  }
+  if (partition.left_file != nullptr) {
+    types.clear();
+    for (oid_t column_id = 0; column_id < left_schema_->GetColumnCount();
+         column_id++) {
+      types.push_back(left_schema_->GetType(column_id));
+    }
+    partition.left_file->Rewind();
+    while (partition.left_file->ReadRow(types, row_values_)) {
+      SpillRow(partitions, &row, types.size(), true);
+    }
+  }
+
+  AddPartitions(partitions);
+}
+
+bool HashJoinExecutor::ExecuteSpilled() {
+  for (;;) {
     if (buffered_output_tiles.empty() == false) {
       auto output_tile = buffered_output_tiles.front();
       SetOutput(output_tile);
       buffered_output_tiles.pop_front();
-
       return true;
-    } else {
-      // Try again
+    }
+
+    if (partition_loaded_ == true) {
+      if (LoadLeftTile() == true) {
+        ProbeLeftTile(partition_table_, left_key_ids_);
+
+        // Only outer joins need the left rows once they are probed
+        if (join_type_ == JoinType::INNER || join_type_ == JoinType::RIGHT) {
+          left_result_tiles_.clear();
+        }
+        continue;
+      }
+
+      // All left rows of the partition are probed
+      if (BuildOuterJoinOutput() == true) {
+        return true;
+      }
+      FinishPartition();
       continue;
     }
+
+    if (pending_partitions_.empty() == true) {
+      return false;
+    }
+    SpillPartition partition = std::move(pending_partitions_.back());
+    pending_partitions_.pop_back();
+    LoadPartition(std::move(partition));
+  }
+}
+
+void HashJoinExecutor::LoadPartition(SpillPartition partition) {
+  size_t bytes = partition.right_rows * HashExecutor::join_table_row_bytes;
+  if (partition.right_file != nullptr) {
+    bytes += partition.right_file->GetSize();
+  }
+  if (executor_context_ != nullptr &&
+      executor_context_->ReserveMemory(bytes) == false) {
+    if (partition.depth < max_spill_depth) {
+      Repartition(partition);
+      return;
+    }
+    // Further splits would not help, the keys are too alike
+    LOG_DEBUG("Hash join partition of %lu right rows exceeds the budget",
+              partition.right_rows);
+  } else {
+    reserved_memory_ = bytes;
+  }
+
+  loaded_partition_ = std::move(partition);
+  partition_loaded_ = true;
+  if (loaded_partition_.left_file != nullptr) {
+    loaded_partition_.left_file->Rewind();
+  }
+  if (loaded_partition_.right_file == nullptr) {
+    return;
+  }
+
+  loaded_partition_.right_file->Rewind();
+  LogicalTile *right_tile;
+  while ((right_tile = ReadSpilledTile(*loaded_partition_.right_file,
+                                       *right_schema_)) != nullptr) {
+    BufferRightTile(right_tile);
+    size_t tile_itr = right_result_tiles_.size() - 1;
+    for (oid_t tuple_id : *right_tile) {
+      auto key =
+          HashExecutor::HashMapType::key_type(right_tile, tuple_id,
+                                              &right_key_ids_);
+      partition_table_[key].insert(std::make_pair(tile_itr, tuple_id));
+    }
+  }
+}
+
+bool HashJoinExecutor::LoadLeftTile() {
+  if (loaded_partition_.left_file == nullptr) {
+    return false;
+  }
+  auto left_tile =
+      ReadSpilledTile(*loaded_partition_.left_file, *left_schema_);
+  if (left_tile == nullptr) {
+    return false;
+  }
+  BufferLeftTile(left_tile);
+  return true;
+}
+
+void HashJoinExecutor::FinishPartition() {
+  partition_table_.clear();
+  left_result_tiles_.clear();
+  right_result_tiles_.clear();
+  no_matching_left_row_sets_.clear();
+  no_matching_right_row_sets_.clear();
+  left_matching_idx = 0;
+  right_matching_idx = 0;
+  loaded_partition_ = SpillPartition();
+  partition_loaded_ = false;
+
+  if (executor_context_ != nullptr) {
+    executor_context_->ReleaseMemory(reserved_memory_);
+  }
+  reserved_memory_ = 0;
+}
+
+LogicalTile *HashJoinExecutor::ReadSpilledTile(SpillFile &file,
+                                               const catalog::Schema &schema) {
+  std::vector<type::Type::TypeId> types;
+  for (oid_t column_id = 0; column_id < schema.GetColumnCount();
+       column_id++) {
+    types.push_back(schema.GetType(column_id));
+  }
+
+  std::vector<std::vector<type::Value>> rows;
+  while (rows.size() < spill_tile_size && file.ReadRow(types, row_values_)) {
+    rows.push_back(row_values_);
+  }
+  if (rows.empty() == true) {
+    return nullptr;
+  }
+
+  std::shared_ptr<storage::Tile> tile(
+      storage::TileFactory::GetTempTile(schema, rows.size()));
+  for (oid_t tuple_id = 0; tuple_id < rows.size(); tuple_id++) {
+    for (oid_t column_id = 0; column_id < types.size(); column_id++) {
+      tile->SetValue(rows[tuple_id][column_id], tuple_id, column_id);
+    }
   }
+  return LogicalTileFactory::WrapTiles({tile});
 }
 
 }  // namespace executor
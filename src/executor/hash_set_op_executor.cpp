@@ -14,16 +14,29 @@
 #include <utility>
 #include <vector>
 
+#include "common/container_tuple.h"
 #include "common/logger.h"
 #include "type/value.h"
 #include "executor/logical_tile.h"
 #include "executor/hash_set_op_executor.h"
+#include "storage/tile.h"
 
 #include "planner/set_op_plan.h"
 
 namespace peloton {
 namespace executor {
 
+namespace {
+
+// Where a row whose key was spilled is, right rows are only counted
+struct SpilledRow {
+  size_t tile;
+  oid_t row;
+  bool is_left;
+};
+
+}  // namespace
+
 /**
  * @brief Constructor
  */
@@ -76,12 +89,33 @@ bool HashSetOpExecutor::ExecuteHelper() {
     left_tiles_.emplace_back(children_[0]->GetOutput());
   }
 
-  if (left_tiles_.size() == 0) return false;
+  if (left_tiles_.size() == 0) {
+    hash_done_ = true;
+    return false;
+  }
+
+  // All columns make up the key
+  std::vector<oid_t> column_ids;
+  std::vector<type::Type::TypeId> key_types;
+  for (auto &column : left_tiles_[0]->GetSchema()) {
+    column_ids.push_back(column_ids.size());
+    key_types.push_back(
+        column.base_tile->GetSchema()->GetType(column.origin_column_id));
+  }
+  RowHashTable htable(key_types, sizeof(counter_pair_t), sizeof(SpilledRow));
+  htable.SetExecutorContext(executor_context_);
 
   // Scan the left child's input and update the counters
-  for (auto &tile : left_tiles_) {
+  for (size_t tile_itr = 0; tile_itr < left_tiles_.size(); tile_itr++) {
+    auto tile = left_tiles_[tile_itr].get();
     for (oid_t tuple_id : *tile) {
-      htable_[HashSetOpMapType::key_type(tile.get(), tuple_id)].left++;
+      expression::ContainerTuple<LogicalTile> tuple(tile, tuple_id);
+      SpilledRow record = {tile_itr, tuple_id, true};
+      bool inserted;
+      auto entry = htable.Insert(&tuple, column_ids, &record, inserted);
+      if (entry != nullptr) {
+        GetCounters(entry).left++;
+      }
     }
   }
 
@@ -91,65 +125,59 @@ bool HashSetOpExecutor::ExecuteHelper() {
     std::unique_ptr<LogicalTile> tile(children_[1]->GetOutput());
 
     for (oid_t tuple_id : *tile) {
-      auto it = htable_.find(HashSetOpMapType::key_type(tile.get(), tuple_id));
       // Do nothing if this key never appears in the left child
-      // because it shouldn't show up in the result anyway
-      if (it != htable_.end()) {
-        it->second.right++;
+      // because it shouldn't show up in the result anyway, unless
+      // it may be among the spilled ones
+      expression::ContainerTuple<LogicalTile> tuple(tile.get(), tuple_id);
+      SpilledRow record = {0, tuple_id, false};
+      auto entry = htable.Find(&tuple, column_ids, &record);
+      if (entry != nullptr) {
+        GetCounters(entry).right++;
       }
     }
   }
 
   // Calculate the output number for each key
-  switch (set_op_) {
-    case SetOpType::INTERSECT:
-      CalculateCopies<SetOpType::INTERSECT>(htable_);
-      break;
-    case SetOpType::INTERSECT_ALL:
-      CalculateCopies<SetOpType::INTERSECT_ALL>(htable_);
-      break;
-    case SetOpType::EXCEPT:
-      CalculateCopies<SetOpType::EXCEPT>(htable_);
-      break;
-    case SetOpType::EXCEPT_ALL:
-      CalculateCopies<SetOpType::EXCEPT_ALL>(htable_);
-      break;
-    case SetOpType::INVALID:
-      return false;
-  }
-
-  /*
-   * A bit cumbersome here:
-   * Since the first tuple of each group is used as the representative key
-   * in the hash table,
-   * we cannot invalidate it otherwise subsequent key comparison will fail
-   * (due to safety check in LogicalTile::GetValue()).
-   * Instead, we skip the first tuple and process it in a second round.
-   */
+  if (CalculateCopies(htable) == false) return false;
 
-  // 1st round
+  // Keys are copies in the table, so rows can be hidden right away. Rows of
+  // spilled keys are not in the table.
   for (auto &tile : left_tiles_) {
     for (oid_t tuple_id : *tile) {
-      auto it = htable_.find(HashSetOpMapType::key_type(tile.get(), tuple_id));
-
-      PL_ASSERT(it != htable_.end());
-
-      if (it->first.GetContainer() == tile.get() &&
-          it->first.GetTupleId() == tuple_id)
-        continue;
-      else if (it->second.left > 0)
-        it->second.left--;
-      else
-        tile->RemoveVisibility(tuple_id);
+      expression::ContainerTuple<LogicalTile> tuple(tile.get(), tuple_id);
+      auto entry = htable.Find(&tuple, column_ids);
+      if (entry != nullptr) {
+        KeepCopy(GetCounters(entry), tile.get(), tuple_id);
+      }
     }
   }
 
-  // 2nd round
-  for (auto &item : htable_) {
-    // We should have at most one quota left
-    PL_ASSERT(item.second.left == 1 || item.second.left == 0);
-    if (item.second.left == 0) {
-      item.first.GetContainer()->RemoveVisibility(item.first.GetTupleId());
+  // Count and keep the rows of every spilled partition the same way
+  for (size_t partition = 0; partition < RowHashTable::partition_count;
+       partition++) {
+    if (htable.IsPartitionSpilled(partition) == false) continue;
+
+    htable.LoadPartition(partition);
+    RowHashTable::Entry *entry;
+    const char *record;
+    bool inserted;
+    SpilledRow row;
+    while ((entry = htable.NextRecord(record, inserted)) != nullptr) {
+      PL_MEMCPY(&row, record, sizeof(row));
+      if (row.is_left) {
+        GetCounters(entry).left++;
+      } else {
+        GetCounters(entry).right++;
+      }
+    }
+    CalculateCopies(htable);
+
+    htable.RewindPartition();
+    while ((entry = htable.NextRecord(record, inserted)) != nullptr) {
+      PL_MEMCPY(&row, record, sizeof(row));
+      if (row.is_left) {
+        KeepCopy(GetCounters(entry), left_tiles_[row.tile].get(), row.row);
+      }
     }
   }
 
@@ -158,28 +186,44 @@ bool HashSetOpExecutor::ExecuteHelper() {
   return true;
 }
 
+bool HashSetOpExecutor::CalculateCopies(RowHashTable &htable) {
+  switch (set_op_) {
+    case SetOpType::INTERSECT:
+      return CalculateCopies<SetOpType::INTERSECT>(htable);
+    case SetOpType::INTERSECT_ALL:
+      return CalculateCopies<SetOpType::INTERSECT_ALL>(htable);
+    case SetOpType::EXCEPT:
+      return CalculateCopies<SetOpType::EXCEPT>(htable);
+    case SetOpType::EXCEPT_ALL:
+      return CalculateCopies<SetOpType::EXCEPT_ALL>(htable);
+    default:
+      return false;
+  }
+}
+
 /**
  * Based on the set-op type,
  * calculate the number of output copies of each tuples
  * and store it in the left counter.
  */
 template <SetOpType SETOP>
-bool HashSetOpExecutor::CalculateCopies(HashSetOpMapType &htable) {
-  for (auto &item : htable) {
+bool HashSetOpExecutor::CalculateCopies(RowHashTable &htable) {
+  for (auto entry : htable.GetEntries()) {
+    auto &counters = GetCounters(entry);
     switch (SETOP) {
       case SetOpType::INTERSECT:
-        item.second.left = (item.second.right > 0) ? 1 : 0;
+        counters.left = (counters.right > 0) ? 1 : 0;
         break;
       case SetOpType::INTERSECT_ALL:
-        item.second.left = std::min(item.second.left, item.second.right);
+        counters.left = std::min(counters.left, counters.right);
         break;
       case SetOpType::EXCEPT:
-        item.second.left = (item.second.right > 0) ? 0 : 1;
+        counters.left = (counters.right > 0) ? 0 : 1;
         break;
       case SetOpType::EXCEPT_ALL:
-        item.second.left = (item.second.left > item.second.right)
-                               ? (item.second.left - item.second.right)
-                               : 0;
+        counters.left = (counters.left > counters.right)
+                            ? (counters.left - counters.right)
+                            : 0;
         break;
       default:
         return false;
@@ -188,5 +232,14 @@ bool HashSetOpExecutor::CalculateCopies(HashSetOpMapType &htable) {
   return true;
 }
 
+void HashSetOpExecutor::KeepCopy(counter_pair_t &counters, LogicalTile *tile,
+                                 oid_t tuple_id) {
+  if (counters.left > 0) {
+    counters.left--;
+  } else {
+    tile->RemoveVisibility(tuple_id);
+  }
+}
+
 } /* namespace executor */
 } /* namespace peloton */
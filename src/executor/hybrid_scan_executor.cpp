@@ -193,6 +193,11 @@ bool HybridScanExecutor::SeqScanUtil() {
     auto tile_group = table_->GetTileGroup(current_tile_group_offset_++);
     auto tile_group_header = tile_group->GetHeader();
 
+    // Skip the tile groups whose values can not satisfy the predicate
+    if (predicate_ != nullptr && MayMatch(tile_group.get()) == false) {
+      continue;
+    }
+
     oid_t active_tuple_count = tile_group->GetNextTupleSlot();
 
     // Construct position list by looping through tile group
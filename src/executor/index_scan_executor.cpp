@@ -12,6 +12,8 @@
 
 #include "executor/index_scan_executor.h"
 
+#include <algorithm>
+#include <map>
 #include <memory>
 #include <numeric>
 #include <utility>
@@ -21,6 +23,7 @@
 #include "common/container_tuple.h"
 #include "common/logger.h"
 #include "concurrency/transaction_manager_factory.h"
+#include "configuration/configuration.h"
 #include "executor/executor_context.h"
 #include "executor/logical_tile.h"
 #include "executor/logical_tile_factory.h"
@@ -28,10 +31,12 @@
 #include "gc/gc_manager_factory.h"
 #include "index/index.h"
 #include "planner/index_scan_plan.h"
+#include "statistics/backend_stats_context.h"
 #include "storage/data_table.h"
 #include "storage/masked_tuple.h"
 #include "storage/tile_group.h"
 #include "storage/tile_group_header.h"
+#include "storage/tuple.h"
 #include "type/types.h"
 #include "type/value.h"
 
@@ -89,6 +94,20 @@ bool IndexScanExecutor::DInit() {
   limit_offset_ = node.GetLimitOffset();
   descend_ = node.GetDescend();
 
+  point_lookup_ = node.IsPointLookup() && limit_ == false;
+  if (point_lookup_ == true && point_key_.get() == nullptr) {
+    // Position of the value of every key column in values_
+    auto &key_attrs = index_->GetMetadata()->GetKeyAttrs();
+    point_key_offsets_.clear();
+    for (auto key_attr : key_attrs) {
+      auto offset_itr =
+          std::find(key_column_ids_.begin(), key_column_ids_.end(), key_attr);
+      PL_ASSERT(offset_itr != key_column_ids_.end());
+      point_key_offsets_.push_back(offset_itr - key_column_ids_.begin());
+    }
+    point_key_.reset(new storage::Tuple(index_->GetKeySchema(), true));
+  }
+
   if (runtime_keys_.size() != 0) {
     PL_ASSERT(runtime_keys_.size() == values_.size());
 
@@ -124,7 +143,10 @@ bool IndexScanExecutor::DExecute() {
   LOG_TRACE("Index Scan executor :: 0 child");
 
   if (!done_) {
-    if (index_->GetIndexType() == IndexConstraintType::PRIMARY_KEY) {
+    if (point_lookup_ == true) {
+      auto status = ExecPrimaryIndexPointLookup();
+      if (status == false) return false;
+    } else if (index_->GetIndexType() == IndexConstraintType::PRIMARY_KEY) {
       auto status = ExecPrimaryIndexLookup();
       if (status == false) return false;
     } else {
@@ -200,11 +222,6 @@ bool IndexScanExecutor::ExecPrimaryIndexLookup() {
     return false;
   }
 
-  auto &transaction_manager =
-      concurrency::TransactionManagerFactory::GetInstance();
-
-  auto current_txn = executor_context_->GetTransaction();
-  auto &manager = catalog::Manager::GetInstance();
   std::vector<ItemPointer> visible_tuple_locations;
   std::map<oid_t, std::vector<oid_t>> visible_tuples;
 
@@ -212,115 +229,23 @@ bool IndexScanExecutor::ExecPrimaryIndexLookup() {
   int num_tuples_examined = 0;
 #endif
 
+  // workers help the GC at most once per lookup
+  bool gc_requested = false;
+
   // for every tuple that is found in the index.
   for (auto tuple_location_ptr : tuple_location_ptrs) {
-    ItemPointer tuple_location = *tuple_location_ptr;
-    auto tile_group = manager.GetTileGroup(tuple_location.block);
-    auto tile_group_header = tile_group.get()->GetHeader();
-    size_t chain_length = 0;
-
 #ifdef LOG_TRACE_ENABLED
     num_tuples_examined++;
 #endif
 
-    // the following code traverses the version chain until a certain visible
-    // version is found.
-    // we should always find a visible version from a version chain.
-    while (true) {
-      ++chain_length;
-
-      auto visibility = transaction_manager.IsVisible(
-          current_txn, tile_group_header, tuple_location.offset);
-
-      // if the tuple is deleted
-      if (visibility == VisibilityType::DELETED) {
-        LOG_TRACE("encounter deleted tuple: %u, %u", tuple_location.block,
-                  tuple_location.offset);
-        break;
-      }
-      // if the tuple is visible.
-      else if (visibility == VisibilityType::OK) {
-        LOG_TRACE("perform read: %u, %u", tuple_location.block,
-                  tuple_location.offset);
-
-        bool eval = true;
-        // if having predicate, then perform evaluation.
-        if (predicate_ != nullptr) {
-          LOG_TRACE("perform prediate evaluate");
-          expression::ContainerTuple<storage::TileGroup> tuple(
-              tile_group.get(), tuple_location.offset);
-          eval =
-              predicate_->Evaluate(&tuple, nullptr, executor_context_).IsTrue();
-        }
-        // if passed evaluation, then perform write.
-        if (eval == true) {
-          LOG_TRACE("perform read operation");
-          auto res = transaction_manager.PerformRead(
-              current_txn, tuple_location, acquire_owner);
-          if (!res) {
-            LOG_TRACE("read nothing");
-            transaction_manager.SetTransactionResult(current_txn,
-                                                     ResultType::FAILURE);
-            return res;
-          }
-          // if perform read is successful, then add to visible tuple vector.
-          visible_tuple_locations.push_back(tuple_location);
-        }
-
-        break;
-      }
-      // if the tuple is not visible.
-      else {
-        PL_ASSERT(visibility == VisibilityType::INVISIBLE);
-
-        LOG_TRACE("Invisible read: %u, %u", tuple_location.block,
-                  tuple_location.offset);
-
-        bool is_acquired = (tile_group_header->GetTransactionId(
-                                tuple_location.offset) == INITIAL_TXN_ID);
-        bool is_alive =
-            (tile_group_header->GetEndCommitId(tuple_location.offset) <=
-             current_txn->GetBeginCommitId());
-        if (is_acquired && is_alive) {
-          // See an invisible version that does not belong to any one in the
-          // version chain.
-          // this means that some other transactions have modified the version
-          // chain.
-          // Wire back because the current version is expired. have to search
-          // from scratch.
-          tuple_location =
-              *(tile_group_header->GetIndirection(tuple_location.offset));
-          tile_group = manager.GetTileGroup(tuple_location.block);
-          tile_group_header = tile_group.get()->GetHeader();
-          chain_length = 0;
-          continue;
-        }
-
-        ItemPointer old_item = tuple_location;
-        tuple_location = tile_group_header->GetNextItemPointer(old_item.offset);
-
-        // there must exist a visible version.
-        if (tuple_location.IsNull()) {
-          if (chain_length == 1) {
-            break;
-          }
-
-          // in most cases, there should exist a visible version.
-          // if we have traversed through the chain and still can not fulfill
-          // one of the above conditions,
-          // then return result_failure.
-          transaction_manager.SetTransactionResult(current_txn,
-                                                   ResultType::FAILURE);
-          return false;
-        }
-
-        // search for next version.
-        tile_group = manager.GetTileGroup(tuple_location.block);
-        tile_group_header = tile_group.get()->GetHeader();
-        continue;
-      }
+    ItemPointer visible_location;
+    if (ReadVisibleVersion(*tuple_location_ptr, acquire_owner, gc_requested,
+                           visible_location) == false) {
+      return false;
+    }
+    if (visible_location.IsNull() == false) {
+      visible_tuple_locations.push_back(visible_location);
     }
-    LOG_TRACE("Traverse length: %d\n", (int)chain_length);
   }
 #ifdef LOG_TRACE_ENABLED
   LOG_TRACE("Examined %d tuples from index %s", num_tuples_examined,
@@ -364,6 +289,293 @@ bool IndexScanExecutor::ExecPrimaryIndexLookup() {
   return true;
 }
 
+bool IndexScanExecutor::ReadVisibleVersion(ItemPointer tuple_location,
+                                           bool acquire_owner,
+                                           bool &gc_requested,
+                                           ItemPointer &visible_location) {
+  auto &transaction_manager =
+      concurrency::TransactionManagerFactory::GetInstance();
+  auto current_txn = executor_context_->GetTransaction();
+  auto &manager = catalog::Manager::GetInstance();
+
+  auto tile_group = manager.GetTileGroup(tuple_location.block);
+  auto tile_group_header = tile_group.get()->GetHeader();
+  size_t chain_length = 0;
+
+  // the following code traverses the version chain until a certain visible
+  // version is found.
+  // we should always find a visible version from a version chain.
+  while (true) {
+    ++chain_length;
+
+    auto visibility = transaction_manager.IsVisible(
+        current_txn, tile_group_header, tuple_location.offset);
+
+    // if the tuple is deleted
+    if (visibility == VisibilityType::DELETED) {
+      LOG_TRACE("encounter deleted tuple: %u, %u", tuple_location.block,
+                tuple_location.offset);
+      break;
+    }
+    // if the tuple is visible.
+    else if (visibility == VisibilityType::OK) {
+      LOG_TRACE("perform read: %u, %u", tuple_location.block,
+                tuple_location.offset);
+
+      expression::ContainerTuple<storage::TileGroup> tuple(
+          tile_group.get(), tuple_location.offset);
+
+      // Tuples the join above can not match are dropped like the ones that
+      // fail the predicate
+      bool eval = PassesRuntimeFilter(&tuple);
+      // if having predicate, then perform evaluation.
+      if (eval == true && predicate_ != nullptr) {
+        LOG_TRACE("perform prediate evaluate");
+        eval =
+            predicate_->Evaluate(&tuple, nullptr, executor_context_).IsTrue();
+      }
+      // if passed evaluation, then perform write.
+      if (eval == true) {
+        LOG_TRACE("perform read operation");
+        auto res = transaction_manager.PerformRead(
+            current_txn, tuple_location, acquire_owner);
+        if (!res) {
+          LOG_TRACE("read nothing");
+          transaction_manager.SetTransactionResult(current_txn,
+                                                   ResultType::FAILURE);
+          return res;
+        }
+        // if perform read is successful, then this is the visible version.
+        visible_location = tuple_location;
+      }
+
+      break;
+    }
+    // if the tuple is not visible.
+    else {
+      PL_ASSERT(visibility == VisibilityType::INVISIBLE);
+
+      LOG_TRACE("Invisible read: %u, %u", tuple_location.block,
+                tuple_location.offset);
+
+      bool is_acquired = (tile_group_header->GetTransactionId(
+                              tuple_location.offset) == INITIAL_TXN_ID);
+      bool is_alive =
+          (tile_group_header->GetEndCommitId(tuple_location.offset) <=
+           current_txn->GetBeginCommitId());
+      if (is_acquired && is_alive) {
+        // See an invisible version that does not belong to any one in the
+        // version chain.
+        // this means that some other transactions have modified the version
+        // chain.
+        // Wire back because the current version is expired. have to search
+        // from scratch.
+        tuple_location =
+            *(tile_group_header->GetIndirection(tuple_location.offset));
+        tile_group = manager.GetTileGroup(tuple_location.block);
+        tile_group_header = tile_group.get()->GetHeader();
+        chain_length = 0;
+        continue;
+      }
+
+      ItemPointer old_item = tuple_location;
+      tuple_location = tile_group_header->GetNextItemPointer(old_item.offset);
+
+      // there must exist a visible version.
+      if (tuple_location.IsNull()) {
+        if (chain_length == 1) {
+          break;
+        }
+
+        // in most cases, there should exist a visible version.
+        // if we have traversed through the chain and still can not fulfill
+        // one of the above conditions,
+        // then return result_failure.
+        transaction_manager.SetTransactionResult(current_txn,
+                                                 ResultType::FAILURE);
+        return false;
+      }
+
+      // search for next version.
+      tile_group = manager.GetTileGroup(tuple_location.block);
+      tile_group_header = tile_group.get()->GetHeader();
+      continue;
+    }
+  }
+  LOG_TRACE("Traverse length: %d\n", (int)chain_length);
+  VersionChainTraversed(chain_length, gc_requested);
+  return true;
+}
+
+bool IndexScanExecutor::ExecPrimaryIndexPointLookup() {
+  LOG_TRACE("Exec primary index point lookup");
+  PL_ASSERT(!done_);
+
+  // Build the key from the bound values
+  auto key_schema = index_->GetKeySchema();
+  auto pool = executor_context_->GetPool();
+  for (oid_t key_column_itr = 0; key_column_itr < point_key_offsets_.size();
+       ++key_column_itr) {
+    auto &value = values_[point_key_offsets_[key_column_itr]];
+    auto key_type = key_schema->GetColumn(key_column_itr).GetType();
+    if (value.GetTypeId() == key_type) {
+      point_key_->SetValue(key_column_itr, value, pool);
+    } else {
+      point_key_->SetValue(key_column_itr, value.CastAs(key_type), pool);
+    }
+  }
+
+  std::vector<ItemPointer *> tuple_location_ptrs;
+  index_->ScanKey(point_key_.get(), tuple_location_ptrs);
+  if (tuple_location_ptrs.empty()) {
+    LOG_TRACE("no tuple is retrieved from index.");
+    return false;
+  }
+
+  // A deleted and re-inserted key has an entry for every version chain until
+  // the GC unlinks the old one, so read the visible version of each
+  bool acquire_owner = GetPlanNode<planner::AbstractScan>().IsForUpdate();
+  bool gc_requested = false;
+  for (auto tuple_location_ptr : tuple_location_ptrs) {
+    ItemPointer visible_location;
+    if (ReadVisibleVersion(*tuple_location_ptr, acquire_owner, gc_requested,
+                           visible_location) == false) {
+      return false;
+    }
+    if (visible_location.IsNull()) continue;
+
+    auto tile_group =
+        catalog::Manager::GetInstance().GetTileGroup(visible_location.block);
+    std::unique_ptr<LogicalTile> logical_tile(LogicalTileFactory::GetTile());
+    logical_tile->AddColumns(tile_group, full_column_ids_);
+    logical_tile->AddPositionList({visible_location.offset});
+    if (column_ids_.size() != 0) {
+      logical_tile->ProjectColumns(full_column_ids_, column_ids_);
+    }
+    result_.push_back(logical_tile.release());
+  }
+
+  done_ = true;
+  return true;
+}
+
+bool IndexScanExecutor::CanProbeKeys(
+    const std::vector<oid_t> &column_ids) const {
+  if (index_->GetIndexType() != IndexConstraintType::PRIMARY_KEY ||
+      limit_ == true) {
+    return false;
+  }
+  for (auto expr_type : expr_types_) {
+    if (expr_type != ExpressionType::COMPARE_EQUAL) return false;
+  }
+
+  // Every key column has to be bound exactly once
+  auto &key_attrs = index_->GetMetadata()->GetKeyAttrs();
+  if (key_column_ids_.size() != key_attrs.size()) return false;
+  for (auto key_attr : key_attrs) {
+    if (std::count(key_column_ids_.begin(), key_column_ids_.end(),
+                   key_attr) != 1) {
+      return false;
+    }
+  }
+
+  for (auto column_id : column_ids) {
+    if (column_id >= column_ids_.size() ||
+        std::find(key_column_ids_.begin(), key_column_ids_.end(),
+                  column_ids_[column_id]) == key_column_ids_.end()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool IndexScanExecutor::ProbeKeys(
+    const std::vector<oid_t> &column_ids,
+    const std::vector<std::vector<type::Value>> &keys,
+    std::vector<std::vector<std::unique_ptr<LogicalTile>>> &result_tiles) {
+  PL_ASSERT(CanProbeKeys(column_ids));
+
+  // Position in values_ of every probed column and of every key column
+  std::vector<size_t> probe_offsets;
+  for (auto column_id : column_ids) {
+    probe_offsets.push_back(std::find(key_column_ids_.begin(),
+                                      key_column_ids_.end(),
+                                      column_ids_[column_id]) -
+                            key_column_ids_.begin());
+  }
+  std::vector<size_t> key_offsets;
+  for (auto key_attr : index_->GetMetadata()->GetKeyAttrs()) {
+    key_offsets.push_back(std::find(key_column_ids_.begin(),
+                                    key_column_ids_.end(), key_attr) -
+                          key_column_ids_.begin());
+  }
+
+  // Build the key tuples
+  auto key_schema = index_->GetKeySchema();
+  auto pool = executor_context_->GetPool();
+  std::vector<std::unique_ptr<storage::Tuple>> key_tuples;
+  std::vector<const storage::Tuple *> key_tuple_ptrs;
+  std::vector<type::Value> values(values_);
+  for (auto &key : keys) {
+    PL_ASSERT(key.size() == probe_offsets.size());
+    for (size_t probe_itr = 0; probe_itr < probe_offsets.size(); probe_itr++) {
+      values[probe_offsets[probe_itr]] = key[probe_itr];
+    }
+
+    std::unique_ptr<storage::Tuple> key_tuple(
+        new storage::Tuple(key_schema, true));
+    for (oid_t key_column_itr = 0; key_column_itr < key_offsets.size();
+         ++key_column_itr) {
+      auto &value = values[key_offsets[key_column_itr]];
+      auto key_type = key_schema->GetColumn(key_column_itr).GetType();
+      if (value.GetTypeId() == key_type) {
+        key_tuple->SetValue(key_column_itr, value, pool);
+      } else {
+        key_tuple->SetValue(key_column_itr, value.CastAs(key_type), pool);
+      }
+    }
+    key_tuple_ptrs.push_back(key_tuple.get());
+    key_tuples.push_back(std::move(key_tuple));
+  }
+
+  std::vector<std::vector<ItemPointer *>> tuple_location_ptrs;
+  index_->ScanKeys(key_tuple_ptrs, tuple_location_ptrs);
+
+  bool acquire_owner = GetPlanNode<planner::AbstractScan>().IsForUpdate();
+  bool gc_requested = false;
+  auto &manager = catalog::Manager::GetInstance();
+  result_tiles.clear();
+  result_tiles.resize(keys.size());
+  for (size_t key_itr = 0; key_itr < keys.size(); key_itr++) {
+    std::map<oid_t, std::vector<oid_t>> visible_tuples;
+    for (auto tuple_location_ptr : tuple_location_ptrs[key_itr]) {
+      ItemPointer visible_location;
+      if (ReadVisibleVersion(*tuple_location_ptr, acquire_owner, gc_requested,
+                             visible_location) == false) {
+        return false;
+      }
+      if (visible_location.IsNull() == false) {
+        visible_tuples[visible_location.block].push_back(
+            visible_location.offset);
+      }
+    }
+
+    // Construct a logical tile for each block
+    for (auto &tuples : visible_tuples) {
+      auto tile_group = manager.GetTileGroup(tuples.first);
+      std::unique_ptr<LogicalTile> logical_tile(LogicalTileFactory::GetTile());
+      logical_tile->AddColumns(tile_group, full_column_ids_);
+      logical_tile->AddPositionList(std::move(tuples.second));
+      if (column_ids_.size() != 0) {
+        logical_tile->ProjectColumns(full_column_ids_, column_ids_);
+      }
+      result_tiles[key_itr].push_back(std::move(logical_tile));
+    }
+  }
+
+  return true;
+}
+
 bool IndexScanExecutor::ExecSecondaryIndexLookup() {
   LOG_TRACE("ExecSecondaryIndexLookup");
   PL_ASSERT(!done_);
@@ -435,6 +647,9 @@ bool IndexScanExecutor::ExecSecondaryIndexLookup() {
   int num_blocks_reused = 0;
 #endif
 
+  // workers help the GC at most once per lookup
+  bool gc_requested = false;
+
   for (auto tuple_location_ptr : tuple_location_ptrs) {
     ItemPointer tuple_location = *tuple_location_ptr;
     if (tuple_location.block != last_block) {
@@ -489,9 +704,9 @@ bool IndexScanExecutor::ExecSecondaryIndexLookup() {
           break;
         }
 
-        bool eval = true;
+        bool eval = PassesRuntimeFilter(&candidate_tuple);
         // if having predicate, then perform evaluation.
-        if (predicate_ != nullptr) {
+        if (eval == true && predicate_ != nullptr) {
           eval = predicate_->Evaluate(&candidate_tuple, nullptr,
                                       executor_context_).IsTrue();
         }
@@ -570,6 +785,7 @@ bool IndexScanExecutor::ExecSecondaryIndexLookup() {
       }
     }
     LOG_TRACE("Traverse length: %d\n", (int)chain_length);
+    VersionChainTraversed(chain_length, gc_requested);
   }
 #ifdef LOG_TRACE_ENABLED
   LOG_TRACE("Examined %d tuples from index %s [num_blocks_reused=%d]",
@@ -607,6 +823,20 @@ bool IndexScanExecutor::ExecSecondaryIndexLookup() {
   return true;
 }
 
+void IndexScanExecutor::VersionChainTraversed(const size_t chain_length,
+                                              bool &gc_requested) {
+  if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
+    stats::BackendStatsContext::GetInstance()->GetVersionChainLengths().Record(
+        chain_length);
+  }
+
+  // Long chains mean the GC is lagging behind, lend it a hand
+  if (gc_requested == false && chain_length > COOPERATIVE_GC_CHAIN_LENGTH) {
+    gc_requested = true;
+    gc::GCManagerFactory::GetInstance().CooperativeCollect();
+  }
+}
+
 void IndexScanExecutor::CheckOpenRangeWithReturnedTuples(
     std::vector<ItemPointer> &tuple_locations) {
   while (left_open_) {
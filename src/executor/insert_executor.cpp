@@ -90,37 +90,28 @@ bool InsertExecutor::DExecute() {
     auto target_table_schema = target_table->GetSchema();
     auto column_count = target_table_schema->GetColumnCount();
 
-    std::unique_ptr<storage::Tuple> tuple(
-        new storage::Tuple(target_table_schema, true));
-
-    // Go over the logical tile
+    // Materialize the logical tile and insert it as one batch
+    std::vector<std::unique_ptr<storage::Tuple>> tuples;
+    std::vector<const storage::Tuple *> batch;
     for (oid_t tuple_id : *logical_tile) {
       expression::ContainerTuple<LogicalTile> cur_tuple(logical_tile.get(),
                                                         tuple_id);
 
-      // Materialize the logical tile tuple
+      std::unique_ptr<storage::Tuple> tuple(
+          new storage::Tuple(target_table_schema, true));
       for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
         type::Value val = (cur_tuple.GetValue(column_itr));
         tuple->SetValue(column_itr, val, executor_pool);
       }
+      batch.push_back(tuple.get());
+      tuples.push_back(std::move(tuple));
+    }
 
-      // insert tuple into the table.
-      ItemPointer *index_entry_ptr = nullptr;
-      peloton::ItemPointer location =
-          target_table->InsertTuple(tuple.get(), current_txn, &index_entry_ptr);
-
-      // it is possible that some concurrent transactions have inserted the same
-      // tuple.
-      // in this case, abort the transaction.
-      if (location.block == INVALID_OID) {
-        transaction_manager.SetTransactionResult(
-            current_txn, peloton::ResultType::FAILURE);
-        return false;
-      }
-
-      transaction_manager.PerformInsert(current_txn, location, index_entry_ptr);
-
-      executor_context_->num_processed += 1;  // insert one
+    // it is possible that some concurrent transactions have inserted the same
+    // tuple.
+    // in this case, abort the transaction.
+    if (InsertBatch(target_table, batch) == false) {
+      return false;
     }
 
     return true;
@@ -155,6 +146,21 @@ bool InsertExecutor::DExecute() {
       tuple = project_tuple.get();
     }
 
+    // Multi-row VALUES lists go into the table as one batch
+    if (!project_info && bulk_insert_count > 1) {
+      std::vector<const storage::Tuple *> batch;
+      for (oid_t insert_itr = 0; insert_itr < bulk_insert_count;
+           insert_itr++) {
+        batch.push_back(node.GetTuple(insert_itr));
+      }
+      if (InsertBatch(target_table, batch) == false) {
+        return false;
+      }
+
+      done_ = true;
+      return true;
+    }
+
     // Bulk Insert Mode
     for (oid_t insert_itr = 0; insert_itr < bulk_insert_count; insert_itr++) {
       // if we are doing a bulk insert from values not project_info
@@ -194,5 +200,31 @@ bool InsertExecutor::DExecute() {
   return true;
 }
 
+/**
+ * @brief Inserts the tuples with one batched table insert.
+ * @return false if the transaction has to abort.
+ */
+bool InsertExecutor::InsertBatch(
+    storage::DataTable *target_table,
+    const std::vector<const storage::Tuple *> &tuples) {
+  if (tuples.empty()) {
+    return true;
+  }
+
+  auto &transaction_manager =
+      concurrency::TransactionManagerFactory::GetInstance();
+  auto current_txn = executor_context_->GetTransaction();
+
+  if (target_table->InsertTuples(tuples, current_txn) == false) {
+    LOG_TRACE("Failed to Insert. Set txn failure.");
+    transaction_manager.SetTransactionResult(current_txn, ResultType::FAILURE);
+    return false;
+  }
+
+  LOG_TRACE("Inserted a batch of %lu tuples", tuples.size());
+  executor_context_->num_processed += tuples.size();
+  return true;
+}
+
 }  // namespace executor
 }  // namespace peloton
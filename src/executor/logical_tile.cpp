@@ -516,233 +516,71 @@ const std::string LogicalTile::GetInfo() const {
   return os.str();
 }
 
-/**
- * @brief Generates map from each base tile to columns originally from that
- *        base tile to be materialized.
- * @param column_ids Ids of columns to be materialized.
- * @param source_tile Logical tile that contains mapping from columns to
- *        base tiles.
- * @param tile_to_cols Map to be populated with mappings from tile to columns.
- *
- * We generate this mapping so that we can materialize columns tile by tile for
- * efficiency reasons.
- */
-void LogicalTile::GenerateTileToColMap(
-    const std::unordered_map<oid_t, oid_t> &old_to_new_cols,
-    std::unordered_map<storage::Tile *, std::vector<oid_t>>
-        &cols_in_physical_tile) {
-  for (const auto &kv : old_to_new_cols) {
-    oid_t col = kv.first;
-
-    // figure out base physical tile for column in logical tile
-    storage::Tile *base_tile = GetBaseTile(col);
-
-    std::vector<oid_t> &cols_from_tile = cols_in_physical_tile[base_tile];
-    cols_from_tile.push_back(col);
+LogicalTile::ColumnGather::ColumnGather(const LogicalTile *source_tile,
+                                        oid_t column_id,
+                                        storage::Tile *dest_tile,
+                                        oid_t dest_column_id)
+    : dest_tile_(dest_tile) {
+  auto &column_info = source_tile->GetColumnInfo(column_id);
+  position_list_ = &source_tile->GetPositionList(column_info.position_list_idx);
+
+  source_tile_ = column_info.base_tile.get();
+  auto source_schema = source_tile_->GetSchema();
+  oid_t source_column_id = column_info.origin_column_id;
+  source_offset_ = source_schema->GetOffset(source_column_id);
+  source_type_ = source_schema->GetType(source_column_id);
+  source_inlined_ = source_schema->IsInlined(source_column_id);
+
+  auto dest_schema = dest_tile_->GetSchema();
+  dest_offset_ = dest_schema->GetOffset(dest_column_id);
+  dest_inlined_ = dest_schema->IsInlined(dest_column_id);
+  dest_length_ = dest_schema->GetAppropriateLength(dest_column_id);
+
+  // Strings keep their length inline, only values of fixed size are copied
+  // as bytes
+  byte_copy_ = source_tile_->IsCompressed() == false &&
+               source_inlined_ == true && dest_inlined_ == true &&
+               source_type_ == dest_schema->GetType(dest_column_id) &&
+               source_type_ != type::Type::VARCHAR &&
+               source_type_ != type::Type::VARBINARY &&
+               source_schema->GetLength(source_column_id) ==
+                   dest_schema->GetLength(dest_column_id);
+  if (byte_copy_ == true) {
+    source_data_ = source_tile_->GetTupleLocation(0) + source_offset_;
+    source_tuple_length_ = source_schema->GetLength();
+    dest_data_ = dest_tile_->GetTupleLocation(0) + dest_offset_;
+    dest_tuple_length_ = dest_schema->GetLength();
+    value_length_ = source_schema->GetLength(source_column_id);
   }
 }
 
+void LogicalTile::ColumnGather::CopyValue(oid_t base_tuple_id,
+                                          oid_t dest_tuple_id) {
+  type::Value value =
+      base_tuple_id == NULL_OID
+          ? type::ValueFactory::GetNullValueByType(source_type_)
+          : source_tile_->GetValueFast(base_tuple_id, source_offset_,
+                                       source_type_, source_inlined_);
+  dest_tile_->SetValueFast(value, dest_tuple_id, dest_offset_, dest_inlined_,
+                           dest_length_);
+}
+
 /**
- * @brief Does the actual copying of data into the new physical tile.
- * @param source_tile Source tile to copy data from.
- * @param tile_to_cols Map from base tile to columns in that tile
- *        to be materialized.
+ * @brief Copies the visible rows of the columns into a physical tile. Every
+ * column is gathered on its own, so a base tile is read a column at a time.
+ * @param old_to_new_cols Map from columns of this tile to columns of the
+ *        physical tile.
  * @param dest_tile New tile to copy data into.
  */
-void LogicalTile::MaterializeByTiles(
-    const std::unordered_map<oid_t, oid_t> &old_to_new_cols,
-    const std::unordered_map<storage::Tile *, std::vector<oid_t>> &tile_to_cols,
-    storage::Tile *dest_tile) {
-  bool row_wise_materialization = true;
-
-  if (peloton_layout_mode == LAYOUT_TYPE_COLUMN)
-    row_wise_materialization = false;
-
-  // TODO: Make this a parameter
-  auto dest_tile_column_count = dest_tile->GetColumnCount();
-  oid_t column_count_threshold = 20;
-  if (peloton_layout_mode == LAYOUT_TYPE_HYBRID &&
-      dest_tile_column_count <= column_count_threshold)
-    row_wise_materialization = false;
-
-  // Materialize as needed
-  if (row_wise_materialization == true) {
-    MaterializeRowAtAtATime(old_to_new_cols, tile_to_cols, dest_tile);
-  } else {
-    MaterializeColumnAtATime(old_to_new_cols, tile_to_cols, dest_tile);
-  }
-}
-
-void LogicalTile::MaterializeRowAtAtATime(
-    const std::unordered_map<oid_t, oid_t> &old_to_new_cols,
-    const std::unordered_map<storage::Tile *, std::vector<oid_t>> &tile_to_cols,
-    storage::Tile *dest_tile) {
-  ///////////////////////////
-  // EACH PHYSICAL TILE
-  ///////////////////////////
-  // Copy over all data from each base tile.
-  for (const auto &kv : tile_to_cols) {
-    const std::vector<oid_t> &old_column_ids = kv.second;
-
-    auto &schema = GetSchema();
-    oid_t new_tuple_id = 0;
-
-    auto &column_position_lists = GetPositionLists();
-
-    // Get old column information
-    std::vector<oid_t> old_column_position_idxs;
-    std::vector<size_t> old_column_offsets;
-    std::vector<type::Type::TypeId> old_column_types;
-    std::vector<bool> old_is_inlineds;
-    std::vector<storage::Tile *> old_tiles;
-
-    // Get new column information
-    std::vector<size_t> new_column_offsets;
-    std::vector<bool> new_is_inlineds;
-    std::vector<size_t> new_column_lengths;
-
-    // Amortize schema lookups once per column
-    for (oid_t old_col_id : old_column_ids) {
-      auto &column_info = schema[old_col_id];
-
-      // Get the position list
-      old_column_position_idxs.push_back(column_info.position_list_idx);
-
-      // Get old column information
-      storage::Tile *old_tile = column_info.base_tile.get();
-      old_tiles.push_back(old_tile);
-      auto old_schema = old_tile->GetSchema();
-      oid_t old_column_id = column_info.origin_column_id;
-      const size_t old_column_offset = old_schema->GetOffset(old_column_id);
-      old_column_offsets.push_back(old_column_offset);
-      const type::Type::TypeId old_column_type =
-          old_schema->GetType(old_column_id);
-      old_column_types.push_back(old_column_type);
-      const bool old_is_inlined = old_schema->IsInlined(old_column_id);
-      old_is_inlineds.push_back(old_is_inlined);
-
-      // Old to new column mapping
-      auto it = old_to_new_cols.find(old_col_id);
-      PL_ASSERT(it != old_to_new_cols.end());
-
-      // Get new column information
-      oid_t new_column_id = it->second;
-      auto new_schema = dest_tile->GetSchema();
-      const size_t new_column_offset = new_schema->GetOffset(new_column_id);
-      new_column_offsets.push_back(new_column_offset);
-      const bool new_is_inlined = new_schema->IsInlined(new_column_id);
-      new_is_inlineds.push_back(new_is_inlined);
-      const size_t new_column_length =
-          new_schema->GetAppropriateLength(new_column_id);
-      new_column_lengths.push_back(new_column_length);
-    }
-
-    PL_ASSERT(new_column_offsets.size() == old_column_ids.size());
-
-    ///////////////////////////
-    // EACH TUPLE
-    ///////////////////////////
-    // Copy all values in the tuple to the physical tile
-    // This uses fast getter and setter functions
-    for (oid_t old_tuple_id : *this) {
-      ///////////////////////////
-      // EACH COLUMN
-      ///////////////////////////
-      // Go over each column in given base physical tile
-      oid_t col_itr = 0;
-
-      for (oid_t old_col_id : old_column_position_idxs) {
-        auto &column_position_list = column_position_lists[old_col_id];
-
-        oid_t base_tuple_id = column_position_list[old_tuple_id];
-
-        auto value = old_tiles[col_itr]->GetValueFast(
-            base_tuple_id, old_column_offsets[col_itr],
-            old_column_types[col_itr], old_is_inlineds[col_itr]);
-
-        LOG_TRACE("Old Tuple : %u Column : %u ", old_tuple_id, old_col_id);
-        LOG_TRACE("New Tuple : %u Column : %lu ", new_tuple_id,
-                  new_column_offsets[col_itr]);
-
-        dest_tile->SetValueFast(
-            value, new_tuple_id, new_column_offsets[col_itr],
-            new_is_inlineds[col_itr], new_column_lengths[col_itr]);
-
-        // Go to next column
-        col_itr++;
-      }
-
-      // Go to next tuple
-      new_tuple_id++;
-    }
-  }
-}
-
-void LogicalTile::MaterializeColumnAtATime(
+void LogicalTile::MaterializeColumns(
     const std::unordered_map<oid_t, oid_t> &old_to_new_cols,
-    const std::unordered_map<storage::Tile *, std::vector<oid_t>> &tile_to_cols,
     storage::Tile *dest_tile) {
-  ///////////////////////////
-  // EACH PHYSICAL TILE
-  ///////////////////////////
-  // Copy over all data from each base tile.
-  for (const auto &kv : tile_to_cols) {
-    const std::vector<oid_t> &old_column_ids = kv.second;
-
-    ///////////////////////////
-    // EACH COLUMN
-    ///////////////////////////
-    // Go over each column in given base physical tile
-    for (oid_t old_col_id : old_column_ids) {
-      auto &column_info = GetColumnInfo(old_col_id);
-
-      // Amortize schema lookups once per column
-      storage::Tile *old_tile = column_info.base_tile.get();
-      auto old_schema = old_tile->GetSchema();
-
-      // Get old column information
-      oid_t old_column_id = column_info.origin_column_id;
-      const size_t old_column_offset = old_schema->GetOffset(old_column_id);
-      const type::Type::TypeId old_column_type =
-          old_schema->GetType(old_column_id);
-      const bool old_is_inlined = old_schema->IsInlined(old_column_id);
-
-      // Old to new column mapping
-      auto it = old_to_new_cols.find(old_col_id);
-      PL_ASSERT(it != old_to_new_cols.end());
-
-      // Get new column information
-      oid_t new_column_id = it->second;
-      auto new_schema = dest_tile->GetSchema();
-      const size_t new_column_offset = new_schema->GetOffset(new_column_id);
-      const bool new_is_inlined = new_schema->IsInlined(new_column_id);
-      const size_t new_column_length =
-          new_schema->GetAppropriateLength(new_column_id);
-
-      // Get the position list
-      auto &column_position_list =
-          GetPositionList(column_info.position_list_idx);
-      oid_t new_tuple_id = 0;
-
-      // Copy all values in the column to the physical tile
-      // This uses fast getter and setter functions
-      ///////////////////////////
-      // EACH TUPLE
-      ///////////////////////////
-      for (oid_t old_tuple_id : *this) {
-        oid_t base_tuple_id = column_position_list[old_tuple_id];
-        type::Value value = (old_tile->GetValueFast(
-            base_tuple_id, old_column_offset, old_column_type, old_is_inlined));
-
-        LOG_TRACE("Old Tuple : %u Column : %u ", old_tuple_id, old_col_id);
-        LOG_TRACE("New Tuple : %u Column : %u ", new_tuple_id, new_column_id);
-
-        dest_tile->SetValueFast(value, new_tuple_id, new_column_offset,
-                                new_is_inlined, new_column_length);
-
-        // Go to next tuple
-        new_tuple_id++;
-      }
+  std::vector<oid_t> tuple_ids(begin(), end());
+  for (auto &kv : old_to_new_cols) {
+    ColumnGather gather(this, kv.first, dest_tile, kv.second);
+    for (oid_t new_tuple_id = 0; new_tuple_id < tuple_ids.size();
+         new_tuple_id++) {
+      gather.Copy(tuple_ids[new_tuple_id], new_tuple_id);
     }
   }
 }
@@ -766,16 +604,11 @@ std::unique_ptr<storage::Tile> LogicalTile::Materialize() {
     old_to_new_cols[col] = col;
   }
 
-  // Generate mappings.
-  std::unordered_map<storage::Tile *, std::vector<oid_t>> tile_to_cols;
-  GenerateTileToColMap(old_to_new_cols, tile_to_cols);
-
   // Create new physical tile.
   std::unique_ptr<storage::Tile> dest_tile(
       storage::TileFactory::GetTempTile(*source_tile_schema, num_tuples));
 
-  // Proceed to materialize logical tile by physical tile at a time.
-  MaterializeByTiles(old_to_new_cols, tile_to_cols, dest_tile.get());
+  MaterializeColumns(old_to_new_cols, dest_tile.get());
 
   // Wrap physical tile in logical tile.
   return std::move(dest_tile);
@@ -11,6 +11,12 @@
 //===----------------------------------------------------------------------===//
 
 
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "type/types.h"
@@ -23,6 +29,141 @@
 namespace peloton {
 namespace executor {
 
+namespace {
+
+// Inputs get another thread for every this many rows
+const size_t min_rows_per_thread = 1 << 12;
+
+// Keys sampled per partition to pick the key ranges of the partitions
+const size_t samples_per_partition = 64;
+
+const uint64_t sign_bit = 1ULL << 63;
+
+bool IsInteger(const type::Type::TypeId type_id) {
+  switch (type_id) {
+    case type::Type::BOOLEAN:
+    case type::Type::TINYINT:
+    case type::Type::SMALLINT:
+    case type::Type::INTEGER:
+    case type::Type::BIGINT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool IsString(const type::Type::TypeId type_id) {
+  return type_id == type::Type::VARCHAR || type_id == type::Type::VARBINARY;
+}
+
+int64_t GetInteger(const type::Value &value) {
+  switch (value.GetTypeId()) {
+    case type::Type::BOOLEAN:
+    case type::Type::TINYINT:
+      return value.GetAs<int8_t>();
+    case type::Type::SMALLINT:
+      return value.GetAs<int16_t>();
+    case type::Type::INTEGER:
+      return value.GetAs<int32_t>();
+    default:
+      return value.GetAs<int64_t>();
+  }
+}
+
+void AppendUint64(std::vector<char> &bytes, uint64_t key) {
+  for (int shift = 56; shift >= 0; shift -= 8) {
+    bytes.push_back(static_cast<char>((key >> shift) & 0xff));
+  }
+}
+
+// Zero bytes are escaped and the string ends with two of them, so no
+// string is a prefix of another
+void AppendString(std::vector<char> &bytes, const char *data, size_t length) {
+  for (size_t byte_itr = 0; byte_itr < length; byte_itr++) {
+    bytes.push_back(data[byte_itr]);
+    if (data[byte_itr] == 0) bytes.push_back(1);
+  }
+  bytes.push_back(0);
+  bytes.push_back(0);
+}
+
+// Runs the task for every index, on as many threads. An exception of a task
+// is rethrown on the calling thread once all threads are done.
+void RunParallel(size_t count, const std::function<void(size_t)> &task) {
+  std::vector<std::exception_ptr> exceptions(count);
+  auto run_task = [&](size_t index) {
+    try {
+      task(index);
+    } catch (...) {
+      exceptions[index] = std::current_exception();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t index = 1; index < count; index++) {
+    threads.emplace_back(run_task, index);
+  }
+  run_task(0);
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  for (auto &exception : exceptions) {
+    if (exception != nullptr) std::rethrow_exception(exception);
+  }
+}
+
+}  // namespace
+
+// A row of an input and its normalized join key. Equal keys have equal
+// bytes, and the bytes of all keys are ordered, though not like the values.
+struct MergeJoinExecutor::SortEntry {
+  // The first bytes of the key, most significant first
+  uint64_t prefix;
+  const char *key;
+  uint32_t key_size;
+  oid_t tile;
+  oid_t row;
+
+  inline int Compare(const SortEntry &other) const {
+    if (prefix != other.prefix) return prefix < other.prefix ? -1 : 1;
+    if (key_size <= sizeof(prefix) && other.key_size <= sizeof(prefix)) {
+      return int(key_size) - int(other.key_size);
+    }
+    int cmp = memcmp(key, other.key, std::min(key_size, other.key_size));
+    return cmp != 0 ? cmp : int(key_size) - int(other.key_size);
+  }
+
+  inline bool operator<(const SortEntry &other) const {
+    return Compare(other) < 0;
+  }
+};
+
+// The keys one thread normalized
+struct MergeJoinExecutor::KeyRun {
+  std::vector<char> bytes;
+  std::vector<SortEntry> entries;
+
+  // The entries of every partition
+  std::vector<std::vector<SortEntry>> partitions;
+};
+
+// The rows of both inputs in a key range and the pairs of them that join
+struct MergeJoinExecutor::Partition {
+  std::vector<SortEntry> left;
+  std::vector<SortEntry> right;
+  std::vector<std::pair<size_t, size_t>> matches;
+  std::vector<bool> left_matched;
+  std::vector<bool> right_matched;
+};
+
+size_t MergeJoinExecutor::sort_thread_count_ =
+    std::max(1U, std::thread::hardware_concurrency());
+
+void MergeJoinExecutor::SetSortThreadCount(size_t sort_thread_count) {
+  sort_thread_count_ = std::max<size_t>(1, sort_thread_count);
+}
+
 /**
  * @brief Constructor for nested loop join executor.
  * @param node Nested loop join node corresponding to this executor.
@@ -43,6 +184,10 @@ bool MergeJoinExecutor::DInit() {
 
   if (join_clauses_ == nullptr) return false;
 
+  sort_inputs_ = node.GetSortInputs();
+  sort_merge_done_ = false;
+  sorted_output_tiles_.clear();
+
   return true;
 }
 
@@ -59,6 +204,20 @@ bool MergeJoinExecutor::DExecute() {
       left_start_row, left_end_row, left_child_done_, right_start_row,
       right_end_row, right_child_done_);
 
+  // Unsorted inputs are joined as a whole
+  if (sort_inputs_ == true) {
+    if (sort_merge_done_ == false) {
+      SortMergeJoin();
+      sort_merge_done_ = true;
+    }
+    if (sorted_output_tiles_.empty() == false) {
+      SetOutput(sorted_output_tiles_.front().release());
+      sorted_output_tiles_.pop_front();
+      return true;
+    }
+    return BuildOuterJoinOutput();
+  }
+
   // Build outer join output when done
   if (right_child_done_ && left_child_done_) {
     return BuildOuterJoinOutput();
@@ -149,6 +308,20 @@ bool MergeJoinExecutor::DExecute() {
       auto right_value =
           clause.right_->Evaluate(&left_tuple, &right_tuple, nullptr);
 
+      // A NULL key never matches, skip its rows
+      if (left_value.IsNull()) {
+        left_start_row = left_end_row;
+        left_end_row = Advance(left_tile, left_start_row, true);
+        not_matching_tuple_pair = true;
+        break;
+      }
+      if (right_value.IsNull()) {
+        right_start_row = right_end_row;
+        right_end_row = Advance(right_tile, right_start_row, false);
+        not_matching_tuple_pair = true;
+        break;
+      }
+
       // Left key < Right key, advance left
       if (left_value.CompareLessThan(right_value) == type::CMP_TRUE) {
         LOG_TRACE("left < right, advance left ");
@@ -178,28 +351,22 @@ bool MergeJoinExecutor::DExecute() {
     // Join clauses matched, try to match predicate
     LOG_TRACE("one pair of tuples matches join clause ");
 
-    // Join predicate exists
-    if (predicate_ != nullptr) {
-      auto eval = predicate_->Evaluate(&left_tuple,
-                                      &right_tuple, executor_context_);
-      if (eval.IsFalse()) {
-      //if (predicate_->Evaluate(&left_tuple, &right_tuple, executor_context_)
-      //        .IsFalse()) {
-        // Join predicate is false. Advance both.
-        left_start_row = left_end_row;
-        left_end_row = Advance(left_tile, left_start_row, true);
-
-        right_start_row = right_end_row;
-        right_end_row = Advance(right_tile, right_start_row, false);
-      }
-    }
-
-    // Sub tile matched, do a Cartesian product
-    // Go over every pair of tuples in left and right logical tiles
+    // Sub tile matched, do a Cartesian product of the pairs that satisfy the
+    // join predicate
     for (size_t left_tile_row_itr = left_start_row;
          left_tile_row_itr < left_end_row; left_tile_row_itr++) {
       for (size_t right_tile_row_itr = right_start_row;
            right_tile_row_itr < right_end_row; right_tile_row_itr++) {
+        if (predicate_ != nullptr) {
+          expression::ContainerTuple<executor::LogicalTile> left_row(
+              left_tile, left_tile_row_itr);
+          expression::ContainerTuple<executor::LogicalTile> right_row(
+              right_tile, right_tile_row_itr);
+          auto eval =
+              predicate_->Evaluate(&left_row, &right_row, executor_context_);
+          if (eval.IsTrue() == false) continue;
+        }
+
         // Insert a tuple into the output logical tile
         pos_lists_builder.AddRow(left_tile_row_itr, right_tile_row_itr);
 
@@ -230,10 +397,322 @@ bool MergeJoinExecutor::DExecute() {
     // If we are out of any more pairs of child tiles to examine,
     // then we will return false earlier in this function
     // So, no need to return false here
-    DExecute();
+    return DExecute();
+  }
+}
+
+/**
+ * @brief Buffers both inputs, partitions their rows by ranges of the
+ * normalized join keys and sorts and merges the partitions in parallel. The
+ * matches are grouped into one output tile per pair of input tiles.
+ */
+void MergeJoinExecutor::SortMergeJoin() {
+  while (children_[0]->Execute()) {
+    BufferLeftTile(children_[0]->GetOutput());
+  }
+  left_child_done_ = true;
+  while (children_[1]->Execute()) {
+    BufferRightTile(children_[1]->GetOutput());
+  }
+  right_child_done_ = true;
+
+  size_t row_count = 0;
+  LogicalTile *first_tiles[2] = {nullptr, nullptr};
+  for (auto &tile : left_result_tiles_) {
+    row_count += tile->GetTupleCount();
+    if (first_tiles[0] == nullptr && tile->GetTupleCount() > 0) {
+      first_tiles[0] = tile.get();
+    }
+  }
+  for (auto &tile : right_result_tiles_) {
+    row_count += tile->GetTupleCount();
+    if (first_tiles[1] == nullptr && tile->GetTupleCount() > 0) {
+      first_tiles[1] = tile.get();
+    }
   }
 
-  return true;
+  // Nothing joins with an empty input
+  if (first_tiles[0] == nullptr || first_tiles[1] == nullptr) return;
+
+  // The values of a column share a type, the first row tells the kind of
+  // every clause
+  key_kinds_.clear();
+  expression::ContainerTuple<LogicalTile> left_tuple(
+      first_tiles[0], *first_tiles[0]->begin());
+  expression::ContainerTuple<LogicalTile> right_tuple(
+      first_tiles[1], *first_tiles[1]->begin());
+  for (auto &clause : *join_clauses_) {
+    auto left_type =
+        clause.left_->Evaluate(&left_tuple, &left_tuple, executor_context_)
+            .GetTypeId();
+    auto right_type =
+        clause.right_->Evaluate(&right_tuple, &right_tuple, executor_context_)
+            .GetTypeId();
+    if (IsInteger(left_type) && IsInteger(right_type)) {
+      key_kinds_.push_back(KeyKind::INTEGER);
+    } else if ((IsInteger(left_type) || left_type == type::Type::DECIMAL) &&
+               (IsInteger(right_type) || right_type == type::Type::DECIMAL)) {
+      key_kinds_.push_back(KeyKind::DECIMAL);
+    } else if (left_type == type::Type::TIMESTAMP &&
+               right_type == type::Type::TIMESTAMP) {
+      key_kinds_.push_back(KeyKind::TIMESTAMP);
+    } else if (IsString(left_type) && IsString(right_type)) {
+      key_kinds_.push_back(KeyKind::STRING);
+    } else {
+      key_kinds_.push_back(KeyKind::TEXT);
+    }
+  }
+
+  size_t thread_count = std::max<size_t>(
+      1, std::min(sort_thread_count_, row_count / min_rows_per_thread));
+
+  // Normalize the keys, every thread takes some of the tiles of each side
+  std::vector<KeyRun> left_runs(thread_count), right_runs(thread_count);
+  RunParallel(thread_count, [&](size_t thread_itr) {
+    ExtractKeys(true, thread_itr, thread_count, left_runs[thread_itr]);
+    ExtractKeys(false, thread_itr, thread_count, right_runs[thread_itr]);
+  });
+
+  // Pick the key ranges of the partitions from a sample of both sides
+  std::vector<SortEntry> samples;
+  size_t sample_count = samples_per_partition * thread_count;
+  for (auto runs : {&left_runs, &right_runs}) {
+    for (auto &run : *runs) {
+      size_t step = std::max<size_t>(
+          1, run.entries.size() * thread_count / sample_count);
+      for (size_t entry_itr = 0; entry_itr < run.entries.size();
+           entry_itr += step) {
+        samples.push_back(run.entries[entry_itr]);
+      }
+    }
+  }
+  std::sort(samples.begin(), samples.end());
+  std::vector<SortEntry> splitters;
+  for (size_t partition_itr = 1;
+       partition_itr < thread_count && samples.empty() == false;
+       partition_itr++) {
+    auto &splitter = samples[samples.size() * partition_itr / thread_count];
+    if (splitters.empty() || splitters.back() < splitter) {
+      splitters.push_back(splitter);
+    }
+  }
+  size_t partition_count = splitters.size() + 1;
+
+  // Scatter the rows, equal keys of both sides go to the same partition
+  RunParallel(thread_count, [&](size_t thread_itr) {
+    for (auto run : {&left_runs[thread_itr], &right_runs[thread_itr]}) {
+      run->partitions.resize(partition_count);
+      for (auto &entry : run->entries) {
+        auto partition_itr =
+            std::upper_bound(splitters.begin(), splitters.end(), entry) -
+            splitters.begin();
+        run->partitions[partition_itr].push_back(entry);
+      }
+    }
+  });
+
+  // Sort and merge the partitions
+  std::vector<Partition> partitions(partition_count);
+  RunParallel(thread_count, [&](size_t thread_itr) {
+    for (size_t partition_itr = thread_itr; partition_itr < partition_count;
+         partition_itr += thread_count) {
+      auto &partition = partitions[partition_itr];
+      for (size_t run_itr = 0; run_itr < thread_count; run_itr++) {
+        auto &left = left_runs[run_itr].partitions[partition_itr];
+        auto &right = right_runs[run_itr].partitions[partition_itr];
+        partition.left.insert(partition.left.end(), left.begin(), left.end());
+        partition.right.insert(partition.right.end(), right.begin(),
+                               right.end());
+      }
+      MergePartition(partition);
+    }
+  });
+
+  // Group the matches by their pair of tiles
+  std::unordered_map<uint64_t, size_t> output_offsets;
+  std::vector<std::unique_ptr<LogicalTile>> output_tiles;
+  std::vector<LogicalTile::PositionListsBuilder> builders;
+  for (auto &partition : partitions) {
+    for (size_t entry_itr = 0; entry_itr < partition.left.size();
+         entry_itr++) {
+      if (partition.left_matched[entry_itr]) {
+        RecordMatchedLeftRow(partition.left[entry_itr].tile,
+                             partition.left[entry_itr].row);
+      }
+    }
+    for (size_t entry_itr = 0; entry_itr < partition.right.size();
+         entry_itr++) {
+      if (partition.right_matched[entry_itr]) {
+        RecordMatchedRightRow(partition.right[entry_itr].tile,
+                              partition.right[entry_itr].row);
+      }
+    }
+
+    for (auto &match : partition.matches) {
+      auto &left = partition.left[match.first];
+      auto &right = partition.right[match.second];
+      uint64_t tile_pair = (uint64_t(left.tile) << 32) | right.tile;
+      auto offset_itr = output_offsets.find(tile_pair);
+      if (offset_itr == output_offsets.end()) {
+        auto left_tile = left_result_tiles_[left.tile].get();
+        auto right_tile = right_result_tiles_[right.tile].get();
+        offset_itr =
+            output_offsets.emplace(tile_pair, output_tiles.size()).first;
+        output_tiles.push_back(BuildOutputLogicalTile(left_tile, right_tile));
+        builders.emplace_back(left_tile, right_tile);
+      }
+      builders[offset_itr->second].AddRow(left.row, right.row);
+    }
+  }
+
+  for (size_t tile_itr = 0; tile_itr < output_tiles.size(); tile_itr++) {
+    output_tiles[tile_itr]->SetPositionListsAndVisibility(
+        builders[tile_itr].Release());
+    sorted_output_tiles_.push_back(std::move(output_tiles[tile_itr]));
+  }
+
+  LOG_TRACE("Sort merge join of %lu rows on %lu threads: %lu tiles",
+            row_count, thread_count, sorted_output_tiles_.size());
+}
+
+void MergeJoinExecutor::ExtractKeys(bool is_left, size_t first_tile,
+                                    size_t thread_count, KeyRun &run) const {
+  auto &tiles = is_left ? left_result_tiles_ : right_result_tiles_;
+  std::vector<size_t> key_offsets;
+  for (size_t tile_itr = first_tile; tile_itr < tiles.size();
+       tile_itr += thread_count) {
+    auto tile = tiles[tile_itr].get();
+    for (oid_t row : *tile) {
+      expression::ContainerTuple<LogicalTile> tuple(tile, row);
+      size_t key_offset = run.bytes.size();
+      bool has_null = false;
+      for (size_t clause_itr = 0; clause_itr < join_clauses_->size();
+           clause_itr++) {
+        auto &clause = (*join_clauses_)[clause_itr];
+        auto expr = is_left ? clause.left_.get() : clause.right_.get();
+        auto value = expr->Evaluate(&tuple, &tuple, executor_context_);
+
+        // A NULL key never matches, the row is left out
+        if (value.IsNull()) {
+          has_null = true;
+          break;
+        }
+
+        switch (key_kinds_[clause_itr]) {
+          case KeyKind::INTEGER:
+            AppendUint64(run.bytes,
+                         static_cast<uint64_t>(GetInteger(value)) ^ sign_bit);
+            break;
+          case KeyKind::DECIMAL: {
+            double decimal = IsInteger(value.GetTypeId())
+                                 ? double(GetInteger(value))
+                                 : value.GetAs<double>();
+            // Zero is equal to minus zero
+            if (decimal == 0) decimal = 0;
+            uint64_t bits;
+            std::memcpy(&bits, &decimal, sizeof(bits));
+            AppendUint64(run.bytes,
+                         (bits & sign_bit) ? ~bits : bits | sign_bit);
+            break;
+          }
+          case KeyKind::TIMESTAMP:
+            AppendUint64(run.bytes, value.GetAs<uint64_t>());
+            break;
+          case KeyKind::STRING:
+            AppendString(run.bytes, value.GetData(), value.GetLength());
+            break;
+          case KeyKind::TEXT: {
+            auto text = value.ToString();
+            AppendString(run.bytes, text.data(), text.size());
+            break;
+          }
+        }
+      }
+      if (has_null) {
+        run.bytes.resize(key_offset);
+        continue;
+      }
+
+      SortEntry entry;
+      entry.key = nullptr;
+      entry.key_size = run.bytes.size() - key_offset;
+      entry.tile = tile_itr;
+      entry.row = row;
+      entry.prefix = 0;
+      for (size_t byte_itr = 0; byte_itr < sizeof(entry.prefix); byte_itr++) {
+        uint64_t byte = byte_itr < entry.key_size
+                            ? uint8_t(run.bytes[key_offset + byte_itr])
+                            : 0;
+        entry.prefix = (entry.prefix << 8) | byte;
+      }
+      run.entries.push_back(entry);
+      key_offsets.push_back(key_offset);
+    }
+  }
+
+  // The bytes do not move anymore
+  for (size_t entry_itr = 0; entry_itr < run.entries.size(); entry_itr++) {
+    run.entries[entry_itr].key = run.bytes.data() + key_offsets[entry_itr];
+  }
+}
+
+/**
+ * @brief Sorts both sides of a partition and joins every run of equal keys
+ * of the left side with the one of the right side, if there is one.
+ */
+void MergeJoinExecutor::MergePartition(Partition &partition) const {
+  auto &left = partition.left;
+  auto &right = partition.right;
+  std::sort(left.begin(), left.end());
+  std::sort(right.begin(), right.end());
+  partition.left_matched.assign(left.size(), false);
+  partition.right_matched.assign(right.size(), false);
+
+  size_t left_itr = 0, right_itr = 0;
+  while (left_itr < left.size() && right_itr < right.size()) {
+    int cmp = left[left_itr].Compare(right[right_itr]);
+    if (cmp < 0) {
+      left_itr++;
+      continue;
+    }
+    if (cmp > 0) {
+      right_itr++;
+      continue;
+    }
+
+    size_t left_end = left_itr + 1;
+    while (left_end < left.size() &&
+           left[left_end].Compare(left[left_itr]) == 0) {
+      left_end++;
+    }
+    size_t right_end = right_itr + 1;
+    while (right_end < right.size() &&
+           right[right_end].Compare(right[right_itr]) == 0) {
+      right_end++;
+    }
+
+    for (size_t left_row = left_itr; left_row < left_end; left_row++) {
+      for (size_t right_row = right_itr; right_row < right_end; right_row++) {
+        if (predicate_ != nullptr) {
+          expression::ContainerTuple<LogicalTile> left_tuple(
+              left_result_tiles_[left[left_row].tile].get(),
+              left[left_row].row);
+          expression::ContainerTuple<LogicalTile> right_tuple(
+              right_result_tiles_[right[right_row].tile].get(),
+              right[right_row].row);
+          auto eval = predicate_->Evaluate(&left_tuple, &right_tuple,
+                                           executor_context_);
+          if (eval.IsTrue() == false) continue;
+        }
+        partition.matches.emplace_back(left_row, right_row);
+        partition.left_matched[left_row] = true;
+        partition.right_matched[right_row] = true;
+      }
+    }
+
+    left_itr = left_end;
+    right_itr = right_end;
+  }
 }
 
 /**
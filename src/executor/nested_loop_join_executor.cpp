@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 #include <unordered_set>
@@ -28,6 +29,24 @@
 namespace peloton {
 namespace executor {
 
+namespace {
+
+// Orders join keys column by column
+bool JoinKeyLess(const std::vector<type::Value> &lhs,
+                 const std::vector<type::Value> &rhs) {
+  for (size_t column_itr = 0; column_itr < lhs.size(); column_itr++) {
+    if (lhs[column_itr].CompareLessThan(rhs[column_itr]) == type::CMP_TRUE) {
+      return true;
+    }
+    if (lhs[column_itr].CompareGreaterThan(rhs[column_itr]) == type::CMP_TRUE) {
+      return false;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
 /**
  * @brief Constructor for nested loop join executor.
  * @param node Nested loop join node corresponding to this executor.
@@ -53,6 +72,32 @@ bool NestedLoopJoinExecutor::DInit() {
 
   PL_ASSERT(left_result_tiles_.empty());
 
+  left_tile_.reset();
+  left_tile_done_ = true;
+  key_probes_.clear();
+  key_probe_itr_ = 0;
+  key_probe_started_ = false;
+  no_matching_left_rows_.clear();
+
+  // Probing the index never sees the right rows without a match, so right and
+  // full joins keep joining a row at a time
+  const planner::NestedLoopJoinPlan &node =
+      GetPlanNode<planner::NestedLoopJoinPlan>();
+  auto right_node = children_[1]->GetRawNode();
+  batched_index_join_ =
+      (join_type_ == JoinType::INNER || join_type_ == JoinType::LEFT) &&
+      node.GetJoinColumnsRight().empty() == false && right_node != nullptr &&
+      right_node->GetPlanNodeType() == PlanNodeType::INDEXSCAN;
+
+  index_probe_child_ = nullptr;
+  if (batched_index_join_ == true) {
+    auto index_scan = dynamic_cast<IndexScanExecutor *>(children_[1]);
+    if (index_scan != nullptr &&
+        index_scan->CanProbeKeys(node.GetJoinColumnsRight()) == true) {
+      index_probe_child_ = index_scan;
+    }
+  }
+
   return true;
 }
 
@@ -93,6 +138,10 @@ bool NestedLoopJoinExecutor::DExecute() {
   const std::vector<oid_t> &join_column_ids_left = node.GetJoinColumnsLeft();
   const std::vector<oid_t> &join_column_ids_right = node.GetJoinColumnsRight();
 
+  if (batched_index_join_ == true) {
+    return ExecuteBatchedIndexJoin(join_column_ids_left, join_column_ids_right);
+  }
+
   // We should first deal with the current result. Otherwise we will cache a lot
   // data which is not good to utilize memory. After that we call child execute.
   // Since is the high level idea, each time we get tile from left, we should
@@ -142,6 +191,11 @@ bool NestedLoopJoinExecutor::DExecute() {
 
         // Go over every pair of tuples in left and right logical tiles
         for (auto right_tile_row_itr : *right_tile) {
+          if (MatchesPredicate(left_tile_.get(), left_tile_row_itr_,
+                               right_tile.get(), right_tile_row_itr) == false) {
+            continue;
+          }
+
           // Insert a tuple into the output logical tile
           // First, copy the elements in left logical tile's tuple
           LOG_TRACE("Insert a tuple into the output logical tile");
@@ -210,5 +264,175 @@ bool NestedLoopJoinExecutor::DExecute() {
 
   }  // end the very beginning for loop
 }
+
+/**
+ * @brief Joins a whole left tile at a time. The rows of the tile are grouped
+ * by join key. If the right index scan binds the whole primary key, all
+ * distinct keys of the tile are looked up with one sorted multi-key index
+ * probe. Otherwise the right child is executed once per distinct key, in key
+ * order. Each right tile is joined with all the left rows of its key at once.
+ * In left joins the rows without a match follow once all keys of the tile are
+ * joined.
+ * @return true on success, false otherwise.
+ */
+bool NestedLoopJoinExecutor::ExecuteBatchedIndexJoin(
+    const std::vector<oid_t> &join_column_ids_left,
+    const std::vector<oid_t> &join_column_ids_right) {
+  for (;;) {
+    while (key_probe_itr_ < key_probes_.size()) {
+      auto &key_probe = key_probes_[key_probe_itr_];
+      std::unique_ptr<LogicalTile> right_tile;
+      if (index_probe_child_ != nullptr) {
+        // All matches of this key are joined, move on to the next one
+        if (right_result_itr_ == key_probe.right_tiles_.size()) {
+          key_probe.right_tiles_.clear();
+          right_result_itr_ = 0;
+          key_probe_itr_++;
+          continue;
+        }
+        right_tile = std::move(key_probe.right_tiles_[right_result_itr_++]);
+      } else {
+        if (key_probe_started_ == false) {
+          children_[1]->UpdatePredicate(join_column_ids_right, key_probe.key_);
+          key_probe_started_ = true;
+        }
+
+        // All matches of this key are found, move on to the next one
+        if (children_[1]->Execute() == false) {
+          children_[1]->ResetState();
+          key_probe_started_ = false;
+          key_probe_itr_++;
+          continue;
+        }
+        right_tile.reset(children_[1]->GetOutput());
+      }
+      PL_ASSERT(right_tile != nullptr);
+
+      auto output_tile =
+          BuildOutputLogicalTile(left_tile_.get(), right_tile.get());
+      LogicalTile::PositionListsBuilder pos_lists_builder(left_tile_.get(),
+                                                          right_tile.get());
+      for (auto left_tile_row_itr : key_probe.left_rows_) {
+        for (auto right_tile_row_itr : *right_tile) {
+          if (MatchesPredicate(left_tile_.get(), left_tile_row_itr,
+                               right_tile.get(), right_tile_row_itr)) {
+            pos_lists_builder.AddRow(left_tile_row_itr, right_tile_row_itr);
+            no_matching_left_rows_.erase(left_tile_row_itr);
+          }
+        }
+      }
+
+      if (pos_lists_builder.Size() > 0) {
+        output_tile->SetPositionListsAndVisibility(pos_lists_builder.Release());
+        SetOutput(output_tile.release());
+        return true;
+      }
+    }
+
+    // Pad the left rows without a match with NULLs
+    if (no_matching_left_rows_.empty() == false) {
+      auto output_tile =
+          BuildOutputLogicalTile(left_tile_.get(), nullptr, proj_schema_);
+      LogicalTile::PositionListsBuilder pos_lists_builder(
+          &(left_tile_->GetPositionLists()), nullptr);
+      for (auto left_tile_row_itr : no_matching_left_rows_) {
+        pos_lists_builder.AddRightNullRow(left_tile_row_itr);
+      }
+      no_matching_left_rows_.clear();
+      output_tile->SetPositionListsAndVisibility(pos_lists_builder.Release());
+      SetOutput(output_tile.release());
+      return true;
+    }
+
+    if (children_[0]->Execute() == false) {
+      LOG_TRACE("Left child is exhausted.");
+      left_child_done_ = true;
+      return false;
+    }
+
+    left_tile_.reset(children_[0]->GetOutput());
+    BuildKeyProbes(join_column_ids_left);
+
+    if (index_probe_child_ != nullptr && key_probes_.empty() == false) {
+      std::vector<std::vector<type::Value>> keys;
+      keys.reserve(key_probes_.size());
+      for (auto &key_probe : key_probes_) {
+        keys.push_back(key_probe.key_);
+      }
+      std::vector<std::vector<std::unique_ptr<LogicalTile>>> right_tiles;
+      if (index_probe_child_->ProbeKeys(join_column_ids_right, keys,
+                                        right_tiles) == false) {
+        return false;
+      }
+      for (size_t key_itr = 0; key_itr < key_probes_.size(); key_itr++) {
+        key_probes_[key_itr].right_tiles_ = std::move(right_tiles[key_itr]);
+      }
+    }
+  }
+}
+
+bool NestedLoopJoinExecutor::MatchesPredicate(LogicalTile *left_tile,
+                                              oid_t left_row,
+                                              LogicalTile *right_tile,
+                                              oid_t right_row) const {
+  if (predicate_ == nullptr) return true;
+
+  expression::ContainerTuple<executor::LogicalTile> left_tuple(left_tile,
+                                                               left_row);
+  expression::ContainerTuple<executor::LogicalTile> right_tuple(right_tile,
+                                                                right_row);
+  return predicate_->Evaluate(&left_tuple, &right_tuple, executor_context_)
+      .IsTrue();
+}
+
+void NestedLoopJoinExecutor::BuildKeyProbes(
+    const std::vector<oid_t> &join_column_ids_left) {
+  key_probes_.clear();
+  key_probe_itr_ = 0;
+  key_probe_started_ = false;
+  right_result_itr_ = 0;
+
+  std::vector<KeyProbe> left_rows;
+  left_rows.reserve(left_tile_->GetTupleCount());
+  for (auto left_tile_row_itr : *left_tile_) {
+    if (join_type_ == JoinType::LEFT) {
+      no_matching_left_rows_.insert(left_tile_row_itr);
+    }
+
+    expression::ContainerTuple<executor::LogicalTile> left_tuple(
+        left_tile_.get(), left_tile_row_itr);
+
+    KeyProbe left_row;
+    bool has_null = false;
+    for (auto column_id : join_column_ids_left) {
+      left_row.key_.push_back(left_tuple.GetValue(column_id));
+      has_null = has_null || left_row.key_.back().IsNull();
+    }
+
+    // A NULL key never matches anything
+    if (has_null == false) {
+      left_row.left_rows_.push_back(left_tile_row_itr);
+      left_rows.push_back(std::move(left_row));
+    }
+  }
+
+  std::stable_sort(left_rows.begin(), left_rows.end(),
+                   [](const KeyProbe &lhs, const KeyProbe &rhs) {
+                     return JoinKeyLess(lhs.key_, rhs.key_);
+                   });
+
+  for (auto &left_row : left_rows) {
+    if (key_probes_.empty() == true ||
+        JoinKeyLess(key_probes_.back().key_, left_row.key_) == true) {
+      key_probes_.push_back(std::move(left_row));
+    } else {
+      key_probes_.back().left_rows_.push_back(left_row.left_rows_[0]);
+    }
+  }
+
+  LOG_TRACE("Left tile has %lu rows and %lu distinct keys", left_rows.size(),
+            key_probes_.size());
+}
+
 }  // namespace executor
 }  // namespace peloton
@@ -39,6 +39,11 @@ bool OrderByExecutor::DInit() {
 
   sort_done_ = false;
   num_tuples_returned_ = 0;
+  num_tuples_get_ = 0;
+
+  // Drop the tuples of a previous execution of this tree
+  input_tiles_.clear();
+  sort_buffer_.clear();
 
   // Grab info from plan node and check it
   const planner::OrderByPlan &node = GetPlanNode<planner::OrderByPlan>();
@@ -77,20 +82,54 @@ bool OrderByExecutor::DExecute() {
   size_t tile_size = std::min(size_t(DEFAULT_TUPLES_PER_TILEGROUP),
                               sort_buffer_.size() - num_tuples_returned_);
 
+  // Rows with equal sort keys go to the same tile, so that a merge join
+  // above sees every run of a key at once
+  while (num_tuples_returned_ + tile_size < sort_buffer_.size()) {
+    size_t next_row = num_tuples_returned_ + tile_size;
+    auto last_key = sort_buffer_[next_row - 1].tuple.get();
+    auto next_key = sort_buffer_[next_row].tuple.get();
+    bool equal_keys = true;
+    for (oid_t id = 0; id < sort_key_tuple_schema_->GetColumnCount(); id++) {
+      equal_keys = equal_keys && last_key->GetValue(id).CompareEquals(
+                                     next_key->GetValue(id)) == type::CMP_TRUE;
+    }
+    if (equal_keys == false) break;
+    tile_size++;
+  }
+
   std::shared_ptr<storage::Tile> ptile(storage::TileFactory::GetTile(
       BackendType::MM, INVALID_OID, INVALID_OID, INVALID_OID, INVALID_OID,
       nullptr, *input_schema_, nullptr, tile_size));
 
+  // Gather the output columns from the input tiles the rows reference, a
+  // column and an input tile at a time
+  std::vector<std::pair<oid_t, oid_t>> tile_rows;
+  tile_rows.reserve(tile_size);
   for (size_t id = 0; id < tile_size; id++) {
     oid_t source_tile_id =
         sort_buffer_[num_tuples_returned_ + id].item_pointer.block;
-    oid_t source_tuple_id =
-        sort_buffer_[num_tuples_returned_ + id].item_pointer.offset;
-    // Insert a physical tuple into physical tile
-    for (oid_t col = 0; col < input_schema_->GetColumnCount(); col++) {
-      type::Value val =
-          (input_tiles_[source_tile_id]->GetValue(source_tuple_id, col));
-      ptile.get()->SetValue(val, id, col);
+    tile_rows.emplace_back(source_tile_id, id);
+  }
+  std::sort(tile_rows.begin(), tile_rows.end());
+
+  const planner::OrderByPlan &node = GetPlanNode<planner::OrderByPlan>();
+  auto &output_column_ids = node.GetOutputColumnIds();
+  for (oid_t col = 0; col < input_schema_->GetColumnCount(); col++) {
+    size_t run_start = 0;
+    while (run_start < tile_rows.size()) {
+      oid_t source_tile_id = tile_rows[run_start].first;
+      LogicalTile::ColumnGather gather(input_tiles_[source_tile_id].get(),
+                                       output_column_ids[col], ptile.get(),
+                                       col);
+      size_t run_end = run_start;
+      for (; run_end < tile_rows.size() &&
+                 tile_rows[run_end].first == source_tile_id;
+           run_end++) {
+        oid_t id = tile_rows[run_end].second;
+        gather.Copy(sort_buffer_[num_tuples_returned_ + id].item_pointer.offset,
+                    id);
+      }
+      run_start = run_end;
     }
   }
 
@@ -199,6 +238,12 @@ bool OrderByExecutor::DoSort() {
       for (oid_t id = 0; id < descend_flags.size(); id++) {
         type::Value va = (ta->GetValue(id));
         type::Value vb = (tb->GetValue(id));
+        // NULLs compare with nothing, they go after all values in ascending
+        // order and before them in descending order
+        if (va.IsNull() || vb.IsNull()) {
+          if (va.IsNull() == vb.IsNull()) continue;
+          return vb.IsNull() != descend_flags[id];
+        }
         if (!descend_flags[id]) {
           if (va.CompareLessThan(vb) == type::CMP_TRUE)
             return true;
@@ -17,6 +17,7 @@
 #include "executor/executor_context.h"
 #include "executor/executors.h"
 #include "optimizer/util.h"
+#include "planner/copy_plan.h"
 #include "storage/tuple_iterator.h"
 
 namespace peloton {
@@ -45,7 +46,8 @@ void CleanExecutorTree(executor::AbstractExecutor *root);
 peloton_status PlanExecutor::ExecutePlan(
     const planner::AbstractPlan *plan, concurrency::Transaction *txn,
     const std::vector<type::Value> &params, std::vector<StatementResult> &result,
-    const std::vector<int> &result_format) {
+    const std::vector<int> &result_format, std::string *profile_info,
+    ExecutorTreeCache *tree_cache) {
   peloton_status p_status;
   if (plan == nullptr) return p_status;
 
@@ -56,16 +58,33 @@ peloton_status PlanExecutor::ExecutePlan(
   PL_ASSERT(txn);
 
   LOG_TRACE("Txn ID = %lu ", txn->GetTransactionId());
-  LOG_TRACE("Building the executor tree");
 
-  // Use const std::vector<type::Value> &params to make it more elegant for
-  // network
-  std::unique_ptr<executor::ExecutorContext> executor_context(
-      BuildExecutorContext(params, txn));
+  // Profiled executors keep their counters, so they are never reused
+  if (profile_info != nullptr) {
+    tree_cache = nullptr;
+  }
 
-  // Build the executor tree
-  std::unique_ptr<executor::AbstractExecutor> executor_tree(
-      BuildExecutorTree(nullptr, plan, executor_context.get()));
+  std::unique_ptr<ExecutorTree> tree;
+  if (tree_cache != nullptr) {
+    tree = tree_cache->Acquire(plan);
+  }
+
+  if (tree.get() != nullptr) {
+    LOG_TRACE("Reusing the executor tree");
+    tree->executor_context_->Reset(txn, params);
+  } else {
+    LOG_TRACE("Building the executor tree");
+
+    // Use const std::vector<type::Value> &params to make it more elegant for
+    // network
+    tree.reset(new ExecutorTree(plan, BuildExecutorContext(params, txn)));
+    if (profile_info != nullptr) {
+      tree->executor_context_->EnableProfiling();
+    }
+  }
+
+  auto executor_context = tree->executor_context_.get();
+  auto executor_tree = tree->root_.get();
 
   LOG_TRACE("Initializing the executor tree");
 
@@ -83,7 +102,8 @@ peloton_status PlanExecutor::ExecutePlan(
       std::unique_ptr<executor::LogicalTile> logical_tile(
           executor_tree->GetOutput());
       // Some executors don't return logical tiles (e.g., Update).
-      if (logical_tile.get() != nullptr) {
+      // A profiled execution discards its output like EXPLAIN ANALYZE does.
+      if (logical_tile.get() != nullptr && profile_info == nullptr) {
         LOG_TRACE("Final Answer: %s",
                   logical_tile->GetInfo().c_str());  // Printing the answers
         std::vector<std::vector<std::string>> answer_tuples;
@@ -105,6 +125,10 @@ peloton_status PlanExecutor::ExecutePlan(
       }
     }
 
+    if (profile_info != nullptr) {
+      *profile_info = executor_tree->GetProfileInfo();
+    }
+
     // Set the result
     p_status.m_processed = executor_context->num_processed;
     // success so far
@@ -115,8 +139,10 @@ peloton_status PlanExecutor::ExecutePlan(
 
   p_status.m_result_slots = nullptr;
 
-  // clean up executor tree
-  CleanExecutorTree(executor_tree.get());
+  // Keep the executor tree for the next execution, or clean it up
+  if (tree_cache != nullptr && p_status.m_result == ResultType::SUCCESS) {
+    tree_cache->Release(std::move(tree));
+  }
 
   return p_status;
 }
@@ -225,6 +251,77 @@ cleanup:
   return executor_context->num_processed;
 }
 
+//===--------------------------------------------------------------------===//
+// Executor Tree
+//===--------------------------------------------------------------------===//
+
+ExecutorTree::ExecutorTree(const planner::AbstractPlan *plan,
+                           executor::ExecutorContext *executor_context)
+    : plan_(plan),
+      executor_context_(executor_context),
+      root_(BuildExecutorTree(nullptr, plan, executor_context)) {}
+
+ExecutorTree::~ExecutorTree() {
+  // clean up executor tree
+  CleanExecutorTree(root_.get());
+}
+
+std::unique_ptr<ExecutorTree> ExecutorTreeCache::Acquire(
+    const planner::AbstractPlan *plan) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto tree_itr = trees_.find(std::this_thread::get_id());
+  if (tree_itr == trees_.end() || tree_itr->second.get() == nullptr ||
+      tree_itr->second->plan_ != plan) {
+    return nullptr;
+  }
+  return std::move(tree_itr->second);
+}
+
+void ExecutorTreeCache::Release(std::unique_ptr<ExecutorTree> tree) {
+  if (tree->root_.get() == nullptr || IsReusable(tree->plan_) == false) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  trees_[std::this_thread::get_id()] = std::move(tree);
+}
+
+void ExecutorTreeCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  trees_.clear();
+}
+
+size_t ExecutorTreeCache::GetSize() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t size = 0;
+  for (auto &entry : trees_) {
+    if (entry.second.get() != nullptr) size++;
+  }
+  return size;
+}
+
+bool ExecutorTreeCache::IsReusable(const planner::AbstractPlan *plan) {
+  switch (plan->GetPlanNodeType()) {
+    case PlanNodeType::SEQSCAN:
+    case PlanNodeType::INDEXSCAN:
+    case PlanNodeType::INSERT:
+    case PlanNodeType::DELETE:
+    case PlanNodeType::UPDATE:
+    case PlanNodeType::LIMIT:
+    case PlanNodeType::PROJECTION:
+    case PlanNodeType::MATERIALIZE:
+    case PlanNodeType::AGGREGATE_V2:
+    case PlanNodeType::ORDERBY:
+      break;
+    default:
+      return false;
+  }
+
+  for (auto &child : plan->GetChildren()) {
+    if (IsReusable(child.get()) == false) return false;
+  }
+  return true;
+}
+
 /**
  * @brief Build Executor Context
  */
@@ -336,8 +433,19 @@ executor::AbstractExecutor *BuildExecutorTree(
       child_executor = new executor::CreateExecutor(plan, executor_context);
       break;
     case PlanNodeType::COPY:
-      LOG_TRACE("Adding Copy Executer");
-      child_executor = new executor::CopyExecutor(plan, executor_context);
+      if (static_cast<const planner::CopyPlan *>(plan)->IsImport()) {
+        LOG_TRACE("Adding Copy From Executer");
+        child_executor =
+            new executor::CopyFromExecutor(plan, executor_context);
+      } else {
+        LOG_TRACE("Adding Copy Executer");
+        child_executor = new executor::CopyExecutor(plan, executor_context);
+      }
+      break;
+
+    case PlanNodeType::ANALYZE:
+      LOG_TRACE("Adding Analyze Executer");
+      child_executor = new executor::AnalyzeExecutor(plan, executor_context);
       break;
 
     default:
@@ -71,6 +71,12 @@ bool ProjectionExecutor::DExecute() {
     std::unique_ptr<LogicalTile> source_tile(children_[0]->GetOutput());
     auto num_tuples = source_tile->GetTupleCount();
 
+    // Projections that only reorder columns pass the column references on
+    if (PassThrough(source_tile.get())) {
+      SetOutput(source_tile.release());
+      return true;
+    }
+
     // Create new physical tile where we store projected tuples
     std::shared_ptr<storage::Tile> dest_tile(
         storage::TileFactory::GetTempTile(*schema_, num_tuples));
@@ -99,5 +105,41 @@ bool ProjectionExecutor::DExecute() {
   return false;
 }
 
+/**
+ * @brief Points the columns of the tile at the columns the projection maps
+ * to them, when the projection only maps columns of the same types.
+ * @return true if the tile is the projection, false if it has to be copied.
+ */
+bool ProjectionExecutor::PassThrough(LogicalTile *source_tile) {
+  if (project_info_->isNonTrivial()) return false;
+
+  auto &direct_map_list = project_info_->GetDirectMapList();
+  if (direct_map_list.size() != schema_->GetColumnCount()) return false;
+
+  std::vector<LogicalTile::ColumnInfo> new_schema(schema_->GetColumnCount());
+  std::vector<bool> mapped(schema_->GetColumnCount(), false);
+  for (auto &direct_map : direct_map_list) {
+    oid_t dest_column_id = direct_map.first;
+    oid_t tuple_idx = direct_map.second.first;
+    oid_t source_column_id = direct_map.second.second;
+    if (tuple_idx != 0 || dest_column_id >= mapped.size() ||
+        mapped[dest_column_id] == true ||
+        source_column_id >= source_tile->GetColumnCount()) {
+      return false;
+    }
+
+    auto &column_info = source_tile->GetColumnInfo(source_column_id);
+    auto base_type = column_info.base_tile->GetSchema()->GetType(
+        column_info.origin_column_id);
+    if (base_type != schema_->GetType(dest_column_id)) return false;
+
+    new_schema[dest_column_id] = column_info;
+    mapped[dest_column_id] = true;
+  }
+
+  source_tile->SetSchema(std::move(new_schema));
+  return true;
+}
+
 } /* namespace executor */
 } /* namespace peloton */
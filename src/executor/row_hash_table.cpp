@@ -0,0 +1,411 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// row_hash_table.cpp
+//
+// Identification: src/executor/row_hash_table.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "executor/row_hash_table.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/abstract_tuple.h"
+#include "common/exception.h"
+#include "common/logger.h"
+#include "common/macros.h"
+#include "executor/executor_context.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace executor {
+
+namespace {
+
+// The first byte of every packed column tells how the rest is encoded
+enum class KeyTag : char {
+  NULL_VALUE = 0,
+  INTEGER = 1,
+  DECIMAL = 2,
+  TIMESTAMP = 3,
+  VARCHAR = 4,
+  VARBINARY = 5
+};
+
+const size_t initial_bucket_count = 16;
+
+// Blocks of the arena never grow beyond this
+const size_t max_arena_block_size = 1 << 20;
+
+template <typename T>
+void Append(std::vector<char> &bytes, const T &value) {
+  auto data = reinterpret_cast<const char *>(&value);
+  bytes.insert(bytes.end(), data, data + sizeof(T));
+}
+
+template <typename T>
+T Read(const char *&data) {
+  T value;
+  PL_MEMCPY(&value, data, sizeof(T));
+  data += sizeof(T);
+  return value;
+}
+
+// Finalizer of MurmurHash3
+uint64_t Mix(uint64_t hash) {
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+}  // namespace
+
+void RowHashTable::PackValue(std::vector<char> &bytes,
+                             const type::Value &value) {
+  if (value.IsNull()) {
+    bytes.push_back(static_cast<char>(KeyTag::NULL_VALUE));
+    return;
+  }
+
+  switch (value.GetTypeId()) {
+    case type::Type::BOOLEAN:
+    case type::Type::TINYINT:
+      bytes.push_back(static_cast<char>(KeyTag::INTEGER));
+      Append<int64_t>(bytes, value.GetAs<int8_t>());
+      break;
+    case type::Type::SMALLINT:
+      bytes.push_back(static_cast<char>(KeyTag::INTEGER));
+      Append<int64_t>(bytes, value.GetAs<int16_t>());
+      break;
+    case type::Type::INTEGER:
+      bytes.push_back(static_cast<char>(KeyTag::INTEGER));
+      Append<int64_t>(bytes, value.GetAs<int32_t>());
+      break;
+    case type::Type::BIGINT:
+      bytes.push_back(static_cast<char>(KeyTag::INTEGER));
+      Append<int64_t>(bytes, value.GetAs<int64_t>());
+      break;
+    case type::Type::DECIMAL: {
+      // Both zeros are the same key
+      double decimal = value.GetAs<double>();
+      bytes.push_back(static_cast<char>(KeyTag::DECIMAL));
+      Append<double>(bytes, decimal == 0 ? 0.0 : decimal);
+      break;
+    }
+    case type::Type::TIMESTAMP:
+      bytes.push_back(static_cast<char>(KeyTag::TIMESTAMP));
+      Append<uint64_t>(bytes, value.GetAs<uint64_t>());
+      break;
+    case type::Type::VARCHAR:
+    case type::Type::VARBINARY: {
+      // Strings are kept without their terminating zero
+      uint32_t length = value.GetLength();
+      const char *data = value.GetData();
+      bool is_varchar = value.GetTypeId() == type::Type::VARCHAR;
+      if (is_varchar && length > 0 && data[length - 1] == 0) {
+        length--;
+      }
+      bytes.push_back(static_cast<char>(is_varchar ? KeyTag::VARCHAR
+                                                   : KeyTag::VARBINARY));
+      Append<uint32_t>(bytes, length);
+      bytes.insert(bytes.end(), data, data + length);
+      break;
+    }
+    default: {
+      std::string message =
+          "Can not hash values of type " + TypeIdToString(value.GetTypeId());
+      throw ExecutorException(message);
+    }
+  }
+}
+
+type::Value RowHashTable::UnpackValue(const char *&data,
+                                      const type::Type::TypeId type_id) {
+  auto tag = static_cast<KeyTag>(*data++);
+  switch (tag) {
+    case KeyTag::NULL_VALUE:
+      return type::ValueFactory::GetNullValueByType(type_id);
+    case KeyTag::INTEGER: {
+      auto integer = Read<int64_t>(data);
+      switch (type_id) {
+        case type::Type::BOOLEAN:
+          return type::ValueFactory::GetBooleanValue(
+              static_cast<int8_t>(integer));
+        case type::Type::TINYINT:
+          return type::ValueFactory::GetTinyIntValue(
+              static_cast<int8_t>(integer));
+        case type::Type::SMALLINT:
+          return type::ValueFactory::GetSmallIntValue(
+              static_cast<int16_t>(integer));
+        case type::Type::INTEGER:
+          return type::ValueFactory::GetIntegerValue(
+              static_cast<int32_t>(integer));
+        default:
+          return type::ValueFactory::GetBigIntValue(integer);
+      }
+    }
+    case KeyTag::DECIMAL:
+      return type::ValueFactory::GetDecimalValue(Read<double>(data));
+    case KeyTag::TIMESTAMP:
+      return type::ValueFactory::GetTimestampValue(Read<uint64_t>(data));
+    case KeyTag::VARCHAR:
+    case KeyTag::VARBINARY: {
+      auto length = Read<uint32_t>(data);
+      std::string string(data, length);
+      data += length;
+      return tag == KeyTag::VARCHAR
+                 ? type::ValueFactory::GetVarcharValue(string)
+                 : type::ValueFactory::GetVarbinaryValue(string);
+    }
+  }
+  throw ExecutorException("Corrupt packed key");
+}
+
+uint64_t RowHashTable::HashBytes(const char *data, size_t size) {
+  uint64_t hash = size;
+  while (size >= sizeof(uint64_t)) {
+    hash = Mix(hash ^ Read<uint64_t>(data));
+    size -= sizeof(uint64_t);
+  }
+  uint64_t tail = 0;
+  PL_MEMCPY(&tail, data, size);
+  return Mix(hash ^ tail);
+}
+
+uint64_t RowHashTable::HashKey(const AbstractTuple *tuple,
+                               const std::vector<oid_t> &column_ids,
+                               std::vector<char> &buffer) {
+  buffer.clear();
+  for (auto column_id : column_ids) {
+    PackValue(buffer, tuple->GetValue(column_id));
+  }
+  return HashBytes(buffer.data(), buffer.size());
+}
+
+size_t RowHashTable::memory_limit_ = 1UL << 28;
+
+const size_t RowHashTable::reservation_size;
+
+void RowHashTable::SetMemoryLimit(size_t memory_limit) {
+  memory_limit_ = memory_limit;
+}
+
+RowHashTable::RowHashTable(const std::vector<type::Type::TypeId> &key_types,
+                           size_t payload_size, size_t record_size,
+                           size_t block_size)
+    : key_types_(key_types),
+      payload_size_(payload_size),
+      record_size_(record_size),
+      block_size_(block_size),
+      table_memory_limit_(memory_limit_),
+      spill_files_(partition_count) {
+  Clear();
+}
+
+RowHashTable::~RowHashTable() {
+  if (executor_context_ != nullptr) {
+    executor_context_->ReleaseMemory(reserved_memory_);
+  }
+}
+
+void RowHashTable::Clear() {
+  arena_.reset(new Arena(block_size_, max_arena_block_size));
+  buckets_.assign(initial_bucket_count, nullptr);
+  entries_.clear();
+}
+
+uint64_t RowHashTable::PackKey(const AbstractTuple *tuple,
+                               const std::vector<oid_t> &column_ids) {
+  PL_ASSERT(column_ids.size() == key_types_.size());
+  return HashKey(tuple, column_ids, key_buffer_);
+}
+
+RowHashTable::Entry *RowHashTable::FindPacked(uint64_t hash) const {
+  auto entry = buckets_[hash & (buckets_.size() - 1)];
+  for (; entry != nullptr; entry = entry->next) {
+    if (entry->hash == hash && entry->key_size == key_buffer_.size() &&
+        memcmp(entry->GetKey(), key_buffer_.data(), key_buffer_.size()) ==
+            0) {
+      return entry;
+    }
+  }
+  return nullptr;
+}
+
+RowHashTable::Entry *RowHashTable::AddEntry(uint64_t hash) {
+  if (entries_.size() >= buckets_.size()) {
+    Grow();
+  }
+
+  size_t key_size = key_buffer_.size();
+  size_t payload_offset = Entry::GetPayloadOffset(key_size);
+  auto entry = static_cast<Entry *>(
+      arena_->Allocate(sizeof(Entry) + payload_offset + payload_size_));
+  entry->hash = hash;
+  entry->key_size = key_size;
+  PL_MEMCPY(entry + 1, key_buffer_.data(), key_size);
+  PL_MEMSET(entry->GetPayload(), 0, payload_size_);
+
+  auto &bucket = buckets_[hash & (buckets_.size() - 1)];
+  entry->next = bucket;
+  bucket = entry;
+  entries_.push_back(entry);
+  return entry;
+}
+
+void RowHashTable::Grow() {
+  buckets_.assign(buckets_.size() * 2, nullptr);
+  for (auto entry : entries_) {
+    auto &bucket = buckets_[entry->hash & (buckets_.size() - 1)];
+    entry->next = bucket;
+    bucket = entry;
+  }
+}
+
+RowHashTable::Entry *RowHashTable::Find(const AbstractTuple *tuple,
+                                        const std::vector<oid_t> &column_ids,
+                                        const void *record) {
+  auto hash = PackKey(tuple, column_ids);
+  auto entry = FindPacked(hash);
+  if (entry == nullptr && spilling_ == true && record != nullptr) {
+    Spill(hash, record);
+  }
+  return entry;
+}
+
+RowHashTable::Entry *RowHashTable::Insert(
+    const AbstractTuple *tuple, const std::vector<oid_t> &column_ids,
+    const void *record, bool &inserted) {
+  return InsertPacked(PackKey(tuple, column_ids), record, inserted);
+}
+
+RowHashTable::Entry *RowHashTable::Insert(const type::Value &value,
+                                          const void *record,
+                                          bool &inserted) {
+  PL_ASSERT(key_types_.size() == 1);
+  key_buffer_.clear();
+  PackValue(key_buffer_, value);
+  auto hash = HashBytes(key_buffer_.data(), key_buffer_.size());
+  return InsertPacked(hash, record, inserted);
+}
+
+RowHashTable::Entry *RowHashTable::InsertPacked(uint64_t hash,
+                                                const void *record,
+                                                bool &inserted) {
+  inserted = false;
+  auto entry = FindPacked(hash);
+  if (entry != nullptr) {
+    return entry;
+  }
+
+  if (spilling_ == false &&
+      (GetMemoryUsage() > table_memory_limit_ || ReserveMemory() == false)) {
+    LOG_DEBUG("Row hash table of %lu entries starts spilling",
+              entries_.size());
+    spilling_ = true;
+  }
+  if (spilling_ == true) {
+    Spill(hash, record);
+    return nullptr;
+  }
+
+  inserted = true;
+  return AddEntry(hash);
+}
+
+bool RowHashTable::ReserveMemory() {
+  if (executor_context_ == nullptr) {
+    return true;
+  }
+
+  // Entries to come need memory as well, so the table reserves ahead
+  size_t memory_usage = GetMemoryUsage() + reservation_size / 2;
+  if (memory_usage <= reserved_memory_) {
+    return true;
+  }
+  size_t bytes = std::max(memory_usage - reserved_memory_, reservation_size);
+  if (executor_context_->ReserveMemory(bytes) == false) {
+    return false;
+  }
+  reserved_memory_ += bytes;
+  return true;
+}
+
+void RowHashTable::Spill(uint64_t hash, const void *record) {
+  PL_ASSERT(record != nullptr || record_size_ == 0);
+
+  // The top bits pick the partition, the low ones the bucket
+  auto &file = spill_files_[hash >> 60];
+  if (file == nullptr) {
+    file.reset(new SpillFile());
+  }
+
+  uint32_t key_size = key_buffer_.size();
+  file->Write(&key_size, sizeof(key_size));
+  file->Write(key_buffer_.data(), key_size);
+  if (record_size_ > 0) {
+    file->Write(record, record_size_);
+  }
+}
+
+void RowHashTable::LoadPartition(size_t partition) {
+  PL_ASSERT(partition < partition_count);
+  PL_ASSERT(IsPartitionSpilled(partition));
+  Clear();
+  loaded_file_ = spill_files_[partition].get();
+  RewindPartition();
+}
+
+void RowHashTable::RewindPartition() {
+  PL_ASSERT(loaded_file_ != nullptr);
+  loaded_file_->Rewind();
+}
+
+RowHashTable::Entry *RowHashTable::NextRecord(const char *&record,
+                                              bool &inserted) {
+  PL_ASSERT(loaded_file_ != nullptr);
+  uint32_t key_size;
+  if (loaded_file_->Read(&key_size, sizeof(key_size)) == false) {
+    return nullptr;
+  }
+
+  key_buffer_.resize(key_size);
+  record_buffer_.resize(record_size_);
+  if (loaded_file_->Read(key_buffer_.data(), key_size) == false ||
+      (record_size_ > 0 &&
+       loaded_file_->Read(record_buffer_.data(), record_size_) == false)) {
+    throw ExecutorException("Spill file ends within a row");
+  }
+  record = record_buffer_.data();
+
+  auto hash = HashBytes(key_buffer_.data(), key_buffer_.size());
+  auto entry = FindPacked(hash);
+  inserted = (entry == nullptr);
+  return inserted ? AddEntry(hash) : entry;
+}
+
+void RowHashTable::GetKey(const Entry *entry,
+                          std::vector<type::Value> &values) const {
+  values.clear();
+  const char *data = entry->GetKey();
+  for (auto type_id : key_types_) {
+    values.push_back(UnpackValue(data, type_id));
+  }
+  PL_ASSERT(data == entry->GetKey() + entry->GetKeySize());
+}
+
+size_t RowHashTable::GetMemoryUsage() const {
+  return arena_->GetAllocatedBytes() +
+         (buckets_.size() + entries_.capacity()) * sizeof(Entry *);
+}
+
+}  // namespace executor
+}  // namespace peloton
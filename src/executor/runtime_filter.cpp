@@ -0,0 +1,169 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// runtime_filter.cpp
+//
+// Identification: src/executor/runtime_filter.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "executor/runtime_filter.h"
+
+#include "common/abstract_tuple.h"
+#include "common/macros.h"
+#include "storage/zone_map.h"
+
+namespace peloton {
+namespace executor {
+
+namespace {
+
+bool IsInteger(const type::Type::TypeId type_id) {
+  switch (type_id) {
+    case type::Type::TINYINT:
+    case type::Type::SMALLINT:
+    case type::Type::INTEGER:
+    case type::Type::BIGINT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Equal values of all integer types hash alike, so keys of a column can be
+// probed with values of another integer column
+uint64_t HashValue(const type::Value &value) {
+  int64_t integer;
+  switch (value.GetTypeId()) {
+    case type::Type::TINYINT:
+      integer = value.GetAs<int8_t>();
+      break;
+    case type::Type::SMALLINT:
+      integer = value.GetAs<int16_t>();
+      break;
+    case type::Type::INTEGER:
+      integer = value.GetAs<int32_t>();
+      break;
+    case type::Type::BIGINT:
+      integer = value.GetAs<int64_t>();
+      break;
+    default:
+      return value.Hash();
+  }
+  return static_cast<uint64_t>(integer);
+}
+
+// Finalizer of MurmurHash3, the hashes of integers are the integers
+uint64_t Mix(uint64_t hash) {
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+}  // namespace
+
+RuntimeFilter::RuntimeFilter(const std::vector<type::Type::TypeId> &key_types,
+                             const size_t expected_key_count)
+    : key_types_(key_types),
+      has_range_(key_types.size(), false),
+      min_values_(key_types.size()),
+      max_values_(key_types.size()) {
+  // A power of two number of words, so a word is picked with a mask
+  size_t word_count = 1;
+  while (word_count * 64 < expected_key_count * bits_per_key) {
+    word_count *= 2;
+  }
+  words_.assign(word_count, 0);
+  word_mask_ = word_count - 1;
+}
+
+uint64_t RuntimeFilter::HashKey(const AbstractTuple *tuple,
+                                const std::vector<oid_t> &key_column_ids,
+                                bool &has_null) const {
+  PL_ASSERT(key_column_ids.size() == key_types_.size());
+  uint64_t hash = 0;
+  has_null = false;
+  for (auto column_id : key_column_ids) {
+    auto value = tuple->GetValue(column_id);
+    if (value.IsNull()) {
+      has_null = true;
+      return 0;
+    }
+    hash = Mix(hash ^ HashValue(value));
+  }
+  return hash;
+}
+
+uint64_t RuntimeFilter::GetBitMask(const uint64_t hash) {
+  // The low bits pick the word, every higher group of six bits one bit
+  uint64_t mask = 0;
+  for (size_t bit_itr = 0; bit_itr < hash_count; bit_itr++) {
+    mask |= 1ULL << ((hash >> (40 - bit_itr * 6)) & 63);
+  }
+  return mask;
+}
+
+void RuntimeFilter::Insert(const AbstractTuple *tuple,
+                           const std::vector<oid_t> &key_column_ids) {
+  bool has_null;
+  auto hash = HashKey(tuple, key_column_ids, has_null);
+  if (has_null) return;
+
+  words_[hash & word_mask_] |= GetBitMask(hash);
+  key_count_++;
+
+  for (oid_t key_offset = 0; key_offset < key_column_ids.size();
+       key_offset++) {
+    if (storage::ZoneMap::HasRange(key_types_[key_offset]) == false) continue;
+
+    auto value = tuple->GetValue(key_column_ids[key_offset]);
+    if (has_range_[key_offset] == false) {
+      min_values_[key_offset] = value;
+      max_values_[key_offset] = value;
+      has_range_[key_offset] = true;
+    } else if (value.CompareLessThan(min_values_[key_offset]) ==
+               type::CMP_TRUE) {
+      min_values_[key_offset] = value;
+    } else if (value.CompareGreaterThan(max_values_[key_offset]) ==
+               type::CMP_TRUE) {
+      max_values_[key_offset] = value;
+    }
+  }
+}
+
+bool RuntimeFilter::MayContain(const AbstractTuple *tuple,
+                               const std::vector<oid_t> &key_column_ids) const {
+  bool has_null;
+  auto hash = HashKey(tuple, key_column_ids, has_null);
+  if (has_null) return false;
+
+  auto mask = GetBitMask(hash);
+  return (words_[hash & word_mask_] & mask) == mask;
+}
+
+bool RuntimeFilter::GetRange(const oid_t key_offset, type::Value &min_value,
+                             type::Value &max_value) const {
+  PL_ASSERT(key_offset < key_types_.size());
+  if (has_range_[key_offset] == false) return false;
+
+  min_value = min_values_[key_offset];
+  max_value = max_values_[key_offset];
+  return true;
+}
+
+bool RuntimeFilter::IsCompatible(const oid_t key_offset,
+                                 const type::Type::TypeId probe_type) const {
+  PL_ASSERT(key_offset < key_types_.size());
+  auto key_type = key_types_[key_offset];
+  return key_type == probe_type ||
+         (IsInteger(key_type) && IsInteger(probe_type));
+}
+
+}  // namespace executor
+}  // namespace peloton
@@ -23,6 +23,7 @@
 #include "executor/executor_context.h"
 #include "expression/abstract_expression.h"
 #include "common/container_tuple.h"
+#include "storage/compressed_column.h"
 #include "storage/data_table.h"
 #include "storage/tile_group_header.h"
 #include "storage/tile.h"
@@ -128,12 +129,31 @@ bool SeqScanExecutor::DExecute() {
           target_table_->GetTileGroup(current_tile_group_offset_++);
       auto tile_group_header = tile_group->GetHeader();
 
+      // Skip the tile groups whose values can not satisfy the predicate or
+      // the runtime filter
+      if (MayMatch(tile_group.get()) == false) {
+        continue;
+      }
+      tile_group_header->IncrementReadCount();
+
       oid_t active_tuple_count = tile_group->GetNextTupleSlot();
 
+      // Filter compressed tile groups on the codes first
+      std::vector<bool> matches;
+      bool predicate_filtered = false;
+      if (predicate_ != nullptr && tile_group->GetTile(0)->IsCompressed()) {
+        matches.assign(active_tuple_count, true);
+        predicate_filtered = FilterCompressed(tile_group.get(), matches);
+      }
+
       // Construct position list by looping through tile group
       // and applying the predicate.
       std::vector<oid_t> position_list;
       for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
+        if (matches.empty() == false && matches[tuple_id] == false) {
+          continue;
+        }
+
         ItemPointer location(tile_group->GetTileGroupId(), tuple_id);
 
 
@@ -141,8 +161,16 @@ bool SeqScanExecutor::DExecute() {
 
         // check transaction visibility
         if (visibility == VisibilityType::OK) {
+          expression::ContainerTuple<storage::TileGroup> tuple(
+              tile_group.get(), tuple_id);
+
+          // Drop the tuples the join above can not match
+          if (PassesRuntimeFilter(&tuple) == false) {
+            continue;
+          }
+
           // if the tuple is visible, then perform predicate evaluation.
-          if (predicate_ == nullptr) {
+          if (predicate_ == nullptr || predicate_filtered == true) {
             position_list.push_back(tuple_id);
             auto res = transaction_manager.PerformRead(current_txn, location, acquire_owner);
             if (!res) {
@@ -150,8 +178,6 @@ bool SeqScanExecutor::DExecute() {
               return res;
             }
           } else {
-            expression::ContainerTuple<storage::TileGroup> tuple(
-                tile_group.get(), tuple_id);
             LOG_TRACE("Evaluate predicate for a tuple");
             auto eval = predicate_->Evaluate(&tuple, nullptr, executor_context_);
             LOG_TRACE("Evaluation result: %s", eval.GetInfo().c_str());
@@ -188,5 +214,33 @@ bool SeqScanExecutor::DExecute() {
   return false;
 }
 
+/**
+ * @brief Clears the matches of the tuples of a compressed tile group that
+ * fail a "column <comparison> constant" conjunct of the predicate.
+ * @return true if every conjunct was evaluated, false if the predicate must
+ * still be evaluated on the remaining tuples.
+ */
+bool SeqScanExecutor::FilterCompressed(storage::TileGroup *tile_group,
+                                       std::vector<bool> &matches) {
+  bool all_filtered = only_column_comparisons_;
+  for (auto &column_comparison : column_comparisons_) {
+    oid_t tile_offset, tile_column;
+    tile_group->LocateTileAndColumn(column_comparison.column_id, tile_offset,
+                                    tile_column);
+    auto column =
+        tile_group->GetTile(tile_offset)->GetCompressedColumn(tile_column);
+    PL_ASSERT(column != nullptr);
+
+    if (column->Filter(column_comparison.comparison,
+                       column_comparison.constant, matches) == false) {
+      all_filtered = false;
+    }
+  }
+
+  LOG_TRACE("Filtered %lu compressed tuples, all conjuncts: %d",
+            matches.size(), all_filtered);
+  return all_filtered;
+}
+
 }  // namespace executor
 }  // namespace peloton
@@ -0,0 +1,154 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// spill_file.cpp
+//
+// Identification: src/executor/spill_file.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "executor/spill_file.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+#include "common/abstract_tuple.h"
+#include "common/exception.h"
+#include "common/macros.h"
+#include "configuration/configuration.h"
+#include "executor/row_hash_table.h"
+
+namespace peloton {
+namespace executor {
+
+SpillFile::SpillFile() {
+  std::string path = FLAGS_spill_directory + "/peloton_spill_XXXXXX";
+  std::vector<char> path_buffer(path.begin(), path.end());
+  path_buffer.push_back(0);
+
+  fd_ = mkstemp(path_buffer.data());
+  if (fd_ < 0) {
+    throw ExecutorException("Could not create spill file in " +
+                            FLAGS_spill_directory + ": " + strerror(errno));
+  }
+  unlink(path_buffer.data());
+}
+
+SpillFile::~SpillFile() { close(fd_); }
+
+void SpillFile::Write(const void *data, size_t size) {
+  PL_ASSERT(reading_ == false);
+  if (buffer_.empty()) {
+    buffer_.resize(buffer_size);
+  }
+
+  auto bytes = static_cast<const char *>(data);
+  while (size > 0) {
+    if (buffer_offset_ == buffer_.size()) {
+      Flush();
+    }
+    size_t chunk = std::min(size, buffer_.size() - buffer_offset_);
+    PL_MEMCPY(buffer_.data() + buffer_offset_, bytes, chunk);
+    buffer_offset_ += chunk;
+    bytes += chunk;
+    size -= chunk;
+    size_ += chunk;
+  }
+}
+
+void SpillFile::Flush() {
+  size_t written = 0;
+  while (written < buffer_offset_) {
+    auto result =
+        write(fd_, buffer_.data() + written, buffer_offset_ - written);
+    if (result < 0) {
+      if (errno == EINTR) continue;
+      throw ExecutorException(std::string("Could not write spill file: ") +
+                              strerror(errno));
+    }
+    written += result;
+  }
+  buffer_offset_ = 0;
+}
+
+void SpillFile::Rewind() {
+  if (reading_ == false) {
+    Flush();
+    reading_ = true;
+  }
+  if (lseek(fd_, 0, SEEK_SET) < 0) {
+    throw ExecutorException(std::string("Could not rewind spill file: ") +
+                            strerror(errno));
+  }
+  buffer_offset_ = 0;
+  buffer_end_ = 0;
+}
+
+bool SpillFile::Read(void *data, size_t size) {
+  PL_ASSERT(reading_ == true);
+  if (buffer_.empty()) {
+    buffer_.resize(buffer_size);
+  }
+
+  auto bytes = static_cast<char *>(data);
+  while (size > 0) {
+    if (buffer_offset_ == buffer_end_) {
+      auto result = read(fd_, buffer_.data(), buffer_.size());
+      if (result < 0) {
+        if (errno == EINTR) continue;
+        throw ExecutorException(std::string("Could not read spill file: ") +
+                                strerror(errno));
+      }
+      if (result == 0) {
+        return false;
+      }
+      buffer_offset_ = 0;
+      buffer_end_ = result;
+    }
+    size_t chunk = std::min(size, buffer_end_ - buffer_offset_);
+    PL_MEMCPY(bytes, buffer_.data() + buffer_offset_, chunk);
+    buffer_offset_ += chunk;
+    bytes += chunk;
+    size -= chunk;
+  }
+  return true;
+}
+
+void SpillFile::WriteRow(const AbstractTuple *tuple, size_t column_count) {
+  row_buffer_.clear();
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    RowHashTable::PackValue(row_buffer_, tuple->GetValue(column_itr));
+  }
+  uint32_t row_size = row_buffer_.size();
+  Write(&row_size, sizeof(row_size));
+  Write(row_buffer_.data(), row_size);
+}
+
+bool SpillFile::ReadRow(const std::vector<type::Type::TypeId> &types,
+                        std::vector<type::Value> &values) {
+  uint32_t row_size;
+  if (Read(&row_size, sizeof(row_size)) == false) {
+    return false;
+  }
+  row_buffer_.resize(row_size);
+  if (Read(row_buffer_.data(), row_size) == false) {
+    throw ExecutorException("Spill file ends within a row");
+  }
+
+  values.clear();
+  const char *data = row_buffer_.data();
+  for (auto type_id : types) {
+    values.push_back(RowHashTable::UnpackValue(data, type_id));
+  }
+  PL_ASSERT(data == row_buffer_.data() + row_size);
+  return true;
+}
+
+}  // namespace executor
+}  // namespace peloton
@@ -40,8 +40,6 @@ UpdateExecutor::UpdateExecutor(const planner::AbstractPlan *node,
  */
 bool UpdateExecutor::DInit() {
   PL_ASSERT(children_.size() == 1);
-  PL_ASSERT(target_table_ == nullptr);
-  PL_ASSERT(project_info_ == nullptr);
 
   // Grab settings from node
   const planner::UpdatePlan &node = GetPlanNode<planner::UpdatePlan>();
@@ -14,9 +14,12 @@
 #include "storage/tuple.h"
 #include "storage/database.h"
 #include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
 #include "catalog/manager.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "common/container_tuple.h"
+#include "configuration/configuration.h"
+#include "statistics/backend_stats_context.h"
 
 namespace peloton {
 namespace gc {
@@ -39,8 +42,16 @@ bool TransactionLevelGCManager::ResetTuple(const ItemPointer &location) {
     tile_group_header->GetReservedFieldRef(location.offset), 0,
     storage::TileGroupHeader::GetReservedSize());
 
-  // Reclaim the varlen pool
-  CheckAndReclaimVarlenColumns(tile_group, location.offset);
+  // Pairs with the layout changes, which set the flag before they check the
+  // slots
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  // Reclaim the varlen pool, frozen tile groups keep their data and
+  // transforming ones may still be copying it
+  if (tile_group_header->IsFrozen() == false &&
+      tile_group_header->IsTransforming() == false) {
+    CheckAndReclaimVarlenColumns(tile_group, location.offset);
+  }
 
   LOG_TRACE("Garbage tuple(%u, %u) is reset", location.block, location.offset);
   return true;
@@ -50,18 +61,30 @@ void TransactionLevelGCManager::Running(const int &thread_id) {
   PL_ASSERT(is_running_ == true);
   uint32_t backoff_shifts = 0;
   while (true) {
-    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
-    auto max_cid = txn_manager.GetMaxCommittedCid();
-
-    PL_ASSERT(max_cid != MAX_CID);
-    int reclaimed_count = Reclaim(thread_id, max_cid);
+    stats::LatencyTimer pause_timer;
+    pause_timer.StartTimer();
+
+    // Workers only ever try the lock, so this waits for at most one batch
+    int collected_count = 0;
+    if (is_paused_ == false) {
+      partition_locks_[thread_id].Lock();
+      if (is_paused_ == false) {
+        collected_count = Collect(thread_id, MAX_ATTEMPT_COUNT, false);
+      }
+      partition_locks_[thread_id].Unlock();
+    }
 
-    int unlinked_count = Unlink(thread_id, max_cid);
+    // Only passes that did some work count as GC pauses
+    if (FLAGS_stats_mode != STATS_TYPE_INVALID && collected_count != 0) {
+      stats::BackendStatsContext::GetInstance()
+          ->GetGCPauseLatencyMetric()
+          .RecordLatency(pause_timer.RecordLatency());
+    }
 
     if (is_running_ == false) {
       return;
     }
-    if (reclaimed_count == 0 && unlinked_count == 0) {
+    if (collected_count == 0) {
       // sleep at most 0.8192 s
       if (backoff_shifts < 13) {
         ++backoff_shifts;
@@ -75,6 +98,31 @@ void TransactionLevelGCManager::Running(const int &thread_id) {
   }
 }
 
+int TransactionLevelGCManager::Collect(const int &thread_id,
+                                       const size_t &max_count,
+                                       const bool is_inline) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto max_cid = txn_manager.GetMaxCommittedCid();
+
+  PL_ASSERT(max_cid != MAX_CID);
+
+  size_t version_count = 0;
+  int reclaimed_count = Reclaim(thread_id, max_cid, version_count, max_count);
+
+  int unlinked_count = Unlink(thread_id, max_cid, max_count);
+
+  if (FLAGS_stats_mode != STATS_TYPE_INVALID && version_count != 0) {
+    auto stats_context = stats::BackendStatsContext::GetInstance();
+    if (is_inline == true) {
+      stats_context->GetInlineGCReclaimedMetric().Increment(version_count);
+    } else {
+      stats_context->GetBackgroundGCReclaimedMetric().Increment(
+          version_count);
+    }
+  }
+
+  return reclaimed_count + unlinked_count;
+}
 
 void TransactionLevelGCManager::RecycleTransaction(std::shared_ptr<GCSet> gc_set, const cid_t &timestamp) {
   // Add the garbage context to the lock-free queue
@@ -82,30 +130,59 @@ void TransactionLevelGCManager::RecycleTransaction(std::shared_ptr<GCSet> gc_set
   unlink_queues_[HashToThread(gc_context->timestamp_)]->Enqueue(gc_context);
 }
 
-int TransactionLevelGCManager::Unlink(const int &thread_id, const cid_t &max_cid) {
+void TransactionLevelGCManager::PauseGC() {
+  is_paused_ = true;
+
+  // Wait for the passes that started before the flag was set
+  for (auto &partition_lock : partition_locks_) {
+    partition_lock.Lock();
+    partition_lock.Unlock();
+  }
+}
+
+void TransactionLevelGCManager::CooperativeCollect() {
+  if (is_running_ == false) {
+    return;
+  }
+
+  // Spread the helping workers over the partitions
+  static thread_local unsigned int next_partition = 0;
+  int thread_id = (next_partition++) % gc_thread_count_;
+
+  // Never wait for the GC thread or another worker
+  if (partition_locks_[thread_id].TryLock() == false) {
+    return;
+  }
+  Collect(thread_id, COOPERATIVE_GC_BATCH_SIZE, true);
+  partition_locks_[thread_id].Unlock();
+}
+
+int TransactionLevelGCManager::Unlink(const int &thread_id, const cid_t &max_cid,
+                                      const size_t &max_count) {
   
   int tuple_counter = 0;
 
   // check if any garbage can be unlinked from indexes.
-  // every time we garbage collect at most MAX_ATTEMPT_COUNT tuples.
+  // every time we garbage collect at most max_count tuples.
   std::vector<std::shared_ptr<GarbageContext>> garbages;
 
   // First iterate the local unlink queue
-  local_unlink_queues_[thread_id].remove_if(
-    [this, &garbages, &tuple_counter, max_cid](const std::shared_ptr<GarbageContext>& garbage_ctx) -> bool {
-      bool res = garbage_ctx->timestamp_ < max_cid;
-      if (res == true) {
-        DeleteFromIndexes(garbage_ctx);
-        // Add to the garbage map
-
-        garbages.push_back(garbage_ctx);
-        tuple_counter++;
-      }
-      return res;
+  auto &local_unlink_queue = local_unlink_queues_[thread_id];
+  auto garbage_ctx_itr = local_unlink_queue.begin();
+  for (size_t i = 0; i < max_count && garbage_ctx_itr != local_unlink_queue.end(); ++i) {
+    auto garbage_ctx = *garbage_ctx_itr;
+    if (garbage_ctx->timestamp_ < max_cid) {
+      DeleteFromIndexes(garbage_ctx);
+      // Add to the garbage map
+      garbages.push_back(garbage_ctx);
+      tuple_counter++;
+      garbage_ctx_itr = local_unlink_queue.erase(garbage_ctx_itr);
+    } else {
+      ++garbage_ctx_itr;
     }
-  );
+  }
 
-  for (size_t i = 0; i < MAX_ATTEMPT_COUNT; ++i) {
+  for (size_t i = 0; i < max_count; ++i) {
 
     std::shared_ptr<GarbageContext> garbage_ctx;
     // if there's no more tuples in the queue, then break.
@@ -138,20 +215,23 @@ int TransactionLevelGCManager::Unlink(const int &thread_id, const cid_t &max_cid
   return tuple_counter;
 }
 
-// executed by a single thread. so no synchronization is required.
-int TransactionLevelGCManager::Reclaim(const int &thread_id, const cid_t &max_cid) {
+// executed under the partition lock. so no further synchronization is required.
+int TransactionLevelGCManager::Reclaim(const int &thread_id, const cid_t &max_cid,
+                                       size_t &version_count,
+                                       const size_t &max_count) {
   int gc_counter = 0;
 
   // we delete garbage in the free list
   auto garbage_ctx_entry = reclaim_maps_[thread_id].begin();
-  while (garbage_ctx_entry != reclaim_maps_[thread_id].end()) {
+  while (garbage_ctx_entry != reclaim_maps_[thread_id].end() &&
+         (size_t)gc_counter < max_count) {
     const cid_t garbage_ts = garbage_ctx_entry->first;
     auto garbage_ctx = garbage_ctx_entry->second;
 
     // if the timestamp of the garbage is older than the current max_cid,
     // recycle it
     if (garbage_ts < max_cid) {
-      AddToRecycleMap(garbage_ctx);
+      version_count += AddToRecycleMap(garbage_ctx);
 
       // Remove from the original map
       garbage_ctx_entry = reclaim_maps_[thread_id].erase(garbage_ctx_entry);
@@ -166,7 +246,8 @@ int TransactionLevelGCManager::Reclaim(const int &thread_id, const cid_t &max_ci
 }
 
 // Multiple GC thread share the same recycle map
-void TransactionLevelGCManager::AddToRecycleMap(std::shared_ptr<GarbageContext> garbage_ctx) {
+size_t TransactionLevelGCManager::AddToRecycleMap(std::shared_ptr<GarbageContext> garbage_ctx) {
+  size_t version_count = 0;
   for (auto &entry : *(garbage_ctx->gc_set_.get())) {
 
     auto &manager = catalog::Manager::GetInstance();
@@ -174,7 +255,7 @@ void TransactionLevelGCManager::AddToRecycleMap(std::shared_ptr<GarbageContext>
 
     // During the resetting, a table may be deconstructed because of the DROP TABLE request
     if (tile_group == nullptr) {
-      return;
+      return version_count;
     }
 
     PL_ASSERT(tile_group != nullptr);
@@ -194,6 +275,13 @@ void TransactionLevelGCManager::AddToRecycleMap(std::shared_ptr<GarbageContext>
       if (ResetTuple(location) == false) {
         continue;
       }
+      version_count++;
+      // the slots of frozen tile groups are never reused, nor the ones of
+      // tile groups whose layout is being changed
+      if (tile_group->GetHeader()->IsFrozen() == true ||
+          tile_group->GetHeader()->IsTransforming() == true) {
+        continue;
+      }
       // if the entry for table_id exists.
       if (recycle_queue_map_.find(table_id) != recycle_queue_map_.end()) {
         recycle_queue_map_[table_id]->Enqueue(location);
@@ -202,6 +290,7 @@ void TransactionLevelGCManager::AddToRecycleMap(std::shared_ptr<GarbageContext>
     }
   }
 
+  return version_count;
 }
 
 // this function returns a free tuple slot, if one exists
@@ -224,12 +313,13 @@ ItemPointer TransactionLevelGCManager::ReturnFreeSlot(const oid_t &table_id) {
 }
 
 void TransactionLevelGCManager::ClearGarbage(int thread_id) {
+  size_t version_count = 0;
   while(!unlink_queues_[thread_id]->IsEmpty() || !local_unlink_queues_[thread_id].empty()) {
     Unlink(thread_id, MAX_CID);
   }
 
   while(reclaim_maps_[thread_id].size() != 0) {
-    Reclaim(thread_id, MAX_CID);
+    Reclaim(thread_id, MAX_CID, version_count);
   }
 
   return;
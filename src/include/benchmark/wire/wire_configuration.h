@@ -0,0 +1,79 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// wire_configuration.h
+//
+// Identification: src/include/benchmark/wire/wire_configuration.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <cstring>
+#include <getopt.h>
+#include <vector>
+#include <iostream>
+
+#include "type/types.h"
+
+namespace peloton {
+namespace benchmark {
+namespace wire {
+
+static const char wire_table_name[] = "wire_bench";
+
+class configuration {
+ public:
+  // server address
+  std::string host;
+
+  // server port
+  int port;
+
+  // number of rows loaded before the run
+  int scale_factor;
+
+  // execution duration (in s)
+  double duration;
+
+  // number of client connections
+  int backend_count;
+
+  // number of queries sent before waiting for their results
+  int pipeline_depth;
+
+  // insert new rows instead of reading existing ones
+  bool insert_mode;
+
+  // throughput (queries per second)
+  double throughput = 0;
+
+  // error rate
+  double error_rate = 0;
+};
+
+extern configuration state;
+
+void Usage(FILE *out);
+
+void ParseArguments(int argc, char *argv[], configuration &state);
+
+void ValidatePort(const configuration &state);
+
+void ValidateScaleFactor(const configuration &state);
+
+void ValidateDuration(const configuration &state);
+
+void ValidateBackendCount(const configuration &state);
+
+void ValidatePipelineDepth(const configuration &state);
+
+void WriteOutput();
+
+}  // namespace wire
+}  // namespace benchmark
+}  // namespace peloton
@@ -13,6 +13,7 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <mutex>
 #include <thread>
 #include <vector>
@@ -68,6 +69,13 @@ class LayoutTuner {
   // Update layout of table
   void UpdateDefaultPartition(storage::DataTable *table);
 
+  // Transform the tile groups of the table according to their accesses:
+  // tile groups that are written to get the row layout, the ones that are
+  // only scanned the default layout of the table, or a column layout if the
+  // default layout is the row layout. Halves the access counts if decay is
+  // set.
+  void TransformTileGroups(storage::DataTable *table, bool decay);
+
  private:
   // Tables whose layout must be tuned
   std::vector<storage::DataTable *> tables;
@@ -105,6 +113,22 @@ class LayoutTuner {
   // Desired layout tile count
   oid_t tile_count = 2;
 
+  // Tile groups with at least this many recent writes are hot
+  uint64_t hot_write_count = 1;
+
+  // Tile groups without writes and at least this many recent scans are
+  // cold
+  uint64_t cold_read_count = 2;
+
+  // The access counts are halved every period (in ms)
+  oid_t decay_period = 1000;
+
+  // Fraction of the time the tuner thread spends transforming tile groups
+  double cpu_budget = 0.1;
+
+  // Last time the access counts were halved
+  std::chrono::steady_clock::time_point last_decay_time;
+
 };
 
 }  // End brain namespace
@@ -0,0 +1,74 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_group_freezer.h
+//
+// Identification: src/include/brain/tile_group_freezer.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <thread>
+
+#include "type/types.h"
+
+namespace peloton {
+
+namespace storage {
+class DataTable;
+}
+
+namespace brain {
+
+//===--------------------------------------------------------------------===//
+// Tile Group Freezer
+//
+// Periodically goes over all tables and compresses the tile groups that no
+// running or future transaction can modify any more.
+//===--------------------------------------------------------------------===//
+
+class TileGroupFreezer {
+ public:
+  TileGroupFreezer(const TileGroupFreezer &) = delete;
+  TileGroupFreezer &operator=(const TileGroupFreezer &) = delete;
+  TileGroupFreezer(TileGroupFreezer &&) = delete;
+  TileGroupFreezer &operator=(TileGroupFreezer &&) = delete;
+
+  TileGroupFreezer();
+
+  ~TileGroupFreezer();
+
+  // Singleton
+  static TileGroupFreezer &GetInstance();
+
+  // Start freezing
+  void Start();
+
+  // Freeze tile groups until stopped
+  void Freeze();
+
+  // Stop freezing
+  void Stop();
+
+  // Compresses the tile groups of the table that are cold as of max_cid,
+  // returns how many were compressed
+  static size_t FreezeTable(storage::DataTable *table, const cid_t max_cid);
+
+ private:
+  // Stop signal
+  std::atomic<bool> freezing_stop;
+
+  // Freezer thread
+  std::thread freezer_thread;
+
+  // Sleeping period between two passes (in ms)
+  oid_t sleep_duration = 1000;
+};
+
+}  // End brain namespace
+}  // End peloton namespace
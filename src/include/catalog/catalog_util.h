@@ -76,5 +76,13 @@ std::unique_ptr<storage::Tuple> GetQueryMetricsCatalogTuple(
     stats::QueryMetric::QueryParamBuf val_buf, int64_t reads, int64_t updates,
     int64_t deletes, int64_t inserts, int64_t latency, int64_t cpu_time,
     int64_t time_stamp, type::AbstractPool *pool);
+
+std::unique_ptr<storage::Tuple> GetColumnStatsCatalogTuple(
+    const catalog::Schema *schema, oid_t table_id, oid_t database_id,
+    oid_t column_id, int64_t num_rows, int64_t modification_count,
+    double null_frac, double num_distinct,
+    const std::string &most_common_vals,
+    const std::string &most_common_freqs,
+    const std::string &histogram_bounds, type::AbstractPool *pool);
 }
 }
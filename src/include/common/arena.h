@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// arena.h
+//
+// Identification: src/include/common/arena.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace peloton {
+
+//===--------------------------------------------------------------------===//
+// Arena
+//
+// Hands out memory from large blocks by bumping a pointer. Nothing is freed
+// on its own, all blocks are released when the arena is destroyed.
+//===--------------------------------------------------------------------===//
+
+class Arena {
+ public:
+  Arena(const Arena &) = delete;
+  Arena &operator=(const Arena &) = delete;
+
+  // Every block is twice the size of the one before it, up to
+  // max_block_size, or all are of block_size if that is smaller
+  Arena(size_t block_size = default_block_size, size_t max_block_size = 0);
+
+  ~Arena();
+
+  // Memory for size bytes, aligned for any type
+  void *Allocate(size_t size);
+
+  inline size_t GetAllocatedBytes() const { return allocated_bytes_; }
+
+  // The arena ArenaAllocated objects created by this thread go to, nullptr
+  // if they go to the heap
+  static Arena *GetActive();
+
+  // Makes an arena the active one of this thread while it is in scope
+  class Scope {
+   public:
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+    Scope(Arena *arena);
+
+    ~Scope();
+
+   private:
+    Arena *previous_;
+  };
+
+  static const size_t alignment = 16;
+
+  static const size_t default_block_size = 1 << 14;
+
+ private:
+  std::vector<char *> blocks_;
+
+  size_t block_size_;
+
+  size_t max_block_size_;
+
+  // Free part of the current block
+  char *block_ptr_ = nullptr;
+  size_t block_remaining_ = 0;
+
+  size_t allocated_bytes_ = 0;
+};
+
+//===--------------------------------------------------------------------===//
+// ArenaAllocated
+//
+// Objects of classes deriving from this are placed in the active arena of
+// the creating thread, or on the heap if there is none. Deleting an object
+// runs its destructor, the memory of an arena object is only given back with
+// its arena. Objects in an arena must not outlive it.
+//===--------------------------------------------------------------------===//
+
+class ArenaAllocated {
+ public:
+  static void *operator new(size_t size);
+
+  static void operator delete(void *ptr);
+};
+
+}  // End peloton namespace
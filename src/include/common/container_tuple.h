@@ -92,7 +92,17 @@ class ContainerTuple : public AbstractTuple {
    * Assume the schema of other tuple.Is the same as this. No check.
    */
   bool EqualsNoSchemaCheck(const ContainerTuple<T> &other) const {
-    if (column_ids_) {
+    if (column_ids_ && other.column_ids_) {
+      // The tuples may keep their keys in different columns
+      PL_ASSERT(column_ids_->size() == other.column_ids_->size());
+      for (size_t key_itr = 0; key_itr < column_ids_->size(); key_itr++) {
+        type::Value lhs = (GetValue((*column_ids_)[key_itr]));
+        type::Value rhs = (other.GetValue((*other.column_ids_)[key_itr]));
+        if (lhs.CompareNotEquals(rhs) == type::CMP_TRUE) {
+          return false;
+        }
+      }
+    } else if (column_ids_) {
       for (auto &column_itr : *column_ids_) {
         type::Value lhs = (GetValue(column_itr));
         type::Value rhs = (other.GetValue(column_itr));
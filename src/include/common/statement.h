@@ -25,6 +25,10 @@ namespace planner {
 class AbstractPlan;
 }
 
+namespace bridge {
+class ExecutorTreeCache;
+}
+
 // TODO: Somebody needs to define what the hell this is???
 typedef std::pair<std::vector<unsigned char>, std::vector<unsigned char>>
     StatementResult;
@@ -73,6 +77,11 @@ class Statement : public Printable {
 
   const std::shared_ptr<planner::AbstractPlan>& GetPlanTree() const;
 
+  // Executor trees kept across the executions of the plan tree
+  inline bridge::ExecutorTreeCache *GetExecutorTreeCache() const {
+    return executor_trees_.get();
+  }
+
   inline bool GetNeedsPlan() const { return (needs_replan_); }
 
   inline void SetNeedsPlan(bool replan) { needs_replan_ = replan; }
@@ -99,6 +108,9 @@ class Statement : public Printable {
   // cached plan tree
   std::shared_ptr<planner::AbstractPlan> plan_tree_;
 
+  // executor trees of the cached plan tree
+  std::unique_ptr<bridge::ExecutorTreeCache> executor_trees_;
+
   // the oids of the tables referenced by this statement
   // this may be empty
   std::set<oid_t> table_ids_;
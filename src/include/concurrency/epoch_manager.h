@@ -13,6 +13,10 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <limits>
+#include <memory>
 #include <thread>
 #include <vector>
 
@@ -26,30 +30,26 @@
 namespace peloton {
 namespace concurrency {
 
-struct Epoch {
-  std::atomic<int> ro_txn_ref_count_;
-  std::atomic<int> rw_txn_ref_count_;
-  cid_t max_cid_;
-
-  Epoch(): 
-    ro_txn_ref_count_(0), 
-    rw_txn_ref_count_(0),
-    max_cid_(0) {}
-
-  Epoch(const Epoch &epoch): 
-    ro_txn_ref_count_(epoch.ro_txn_ref_count_.load()), 
-    rw_txn_ref_count_(epoch.rw_txn_ref_count_.load()),
-    max_cid_(0) {}
-
-  void Init() {
-    ro_txn_ref_count_ = 0;
-    rw_txn_ref_count_ = 0;
-    max_cid_ = 0;
-  }
-};
+// Number of (epoch, max cid) pairs remembered by each epoch slot
+#define EPOCH_SLOT_HISTORY_SIZE 8
+
+// Slots beyond this count are shared between threads
+#define EPOCH_MAX_SLOT_COUNT 1024
 
 /*
-Epoch queue layout:
+Each thread announces its transactions in its own epoch slot instead of
+bumping shared per-epoch reference counters:
+
+ - the oldest epoch of its running read-write and read-only txns
+ - for its most recent epochs, the largest begin cid it has entered with
+
+A slot lives on its own cache lines and is only written by its owner, so
+beginning and ending a txn never writes shared memory. The (rare) case of
+a txn ending on another thread, or of more threads than slots, is handled
+by a per-slot spinlock that is uncontended otherwise.
+
+The tails of the former epoch queue are computed by scanning all slots:
+
  current epoch               queue tail                reclaim tail
 /                           /                          /
 +--------+--------+--------+--------+--------+--------+--------+-------
@@ -57,28 +57,59 @@ Epoch queue layout:
 +--------+--------+--------+--------+--------+--------+--------+-------
 New                                                   Old
 
-Note:
-1) Queue tail epoch and epochs which is older than it have 0 rw txn ref count
-2) Reclaim tail epoch and epochs which is older than it have 0 ro txn ref count
-3) Reclaim tail is at least 2 turns older than the queue tail epoch
-4) Queue tail is at least 2 turns older than the head epoch
+ - queue tail   : min(current epoch - safety, oldest rw epoch)
+ - reclaim tail : min(queue tail - safety, oldest ro epoch)
+
+Read-only txns get the largest begin cid of the epochs older than the queue
+tail, and the GC may reclaim everything up to the largest begin cid of the
+epochs older than the reclaim tail.
 */
 
+struct EpochSlot {
+  EpochSlot();
+
+  char cache_padding_front_[CACHELINE_SIZE];
+
+  // Oldest epoch of the running read-write / read-only txns of this slot
+  std::atomic<size_t> rw_epoch_;
+  std::atomic<size_t> ro_epoch_;
+
+  // Ring of recent epochs and the largest begin cid entered in that epoch
+  // or any earlier one. An entry is written epoch first, cid second.
+  std::atomic<size_t> history_epochs_[EPOCH_SLOT_HISTORY_SIZE];
+  std::atomic<cid_t> history_cids_[EPOCH_SLOT_HISTORY_SIZE];
+  size_t history_head_;
+
+  // Epochs of the running txns, only accessed under the lock
+  std::vector<size_t> rw_epochs_;
+  std::vector<size_t> ro_epochs_;
+
+  Spinlock lock_;
+
+  // Whether a thread currently owns this slot
+  std::atomic<bool> in_use_;
+
+  char cache_padding_back_[CACHELINE_SIZE];
+};
+
+// The slots of an epoch manager. A thread keeps the array of its slot alive,
+// so that it can still release the slot after the manager is destroyed.
+struct EpochSlotArray {
+  EpochSlotArray();
+  ~EpochSlotArray();
+
+  std::array<std::atomic<EpochSlot *>, EPOCH_MAX_SLOT_COUNT> slots_;
+  std::atomic<size_t> slot_count_;
+};
+
 class EpochManager {
   EpochManager(const EpochManager&) = delete;
-  static const int safety_interval_ = 2;
+  static const size_t safety_interval_ = 2;
 
 public:
-  EpochManager()
-    : epoch_queue_(epoch_queue_size_),
-      queue_tail_(0), 
-      reclaim_tail_(0), 
-      current_epoch_(0),
-      queue_tail_token_(true), 
-      reclaim_tail_token_(true),
-      max_cid_ro_(READ_ONLY_START_CID), 
-      max_cid_gc_(0), 
-      is_running_(false) {}
+  EpochManager();
+
+  ~EpochManager();
 
   void Reset(const size_t &current_epoch) {
     current_epoch_ = current_epoch;
@@ -102,203 +133,79 @@ public:
     this->is_running_ = false;
   }
 
-  size_t EnterReadOnlyEpoch(cid_t begin_cid) {
-    auto epoch = queue_tail_.load();
-
-    size_t epoch_idx = epoch % epoch_queue_size_;
-    epoch_queue_[epoch_idx].ro_txn_ref_count_++;
-
-    // Set the max cid in the tuple
-    auto max_cid_ptr = &(epoch_queue_[epoch_idx].max_cid_);
-    AtomicMax(max_cid_ptr, begin_cid);
-
-    return epoch;
-  }
-
-  size_t EnterEpoch(cid_t begin_cid) {
-    auto epoch = current_epoch_.load();
-
-    size_t epoch_idx = epoch % epoch_queue_size_;
-    epoch_queue_[epoch_idx].rw_txn_ref_count_++;
-
-    // Set the max cid in the tuple
-    auto max_cid_ptr = &(epoch_queue_[epoch_idx].max_cid_);
-    AtomicMax(max_cid_ptr, begin_cid);
+  // Register a txn in the calling thread's slot. The returned epoch id has
+  // to be passed back when the txn exits.
+  size_t EnterReadOnlyEpoch(cid_t begin_cid);
 
-    return epoch;
-  }
-
-  void ExitReadOnlyEpoch(size_t epoch) {
-    PL_ASSERT(epoch >= reclaim_tail_);
-    PL_ASSERT(epoch <= queue_tail_);
+  size_t EnterEpoch(cid_t begin_cid);
 
-    auto epoch_idx = epoch % epoch_queue_size_;
-    epoch_queue_[epoch_idx].ro_txn_ref_count_--;
-  }
+  void ExitReadOnlyEpoch(size_t epoch_id);
 
-  void ExitEpoch(size_t epoch) {
-    PL_ASSERT(epoch >= queue_tail_);
-    PL_ASSERT(epoch <= current_epoch_);
-
-    auto epoch_idx = epoch % epoch_queue_size_;
-    epoch_queue_[epoch_idx].rw_txn_ref_count_--;
-  }
+  void ExitEpoch(size_t epoch_id);
 
   // assume we store epoch_store max_store previously
   cid_t GetMaxDeadTxnCid() {
-    IncreaseQueueTail();
-    IncreaseReclaimTail();
-
-    return max_cid_gc_;
+    IncreaseTails();
+    return max_cid_gc_.load();
   }
 
   cid_t GetReadOnlyTxnCid() {
-    IncreaseQueueTail();
-    return max_cid_ro_;
-  }
-
-private:
-  void Running() {
-    
-    PL_ASSERT(is_running_ == true);
-    
-    while (is_running_ == true) {
-      // the epoch advances every EPOCH_LENGTH milliseconds.
-      std::this_thread::sleep_for(std::chrono::milliseconds(EPOCH_LENGTH));
-
-      auto next_idx = (current_epoch_.load() + 1) % epoch_queue_size_;
-      auto tail_idx = reclaim_tail_.load() % epoch_queue_size_;
-
-      if(next_idx == tail_idx) {
-        // overflow
-        // in this case, just increase tail
-        IncreaseQueueTail();
-        IncreaseReclaimTail();
-        continue;
-      }
-
-      // we have to init it first, then increase current epoch
-      // otherwise may read dirty data
-      epoch_queue_[next_idx].Init();
-      current_epoch_++;
-
-      IncreaseQueueTail();
-      IncreaseReclaimTail();
+    if (tails_epoch_.load() != current_epoch_.load()) {
+      IncreaseTails();
     }
+    return max_cid_ro_.load();
   }
 
-  void IncreaseReclaimTail() {
-    bool expect = true, desired = false;
-    if(!reclaim_tail_token_.compare_exchange_weak(expect, desired)){
-      // someone now is increasing tail
-      return;
-    }
-
-    auto current = queue_tail_.load();
-    auto tail = reclaim_tail_.load();
-
-    while(true) {
-      if(tail + safety_interval_ >= current) {
-        break;
-      }
-
-      auto idx = tail % epoch_queue_size_;
+private:
+  void Running();
 
-      // inc tail until we find an epoch that has running txn
-      if(epoch_queue_[idx].ro_txn_ref_count_ > 0) {
-        break;
-      }
+  // Recompute the queue and reclaim tails with a scan over all slots
+  void IncreaseTails();
 
-      // save max cid
-      auto max = epoch_queue_[idx].max_cid_;
-      AtomicMax(&max_cid_gc_, max);
-      tail++;
-    }
+  // Largest begin cid entered in any epoch older than the given one
+  cid_t GetMaxCidBefore(const size_t epoch) const;
 
-    reclaim_tail_ = tail;
+  EpochSlot *GetThreadSlot(size_t &slot_id);
 
-    expect = false;
-    desired = true;
+  // Finds a free slot, or a shared one if there is none left
+  size_t AcquireSlot(bool &owned);
 
-    reclaim_tail_token_.compare_exchange_weak(expect, desired);
-    return;
+  // Epoch ids encode both the epoch and the slot of the txn
+  static inline size_t GetEpochId(const size_t epoch, const size_t slot_id) {
+    return epoch * max_slot_count_ + slot_id;
   }
 
-  void IncreaseQueueTail() {
-    bool expect = true, desired = false;
-    if(!queue_tail_token_.compare_exchange_weak(expect, desired)){
-      // someone now is increasing tail
-      return;
-    }
-
-    auto current = current_epoch_.load();
-    auto tail = queue_tail_.load();
-
-    while(true) {
-      if(tail + safety_interval_ >= current) {
-        break;
-      }
-
-      auto idx = tail % epoch_queue_size_;
-
-      // inc tail until we find an epoch that has running txn
-      if(epoch_queue_[idx].rw_txn_ref_count_ > 0) {
-        break;
-      }
+  static void RecordMaxCid(EpochSlot *slot, const size_t epoch,
+                           const cid_t begin_cid);
 
-      // save max cid
-      auto max = epoch_queue_[idx].max_cid_;
-      AtomicMax(&max_cid_ro_, max);
-      tail++;
+  template <typename T>
+  static void AtomicMax(std::atomic<T> &addr, const T max) {
+    auto old = addr.load();
+    while (old < max && !addr.compare_exchange_weak(old, max)) {
     }
-
-    queue_tail_ = tail;
-
-    expect = false;
-    desired = true;
-
-    queue_tail_token_.compare_exchange_weak(expect, desired);
-    return;
   }
 
-  void AtomicMax(cid_t* addr, cid_t max) {
-    while(true) {
-      auto old = *addr;
-      if(old > max) {
-        return;
-      }else if ( __sync_bool_compare_and_swap(addr, old, max) ) {
-        return;
-      }
-    }
-  }
+private:
+  static const size_t max_slot_count_ = EPOCH_MAX_SLOT_COUNT;
 
-  inline void InitEpochQueue() {
-    for (int i = 0; i < 5; ++i) {
-      epoch_queue_[i].Init();
-    }
+  // Epoch announced by slots without running txns
+  static const size_t max_epoch_ = std::numeric_limits<size_t>::max();
 
-    current_epoch_ = 0;
-    queue_tail_ = 0;
-    reclaim_tail_ = 0;
-  }
+  std::shared_ptr<EpochSlotArray> slot_array_;
 
-private:
-  // queue size
-  static const size_t epoch_queue_size_ = 4096;
-
-  // Epoch vector
-  std::vector<Epoch> epoch_queue_;
+  std::atomic<size_t> current_epoch_;
   std::atomic<size_t> queue_tail_;
   std::atomic<size_t> reclaim_tail_;
-  std::atomic<size_t> current_epoch_;
-  std::atomic<bool> queue_tail_token_;
-  std::atomic<bool> reclaim_tail_token_;
-  cid_t max_cid_ro_;
-  cid_t max_cid_gc_;
+
+  // Epoch of the last tail computation
+  std::atomic<size_t> tails_epoch_;
+  std::atomic<bool> tails_token_;
+
+  std::atomic<cid_t> max_cid_ro_;
+  std::atomic<cid_t> max_cid_gc_;
   bool is_running_;
 };
 
 
 }
 }
-
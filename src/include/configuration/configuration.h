@@ -31,10 +31,19 @@ DECLARE_uint64(max_connections);
 // Socket family
 DECLARE_string(socket_family);
 
+// Number of threads accepting connections
+DECLARE_uint64(acceptor_count);
+
 //===----------------------------------------------------------------------===//
 // RESOURCE USAGE
 //===----------------------------------------------------------------------===//
 
+// Memory budget of a query for its hash tables
+DECLARE_uint64(query_memory_limit);
+
+// Directory of the files operators spill to
+DECLARE_string(spill_directory);
+
 //===----------------------------------------------------------------------===//
 // WRITE AHEAD LOG
 //===----------------------------------------------------------------------===//
@@ -67,6 +76,9 @@ DECLARE_bool(index_tuner);
 // Enable or disable layout tuner
 DECLARE_bool(layout_tuner);
 
+// Enable or disable compression of cold tile groups
+DECLARE_bool(tile_group_freezer);
+
 //===----------------------------------------------------------------------===//
 // GENERAL
 //===----------------------------------------------------------------------===//
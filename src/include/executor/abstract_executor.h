@@ -13,6 +13,7 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "common/item_pointer.h"
@@ -31,6 +32,30 @@ class ExecutorContext;
 
 namespace executor {
 
+//===--------------------------------------------------------------------===//
+// Executor Profile
+//===--------------------------------------------------------------------===//
+
+// Per-executor counters, only maintained while profiling is enabled on the
+// executor context (EXPLAIN ANALYZE)
+struct ExecutorProfile {
+  // Time spent in Execute(), including the children (in nanoseconds)
+  uint64_t execute_time_ns = 0;
+
+  // Number of Execute() calls
+  uint64_t execute_calls = 0;
+
+  // Logical tiles and visible tuples handed to the parent
+  uint64_t tiles_out = 0;
+  uint64_t rows_out = 0;
+
+  // Entries in the hash table built by this executor, if any
+  uint64_t hash_table_entries = 0;
+
+  // Bytes written to temporary storage, if any
+  uint64_t spill_bytes = 0;
+};
+
 class AbstractExecutor {
  public:
   AbstractExecutor(const AbstractExecutor &) = delete;
@@ -80,6 +105,18 @@ class AbstractExecutor {
   // Used to reset the state. For now it's overloaded by index scan executor
   virtual void ResetState() {}
 
+  //===--------------------------------------------------------------------===//
+  // Profiling
+  //===--------------------------------------------------------------------===//
+
+  const ExecutorProfile &GetProfile() const { return profile_; }
+
+  // Number of tuples produced by the children
+  uint64_t GetRowsIn() const;
+
+  // Annotated executor tree, one line per executor
+  std::string GetProfileInfo(int depth = 0) const;
+
  protected:
   // NOTE: The reason why we keep the plan node separate from the executor
   // context is because we might want to reuse the plan multiple times
@@ -111,6 +148,9 @@ class AbstractExecutor {
   /** @brief Children nodes of this executor in the executor tree. */
   std::vector<AbstractExecutor *> children_;
 
+  // Execution counters of this executor
+  ExecutorProfile profile_;
+
  private:
   // Output logical tile
   // This is where we will write the results of the plan node's execution
@@ -12,13 +12,26 @@
 
 #pragma once
 
+#include <memory>
+#include <vector>
+
 #include "planner/abstract_scan_plan.h"
 #include "type/types.h"
+#include "type/value.h"
 #include "executor/abstract_executor.h"
 
 namespace peloton {
+
+class AbstractTuple;
+
+namespace storage {
+class TileGroup;
+}
+
 namespace executor {
 
+class RuntimeFilter;
+
 /**
  * Super class for different kinds of scan executor.
  * It provides common codes for all kinds of scan:
@@ -41,11 +54,36 @@ class AbstractScanExecutor : public AbstractExecutor {
 
   virtual void ResetState() {}
 
+  /**
+   * @brief Pushes the runtime filter of a join into the scan. The key
+   * columns are positions in the output of the scan.
+   * @return false if the scan can not apply the filter and ignores it.
+   */
+  bool SetRuntimeFilter(std::shared_ptr<const RuntimeFilter> runtime_filter,
+                        const std::vector<oid_t> &key_column_ids);
+
  protected:
   bool DInit();
 
   virtual bool DExecute() = 0;
 
+  /**
+   * @brief Whether a tuple of the tile group may satisfy the predicate,
+   * according to its zone map.
+   */
+  bool MayMatch(storage::TileGroup *tile_group) const;
+
+  /** @brief Whether a tuple of the table may pass the runtime filter. */
+  bool PassesRuntimeFilter(const AbstractTuple *tuple) const;
+
+  /** @brief A conjunct of the predicate: column <comparison> constant. */
+  struct ColumnComparison {
+    oid_t column_id;
+    ExpressionType comparison;
+    // Unused for OPERATOR_IS_NULL
+    type::Value constant;
+  };
+
  protected:
   //===--------------------------------------------------------------------===//
   // Plan Info
@@ -56,6 +94,18 @@ class AbstractScanExecutor : public AbstractExecutor {
 
   /** @brief Columns from tile group to be added to logical tile output. */
   std::vector<oid_t> column_ids_;
+
+  /** @brief The conjuncts of the predicate that compare a column. */
+  std::vector<ColumnComparison> column_comparisons_;
+
+  /** @brief Whether the predicate is the conjunction of the comparisons. */
+  bool only_column_comparisons_ = false;
+
+  /** @brief Filter on the join keys pushed down from a hash join. */
+  std::shared_ptr<const RuntimeFilter> runtime_filter_;
+
+  /** @brief Columns of the table the runtime filter is probed with. */
+  std::vector<oid_t> runtime_filter_column_ids_;
 };
 
 }  // namespace executor
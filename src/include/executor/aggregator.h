@@ -12,11 +12,12 @@
 
 #pragma once
 
+#include <memory>
 #include <unordered_map>
-#include <unordered_set>
 
 #include "common/container_tuple.h"
 #include "executor/abstract_executor.h"
+#include "executor/row_hash_table.h"
 #include "planner/aggregate_plan.h"
 #include "type/value_factory.h"
 
@@ -49,11 +50,9 @@ class AbstractAttributeAggregator {
   virtual type::Value DFinalize() = 0;
 
  private:
-  typedef std::unordered_set<type::Value, type::Value::hash,
-                             type::Value::equal_to>
-      DistinctSetType;
-
-  DistinctSetType distinct_set_;
+  // Distinct values, created with the first one. NULLs are never kept, no
+  // aggregate counts them.
+  std::unique_ptr<RowHashTable> distinct_values_;
 
   bool is_distinct_ = false;
 };
@@ -275,7 +274,19 @@ class HashAggregator : public AbstractAggregator {
 
   ~HashAggregator();
 
+  // Spilled rows are split again at most this many times
+  static const size_t max_spill_depth = 8;
+
  private:
+  // Writes a row of a group that does not fit the memory budget to the
+  // partition of its key
+  void SpillTuple(AbstractTuple *tuple);
+
+  // Aggregates the rows spilled to a partition
+  bool FinalizePartition(SpillFile &file, size_t depth);
+
+  void FreeGroups();
+
   const size_t num_input_columns;
 
   /** List of aggregates for a specific group. */
@@ -321,6 +332,21 @@ class HashAggregator : public AbstractAggregator {
 
   /** @brief Hash table */
   HashAggregateMapType aggregates_map;
+
+  /** @brief Estimated bytes of a group and bytes reserved for all groups */
+  size_t group_size_ = 0;
+  size_t reserved_memory_ = 0;
+
+  /**
+   * @brief Once a new group does not fit the budget, the rows of all new
+   * groups are spilled to partitions by the hash bits of the depth
+   */
+  bool spilling_ = false;
+  size_t spill_depth_ = 0;
+  std::vector<std::unique_ptr<SpillFile>> spill_files_;
+  std::vector<type::Type::TypeId> spill_types_;
+  std::vector<type::Value> spill_values_;
+  std::vector<char> key_buffer_;
 };
 
 /**
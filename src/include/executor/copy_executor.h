@@ -14,7 +14,9 @@
 
 #include "executor/abstract_executor.h"
 
+#include <memory>
 #include <vector>
+#include "storage/table_exporter.h"
 #include "wire/packet_manager.h"
 
 #define COPY_BUFFER_SIZE 65536
@@ -70,6 +72,9 @@ class CopyExecutor : public AbstractExecutor {
   // The handler for the output file
   FileHandle file_handle_ = INVALID_FILE_HANDLE;
 
+  // Writes the target table when there is no child to copy from
+  std::unique_ptr<storage::TableExporter> exporter_;
+
   // Field delimiter between columns
   char delimiter = ',';
 
@@ -0,0 +1,131 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// copy_from_executor.h
+//
+// Identification: src/include/executor/copy_from_executor.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "common/item_pointer.h"
+#include "executor/abstract_executor.h"
+#include "type/ephemeral_pool.h"
+
+namespace peloton {
+
+namespace catalog {
+class Schema;
+}
+
+namespace storage {
+class DataTable;
+class Tuple;
+}
+
+namespace executor {
+
+/**
+ * Loads a delimited text file into a table (COPY ... FROM). The file is cut
+ * into chunks at line boundaries that are parsed by a set of threads, while
+ * the executor thread inserts the parsed rows in batches. The index entries
+ * of the loaded rows can be added in bulk once all rows are in the table.
+ */
+class CopyFromExecutor : public AbstractExecutor {
+ public:
+  CopyFromExecutor(const CopyFromExecutor &) = delete;
+  CopyFromExecutor &operator=(const CopyFromExecutor &) = delete;
+  CopyFromExecutor(CopyFromExecutor &&) = delete;
+  CopyFromExecutor &operator=(CopyFromExecutor &&) = delete;
+
+  CopyFromExecutor(const planner::AbstractPlan *node,
+                   ExecutorContext *executor_context);
+
+  ~CopyFromExecutor();
+
+  // Set the number of threads that parse the input of a COPY FROM
+  static void SetParserCount(size_t parser_count);
+
+ protected:
+  bool DInit();
+
+  bool DExecute();
+
+ private:
+  // Rows parsed from one run of lines, inserted with one table insert
+  struct TupleBatch {
+    type::EphemeralPool pool_;
+    std::vector<std::unique_ptr<storage::Tuple>> tuples_;
+  };
+
+  // Parse the lines in [begin, end) of the file, runs on a parser thread
+  void ParseChunk(size_t begin, size_t end);
+
+  // Parse one line into the tuple, returns false if it is malformed
+  bool ParseLine(const char *line, const char *line_end,
+                 storage::Tuple *tuple, type::AbstractPool *pool);
+
+  // Hand a batch to the executor thread, waits while the queue is full
+  void PushBatch(std::unique_ptr<TupleBatch> batch);
+
+  // Take the next batch, returns nullptr once all parsers are done
+  std::unique_ptr<TupleBatch> PopBatch();
+
+  // Record the first error and make the parsers stop
+  void SetError(const std::string &error_message);
+
+  // Insert a batch into the target table
+  bool InsertBatch(TupleBatch &batch);
+
+  // Unmap and close the input file
+  void CloseFile();
+
+  //===--------------------------------------------------------------------===//
+  // Executor State
+  //===--------------------------------------------------------------------===//
+
+  bool done_ = false;
+
+  storage::DataTable *target_table_ = nullptr;
+
+  const catalog::Schema *schema_ = nullptr;
+
+  char delimiter_ = ',';
+
+  bool defer_index_build_ = true;
+
+  // The memory mapped input file
+  int file_descriptor_ = -1;
+  const char *file_data_ = nullptr;
+  size_t file_size_ = 0;
+
+  // Parsed batches waiting to be inserted
+  std::mutex batch_mutex_;
+  std::condition_variable batch_cv_;
+  std::deque<std::unique_ptr<TupleBatch>> batch_queue_;
+  size_t max_queued_batches_ = 0;
+  size_t running_parser_count_ = 0;
+
+  // Set once a row is malformed or an insert failed
+  std::atomic<bool> failed_;
+  std::string error_message_;
+
+  // Index entries of the loaded rows, added to the indexes at the end
+  std::vector<ItemPointer *> deferred_index_entries_;
+
+  static size_t parser_count_;
+};
+
+}  // namespace executor
+}  // namespace peloton
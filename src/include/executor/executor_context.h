@@ -44,6 +44,10 @@ class ExecutorContext {
 
   ~ExecutorContext();
 
+  // Prepares the context for another execution of the same executor tree
+  void Reset(concurrency::Transaction *transaction,
+             const std::vector<type::Value> &params);
+
   concurrency::Transaction *GetTransaction() const;
 
   const std::vector<type::Value> &GetParams() const;
@@ -55,6 +59,25 @@ class ExecutorContext {
   // Get a pool
   type::EphemeralPool *GetPool();
 
+  // Collect per-executor counters (EXPLAIN ANALYZE)
+  inline void EnableProfiling() { profiling_enabled_ = true; }
+
+  inline bool IsProfilingEnabled() const { return profiling_enabled_; }
+
+  // Reserves memory of the query's budget, returns false without reserving
+  // if the budget does not have enough left. Operators spill then.
+  bool ReserveMemory(size_t bytes);
+
+  void ReleaseMemory(size_t bytes);
+
+  inline size_t GetMemoryUsage() const { return memory_usage_; }
+
+  inline size_t GetMemoryBudget() const { return memory_budget_; }
+
+  inline void SetMemoryBudget(size_t memory_budget) {
+    memory_budget_ = memory_budget;
+  }
+
   // num of tuple processed
   uint32_t num_processed = 0;
 
@@ -72,6 +95,13 @@ class ExecutorContext {
   // pool
   std::unique_ptr<type::EphemeralPool> pool_;
 
+  // whether executors record their profile
+  bool profiling_enabled_ = false;
+
+  // memory reserved by the operators and the most they may reserve
+  size_t memory_usage_ = 0;
+  size_t memory_budget_;
+
 };
 
 }  // namespace executor
@@ -19,6 +19,7 @@
 #include "type/types.h"
 #include "executor/abstract_executor.h"
 #include "executor/logical_tile.h"
+#include "executor/runtime_filter.h"
 #include "common/container_tuple.h"
 
 #include <boost/functional/hash.hpp>
@@ -40,6 +41,8 @@ class HashExecutor : public AbstractExecutor {
   explicit HashExecutor(const planner::AbstractPlan *node,
                         ExecutorContext *executor_context);
 
+  ~HashExecutor();
+
   /** @brief Type definitions for hash table */
   typedef std::unordered_map<
       expression::ContainerTuple<LogicalTile>,
@@ -48,18 +51,48 @@ class HashExecutor : public AbstractExecutor {
       expression::ContainerTupleHasher<LogicalTile>,
       expression::ContainerTupleComparator<LogicalTile>> HashMapType;
 
+  /** @brief The hash table, only built if the join table is enabled */
   inline HashMapType &GetHashTable() { return this->hash_table_; }
 
   inline const std::vector<oid_t> &GetHashKeyIds() const {
     return this->column_ids_;
   }
 
+  /**
+   * @brief Builds the hash table of the positions of every key for a hash
+   * join. Otherwise the executor only removes duplicate rows.
+   */
+  inline void EnableJoinTable() { join_table_enabled_ = true; }
+
+  /** @brief Builds a runtime filter of the keys along with the hash table */
+  inline void EnableRuntimeFilter() { runtime_filter_enabled_ = true; }
+
+  /** @brief The runtime filter, nullptr until the hash table is built */
+  inline std::shared_ptr<const RuntimeFilter> GetRuntimeFilter() const {
+    return runtime_filter_;
+  }
+
+  /**
+   * @brief Whether the join table did not fit the memory budget of the query
+   * and was not built. The join partitions its inputs to disk then.
+   */
+  inline bool HasOverflowed() const { return overflowed_; }
+
+  /** @brief Estimated bytes of the join table per row */
+  static const size_t join_table_row_bytes = 128;
+
  protected:
   bool DInit();
 
   bool DExecute();
 
  private:
+  /** @brief Hides all but the first row of every key */
+  void RemoveDuplicates();
+
+  /** @brief Reserves the budget of the join table, false if it is short */
+  bool ReserveJoinTable();
+
   /** @brief Hash table */
   HashMapType hash_table_;
 
@@ -68,6 +101,17 @@ class HashExecutor : public AbstractExecutor {
 
   std::vector<oid_t> column_ids_;
 
+  bool join_table_enabled_ = false;
+
+  bool runtime_filter_enabled_ = false;
+
+  std::shared_ptr<RuntimeFilter> runtime_filter_;
+
+  bool overflowed_ = false;
+
+  /** @brief Bytes of the budget reserved for the join table */
+  size_t reserved_memory_ = 0;
+
   bool done_ = false;
 
   size_t result_itr = 0;
@@ -17,8 +17,10 @@
 #include <vector>
 
 #include "executor/abstract_join_executor.h"
+#include "executor/abstract_scan_executor.h"
 #include "planner/hash_join_plan.h"
 #include "executor/hash_executor.h"
+#include "executor/spill_file.h"
 
 namespace peloton {
 namespace executor {
@@ -31,14 +33,72 @@ class HashJoinExecutor : public AbstractJoinExecutor {
   explicit HashJoinExecutor(const planner::AbstractPlan *node,
                             ExecutorContext *executor_context);
 
+  ~HashJoinExecutor();
+
+  // Partitions spilled per level, picked by the next four bits of the hash
+  static const size_t spill_partition_count = 16;
+
+  // Partitions are split again at most this many times
+  static const size_t max_spill_depth = 8;
+
+  // Rows per tile read back from a spill file
+  static const size_t spill_tile_size = 1 << 12;
+
  protected:
   bool DInit();
 
   bool DExecute();
 
  private:
+  // Rows of both sides with keys of the same hash bits, joined on their own
+  struct SpillPartition {
+    size_t depth = 0;
+    std::unique_ptr<SpillFile> left_file;
+    std::unique_ptr<SpillFile> right_file;
+    size_t left_rows = 0;
+    size_t right_rows = 0;
+  };
+
+  // Joins the last left tile with the right tiles of the hash table
+  void ProbeLeftTile(HashExecutor::HashMapType &hash_table,
+                     const std::vector<oid_t> &outer_col_ids);
+
+  //===--------------------------------------------------------------------===//
+  // Grace hash join, once the hash table does not fit the memory budget
+  //===--------------------------------------------------------------------===//
+
+  // Writes the buffered right tiles and all left tiles to partitions
+  void SpillInputs(const std::vector<oid_t> &outer_col_ids);
+
+  void SpillRow(std::vector<SpillPartition> &partitions,
+                const AbstractTuple *row, size_t column_count,
+                bool left_side);
+
+  // Adds the partitions that can produce output to the pending ones
+  void AddPartitions(std::vector<SpillPartition> &partitions);
+
+  // Splits a partition that does not fit the budget by the next hash bits
+  void Repartition(SpillPartition &partition);
+
+  bool ExecuteSpilled();
+
+  // Buffers the right rows of the partition and builds their hash table,
+  // or splits the partition if they do not fit
+  void LoadPartition(SpillPartition partition);
+
+  // Buffers the next left rows of the loaded partition, false at the end
+  bool LoadLeftTile();
+
+  void FinishPartition();
+
+  // Reads up to spill_tile_size rows, nullptr at the end of the file
+  LogicalTile *ReadSpilledTile(SpillFile &file, const catalog::Schema &schema);
+
   HashExecutor *hash_executor_ = nullptr;
 
+  // The scan of the probe side the runtime filter is pushed into
+  AbstractScanExecutor *probe_scan_ = nullptr;
+
   bool hashed_ = false;
 
   std::deque<LogicalTile *> buffered_output_tiles;
@@ -47,6 +107,30 @@ class HashJoinExecutor : public AbstractJoinExecutor {
   // logical tile iterators
   size_t left_logical_tile_itr_ = 0;
   size_t right_logical_tile_itr_ = 0;
+
+  bool spilled_ = false;
+
+  // Key columns of both sides
+  std::vector<oid_t> left_key_ids_;
+  std::vector<oid_t> right_key_ids_;
+
+  // Schemas of the spilled rows
+  std::unique_ptr<catalog::Schema> left_schema_;
+  std::unique_ptr<catalog::Schema> right_schema_;
+
+  std::vector<SpillPartition> pending_partitions_;
+
+  SpillPartition loaded_partition_;
+
+  bool partition_loaded_ = false;
+
+  HashExecutor::HashMapType partition_table_;
+
+  // Bytes of the budget reserved for the loaded partition
+  size_t reserved_memory_ = 0;
+
+  std::vector<char> key_buffer_;
+  std::vector<type::Value> row_values_;
 };
 
 }  // namespace executor
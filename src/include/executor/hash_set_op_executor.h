@@ -13,12 +13,10 @@
 
 #pragma once
 
-#include <unordered_map>
-
 #include "type/types.h"
 #include "executor/abstract_executor.h"
 #include "executor/logical_tile.h"
-#include "common/container_tuple.h"
+#include "executor/row_hash_table.h"
 
 namespace peloton {
 namespace executor {
@@ -38,6 +36,9 @@ namespace executor {
  * we can simply massage the validation flags of the left child
  * and forward the (logical tiles) upwards.
  * This avoids materialization.
+ *
+ * The rows are counted in a RowHashTable. Rows whose keys it spilled are
+ * handled one spilled partition at a time once both children are done.
  */
 class HashSetOpExecutor : public AbstractExecutor {
  public:
@@ -60,21 +61,21 @@ class HashSetOpExecutor : public AbstractExecutor {
     size_t right = 0;
   } counter_pair_t;
 
-  /** @brief Type definitions for hash table */
-  typedef std::unordered_map<
-      expression::ContainerTuple<LogicalTile>, counter_pair_t,
-      expression::ContainerTupleHasher<LogicalTile>,
-      expression::ContainerTupleComparator<LogicalTile>> HashSetOpMapType;
-
   /* Helper functions */
 
   bool ExecuteHelper();
 
+  static inline counter_pair_t &GetCounters(RowHashTable::Entry *entry) {
+    return *reinterpret_cast<counter_pair_t *>(entry->GetPayload());
+  }
+
+  bool CalculateCopies(RowHashTable &htable);
+
   template <SetOpType SETOP>
-  bool CalculateCopies(HashSetOpMapType &htable);
+  bool CalculateCopies(RowHashTable &htable);
 
-  /** @brief Hash table */
-  HashSetOpMapType htable_;
+  /** @brief Keeps the row if its key has copies left, hides it otherwise */
+  void KeepCopy(counter_pair_t &counters, LogicalTile *tile, oid_t tuple_id);
 
   /** @brief The specified set-op type */
   SetOpType set_op_ = SetOpType::INVALID;
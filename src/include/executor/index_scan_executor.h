@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "executor/abstract_scan_executor.h"
@@ -25,6 +26,7 @@ class Index;
 
 namespace storage {
 class AbstractTable;
+class Tuple;
 }
 
 namespace executor {
@@ -44,6 +46,18 @@ class IndexScanExecutor : public AbstractScanExecutor {
 
   void ResetState();
 
+  // Whether ProbeKeys() can look up keys of the given output columns, i.e.
+  // the scan is an equality on the whole primary key that binds them
+  bool CanProbeKeys(const std::vector<oid_t> &column_ids) const;
+
+  // Looks up a batch of keys of the given output columns with one index
+  // probe. The other key columns keep the values of the scan. Fills the
+  // result tiles of every key, returns false if the txn has to abort.
+  bool ProbeKeys(
+      const std::vector<oid_t> &column_ids,
+      const std::vector<std::vector<type::Value>> &keys,
+      std::vector<std::vector<std::unique_ptr<LogicalTile>>> &result_tiles);
+
  protected:
   bool DInit();
 
@@ -56,6 +70,20 @@ class IndexScanExecutor : public AbstractScanExecutor {
   bool ExecPrimaryIndexLookup();
   bool ExecSecondaryIndexLookup();
 
+  // Reads the visible tuple of an equality on the whole primary key, without
+  // building a scan predicate or collecting intermediate results
+  bool ExecPrimaryIndexPointLookup();
+
+  // Walks the version chain starting at the given location and reads the
+  // version visible to the txn, if it passes the predicate. visible_location
+  // stays null if there is none. Returns false if the txn has to abort.
+  bool ReadVisibleVersion(ItemPointer tuple_location, bool acquire_owner,
+                          bool &gc_requested, ItemPointer &visible_location);
+
+  // Records the length of a version chain walked by a lookup and lets long
+  // chains trigger a bounded, inline GC pass
+  void VersionChainTraversed(const size_t chain_length, bool &gc_requested);
+
   // When the required scan range has open boundaries, the tuples found by the
   // index might not be exact since the index can only give back tuples in a
   // close range. This function prune the head and the tail of the returned
@@ -109,6 +137,13 @@ class IndexScanExecutor : public AbstractScanExecutor {
 
   bool key_ready_ = false;
 
+  // whether the scan reads a single tuple by its primary key
+  bool point_lookup_ = false;
+
+  // key tuple of a point lookup, and the value of each of its columns
+  std::unique_ptr<storage::Tuple> point_key_;
+  std::vector<oid_t> point_key_offsets_;
+
   // whether the index scan range is left open
   bool left_open_ = false;
 
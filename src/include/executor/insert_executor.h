@@ -18,6 +18,12 @@
 #include <vector>
 
 namespace peloton {
+
+namespace storage {
+class DataTable;
+class Tuple;
+}
+
 namespace executor {
 
 class InsertExecutor : public AbstractExecutor {
@@ -36,6 +42,10 @@ class InsertExecutor : public AbstractExecutor {
   bool DExecute();
 
  private:
+  // Inserts the tuples into the table in one batch
+  bool InsertBatch(storage::DataTable *target_table,
+                   const std::vector<const storage::Tuple *> &tuples);
+
   bool done_ = false;
 };
 
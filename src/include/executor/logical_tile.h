@@ -115,6 +115,11 @@ class LogicalTile : public Printable {
   // Materialize and return a physical tile.
   std::unique_ptr<storage::Tile> Materialize();
 
+  // Copies the visible rows of the columns into the columns of a physical
+  // tile that old_to_new_cols maps them to, a column at a time
+  void MaterializeColumns(const std::unordered_map<oid_t, oid_t> &old_to_new_cols,
+                          storage::Tile *dest_tile);
+
   //===--------------------------------------------------------------------===//
   // Logical Tile Iterator
   //===--------------------------------------------------------------------===//
@@ -175,6 +180,56 @@ class LogicalTile : public Printable {
     oid_t origin_column_id;
   };
 
+  //===--------------------------------------------------------------------===//
+  // Column Gather
+  //===--------------------------------------------------------------------===//
+
+  /**
+   * @brief Copies values of a column of a logical tile into a column of a
+   * physical tile. Values of fixed size are copied as bytes straight from the
+   * base tile, only variable length values and NULL rows of outer joins go
+   * through type::Value.
+   */
+  class ColumnGather {
+   public:
+    ColumnGather(const LogicalTile *source_tile, oid_t column_id,
+                 storage::Tile *dest_tile, oid_t dest_column_id);
+
+    inline void Copy(oid_t tuple_id, oid_t dest_tuple_id) {
+      oid_t base_tuple_id = (*position_list_)[tuple_id];
+      if (byte_copy_ == true && base_tuple_id != NULL_OID) {
+        PL_MEMCPY(dest_data_ + dest_tuple_id * dest_tuple_length_,
+                  source_data_ + base_tuple_id * source_tuple_length_,
+                  value_length_);
+      } else {
+        CopyValue(base_tuple_id, dest_tuple_id);
+      }
+    }
+
+   private:
+    void CopyValue(oid_t base_tuple_id, oid_t dest_tuple_id);
+
+    const PositionList *position_list_;
+
+    storage::Tile *source_tile_;
+    size_t source_offset_;
+    type::Type::TypeId source_type_;
+    bool source_inlined_;
+
+    storage::Tile *dest_tile_;
+    size_t dest_offset_;
+    bool dest_inlined_;
+    size_t dest_length_;
+
+    // Both columns hold values of the same fixed size inline
+    bool byte_copy_ = false;
+    const char *source_data_ = nullptr;
+    size_t source_tuple_length_ = 0;
+    char *dest_data_ = nullptr;
+    size_t dest_tuple_length_ = 0;
+    size_t value_length_ = 0;
+  };
+
   //===--------------------------------------------------------------------===//
   // Position Lists Builder
   //===--------------------------------------------------------------------===//
@@ -288,53 +343,6 @@ class LogicalTile : public Printable {
   // Default constructor
   LogicalTile();
 
-  //===--------------------------------------------------------------------===//
-  // Materialize utilities. We can make these public if it is necessary.
-  // TODO: We might refactor MaterializationExecutor using these functions in
-  // the future
-  //===--------------------------------------------------------------------===//
-
-  // Column-oriented materialization
-  void MaterializeColumnAtATime(
-      const std::unordered_map<oid_t, oid_t> &old_to_new_cols,
-      const std::unordered_map<storage::Tile *, std::vector<oid_t>>
-          &tile_to_cols,
-      storage::Tile *dest_tile);
-
-  // Row-oriented materialization
-  void MaterializeRowAtAtATime(
-      const std::unordered_map<oid_t, oid_t> &old_to_new_cols,
-      const std::unordered_map<storage::Tile *, std::vector<oid_t>>
-          &tile_to_cols,
-      storage::Tile *dest_tile);
-
-  /**
-   * @brief Does the actual copying of data into the new physical tile.
-   * @param tile_to_cols Map from base tile to columns in that tile
-   *        to be materialized.
-   * @param dest_tile New tile to copy data into.
-   */
-  void MaterializeByTiles(
-      const std::unordered_map<oid_t, oid_t> &old_to_new_cols,
-      const std::unordered_map<storage::Tile *, std::vector<oid_t>>
-          &tile_to_cols,
-      storage::Tile *dest_tile);
-
-  /**
-   * @brief Generates map from each base tile to columns originally from that
-   *        base tile to be materialized.
-   * @param column_ids Ids of columns to be materialized.
-   * @param tile_to_cols Map to be populated with mappings from tile to columns.
-   *
-   * We generate this mapping so that we can materialize columns tile by tile
-   *for
-   * efficiency reasons.
-   */
-  void GenerateTileToColMap(
-      const std::unordered_map<oid_t, oid_t> &old_to_new_cols,
-      std::unordered_map<storage::Tile *, std::vector<oid_t>>
-          &cols_in_physical_tile);
-
   //===--------------------------------------------------------------------===//
   // Members
   //===--------------------------------------------------------------------===//
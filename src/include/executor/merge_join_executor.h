@@ -13,6 +13,8 @@
 
 #pragma once
 
+#include <deque>
+#include <memory>
 #include <vector>
 
 #include "executor/abstract_join_executor.h"
@@ -29,14 +31,36 @@ class MergeJoinExecutor : public AbstractJoinExecutor {
   explicit MergeJoinExecutor(const planner::AbstractPlan *node,
                              ExecutorContext *executor_context);
 
+  // Threads that partition, sort and merge the inputs of the plans that
+  // leave the sorting to the join
+  static void SetSortThreadCount(size_t sort_thread_count);
+
  protected:
   bool DInit();
 
   bool DExecute();
 
  private:
+  struct SortEntry;
+  struct KeyRun;
+  struct Partition;
+
+  // How the values of a join clause are normalized, both sides the same way
+  enum class KeyKind { INTEGER, DECIMAL, TIMESTAMP, STRING, TEXT };
+
   size_t Advance(LogicalTile *tile, size_t start_row, bool is_left);
 
+  // Joins the whole inputs at once: both are partitioned by ranges of the
+  // normalized join keys, the partitions are sorted and merged in parallel
+  void SortMergeJoin();
+
+  // Normalizes the keys of the rows of every thread_count-th buffered tile
+  // of a side, starting at first_tile
+  void ExtractKeys(bool is_left, size_t first_tile, size_t thread_count,
+                   KeyRun &run) const;
+
+  void MergePartition(Partition &partition) const;
+
   /** @brief a vector of join clauses
    * Get this from plan node during initialization */
   const std::vector<planner::MergeJoinPlan::JoinClause> *join_clauses_;
@@ -46,6 +70,16 @@ class MergeJoinExecutor : public AbstractJoinExecutor {
 
   size_t left_end_row = 0;
   size_t right_end_row = 0;
+
+  bool sort_inputs_ = false;
+
+  bool sort_merge_done_ = false;
+
+  std::vector<KeyKind> key_kinds_;
+
+  std::deque<std::unique_ptr<LogicalTile>> sorted_output_tiles_;
+
+  static size_t sort_thread_count_;
 };
 
 }  // namespace executor
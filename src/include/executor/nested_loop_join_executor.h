@@ -13,12 +13,17 @@
 #pragma once
 
 #include "executor/abstract_join_executor.h"
+#include "type/value.h"
 
+#include <memory>
+#include <unordered_set>
 #include <vector>
 
 namespace peloton {
 namespace executor {
 
+class IndexScanExecutor;
+
 class NestedLoopJoinExecutor : public AbstractJoinExecutor {
   NestedLoopJoinExecutor(const NestedLoopJoinExecutor &) = delete;
   NestedLoopJoinExecutor &operator=(const NestedLoopJoinExecutor &) = delete;
@@ -32,6 +37,25 @@ class NestedLoopJoinExecutor : public AbstractJoinExecutor {
   bool DExecute();
 
  private:
+  // The rows of a left tile that share one join key, and the right rows
+  // found for it by an index probe
+  struct KeyProbe {
+    std::vector<type::Value> key_;
+    std::vector<oid_t> left_rows_;
+    std::vector<std::unique_ptr<LogicalTile>> right_tiles_;
+  };
+
+  // Joins whole left tiles against the index of the right child
+  bool ExecuteBatchedIndexJoin(const std::vector<oid_t> &join_column_ids_left,
+                               const std::vector<oid_t> &join_column_ids_right);
+
+  // Whether the pair of rows satisfies the join predicate, if there is one
+  bool MatchesPredicate(LogicalTile *left_tile, oid_t left_row,
+                        LogicalTile *right_tile, oid_t right_row) const;
+
+  // Groups the rows of the current left tile by join key, in key order
+  void BuildKeyProbes(const std::vector<oid_t> &join_column_ids_left);
+
   // Right child's result tiles iterator
   size_t right_result_itr_ = 0;
 
@@ -51,6 +75,27 @@ class NestedLoopJoinExecutor : public AbstractJoinExecutor {
   // return the combine result when there is a matched right tile. So next time,
   // we will begin from the point of last time, if left_tile_done is false
   bool left_tile_done_ = true;
+
+  // True if the right child is an index scan of an inner or left join. The
+  // index is then probed once per distinct key of a left tile instead of once
+  // per left row.
+  bool batched_index_join_ = false;
+
+  // The right child if it can look up all keys of a left tile with a single
+  // index probe, otherwise it is executed once per key
+  IndexScanExecutor *index_probe_child_ = nullptr;
+
+  // Rows of the current left tile without a match yet, in left joins
+  std::unordered_set<oid_t> no_matching_left_rows_;
+
+  // Distinct join keys of the current left tile in sorted order
+  std::vector<KeyProbe> key_probes_;
+
+  // The key probe being joined and whether the right child was set up for it.
+  // The right tiles of a key are joined in order, right_result_itr_ is the
+  // next one.
+  size_t key_probe_itr_ = 0;
+  bool key_probe_started_ = false;
 };
 
 }  // namespace executor
@@ -12,12 +12,21 @@
 
 #pragma once
 
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
 #include "common/statement.h"
 #include "executor/abstract_executor.h"
 #include "type/types.h"
 #include "concurrency/transaction_manager_factory.h"
 
 namespace peloton {
+
+namespace executor {
+class ExecutorContext;
+}
+
 namespace bridge {
 
 //===--------------------------------------------------------------------===//
@@ -45,6 +54,58 @@ typedef struct peloton_status {
 
 } peloton_status;
 
+//===--------------------------------------------------------------------===//
+// Executor Tree
+//===--------------------------------------------------------------------===//
+
+// The executors built for a plan, together with their context
+struct ExecutorTree {
+  ExecutorTree(const planner::AbstractPlan *plan,
+               executor::ExecutorContext *executor_context);
+
+  ~ExecutorTree();
+
+  const planner::AbstractPlan *plan_;
+
+  std::unique_ptr<executor::ExecutorContext> executor_context_;
+
+  std::unique_ptr<executor::AbstractExecutor> root_;
+};
+
+/*
+ * Keeps the executor trees of a prepared statement across its executions,
+ * one per worker thread. A tree is checked out for an execution, so it is
+ * never shared, and is re-initialized with the new params and txn instead
+ * of being rebuilt.
+ */
+class ExecutorTreeCache {
+ public:
+  ExecutorTreeCache(const ExecutorTreeCache &) = delete;
+  ExecutorTreeCache &operator=(const ExecutorTreeCache &) = delete;
+
+  ExecutorTreeCache() {}
+
+  // Takes the tree of the calling thread, nullptr if there is none
+  std::unique_ptr<ExecutorTree> Acquire(const planner::AbstractPlan *plan);
+
+  // Gives back a tree after a complete execution. Trees that contain
+  // executors which can not be re-initialized are dropped.
+  void Release(std::unique_ptr<ExecutorTree> tree);
+
+  // Drops all trees, e.g. when the plan is replaced
+  void Clear();
+
+  size_t GetSize();
+
+  // Whether all executors of the plan reset their state in DInit()
+  static bool IsReusable(const planner::AbstractPlan *plan);
+
+ private:
+  std::mutex mutex_;
+
+  std::unordered_map<std::thread::id, std::unique_ptr<ExecutorTree>> trees_;
+};
+
 class PlanExecutor {
  public:
   PlanExecutor(const PlanExecutor &) = delete;
@@ -77,12 +138,18 @@ class PlanExecutor {
    * for networking
    * Before ExecutePlan, a node first receives value list, so we should
    * pass value list directly rather than passing Postgres's ParamListInfo
+   * If profile_info is given, the executors are profiled and the annotated
+   * executor tree is written to it (EXPLAIN ANALYZE)
+   * If tree_cache is given, the executor tree is taken from and returned
+   * to it instead of being built and torn down
    */
   static peloton_status ExecutePlan(const planner::AbstractPlan *plan,
                                     concurrency::Transaction* txn,
                                     const std::vector<type::Value> &params,
                                     std::vector<StatementResult> &result,
-                                    const std::vector<int> &result_format);
+                                    const std::vector<int> &result_format,
+                                    std::string *profile_info = nullptr,
+                                    ExecutorTreeCache *tree_cache = nullptr);
 
   /*
    * @brief When a peloton node recvs a query plan, this function is invoked
@@ -35,6 +35,8 @@ class ProjectionExecutor : public AbstractExecutor {
   bool DExecute();
 
  private:
+  bool PassThrough(LogicalTile *source_tile);
+
   //===--------------------------------------------------------------------===//
   // Executor State
   //===--------------------------------------------------------------------===//
@@ -0,0 +1,220 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// row_hash_table.h
+//
+// Identification: src/include/executor/row_hash_table.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "common/arena.h"
+#include "executor/spill_file.h"
+#include "type/types.h"
+#include "type/value.h"
+
+namespace peloton {
+
+class AbstractTuple;
+
+namespace executor {
+
+class ExecutorContext;
+
+//===--------------------------------------------------------------------===//
+// RowHashTable
+//
+// A hash table of row keys for DISTINCT and set operations. Keys are packed
+// into bytes that are equal exactly if the keys are, NULLs equal each other
+// and integers of all widths compare by value. Every entry holds its packed
+// key, the hash of it and a zeroed payload of fixed size for the caller,
+// and lives in an arena of the table.
+//
+// Once the table holds more than the memory limit, or the budget of the
+// query has no memory left for it, keys that are not in it yet are no longer
+// added but spilled: the key and a record of fixed size from the caller are
+// appended to a spill file, one of partition_count files picked by the hash. Keys in memory are never spilled, so all records
+// of a key are either in memory or in the same file. After the input the
+// caller loads the spilled partitions one at a time.
+//===--------------------------------------------------------------------===//
+class RowHashTable {
+ public:
+  RowHashTable(const RowHashTable &) = delete;
+  RowHashTable &operator=(const RowHashTable &) = delete;
+
+  class Entry {
+   public:
+    inline const char *GetKey() const {
+      return reinterpret_cast<const char *>(this + 1);
+    }
+
+    inline uint32_t GetKeySize() const { return key_size; }
+
+    inline uint64_t GetHash() const { return hash; }
+
+    // The payload follows the key, aligned for any scalar type
+    inline char *GetPayload() {
+      return reinterpret_cast<char *>(this + 1) + GetPayloadOffset(key_size);
+    }
+
+   private:
+    friend class RowHashTable;
+
+    static inline size_t GetPayloadOffset(size_t key_size) {
+      return (key_size + 7) & ~size_t(7);
+    }
+
+    Entry *next;
+    uint64_t hash;
+    uint32_t key_size;
+  };
+
+  // Records of spilled keys are of record_size bytes. The block size is the
+  // size of the first arena block, small tables stay small.
+  RowHashTable(const std::vector<type::Type::TypeId> &key_types,
+               size_t payload_size, size_t record_size = 0,
+               size_t block_size = Arena::default_block_size);
+
+  ~RowHashTable();
+
+  // Charges the memory of the table to the budget of the query
+  void SetExecutorContext(ExecutorContext *executor_context) {
+    executor_context_ = executor_context;
+  }
+
+  // The entry of the key of the tuple columns, nullptr if it is not in the
+  // table. While the table spills, a key that is not in it is spilled with
+  // the record if there is one.
+  Entry *Find(const AbstractTuple *tuple,
+              const std::vector<oid_t> &column_ids,
+              const void *record = nullptr);
+
+  // The entry of the key, added with a zeroed payload if it is new. Returns
+  // nullptr if the key was spilled with the record instead.
+  Entry *Insert(const AbstractTuple *tuple,
+                const std::vector<oid_t> &column_ids, const void *record,
+                bool &inserted);
+
+  // Insert for keys of a single value
+  Entry *Insert(const type::Value &value, const void *record, bool &inserted);
+
+  // Entries in the order they were added
+  inline const std::vector<Entry *> &GetEntries() const { return entries_; }
+
+  inline size_t GetEntryCount() const { return entries_.size(); }
+
+  // Unpacks the key of an entry into values of the key types
+  void GetKey(const Entry *entry, std::vector<type::Value> &values) const;
+
+  // Bytes of the entries and the buckets
+  size_t GetMemoryUsage() const;
+
+  inline bool IsSpilling() const { return spilling_; }
+
+  inline bool IsPartitionSpilled(size_t partition) const {
+    return spill_files_[partition] != nullptr;
+  }
+
+  // Empties the table and starts reading the records spilled to the
+  // partition. The keys of the records are all added, the memory limit does
+  // not apply to them.
+  void LoadPartition(size_t partition);
+
+  // Reads the records of the loaded partition again, the keys stay
+  void RewindPartition();
+
+  // The entry of the key of the next record of the loaded partition, added
+  // if it is new, nullptr after the last record
+  Entry *NextRecord(const char *&record, bool &inserted);
+
+  // Bytes all tables created after this may use before they spill
+  static void SetMemoryLimit(size_t memory_limit);
+
+  static size_t GetMemoryLimit() { return memory_limit_; }
+
+  static const size_t partition_count = 16;
+
+  // Appends the value packed as a key column
+  static void PackValue(std::vector<char> &bytes, const type::Value &value);
+
+  // Reads a packed value as a value of the type and moves past it
+  static type::Value UnpackValue(const char *&data,
+                                 const type::Type::TypeId type_id);
+
+  static uint64_t HashBytes(const char *data, size_t size);
+
+  // Packs the key of the tuple columns into the buffer and returns its hash,
+  // the same hash the table uses
+  static uint64_t HashKey(const AbstractTuple *tuple,
+                          const std::vector<oid_t> &column_ids,
+                          std::vector<char> &buffer);
+
+  // The table reserves memory of the budget in chunks of at least this
+  static const size_t reservation_size = 1 << 16;
+
+ private:
+  // Packs the key into key_buffer_ and returns its hash
+  uint64_t PackKey(const AbstractTuple *tuple,
+                   const std::vector<oid_t> &column_ids);
+
+  Entry *FindPacked(uint64_t hash) const;
+
+  // Inserts the key in key_buffer_, or spills it with the record
+  Entry *InsertPacked(uint64_t hash, const void *record, bool &inserted);
+
+  Entry *AddEntry(uint64_t hash);
+
+  void Spill(uint64_t hash, const void *record);
+
+  // Reserves budget for the memory the table uses, false if there is none
+  bool ReserveMemory();
+
+  void Clear();
+
+  void Grow();
+
+  std::vector<type::Type::TypeId> key_types_;
+
+  size_t payload_size_;
+
+  size_t record_size_;
+
+  size_t block_size_;
+
+  std::unique_ptr<Arena> arena_;
+
+  // Chains of entries, a power of two of them
+  std::vector<Entry *> buckets_;
+
+  std::vector<Entry *> entries_;
+
+  std::vector<char> key_buffer_;
+
+  size_t table_memory_limit_;
+
+  bool spilling_ = false;
+
+  std::vector<std::unique_ptr<SpillFile>> spill_files_;
+
+  // The partition records are read from
+  SpillFile *loaded_file_ = nullptr;
+
+  ExecutorContext *executor_context_ = nullptr;
+
+  // Bytes reserved of the budget of the query
+  size_t reserved_memory_ = 0;
+
+  std::vector<char> record_buffer_;
+
+  static size_t memory_limit_;
+};
+
+}  // namespace executor
+}  // namespace peloton
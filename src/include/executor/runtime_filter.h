@@ -0,0 +1,103 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// runtime_filter.h
+//
+// Identification: src/include/executor/runtime_filter.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "type/types.h"
+#include "type/value.h"
+
+namespace peloton {
+
+class AbstractTuple;
+
+namespace executor {
+
+//===--------------------------------------------------------------------===//
+// RuntimeFilter
+//
+// A summary of the build keys of a hash join that the join pushes into the
+// scan of its probe side once the build is done, so the scan can discard
+// the rows that can not find a match before it materializes them.
+//
+// Every key is hashed into a blocked Bloom filter: all of its bits are in a
+// single 64-bit word, so a lookup touches one cache line. The smallest and
+// largest key of every numeric and timestamp column are kept too, the scan
+// compares them with the zone maps to skip whole tile groups.
+//===--------------------------------------------------------------------===//
+class RuntimeFilter {
+ public:
+  RuntimeFilter(const RuntimeFilter &) = delete;
+  RuntimeFilter &operator=(const RuntimeFilter &) = delete;
+
+  RuntimeFilter(const std::vector<type::Type::TypeId> &key_types,
+                const size_t expected_key_count);
+
+  // Adds the key of a build tuple. Keys with a NULL never match and are
+  // skipped.
+  void Insert(const AbstractTuple *tuple,
+              const std::vector<oid_t> &key_column_ids);
+
+  // Returns false if no build key equals the key of the tuple. May return
+  // true for keys that were not inserted, never false for ones that were.
+  bool MayContain(const AbstractTuple *tuple,
+                  const std::vector<oid_t> &key_column_ids) const;
+
+  // Returns false if the key column has no range, because its type has none
+  // or no key was inserted
+  bool GetRange(const oid_t key_offset, type::Value &min_value,
+                type::Value &max_value) const;
+
+  // Whether values of a probe column of the type hash like the keys
+  bool IsCompatible(const oid_t key_offset,
+                    const type::Type::TypeId probe_type) const;
+
+  const std::vector<type::Type::TypeId> &GetKeyTypes() const {
+    return key_types_;
+  }
+
+  size_t GetKeyCount() const { return key_count_; }
+
+  // Bits of the Bloom filter per expected key
+  static const size_t bits_per_key = 16;
+
+  // Bits set per key
+  static const size_t hash_count = 4;
+
+ private:
+  // Hashes the key, NULL keys are reported through has_null
+  uint64_t HashKey(const AbstractTuple *tuple,
+                   const std::vector<oid_t> &key_column_ids,
+                   bool &has_null) const;
+
+  // The bits of the word a hash sets
+  static uint64_t GetBitMask(const uint64_t hash);
+
+  std::vector<type::Type::TypeId> key_types_;
+
+  size_t key_count_ = 0;
+
+  std::vector<uint64_t> words_;
+
+  uint64_t word_mask_;
+
+  // Ranges of the key columns, valid where has_range_ is set
+  std::vector<bool> has_range_;
+
+  std::vector<type::Value> min_values_;
+
+  std::vector<type::Value> max_values_;
+};
+
+}  // namespace executor
+}  // namespace peloton
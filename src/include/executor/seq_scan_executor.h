@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "planner/seq_scan_plan.h"
 #include "executor/abstract_scan_executor.h"
 
@@ -36,6 +38,9 @@ class SeqScanExecutor : public AbstractScanExecutor {
   bool DExecute();
 
  private:
+  bool FilterCompressed(storage::TileGroup *tile_group,
+                        std::vector<bool> &matches);
+
   //===--------------------------------------------------------------------===//
   // Executor State
   //===--------------------------------------------------------------------===//
@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// spill_file.h
+//
+// Identification: src/include/executor/spill_file.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "type/types.h"
+#include "type/value.h"
+
+namespace peloton {
+
+class AbstractTuple;
+
+namespace executor {
+
+//===--------------------------------------------------------------------===//
+// SpillFile
+//
+// A temporary file in the spill directory that operators write rows to once
+// they run out of memory, and read back from the start. Writes and reads go
+// through a large buffer, so the disk only sees big sequential requests. The
+// file is unlinked right away and vanishes when it is closed.
+//===--------------------------------------------------------------------===//
+class SpillFile {
+ public:
+  SpillFile(const SpillFile &) = delete;
+  SpillFile &operator=(const SpillFile &) = delete;
+
+  SpillFile();
+
+  ~SpillFile();
+
+  void Write(const void *data, size_t size);
+
+  // Writes the first column_count values of the tuple, packed
+  void WriteRow(const AbstractTuple *tuple, size_t column_count);
+
+  // Ends writing and starts reading from the start, again if it was read
+  void Rewind();
+
+  // Returns false at the end of the file
+  bool Read(void *data, size_t size);
+
+  // Reads a row as values of the types, returns false at the end of the file
+  bool ReadRow(const std::vector<type::Type::TypeId> &types,
+               std::vector<type::Value> &values);
+
+  // Bytes written
+  inline size_t GetSize() const { return size_; }
+
+  static const size_t buffer_size = 1 << 18;
+
+ private:
+  void Flush();
+
+  int fd_;
+
+  std::vector<char> buffer_;
+
+  // Next byte of the buffer to write or read, and the end of the read bytes
+  size_t buffer_offset_ = 0;
+  size_t buffer_end_ = 0;
+
+  bool reading_ = false;
+
+  size_t size_ = 0;
+
+  std::vector<char> row_buffer_;
+};
+
+}  // namespace executor
+}  // namespace peloton
@@ -14,6 +14,7 @@
 
 #include <string>
 
+#include "common/arena.h"
 #include "common/logger.h"
 #include "common/macros.h"
 #include "common/printable.h"
@@ -46,7 +47,7 @@ namespace expression {
 // remain constant and read-only during an execution.
 //===----------------------------------------------------------------------===//
 
-class AbstractExpression : public Printable {
+class AbstractExpression : public Printable, public ArenaAllocated {
  public:
   virtual type::Value Evaluate(const AbstractTuple *tuple1,
                          const AbstractTuple *tuple2,
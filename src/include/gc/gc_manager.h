@@ -29,6 +29,9 @@ class TileGroup;
 
 namespace gc {
 
+// Workers that walk more versions than this help collecting garbage
+#define COOPERATIVE_GC_CHAIN_LENGTH 4
+
 //===--------------------------------------------------------------------===//
 // GC Manager
 //===--------------------------------------------------------------------===//
@@ -60,6 +63,12 @@ class GCManager {
 
   virtual void StopGC() {}
 
+  // Pauses and resumes the background passes. Workers keep helping the GC
+  // while it is paused.
+  virtual void PauseGC() {}
+
+  virtual void ResumeGC() {}
+
   virtual ItemPointer ReturnFreeSlot(const oid_t &table_id UNUSED_ATTRIBUTE) {
     return INVALID_ITEMPOINTER;
   }
@@ -73,6 +82,10 @@ class GCManager {
   virtual void RecycleTransaction(std::shared_ptr<GCSet> gc_set UNUSED_ATTRIBUTE, 
                                    const cid_t &timestamp UNUSED_ATTRIBUTE) {}
 
+  // Lets a worker that walked a long version chain help the GC threads with
+  // a small, bounded batch of work. Never blocks.
+  virtual void CooperativeCollect() {}
+
  protected:
   void CheckAndReclaimVarlenColumns(storage::TileGroup *tg, oid_t tuple_id);
 
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <thread>
 #include <unordered_map>
 #include <map>
@@ -21,6 +22,7 @@
 #include "type/types.h"
 #include "common/logger.h"
 #include "common/init.h"
+#include "common/platform.h"
 #include "common/thread_pool.h"
 #include "gc/gc_manager.h"
 
@@ -32,6 +34,9 @@ namespace gc {
 #define MAX_QUEUE_LENGTH 100000
 #define MAX_ATTEMPT_COUNT 100000
 
+// Max number of garbage contexts a worker unlinks or reclaims inline
+#define COOPERATIVE_GC_BATCH_SIZE 8
+
 
 struct GarbageContext {
   GarbageContext() : timestamp_(INVALID_CID) {}
@@ -49,6 +54,8 @@ class TransactionLevelGCManager : public GCManager {
 public:
   TransactionLevelGCManager(int thread_count) 
     : gc_thread_count_(thread_count),
+      partition_locks_(thread_count),
+      is_paused_(false),
       reclaim_maps_(thread_count) {
 
     unlink_queues_.reserve(thread_count);
@@ -91,8 +98,14 @@ public:
     this->is_running_ = false;
   }
 
+  virtual void PauseGC() override;
+
+  virtual void ResumeGC() override { is_paused_ = false; }
+
   virtual void RecycleTransaction(std::shared_ptr<GCSet> gc_set, const cid_t &timestamp) override;
 
+  virtual void CooperativeCollect() override;
+
   virtual ItemPointer ReturnFreeSlot(const oid_t &table_id) override;
 
   virtual void RegisterTable(const oid_t &table_id) override {
@@ -124,11 +137,19 @@ private:
 
   void Running(const int &thread_id);
 
-  int Unlink(const int &thread_id, const cid_t &max_cid);
+  // Reclaims and unlinks at most max_count contexts each of the given
+  // partition. The caller must hold the partition lock.
+  int Collect(const int &thread_id, const size_t &max_count,
+              const bool is_inline);
 
-  int Reclaim(const int &thread_id, const cid_t &max_cid);
+  int Unlink(const int &thread_id, const cid_t &max_cid,
+             const size_t &max_count = MAX_ATTEMPT_COUNT);
 
-  void AddToRecycleMap(std::shared_ptr<GarbageContext> gc_ctx);
+  int Reclaim(const int &thread_id, const cid_t &max_cid,
+              size_t &version_count,
+              const size_t &max_count = MAX_ATTEMPT_COUNT);
+
+  size_t AddToRecycleMap(std::shared_ptr<GarbageContext> gc_ctx);
 
   bool ResetTuple(const ItemPointer &);
 
@@ -143,6 +164,13 @@ private:
 
   int gc_thread_count_;
 
+  // Serializes the background thread of a partition with the workers
+  // helping it. # partition_locks == # gc_threads
+  std::vector<Spinlock> partition_locks_;
+
+  // Background passes are skipped while set, checked under the partition lock
+  std::atomic<bool> is_paused_;
+
   // queues for to-be-unlinked tuples.
   // # unlink_queues == # gc_threads
   std::vector<std::shared_ptr<peloton::LockFreeQueue<std::shared_ptr<GarbageContext>>>> unlink_queues_;
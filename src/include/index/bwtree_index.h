@@ -96,6 +96,9 @@ class BWTreeIndex : public Index {
   void ScanKey(const storage::Tuple *key,
                std::vector<ValueType> &result);
 
+  void ScanKeys(const std::vector<const storage::Tuple *> &keys,
+                std::vector<std::vector<ValueType>> &results);
+
   std::string GetTypeName() const;
 
   // TODO: Implement this
@@ -283,6 +283,11 @@ class Index : public Printable {
   virtual void ScanKey(const storage::Tuple *key,
                        std::vector<ItemPointer *> &result) = 0;
 
+  // Looks up a batch of keys at once and fills one result list per key.
+  // Ordered indexes probe the keys in key order with a single iterator.
+  virtual void ScanKeys(const std::vector<const storage::Tuple *> &keys,
+                        std::vector<std::vector<ItemPointer *>> &results);
+
   ///////////////////////////////////////////////////////////////////
   // Garbage Collection
   ///////////////////////////////////////////////////////////////////
@@ -182,6 +182,11 @@ class LogManager {
   // log an insert
   void LogInsert(cid_t commit_id, const ItemPointer &new_location);
 
+  // log all inserts of a transaction into one tile group. they share the
+  // catalog lookups and the tuple buffer.
+  void LogInserts(cid_t commit_id, oid_t tile_group_id,
+                  const std::vector<oid_t> &tuple_slots);
+
   // log a delete
   void LogDelete(cid_t commit_id, const ItemPointer &delete_location);
 
@@ -34,7 +34,8 @@ class LoggingUtil {
 
   static bool IsBasedOnWriteBehindLogging(const LoggingType &logging_type);
 
-  static void FFlushFsync(FileHandle &file_handle);
+  // Returns false if flushing or syncing the file failed
+  static bool FFlushFsync(FileHandle &file_handle);
 
   static bool InitFileHandle(const char *name, FileHandle &file_handle,
                              const char *mode);
@@ -41,6 +41,7 @@ class ChildPropertyGenerator : public OperatorVisitor {
   void Visit(const PhysicalLeftHashJoin *) override;
   void Visit(const PhysicalRightHashJoin *) override;
   void Visit(const PhysicalOuterHashJoin *) override;
+  void Visit(const PhysicalInnerMergeJoin *) override;
 
  private:
   ColumnManager &manager_;
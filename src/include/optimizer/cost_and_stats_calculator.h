@@ -51,6 +51,7 @@ class CostAndStatsCalculator : public OperatorVisitor {
   void Visit(const PhysicalLeftHashJoin *) override;
   void Visit(const PhysicalRightHashJoin *) override;
   void Visit(const PhysicalOuterHashJoin *) override;
+  void Visit(const PhysicalInnerMergeJoin *) override;
 
  private:
   ColumnManager &manager_;
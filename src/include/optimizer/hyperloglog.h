@@ -0,0 +1,60 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// hyperloglog.h
+//
+// Identification: src/include/optimizer/hyperloglog.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace peloton {
+
+namespace type {
+class Value;
+}
+
+namespace optimizer {
+
+//===--------------------------------------------------------------------===//
+// HyperLogLog
+//
+// Estimates the number of distinct values it was fed in 2^precision bytes.
+// The standard error is about 1.04 / sqrt(2^precision), 1.6% by default.
+//===--------------------------------------------------------------------===//
+
+class HyperLogLog {
+ public:
+  HyperLogLog(uint8_t precision = default_precision);
+
+  // NULLs are not counted
+  void Add(const type::Value &value);
+
+  void AddHash(uint64_t hash);
+
+  // Afterwards this estimates the union of both inputs. Both sketches must
+  // have the same precision.
+  void Merge(const HyperLogLog &other);
+
+  double Estimate() const;
+
+  inline uint8_t GetPrecision() const { return precision_; }
+
+  static const uint8_t default_precision = 12;
+
+ private:
+  uint8_t precision_;
+
+  // Per register the longest run of leading zeros seen plus one
+  std::vector<uint8_t> registers_;
+};
+
+}  // End optimizer namespace
+}  // End peloton namespace
@@ -0,0 +1,166 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// join_enumerator.h
+//
+// Identification: src/include/optimizer/join_enumerator.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "type/types.h"
+#include "type/value.h"
+
+namespace peloton {
+
+namespace expression {
+class AbstractExpression;
+}
+
+namespace storage {
+class DataTable;
+}
+
+namespace optimizer {
+
+class OperatorExpression;
+class TableStats;
+
+// A column of a relation of the join graph: the relation and the column id
+// in its table
+typedef std::pair<size_t, oid_t> JoinColumn;
+
+//===--------------------------------------------------------------------===//
+// JoinEnumerator
+//
+// Finds the cheapest order and algorithms to inner join a set of base
+// relations. The predicates are split into single-relation filters that are
+// pushed into the scans and join predicates that form the edges of the
+// query graph. Connected sub-graphs are enumerated bottom up with DPccp
+// (Moerkotte and Neumann), which considers every bushy tree without cross
+// products once, and every join is costed as a nested loop, index nested
+// loop, hash and merge join. Cardinalities come from the statistics of
+// ANALYZE when there are any. Graphs that are too large are ordered
+// greedily.
+//
+// The columns of the expressions handed to the enumerator are resolved to
+// relations: the tuple index of a column is the relation, the value index
+// the column in the table.
+//===--------------------------------------------------------------------===//
+class JoinEnumerator {
+ public:
+  JoinEnumerator(const JoinEnumerator &) = delete;
+  JoinEnumerator &operator=(const JoinEnumerator &) = delete;
+
+  JoinEnumerator();
+
+  ~JoinEnumerator();
+
+  // Adds a base relation and returns its index. The columns of the relation
+  // can be qualified with the name.
+  size_t AddRelation(storage::DataTable *table, const std::string &name);
+
+  // Resolves the columns of the expression to the relations and fills in the
+  // types. Throws if a column does not exist or is ambiguous.
+  void ResolveColumns(expression::AbstractExpression *expr) const;
+
+  // Adds the conjuncts of a resolved WHERE or ON predicate
+  void AddPredicate(const expression::AbstractExpression *predicate);
+
+  // Marks the columns of a resolved expression as needed above the joins
+  void AddOutputColumns(const expression::AbstractExpression *expr);
+
+  // Marks all columns of the relation as needed above the joins
+  void AddOutputColumns(size_t relation);
+
+  // Finds the cheapest join tree. The leaves are PhysicalScans, the inner
+  // nodes physical inner joins whose predicates are bound to the outputs of
+  // their children.
+  std::shared_ptr<OperatorExpression> Enumerate();
+
+  // The columns the tree returned by Enumerate() outputs, in order
+  const std::vector<JoinColumn> &GetOutputLayout() const {
+    return output_layout_;
+  }
+
+  // Rewrites the resolved columns of an expression to positions in a
+  // layout. Columns of the left layout get tuple index 0, the others 1.
+  static void BindColumns(expression::AbstractExpression *expr,
+                          const std::vector<JoinColumn> &left_layout,
+                          const std::vector<JoinColumn> &right_layout);
+
+  // Finds a visible index of the table all of whose key columns are bound
+  // by equality, returns INVALID_OID if there is none
+  static oid_t FindLookupIndex(storage::DataTable *table,
+                               const std::vector<oid_t> &bound_column_ids);
+
+  // Collects the columns of the table compared for equality with a constant
+  // or a parameter in the conjuncts of a scan predicate
+  static void GetEqualityConstants(const expression::AbstractExpression *expr,
+                                   std::vector<oid_t> &column_ids,
+                                   std::vector<type::Value> &values);
+
+  // Relations above this many are ordered greedily
+  static const size_t max_dp_relations = 12;
+
+ private:
+  struct Relation;
+  struct Conjunct;
+  struct JoinPlan;
+
+  typedef uint64_t RelationSet;
+
+  void BuildGraph();
+
+  double EstimateFilterSelectivity(
+      const Relation &relation,
+      const expression::AbstractExpression *conjunct) const;
+
+  double EstimateJoinSelectivity(const Conjunct &conjunct) const;
+
+  double GetCardinality(RelationSet relations);
+
+  RelationSet GetNeighbors(RelationSet relations, RelationSet excluded) const;
+
+  // DPccp
+  void EnumerateCsgRec(RelationSet csg, RelationSet excluded);
+  void EmitCsg(RelationSet csg);
+  void EnumerateCmpRec(RelationSet csg, RelationSet cmp, RelationSet excluded);
+  void EmitCsgCmp(RelationSet left, RelationSet right);
+
+  void EnumerateGreedy();
+
+  // The cheapest way to join the two plans in this order, nullptr if none
+  std::shared_ptr<JoinPlan> JoinPlans(std::shared_ptr<JoinPlan> left,
+                                      std::shared_ptr<JoinPlan> right);
+
+  std::shared_ptr<OperatorExpression> BuildOperatorTree(
+      const JoinPlan &plan, std::vector<JoinColumn> &layout) const;
+
+  std::vector<Relation> relations_;
+
+  std::vector<Conjunct> conjuncts_;
+
+  std::vector<std::unique_ptr<expression::AbstractExpression>> predicates_;
+
+  // Pairs of relations joined by a predicate
+  std::vector<RelationSet> neighbors_;
+
+  std::unordered_map<RelationSet, std::shared_ptr<JoinPlan>> best_plans_;
+
+  std::unordered_map<RelationSet, double> cardinalities_;
+
+  std::vector<JoinColumn> output_layout_;
+};
+
+}  // namespace optimizer
+}  // namespace peloton
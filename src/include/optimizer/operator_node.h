@@ -50,6 +50,7 @@ enum class OpType {
   LeftHashJoin,
   RightHashJoin,
   OuterHashJoin,
+  InnerMergeJoin,
 };
 
 //===--------------------------------------------------------------------===//
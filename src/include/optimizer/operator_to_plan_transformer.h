@@ -13,6 +13,7 @@
 #pragma once
 
 #include "optimizer/operator_visitor.h"
+#include "type/types.h"
 
 namespace peloton {
 
@@ -38,6 +39,12 @@ class OperatorToPlanTransformer : public OperatorVisitor {
       std::shared_ptr<OperatorExpression> plan, PropertySet *requirements,
       std::vector<PropertySet> *required_input_props);
 
+  // Converts a whole tree of physical operators whose predicates are bound
+  // to the outputs of their children, as built by the JoinEnumerator. The
+  // joins output the columns of the left child followed by the right child.
+  std::unique_ptr<planner::AbstractPlan> ConvertOpExpressionTree(
+      std::shared_ptr<OperatorExpression> plan);
+
   void Visit(const PhysicalScan *op) override;
 
   void Visit(const PhysicalProject *) override;
@@ -60,11 +67,28 @@ class OperatorToPlanTransformer : public OperatorVisitor {
 
   void Visit(const PhysicalOuterHashJoin *) override;
 
+  void Visit(const PhysicalInnerMergeJoin *) override;
+
  private:
   void VisitOpExpression(std::shared_ptr<OperatorExpression> op);
 
+  // Probes the index of the scan that is the right child of an index nested
+  // loop join
+  std::unique_ptr<planner::AbstractPlan> CreateIndexLookupPlan(
+      const PhysicalInnerNLJoin *op, std::vector<oid_t> &left_keys,
+      std::vector<oid_t> &right_keys);
+
   std::unique_ptr<planner::AbstractPlan> output_plan_;
 
+  // The types of the columns output_plan_ outputs, when converting a tree
+  std::vector<type::Type::TypeId> output_types_;
+
+  // The operator being converted and the plans of its children, when
+  // converting a tree
+  std::shared_ptr<OperatorExpression> current_op_;
+  std::vector<std::unique_ptr<planner::AbstractPlan>> children_plans_;
+  std::vector<std::vector<type::Type::TypeId>> children_types_;
+
   PropertySet *requirements_;
   std::vector<PropertySet> *required_input_props_;
 };
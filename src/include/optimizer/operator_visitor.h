@@ -36,6 +36,7 @@ class OperatorVisitor {
   virtual void Visit(const PhysicalLeftHashJoin *) = 0;
   virtual void Visit(const PhysicalRightHashJoin *) = 0;
   virtual void Visit(const PhysicalOuterHashJoin *) = 0;
+  virtual void Visit(const PhysicalInnerMergeJoin *) = 0;
 };
 
 } /* namespace optimizer */
@@ -18,6 +18,7 @@
 #include "optimizer/operator_node.h"
 #include "optimizer/util.h"
 
+#include <memory>
 #include <vector>
 
 namespace peloton {
@@ -117,13 +118,22 @@ class LogicalLimit : public OperatorNode<LogicalLimit> {
 //===--------------------------------------------------------------------===//
 class PhysicalScan : public OperatorNode<PhysicalScan> {
  public:
-  static Operator make(storage::DataTable *table);
+  static Operator make(
+      storage::DataTable *table,
+      std::shared_ptr<expression::AbstractExpression> predicate = nullptr,
+      std::vector<oid_t> column_ids = {});
 
   bool operator==(const BaseOperatorNode &r) override;
 
   hash_t Hash() const override;
 
   storage::DataTable *table_;
+
+  // Filter over the columns of the table, nullptr if there is none
+  std::shared_ptr<expression::AbstractExpression> predicate_;
+
+  // Columns of the table in the output
+  std::vector<oid_t> column_ids_;
 };
 
 //===--------------------------------------------------------------------===//
@@ -147,7 +157,22 @@ class PhysicalFilter : public OperatorNode<PhysicalFilter> {
 //===--------------------------------------------------------------------===//
 class PhysicalInnerNLJoin : public OperatorNode<PhysicalInnerNLJoin> {
  public:
-  static Operator make();
+  static Operator make(
+      std::shared_ptr<expression::AbstractExpression> join_predicate = nullptr,
+      std::vector<oid_t> left_keys = {}, std::vector<oid_t> right_keys = {},
+      bool index_lookup = false);
+
+  // Predicate over the pair of left and right tuples, nullptr if there is
+  // none
+  std::shared_ptr<expression::AbstractExpression> join_predicate_;
+
+  // Positions of the equi-join keys in the outputs of the children
+  std::vector<oid_t> left_keys_;
+  std::vector<oid_t> right_keys_;
+
+  // The right child is a scan that is probed through an index on the right
+  // keys for every distinct left key instead of being scanned again
+  bool index_lookup_ = false;
 };
 
 //===--------------------------------------------------------------------===//
@@ -179,7 +204,31 @@ class PhysicalOuterNLJoin : public OperatorNode<PhysicalOuterNLJoin> {
 //===--------------------------------------------------------------------===//
 class PhysicalInnerHashJoin : public OperatorNode<PhysicalInnerHashJoin> {
  public:
-  static Operator make();
+  static Operator make(
+      std::shared_ptr<expression::AbstractExpression> join_predicate = nullptr,
+      std::vector<oid_t> left_keys = {}, std::vector<oid_t> right_keys = {});
+
+  std::shared_ptr<expression::AbstractExpression> join_predicate_;
+
+  std::vector<oid_t> left_keys_;
+  std::vector<oid_t> right_keys_;
+};
+
+//===--------------------------------------------------------------------===//
+// InnerMergeJoin
+//
+// The children are sorted on their keys before they are merged
+//===--------------------------------------------------------------------===//
+class PhysicalInnerMergeJoin : public OperatorNode<PhysicalInnerMergeJoin> {
+ public:
+  static Operator make(
+      std::shared_ptr<expression::AbstractExpression> join_predicate,
+      std::vector<oid_t> left_keys, std::vector<oid_t> right_keys);
+
+  std::shared_ptr<expression::AbstractExpression> join_predicate_;
+
+  std::vector<oid_t> left_keys_;
+  std::vector<oid_t> right_keys_;
 };
 
 //===--------------------------------------------------------------------===//
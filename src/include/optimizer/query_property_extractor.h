@@ -49,6 +49,7 @@ class QueryPropertyExtractor : public QueryNodeVisitor {
   void Visit(const parser::TransactionStatement *) override;
   void Visit(const parser::UpdateStatement *) override;
   void Visit(const parser::CopyStatement *) override;
+  void Visit(const parser::AnalyzeStatement *) override;
 
  private:
   ColumnManager &manager_;
@@ -42,6 +42,7 @@ class AbstractExpression;
 
 namespace planner {
 class AbstractScan;
+class IndexScanPlan;
 }
 
 namespace optimizer {
@@ -63,6 +64,11 @@ class SimpleOptimizer : public AbstractOptimizer {
   std::shared_ptr<planner::AbstractPlan> BuildPelotonPlanTree(
       const std::unique_ptr<parser::SQLStatementList> &parse_tree) override;
 
+  // create a scan plan for a select statement
+  static std::unique_ptr<planner::AbstractScan> CreateScanPlan(
+      storage::DataTable *target_table, std::vector<oid_t> &column_ids,
+      expression::AbstractExpression *predicate, bool for_update);
+
  private:
   //===--------------------------------------------------------------------===//
   // UTILITIES
@@ -83,10 +89,9 @@ class SimpleOptimizer : public AbstractOptimizer {
                                    std::vector<type::Value> &values,
                                    oid_t &index_id);
 
-  // create a scan plan for a select statement
-  static std::unique_ptr<planner::AbstractScan> CreateScanPlan(
-      storage::DataTable *target_table, std::vector<oid_t> &column_ids,
-      expression::AbstractExpression *predicate, bool for_update);
+  // Marks an index scan that is an equality on every primary key column,
+  // so that the executor can do a single key lookup
+  static void SetPointLookupFlag(planner::IndexScanPlan *index_scan_plan);
 
   // create a copy plan for a copy statement
   static std::unique_ptr<planner::AbstractPlan> CreateCopyPlan(
@@ -94,9 +99,15 @@ class SimpleOptimizer : public AbstractOptimizer {
 
   static std::unique_ptr<planner::AbstractPlan> CreateHackingNestedLoopJoinPlan(
       const parser::SelectStatement *statement);
+
+  // create a plan for inner joins and cross products of any number of tables
   static std::unique_ptr<planner::AbstractPlan> CreateJoinPlan(
       parser::SelectStatement *select_stmt);
 
+  // create a hash join plan for an outer join of two tables
+  static std::unique_ptr<planner::AbstractPlan> CreateOuterJoinPlan(
+      parser::SelectStatement *select_stmt);
+
   // This is used for order_by + limit optimization. Let the index scan executor
   // know order_by flags when create an order_by
   // plan. This is used when we create a order_by plan and the underlying
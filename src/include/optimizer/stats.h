@@ -12,20 +12,122 @@
 
 #pragma once
 
-#include "optimizer/tuple_sample.h"
+#include <memory>
+#include <vector>
+
+#include "type/types.h"
+#include "type/value.h"
 
 namespace peloton {
 namespace optimizer {
 
+//===--------------------------------------------------------------------===//
+// ColumnStats
+//
+// The distribution of the values of a column. Frequencies are fractions of
+// all rows of the table, NULLs included.
+//===--------------------------------------------------------------------===//
+class ColumnStats {
+ public:
+  ColumnStats(oid_t column_id, type::Type::TypeId type)
+      : column_id(column_id), type(type) {}
+
+  // Derives the most common values and the histogram from a sample of the
+  // non-NULL values of the column. The counts come from the full table.
+  void Build(std::vector<type::Value> &sample_values, size_t num_rows,
+             size_t null_count, double num_distinct);
+
+  // Fraction of the rows equal to the value
+  double EstimateEqualSelectivity(const type::Value &value) const;
+
+  // Fraction of the rows less than the value, or less or equal
+  double EstimateLessThanSelectivity(const type::Value &value,
+                                     bool or_equal) const;
+
+  // Fraction of the rows the comparison with the constant holds for. NULLs
+  // never qualify.
+  double EstimateSelectivity(ExpressionType compare_type,
+                             const type::Value &value) const;
+
+  // Fraction of the non-NULL rows not covered by the most common values
+  double GetHistogramFraction() const;
+
+  const std::string GetInfo() const;
+
+  oid_t column_id;
+
+  type::Type::TypeId type;
+
+  size_t num_rows = 0;
+
+  double null_fraction = 0;
+
+  double num_distinct = 0;
+
+  std::vector<type::Value> most_common_values;
+
+  std::vector<double> most_common_frequencies;
+
+  // Equi-depth histogram over the values that are not among the most common
+  // ones: every bucket between two bounds holds the same number of rows
+  std::vector<type::Value> histogram_bounds;
+
+  static const size_t max_most_common_values = 100;
+
+  static const size_t max_histogram_buckets = 100;
+};
+
+//===--------------------------------------------------------------------===//
+// TableStats
+//===--------------------------------------------------------------------===//
+class TableStats {
+ public:
+  TableStats(oid_t database_id, oid_t table_id)
+      : database_id(database_id), table_id(table_id) {}
+
+  // nullptr if the column was not analyzed
+  const ColumnStats *GetColumnStats(oid_t column_id) const;
+
+  oid_t database_id;
+
+  oid_t table_id;
+
+  size_t num_rows = 0;
+
+  // The modification count of the table when it was analyzed
+  size_t modification_count = 0;
+
+  std::vector<std::unique_ptr<ColumnStats>> column_stats;
+};
+
 //===--------------------------------------------------------------------===//
 // Stats
+//
+// What the optimizer knows about the output of a group expression
 //===--------------------------------------------------------------------===//
 class Stats {
  public:
-  Stats(TupleSample *sample) : sample_(sample){};
+  Stats(std::shared_ptr<const TableStats> table_stats)
+      : table_stats_(table_stats) {
+    if (table_stats != nullptr) {
+      cardinality_ = table_stats->num_rows;
+    }
+  };
+
+  inline double GetCardinality() const { return cardinality_; }
+
+  inline void SetCardinality(double cardinality) {
+    cardinality_ = cardinality;
+  }
+
+  // Statistics of the base table, nullptr if there are none
+  inline const TableStats *GetTableStats() const { return table_stats_.get(); }
 
  private:
-  TupleSample *sample_;
+  std::shared_ptr<const TableStats> table_stats_;
+
+  // Estimated number of output rows
+  double cardinality_ = 0;
 };
 
 } /* namespace optimizer */
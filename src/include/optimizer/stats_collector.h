@@ -0,0 +1,90 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// stats_collector.h
+//
+// Identification: src/include/optimizer/stats_collector.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "optimizer/hyperloglog.h"
+#include "optimizer/stats.h"
+#include "optimizer/tuple_sample.h"
+
+namespace peloton {
+
+namespace concurrency {
+class Transaction;
+}
+
+namespace storage {
+class DataTable;
+}
+
+namespace optimizer {
+
+//===--------------------------------------------------------------------===//
+// StatsCollector
+//
+// Computes the statistics of a table with one scan. The tile groups are
+// split into ranges scanned in parallel. Every thread counts rows and NULLs,
+// feeds a distinct value sketch per column and keeps a reservoir sample of
+// the rows, the partial results are merged at the end.
+//===--------------------------------------------------------------------===//
+class StatsCollector {
+ public:
+  StatsCollector(const StatsCollector &) = delete;
+  StatsCollector &operator=(const StatsCollector &) = delete;
+
+  StatsCollector(storage::DataTable *table);
+
+  // Statistics over the rows visible to the transaction. The rows are not
+  // registered as reads, so collecting never conflicts with writers.
+  std::shared_ptr<TableStats> Collect(concurrency::Transaction *txn);
+
+  // Set the number of threads scanning a table
+  static void SetThreadCount(size_t thread_count);
+
+  // Set the number of rows sampled per table
+  static void SetSampleSize(size_t sample_size);
+
+  static const size_t default_sample_size = 30000;
+
+ private:
+  // What one scan thread gathered
+  struct PartialStats {
+    PartialStats(size_t column_count, size_t sample_size, uint64_t seed)
+        : sample(sample_size, seed),
+          sketches(column_count),
+          null_counts(column_count, 0) {}
+
+    size_t row_count = 0;
+
+    TupleSample sample;
+
+    std::vector<HyperLogLog> sketches;
+
+    std::vector<size_t> null_counts;
+  };
+
+  // Scan the tile groups in [begin, end), runs on a scan thread
+  void ScanTileGroups(concurrency::Transaction *txn, size_t begin, size_t end,
+                      PartialStats *partial_stats);
+
+  storage::DataTable *table_;
+
+  static size_t thread_count_;
+
+  static size_t sample_size_;
+};
+
+}  // End optimizer namespace
+}  // End peloton namespace
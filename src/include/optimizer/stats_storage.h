@@ -0,0 +1,88 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// stats_storage.h
+//
+// Identification: src/include/optimizer/stats_storage.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "optimizer/stats.h"
+#include "type/abstract_pool.h"
+
+namespace peloton {
+
+namespace concurrency {
+class Transaction;
+}
+
+namespace storage {
+class DataTable;
+}
+
+namespace optimizer {
+
+//===--------------------------------------------------------------------===//
+// StatsStorage
+//
+// The statistics of all analyzed tables. The optimizer reads them from
+// memory, every analyze also writes a row per column to the column_stats
+// table of the catalog database, where they can be queried with SQL.
+// Lists of values are written as {v1,v2,...}, values holding a separator,
+// a quote or a backslash are quoted and escaped.
+//===--------------------------------------------------------------------===//
+class StatsStorage {
+ public:
+  StatsStorage(const StatsStorage &) = delete;
+  StatsStorage &operator=(const StatsStorage &) = delete;
+
+  // Global Singleton
+  static StatsStorage &GetInstance();
+
+  // Collect the statistics of the table and store them
+  std::shared_ptr<const TableStats> AnalyzeTable(
+      storage::DataTable *table, concurrency::Transaction *txn);
+
+  // Analyze the user tables that were never analyzed or whose statistics are
+  // stale, returns how many tables were analyzed
+  size_t AnalyzeStaleTables(concurrency::Transaction *txn);
+
+  // nullptr if the table was never analyzed
+  std::shared_ptr<const TableStats> GetTableStats(oid_t table_id);
+
+  // Whether the table changed enough since it was last analyzed that the
+  // statistics should be refreshed
+  bool IsStale(storage::DataTable *table);
+
+  // Statistics are stale after this many modifications, or after a fraction
+  // of the rows changed if that is more
+  static const size_t stale_min_modifications = 50;
+
+  static constexpr double stale_modification_fraction = 0.1;
+
+ private:
+  StatsStorage();
+
+  // Replace the rows of the table in the column statistics catalog
+  void StoreTableStats(const TableStats &table_stats,
+                       concurrency::Transaction *txn);
+
+  std::mutex stats_mutex_;
+
+  std::unordered_map<oid_t, std::shared_ptr<const TableStats>> table_stats_;
+
+  // Holds the lists written to the catalog
+  std::unique_ptr<type::AbstractPool> pool_;
+};
+
+}  // End optimizer namespace
+}  // End peloton namespace
@@ -13,26 +13,61 @@
 
 #pragma once
 
-#include "optimizer/column.h"
-#include "storage/tile_group.h"
-#include "optimizer/util.h"
-
+#include <random>
 #include <vector>
 
+#include "type/value.h"
+
 namespace peloton {
 namespace optimizer {
 
 //===--------------------------------------------------------------------===//
 // TupleSample
+//
+// A uniform sample of at most capacity rows out of all rows offered to it,
+// kept with reservoir sampling. The values of a row are owned by the sample.
 //===--------------------------------------------------------------------===//
 class TupleSample {
  public:
-  TupleSample(std::vector<Column *> columns,
-              storage::TileGroup *sampled_tuples);
+  typedef std::vector<type::Value> Row;
+
+  TupleSample(size_t capacity, uint64_t seed = 0);
+
+  // Offers the next row. Returns the slot the row has to be stored in with
+  // SetRow(), or -1 if the row is not sampled and needs not be materialized.
+  int64_t Offer();
+
+  void SetRow(int64_t slot, Row &&row);
+
+  // Afterwards this is a sample of the rows offered to both samples
+  void Merge(TupleSample &other);
+
+  inline const std::vector<Row> &GetRows() const { return rows_; }
+
+  inline size_t GetCapacity() const { return capacity_; }
+
+  // Number of rows offered, the population the sample was drawn from
+  inline size_t GetSeenCount() const { return seen_count_; }
 
  private:
-  std::vector<Column *> columns;
-  storage::TileGroup *sampled_tuples;
+  double NextUniform();
+
+  void ComputeNextSampled();
+
+  void DrawGap();
+
+  size_t capacity_;
+
+  size_t seen_count_ = 0;
+
+  // Once the sample is full: the acceptance threshold and the number of the
+  // next row that replaces a sampled one
+  double weight_ = 1.0;
+  size_t next_sampled_ = 0;
+
+  std::vector<Row> rows_;
+
+  std::mt19937_64 random_;
 };
 
 } /* namespace optimizer */
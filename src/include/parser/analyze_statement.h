@@ -0,0 +1,39 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// analyze_statement.h
+//
+// Identification: src/include/parser/analyze_statement.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "parser/sql_statement.h"
+#include "optimizer/query_node_visitor.h"
+
+namespace peloton {
+namespace parser {
+
+/**
+ * @struct AnalyzeStatement
+ * @brief Represents "ANALYZE [table]". Without a table every table whose
+ * statistics are missing or stale is analyzed.
+ */
+struct AnalyzeStatement : TableRefStatement {
+  AnalyzeStatement() : TableRefStatement(StatementType::ANALYZE) {}
+
+  virtual ~AnalyzeStatement() {}
+
+  inline bool HasTable() const { return table_info_ != nullptr; }
+
+  virtual void Accept(optimizer::QueryNodeVisitor* v) const override {
+    v->Visit(this);
+  }
+};
+
+}  // End parser namespace
+}  // End peloton namespace
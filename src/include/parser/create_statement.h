@@ -23,7 +23,7 @@ namespace parser {
  * @struct ColumnDefinition
  * @brief Represents definition of a table column
  */
-struct ColumnDefinition {
+struct ColumnDefinition : ArenaAllocated {
   enum DataType {
     INVALID,
 
@@ -27,7 +27,7 @@ namespace parser {
  */
 typedef enum { kOrderAsc, kOrderDesc } OrderType;
 
-struct OrderDescription {
+struct OrderDescription : ArenaAllocated {
   OrderDescription(OrderType type, expression::AbstractExpression* expr)
       : type(type), expr(expr) {}
 
@@ -45,7 +45,7 @@ struct OrderDescription {
  */
 const int64_t kNoLimit = -1;
 const int64_t kNoOffset = -1;
-struct LimitDescription {
+struct LimitDescription : ArenaAllocated {
   LimitDescription(int64_t limit, int64_t offset)
       : limit(limit), offset(offset) {}
 
@@ -58,7 +58,7 @@ struct LimitDescription {
 /**
  * @struct GroupByDescription
  */
-struct GroupByDescription {
+struct GroupByDescription : ArenaAllocated {
   GroupByDescription() : columns(NULL), having(NULL) {}
 
   ~GroupByDescription() {
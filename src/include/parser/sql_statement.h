@@ -18,8 +18,10 @@
 #pragma once
 
 #include <iostream>
+#include <memory>
 #include <vector>
 
+#include "common/arena.h"
 #include "common/macros.h"
 #include "common/printable.h"
 #include "type/types.h"
@@ -32,7 +34,7 @@ class QueryNodeVisitor;
 
 namespace parser {
 
-struct TableInfo {
+struct TableInfo : ArenaAllocated {
   ~TableInfo() {
     delete[] table_name;
     delete[] database_name;
@@ -43,7 +45,7 @@ struct TableInfo {
 };
 
 // Base class for every SQLStatement
-class SQLStatement : public Printable {
+class SQLStatement : public Printable, public ArenaAllocated {
  public:
   SQLStatement(StatementType type) : stmt_type(type){};
 
@@ -116,6 +118,9 @@ class SQLStatementList : public Printable {
   const char* parser_msg;
   int error_line;
   int error_col;
+
+  // The nodes of the parse tree, released once the statements are deleted
+  std::unique_ptr<Arena> arena;
 };
 
 }  // End parser namespace
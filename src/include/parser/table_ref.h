@@ -28,7 +28,7 @@ struct JoinDefinition;
 
 //  Holds reference to tables.
 // Can be either table names or a select statement.
-struct TableRef {
+struct TableRef : ArenaAllocated {
   TableRef(TableReferenceType type)
       : type(type),
         schema(NULL),
@@ -74,7 +74,7 @@ struct TableRef {
 };
 
 // Definition of a join table
-struct JoinDefinition {
+struct JoinDefinition : ArenaAllocated {
   JoinDefinition()
       : left(NULL), right(NULL), condition(NULL), type(JoinType::INNER) {}
 
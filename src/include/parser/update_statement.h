@@ -24,7 +24,7 @@ namespace parser {
  * @struct UpdateClause
  * @brief Represents "column = value" expressions
  */
-class UpdateClause {
+class UpdateClause : public ArenaAllocated {
  public:
   char* column;
   expression::AbstractExpression* value;
@@ -0,0 +1,49 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// analyze_plan.h
+//
+// Identification: src/include/planner/analyze_plan.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "planner/abstract_plan.h"
+
+namespace peloton {
+namespace storage {
+class DataTable;
+}
+
+namespace planner {
+class AnalyzePlan : public AbstractPlan {
+ public:
+  AnalyzePlan(const AnalyzePlan &) = delete;
+  AnalyzePlan &operator=(const AnalyzePlan &) = delete;
+  AnalyzePlan(AnalyzePlan &&) = delete;
+  AnalyzePlan &operator=(AnalyzePlan &&) = delete;
+
+  // Without a target table the tables with stale statistics are analyzed
+  explicit AnalyzePlan(storage::DataTable *target_table = nullptr)
+      : target_table_(target_table) {}
+
+  inline PlanNodeType GetPlanNodeType() const { return PlanNodeType::ANALYZE; }
+
+  const std::string GetInfo() const { return "AnalyzePlan"; }
+
+  std::unique_ptr<AbstractPlan> Copy() const {
+    return std::unique_ptr<AbstractPlan>(new AnalyzePlan(target_table_));
+  }
+
+  inline storage::DataTable *GetTargetTable() const { return target_table_; }
+
+ private:
+  storage::DataTable *target_table_;
+};
+
+}  // namespace planner
+}  // namespace peloton
@@ -40,6 +40,16 @@ class CopyPlan : public AbstractPlan {
     LOG_DEBUG("Creating a Copy Plan");
   }
 
+  // Copies between the target table and the file without a child plan
+  CopyPlan(char *file_path, storage::DataTable *target_table,
+           CopyType copy_type, char delimiter)
+      : copy_type(copy_type),
+        file_path(file_path),
+        target_table(target_table),
+        delimiter(delimiter) {
+    LOG_DEBUG("Creating a Copy Plan for a table");
+  }
+
   inline PlanNodeType GetPlanNodeType() const { return PlanNodeType::COPY; }
 
   const std::string GetInfo() const { return "CopyPlan"; }
@@ -47,11 +57,28 @@ class CopyPlan : public AbstractPlan {
   // TODO: Implement copy mechanism
   std::unique_ptr<AbstractPlan> Copy() const { return nullptr; }
 
+  inline bool IsImport() const {
+    return copy_type == CopyType::IMPORT_CSV ||
+           copy_type == CopyType::IMPORT_TSV;
+  }
+
+  // Whether rows are exported or imported
+  CopyType copy_type = CopyType::EXPORT_OTHER;
+
   // The path of the target file
   std::string file_path;
 
   // Whether the copying requires deserialization of parameters
   bool deserialize_parameters = false;
+
+  // The table an import loads into, or an export without a child reads
+  storage::DataTable *target_table = nullptr;
+
+  // Field delimiter of the file
+  char delimiter = ',';
+
+  // Whether an import fills the indexes in bulk after loading the rows
+  bool defer_index_build = true;
 };
 
 }  // namespace planner
@@ -154,6 +154,8 @@ class IndexScanPlan : public AbstractScan {
 
   inline bool GetDescend() const { return descend_; }
 
+  inline bool IsPointLookup() const { return point_lookup_; }
+
   const std::string GetInfo() const { return "IndexScan"; }
 
   void SetLimit(bool limit) { limit_ = limit; }
@@ -164,6 +166,8 @@ class IndexScanPlan : public AbstractScan {
 
   void SetDescend(bool descend) { descend_ = descend; }
 
+  void SetPointLookup(bool point_lookup) { point_lookup_ = point_lookup; }
+
   void SetParameterValues(std::vector<type::Value> *values);
 
   std::unique_ptr<AbstractPlan> Copy() const {
@@ -176,6 +180,7 @@ class IndexScanPlan : public AbstractScan {
                        new_runtime_keys);
     IndexScanPlan *new_plan = new IndexScanPlan(
         GetTable(), GetPredicate()->Copy(), GetColumnIds(), desc, false);
+    new_plan->SetPointLookup(point_lookup_);
     return std::unique_ptr<AbstractPlan>(new_plan);
   }
 
@@ -232,6 +237,10 @@ class IndexScanPlan : public AbstractScan {
 
   // whether order by is descending
   bool descend_ = false;
+
+  // whether the scan is an equality on all columns of the primary key,
+  // i.e. it reads at most one tuple
+  bool point_lookup_ = false;
 };
 
 }  // namespace planner
@@ -53,10 +53,11 @@ class MergeJoinPlan : public AbstractJoinPlan {
       std::unique_ptr<const expression::AbstractExpression> &&predicate,
       std::unique_ptr<const ProjectInfo> &&proj_info,
       std::shared_ptr<const catalog::Schema> &proj_schema,
-      std::vector<JoinClause> &join_clauses)
+      std::vector<JoinClause> &join_clauses, bool sort_inputs = false)
       : AbstractJoinPlan(join_type, std::move(predicate), std::move(proj_info),
                          proj_schema),
-        join_clauses_(std::move(join_clauses)) {
+        join_clauses_(std::move(join_clauses)),
+        sort_inputs_(sort_inputs) {
     // Nothing to see here...
   }
 
@@ -68,6 +69,10 @@ class MergeJoinPlan : public AbstractJoinPlan {
     return &join_clauses_;
   }
 
+  // Whether the executor partitions and sorts the inputs itself instead of
+  // expecting them sorted on the join keys
+  bool GetSortInputs() const { return sort_inputs_; }
+
   const std::string GetInfo() const { return "MergeJoin"; }
 
   std::unique_ptr<AbstractPlan> Copy() const {
@@ -84,12 +89,15 @@ class MergeJoinPlan : public AbstractJoinPlan {
         catalog::Schema::CopySchema(GetSchema()));
     MergeJoinPlan *new_plan = new MergeJoinPlan(
         GetJoinType(), std::move(predicate_copy),
-        std::move(GetProjInfo()->Copy()), schema_copy, new_join_clauses);
+        std::move(GetProjInfo()->Copy()), schema_copy, new_join_clauses,
+        sort_inputs_);
     return std::unique_ptr<AbstractPlan>(new_plan);
   }
 
  private:
   std::vector<JoinClause> join_clauses_;
+
+  bool sort_inputs_;
 };
 
 }  // namespace planner
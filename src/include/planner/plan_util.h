@@ -57,6 +57,30 @@ class PlanUtil {
     }
   }
 
+ public:
+  /**
+   * @brief Get the plan tree as printed by EXPLAIN
+   * @param The plan tree
+   * @return One line per plan node, indented by depth
+   */
+  static std::string GetExplainInfo(const planner::AbstractPlan *plan) {
+    std::ostringstream os;
+    if (plan != nullptr) {
+      GetExplainInfo(plan, os, 0);
+    }
+    return (os.str());
+  }
+
+ private:
+  static void GetExplainInfo(const planner::AbstractPlan *plan,
+                             std::ostringstream &os, int depth) {
+    os << std::string(depth * 2, ' ') << "-> "
+       << PlanNodeTypeToString(plan->GetPlanNodeType()) << std::endl;
+    for (auto &child : plan->GetChildren()) {
+      GetExplainInfo(child.get(), os, depth + 1);
+    }
+  }
+
  public:
   /**
    * @brief Get the tables referenced in the plan
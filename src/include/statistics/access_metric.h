@@ -12,7 +12,7 @@
 
 #pragma once
 
-#include <vector>
+#include <array>
 
 #include "type/types.h"
 #include "statistics/abstract_metric.h"
@@ -129,22 +129,22 @@ class AccessMetric : public AbstractMetric {
   // MEMBERS
   //===--------------------------------------------------------------------===//
 
-  // Vector containing all access types
-  std::vector<CounterMetric> access_counters_{
-      CounterMetric(COUNTER_METRIC),  // READ_COUNTER
-      CounterMetric(COUNTER_METRIC),  // UPDATE_COUNTER
-      CounterMetric(COUNTER_METRIC),  // INSERT_COUNTER
-      CounterMetric(COUNTER_METRIC)   // DELETE_COUNTER
-  };
-
   // The different types of accesses. These also
   // serve as indexes into the access_counters_
-  // vector.
+  // array.
   static const size_t READ_COUNTER = 0;
   static const size_t UPDATE_COUNTER = 1;
   static const size_t INSERT_COUNTER = 2;
   static const size_t DELETE_COUNTER = 3;
   static const size_t NUM_COUNTERS = 4;
+
+  // Inline array containing all access types (no heap allocation)
+  std::array<CounterMetric, NUM_COUNTERS> access_counters_{{
+      CounterMetric(COUNTER_METRIC),  // READ_COUNTER
+      CounterMetric(COUNTER_METRIC),  // UPDATE_COUNTER
+      CounterMetric(COUNTER_METRIC),  // INSERT_COUNTER
+      CounterMetric(COUNTER_METRIC)   // DELETE_COUNTER
+  }};
 };
 
 }  // namespace stats
@@ -18,6 +18,8 @@
 #include <unordered_map>
 
 #include "common/platform.h"
+#include "statistics/counter_metric.h"
+#include "statistics/latency_histogram.h"
 #include "statistics/table_metric.h"
 #include "statistics/index_metric.h"
 #include "statistics/latency_metric.h"
@@ -28,6 +30,10 @@
 
 #define QUERY_METRIC_QUEUE_SIZE 100000
 
+// Number of slots in the per-thread tile group -> table metric cache.
+// Must be a power of two.
+#define TABLE_METRIC_CACHE_SIZE 256
+
 namespace peloton {
 class Statement;
 }
@@ -40,7 +46,15 @@ class IndexMetadata;
 
 namespace stats {
 
-class CounterMetric;
+// Statement classes that get their own latency histogram
+enum QueryLatencyType {
+  QUERY_LATENCY_SELECT = 0,
+  QUERY_LATENCY_INSERT = 1,
+  QUERY_LATENCY_UPDATE = 2,
+  QUERY_LATENCY_DELETE = 3,
+  QUERY_LATENCY_OTHER = 4,
+  NUM_QUERY_LATENCY_TYPES = 5
+};
 
 /**
  * Context of backend stats as a singleton per thread
@@ -49,7 +63,7 @@ class BackendStatsContext {
  public:
   static BackendStatsContext* GetInstance();
 
-  BackendStatsContext(size_t max_latency_history, bool regiser_to_aggregator);
+  BackendStatsContext(bool regiser_to_aggregator);
   ~BackendStatsContext();
 
   //===--------------------------------------------------------------------===//
@@ -80,17 +94,69 @@ class BackendStatsContext {
   // Returns the latency metric
   LatencyMetric& GetTxnLatencyMetric();
 
+  // Returns the latency metric of logging a commit (including the wait for
+  // the flush under synchronous commit)
+  inline LatencyMetric& GetCommitLatencyMetric() { return commit_latencies_; }
+
+  // Returns the latency metric of log fsyncs issued by this thread
+  inline LatencyMetric& GetFsyncLatencyMetric() { return fsync_latencies_; }
+
+  // Returns the latency metric of GC passes run by this thread
+  inline LatencyMetric& GetGCPauseLatencyMetric() {
+    return gc_pause_latencies_;
+  }
+
+  // Returns the lengths of the version chains walked by this thread
+  inline LatencyHistogram& GetVersionChainLengths() {
+    return version_chain_lengths_;
+  }
+
+  // Returns the number of versions reclaimed by the GC threads
+  inline CounterMetric& GetBackgroundGCReclaimedMetric() {
+    return gc_background_reclaimed_;
+  }
+
+  // Returns the number of versions reclaimed inline by this worker
+  inline CounterMetric& GetInlineGCReclaimedMetric() {
+    return gc_inline_reclaimed_;
+  }
+
+  // Returns the latency metric of the given class of queries
+  inline LatencyMetric& GetQueryLatencyMetric(QueryLatencyType query_type) {
+    return query_latencies_[query_type];
+  }
+
   // Increment the read stat for given tile group
-  void IncrementTableReads(oid_t tile_group_id);
+  inline void IncrementTableReads(oid_t tile_group_id) {
+    GetTableAccessForTileGroup(tile_group_id).IncrementReads();
+    if (ongoing_query_metric_ != nullptr) {
+      ongoing_query_metric_->GetQueryAccess().IncrementReads();
+    }
+  }
 
   // Increment the insert stat for given tile group
-  void IncrementTableInserts(oid_t tile_group_id);
+  inline void IncrementTableInserts(oid_t tile_group_id) {
+    GetTableAccessForTileGroup(tile_group_id).IncrementInserts();
+    if (ongoing_query_metric_ != nullptr) {
+      ongoing_query_metric_->GetQueryAccess().IncrementInserts();
+    }
+  }
 
   // Increment the update stat for given tile group
-  void IncrementTableUpdates(oid_t tile_group_id);
+  inline void IncrementTableUpdates(oid_t tile_group_id) {
+    GetTableAccessForTileGroup(tile_group_id).IncrementUpdates();
+    if (ongoing_query_metric_ != nullptr) {
+      ongoing_query_metric_->GetQueryAccess().IncrementUpdates();
+    }
+  }
 
   // Increment the delete stat for given tile group
-  void IncrementTableDeletes(oid_t tile_group_id);
+  inline void IncrementTableDeletes(oid_t tile_group_id) {
+    GetTableAccessForTileGroup(tile_group_id).IncrementDeletes();
+    if (ongoing_query_metric_ != nullptr) {
+      ongoing_query_metric_->GetQueryAccess().IncrementDeletes();
+    }
+  }
 
   // Increment the read stat for given index by read_count
   void IncrementIndexReads(size_t read_count, index::IndexMetadata* metadata);
@@ -156,6 +222,11 @@ class BackendStatsContext {
   // Index oid spin lock
   Spinlock index_id_lock;
 
+  // Protects the structure (not the counters) of database_metrics_ and
+  // table_metrics_. Only taken by the owning worker when it creates a new
+  // metric, and by the aggregator while it walks the maps.
+  Spinlock metric_map_lock_;
+
   // Metrics for completed queries
   LockFreeQueue<std::shared_ptr<QueryMetric>> completed_query_metrics_{
       QUERY_METRIC_QUEUE_SIZE};
@@ -165,6 +236,22 @@ class BackendStatsContext {
   // MEMBERS
   //===--------------------------------------------------------------------===//
 
+  // One slot of the direct-mapped tile group -> table metric cache
+  struct TableMetricSlot {
+    oid_t tile_group_id = INVALID_OID;
+    TableMetric *table_metric = nullptr;
+  };
+
+  // Keep the per-thread hot slots away from whatever the allocator placed
+  // next to this context
+  char cache_padding_front_[CACHELINE_SIZE];
+
+  // Caches the table metric of recently touched tile groups so that the
+  // per-tuple counters do not go through the catalog manager
+  TableMetricSlot table_metric_cache_[TABLE_METRIC_CACHE_SIZE];
+
+  char cache_padding_back_[CACHELINE_SIZE];
+
   // The query metric for the on going metric
   std::shared_ptr<QueryMetric> ongoing_query_metric_ = nullptr;
 
@@ -172,7 +259,31 @@ class BackendStatsContext {
   std::thread::id thread_id_;
 
   // Latencies recorded by this worker
-  LatencyMetric txn_latencies_;
+  LatencyMetric txn_latencies_{LATENCY_METRIC, "TXN"};
+
+  LatencyMetric commit_latencies_{LATENCY_METRIC, "COMMIT"};
+
+  LatencyMetric fsync_latencies_{LATENCY_METRIC, "LOG FSYNC"};
+
+  LatencyMetric gc_pause_latencies_{LATENCY_METRIC, "GC PAUSE"};
+
+  LatencyMetric query_latencies_[NUM_QUERY_LATENCY_TYPES]{
+      {LATENCY_METRIC, "SELECT"},
+      {LATENCY_METRIC, "INSERT"},
+      {LATENCY_METRIC, "UPDATE"},
+      {LATENCY_METRIC, "DELETE"},
+      {LATENCY_METRIC, "OTHER QUERY"}};
+
+  // Number of versions walked per version chain traversal
+  LatencyHistogram version_chain_lengths_;
+
+  // Versions reclaimed by the GC threads and by workers helping them
+  CounterMetric gc_background_reclaimed_{COUNTER_METRIC};
+
+  CounterMetric gc_inline_reclaimed_{COUNTER_METRIC};
+
+  // The class of the on going query
+  QueryLatencyType ongoing_query_type_ = QUERY_LATENCY_OTHER;
 
   // Whether this context is registered to the global aggregator
   bool is_registered_to_aggregator_;
@@ -187,6 +298,24 @@ class BackendStatsContext {
   // Mark the on going query as completed and move it to completed query queue
   void CompleteQueryMetric();
 
+  // Returns all latency metrics of this context
+  std::vector<LatencyMetric*> GetLatencyMetrics();
+
+  // Returns the access metric of the table owning the given tile group
+  inline AccessMetric &GetTableAccessForTileGroup(oid_t tile_group_id) {
+    auto &slot =
+        table_metric_cache_[tile_group_id & (TABLE_METRIC_CACHE_SIZE - 1)];
+    if (slot.tile_group_id != tile_group_id) {
+      slot.table_metric = LookupTableMetric(tile_group_id);
+      slot.tile_group_id = tile_group_id;
+    }
+    return slot.table_metric->GetTableAccess();
+  }
+
+  // Resolves the table metric of a tile group through the catalog manager.
+  // Only called on a cache miss.
+  TableMetric *LookupTableMetric(oid_t tile_group_id);
+
   // Get the mapping table of backend stat context for each thread
   static CuckooMap<std::thread::id, std::shared_ptr<BackendStatsContext>> &
     GetBackendContextMap(void);
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <string>
 #include <sstream>
 
@@ -23,33 +24,45 @@ namespace stats {
 
 /**
  * Metric as a counter. E.g. # txns committed, # tuples read, etc.
+ *
+ * A counter has a single writer (the worker thread owning the enclosing
+ * BackendStatsContext), so updates are plain relaxed load/store pairs
+ * instead of locked read-modify-write instructions. The aggregator may
+ * read the counter concurrently without taking any lock.
  */
 class CounterMetric : public AbstractMetric {
  public:
   CounterMetric(MetricType type);
 
+  CounterMetric(const CounterMetric &other);
+
   //===--------------------------------------------------------------------===//
   // ACCESSORS
   //===--------------------------------------------------------------------===//
 
-  inline void Increment() { count_++; }
+  inline void Increment() { Increment(1); }
 
-  inline void Increment(int64_t count) { count_ += count; }
+  inline void Increment(int64_t count) {
+    count_.store(count_.load(std::memory_order_relaxed) + count,
+                 std::memory_order_relaxed);
+  }
 
-  inline void Decrement() { count_--; }
+  inline void Decrement() { Increment(-1); }
 
-  inline void Decrement(int64_t count) { count_ -= count; }
+  inline void Decrement(int64_t count) { Increment(-count); }
 
   //===--------------------------------------------------------------------===//
   // HELPER METHODS
   //===--------------------------------------------------------------------===//
 
-  inline void Reset() { count_ = 0; }
+  inline void Reset() { count_.store(0, std::memory_order_relaxed); }
 
-  inline int64_t GetCounter() { return count_; }
+  inline int64_t GetCounter() const {
+    return count_.load(std::memory_order_relaxed);
+  }
 
   inline bool operator==(const CounterMetric &other) {
-    return count_ == other.count_;
+    return GetCounter() == other.GetCounter();
   }
 
   inline bool operator!=(const CounterMetric &other) {
@@ -62,7 +75,7 @@ class CounterMetric : public AbstractMetric {
   // Returns a string representation of this counter
   inline const std::string GetInfo() const {
     std::stringstream ss;
-    ss << count_;
+    ss << GetCounter();
     return ss.str();
   }
 
@@ -72,7 +85,7 @@ class CounterMetric : public AbstractMetric {
   //===--------------------------------------------------------------------===//
 
   // The current count
-  int64_t count_;
+  std::atomic<int64_t> count_;
 };
 
 }  // namespace stats
@@ -0,0 +1,162 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// latency_histogram.h
+//
+// Identification: src/include/statistics/latency_histogram.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace peloton {
+namespace stats {
+
+/**
+ * Log-linear (HDR-style) histogram of latency values in microseconds.
+ *
+ * Values below LINEAR_BUCKET_COUNT get one bucket each. Above that, every
+ * power of two is split into SUB_BUCKET_COUNT equally sized buckets, which
+ * bounds the relative error of any reported percentile by
+ * 1 / (2 * SUB_BUCKET_COUNT).
+ *
+ * A histogram has a single writer (its owning worker thread). Buckets are
+ * updated with relaxed load/store pairs, so recording never takes a lock or
+ * issues a locked instruction, and readers (the aggregator) may merge a
+ * live histogram at any time.
+ *
+ * Windows are obtained by subtracting an older snapshot of the same
+ * cumulative histogram from a newer one.
+ */
+class LatencyHistogram {
+ public:
+  // Number of sub-buckets per power of two (as a power of two)
+  static const int SUB_BUCKET_BITS = 4;
+  static const uint64_t SUB_BUCKET_COUNT = 1UL << SUB_BUCKET_BITS;
+
+  // Values below this are tracked exactly
+  static const uint64_t LINEAR_BUCKET_COUNT = SUB_BUCKET_COUNT << 1;
+
+  // Largest tracked exponent, 2^41 us is roughly 25 days. Larger values are
+  // clamped into the last bucket.
+  static const int MAX_EXPONENT = 40;
+
+  static const size_t BUCKET_COUNT =
+      LINEAR_BUCKET_COUNT +
+      (MAX_EXPONENT - SUB_BUCKET_BITS) * SUB_BUCKET_COUNT;
+
+  LatencyHistogram();
+
+  LatencyHistogram(const LatencyHistogram &other);
+
+  LatencyHistogram &operator=(const LatencyHistogram &other);
+
+  //===--------------------------------------------------------------------===//
+  // RECORDING
+  //===--------------------------------------------------------------------===//
+
+  // Records one value (in microseconds). Must only be called by the owner.
+  inline void Record(uint64_t value_us) {
+    Bump(buckets_[GetBucketIndex(value_us)], 1);
+    Bump(count_, 1);
+    Bump(sum_, value_us);
+    if (value_us > max_.load(std::memory_order_relaxed)) {
+      max_.store(value_us, std::memory_order_relaxed);
+    }
+  }
+
+  //===--------------------------------------------------------------------===//
+  // ACCESSORS
+  //===--------------------------------------------------------------------===//
+
+  inline uint64_t GetCount() const {
+    return count_.load(std::memory_order_relaxed);
+  }
+
+  inline uint64_t GetSum() const {
+    return sum_.load(std::memory_order_relaxed);
+  }
+
+  // Exact maximum for cumulative histograms. For windows produced by
+  // Subtract() this is the upper bound of the highest non-empty bucket.
+  inline uint64_t GetMax() const {
+    return max_.load(std::memory_order_relaxed);
+  }
+
+  // Returns the smallest recorded value (bucket precision)
+  uint64_t GetMin() const;
+
+  // Returns the mean value
+  double GetMean() const;
+
+  // Returns the value at the given percentile in [0, 100]
+  uint64_t GetPercentile(double percentile) const;
+
+  //===--------------------------------------------------------------------===//
+  // HELPER FUNCTIONS
+  //===--------------------------------------------------------------------===//
+
+  // Adds all values of the source histogram to this histogram
+  void Merge(const LatencyHistogram &source);
+
+  // Removes the values of an older snapshot of the same cumulative
+  // histogram, leaving only the values recorded in between
+  void Subtract(const LatencyHistogram &older);
+
+  // Drops all values
+  void Reset();
+
+  // Bucket index for a value
+  static inline size_t GetBucketIndex(uint64_t value) {
+    if (value < LINEAR_BUCKET_COUNT) {
+      return value;
+    }
+    int exponent = 63 - __builtin_clzll(value);
+    if (exponent > MAX_EXPONENT) {
+      return BUCKET_COUNT - 1;
+    }
+    int shift = exponent - SUB_BUCKET_BITS;
+    return LINEAR_BUCKET_COUNT +
+           (exponent - SUB_BUCKET_BITS - 1) * SUB_BUCKET_COUNT +
+           ((value >> shift) - SUB_BUCKET_COUNT);
+  }
+
+  // Smallest value mapped to a bucket
+  static uint64_t GetBucketLowerBound(size_t index);
+
+  // Largest value mapped to a bucket
+  static uint64_t GetBucketUpperBound(size_t index);
+
+ private:
+  // Single-writer increment
+  static inline void Bump(std::atomic<uint64_t> &counter, uint64_t delta) {
+    counter.store(counter.load(std::memory_order_relaxed) + delta,
+                  std::memory_order_relaxed);
+  }
+
+  //===--------------------------------------------------------------------===//
+  // MEMBERS
+  //===--------------------------------------------------------------------===//
+
+  std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets_;
+
+  // Number of recorded values
+  std::atomic<uint64_t> count_;
+
+  // Sum of recorded values
+  std::atomic<uint64_t> sum_;
+
+  // Largest recorded value
+  std::atomic<uint64_t> max_;
+};
+
+}  // namespace stats
+}  // namespace peloton
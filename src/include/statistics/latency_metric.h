@@ -12,22 +12,22 @@
 
 #pragma once
 
+#include <chrono>
 #include <string>
 #include <sstream>
 
-#include "common/timer.h"
 #include "common/macros.h"
 #include "type/types.h"
 #include "common/exception.h"
-#include "container/circular_buffer.h"
 #include "statistics/abstract_metric.h"
-#include <mutex>
+#include "statistics/latency_histogram.h"
 
 namespace peloton {
 namespace stats {
 
 // Container for different latency measurements
 struct LatencyMeasurements {
+  uint64_t count_ = 0;
   double average_ = 0.0;
   double min_ = 0.0;
   double max_ = 0.0;
@@ -35,85 +35,103 @@ struct LatencyMeasurements {
   double perc_25th_ = 0.0;
   double perc_75th_ = 0.0;
   double perc_99th_ = 0.0;
+  double perc_999th_ = 0.0;
 };
 
 /**
- * Metric for storing raw latency values and computing
- * latency measurements.
+ * Times a single operation. Used where only one latency value is needed
+ * (e.g. a single query) and a histogram would be wasted.
+ */
+class LatencyTimer {
+ public:
+  // Starts the timer for the next latency measurement
+  inline void StartTimer() { begin_ = std::chrono::steady_clock::now(); }
+
+  // Stops the timer and returns the time elapsed since StartTimer (ms)
+  inline double RecordLatency() {
+    latency_ = std::chrono::duration_cast<
+                   std::chrono::duration<double, std::milli>>(
+                   std::chrono::steady_clock::now() - begin_).count();
+    return latency_;
+  }
+
+  // Returns the last recorded latency (ms)
+  inline double GetLatency() const { return latency_; }
+
+ private:
+  std::chrono::steady_clock::time_point begin_;
+
+  double latency_ = 0.0;
+};
+
+/**
+ * Metric for recording latency values into a log-linear histogram and
+ * computing latency measurements (percentiles) from it.
  */
 class LatencyMetric : public AbstractMetric {
  public:
-  LatencyMetric(MetricType type, size_t max_history);
+  LatencyMetric(MetricType type, const std::string &name);
 
   //===--------------------------------------------------------------------===//
   // HELPER METHODS
   //===--------------------------------------------------------------------===//
 
   inline void Reset() {
-    latencies_.Clear();
-    timer_ms_.Reset();
+    histogram_.Reset();
+    latency_measurements_ = LatencyMeasurements();
   }
 
   // Starts the timer for the next latency measurement
-  inline void StartTimer() {
-    timer_ms_.Reset();
-    timer_ms_.Start();
-  }
+  inline void StartTimer() { timer_.StartTimer(); }
 
   // Stops the latency timer and records the total time elapsed
-  inline void RecordLatency() {
-    timer_ms_.Stop();
-    double latency_value = timer_ms_.GetDuration();
-    // Record this latency only if we can do so without blocking.
-    // Occasionally losing single latency measurements is fine.
-    {
-      std::unique_lock<std::mutex> lock(latency_mutex_, std::defer_lock);
-      if (lock.try_lock()) {
-        latencies_.PushBack(latency_value);
-      }
-    }
+  inline void RecordLatency() { RecordLatency(timer_.RecordLatency()); }
+
+  // Records a latency value (ms) measured elsewhere
+  inline void RecordLatency(double latency_ms) {
+    histogram_.Record((uint64_t)(latency_ms * 1000));
   }
 
-  // Returns the first latency value recorded
-  inline double GetFirstLatencyValue() {
-    PL_ASSERT(latencies_.begin() != latencies_.end());
-    return *(latencies_.begin());
+  // Returns the underlying histogram (latencies in microseconds)
+  inline const LatencyHistogram &GetHistogram() const { return histogram_; }
+
+  // Returns the result of the last call to ComputeLatencies()
+  inline const LatencyMeasurements &GetLatencyMeasurements() const {
+    return latency_measurements_;
   }
 
-  // Computes the latency measurements using the latencies
-  // collected so far.
+  // Computes the latency measurements over all latencies collected so far
   void ComputeLatencies();
 
+  // Computes the latency measurements of the latencies collected after the
+  // given (older) snapshot of this metric's histogram was taken
+  LatencyMeasurements ComputeWindow(const LatencyHistogram &older) const;
+
   // Combines the source latency metric with this latency metric
   void Aggregate(AbstractMetric &source);
 
   // Returns a string representation of this latency metric
   const std::string GetInfo() const;
 
-  // Returns a copy of the latencies collected
-  CircularBuffer<double> Copy();
+  // Converts a histogram to latency measurements (ms)
+  static LatencyMeasurements Measure(const LatencyHistogram &histogram);
 
  private:
   //===--------------------------------------------------------------------===//
   // MEMBERS
   //===--------------------------------------------------------------------===//
 
-  // Circular buffer with capacity N that stores the <= N
-  // most recent latencies collected
-  CircularBuffer<double> latencies_;
+  // What is being timed (e.g. TXN)
+  std::string name_;
+
+  // All latencies recorded so far
+  LatencyHistogram histogram_;
 
   // Timer for timing individual latencies
-  Timer<std::ratio<1, 1000>> timer_ms_;
+  LatencyTimer timer_;
 
   // Stores result of last call to ComputeLatencies()
   LatencyMeasurements latency_measurements_;
-
-  // The maximum number of latencies that can be stored
-  // (the capacity size N of the circular buffer)
-  size_t max_history_;
-
-  // Protects accesses to the circular buffer
-  std::mutex latency_mutex_;
 };
 
 }  // namespace stats
@@ -72,7 +72,7 @@ class QueryMetric : public AbstractMetric {
 
   inline AccessMetric &GetQueryAccess() { return query_access_; }
 
-  inline LatencyMetric &GetQueryLatency() { return latency_metric_; }
+  inline LatencyTimer &GetQueryLatency() { return latency_timer_; }
 
   inline ProcessorMetric &GetProcessorMetric() { return processor_metric_; }
 
@@ -84,6 +84,15 @@ class QueryMetric : public AbstractMetric {
     return query_params_;
   }
 
+  // Annotated executor tree of a profiled (EXPLAIN ANALYZE) execution
+  inline const std::string &GetExecutorProfile() const {
+    return executor_profile_;
+  }
+
+  inline void SetExecutorProfile(const std::string &executor_profile) {
+    executor_profile_ = executor_profile;
+  }
+
   //===--------------------------------------------------------------------===//
   // HELPER FUNCTIONS
   //===--------------------------------------------------------------------===//
@@ -98,6 +107,9 @@ class QueryMetric : public AbstractMetric {
     ss << "  QUERY " << query_name_ << std::endl;
     ss << "-----------------------------" << std::endl;
     ss << query_access_.GetInfo() << std::endl;
+    if (executor_profile_.empty() == false) {
+      ss << executor_profile_;
+    }
     return ss.str();
   }
 
@@ -118,11 +130,14 @@ class QueryMetric : public AbstractMetric {
   // The number of tuple accesses
   AccessMetric query_access_{ACCESS_METRIC};
 
-  // Latency metric
-  LatencyMetric latency_metric_{LATENCY_METRIC, 2};
+  // Latency of this query
+  LatencyTimer latency_timer_;
 
   // Processor metric
   ProcessorMetric processor_metric_{PROCESSOR_METRIC};
+
+  // Executor profile, empty unless the query was profiled
+  std::string executor_profile_;
 };
 
 }  // namespace stats
@@ -34,8 +34,7 @@
 
 #define STATS_AGGREGATION_INTERVAL_MS 1000
 #define STATS_LOG_INTERVALS 10
-#define LATENCY_MAX_HISTORY_THREAD 100
-#define LATENCY_MAX_HISTORY_AGGREGATOR 10000
+#define STATS_ANALYZE_INTERVALS 10
 
 class BackendStatsContext;
 
@@ -128,6 +127,10 @@ class StatsAggregator {
 
   int64_t total_prev_txn_committed_;
 
+  // Cumulative txn latencies as of the previous interval, used to compute
+  // the latencies of the current interval only
+  LatencyHistogram prev_txn_latencies_;
+
   // Stats aggregator background thread
   std::thread aggregator_thread_;
 
@@ -153,6 +156,9 @@ class StatsAggregator {
   // Write all metrics to metric tables
   void UpdateMetrics();
 
+  // Analyze the tables whose optimizer statistics are missing or stale
+  void RefreshTableStats();
+
   // Update the table metrics with a given database
   void UpdateTableMetrics(storage::Database *database, int64_t time_stamp,
                           concurrency::Transaction *txn);
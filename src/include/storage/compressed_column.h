@@ -0,0 +1,129 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// compressed_column.h
+//
+// Identification: src/include/storage/compressed_column.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "type/types.h"
+#include "type/value.h"
+
+namespace peloton {
+namespace storage {
+
+class Tile;
+
+// How the values of a compressed column are stored
+enum class ColumnEncodingType {
+  INVALID = 0,
+  DICTIONARY = 1,          // bit-packed codes into the sorted distinct values
+  FRAME_OF_REFERENCE = 2,  // bit-packed offsets from the smallest value
+  RUN_LENGTH = 3           // one code per run of equal values
+};
+
+//===--------------------------------------------------------------------===//
+// CompressedColumn
+//
+// An immutable, compressed copy of a column of a tile. Every value is
+// mapped to an integer code. Integer and timestamp columns are frame of
+// reference encoded, the code is the distance to the smallest value. All
+// other columns get a dictionary of their distinct values in ascending
+// order, the code is the position in the dictionary. In both cases the
+// order of the codes is the order of the values and the code after the
+// largest one stands for NULL.
+//
+// The codes are bit-packed with as few bits as the largest code needs.
+// Columns with long runs of equal values, typically low-cardinality ones,
+// store one code per run instead.
+//===--------------------------------------------------------------------===//
+class CompressedColumn {
+ public:
+  CompressedColumn(const CompressedColumn &) = delete;
+  CompressedColumn &operator=(const CompressedColumn &) = delete;
+
+  // Encodes the first tuple_count values of a column of an uncompressed tile
+  CompressedColumn(Tile *tile, const oid_t column_id, const oid_t tuple_count);
+
+  // Varlen values point into the column, like the ones of a tile point into
+  // its pool
+  type::Value GetValue(const oid_t tuple_offset) const;
+
+  // Evaluates "column <comparison> constant" on the codes and clears the
+  // matches of the values that do not satisfy it. Returns false without
+  // touching the matches if the comparison can not be evaluated on the
+  // codes.
+  bool Filter(const ExpressionType comparison, const type::Value &constant,
+              std::vector<bool> &matches) const;
+
+  ColumnEncodingType GetEncodingType() const;
+
+  type::Type::TypeId GetTypeId() const { return type_id_; }
+
+  // Bytes used by the encoded values
+  size_t GetSize() const;
+
+  // Runs are stored if there is at most one per this many values
+  static const size_t run_length_factor = 8;
+
+ private:
+  uint64_t GetCode(const oid_t tuple_offset) const;
+
+  uint64_t GetPackedCode(const size_t code_offset) const;
+
+  void PackCodes(const std::vector<uint64_t> &codes);
+
+  void BuildDictionary(const std::vector<type::Value> &values,
+                       std::vector<uint64_t> &codes);
+
+  // The codes whose values satisfy the comparison are the ones in
+  // [low_code, high_code), or the ones outside of it if negate is set
+  bool GetCodeRange(const ExpressionType comparison,
+                    const type::Value &constant, uint64_t &low_code,
+                    uint64_t &high_code, bool &negate) const;
+
+  // Frame of reference keys keep the order of the values as unsigned
+  // integers
+  uint64_t GetKey(const type::Value &value) const;
+
+  type::Value GetKeyValue(const uint64_t key) const;
+
+  type::Type::TypeId type_id_;
+
+  oid_t tuple_count_;
+
+  bool is_dictionary_ = false;
+
+  // Smallest key of a frame of reference encoded column
+  uint64_t base_key_ = 0;
+
+  // Distinct values of a dictionary encoded column, in the format they are
+  // stored in a tile
+  std::vector<char> dictionary_;
+
+  size_t dictionary_entry_size_ = 0;
+
+  // Length prefixed data the varlen dictionary entries point to
+  std::vector<char> varlen_data_;
+
+  // Number of codes of non-NULL values, also the code of NULL
+  uint64_t null_code_ = 0;
+
+  uint32_t bit_width_ = 0;
+
+  std::vector<uint64_t> packed_codes_;
+
+  // Exclusive end of every run, empty unless run length encoded
+  std::vector<oid_t> run_ends_;
+};
+
+}  // End storage namespace
+}  // End peloton namespace
@@ -121,6 +121,24 @@ class DataTable : public AbstractTable {
   // aggregate_executor.
   ItemPointer InsertTuple(const Tuple *tuple);
 
+  // insert a batch of tuples in table. the slots are claimed in runs of
+  // consecutive slots and every index is filled in key order. the inserts are
+  // registered with the transaction before the index entries are added, so
+  // a batch also conflicts with itself. returns false on a constraint
+  // violation, the transaction has to abort then.
+  // if deferred_index_entries is given, the indexes are left alone and the
+  // index entries of the batch are appended to it for BuildIndexes().
+  bool InsertTuples(const std::vector<const Tuple *> &tuples,
+                    concurrency::Transaction *transaction,
+                    std::vector<ItemPointer *> *deferred_index_entries =
+                        nullptr);
+
+  // add the deferred index entries of earlier InsertTuples() calls to all
+  // indexes, each index in key order. returns false on a constraint
+  // violation.
+  bool BuildIndexes(const std::vector<ItemPointer *> &index_entry_ptrs,
+                    concurrency::Transaction *transaction);
+
   //===--------------------------------------------------------------------===//
   // TILE GROUP
   //===--------------------------------------------------------------------===//
@@ -187,6 +205,21 @@ class DataTable : public AbstractTable {
   storage::TileGroup *TransformTileGroup(const oid_t &tile_group_offset,
                                          const double &theta);
 
+  // Replaces a full tile group with a copy in the given layout if the
+  // layouts differ by at least theta. Both share the header, readers of the
+  // old tile group are not blocked. Returns nullptr if the tile group is
+  // frozen, not full, has uncommitted versions or is being transformed.
+  storage::TileGroup *TransformTileGroup(const oid_t &tile_group_offset,
+                                         const column_map_type &column_map,
+                                         const double &theta);
+
+  // Replaces a cold tile group with a compressed copy. A tile group is cold
+  // once it is full and all of its versions are committed before max_cid
+  // and not owned by any transaction. Returns nullptr if it is not cold or
+  // already frozen.
+  storage::TileGroup *FreezeTileGroup(const oid_t &tile_group_offset,
+                                      const cid_t &max_cid);
+
   //===--------------------------------------------------------------------===//
   // STATS
   //===--------------------------------------------------------------------===//
@@ -203,6 +236,10 @@ class DataTable : public AbstractTable {
 
   void ResetDirty();
 
+  // Number of tuple versions ever added or removed, only grows. Statistics
+  // are refreshed once it moved far enough from the last analyze.
+  size_t GetModificationCount() const;
+
   //===--------------------------------------------------------------------===//
   // LAYOUT TUNER
   //===--------------------------------------------------------------------===//
@@ -271,6 +308,10 @@ class DataTable : public AbstractTable {
   // Claim a tuple slot in a tile group
   ItemPointer GetEmptyTupleSlot(const storage::Tuple *tuple);
 
+  // Claim one slot per tuple, in as few runs of consecutive slots as possible
+  void GetEmptyTupleSlots(const std::vector<const storage::Tuple *> &tuples,
+                          std::vector<ItemPointer> &locations);
+
   // add a tile group to the table
   oid_t AddDefaultTileGroup();
   // add a tile group to the table. replace the active_tile_group_id-th active
@@ -286,6 +327,14 @@ class DataTable : public AbstractTable {
   // INDEX HELPERS
   //===--------------------------------------------------------------------===//
 
+  // Get an indirection pointing to the location for the index entries
+  ItemPointer *AllocateIndirection(const ItemPointer &location);
+
+  // Insert a batch of tuples into all indexes, each index in key order
+  bool InsertInIndexes(const std::vector<const AbstractTuple *> &tuples,
+                       const std::vector<ItemPointer *> &index_entry_ptrs,
+                       concurrency::Transaction *transaction);
+
   bool InsertInSecondaryIndexes(const AbstractTuple *tuple,
                                 const TargetList *targets_ptr,
                                 concurrency::Transaction *transaction,
@@ -346,6 +395,9 @@ class DataTable : public AbstractTable {
   // concurrently.
   std::atomic<size_t> number_of_tuples_ = ATOMIC_VAR_INIT(0);
 
+  // # of tuple versions added or removed since the table was created
+  std::atomic<size_t> modification_count_ = ATOMIC_VAR_INIT(0);
+
   // dirty flag. for detecting whether the tile group has been used.
   bool dirty_ = false;
 
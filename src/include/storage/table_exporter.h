@@ -0,0 +1,115 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// table_exporter.h
+//
+// Identification: src/include/storage/table_exporter.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "type/types.h"
+
+namespace peloton {
+
+namespace concurrency {
+class Transaction;
+}
+
+namespace storage {
+
+class DataTable;
+class TileGroup;
+
+/**
+ * Streams the rows of a table to a file. The tile groups are read directly
+ * and the output is written in large chunks.
+ *
+ * EXPORT_BINARY writes a columnar dump, integers in native byte order:
+ *   header: "PLTNDUMP", version (u32), column count (u32), then per column
+ *           its type id (u32) and name (u32 length + bytes)
+ *   blocks: one per tile group with visible rows: row count (u32), then per
+ *           column a null bitmap of (row count + 7) / 8 bytes followed by
+ *           - fixed length types: the values, column length bytes each
+ *           - varlen types: the distinct values of the block (u32 count, then
+ *             u32 length + bytes each) and a u32 dictionary code per row
+ *   trailer: a block with a row count of 0
+ *
+ * All other formats write a line per row. NULL is written as \N, and the
+ * delimiter, newlines and backslashes inside a field are escaped with a
+ * backslash, which is what COPY FROM reads.
+ */
+class TableExporter {
+ public:
+  TableExporter(const TableExporter &) = delete;
+  TableExporter &operator=(const TableExporter &) = delete;
+
+  TableExporter(DataTable *table, CopyType format, char delimiter = ',');
+
+  ~TableExporter();
+
+  // Create the output file, returns false if that fails
+  bool Open(const std::string &file_path);
+
+  // Write the rows visible to the transaction and close the file. returns
+  // false if a read conflicted or the file could not be written, the
+  // transaction has to abort then.
+  bool Export(concurrency::Transaction *transaction);
+
+  // Open the file and export a snapshot read by a read-only transaction,
+  // which is neither validated nor waited for by writers
+  bool ExportSnapshot(const std::string &file_path);
+
+  inline size_t GetBytesWritten() const { return bytes_written_; }
+
+  inline size_t GetRowCount() const { return row_count_; }
+
+  static const char binary_magic[8];
+
+  static const uint32_t binary_version = 1;
+
+ private:
+  void WriteBinaryHeader();
+
+  void WriteRows(TileGroup *tile_group, const std::vector<oid_t> &tuple_ids);
+
+  void WriteBinaryBlock(TileGroup *tile_group,
+                        const std::vector<oid_t> &tuple_ids);
+
+  void AppendUInt32(uint32_t value);
+
+  void AppendInteger(int64_t value);
+
+  void AppendEscaped(const char *data, size_t length);
+
+  // Write out the buffer, returns false if that fails
+  bool Flush();
+
+  // Returns false if writing out the last data fails
+  bool Close();
+
+  DataTable *table_;
+
+  CopyType format_;
+
+  char delimiter_;
+
+  FileHandle file_handle_ = INVALID_FILE_HANDLE;
+
+  // Output that was not written yet
+  std::string buffer_;
+
+  size_t bytes_written_ = 0;
+
+  size_t row_count_ = 0;
+};
+
+}  // namespace storage
+}  // namespace peloton
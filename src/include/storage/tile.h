@@ -12,7 +12,9 @@
 
 #pragma once
 
+#include <memory>
 #include <mutex>
+#include <vector>
 
 #include "catalog/manager.h"
 #include "catalog/schema.h"
@@ -38,12 +40,16 @@ class Tuple;
 class TileGroup;
 class TileGroupHeader;
 class TupleIterator;
+class CompressedColumn;
 
 /**
  * Represents a Tile.
  *
  * Tiles are only instantiated via TileFactory.
  *
+ * A compressed tile keeps its columns in CompressedColumns instead of tuple
+ * slots. It is immutable, only the values can be read.
+ *
  * NOTE: MVCC is implemented on the shared TileGroupHeader.
  */
 class Tile : public Printable {
@@ -61,6 +67,9 @@ class Tile : public Printable {
        const catalog::Schema &tuple_schema, TileGroup *tile_group,
        int tuple_count);
 
+  // Compressed copy of the first tuple_count tuples of an uncompressed tile
+  Tile(Tile *tile, TileGroup *tile_group, int tuple_count);
+
   virtual ~Tile();
 
   //===--------------------------------------------------------------------===//
@@ -117,11 +126,22 @@ class Tile : public Printable {
   // Copy current tile in given backend and return new tile
   Tile *CopyTile(BackendType backend_type);
 
+  //===--------------------------------------------------------------------===//
+  // Compression
+  //===--------------------------------------------------------------------===//
+
+  bool IsCompressed() const { return compressed_columns.empty() == false; }
+
+  // nullptr unless the tile is compressed
+  const CompressedColumn *GetCompressedColumn(const oid_t column_id) const {
+    return IsCompressed() ? compressed_columns[column_id].get() : nullptr;
+  }
+
   //===--------------------------------------------------------------------===//
   // Size Stats
   //===--------------------------------------------------------------------===//
 
-  // Only inlined data
+  // Only inlined data, all of the data of a compressed tile
   uint32_t GetInlinedSize() const { return tile_size; }
 
   int64_t GetUninlinedDataSize() const { return uninlined_data_size; }
@@ -228,6 +248,12 @@ class Tile : public Printable {
    * This is maintained by shared Tile Header.
    */
   TileGroupHeader *tile_group_header;
+
+  // Columns of a compressed tile, it has no tuple slots
+  std::vector<std::unique_ptr<CompressedColumn>> compressed_columns;
+
+ private:
+  oid_t GetColumnIdAtOffset(const size_t column_offset) const;
 };
 
 // Returns a pointer to the tuple requested. No checks are done that the index
@@ -292,6 +318,18 @@ class TileFactory {
     return tile;
   }
 
+  // Creates a compressed copy of the first tuple_count tuples of a tile
+  static Tile *GetCompressedTile(oid_t tile_id, Tile *tile,
+                                 TileGroup *tile_group, int tuple_count) {
+    Tile *compressed_tile = new Tile(tile, tile_group, tuple_count);
+
+    TileFactory::InitCommon(compressed_tile, tile->database_id,
+                            tile->table_id, tile->tile_group_id, tile_id,
+                            tile->schema);
+
+    return compressed_tile;
+  }
+
  private:
   static void InitCommon(Tile *tile, oid_t database_id, oid_t table_id,
                          oid_t tile_group_id, oid_t tile_id,
@@ -52,6 +52,7 @@ class TileGroupHeader;
 class AbstractTable;
 class TileGroupIterator;
 class RollbackSegment;
+class ZoneMap;
 
 typedef std::map<oid_t, std::pair<oid_t, oid_t>> column_map_type;
 
@@ -78,6 +79,13 @@ class TileGroup : public Printable {
             AbstractTable *table, const std::vector<catalog::Schema> &schemas,
             const column_map_type &column_map, int tuple_count);
 
+  // Compressed copy of a frozen tile group, the two share the header
+  explicit TileGroup(TileGroup *tile_group);
+
+  // Empty tile group with another layout that shares the header
+  TileGroup(TileGroup *tile_group, const std::vector<catalog::Schema> &schemas,
+            const column_map_type &column_map);
+
   ~TileGroup();
 
   //===--------------------------------------------------------------------===//
@@ -182,6 +190,10 @@ class TileGroup : public Printable {
 
   double GetSchemaDifference(const storage::column_map_type &new_column_map);
 
+  // Value ranges of the columns, shared by the copies of the tile group
+  // with another layout
+  ZoneMap *GetZoneMap() const { return zone_map.get(); }
+
   // Sync the contents
   void Sync();
 
@@ -207,6 +219,9 @@ class TileGroup : public Printable {
   // associated tile group
   TileGroupHeader *tile_group_header;
 
+  // the header outlives all tile groups sharing it
+  std::shared_ptr<TileGroupHeader> tile_group_header_owner;
+
   // associated table
   AbstractTable *table;  // this design is fantastic!!!
 
@@ -221,6 +236,12 @@ class TileGroup : public Printable {
   // column to tile mapping :
   // <column offset> to <tile offset, tile column offset>
   column_map_type column_map;
+
+  // every value written into the tile group goes into the zone map
+  std::shared_ptr<ZoneMap> zone_map;
+
+ private:
+  std::vector<type::Type::TypeId> GetColumnTypes() const;
 };
 
 }  // End storage namespace
@@ -34,6 +34,15 @@ class TileGroupFactory {
                                  const std::vector<catalog::Schema> &schemas,
                                  const column_map_type &column_map,
                                  int tuple_count);
+
+  // Compressed copy of a frozen tile group. The copy shares the header.
+  static TileGroup *GetCompressedTileGroup(TileGroup *tile_group);
+
+  // Empty tile group with the same header and another layout, the data is
+  // copied over by the caller
+  static TileGroup *GetTransformedTileGroup(
+      TileGroup *tile_group, const std::vector<catalog::Schema> &schemas,
+      const column_map_type &column_map);
 };
 
 }  // End storage namespace
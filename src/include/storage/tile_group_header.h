@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <cstring>
 #include <iostream>
@@ -103,6 +104,23 @@ class TileGroupHeader : public Printable {
     }
   }
 
+  // reserves up to count consecutive slots and returns how many it got.
+  // only called by DataTable::GetEmptyTupleSlots().
+  oid_t GetNextEmptyTupleSlots(const oid_t count, oid_t &first_slot) {
+    if (next_tuple_slot >= num_tuple_slots) {
+      return 0;
+    }
+
+    oid_t tuple_slot_id =
+        next_tuple_slot.fetch_add(count, std::memory_order_relaxed);
+
+    if (tuple_slot_id >= num_tuple_slots) {
+      return 0;
+    }
+    first_slot = tuple_slot_id;
+    return std::min(count, num_tuple_slots - tuple_slot_id);
+  }
+
   /**
    * Used by logging
    */
@@ -227,6 +245,46 @@ class TileGroupHeader : public Printable {
 
   void PrintVisibility(txn_id_t txn_id, cid_t at_cid);
 
+  // The tuple slots of a frozen tile group are immutable and never reused.
+  // A tile group is frozen before it is compressed.
+  inline bool IsFrozen() const { return frozen.load(); }
+
+  inline void SetFrozen(const bool is_frozen) { frozen.store(is_frozen); }
+
+  // The layout of a tile group is changed by one thread at a time, the GC
+  // does not reuse its tuple slots meanwhile. Returns false if another
+  // thread is changing the layout.
+  inline bool StartTransforming() {
+    bool is_transforming = false;
+    return transforming.compare_exchange_strong(is_transforming, true);
+  }
+
+  inline void StopTransforming() { transforming.store(false); }
+
+  inline bool IsTransforming() const { return transforming.load(); }
+
+  // Access statistics of the layout tuner. A read is a scan of the tile
+  // group, a write a version inserted into or modified in it.
+  inline void IncrementReadCount() {
+    read_count.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  inline void IncrementWriteCount() {
+    write_count.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  inline uint64_t GetReadCount() const {
+    return read_count.load(std::memory_order_relaxed);
+  }
+
+  inline uint64_t GetWriteCount() const {
+    return write_count.load(std::memory_order_relaxed);
+  }
+
+  // Halves the counts so that recent accesses weigh more. Concurrent
+  // increments may get lost.
+  void DecayAccessCounts();
+
   // Getter for spin lock
 
   Spinlock &GetHeaderLock() { return tile_header_lock; }
@@ -284,6 +342,14 @@ class TileGroupHeader : public Printable {
   std::atomic<oid_t> next_tuple_slot;
 
   Spinlock tile_header_lock;
+
+  std::atomic<bool> frozen;
+
+  std::atomic<bool> transforming;
+
+  std::atomic<uint64_t> read_count;
+
+  std::atomic<uint64_t> write_count;
 };
 
 }  // End storage namespace
@@ -0,0 +1,84 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// zone_map.h
+//
+// Identification: src/include/storage/zone_map.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "type/types.h"
+#include "type/value.h"
+
+namespace peloton {
+namespace storage {
+
+//===--------------------------------------------------------------------===//
+// ZoneMap
+//
+// The smallest and largest value and the number of NULLs of every column of
+// a tile group. The ranges only grow while values are written into the tile
+// group, so they may be wider than the values it holds, but never narrower.
+// Scans skip tile groups whose ranges can not satisfy their predicate.
+//
+// Ranges are kept for the numeric and timestamp columns, as keys that order
+// like the values. Updates are lock-free.
+//===--------------------------------------------------------------------===//
+class ZoneMap {
+ public:
+  ZoneMap(const ZoneMap &) = delete;
+  ZoneMap &operator=(const ZoneMap &) = delete;
+
+  explicit ZoneMap(const std::vector<type::Type::TypeId> &column_types);
+
+  // Widens the range of the column by a value written into it
+  void UpdateColumn(const oid_t column_id, const type::Value &value);
+
+  // Whether a value of the column may satisfy "column <comparison>
+  // constant". OPERATOR_IS_NULL ignores the constant.
+  bool MayMatch(const oid_t column_id, const ExpressionType comparison,
+                const type::Value &constant) const;
+
+  // Returns false if the column has no range, because its type has none, no
+  // value other than NULL was written into it or it holds a NaN
+  bool GetRange(const oid_t column_id, type::Value &min_value,
+                type::Value &max_value) const;
+
+  // Upper bound of the number of NULLs in the column
+  oid_t GetNullCount(const oid_t column_id) const;
+
+  oid_t GetColumnCount() const { return column_count_; }
+
+  static bool HasRange(const type::Type::TypeId type_id);
+
+ private:
+  struct ColumnZone {
+    type::Type::TypeId type_id;
+
+    // min_key > max_key while there are no values
+    std::atomic<uint64_t> min_key;
+
+    std::atomic<uint64_t> max_key;
+
+    // A NaN was written, which orders with no value, so anything may match
+    std::atomic<bool> unbounded;
+
+    std::atomic<oid_t> null_count;
+  };
+
+  oid_t column_count_;
+
+  std::unique_ptr<ColumnZone[]> columns_;
+};
+
+}  // End storage namespace
+}  // End peloton namespace
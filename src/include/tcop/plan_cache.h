@@ -0,0 +1,139 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// plan_cache.h
+//
+// Identification: src/include/tcop/plan_cache.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "common/cache.h"
+#include "common/statement.h"
+#include "type/value.h"
+
+// Max number of query shapes kept by the plan cache
+#define PLAN_CACHE_SIZE 1024
+
+// Number of independently locked partitions of the plan cache
+#define PLAN_CACHE_PARTITION_COUNT 16
+
+// Max number of idle statements kept for one query shape
+#define PLAN_CACHE_MAX_IDLE_STATEMENTS 16
+
+namespace peloton {
+namespace tcop {
+
+//===--------------------------------------------------------------------===//
+// Cached Query
+//===--------------------------------------------------------------------===//
+
+// All the plans of one query shape. Binding parameters writes into the plan
+// tree, so a statement is only ever used by one connection at a time. Idle
+// statements wait here for the next query of the same shape.
+struct CachedQuery {
+  CachedQuery(const std::string &fingerprint,
+              const std::set<oid_t> &table_ids, bool cacheable)
+      : fingerprint_(fingerprint),
+        table_ids_(table_ids),
+        cacheable_(cacheable) {}
+
+  std::string fingerprint_;
+
+  // The tables the plans read or write
+  std::set<oid_t> table_ids_;
+
+  // False if the parameterized query can not be planned
+  bool cacheable_;
+
+  std::vector<std::shared_ptr<Statement>> idle_statements_;
+};
+
+//===--------------------------------------------------------------------===//
+// Plan Cache
+//===--------------------------------------------------------------------===//
+
+/**
+ * Server-wide cache of the plans of simple-protocol queries, keyed by the
+ * query with its literals lifted into parameters ($1, $2, ...). Queries
+ * that only differ in their literals share a fingerprint and skip parsing
+ * and planning.
+ *
+ * Entries are invalidated by table oid, like the prepared statements of a
+ * PacketManager, and whenever a database goes away.
+ */
+class PlanCache {
+ public:
+  PlanCache(const PlanCache &) = delete;
+  PlanCache &operator=(const PlanCache &) = delete;
+
+  PlanCache();
+
+  static PlanCache &GetInstance();
+
+  // Takes an idle statement for the fingerprint, nullptr if there is none.
+  // cacheable is set to false if the fingerprint is known to be unplannable.
+  // The returned version must be handed back to Release().
+  std::shared_ptr<Statement> Acquire(const std::string &fingerprint,
+                                     bool &cacheable, size_t &version);
+
+  // Gives a statement back after its execution. It is dropped if the cache
+  // was invalidated since the statement was acquired.
+  void Release(const std::string &fingerprint,
+               const std::shared_ptr<Statement> &statement,
+               const size_t version);
+
+  // Remembers that the fingerprint can not be planned
+  void MarkUncacheable(const std::string &fingerprint, const size_t version);
+
+  // Drops all the plans that reference the given table
+  void InvalidateTable(oid_t table_id);
+
+  // Drops all plans
+  void Clear();
+
+  // Returns the number of cached query shapes
+  size_t GetSize();
+
+  // Replaces the literals of the query with parameters and returns them.
+  // Returns false if the query should not go through the cache.
+  static bool Parameterize(const std::string &query, std::string &fingerprint,
+                           std::vector<type::Value> &params);
+
+ private:
+  struct Partition {
+    Partition() : queries_(PLAN_CACHE_SIZE / PLAN_CACHE_PARTITION_COUNT) {}
+
+    std::mutex mutex_;
+    Cache<std::string, CachedQuery> queries_;
+  };
+
+  // Removes the entries matching the predicate from all partitions
+  template <typename Predicate>
+  void Invalidate(Predicate predicate);
+
+  inline Partition &GetPartition(const std::string &fingerprint) {
+    return partitions_[std::hash<std::string>()(fingerprint) %
+                       PLAN_CACHE_PARTITION_COUNT];
+  }
+
+  Partition partitions_[PLAN_CACHE_PARTITION_COUNT];
+
+  // Bumped by every invalidation so that plans built concurrently with it
+  // do not make it into the cache
+  std::atomic<size_t> version_;
+};
+
+}  // End tcop namespace
+}  // End peloton namespace
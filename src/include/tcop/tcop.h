@@ -65,7 +65,9 @@ class TrafficCop {
   // statement
   bridge::peloton_status ExecuteStatementPlan(
       const planner::AbstractPlan *plan, const std::vector<type::Value> &params,
-      std::vector<StatementResult> &result, const std::vector<int> &result_format);
+      std::vector<StatementResult> &result, const std::vector<int> &result_format,
+      std::string *profile_info = nullptr,
+      bridge::ExecutorTreeCache *tree_cache = nullptr);
 
   // InitBindPrepStmt - Prepare and bind a query from a query string
   std::shared_ptr<Statement> PrepareStatement(const std::string &statement_name,
@@ -81,6 +83,11 @@ class TrafficCop {
   FieldInfo GetColumnFieldForAggregates(std::string name,
                                             ExpressionType expr_type);
 
+  // Strips a leading EXPLAIN [ANALYZE] from the query.
+  // Returns false if the query is not an EXPLAIN.
+  static bool ParseExplain(const std::string &query,
+                           std::string &explained_query, bool &analyze);
+
   int BindParameters(std::vector<std::pair<int, std::string>> &parameters,
                      Statement **stmt, std::string &error_message);
 
@@ -103,6 +110,22 @@ class TrafficCop {
   ResultType CommitQueryHelper();
 
   ResultType AbortQueryHelper();
+
+  // Runs the query through a plan of the shared plan cache.
+  // Returns false if the query has to be prepared from scratch.
+  bool ExecuteCachedStatement(const std::string &fingerprint,
+                              std::vector<type::Value> &params,
+                              std::vector<StatementResult> &result,
+                              std::vector<FieldInfo> &tuple_descriptor,
+                              int &rows_changed, std::string &error_message,
+                              ResultType &status);
+
+  // Runs (or for plain EXPLAIN just prints) the plan of an EXPLAIN statement
+  // and returns one result row per line
+  ResultType ExplainQueryHelper(const std::shared_ptr<Statement> &statement,
+                                const std::vector<type::Value> &params,
+                                std::vector<StatementResult> &result,
+                                int &rows_changed);
 };
 
 }  // End tcop namespace
@@ -546,6 +546,7 @@ enum class PlanNodeType {
   // Utility
   RESULT = 70,
   COPY = 71,
+  ANALYZE = 72,
 
   // Test
   MOCK = 80
@@ -583,7 +584,8 @@ enum class StatementType {
   RENAME = 11,                // rename statement type
   ALTER = 12,                 // alter statement type
   TRANSACTION = 13,           // transaction statement type,
-  COPY = 14                   // copy type
+  COPY = 14,                  // copy type
+  ANALYZE = 15                // analyze type
 };
 std::string StatementTypeToString(StatementType type);
 StatementType StringToStatementType(const std::string &str);
@@ -679,6 +681,7 @@ enum class CopyType {
   EXPORT_CSV,     // Export data to csv file
   EXPORT_STDOUT,  // Export data to std out
   EXPORT_OTHER,   // Export data to other file format
+  EXPORT_BINARY,  // Export data to a binary columnar dump
 };
 
 //===--------------------------------------------------------------------===//
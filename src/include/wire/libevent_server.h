@@ -53,6 +53,7 @@ enum ConnState {
   CONN_WRITE,      // State the writes data to the network
   CONN_WAIT,       // State for waiting for some event to happen
   CONN_PROCESS,    // State that runs the wire protocol on received data
+  CONN_EXECUTE,    // State that handles the result of a processed packet
   CONN_CLOSING,    // State for closing the client connection
   CONN_CLOSED,     // State for closed connection
   CONN_INVALID,    // Invalid STate
@@ -72,18 +73,15 @@ enum WriteState {
 
 /* Libevent Callbacks */
 
-/* Used by a worker thread to receive a new connection from the main thread and
- * launch the event handler */
-void WorkerHandleNewConn(evutil_socket_t local_fd, short ev_flags, void *arg);
+/* Used by a worker thread to receive new connections from the acceptors and
+ * connections whose packet a query thread has processed */
+void WorkerHandleNotify(evutil_socket_t notify_fd, short ev_flags, void *arg);
 
 /* Used by a worker to execute the main event loop for a connection */
 void EventHandler(evutil_socket_t connfd, short ev_flags, void *arg);
 
 /* Helpers */
 
-/* Helper used by master thread to dispatch new connection to worker thread */
-void DispatchConnection(int new_conn_fd, short event_flags);
-
 /* Runs the state machine for the protocol. Invoked by event handler callback */
 void StateMachine(LibeventSocket *conn);
 
@@ -162,6 +160,7 @@ class LibeventSocket {
   PacketManager pkt_manager;       // Stores state for this socket
   ConnState state = CONN_INVALID;  // Initial state of connection
   InputPacket rpkt;                // Used for reading a single Postgres packet
+  bool process_status = true;      // Result of the last processed packet
 
  private:
   Buffer rbuf_;                     // Socket's read buffer
@@ -205,12 +204,25 @@ class LibeventSocket {
   // Extracts the contents of Postgres packet from the read socket buffer
   bool ReadPacket();
 
+  // Writes the responses into the write buffer. The buffer is flushed on
+  // Sync, unless more complete messages of a pipelined batch are waiting.
   WriteState WritePackets();
 
+  // Used to invoke a write into the Socket, returns false if the socket is not
+  // ready for write
+  WriteState FlushWriteBuffer();
+
   void PrintWriteBuffer();
 
   void CloseSocket();
 
+  // Process the packet on a query thread. The event of the socket is removed
+  // until the thread hands the connection back to its worker.
+  void ExecutePacket();
+
+  // Continue after a query thread processed the packet
+  void ResumeAfterExecute();
+
   void Reset();
 
  private:
@@ -220,9 +232,12 @@ class LibeventSocket {
   // Writes a packet's content into the write buffer
   WriteState BufferWriteBytesContent(OutputPacket *pkt);
 
-  // Used to invoke a write into the Socket, returns false if the socket is not
-  // ready for write
-  WriteState FlushWriteBuffer();
+  // Writes the write buffer and the rest of a packet that does not fit into
+  // it with one writev, returns false if the socket is not ready for write
+  WriteState FlushWriteBufferAndPacket(OutputPacket *pkt);
+
+  // Is a complete packet waiting in the read buffer?
+  bool IsPacketBuffered();
 };
 
 struct LibeventServer {
@@ -233,6 +248,12 @@ struct LibeventServer {
   uint64_t port_;           // port number
   size_t max_connections_;  // maximum number of connections
 
+  // Pending connections a listening socket queues up
+  static const int conn_backlog = 128;
+
+  // Create a socket listening on the port
+  int CreateListenSocket(const struct sockaddr_in &sin, bool reuse_port);
+
  public:
   LibeventServer();
   static LibeventSocket *GetConn(const int &connfd);
@@ -24,6 +24,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <atomic>
 #include <iostream>
 #include <vector>
 
@@ -42,6 +43,7 @@ namespace wire {
 
 // Forward Declarations
 struct NewConnQueueItem;
+class LibeventSocket;
 
 class LibeventThread {
  protected:
@@ -49,9 +51,14 @@ class LibeventThread {
   const int thread_id_;
   struct event_base *libevent_base_;
 
+  // Number of client connections served by this thread
+  std::atomic<size_t> connection_count_;
+
  public:
   LibeventThread(const int thread_id, struct event_base *libevent_base)
-      : thread_id_(thread_id), libevent_base_(libevent_base) {
+      : thread_id_(thread_id),
+        libevent_base_(libevent_base),
+        connection_count_(0) {
     if (libevent_base_ == nullptr) {
       LOG_ERROR("Can't allocate event base\n");
       exit(1);
@@ -62,42 +69,60 @@ class LibeventThread {
 
   inline int GetThreadID() const { return thread_id_; }
 
+  inline size_t GetConnectionCount() const { return connection_count_; }
+
+  inline void AddConnection() { connection_count_++; }
+
+  inline void RemoveConnection() { connection_count_--; }
+
   // TODO implement destructor
   inline ~LibeventThread() {}
 };
 
 class LibeventWorkerThread : public LibeventThread {
  private:
-  // New connection event
-  struct event *new_conn_event_;
+  // Notification event
+  struct event *notify_event_;
 
  public:
-  // Notify new connection pipe(send end)
-  int new_conn_send_fd;
-
-  // Notify new connection pipe(receive end)
-  int new_conn_receive_fd;
+  // Wakes up the worker thread. Notifications coalesce, so the worker drains
+  // both queues whenever the eventfd fires.
+  int notify_fd;
 
   /* The queue for new connection requests */
   LockFreeQueue<std::shared_ptr<NewConnQueueItem>> new_conn_queue;
 
+  /* The queue for connections whose packet was processed by a query thread */
+  LockFreeQueue<LibeventSocket *> executed_conn_queue;
+
  public:
   LibeventWorkerThread(const int thread_id);
+
+  // Hand a connection back once its packet has been processed
+  void NotifyExecuted(LibeventSocket *conn);
+
+  // Wake up the event loop of the worker
+  void Notify();
 };
 
 class LibeventMasterThread : public LibeventThread {
  private:
-  const int num_threads_;
-
-  // TODO: have a smarter dispatch scheduler
-  int next_thread_id_ = 0;  // next thread we dispatched to
+  // Worker the search for the least loaded worker starts at, so that ties
+  // are spread over the workers
+  static std::atomic<size_t> next_thread_id_;
 
  public:
   LibeventMasterThread(const int num_threads, struct event_base *libevent_base);
 
-  void DispatchConnection(int new_conn_fd, short event_flags);
+  // Assign a new connection to the worker serving the fewest connections.
+  // Safe to call from any acceptor.
+  static void DispatchConnection(int new_conn_fd, short event_flags);
+
+  // Hand a listening socket to a worker, which then accepts on it as well
+  static void DispatchListener(int listen_fd, int thread_id);
 
-  std::vector<std::shared_ptr<LibeventWorkerThread>> &GetWorkerThreads();
+  static std::vector<std::shared_ptr<LibeventWorkerThread>>
+      &GetWorkerThreads();
 
   static void StartWorker(peloton::wire::LibeventWorkerThread *worker_thread);
 };
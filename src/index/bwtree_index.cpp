@@ -11,6 +11,8 @@
 //===----------------------------------------------------------------------===//
 #include "index/bwtree_index.h"
 
+#include <algorithm>
+
 #include "common/logger.h"
 #include "index/index_key.h"
 #include "index/scan_optimizer.h"
@@ -20,6 +22,9 @@
 namespace peloton {
 namespace index {
 
+// Entries a multi-key probe walks over before it descends the tree again
+static const size_t MAX_SKIPPED_ENTRIES = 64;
+
 BWTREE_TEMPLATE_ARGUMENTS
 BWTREE_INDEX_TYPE::BWTreeIndex(IndexMetadata *metadata)
     :  // Base class
@@ -273,6 +278,81 @@ void BWTREE_INDEX_TYPE::ScanKey(const storage::Tuple *key,
   return;
 }
 
+/*
+ * ScanKeys() - Look up a batch of keys with one forward iterator
+ *
+ * The keys are probed in ascending order. Between two keys the iterator
+ * walks forward over the entries in between, which mostly stay in the leaf
+ * it already holds, and only descends the tree again for a key that is more
+ * than MAX_SKIPPED_ENTRIES entries away.
+ */
+BWTREE_TEMPLATE_ARGUMENTS
+void BWTREE_INDEX_TYPE::ScanKeys(
+    const std::vector<const storage::Tuple *> &keys,
+    std::vector<std::vector<ValueType>> &results) {
+  results.resize(keys.size());
+
+  std::vector<KeyType> index_keys(keys.size());
+  std::vector<size_t> key_order(keys.size());
+  for (size_t key_itr = 0; key_itr < keys.size(); key_itr++) {
+    index_keys[key_itr].SetFromKey(keys[key_itr]);
+    key_order[key_itr] = key_itr;
+  }
+  std::sort(key_order.begin(), key_order.end(),
+            [this, &index_keys](const size_t lhs, const size_t rhs) {
+              return container.KeyCmpLess(index_keys[lhs], index_keys[rhs]);
+            });
+
+  size_t result_count = 0;
+  typename MapType::ForwardIterator scan_itr{};
+  const KeyType *last_key = nullptr;
+  size_t last_key_itr = 0;
+  for (auto key_itr : key_order) {
+    const KeyType &index_key = index_keys[key_itr];
+
+    // The iterator has already passed the entries of a repeated key
+    if (last_key != nullptr && container.KeyCmpEqual(*last_key, index_key)) {
+      results[key_itr] = results[last_key_itr];
+      result_count += results[key_itr].size();
+      continue;
+    }
+
+    size_t skipped_count = 0;
+    while (last_key != nullptr && scan_itr.IsEnd() == false &&
+           skipped_count < MAX_SKIPPED_ENTRIES &&
+           container.KeyCmpLess(scan_itr->first, index_key)) {
+      scan_itr++;
+      skipped_count++;
+    }
+    if (last_key == nullptr || (scan_itr.IsEnd() == false &&
+                                container.KeyCmpLess(scan_itr->first,
+                                                     index_key))) {
+      scan_itr = container.Begin(index_key);
+    }
+    last_key = &index_key;
+    last_key_itr = key_itr;
+
+    // No larger key is left in the index
+    if (scan_itr.IsEnd() == true) {
+      break;
+    }
+
+    for (; (scan_itr.IsEnd() == false) &&
+               container.KeyCmpEqual(scan_itr->first, index_key);
+         scan_itr++) {
+      results[key_itr].push_back(scan_itr->second);
+      result_count++;
+    }
+  }
+
+  if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
+        result_count, metadata);
+  }
+
+  return;
+}
+
 BWTREE_TEMPLATE_ARGUMENTS
 std::string BWTREE_INDEX_TYPE::GetTypeName() const { return "BWTree"; }
 
@@ -205,6 +205,21 @@ void Index::ScanTest(const std::vector<type::Value> &value_list,
   return;
 }
 
+/*
+ * ScanKeys() - Look up every key of a batch on its own
+ *
+ * Indexes that can walk their keys in order override this
+ */
+void Index::ScanKeys(const std::vector<const storage::Tuple *> &keys,
+                     std::vector<std::vector<ItemPointer *>> &results) {
+  results.resize(keys.size());
+  for (size_t key_itr = 0; key_itr < keys.size(); key_itr++) {
+    ScanKey(keys[key_itr], results[key_itr]);
+  }
+
+  return;
+}
+
 /*
  * Compare() - Check whether a given index key satisfies a predicate
  *
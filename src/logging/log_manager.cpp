@@ -18,10 +18,12 @@
 #include "common/logger.h"
 #include "common/macros.h"
 #include "concurrency/transaction_manager_factory.h"
+#include "configuration/configuration.h"
 #include "executor/executor_context.h"
 #include "logging/log_manager.h"
 #include "logging/logging_util.h"
 #include "logging/records/transaction_record.h"
+#include "statistics/backend_stats_context.h"
 #include "storage/data_table.h"
 #include "storage/database.h"
 #include "storage/tile_group.h"
@@ -217,41 +219,50 @@ void LogManager::LogUpdate(cid_t commit_id, const ItemPointer &old_version,
 }
 
 void LogManager::LogInsert(cid_t commit_id, const ItemPointer &new_location) {
-  if (this->IsInLoggingMode()) {
+  LogInserts(commit_id, new_location.block, {new_location.offset});
+}
+
+void LogManager::LogInserts(cid_t commit_id, oid_t tile_group_id,
+                            const std::vector<oid_t> &tuple_slots) {
+  if (this->IsInLoggingMode() && tuple_slots.empty() == false) {
     auto logger = this->GetBackendLogger();
     auto &manager = catalog::Manager::GetInstance();
     auto catalog = catalog::Catalog::GetInstance();
 
-    auto new_tuple_tile_group = manager.GetTileGroup(new_location.block);
-
-    auto tile_group = manager.GetTileGroup(new_location.block);
+    auto tile_group = manager.GetTileGroup(tile_group_id);
     std::unique_ptr<LogRecord> record;
+
+    // One tuple buffer serves all inserts of the tile group
     std::unique_ptr<storage::Tuple> tuple;
+    const catalog::Schema *schema = nullptr;
     if (LoggingUtil::IsBasedOnWriteAheadLogging(logging_type_)) {
-      auto schema = catalog
-                        ->GetTableWithOid(tile_group->GetDatabaseId(),
-                                          tile_group->GetTableId())
-                        ->GetSchema();
+      schema = catalog
+                   ->GetTableWithOid(tile_group->GetDatabaseId(),
+                                     tile_group->GetTableId())
+                   ->GetSchema();
       tuple.reset(new storage::Tuple(schema, true));
-      for (oid_t col = 0; col < schema->GetColumnCount(); col++) {
-        type::Value val =
-            (new_tuple_tile_group->GetValue(new_location.offset, col));
-        tuple->SetValue(col, val, logger->GetVarlenPool());
-      }
-
-      record.reset(logger->GetTupleRecord(
-          LOGRECORD_TYPE_TUPLE_INSERT, commit_id, tile_group->GetTableId(),
-          new_tuple_tile_group->GetDatabaseId(), new_location,
-          INVALID_ITEMPOINTER, tuple.get()));
+    }
 
-    } else {
-      // do not construct the tuple for the wbl case
-      record.reset(logger->GetTupleRecord(LOGRECORD_TYPE_TUPLE_INSERT,
-                                          commit_id, tile_group->GetTableId(),
-                                          new_tuple_tile_group->GetDatabaseId(),
-                                          new_location, INVALID_ITEMPOINTER));
+    for (auto tuple_slot : tuple_slots) {
+      ItemPointer new_location(tile_group_id, tuple_slot);
+      if (tuple != nullptr) {
+        for (oid_t col = 0; col < schema->GetColumnCount(); col++) {
+          type::Value val = (tile_group->GetValue(tuple_slot, col));
+          tuple->SetValue(col, val, logger->GetVarlenPool());
+        }
+
+        record.reset(logger->GetTupleRecord(
+            LOGRECORD_TYPE_TUPLE_INSERT, commit_id, tile_group->GetTableId(),
+            tile_group->GetDatabaseId(), new_location, INVALID_ITEMPOINTER,
+            tuple.get()));
+      } else {
+        // do not construct the tuple for the wbl case
+        record.reset(logger->GetTupleRecord(
+            LOGRECORD_TYPE_TUPLE_INSERT, commit_id, tile_group->GetTableId(),
+            tile_group->GetDatabaseId(), new_location, INVALID_ITEMPOINTER));
+      }
+      logger->Log(record.get());
     }
-    logger->Log(record.get());
   }
 }
 
@@ -272,6 +283,11 @@ void LogManager::LogDelete(cid_t commit_id,
 
 void LogManager::LogCommitTransaction(cid_t commit_id) {
   if (this->IsInLoggingMode()) {
+    stats::LatencyTimer commit_timer;
+    if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
+      commit_timer.StartTimer();
+    }
+
     auto logger = this->GetBackendLogger();
     TransactionRecord record(LOGRECORD_TYPE_TRANSACTION_COMMIT, commit_id);
     logger->Log(&record);
@@ -279,6 +295,12 @@ void LogManager::LogCommitTransaction(cid_t commit_id) {
       WaitForFlush(commit_id);
     }
     // logger->GetVarlenPool()->Purge();
+
+    if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
+      stats::BackendStatsContext::GetInstance()
+          ->GetCommitLatencyMetric()
+          .RecordLatency(commit_timer.RecordLatency());
+    }
   }
 }
 
@@ -25,6 +25,8 @@
 #include "logging/loggers/wbl_backend_logger.h"
 #include "logging/logging_util.h"
 #include "logging/log_manager.h"
+#include "configuration/configuration.h"
+#include "statistics/backend_stats_context.h"
 
 #define POSSIBLY_DIRTY_GRANT_SIZE 10000000;  // ten million seems reasonable
 
@@ -95,9 +97,16 @@ void WriteBehindFrontendLogger::FlushLogRecords(void) {
   }
 
   // for now fsync every time because the cost is relatively low
+  stats::LatencyTimer fsync_timer;
+  fsync_timer.StartTimer();
   if (fsync(log_file_fd)) {
     LOG_ERROR("Unable to fsync log");
   }
+  if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
+    stats::BackendStatsContext::GetInstance()
+        ->GetFsyncLatencyMetric()
+        .RecordLatency(fsync_timer.RecordLatency());
+  }
 
   // inform backend loggers they can proceed if waiting for sync
   max_flushed_commit_id = max_collected_commit_id;
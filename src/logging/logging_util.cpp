@@ -16,6 +16,8 @@
 #include <cstring>
 
 #include "catalog/catalog.h"
+#include "configuration/configuration.h"
+#include "statistics/backend_stats_context.h"
 #include "storage/database.h"
 #include "type/types.h"
 
@@ -93,19 +95,30 @@ bool LoggingUtil::IsBasedOnWriteBehindLogging(const LoggingType &logging_type) {
   return status;
 }
 
-void LoggingUtil::FFlushFsync(FileHandle &file_handle) {
+bool LoggingUtil::FFlushFsync(FileHandle &file_handle) {
   // First, flush
   PL_ASSERT(file_handle.fd != -1);
-  if (file_handle.fd == -1) return;
+  if (file_handle.fd == -1) return false;
+  bool success = true;
   int ret = fflush(file_handle.file);
   if (ret != 0) {
     LOG_ERROR("Error occured in fflush(%s)", strerror(errno));
+    success = false;
   }
   // Finally, sync
+  stats::LatencyTimer fsync_timer;
+  fsync_timer.StartTimer();
   ret = fsync(file_handle.fd);
   if (ret != 0) {
     LOG_ERROR("Error occured in fsync(%s)", strerror(errno));
+    success = false;
   }
+  if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
+    stats::BackendStatsContext::GetInstance()
+        ->GetFsyncLatencyMetric()
+        .RecordLatency(fsync_timer.RecordLatency());
+  }
+  return success;
 }
 
 bool LoggingUtil::InitFileHandle(const char *name, FileHandle &file_handle,
@@ -0,0 +1,343 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// wire.cpp
+//
+// Identification: src/main/wire/wire.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+
+#include "benchmark/wire/wire_configuration.h"
+#include "common/logger.h"
+
+namespace peloton {
+namespace benchmark {
+namespace wire {
+
+configuration state;
+
+namespace {
+
+// Postgres type oid of INTEGER parameters
+const int32_t int4_type_oid = 23;
+
+// Rows loaded per round trip
+const int load_batch_size = 100;
+
+void PutInt16(std::string &body, int16_t n) {
+  uint16_t n_nb = htons(static_cast<uint16_t>(n));
+  body.append(reinterpret_cast<char *>(&n_nb), sizeof(n_nb));
+}
+
+void PutInt32(std::string &body, int32_t n) {
+  uint32_t n_nb = htonl(static_cast<uint32_t>(n));
+  body.append(reinterpret_cast<char *>(&n_nb), sizeof(n_nb));
+}
+
+void PutString(std::string &body, const std::string &str) {
+  body += str;
+  body += '\0';
+}
+
+// A blocking client connection that speaks just enough of the Postgres
+// protocol to drive the extended query path like pgbench -M prepared does
+class Connection {
+ public:
+  ~Connection() {
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  // Connects and waits until the server is ready for queries
+  bool Open() {
+    fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd_ < 0) {
+      return false;
+    }
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(state.port);
+    if (inet_pton(AF_INET, state.host.c_str(), &addr.sin_addr) != 1 ||
+        connect(fd_, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+      return false;
+    }
+
+    int one = 1;
+    setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    // The startup packet has no type byte
+    std::string body;
+    PutInt32(body, 196608);
+    PutString(body, "user");
+    PutString(body, "postgres");
+    PutString(body, "database");
+    PutString(body, DEFAULT_DB_NAME);
+    body += '\0';
+    PutInt32(out_, body.size() + sizeof(int32_t));
+    out_ += body;
+
+    int error_count = 0;
+    return Flush() && WaitForReady(1, error_count) && error_count == 0;
+  }
+
+  // Queues a message
+  void Put(char type, const std::string &body) {
+    out_ += type;
+    PutInt32(out_, body.size() + sizeof(int32_t));
+    out_ += body;
+  }
+
+  // Sends all queued messages with one write
+  bool Flush() {
+    size_t written = 0;
+    while (written < out_.size()) {
+      auto bytes = write(fd_, out_.data() + written, out_.size() - written);
+      if (bytes < 0) {
+        if (errno == EINTR) continue;
+        return false;
+      }
+      written += bytes;
+    }
+    out_.clear();
+    return true;
+  }
+
+  // Reads responses until ready_count ReadyForQuery messages have arrived
+  bool WaitForReady(int ready_count, int &error_count) {
+    size_t ptr = 0;
+    while (ready_count > 0) {
+      // 1B type and 4B length that includes itself
+      if (in_.size() - ptr > sizeof(int32_t)) {
+        uint32_t len_nb;
+        memcpy(&len_nb, &in_[ptr + 1], sizeof(len_nb));
+        size_t len = ntohl(len_nb);
+        if (in_.size() - ptr >= 1 + len) {
+          if (in_[ptr] == 'Z') {
+            ready_count--;
+          } else if (in_[ptr] == 'E') {
+            error_count++;
+          }
+          ptr += 1 + len;
+          continue;
+        }
+      }
+
+      char buf[8192];
+      auto bytes = read(fd_, buf, sizeof(buf));
+      if (bytes <= 0) {
+        if (bytes < 0 && errno == EINTR) continue;
+        return false;
+      }
+      in_.append(buf, bytes);
+    }
+    in_.erase(0, ptr);
+    return true;
+  }
+
+ private:
+  int fd_ = -1;
+
+  // Queued requests and responses that were not consumed yet
+  std::string out_;
+  std::string in_;
+};
+
+bool SimpleQuery(Connection &conn, const std::string &query) {
+  std::string body;
+  PutString(body, query);
+  conn.Put('Q', body);
+
+  int error_count = 0;
+  return conn.Flush() && conn.WaitForReady(1, error_count);
+}
+
+bool Prepare(Connection &conn, const std::string &name,
+             const std::string &query, int param_count) {
+  std::string body;
+  PutString(body, name);
+  PutString(body, query);
+  PutInt16(body, param_count);
+  for (int param_itr = 0; param_itr < param_count; param_itr++) {
+    PutInt32(body, int4_type_oid);
+  }
+  conn.Put('P', body);
+  conn.Put('S', "");
+
+  int error_count = 0;
+  return conn.Flush() && conn.WaitForReady(1, error_count) &&
+         error_count == 0;
+}
+
+// Queues Bind, Describe, Execute and Sync for a prepared statement
+void QueueExecute(Connection &conn, const std::string &name,
+                  const std::vector<int> &params) {
+  std::string body;
+  PutString(body, "");
+  PutString(body, name);
+  PutInt16(body, 0);
+  PutInt16(body, params.size());
+  for (auto param : params) {
+    auto text = std::to_string(param);
+    PutInt32(body, text.size());
+    body += text;
+  }
+  PutInt16(body, 0);
+  conn.Put('B', body);
+
+  body.clear();
+  body += 'P';
+  PutString(body, "");
+  conn.Put('D', body);
+
+  body.clear();
+  PutString(body, "");
+  PutInt32(body, 0);
+  conn.Put('E', body);
+
+  conn.Put('S', "");
+}
+
+std::string GetInsertQuery() {
+  return std::string("INSERT INTO ") + wire_table_name + " VALUES ($1, $2);";
+}
+
+void LoadTable() {
+  Connection conn;
+  if (conn.Open() == false) {
+    LOG_ERROR("Failed to connect to %s:%d", state.host.c_str(), state.port);
+    exit(EXIT_FAILURE);
+  }
+
+  // The table might be left over from an earlier run
+  SimpleQuery(conn, std::string("DROP TABLE ") + wire_table_name + ";");
+  SimpleQuery(conn, std::string("CREATE TABLE ") + wire_table_name +
+                        "(a INT PRIMARY KEY, b INT);");
+  if (Prepare(conn, "load", GetInsertQuery(), 2) == false) {
+    LOG_ERROR("Failed to prepare the load statement");
+    exit(EXIT_FAILURE);
+  }
+
+  for (int key = 0; key < state.scale_factor; key += load_batch_size) {
+    int batch_end = std::min(key + load_batch_size, state.scale_factor);
+    for (int row = key; row < batch_end; row++) {
+      QueueExecute(conn, "load", {row, row});
+    }
+
+    int error_count = 0;
+    if (conn.Flush() == false ||
+        conn.WaitForReady(batch_end - key, error_count) == false ||
+        error_count > 0) {
+      LOG_ERROR("Failed to load the table");
+      exit(EXIT_FAILURE);
+    }
+  }
+}
+
+void RunClient(int client_id, std::atomic<bool> *is_running,
+               uint64_t *query_count, uint64_t *error_count) {
+  Connection conn;
+  if (conn.Open() == false) {
+    LOG_ERROR("Client %d failed to connect", client_id);
+    return;
+  }
+
+  auto query = state.insert_mode
+                   ? GetInsertQuery()
+                   : std::string("SELECT b FROM ") + wire_table_name +
+                         " WHERE a = $1;";
+  if (Prepare(conn, "bench", query, state.insert_mode ? 2 : 1) == false) {
+    LOG_ERROR("Client %d failed to prepare", client_id);
+    return;
+  }
+
+  std::mt19937 generator(client_id);
+  std::uniform_int_distribution<int> key_distribution(0,
+                                                      state.scale_factor - 1);
+  int next_key = state.scale_factor + client_id;
+
+  while (is_running->load() == true) {
+    for (int query_itr = 0; query_itr < state.pipeline_depth; query_itr++) {
+      if (state.insert_mode == true) {
+        QueueExecute(conn, "bench", {next_key, client_id});
+        next_key += state.backend_count;
+      } else {
+        QueueExecute(conn, "bench", {key_distribution(generator)});
+      }
+    }
+
+    int batch_error_count = 0;
+    if (conn.Flush() == false ||
+        conn.WaitForReady(state.pipeline_depth, batch_error_count) == false) {
+      LOG_ERROR("Client %d lost its connection", client_id);
+      return;
+    }
+    *query_count += state.pipeline_depth;
+    *error_count += batch_error_count;
+  }
+}
+
+}  // namespace
+
+// Main Entry Point
+void RunBenchmark() {
+  LoadTable();
+
+  std::atomic<bool> is_running(true);
+  std::vector<uint64_t> query_counts(state.backend_count, 0);
+  std::vector<uint64_t> error_counts(state.backend_count, 0);
+  std::vector<std::thread> clients;
+  for (int client_id = 0; client_id < state.backend_count; client_id++) {
+    clients.emplace_back(RunClient, client_id, &is_running,
+                         &query_counts[client_id], &error_counts[client_id]);
+  }
+
+  std::this_thread::sleep_for(
+      std::chrono::milliseconds(static_cast<int>(state.duration * 1000)));
+  is_running = false;
+  for (auto &client : clients) {
+    client.join();
+  }
+
+  uint64_t query_count = 0;
+  uint64_t error_count = 0;
+  for (int client_id = 0; client_id < state.backend_count; client_id++) {
+    query_count += query_counts[client_id];
+    error_count += error_counts[client_id];
+  }
+
+  state.throughput = query_count / state.duration;
+  state.error_rate = (query_count > 0) ? error_count * 1.0 / query_count : 0;
+
+  // Emit throughput
+  WriteOutput();
+}
+
+}  // namespace wire
+}  // namespace benchmark
+}  // namespace peloton
+
+int main(int argc, char **argv) {
+  peloton::benchmark::wire::ParseArguments(argc, argv,
+                                           peloton::benchmark::wire::state);
+
+  peloton::benchmark::wire::RunBenchmark();
+
+  return 0;
+}
@@ -0,0 +1,176 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// wire_configuration.cpp
+//
+// Identification: src/main/wire/wire_configuration.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <iomanip>
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+
+#include "benchmark/wire/wire_configuration.h"
+#include "common/logger.h"
+
+namespace peloton {
+namespace benchmark {
+namespace wire {
+
+void Usage(FILE *out) {
+  fprintf(out,
+          "Command line options : wirebench <options> \n"
+          "   -h --help              :  print help message \n"
+          "   -a --host              :  server address (default: 127.0.0.1) \n"
+          "   -p --port              :  server port (default: 15721) \n"
+          "   -k --scale_factor      :  # of rows loaded before the run \n"
+          "   -d --duration          :  execution duration \n"
+          "   -b --backend_count     :  # of client connections \n"
+          "   -l --pipeline_depth    :  # of queries in flight per client \n"
+          "   -i --insert_mode       :  insert rows instead of reading them \n");
+}
+
+static struct option opts[] = {
+    { "host", optional_argument, NULL, 'a' },
+    { "port", optional_argument, NULL, 'p' },
+    { "scale_factor", optional_argument, NULL, 'k' },
+    { "duration", optional_argument, NULL, 'd' },
+    { "backend_count", optional_argument, NULL, 'b' },
+    { "pipeline_depth", optional_argument, NULL, 'l' },
+    { "insert_mode", no_argument, NULL, 'i' },
+    { NULL, 0, NULL, 0 }
+};
+
+void ValidatePort(const configuration &state) {
+  if (state.port <= 0 || state.port > 65535) {
+    LOG_ERROR("Invalid port :: %d", state.port);
+    exit(EXIT_FAILURE);
+  }
+
+  LOG_TRACE("%s : %d", "port", state.port);
+}
+
+void ValidateScaleFactor(const configuration &state) {
+  if (state.scale_factor <= 0) {
+    LOG_ERROR("Invalid scale_factor :: %d", state.scale_factor);
+    exit(EXIT_FAILURE);
+  }
+
+  LOG_TRACE("%s : %d", "scale_factor", state.scale_factor);
+}
+
+void ValidateDuration(const configuration &state) {
+  if (state.duration <= 0) {
+    LOG_ERROR("Invalid duration :: %lf", state.duration);
+    exit(EXIT_FAILURE);
+  }
+
+  LOG_TRACE("%s : %lf", "duration", state.duration);
+}
+
+void ValidateBackendCount(const configuration &state) {
+  if (state.backend_count <= 0) {
+    LOG_ERROR("Invalid backend_count :: %d", state.backend_count);
+    exit(EXIT_FAILURE);
+  }
+
+  LOG_TRACE("%s : %d", "backend_count", state.backend_count);
+}
+
+void ValidatePipelineDepth(const configuration &state) {
+  if (state.pipeline_depth <= 0) {
+    LOG_ERROR("Invalid pipeline_depth :: %d", state.pipeline_depth);
+    exit(EXIT_FAILURE);
+  }
+
+  LOG_TRACE("%s : %d", "pipeline_depth", state.pipeline_depth);
+}
+
+void ParseArguments(int argc, char *argv[], configuration &state) {
+  // Default Values
+  state.host = "127.0.0.1";
+  state.port = 15721;
+  state.scale_factor = 1000;
+  state.duration = 10;
+  state.backend_count = 1;
+  state.pipeline_depth = 1;
+  state.insert_mode = false;
+
+  // Parse args
+  while (1) {
+    int idx = 0;
+    int c = getopt_long(argc, argv, "hia:p:k:d:b:l:", opts, &idx);
+
+    if (c == -1) break;
+
+    switch (c) {
+      case 'a':
+        state.host = optarg;
+        break;
+      case 'p':
+        state.port = atoi(optarg);
+        break;
+      case 'k':
+        state.scale_factor = atoi(optarg);
+        break;
+      case 'd':
+        state.duration = atof(optarg);
+        break;
+      case 'b':
+        state.backend_count = atoi(optarg);
+        break;
+      case 'l':
+        state.pipeline_depth = atoi(optarg);
+        break;
+      case 'i':
+        state.insert_mode = true;
+        break;
+
+      case 'h':
+        Usage(stderr);
+        exit(EXIT_FAILURE);
+        break;
+
+      default:
+        LOG_ERROR("Unknown option: -%c-", c);
+        Usage(stderr);
+        exit(EXIT_FAILURE);
+        break;
+    }
+  }
+
+  // Print configuration
+  ValidatePort(state);
+  ValidateScaleFactor(state);
+  ValidateDuration(state);
+  ValidateBackendCount(state);
+  ValidatePipelineDepth(state);
+
+  LOG_TRACE("%s : %s", "host", state.host.c_str());
+  LOG_TRACE("%s : %d", "Run insert mode", state.insert_mode);
+}
+
+void WriteOutput() {
+  std::ofstream out("outputfile.summary");
+
+  LOG_INFO("----------------------------------------------------------");
+  LOG_INFO("%d %d %d :: %lf %lf", state.backend_count, state.pipeline_depth,
+           state.insert_mode, state.throughput, state.error_rate);
+
+  out << state.backend_count << " ";
+  out << state.pipeline_depth << " ";
+  out << state.insert_mode << " ";
+  out << state.throughput << " ";
+  out << state.error_rate << "\n";
+  out.flush();
+  out.close();
+}
+
+}  // namespace wire
+}  // namespace benchmark
+}  // namespace peloton
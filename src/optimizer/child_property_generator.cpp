@@ -49,6 +49,7 @@ void ChildPropertyGenerator::Visit(const PhysicalInnerHashJoin *){};
 void ChildPropertyGenerator::Visit(const PhysicalLeftHashJoin *){};
 void ChildPropertyGenerator::Visit(const PhysicalRightHashJoin *){};
 void ChildPropertyGenerator::Visit(const PhysicalOuterHashJoin *){};
+void ChildPropertyGenerator::Visit(const PhysicalInnerMergeJoin *){};
 
 } /* namespace optimizer */
 } /* namespace peloton */
@@ -51,6 +51,7 @@ void CostAndStatsCalculator::Visit(const PhysicalInnerHashJoin *){};
 void CostAndStatsCalculator::Visit(const PhysicalLeftHashJoin *){};
 void CostAndStatsCalculator::Visit(const PhysicalRightHashJoin *){};
 void CostAndStatsCalculator::Visit(const PhysicalOuterHashJoin *){};
+void CostAndStatsCalculator::Visit(const PhysicalInnerMergeJoin *){};
 
 } /* namespace optimizer */
 } /* namespace peloton */
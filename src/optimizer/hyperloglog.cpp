@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// hyperloglog.cpp
+//
+// Identification: src/optimizer/hyperloglog.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "optimizer/hyperloglog.h"
+
+#include <cmath>
+
+#include "common/macros.h"
+#include "type/value.h"
+
+namespace peloton {
+namespace optimizer {
+
+namespace {
+
+// The hashes of integer values are the values themselves, mix the bits so
+// that the registers and the leading zeros are evenly distributed
+inline uint64_t MixHash(uint64_t hash) {
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+}  // namespace
+
+HyperLogLog::HyperLogLog(uint8_t precision)
+    : precision_(precision), registers_(1 << precision, 0) {
+  PL_ASSERT(precision >= 4 && precision <= 18);
+}
+
+void HyperLogLog::Add(const type::Value &value) {
+  if (value.IsNull() == true) {
+    return;
+  }
+  AddHash(value.Hash());
+}
+
+void HyperLogLog::AddHash(uint64_t hash) {
+  hash = MixHash(hash);
+  size_t register_id = hash >> (64 - precision_);
+
+  // The remaining bits with a stop bit, so that the count stays in range
+  uint64_t remaining = (hash << precision_) | (1ULL << (precision_ - 1));
+  uint8_t rank = __builtin_clzll(remaining) + 1;
+  if (rank > registers_[register_id]) {
+    registers_[register_id] = rank;
+  }
+}
+
+void HyperLogLog::Merge(const HyperLogLog &other) {
+  PL_ASSERT(precision_ == other.precision_);
+  for (size_t register_id = 0; register_id < registers_.size();
+       register_id++) {
+    if (other.registers_[register_id] > registers_[register_id]) {
+      registers_[register_id] = other.registers_[register_id];
+    }
+  }
+}
+
+double HyperLogLog::Estimate() const {
+  double register_count = registers_.size();
+  double sum = 0;
+  size_t zero_count = 0;
+  for (auto rank : registers_) {
+    sum += std::ldexp(1.0, -rank);
+    if (rank == 0) {
+      zero_count++;
+    }
+  }
+
+  double alpha = 0.7213 / (1 + 1.079 / register_count);
+  double estimate = alpha * register_count * register_count / sum;
+
+  // Small cardinalities are counted more precisely by the empty registers
+  if (estimate <= 2.5 * register_count && zero_count > 0) {
+    estimate = register_count * std::log(register_count / zero_count);
+  }
+  return estimate;
+}
+
+}  // End optimizer namespace
+}  // End peloton namespace
@@ -0,0 +1,948 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// join_enumerator.cpp
+//
+// Identification: src/optimizer/join_enumerator.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "optimizer/join_enumerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <thread>
+
+#include "catalog/schema.h"
+#include "common/exception.h"
+#include "common/logger.h"
+#include "expression/constant_value_expression.h"
+#include "expression/expression_util.h"
+#include "expression/parameter_value_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "index/index.h"
+#include "optimizer/operator_expression.h"
+#include "optimizer/operators.h"
+#include "optimizer/stats.h"
+#include "optimizer/stats_storage.h"
+#include "storage/data_table.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace optimizer {
+
+namespace {
+
+// Selectivity of a predicate nothing is known about
+const double default_selectivity = 1.0 / 3;
+
+// Selectivity of an equality with a value whose column has no statistics
+const double default_equal_selectivity = 0.1;
+
+// Cost of inserting a row into a hash table relative to probing it
+const double hash_build_factor = 2.0;
+
+// Hash tables of more rows do not fit in the caches, every insert and probe
+// costs this much more
+const double hash_cache_rows = 1 << 20;
+const double hash_miss_factor = 4.0;
+
+// Merge joins sort on another thread for every this many input rows
+const double sort_rows_per_thread = 1 << 12;
+
+inline double SortCost(double rows) { return rows * std::log2(rows + 2); }
+
+// Adds the relations whose columns the expression references
+void GetRelations(const expression::AbstractExpression *expr,
+                  uint64_t &relations) {
+  if (expr->GetExpressionType() == ExpressionType::VALUE_TUPLE) {
+    auto tuple_expr =
+        static_cast<const expression::TupleValueExpression *>(expr);
+    relations |= (uint64_t)1 << tuple_expr->GetTupleId();
+  }
+  for (size_t child = 0; child < expr->GetChildrenSize(); child++) {
+    GetRelations(expr->GetChild(child), relations);
+  }
+}
+
+// Adds the columns the expression references
+void GetColumns(const expression::AbstractExpression *expr,
+                std::vector<JoinColumn> &columns) {
+  if (expr->GetExpressionType() == ExpressionType::VALUE_TUPLE) {
+    auto tuple_expr =
+        static_cast<const expression::TupleValueExpression *>(expr);
+    columns.emplace_back(tuple_expr->GetTupleId(), tuple_expr->GetColumnId());
+  }
+  for (size_t child = 0; child < expr->GetChildrenSize(); child++) {
+    GetColumns(expr->GetChild(child), columns);
+  }
+}
+
+// Splits a predicate into its conjuncts
+void GetConjuncts(const expression::AbstractExpression *expr,
+                  std::vector<const expression::AbstractExpression *> &out) {
+  if (expr->GetExpressionType() == ExpressionType::CONJUNCTION_AND) {
+    GetConjuncts(expr->GetChild(0), out);
+    GetConjuncts(expr->GetChild(1), out);
+  } else {
+    out.push_back(expr);
+  }
+}
+
+// Makes the columns of a relation refer to its table tuple
+void BindToTable(expression::AbstractExpression *expr) {
+  if (expr->GetExpressionType() == ExpressionType::VALUE_TUPLE) {
+    auto tuple_expr = static_cast<expression::TupleValueExpression *>(expr);
+    tuple_expr->SetTupleValueExpressionParams(
+        tuple_expr->GetValueType(), tuple_expr->GetColumnId(), 0);
+  }
+  for (size_t child = 0; child < expr->GetChildrenSize(); child++) {
+    BindToTable(expr->GetModifiableChild(child));
+  }
+}
+
+// The conjunction of copies of the expressions, nullptr if there are none
+expression::AbstractExpression *CopyConjunction(
+    const std::vector<const expression::AbstractExpression *> &exprs) {
+  expression::AbstractExpression *result = nullptr;
+  for (auto expr : exprs) {
+    if (result == nullptr) {
+      result = expr->Copy();
+    } else {
+      result = expression::ExpressionUtil::ConjunctionFactory(
+          ExpressionType::CONJUNCTION_AND, result, expr->Copy());
+    }
+  }
+  return result;
+}
+
+inline size_t GetPosition(const std::vector<JoinColumn> &layout,
+                          const JoinColumn &column) {
+  return std::find(layout.begin(), layout.end(), column) - layout.begin();
+}
+
+// The comparison with the sides swapped
+ExpressionType MirrorComparison(ExpressionType compare_type) {
+  switch (compare_type) {
+    case ExpressionType::COMPARE_LESSTHAN:
+      return ExpressionType::COMPARE_GREATERTHAN;
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      return ExpressionType::COMPARE_GREATERTHANOREQUALTO;
+    case ExpressionType::COMPARE_GREATERTHAN:
+      return ExpressionType::COMPARE_LESSTHAN;
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      return ExpressionType::COMPARE_LESSTHANOREQUALTO;
+    default:
+      return compare_type;
+  }
+}
+
+}  // namespace
+
+//===--------------------------------------------------------------------===//
+// Graph
+//===--------------------------------------------------------------------===//
+
+struct JoinEnumerator::Relation {
+  storage::DataTable *table;
+
+  std::string name;
+
+  std::shared_ptr<const TableStats> stats;
+
+  // Rows of the table and rows left after the filters
+  double base_rows;
+  double rows;
+
+  // Conjuncts over the columns of this relation only
+  std::vector<const expression::AbstractExpression *> filters;
+
+  // Columns needed by the joins or above them
+  std::set<oid_t> needed_columns;
+
+  // Columns compared for equality with a constant by the filters
+  std::vector<oid_t> equality_columns;
+};
+
+struct JoinEnumerator::Conjunct {
+  const expression::AbstractExpression *expr;
+
+  RelationSet relations;
+
+  // Whether the conjunct is an equality of two columns of the same type,
+  // which can be a key of a hash, merge or index join
+  bool is_equi_join = false;
+  JoinColumn left_column;
+  JoinColumn right_column;
+
+  double selectivity;
+};
+
+enum class JoinAlgorithm {
+  SCAN,
+  NESTED_LOOP,
+  INDEX_NESTED_LOOP,
+  HASH,
+  MERGE,
+};
+
+struct JoinEnumerator::JoinPlan {
+  RelationSet relations;
+
+  JoinAlgorithm algorithm = JoinAlgorithm::SCAN;
+
+  double cardinality;
+
+  double cost;
+
+  // The scanned relation of a scan
+  size_t relation;
+
+  std::shared_ptr<JoinPlan> left;
+  std::shared_ptr<JoinPlan> right;
+
+  // The conjuncts evaluated by this join and the equi-join keys among them
+  std::vector<size_t> conjuncts;
+  std::vector<JoinColumn> left_keys;
+  std::vector<JoinColumn> right_keys;
+};
+
+JoinEnumerator::JoinEnumerator() {}
+
+JoinEnumerator::~JoinEnumerator() {}
+
+size_t JoinEnumerator::AddRelation(storage::DataTable *table,
+                                   const std::string &name) {
+  if (relations_.size() == sizeof(RelationSet) * 8) {
+    throw NotImplementedException("Too many tables in a join");
+  }
+
+  Relation relation;
+  relation.table = table;
+  relation.name = name;
+  relation.stats = StatsStorage::GetInstance().GetTableStats(table->GetOid());
+  relation.base_rows = std::max(
+      1.0, relation.stats != nullptr ? (double)relation.stats->num_rows
+                                     : (double)table->GetTupleCount());
+  relation.rows = relation.base_rows;
+  relations_.push_back(std::move(relation));
+  return relations_.size() - 1;
+}
+
+void JoinEnumerator::ResolveColumns(
+    expression::AbstractExpression *expr) const {
+  if (expr == nullptr) return;
+
+  // Columns first, functions and the types of the operators are filled in
+  // by the expression utilities once every column is known
+  std::vector<expression::AbstractExpression *> stack = {expr};
+  while (stack.empty() == false) {
+    auto current = stack.back();
+    stack.pop_back();
+    for (size_t child = 0; child < current->GetChildrenSize(); child++) {
+      stack.push_back(current->GetModifiableChild(child));
+    }
+    if (current->GetExpressionType() != ExpressionType::VALUE_TUPLE ||
+        current->GetValueType() != type::Type::INVALID) {
+      continue;
+    }
+
+    auto tuple_expr = static_cast<expression::TupleValueExpression *>(current);
+    auto column_name = tuple_expr->GetColumnName();
+    auto table_name = tuple_expr->GetTableName();
+    size_t relation_idx = relations_.size();
+    oid_t column_id = INVALID_OID;
+    for (size_t relation_itr = 0; relation_itr < relations_.size();
+         relation_itr++) {
+      auto &relation = relations_[relation_itr];
+      if (table_name.empty() == false && table_name != relation.name) {
+        continue;
+      }
+      auto relation_column_id =
+          relation.table->GetSchema()->GetColumnID(column_name);
+      if (relation_column_id == INVALID_OID) continue;
+      if (relation_idx != relations_.size()) {
+        throw Exception("Column " + column_name + " is ambiguous");
+      }
+      relation_idx = relation_itr;
+      column_id = relation_column_id;
+    }
+    if (relation_idx == relations_.size()) {
+      throw Exception("Column " + column_name + " not found");
+    }
+
+    if (tuple_expr->alias.size() > 0) {
+      tuple_expr->expr_name_ = tuple_expr->alias;
+    } else {
+      tuple_expr->expr_name_ = column_name;
+    }
+    auto column_type = relations_[relation_idx]
+                           .table->GetSchema()
+                           ->GetColumn(column_id)
+                           .GetType();
+    tuple_expr->SetTupleValueExpressionParams(column_type, column_id,
+                                              relation_idx);
+  }
+
+  std::vector<const catalog::Schema *> no_schemas;
+  expression::ExpressionUtil::TransformExpression(no_schemas, expr);
+}
+
+void JoinEnumerator::AddPredicate(
+    const expression::AbstractExpression *predicate) {
+  if (predicate == nullptr) return;
+
+  std::vector<const expression::AbstractExpression *> conjuncts;
+  GetConjuncts(predicate, conjuncts);
+  for (auto conjunct : conjuncts) {
+    predicates_.emplace_back(conjunct->Copy());
+    auto expr = predicates_.back().get();
+
+    RelationSet relations = 0;
+    GetRelations(expr, relations);
+
+    // Predicates over a single relation, and the ones over none, are
+    // evaluated by a scan
+    if ((relations & (relations - 1)) == 0) {
+      size_t relation_idx =
+          relations == 0 ? 0 : __builtin_ctzll(relations);
+      relations_[relation_idx].filters.push_back(expr);
+      continue;
+    }
+
+    Conjunct join_conjunct;
+    join_conjunct.expr = expr;
+    join_conjunct.relations = relations;
+    if (expr->GetExpressionType() == ExpressionType::COMPARE_EQUAL &&
+        expr->GetChild(0)->GetExpressionType() ==
+            ExpressionType::VALUE_TUPLE &&
+        expr->GetChild(1)->GetExpressionType() ==
+            ExpressionType::VALUE_TUPLE &&
+        expr->GetChild(0)->GetValueType() ==
+            expr->GetChild(1)->GetValueType()) {
+      auto left = static_cast<const expression::TupleValueExpression *>(
+          expr->GetChild(0));
+      auto right = static_cast<const expression::TupleValueExpression *>(
+          expr->GetChild(1));
+      join_conjunct.is_equi_join = true;
+      join_conjunct.left_column =
+          JoinColumn(left->GetTupleId(), left->GetColumnId());
+      join_conjunct.right_column =
+          JoinColumn(right->GetTupleId(), right->GetColumnId());
+    }
+
+    std::vector<JoinColumn> columns;
+    GetColumns(expr, columns);
+    for (auto &column : columns) {
+      relations_[column.first].needed_columns.insert(column.second);
+    }
+    conjuncts_.push_back(join_conjunct);
+  }
+}
+
+void JoinEnumerator::AddOutputColumns(
+    const expression::AbstractExpression *expr) {
+  std::vector<JoinColumn> columns;
+  GetColumns(expr, columns);
+  for (auto &column : columns) {
+    relations_[column.first].needed_columns.insert(column.second);
+  }
+}
+
+void JoinEnumerator::AddOutputColumns(size_t relation) {
+  auto column_count = relations_[relation].table->GetSchema()->GetColumnCount();
+  for (oid_t column_id = 0; column_id < column_count; column_id++) {
+    relations_[relation].needed_columns.insert(column_id);
+  }
+}
+
+//===--------------------------------------------------------------------===//
+// Cardinality
+//===--------------------------------------------------------------------===//
+
+double JoinEnumerator::EstimateFilterSelectivity(
+    const Relation &relation,
+    const expression::AbstractExpression *conjunct) const {
+  if (conjunct->GetChildrenSize() != 2) return default_selectivity;
+
+  auto compare_type = conjunct->GetExpressionType();
+  switch (compare_type) {
+    case ExpressionType::COMPARE_EQUAL:
+    case ExpressionType::COMPARE_NOTEQUAL:
+    case ExpressionType::COMPARE_LESSTHAN:
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+    case ExpressionType::COMPARE_GREATERTHAN:
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      break;
+    default:
+      return default_selectivity;
+  }
+
+  // A column compared with a constant or a parameter
+  auto column = conjunct->GetChild(0);
+  auto value = conjunct->GetChild(1);
+  if (column->GetExpressionType() != ExpressionType::VALUE_TUPLE) {
+    std::swap(column, value);
+    compare_type = MirrorComparison(compare_type);
+  }
+  if (column->GetExpressionType() != ExpressionType::VALUE_TUPLE ||
+      (value->GetExpressionType() != ExpressionType::VALUE_CONSTANT &&
+       value->GetExpressionType() != ExpressionType::VALUE_PARAMETER)) {
+    return default_selectivity;
+  }
+
+  auto column_id =
+      static_cast<const expression::TupleValueExpression *>(column)
+          ->GetColumnId();
+  const ColumnStats *column_stats = nullptr;
+  if (relation.stats != nullptr) {
+    column_stats = relation.stats->GetColumnStats(column_id);
+  }
+
+  if (column_stats != nullptr &&
+      value->GetExpressionType() == ExpressionType::VALUE_CONSTANT) {
+    auto constant =
+        static_cast<const expression::ConstantValueExpression *>(value)
+            ->GetValue();
+    return column_stats->EstimateSelectivity(compare_type, constant);
+  }
+
+  // The value of a parameter is not known when the plan is built
+  double equal_selectivity = default_equal_selectivity;
+  if (column_stats != nullptr && column_stats->num_distinct >= 1) {
+    equal_selectivity = 1 / column_stats->num_distinct;
+  }
+  switch (compare_type) {
+    case ExpressionType::COMPARE_EQUAL:
+      return equal_selectivity;
+    case ExpressionType::COMPARE_NOTEQUAL:
+      return 1 - equal_selectivity;
+    default:
+      return default_selectivity;
+  }
+}
+
+double JoinEnumerator::EstimateJoinSelectivity(
+    const Conjunct &conjunct) const {
+  if (conjunct.is_equi_join == false) return default_selectivity;
+
+  // Every value of the side with fewer distinct values finds a match on the
+  // other side. Without statistics a column is assumed to be a key.
+  double num_distinct = 1;
+  for (auto &column : {conjunct.left_column, conjunct.right_column}) {
+    auto &relation = relations_[column.first];
+    double column_distinct = relation.base_rows;
+    if (relation.stats != nullptr) {
+      auto column_stats = relation.stats->GetColumnStats(column.second);
+      if (column_stats != nullptr && column_stats->num_distinct >= 1) {
+        column_distinct = column_stats->num_distinct;
+      }
+    }
+    num_distinct = std::max(num_distinct, column_distinct);
+  }
+  return 1 / num_distinct;
+}
+
+double JoinEnumerator::GetCardinality(RelationSet relations) {
+  auto entry = cardinalities_.find(relations);
+  if (entry != cardinalities_.end()) return entry->second;
+
+  double cardinality = 1;
+  for (size_t relation_idx = 0; relation_idx < relations_.size();
+       relation_idx++) {
+    if (relations & ((RelationSet)1 << relation_idx)) {
+      cardinality *= relations_[relation_idx].rows;
+    }
+  }
+  for (auto &conjunct : conjuncts_) {
+    if ((conjunct.relations & ~relations) == 0) {
+      cardinality *= conjunct.selectivity;
+    }
+  }
+  cardinality = std::max(1.0, cardinality);
+  cardinalities_[relations] = cardinality;
+  return cardinality;
+}
+
+void JoinEnumerator::BuildGraph() {
+  for (auto &relation : relations_) {
+    double selectivity = 1;
+    for (auto filter : relation.filters) {
+      selectivity *= EstimateFilterSelectivity(relation, filter);
+    }
+    relation.rows = std::max(1.0, relation.base_rows * selectivity);
+
+    // Filtered relations also output a column, so that their rows count
+    relation.equality_columns.clear();
+    std::vector<type::Value> values;
+    for (auto filter : relation.filters) {
+      GetEqualityConstants(filter, relation.equality_columns, values);
+    }
+    if (relation.needed_columns.empty()) {
+      relation.needed_columns.insert(0);
+    }
+  }
+
+  // Edges join two relations. Predicates over more relations are evaluated
+  // once all of them are joined.
+  neighbors_.assign(relations_.size(), 0);
+  for (auto &conjunct : conjuncts_) {
+    conjunct.selectivity = EstimateJoinSelectivity(conjunct);
+    if (__builtin_popcountll(conjunct.relations) == 2) {
+      auto first = __builtin_ctzll(conjunct.relations);
+      auto second = 63 - __builtin_clzll(conjunct.relations);
+      neighbors_[first] |= (RelationSet)1 << second;
+      neighbors_[second] |= (RelationSet)1 << first;
+    }
+  }
+
+  // Relations that are not connected are joined by cross products, which
+  // may be placed between any two components of the graph
+  std::vector<RelationSet> components;
+  RelationSet visited = 0;
+  for (size_t relation_idx = 0; relation_idx < relations_.size();
+       relation_idx++) {
+    if (visited & ((RelationSet)1 << relation_idx)) continue;
+    RelationSet component = (RelationSet)1 << relation_idx;
+    RelationSet frontier = component;
+    while (frontier != 0) {
+      component |= frontier;
+      frontier = GetNeighbors(component, component);
+    }
+    visited |= component;
+    components.push_back(component);
+  }
+  for (size_t first = 0; first < components.size(); first++) {
+    for (size_t second = 0; second < components.size(); second++) {
+      if (first == second) continue;
+      for (size_t relation_idx = 0; relation_idx < relations_.size();
+           relation_idx++) {
+        if (components[first] & ((RelationSet)1 << relation_idx)) {
+          neighbors_[relation_idx] |= components[second];
+        }
+      }
+    }
+  }
+}
+
+JoinEnumerator::RelationSet JoinEnumerator::GetNeighbors(
+    RelationSet relations, RelationSet excluded) const {
+  RelationSet neighbors = 0;
+  for (size_t relation_idx = 0; relation_idx < relations_.size();
+       relation_idx++) {
+    if (relations & ((RelationSet)1 << relation_idx)) {
+      neighbors |= neighbors_[relation_idx];
+    }
+  }
+  return neighbors & ~excluded & ~relations;
+}
+
+//===--------------------------------------------------------------------===//
+// Costing
+//===--------------------------------------------------------------------===//
+
+std::shared_ptr<JoinEnumerator::JoinPlan> JoinEnumerator::JoinPlans(
+    std::shared_ptr<JoinPlan> left, std::shared_ptr<JoinPlan> right) {
+  auto relations = left->relations | right->relations;
+
+  auto join = std::make_shared<JoinPlan>();
+  join->relations = relations;
+  join->cardinality = GetCardinality(relations);
+  join->left = left;
+  join->right = right;
+
+  // The predicates that become evaluable with this join
+  for (size_t conjunct_idx = 0; conjunct_idx < conjuncts_.size();
+       conjunct_idx++) {
+    auto &conjunct = conjuncts_[conjunct_idx];
+    if ((conjunct.relations & ~relations) != 0 ||
+        (conjunct.relations & ~left->relations) == 0 ||
+        (conjunct.relations & ~right->relations) == 0) {
+      continue;
+    }
+    join->conjuncts.push_back(conjunct_idx);
+    if (conjunct.is_equi_join) {
+      bool left_first = (left->relations &
+                         ((RelationSet)1 << conjunct.left_column.first)) != 0;
+      join->left_keys.push_back(left_first ? conjunct.left_column
+                                           : conjunct.right_column);
+      join->right_keys.push_back(left_first ? conjunct.right_column
+                                            : conjunct.left_column);
+    }
+  }
+
+  double output = join->cardinality;
+  double children_cost = left->cost + right->cost;
+  bool has_keys = join->left_keys.empty() == false;
+
+  // Hash join, the right side is the build side. Without keys it computes
+  // the cross product with the right side materialized once.
+  join->algorithm = JoinAlgorithm::HASH;
+  double hash_cost = hash_build_factor * right->cardinality +
+                     left->cardinality;
+  if (right->cardinality > hash_cache_rows) {
+    hash_cost *= hash_miss_factor;
+  }
+  join->cost = children_cost + hash_cost + output;
+
+  // Merge join, the inputs are partitioned by key ranges and the partitions
+  // sorted and merged in parallel
+  if (has_keys) {
+    double input_rows = left->cardinality + right->cardinality;
+    double sort_threads = std::max(
+        1.0, std::min<double>(std::thread::hardware_concurrency(),
+                              input_rows / sort_rows_per_thread));
+    double cost = children_cost + input_rows + output +
+                  (SortCost(left->cardinality) +
+                   SortCost(right->cardinality)) /
+                      sort_threads;
+    if (cost < join->cost) {
+      join->algorithm = JoinAlgorithm::MERGE;
+      join->cost = cost;
+    }
+  }
+
+  // The nested loop joins execute the right side again for every left row,
+  // so it has to be a base relation
+  if (right->algorithm == JoinAlgorithm::SCAN) {
+    double cost = left->cost + left->cardinality * right->cost + output;
+    if (cost < join->cost) {
+      join->algorithm = JoinAlgorithm::NESTED_LOOP;
+      join->cost = cost;
+    }
+
+    // An index of the right relation all of whose columns are bound by the
+    // join keys, or by constants of its filters, is probed instead
+    auto &relation = relations_[right->relation];
+    std::vector<oid_t> bound_column_ids = relation.equality_columns;
+    for (auto &key : join->right_keys) {
+      bound_column_ids.push_back(key.second);
+    }
+    auto index_offset = FindLookupIndex(relation.table, bound_column_ids);
+    if (has_keys && index_offset != INVALID_OID) {
+      auto &key_attrs =
+          relation.table->GetIndex(index_offset)->GetMetadata()->GetKeyAttrs();
+      bool uses_keys = false;
+      for (auto &key : join->right_keys) {
+        uses_keys = uses_keys ||
+                    std::find(key_attrs.begin(), key_attrs.end(),
+                              key.second) != key_attrs.end();
+      }
+      double probe_cost = 1 + std::log2(relation.base_rows + 1);
+      cost = left->cost + left->cardinality * probe_cost + output;
+      if (uses_keys && cost < join->cost) {
+        join->algorithm = JoinAlgorithm::INDEX_NESTED_LOOP;
+        join->cost = cost;
+      }
+    }
+  }
+
+  return join;
+}
+
+//===--------------------------------------------------------------------===//
+// DPccp
+//===--------------------------------------------------------------------===//
+
+void JoinEnumerator::EnumerateCsgRec(RelationSet csg, RelationSet excluded) {
+  auto neighbors = GetNeighbors(csg, excluded);
+  if (neighbors == 0) return;
+
+  for (auto subset = neighbors; subset != 0;
+       subset = (subset - 1) & neighbors) {
+    if (best_plans_.count(csg | subset) != 0) {
+      EmitCsg(csg | subset);
+    }
+  }
+  for (auto subset = neighbors; subset != 0;
+       subset = (subset - 1) & neighbors) {
+    EnumerateCsgRec(csg | subset, excluded | neighbors);
+  }
+}
+
+void JoinEnumerator::EmitCsg(RelationSet csg) {
+  // Only relations after the smallest one of the sub-graph complement it,
+  // so that every pair is emitted once
+  auto first = __builtin_ctzll(csg);
+  RelationSet excluded = csg | (((RelationSet)2 << first) - 1);
+  auto neighbors = GetNeighbors(csg, excluded);
+
+  for (int relation_idx = (int)relations_.size() - 1; relation_idx >= 0;
+       relation_idx--) {
+    RelationSet cmp = (RelationSet)1 << relation_idx;
+    if ((neighbors & cmp) == 0) continue;
+    EmitCsgCmp(csg, cmp);
+    RelationSet lower = ((RelationSet)2 << relation_idx) - 1;
+    EnumerateCmpRec(csg, cmp, excluded | (lower & neighbors));
+  }
+}
+
+void JoinEnumerator::EnumerateCmpRec(RelationSet csg, RelationSet cmp,
+                                     RelationSet excluded) {
+  auto neighbors = GetNeighbors(cmp, excluded);
+  if (neighbors == 0) return;
+
+  for (auto subset = neighbors; subset != 0;
+       subset = (subset - 1) & neighbors) {
+    if (best_plans_.count(cmp | subset) != 0) {
+      EmitCsgCmp(csg, cmp | subset);
+    }
+  }
+  for (auto subset = neighbors; subset != 0;
+       subset = (subset - 1) & neighbors) {
+    EnumerateCmpRec(csg, cmp | subset, excluded | neighbors);
+  }
+}
+
+void JoinEnumerator::EmitCsgCmp(RelationSet left, RelationSet right) {
+  auto left_plan = best_plans_.find(left);
+  auto right_plan = best_plans_.find(right);
+  if (left_plan == best_plans_.end() || right_plan == best_plans_.end()) {
+    return;
+  }
+
+  auto &best_plan = best_plans_[left | right];
+  for (auto &join : {JoinPlans(left_plan->second, right_plan->second),
+                     JoinPlans(right_plan->second, left_plan->second)}) {
+    if (best_plan == nullptr || join->cost < best_plan->cost) {
+      best_plan = join;
+    }
+  }
+}
+
+void JoinEnumerator::EnumerateGreedy() {
+  std::vector<std::shared_ptr<JoinPlan>> plans;
+  for (size_t relation_idx = 0; relation_idx < relations_.size();
+       relation_idx++) {
+    plans.push_back(best_plans_[(RelationSet)1 << relation_idx]);
+  }
+
+  // Joins the pair of plans that is cheapest to join until one is left
+  while (plans.size() > 1) {
+    std::shared_ptr<JoinPlan> best_plan;
+    size_t best_left = 0, best_right = 0;
+    for (size_t left = 0; left < plans.size(); left++) {
+      for (size_t right = 0; right < plans.size(); right++) {
+        if (left == right ||
+            (GetNeighbors(plans[left]->relations, 0) &
+             plans[right]->relations) == 0) {
+          continue;
+        }
+        auto join = JoinPlans(plans[left], plans[right]);
+        if (best_plan == nullptr || join->cost < best_plan->cost) {
+          best_plan = join;
+          best_left = left;
+          best_right = right;
+        }
+      }
+    }
+    PL_ASSERT(best_plan != nullptr);
+    plans[std::min(best_left, best_right)] = best_plan;
+    plans.erase(plans.begin() + std::max(best_left, best_right));
+    best_plans_[best_plan->relations] = best_plan;
+  }
+}
+
+std::shared_ptr<OperatorExpression> JoinEnumerator::Enumerate() {
+  PL_ASSERT(relations_.empty() == false);
+  BuildGraph();
+
+  best_plans_.clear();
+  for (size_t relation_idx = 0; relation_idx < relations_.size();
+       relation_idx++) {
+    auto scan = std::make_shared<JoinPlan>();
+    scan->relations = (RelationSet)1 << relation_idx;
+    scan->relation = relation_idx;
+    scan->cardinality = GetCardinality(scan->relations);
+    scan->cost = relations_[relation_idx].base_rows;
+    best_plans_[scan->relations] = scan;
+  }
+
+  RelationSet all_relations = (((RelationSet)2 << (relations_.size() - 1)) - 1);
+  if (relations_.size() <= max_dp_relations) {
+    for (int relation_idx = (int)relations_.size() - 1; relation_idx >= 0;
+         relation_idx--) {
+      RelationSet relation = (RelationSet)1 << relation_idx;
+      EmitCsg(relation);
+      EnumerateCsgRec(relation, ((RelationSet)2 << relation_idx) - 1);
+    }
+  }
+  if (best_plans_.count(all_relations) == 0) {
+    EnumerateGreedy();
+  }
+
+  auto &best_plan = best_plans_[all_relations];
+  LOG_TRACE("Join of %lu relations costs %f for %f rows", relations_.size(),
+            best_plan->cost, best_plan->cardinality);
+
+  output_layout_.clear();
+  return BuildOperatorTree(*best_plan, output_layout_);
+}
+
+std::shared_ptr<OperatorExpression> JoinEnumerator::BuildOperatorTree(
+    const JoinPlan &plan, std::vector<JoinColumn> &layout) const {
+  if (plan.algorithm == JoinAlgorithm::SCAN) {
+    auto &relation = relations_[plan.relation];
+    std::vector<oid_t> column_ids(relation.needed_columns.begin(),
+                                  relation.needed_columns.end());
+    for (auto column_id : column_ids) {
+      layout.emplace_back(plan.relation, column_id);
+    }
+
+    std::shared_ptr<expression::AbstractExpression> predicate(
+        CopyConjunction(relation.filters));
+    if (predicate != nullptr) {
+      BindToTable(predicate.get());
+    }
+    return std::make_shared<OperatorExpression>(
+        PhysicalScan::make(relation.table, predicate, column_ids));
+  }
+
+  std::vector<JoinColumn> left_layout, right_layout;
+  auto left = BuildOperatorTree(*plan.left, left_layout);
+  auto right = BuildOperatorTree(*plan.right, right_layout);
+
+  // Hash and merge joins evaluate the equi-join keys themselves
+  std::vector<const expression::AbstractExpression *> exprs;
+  for (auto conjunct_idx : plan.conjuncts) {
+    auto &conjunct = conjuncts_[conjunct_idx];
+    if (conjunct.is_equi_join == false ||
+        plan.algorithm == JoinAlgorithm::NESTED_LOOP ||
+        plan.algorithm == JoinAlgorithm::INDEX_NESTED_LOOP) {
+      exprs.push_back(conjunct.expr);
+    }
+  }
+  std::shared_ptr<expression::AbstractExpression> predicate(
+      CopyConjunction(exprs));
+  if (predicate != nullptr) {
+    BindColumns(predicate.get(), left_layout, right_layout);
+  }
+
+  std::vector<oid_t> left_keys, right_keys;
+  for (size_t key_itr = 0; key_itr < plan.left_keys.size(); key_itr++) {
+    left_keys.push_back(GetPosition(left_layout, plan.left_keys[key_itr]));
+    right_keys.push_back(GetPosition(right_layout, plan.right_keys[key_itr]));
+  }
+
+  Operator op;
+  switch (plan.algorithm) {
+    case JoinAlgorithm::NESTED_LOOP:
+      op = PhysicalInnerNLJoin::make(predicate);
+      break;
+    case JoinAlgorithm::INDEX_NESTED_LOOP:
+      op = PhysicalInnerNLJoin::make(predicate, left_keys, right_keys, true);
+      break;
+    case JoinAlgorithm::HASH:
+      op = PhysicalInnerHashJoin::make(predicate, left_keys, right_keys);
+      break;
+    case JoinAlgorithm::MERGE:
+      op = PhysicalInnerMergeJoin::make(predicate, left_keys, right_keys);
+      break;
+    default:
+      PL_ASSERT(false);
+  }
+
+  layout = left_layout;
+  layout.insert(layout.end(), right_layout.begin(), right_layout.end());
+
+  auto join = std::make_shared<OperatorExpression>(op);
+  join->PushChild(left);
+  join->PushChild(right);
+  return join;
+}
+
+//===--------------------------------------------------------------------===//
+// Utilities
+//===--------------------------------------------------------------------===//
+
+void JoinEnumerator::BindColumns(expression::AbstractExpression *expr,
+                                 const std::vector<JoinColumn> &left_layout,
+                                 const std::vector<JoinColumn> &right_layout) {
+  if (expr->GetExpressionType() == ExpressionType::VALUE_TUPLE) {
+    auto tuple_expr = static_cast<expression::TupleValueExpression *>(expr);
+    JoinColumn column(tuple_expr->GetTupleId(), tuple_expr->GetColumnId());
+    auto position = GetPosition(left_layout, column);
+    int tuple_idx = 0;
+    if (position == left_layout.size()) {
+      position = GetPosition(right_layout, column);
+      tuple_idx = 1;
+      PL_ASSERT(position < right_layout.size());
+    }
+    tuple_expr->SetTupleValueExpressionParams(tuple_expr->GetValueType(),
+                                              position, tuple_idx);
+  }
+  for (size_t child = 0; child < expr->GetChildrenSize(); child++) {
+    BindColumns(expr->GetModifiableChild(child), left_layout, right_layout);
+  }
+}
+
+oid_t JoinEnumerator::FindLookupIndex(
+    storage::DataTable *table, const std::vector<oid_t> &bound_column_ids) {
+  oid_t best_index = INVALID_OID;
+  size_t best_key_count = 0;
+  for (oid_t index_offset = 0; index_offset < table->GetIndexCount();
+       index_offset++) {
+    auto index = table->GetIndex(index_offset);
+    if (index == nullptr || index->GetMetadata()->GetVisibility() == false) {
+      continue;
+    }
+
+    // The index with the most columns finds the fewest rows
+    auto &key_attrs = index->GetMetadata()->GetKeyAttrs();
+    bool bound = true;
+    for (auto key_attr : key_attrs) {
+      bound = bound &&
+              std::find(bound_column_ids.begin(), bound_column_ids.end(),
+                        key_attr) != bound_column_ids.end();
+    }
+    if (bound && key_attrs.size() > best_key_count) {
+      best_index = index_offset;
+      best_key_count = key_attrs.size();
+    }
+  }
+  return best_index;
+}
+
+void JoinEnumerator::GetEqualityConstants(
+    const expression::AbstractExpression *expr, std::vector<oid_t> &column_ids,
+    std::vector<type::Value> &values) {
+  if (expr->GetExpressionType() == ExpressionType::CONJUNCTION_AND) {
+    GetEqualityConstants(expr->GetChild(0), column_ids, values);
+    GetEqualityConstants(expr->GetChild(1), column_ids, values);
+    return;
+  }
+  if (expr->GetExpressionType() != ExpressionType::COMPARE_EQUAL) return;
+
+  auto column = expr->GetChild(0);
+  auto value = expr->GetChild(1);
+  if (column->GetExpressionType() != ExpressionType::VALUE_TUPLE) {
+    std::swap(column, value);
+  }
+  if (column->GetExpressionType() != ExpressionType::VALUE_TUPLE) return;
+
+  auto column_id =
+      static_cast<const expression::TupleValueExpression *>(column)
+          ->GetColumnId();
+  if (std::find(column_ids.begin(), column_ids.end(), column_id) !=
+      column_ids.end()) {
+    return;
+  }
+  if (value->GetExpressionType() == ExpressionType::VALUE_CONSTANT) {
+    column_ids.push_back(column_id);
+    values.push_back(
+        static_cast<const expression::ConstantValueExpression *>(value)
+            ->GetValue());
+  } else if (value->GetExpressionType() == ExpressionType::VALUE_PARAMETER) {
+    column_ids.push_back(column_id);
+    values.push_back(type::ValueFactory::GetParameterOffsetValue(
+                         static_cast<const expression::ParameterValueExpression
+                                         *>(value)->GetValueIdx()).Copy());
+  }
+}
+
+}  // namespace optimizer
+}  // namespace peloton
@@ -12,13 +12,21 @@
 
 #include "expression/expression_util.h"
 
+#include "index/index.h"
+#include "optimizer/join_enumerator.h"
 #include "optimizer/operator_expression.h"
 #include "optimizer/operator_to_plan_transformer.h"
 #include "optimizer/properties.h"
+#include "optimizer/simple_optimizer.h"
 #include "planner/hash_join_plan.h"
+#include "planner/hash_plan.h"
+#include "planner/index_scan_plan.h"
+#include "planner/merge_join_plan.h"
 #include "planner/nested_loop_join_plan.h"
 #include "planner/projection_plan.h"
 #include "planner/seq_scan_plan.h"
+#include "storage/data_table.h"
+#include "type/value_factory.h"
 
 namespace peloton {
 namespace optimizer {
@@ -35,9 +43,36 @@ OperatorToPlanTransformer::ConvertOpExpression(
   return std::move(output_plan_);
 }
 
+std::unique_ptr<planner::AbstractPlan>
+OperatorToPlanTransformer::ConvertOpExpressionTree(
+    std::shared_ptr<OperatorExpression> plan) {
+  requirements_ = nullptr;
+  required_input_props_ = nullptr;
+  VisitOpExpression(plan);
+  return std::move(output_plan_);
+}
+
 void OperatorToPlanTransformer::Visit(const PhysicalScan *op) {
   std::vector<oid_t> column_ids;
 
+  // The scan of a tree carries its columns and predicate, which may be
+  // answered with an index
+  if (requirements_ == nullptr) {
+    column_ids = op->column_ids_;
+    output_types_.clear();
+    for (auto column_id : column_ids) {
+      output_types_.push_back(
+          op->table_->GetSchema()->GetColumn(column_id).GetType());
+    }
+    std::unique_ptr<expression::AbstractExpression> predicate;
+    if (op->predicate_ != nullptr) {
+      predicate.reset(op->predicate_->Copy());
+    }
+    output_plan_ = SimpleOptimizer::CreateScanPlan(op->table_, column_ids,
+                                                   predicate.get(), false);
+    return;
+  }
+
   auto predicate_prop =
       requirements_->GetPropertyOfType(PropertyType::PREDICATE)
           ->As<PropertyPredicate>();
@@ -110,7 +145,27 @@ void OperatorToPlanTransformer::Visit(const PhysicalProject *) {
 
 void OperatorToPlanTransformer::Visit(const PhysicalFilter *) {}
 
-void OperatorToPlanTransformer::Visit(const PhysicalInnerNLJoin *) {}
+void OperatorToPlanTransformer::Visit(const PhysicalInnerNLJoin *op) {
+  if (requirements_ == nullptr) {
+    std::vector<oid_t> left_keys, right_keys;
+    if (op->index_lookup_) {
+      children_plans_[1] = CreateIndexLookupPlan(op, left_keys, right_keys);
+    }
+
+    std::unique_ptr<const expression::AbstractExpression> predicate;
+    if (op->join_predicate_ != nullptr) {
+      predicate.reset(op->join_predicate_->Copy());
+    }
+    std::shared_ptr<const catalog::Schema> schema;
+    std::unique_ptr<planner::AbstractPlan> join_plan(
+        new planner::NestedLoopJoinPlan(JoinType::INNER, std::move(predicate),
+                                        nullptr, schema, left_keys,
+                                        right_keys));
+    join_plan->AddChild(std::move(children_plans_[0]));
+    join_plan->AddChild(std::move(children_plans_[1]));
+    output_plan_ = std::move(join_plan);
+  }
+}
 
 void OperatorToPlanTransformer::Visit(const PhysicalLeftNLJoin *) {}
 
@@ -118,7 +173,32 @@ void OperatorToPlanTransformer::Visit(const PhysicalRightNLJoin *) {}
 
 void OperatorToPlanTransformer::Visit(const PhysicalOuterNLJoin *) {}
 
-void OperatorToPlanTransformer::Visit(const PhysicalInnerHashJoin *) {}
+void OperatorToPlanTransformer::Visit(const PhysicalInnerHashJoin *op) {
+  if (requirements_ == nullptr) {
+    // The right child is hashed on its keys and probed with the left keys
+    std::vector<std::unique_ptr<const expression::AbstractExpression>>
+        hash_keys;
+    for (auto right_key : op->right_keys_) {
+      hash_keys.emplace_back(expression::ExpressionUtil::TupleValueFactory(
+          children_types_[1][right_key], 0, right_key));
+    }
+    std::unique_ptr<planner::HashPlan> hash_plan(
+        new planner::HashPlan(hash_keys));
+    hash_plan->AddChild(std::move(children_plans_[1]));
+
+    std::unique_ptr<const expression::AbstractExpression> predicate;
+    if (op->join_predicate_ != nullptr) {
+      predicate.reset(op->join_predicate_->Copy());
+    }
+    std::shared_ptr<const catalog::Schema> schema;
+    std::unique_ptr<planner::AbstractPlan> join_plan(new planner::HashJoinPlan(
+        JoinType::INNER, std::move(predicate), nullptr, schema,
+        op->left_keys_));
+    join_plan->AddChild(std::move(children_plans_[0]));
+    join_plan->AddChild(std::move(hash_plan));
+    output_plan_ = std::move(join_plan);
+  }
+}
 
 void OperatorToPlanTransformer::Visit(const PhysicalLeftHashJoin *) {}
 
@@ -126,9 +206,125 @@ void OperatorToPlanTransformer::Visit(const PhysicalRightHashJoin *) {}
 
 void OperatorToPlanTransformer::Visit(const PhysicalOuterHashJoin *) {}
 
+void OperatorToPlanTransformer::Visit(const PhysicalInnerMergeJoin *op) {
+  if (requirements_ == nullptr) {
+    // The executor sorts the inputs on the keys itself
+    std::vector<planner::MergeJoinPlan::JoinClause> join_clauses;
+    for (size_t key_itr = 0; key_itr < op->left_keys_.size(); key_itr++) {
+      auto left_key = op->left_keys_[key_itr];
+      auto right_key = op->right_keys_[key_itr];
+      join_clauses.emplace_back(
+          expression::ExpressionUtil::TupleValueFactory(
+              children_types_[0][left_key], 0, left_key),
+          expression::ExpressionUtil::TupleValueFactory(
+              children_types_[1][right_key], 1, right_key),
+          false);
+    }
+
+    std::unique_ptr<const expression::AbstractExpression> predicate;
+    if (op->join_predicate_ != nullptr) {
+      predicate.reset(op->join_predicate_->Copy());
+    }
+    std::shared_ptr<const catalog::Schema> schema;
+    std::unique_ptr<planner::AbstractPlan> join_plan(
+        new planner::MergeJoinPlan(JoinType::INNER, std::move(predicate),
+                                   nullptr, schema, join_clauses, true));
+    join_plan->AddChild(std::move(children_plans_[0]));
+    join_plan->AddChild(std::move(children_plans_[1]));
+    output_plan_ = std::move(join_plan);
+  }
+}
+
+std::unique_ptr<planner::AbstractPlan>
+OperatorToPlanTransformer::CreateIndexLookupPlan(
+    const PhysicalInnerNLJoin *op, std::vector<oid_t> &left_keys,
+    std::vector<oid_t> &right_keys) {
+  auto scan = current_op_->Children()[1]->Op().As<PhysicalScan>();
+  PL_ASSERT(scan != nullptr);
+  auto table = scan->table_;
+
+  // The columns bound by the constants of the scan and by the join keys
+  std::vector<oid_t> constant_column_ids;
+  std::vector<type::Value> constant_values;
+  if (scan->predicate_ != nullptr) {
+    JoinEnumerator::GetEqualityConstants(
+        scan->predicate_.get(), constant_column_ids, constant_values);
+  }
+  std::vector<oid_t> bound_column_ids = constant_column_ids;
+  for (auto right_key : op->right_keys_) {
+    bound_column_ids.push_back(scan->column_ids_[right_key]);
+  }
+  auto index_offset = JoinEnumerator::FindLookupIndex(table, bound_column_ids);
+  PL_ASSERT(index_offset != INVALID_OID);
+  auto index = table->GetIndex(index_offset);
+
+  // The join keys get a placeholder that every left key replaces
+  std::vector<oid_t> key_column_ids;
+  std::vector<ExpressionType> expr_types;
+  std::vector<type::Value> values;
+  for (auto key_attr : index->GetMetadata()->GetKeyAttrs()) {
+    key_column_ids.push_back(key_attr);
+    expr_types.push_back(ExpressionType::COMPARE_EQUAL);
+
+    bool is_join_key = false;
+    for (size_t key_itr = 0; key_itr < op->right_keys_.size(); key_itr++) {
+      auto right_key = op->right_keys_[key_itr];
+      if (scan->column_ids_[right_key] == key_attr && is_join_key == false) {
+        left_keys.push_back(op->left_keys_[key_itr]);
+        right_keys.push_back(right_key);
+        is_join_key = true;
+      }
+    }
+    if (is_join_key) {
+      auto column_type = table->GetSchema()->GetColumn(key_attr).GetType();
+      values.push_back(
+          type::ValueFactory::GetZeroValueByType(column_type).Copy());
+    } else {
+      auto constant_itr = std::find(constant_column_ids.begin(),
+                                    constant_column_ids.end(), key_attr);
+      PL_ASSERT(constant_itr != constant_column_ids.end());
+      values.push_back(
+          constant_values[constant_itr - constant_column_ids.begin()]);
+    }
+  }
+
+  // The whole scan predicate is checked again on the rows the index finds
+  std::vector<expression::AbstractExpression *> runtime_keys;
+  planner::IndexScanPlan::IndexScanDesc index_scan_desc(
+      index, key_column_ids, expr_types, values, runtime_keys);
+  return std::unique_ptr<planner::AbstractPlan>(new planner::IndexScanPlan(
+      table, scan->predicate_.get(), scan->column_ids_, index_scan_desc));
+}
+
 void OperatorToPlanTransformer::VisitOpExpression(
     std::shared_ptr<OperatorExpression> op) {
+  // The children of a tree are converted first
+  std::vector<std::unique_ptr<planner::AbstractPlan>> children_plans;
+  std::vector<std::vector<type::Type::TypeId>> children_types;
+  if (requirements_ == nullptr) {
+    for (auto &child : op->Children()) {
+      VisitOpExpression(child);
+      children_plans.push_back(std::move(output_plan_));
+      children_types.push_back(std::move(output_types_));
+    }
+  }
+
+  current_op_ = op;
+  children_plans_ = std::move(children_plans);
+  children_types_ = std::move(children_types);
   op->Op().Accept(this);
+
+  // Joins output the columns of their children side by side
+  if (requirements_ == nullptr && children_types_.empty() == false) {
+    output_types_.clear();
+    for (auto &child_types : children_types_) {
+      output_types_.insert(output_types_.end(), child_types.begin(),
+                           child_types.end());
+    }
+  }
+  children_plans_.clear();
+  children_types_.clear();
+  current_op_.reset();
 }
 
 } /* namespace optimizer */
@@ -107,9 +107,14 @@ Operator LogicalLimit::make() {
 //===--------------------------------------------------------------------===//
 // Scan
 //===--------------------------------------------------------------------===//
-Operator PhysicalScan::make(storage::DataTable *table) {
+Operator PhysicalScan::make(
+    storage::DataTable *table,
+    std::shared_ptr<expression::AbstractExpression> predicate,
+    std::vector<oid_t> column_ids) {
   PhysicalScan *scan = new PhysicalScan;
   scan->table_ = table;
+  scan->predicate_ = predicate;
+  scan->column_ids_ = std::move(column_ids);
   return Operator(scan);
 }
 
@@ -146,8 +151,15 @@ Operator PhysicalFilter::make() {
 //===--------------------------------------------------------------------===//
 // InnerNLJoin
 //===--------------------------------------------------------------------===//
-Operator PhysicalInnerNLJoin::make() {
+Operator PhysicalInnerNLJoin::make(
+    std::shared_ptr<expression::AbstractExpression> join_predicate,
+    std::vector<oid_t> left_keys, std::vector<oid_t> right_keys,
+    bool index_lookup) {
   PhysicalInnerNLJoin *join = new PhysicalInnerNLJoin;
+  join->join_predicate_ = join_predicate;
+  join->left_keys_ = std::move(left_keys);
+  join->right_keys_ = std::move(right_keys);
+  join->index_lookup_ = index_lookup;
   return Operator(join);
 }
 
@@ -178,8 +190,26 @@ Operator PhysicalOuterNLJoin::make() {
 //===--------------------------------------------------------------------===//
 // InnerHashJoin
 //===--------------------------------------------------------------------===//
-Operator PhysicalInnerHashJoin::make() {
+Operator PhysicalInnerHashJoin::make(
+    std::shared_ptr<expression::AbstractExpression> join_predicate,
+    std::vector<oid_t> left_keys, std::vector<oid_t> right_keys) {
   PhysicalInnerHashJoin *join = new PhysicalInnerHashJoin;
+  join->join_predicate_ = join_predicate;
+  join->left_keys_ = std::move(left_keys);
+  join->right_keys_ = std::move(right_keys);
+  return Operator(join);
+}
+
+//===--------------------------------------------------------------------===//
+// InnerMergeJoin
+//===--------------------------------------------------------------------===//
+Operator PhysicalInnerMergeJoin::make(
+    std::shared_ptr<expression::AbstractExpression> join_predicate,
+    std::vector<oid_t> left_keys, std::vector<oid_t> right_keys) {
+  PhysicalInnerMergeJoin *join = new PhysicalInnerMergeJoin;
+  join->join_predicate_ = join_predicate;
+  join->left_keys_ = std::move(left_keys);
+  join->right_keys_ = std::move(right_keys);
   return Operator(join);
 }
 
@@ -287,6 +317,9 @@ std::string OperatorNode<PhysicalRightHashJoin>::name_ =
 template <>
 std::string OperatorNode<PhysicalOuterHashJoin>::name_ =
     "PhysicalOuterHashJoin";
+template <>
+std::string OperatorNode<PhysicalInnerMergeJoin>::name_ =
+    "PhysicalInnerMergeJoin";
 
 //===--------------------------------------------------------------------===//
 template <>
@@ -329,6 +362,8 @@ template <>
 OpType OperatorNode<PhysicalRightHashJoin>::type_ = OpType::RightHashJoin;
 template <>
 OpType OperatorNode<PhysicalOuterHashJoin>::type_ = OpType::OuterHashJoin;
+template <>
+OpType OperatorNode<PhysicalInnerMergeJoin>::type_ = OpType::InnerMergeJoin;
 
 //===--------------------------------------------------------------------===//
 template <typename T>
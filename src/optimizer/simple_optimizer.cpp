@@ -11,8 +11,11 @@
 //===----------------------------------------------------------------------===//
 
 #include "optimizer/simple_optimizer.h"
+#include "optimizer/join_enumerator.h"
+#include "optimizer/operator_to_plan_transformer.h"
 
 #include "parser/abstract_parse.h"
+#include "parser/analyze_statement.h"
 
 #include "catalog/catalog.h"
 #include "catalog/schema.h"
@@ -24,6 +27,7 @@
 #include "planner/abstract_plan.h"
 #include "planner/abstract_scan_plan.h"
 #include "planner/aggregate_plan.h"
+#include "planner/analyze_plan.h"
 #include "planner/copy_plan.h"
 #include "planner/create_plan.h"
 #include "planner/delete_plan.h"
@@ -43,6 +47,7 @@
 #include "common/logger.h"
 #include "type/value_factory.h"
 
+#include <algorithm>
 #include <memory>
 #include <unordered_map>
 
@@ -56,6 +61,52 @@ SimpleOptimizer::SimpleOptimizer(){};
 
 SimpleOptimizer::~SimpleOptimizer(){};
 
+// Whether the FROM clause is the ORDER_LINE and STOCK join of TPC-C's
+// Stock-Level transaction, which has a hand-written plan
+static bool IsHackingJoin(parser::TableRef* from_table) {
+  if (from_table->list == NULL || from_table->list->size() != 2) {
+    return false;
+  }
+  std::vector<std::string> table_names;
+  for (auto table_ref : *from_table->list) {
+    if (table_ref->type != TableReferenceType::NAME) return false;
+    table_names.push_back(table_ref->table_info_->table_name);
+  }
+  std::sort(table_names.begin(), table_names.end());
+  return table_names[0] == "order_line" && table_names[1] == "stock";
+}
+
+// Collects the tables of a FROM clause of inner joins and cross products in
+// order, and the conditions of the joins
+static void FlattenInnerJoins(
+    parser::TableRef* table_ref, std::vector<parser::TableRef*>& tables,
+    std::vector<expression::AbstractExpression*>& conditions) {
+  switch (table_ref->type) {
+    case TableReferenceType::NAME:
+      tables.push_back(table_ref);
+      break;
+    case TableReferenceType::CROSS_PRODUCT:
+      for (auto list_ref : *table_ref->list) {
+        FlattenInnerJoins(list_ref, tables, conditions);
+      }
+      break;
+    case TableReferenceType::JOIN:
+      if (table_ref->join->type != JoinType::INNER) {
+        throw NotImplementedException(
+            "Error: Outer joins of more than two tables are not supported");
+      }
+      FlattenInnerJoins(table_ref->join->left, tables, conditions);
+      FlattenInnerJoins(table_ref->join->right, tables, conditions);
+      if (table_ref->join->condition != nullptr) {
+        conditions.push_back(table_ref->join->condition);
+      }
+      break;
+    default:
+      throw NotImplementedException(
+          "Error: Sub-selects in FROM are not supported");
+  }
+}
+
 std::shared_ptr<planner::AbstractPlan> SimpleOptimizer::BuildPelotonPlanTree(
     const std::unique_ptr<parser::SQLStatementList>& parse_tree) {
   std::shared_ptr<planner::AbstractPlan> plan_tree;
@@ -96,28 +147,23 @@ std::shared_ptr<planner::AbstractPlan> SimpleOptimizer::BuildPelotonPlanTree(
       expression::AbstractExpression* having = nullptr;
 
       // The HACK to make the join in tpcc work. This is written by Joy Arulraj
-      if (select_stmt->from_table->list != NULL) {
-        LOG_TRACE("have join condition? %d",
-                  select_stmt->from_table->join != NULL);
-        LOG_TRACE("have sub select statement? %d",
-                  select_stmt->from_table->select != NULL);
-        try {
-          catalog::Catalog::GetInstance()->GetTableWithName(DEFAULT_DB_NAME,
-                                                            "order_line");
-          // auto child_SelectPlan = CreateHackingJoinPlan();
-          auto child_SelectPlan = CreateHackingNestedLoopJoinPlan(select_stmt);
-          child_plan = std::move(child_SelectPlan);
-          break;
-        } catch (Exception& e) {
-          throw NotImplementedException("Error: Joins are not implemented yet");
-        }
+      if (IsHackingJoin(select_stmt->from_table)) {
+        auto child_SelectPlan = CreateHackingNestedLoopJoinPlan(select_stmt);
+        child_plan = std::move(child_SelectPlan);
+        break;
       }
 
-      if (select_stmt->from_table->join != NULL) {
+      // Inner joins of any number of tables are ordered by cost, a single
+      // outer join is hashed
+      if (select_stmt->from_table->list != NULL ||
+          (select_stmt->from_table->join != NULL &&
+           select_stmt->from_table->join->type == JoinType::INNER)) {
         child_plan = CreateJoinPlan(select_stmt);
         break;
-        // throw NotImplementedException("Error: Joins are not implemented
-        // yet");
+      }
+      if (select_stmt->from_table->join != NULL) {
+        child_plan = CreateOuterJoinPlan(select_stmt);
+        break;
       }
 
       storage::DataTable* target_table =
@@ -497,6 +543,19 @@ std::shared_ptr<planner::AbstractPlan> SimpleOptimizer::BuildPelotonPlanTree(
       child_plan = std::move(CreateCopyPlan(copy_parse_tree));
     } break;
 
+    case StatementType::ANALYZE: {
+      LOG_TRACE("Adding Analyze plan...");
+      parser::AnalyzeStatement* analyze_parse_tree =
+          static_cast<parser::AnalyzeStatement*>(parse_tree2);
+      storage::DataTable* target_table = nullptr;
+      if (analyze_parse_tree->HasTable() == true) {
+        target_table = catalog::Catalog::GetInstance()->GetTableWithName(
+            analyze_parse_tree->GetDatabaseName(),
+            analyze_parse_tree->GetTableName());
+      }
+      child_plan.reset(new planner::AnalyzePlan(target_table));
+    } break;
+
     case StatementType::DELETE: {
       LOG_TRACE("Adding Delete plan...");
 
@@ -532,6 +591,7 @@ std::shared_ptr<planner::AbstractPlan> SimpleOptimizer::BuildPelotonPlanTree(
             new planner::IndexScanPlan(target_table,
                                        child_DeletePlan->GetPredicate(),
                                        columns, index_scan_desc, true));
+        SetPointLookupFlag(index_scan_node.get());
         LOG_TRACE("Index scan plan created");
 
         // Add index scan plan
@@ -632,6 +692,8 @@ std::shared_ptr<planner::AbstractPlan> SimpleOptimizer::BuildPelotonPlanTree(
             new planner::UpdatePlan(updateStmt, key_column_ids, expr_types,
                                     values, index_id));
         updateStmt->where = old_predicate;
+        SetPointLookupFlag(static_cast<planner::IndexScanPlan*>(
+            child_UpdatePlan->GetChildren()[0].get()));
 
         child_plan = std::move(child_UpdatePlan);
 
@@ -674,14 +736,24 @@ std::shared_ptr<planner::AbstractPlan> SimpleOptimizer::BuildPelotonPlanTree(
 std::unique_ptr<planner::AbstractPlan> SimpleOptimizer::CreateCopyPlan(
     parser::CopyStatement* copy_stmt) {
   std::string table_name(copy_stmt->cpy_table->GetTableName());
-  bool deserialize_parameters = false;
+
+  // Imports and exports of plain tables read or write the tile groups of the
+  // table directly, only the query metrics need a scan to deserialize them
+  bool is_import = copy_stmt->type == CopyType::IMPORT_CSV ||
+                   copy_stmt->type == CopyType::IMPORT_TSV;
+  if (is_import == true || table_name != QUERY_METRIC_NAME) {
+    auto target_table = catalog::Catalog::GetInstance()->GetTableWithName(
+        copy_stmt->cpy_table->GetDatabaseName(), table_name);
+    std::unique_ptr<planner::AbstractPlan> copy_plan(
+        new planner::CopyPlan(copy_stmt->file_path, target_table,
+                              copy_stmt->type, copy_stmt->delimiter));
+    return copy_plan;
+  }
 
   // If we're copying the query metric table, then we need to handle the
   // deserialization of prepared stmt parameters
-  if (table_name == QUERY_METRIC_NAME) {
-    LOG_DEBUG("Copying the query_metric table.");
-    deserialize_parameters = true;
-  }
+  LOG_DEBUG("Copying the query_metric table.");
+  bool deserialize_parameters = true;
 
   std::unique_ptr<planner::AbstractPlan> copy_plan(
       new planner::CopyPlan(copy_stmt->file_path, deserialize_parameters));
@@ -846,6 +918,7 @@ std::unique_ptr<planner::AbstractScan> SimpleOptimizer::CreateScanPlan(
   // Create plan node.
   std::unique_ptr<planner::IndexScanPlan> node(new planner::IndexScanPlan(
       target_table, predicate, column_ids, index_scan_desc, for_update));
+  SetPointLookupFlag(node.get());
   LOG_TRACE("Index scan plan created");
 
   return std::move(node);
@@ -1155,6 +1228,118 @@ std::shared_ptr<const peloton::catalog::Schema> CreateHackJoinSchema() {
 
 std::unique_ptr<planner::AbstractPlan> SimpleOptimizer::CreateJoinPlan(
     parser::SelectStatement* select_stmt) {
+  LOG_TRACE("Create Join Plan");
+  if (select_stmt->group_by != NULL || select_stmt->order != NULL ||
+      select_stmt->select_distinct) {
+    throw NotImplementedException(
+        "Error: GROUP BY, ORDER BY and DISTINCT over joins are not supported");
+  }
+
+  std::vector<parser::TableRef*> table_refs;
+  std::vector<expression::AbstractExpression*> conditions;
+  FlattenInnerJoins(select_stmt->from_table, table_refs, conditions);
+
+  // The columns of all clauses are resolved to the joined tables before the
+  // order is chosen, so that the scans only output the columns needed
+  JoinEnumerator enumerator;
+  std::vector<storage::DataTable*> tables;
+  for (auto table_ref : table_refs) {
+    auto table = catalog::Catalog::GetInstance()->GetTableWithName(
+        table_ref->GetDatabaseName(), table_ref->table_info_->table_name);
+    enumerator.AddRelation(table, table_ref->GetTableName());
+    tables.push_back(table);
+  }
+  if (select_stmt->where_clause != nullptr) {
+    conditions.push_back(select_stmt->where_clause);
+  }
+  for (auto condition : conditions) {
+    enumerator.ResolveColumns(condition);
+    enumerator.AddPredicate(condition);
+  }
+
+  auto& select_list = *select_stmt->getSelectList();
+  for (auto expr : select_list) {
+    if (expr->GetExpressionType() == ExpressionType::STAR) {
+      for (size_t relation = 0; relation < tables.size(); relation++) {
+        enumerator.AddOutputColumns(relation);
+      }
+      continue;
+    }
+    if (expression::ExpressionUtil::IsAggregateExpression(
+            expr->GetExpressionType())) {
+      throw NotImplementedException(
+          "Error: Aggregates over joins are not supported");
+    }
+    enumerator.ResolveColumns(expr);
+    enumerator.AddOutputColumns(expr);
+  }
+
+  OperatorToPlanTransformer transformer;
+  auto join_plan = transformer.ConvertOpExpressionTree(enumerator.Enumerate());
+  auto& layout = enumerator.GetOutputLayout();
+
+  // Project the select list out of the joined columns
+  TargetList tl = TargetList();
+  DirectMapList dml = DirectMapList();
+  std::vector<catalog::Column> output_table_columns;
+  std::vector<JoinColumn> no_columns;
+  oid_t column_idx = 0;
+  for (auto expr : select_list) {
+    if (expr->GetExpressionType() == ExpressionType::STAR) {
+      for (size_t relation = 0; relation < tables.size(); relation++) {
+        auto& columns = tables[relation]->GetSchema()->GetColumns();
+        for (oid_t column_id = 0; column_id < columns.size(); column_id++) {
+          auto position =
+              std::find(layout.begin(), layout.end(),
+                        JoinColumn(relation, column_id)) - layout.begin();
+          dml.push_back(
+              DirectMap(column_idx++, std::make_pair(0, (oid_t)position)));
+          output_table_columns.push_back(columns[column_id]);
+        }
+      }
+    } else if (expr->GetExpressionType() == ExpressionType::VALUE_TUPLE) {
+      auto tup_expr = (expression::TupleValueExpression*)expr;
+      JoinColumn column(tup_expr->GetTupleId(), tup_expr->GetColumnId());
+      auto position =
+          std::find(layout.begin(), layout.end(), column) - layout.begin();
+      dml.push_back(
+          DirectMap(column_idx++, std::make_pair(0, (oid_t)position)));
+      output_table_columns.push_back(
+          tables[column.first]->GetSchema()->GetColumn(column.second));
+    } else {
+      auto target = expr->Copy();
+      JoinEnumerator::BindColumns(target, layout, no_columns);
+      tl.push_back(Target(column_idx, target));
+      output_table_columns.push_back(catalog::Column(
+          expr->GetValueType(), type::Type::GetTypeSize(expr->GetValueType()),
+          "expr" + std::to_string(column_idx)));
+      column_idx++;
+    }
+  }
+
+  std::shared_ptr<const catalog::Schema> schema(
+      new catalog::Schema(output_table_columns));
+  std::unique_ptr<planner::ProjectInfo> proj_info(
+      new planner::ProjectInfo(std::move(tl), std::move(dml)));
+  std::unique_ptr<planner::AbstractPlan> projection_plan(
+      new planner::ProjectionPlan(std::move(proj_info), schema));
+  projection_plan->AddChild(std::move(join_plan));
+
+  if (select_stmt->limit == NULL) {
+    return projection_plan;
+  }
+  int offset = select_stmt->limit->offset;
+  if (offset < 0) {
+    offset = 0;
+  }
+  std::unique_ptr<planner::AbstractPlan> limit_plan(
+      new planner::LimitPlan(select_stmt->limit->limit, offset));
+  limit_plan->AddChild(std::move(projection_plan));
+  return limit_plan;
+}
+
+std::unique_ptr<planner::AbstractPlan> SimpleOptimizer::CreateOuterJoinPlan(
+    parser::SelectStatement* select_stmt) {
   // assuming no aggregation
 
   LOG_DEBUG("Create Join Plan");
@@ -1275,11 +1460,12 @@ std::unique_ptr<planner::AbstractPlan> SimpleOptimizer::CreateJoinPlan(
   LOG_DEBUG("Index scan column size: %ld\n", output_table_columns.size());
   LOG_DEBUG("Schema info: %s", schema->GetInfo().c_str());
   // // Create hash join plan node.
+  if (select_stmt->where_clause != nullptr) {
+    throw NotImplementedException(
+        "Error: WHERE over outer joins is not supported");
+  }
   std::unique_ptr<const peloton::expression::AbstractExpression> predicates =
       nullptr;
-  if (select_stmt->where_clause != nullptr)
-    predicates = std::unique_ptr<const peloton::expression::AbstractExpression>(
-        select_stmt->where_clause->Copy());
   std::unique_ptr<planner::HashJoinPlan> hash_join_plan_node(
       new planner::HashJoinPlan(join_type, std::move(predicates),
                                 std::move(proj_info), schema));
@@ -1290,6 +1476,34 @@ std::unique_ptr<planner::AbstractPlan> SimpleOptimizer::CreateJoinPlan(
   return std::move(hash_join_plan_node);
 }
 
+void SimpleOptimizer::SetPointLookupFlag(
+    planner::IndexScanPlan* index_scan_plan) {
+  auto index = index_scan_plan->GetIndex();
+  if (index->GetIndexType() != IndexConstraintType::PRIMARY_KEY ||
+      index_scan_plan->GetRunTimeKeys().empty() == false) {
+    return;
+  }
+
+  auto& key_column_ids = index_scan_plan->GetKeyColumnIds();
+  auto& expr_types = index_scan_plan->GetExprTypes();
+  for (auto expr_type : expr_types) {
+    if (expr_type != ExpressionType::COMPARE_EQUAL) return;
+  }
+
+  // Every key column has to be bound exactly once
+  auto& key_attrs = index->GetMetadata()->GetKeyAttrs();
+  if (key_column_ids.size() != key_attrs.size()) return;
+  for (auto key_attr : key_attrs) {
+    if (std::count(key_column_ids.begin(), key_column_ids.end(), key_attr) !=
+        1) {
+      return;
+    }
+  }
+
+  LOG_TRACE("Index scan is a primary key point lookup");
+  index_scan_plan->SetPointLookup(true);
+}
+
 void SimpleOptimizer::SetIndexScanFlag(planner::AbstractPlan* select_plan,
                                        uint64_t limit, uint64_t offset,
                                        bool descent) {
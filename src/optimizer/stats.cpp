@@ -13,12 +13,270 @@
 
 #include "optimizer/stats.h"
 
+#include <algorithm>
+#include <sstream>
+
 namespace peloton {
 namespace optimizer {
 
+namespace {
+
+// Selectivity of a comparison nothing is known about
+const double default_selectivity = 1.0 / 3;
+
+inline bool LessThan(const type::Value &left, const type::Value &right) {
+  return left.CompareLessThan(right) == type::CMP_TRUE;
+}
+
+inline bool Equals(const type::Value &left, const type::Value &right) {
+  return left.CompareEquals(right) == type::CMP_TRUE;
+}
+
+// The value of a numeric type as a double, false for other types
+bool GetNumericValue(const type::Value &value, double &result) {
+  switch (value.GetTypeId()) {
+    case type::Type::TINYINT:
+      result = value.GetAs<int8_t>();
+      return true;
+    case type::Type::SMALLINT:
+      result = value.GetAs<int16_t>();
+      return true;
+    case type::Type::INTEGER:
+      result = value.GetAs<int32_t>();
+      return true;
+    case type::Type::BIGINT:
+      result = value.GetAs<int64_t>();
+      return true;
+    case type::Type::DECIMAL:
+      result = value.GetAs<double>();
+      return true;
+    case type::Type::TIMESTAMP:
+      result = value.GetAs<uint64_t>();
+      return true;
+    default:
+      return false;
+  }
+}
+
+inline double Clamp(double selectivity) {
+  return std::min(std::max(selectivity, 0.0), 1.0);
+}
+
+}  // namespace
+
+//===--------------------------------------------------------------------===//
+// ColumnStats
+//===--------------------------------------------------------------------===//
+
+void ColumnStats::Build(std::vector<type::Value> &sample_values,
+                        size_t num_rows, size_t null_count,
+                        double num_distinct) {
+  this->num_rows = num_rows;
+  null_fraction = (num_rows > 0) ? static_cast<double>(null_count) / num_rows
+                                 : 0;
+  this->num_distinct = num_distinct;
+  most_common_values.clear();
+  most_common_frequencies.clear();
+  histogram_bounds.clear();
+  if (sample_values.empty() == true) {
+    return;
+  }
+
+  std::sort(sample_values.begin(), sample_values.end(), LessThan);
+
+  // Runs of equal values as (first position, length)
+  std::vector<std::pair<size_t, size_t>> runs;
+  for (size_t value_itr = 0; value_itr < sample_values.size(); value_itr++) {
+    if (value_itr == 0 ||
+        Equals(sample_values[value_itr], sample_values[value_itr - 1]) ==
+            false) {
+      runs.emplace_back(value_itr, 0);
+    }
+    runs.back().second++;
+  }
+
+  double sample_size = sample_values.size();
+  bool sample_is_complete = (sample_values.size() == num_rows - null_count);
+  if (sample_is_complete == true) {
+    this->num_distinct = runs.size();
+  } else {
+    this->num_distinct = std::max(num_distinct, double(runs.size()));
+  }
+
+  // Values that repeat clearly more often than the average value are kept
+  // with their frequency. If the sample is the whole column, every value is
+  // exact and may be kept.
+  size_t min_count = 1;
+  if (sample_is_complete == false) {
+    min_count = std::max<size_t>(2, 1.25 * sample_size / this->num_distinct);
+  }
+  std::vector<size_t> candidates;
+  for (size_t run_itr = 0; run_itr < runs.size(); run_itr++) {
+    if (runs[run_itr].second >= min_count) {
+      candidates.push_back(run_itr);
+    }
+  }
+  std::stable_sort(candidates.begin(), candidates.end(),
+                   [&runs](size_t left, size_t right) {
+                     return runs[left].second > runs[right].second;
+                   });
+  if (candidates.size() > max_most_common_values) {
+    candidates.resize(max_most_common_values);
+  }
+
+  std::vector<bool> is_common(runs.size(), false);
+  for (auto run_itr : candidates) {
+    is_common[run_itr] = true;
+    most_common_values.push_back(sample_values[runs[run_itr].first]);
+    most_common_frequencies.push_back(runs[run_itr].second / sample_size *
+                                      (1 - null_fraction));
+  }
+
+  // The bounds split the remaining values into buckets of equal size
+  std::vector<type::Value> remaining_values;
+  for (size_t run_itr = 0; run_itr < runs.size(); run_itr++) {
+    if (is_common[run_itr] == true) {
+      continue;
+    }
+    auto &run = runs[run_itr];
+    for (size_t value_itr = run.first; value_itr < run.first + run.second;
+         value_itr++) {
+      remaining_values.push_back(std::move(sample_values[value_itr]));
+    }
+  }
+  if (remaining_values.size() < 2) {
+    histogram_bounds = std::move(remaining_values);
+    return;
+  }
+  size_t bucket_count =
+      std::min(max_histogram_buckets, remaining_values.size() - 1);
+  for (size_t bound_itr = 0; bound_itr <= bucket_count; bound_itr++) {
+    size_t position = bound_itr * (remaining_values.size() - 1) / bucket_count;
+    histogram_bounds.push_back(remaining_values[position]);
+  }
+}
+
+double ColumnStats::GetHistogramFraction() const {
+  double fraction = 1 - null_fraction;
+  for (auto frequency : most_common_frequencies) {
+    fraction -= frequency;
+  }
+  return std::max(fraction, 0.0);
+}
+
+double ColumnStats::EstimateEqualSelectivity(const type::Value &value) const {
+  if (value.IsNull() == true) {
+    return 0;
+  }
+  for (size_t value_itr = 0; value_itr < most_common_values.size();
+       value_itr++) {
+    if (Equals(most_common_values[value_itr], value) == true) {
+      return most_common_frequencies[value_itr];
+    }
+  }
+
+  // The other values are assumed to be equally frequent
+  double other_distinct =
+      std::max(num_distinct - most_common_values.size(), 1.0);
+  return Clamp(GetHistogramFraction() / other_distinct);
+}
+
+double ColumnStats::EstimateLessThanSelectivity(const type::Value &value,
+                                                bool or_equal) const {
+  if (value.IsNull() == true) {
+    return 0;
+  }
+
+  double selectivity = 0;
+  for (size_t value_itr = 0; value_itr < most_common_values.size();
+       value_itr++) {
+    auto &common_value = most_common_values[value_itr];
+    if (LessThan(common_value, value) == true ||
+        (or_equal == true && Equals(common_value, value) == true)) {
+      selectivity += most_common_frequencies[value_itr];
+    }
+  }
+
+  double histogram_fraction = GetHistogramFraction();
+  if (histogram_fraction == 0) {
+    return Clamp(selectivity);
+  }
+  if (histogram_bounds.size() < 2) {
+    double below = 0.5;
+    if (histogram_bounds.size() == 1) {
+      below = LessThan(histogram_bounds[0], value) ? 1 : 0;
+    }
+    return Clamp(selectivity + histogram_fraction * below);
+  }
+
+  // Position of the value in the histogram, interpolated inside its bucket
+  // for numeric types
+  double below;
+  if (LessThan(value, histogram_bounds.front()) == true) {
+    below = 0;
+  } else if (LessThan(histogram_bounds.back(), value) == true) {
+    below = 1;
+  } else {
+    auto upper = std::lower_bound(histogram_bounds.begin(),
+                                  histogram_bounds.end(), value, LessThan);
+    size_t bucket = std::max<size_t>(upper - histogram_bounds.begin(), 1) - 1;
+    double bucket_position = 0.5;
+    double low, high, target;
+    if (GetNumericValue(histogram_bounds[bucket], low) == true &&
+        GetNumericValue(histogram_bounds[bucket + 1], high) == true &&
+        GetNumericValue(value, target) == true && high > low) {
+      bucket_position = (target - low) / (high - low);
+    }
+    below = (bucket + Clamp(bucket_position)) / (histogram_bounds.size() - 1);
+  }
+  return Clamp(selectivity + histogram_fraction * below);
+}
+
+double ColumnStats::EstimateSelectivity(ExpressionType compare_type,
+                                        const type::Value &value) const {
+  double non_null_fraction = 1 - null_fraction;
+  switch (compare_type) {
+    case ExpressionType::COMPARE_EQUAL:
+      return EstimateEqualSelectivity(value);
+    case ExpressionType::COMPARE_NOTEQUAL:
+      return Clamp(non_null_fraction - EstimateEqualSelectivity(value));
+    case ExpressionType::COMPARE_LESSTHAN:
+      return EstimateLessThanSelectivity(value, false);
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      return EstimateLessThanSelectivity(value, true);
+    case ExpressionType::COMPARE_GREATERTHAN:
+      return Clamp(non_null_fraction -
+                   EstimateLessThanSelectivity(value, true));
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      return Clamp(non_null_fraction -
+                   EstimateLessThanSelectivity(value, false));
+    default:
+      return default_selectivity;
+  }
+}
+
+const std::string ColumnStats::GetInfo() const {
+  std::ostringstream os;
+  os << "Column " << column_id << ": rows=" << num_rows
+     << " null_fraction=" << null_fraction
+     << " num_distinct=" << num_distinct
+     << " most_common_values=" << most_common_values.size()
+     << " histogram_bounds=" << histogram_bounds.size();
+  return os.str();
+}
+
 //===--------------------------------------------------------------------===//
-// Stats
+// TableStats
 //===--------------------------------------------------------------------===//
 
+const ColumnStats *TableStats::GetColumnStats(oid_t column_id) const {
+  for (auto &stats : column_stats) {
+    if (stats->column_id == column_id) {
+      return stats.get();
+    }
+  }
+  return nullptr;
+}
+
 } /* namespace optimizer */
 } /* namespace peloton */
@@ -0,0 +1,210 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// stats_collector.cpp
+//
+// Identification: src/optimizer/stats_collector.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "optimizer/stats_collector.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "catalog/schema.h"
+#include "common/logger.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "storage/data_table.h"
+#include "storage/tile.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace optimizer {
+
+namespace {
+
+// Tables smaller than this many tile groups per thread are not split further
+const size_t min_tile_groups_per_thread = 4;
+
+// Where a column of a tile group lives
+struct ColumnLocation {
+  storage::Tile *tile;
+  size_t offset;
+  type::Type::TypeId type;
+  bool is_inlined;
+};
+
+// Values read from a tile point into it, a sampled value has to outlive the
+// tile group
+type::Value GetOwnedValue(const type::Value &value) {
+  if (value.IsNull() == true) {
+    return value;
+  }
+  switch (value.GetTypeId()) {
+    case type::Type::VARCHAR: {
+      size_t length = value.GetLength();
+      return type::ValueFactory::GetVarcharValue(
+          std::string(value.GetData(), length > 0 ? length - 1 : 0));
+    }
+    case type::Type::VARBINARY:
+      return type::ValueFactory::GetVarbinaryValue(
+          reinterpret_cast<const unsigned char *>(value.GetData()),
+          value.GetLength(), true);
+    default:
+      return value.Copy();
+  }
+}
+
+}  // namespace
+
+size_t StatsCollector::thread_count_ = std::thread::hardware_concurrency();
+
+size_t StatsCollector::sample_size_ = StatsCollector::default_sample_size;
+
+StatsCollector::StatsCollector(storage::DataTable *table) : table_(table) {}
+
+void StatsCollector::SetThreadCount(size_t thread_count) {
+  thread_count_ = std::max<size_t>(thread_count, 1);
+}
+
+void StatsCollector::SetSampleSize(size_t sample_size) {
+  sample_size_ = std::max<size_t>(sample_size, 1);
+}
+
+std::shared_ptr<TableStats> StatsCollector::Collect(
+    concurrency::Transaction *txn) {
+  auto schema = table_->GetSchema();
+  size_t column_count = schema->GetColumnCount();
+
+  // Changes made while scanning count towards the next refresh
+  std::shared_ptr<TableStats> table_stats(
+      new TableStats(table_->GetDatabaseOid(), table_->GetOid()));
+  table_stats->modification_count = table_->GetModificationCount();
+
+  size_t tile_group_count = table_->GetTileGroupCount();
+  size_t thread_count = std::min(
+      thread_count_, std::max<size_t>(
+                         tile_group_count / min_tile_groups_per_thread, 1));
+
+  std::vector<std::unique_ptr<PartialStats>> partial_stats;
+  for (size_t thread_itr = 0; thread_itr < thread_count; thread_itr++) {
+    partial_stats.emplace_back(
+        new PartialStats(column_count, sample_size_, thread_itr));
+  }
+
+  std::vector<std::thread> scanners;
+  for (size_t thread_itr = 1; thread_itr < thread_count; thread_itr++) {
+    scanners.emplace_back(&StatsCollector::ScanTileGroups, this, txn,
+                          thread_itr * tile_group_count / thread_count,
+                          (thread_itr + 1) * tile_group_count / thread_count,
+                          partial_stats[thread_itr].get());
+  }
+  ScanTileGroups(txn, 0, tile_group_count / thread_count,
+                 partial_stats[0].get());
+  for (auto &scanner : scanners) {
+    scanner.join();
+  }
+
+  auto &merged = *partial_stats[0];
+  for (size_t thread_itr = 1; thread_itr < thread_count; thread_itr++) {
+    auto &partial = *partial_stats[thread_itr];
+    merged.row_count += partial.row_count;
+    merged.sample.Merge(partial.sample);
+    for (size_t column_itr = 0; column_itr < column_count; column_itr++) {
+      merged.sketches[column_itr].Merge(partial.sketches[column_itr]);
+      merged.null_counts[column_itr] += partial.null_counts[column_itr];
+    }
+  }
+
+  table_stats->num_rows = merged.row_count;
+  std::vector<type::Value> sample_values;
+  for (size_t column_itr = 0; column_itr < column_count; column_itr++) {
+    sample_values.clear();
+    for (auto &row : merged.sample.GetRows()) {
+      if (row[column_itr].IsNull() == false) {
+        sample_values.push_back(row[column_itr]);
+      }
+    }
+
+    std::unique_ptr<ColumnStats> column_stats(
+        new ColumnStats(column_itr, schema->GetType(column_itr)));
+    column_stats->Build(sample_values, merged.row_count,
+                        merged.null_counts[column_itr],
+                        merged.sketches[column_itr].Estimate());
+    table_stats->column_stats.push_back(std::move(column_stats));
+  }
+
+  LOG_DEBUG("Collected statistics of table %s: %lu rows, %lu sampled, %lu "
+            "threads",
+            table_->GetName().c_str(), merged.row_count,
+            merged.sample.GetRows().size(), thread_count);
+  return table_stats;
+}
+
+void StatsCollector::ScanTileGroups(concurrency::Transaction *txn,
+                                    size_t begin, size_t end,
+                                    PartialStats *partial_stats) {
+  auto &transaction_manager =
+      concurrency::TransactionManagerFactory::GetInstance();
+  size_t column_count = table_->GetSchema()->GetColumnCount();
+
+  std::vector<ColumnLocation> columns;
+  for (size_t tile_group_itr = begin; tile_group_itr < end; tile_group_itr++) {
+    auto tile_group = table_->GetTileGroup(tile_group_itr);
+    auto tile_group_header = tile_group->GetHeader();
+    oid_t active_tuple_count = tile_group->GetNextTupleSlot();
+
+    columns.clear();
+    for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+      oid_t tile_offset, tile_column;
+      tile_group->LocateTileAndColumn(column_itr, tile_offset, tile_column);
+      auto tile = tile_group->GetTile(tile_offset);
+      auto tile_schema = tile->GetSchema();
+      columns.push_back({tile, tile_schema->GetOffset(tile_column),
+                         tile_schema->GetType(tile_column),
+                         tile_schema->IsInlined(tile_column)});
+    }
+
+    for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
+      if (transaction_manager.IsVisible(txn, tile_group_header, tuple_id) !=
+          VisibilityType::OK) {
+        continue;
+      }
+      partial_stats->row_count++;
+
+      // Only rows that make it into the sample are copied
+      int64_t sample_slot = partial_stats->sample.Offer();
+      TupleSample::Row row;
+      if (sample_slot >= 0) {
+        row.reserve(column_count);
+      }
+
+      for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+        auto &column = columns[column_itr];
+        auto value = column.tile->GetValueFast(tuple_id, column.offset,
+                                               column.type, column.is_inlined);
+        if (value.IsNull() == true) {
+          partial_stats->null_counts[column_itr]++;
+        } else {
+          partial_stats->sketches[column_itr].Add(value);
+        }
+        if (sample_slot >= 0) {
+          row.push_back(GetOwnedValue(value));
+        }
+      }
+
+      if (sample_slot >= 0) {
+        partial_stats->sample.SetRow(sample_slot, std::move(row));
+      }
+    }
+  }
+}
+
+}  // End optimizer namespace
+}  // End peloton namespace
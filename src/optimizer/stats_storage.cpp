@@ -0,0 +1,171 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// stats_storage.cpp
+//
+// Identification: src/optimizer/stats_storage.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "optimizer/stats_storage.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#include "catalog/catalog.h"
+#include "common/logger.h"
+#include "optimizer/stats_collector.h"
+#include "storage/data_table.h"
+#include "storage/database.h"
+#include "type/ephemeral_pool.h"
+
+namespace peloton {
+namespace optimizer {
+
+namespace {
+
+// A value of a list, quoted if it could be taken for the list syntax
+void AppendListValue(std::string &list, const std::string &value) {
+  bool needs_quotes = value.empty();
+  for (auto ch : value) {
+    if (ch == ',' || ch == '{' || ch == '}' || ch == '"' || ch == '\\' ||
+        ch == ' ') {
+      needs_quotes = true;
+      break;
+    }
+  }
+  if (needs_quotes == false) {
+    list += value;
+    return;
+  }
+
+  list += '"';
+  for (auto ch : value) {
+    if (ch == '"' || ch == '\\') {
+      list += '\\';
+    }
+    list += ch;
+  }
+  list += '"';
+}
+
+std::string FormatValueList(const std::vector<type::Value> &values) {
+  std::string list = "{";
+  for (size_t value_itr = 0; value_itr < values.size(); value_itr++) {
+    if (value_itr > 0) {
+      list += ',';
+    }
+    AppendListValue(list, values[value_itr].ToString());
+  }
+  list += '}';
+  return list;
+}
+
+std::string FormatFrequencyList(const std::vector<double> &frequencies) {
+  std::string list = "{";
+  char buffer[32];
+  for (size_t frequency_itr = 0; frequency_itr < frequencies.size();
+       frequency_itr++) {
+    if (frequency_itr > 0) {
+      list += ',';
+    }
+    snprintf(buffer, sizeof(buffer), "%.6g", frequencies[frequency_itr]);
+    list += buffer;
+  }
+  list += '}';
+  return list;
+}
+
+}  // namespace
+
+StatsStorage::StatsStorage() : pool_(new type::EphemeralPool()) {}
+
+StatsStorage &StatsStorage::GetInstance() {
+  static StatsStorage stats_storage;
+  return stats_storage;
+}
+
+std::shared_ptr<const TableStats> StatsStorage::AnalyzeTable(
+    storage::DataTable *table, concurrency::Transaction *txn) {
+  StatsCollector collector(table);
+  std::shared_ptr<const TableStats> table_stats = collector.Collect(txn);
+
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  StoreTableStats(*table_stats, txn);
+  table_stats_[table->GetOid()] = table_stats;
+  LOG_TRACE("Analyzed table %s", table->GetName().c_str());
+  return table_stats;
+}
+
+size_t StatsStorage::AnalyzeStaleTables(concurrency::Transaction *txn) {
+  auto catalog = catalog::Catalog::GetInstance();
+  size_t analyzed_count = 0;
+
+  auto database_count = catalog->GetDatabaseCount();
+  for (oid_t database_offset = 0; database_offset < database_count;
+       database_offset++) {
+    auto database = catalog->GetDatabaseWithOffset(database_offset);
+    if (database->GetDBName() == CATALOG_DATABASE_NAME) {
+      continue;
+    }
+
+    auto table_count = database->GetTableCount();
+    for (oid_t table_offset = 0; table_offset < table_count; table_offset++) {
+      auto table = database->GetTable(table_offset);
+      if (IsStale(table) == true) {
+        AnalyzeTable(table, txn);
+        analyzed_count++;
+      }
+    }
+  }
+  return analyzed_count;
+}
+
+std::shared_ptr<const TableStats> StatsStorage::GetTableStats(
+    oid_t table_id) {
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  auto entry = table_stats_.find(table_id);
+  if (entry == table_stats_.end()) {
+    return nullptr;
+  }
+  return entry->second;
+}
+
+bool StatsStorage::IsStale(storage::DataTable *table) {
+  auto table_stats = GetTableStats(table->GetOid());
+  if (table_stats == nullptr) {
+    return true;
+  }
+
+  double modification_count =
+      table->GetModificationCount() - table_stats->modification_count;
+  double min_modifications = stale_min_modifications;
+  double fraction = stale_modification_fraction;
+  return modification_count >=
+         std::max(min_modifications, fraction * table_stats->num_rows);
+}
+
+void StatsStorage::StoreTableStats(const TableStats &table_stats,
+                                   concurrency::Transaction *txn) {
+  auto column_stats_table = catalog::Catalog::GetInstance()->GetTableWithName(
+      CATALOG_DATABASE_NAME, COLUMN_STATS_NAME);
+
+  catalog::DeleteTuple(column_stats_table, table_stats.table_id, txn);
+  for (auto &column_stats : table_stats.column_stats) {
+    auto tuple = catalog::GetColumnStatsCatalogTuple(
+        column_stats_table->GetSchema(), table_stats.table_id,
+        table_stats.database_id, column_stats->column_id,
+        table_stats.num_rows, table_stats.modification_count,
+        column_stats->null_fraction, column_stats->num_distinct,
+        FormatValueList(column_stats->most_common_values),
+        FormatFrequencyList(column_stats->most_common_frequencies),
+        FormatValueList(column_stats->histogram_bounds), pool_.get());
+    catalog::InsertTuple(column_stats_table, std::move(tuple), txn);
+  }
+}
+
+}  // End optimizer namespace
+}  // End peloton namespace
@@ -13,15 +13,109 @@
 
 #include "optimizer/tuple_sample.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "common/macros.h"
+
 namespace peloton {
 namespace optimizer {
 
 //===--------------------------------------------------------------------===//
 // TupleSample
 //===--------------------------------------------------------------------===//
-TupleSample::TupleSample(std::vector<Column *> columns,
-                         storage::TileGroup *sampled_tuples)
-    : columns(columns), sampled_tuples(sampled_tuples) {}
+TupleSample::TupleSample(size_t capacity, uint64_t seed)
+    : capacity_(capacity), random_(seed) {
+  PL_ASSERT(capacity > 0);
+  rows_.reserve(capacity);
+}
+
+double TupleSample::NextUniform() {
+  // Never 0, its log is taken
+  std::uniform_real_distribution<double> uniform(
+      std::numeric_limits<double>::min(), 1.0);
+  return uniform(random_);
+}
+
+void TupleSample::ComputeNextSampled() {
+  // Algorithm L: the gap to the next sampled row is drawn directly, rows in
+  // between cost a comparison only
+  weight_ *= std::exp(std::log(NextUniform()) / capacity_);
+  DrawGap();
+}
+
+void TupleSample::DrawGap() {
+  double gap = std::floor(std::log(NextUniform()) / std::log1p(-weight_));
+  next_sampled_ = seen_count_ + static_cast<size_t>(std::min(gap, 1e18)) + 1;
+}
+
+int64_t TupleSample::Offer() {
+  seen_count_++;
+  if (rows_.size() < capacity_) {
+    rows_.emplace_back();
+    if (rows_.size() == capacity_) {
+      ComputeNextSampled();
+    }
+    return rows_.size() - 1;
+  }
+
+  if (seen_count_ < next_sampled_) {
+    return -1;
+  }
+  std::uniform_int_distribution<size_t> slot(0, capacity_ - 1);
+  ComputeNextSampled();
+  return slot(random_);
+}
+
+void TupleSample::SetRow(int64_t slot, Row &&row) {
+  PL_ASSERT(slot >= 0 && static_cast<size_t>(slot) < rows_.size());
+  rows_[slot] = std::move(row);
+}
+
+void TupleSample::Merge(TupleSample &other) {
+  PL_ASSERT(capacity_ == other.capacity_);
+
+  // Both samples are uniform, so are their prefixes after shuffling. The
+  // merged sample draws from either side in proportion to the rows it still
+  // stands for, as if sampling without replacement from the union.
+  std::shuffle(rows_.begin(), rows_.end(), random_);
+  std::shuffle(other.rows_.begin(), other.rows_.end(), random_);
+
+  size_t remaining = seen_count_;
+  size_t other_remaining = other.seen_count_;
+  size_t taken = 0;
+  size_t other_taken = 0;
+  size_t target_size = std::min(capacity_, rows_.size() + other.rows_.size());
+
+  std::vector<Row> rows;
+  rows.reserve(capacity_);
+  while (rows.size() < target_size) {
+    std::uniform_int_distribution<size_t> pick(
+        0, remaining + other_remaining - 1);
+    bool from_this = (other_taken == other.rows_.size()) ||
+                     (taken < rows_.size() && pick(random_) < remaining);
+    if (from_this == true) {
+      rows.push_back(std::move(rows_[taken++]));
+      remaining--;
+    } else {
+      rows.push_back(std::move(other.rows_[other_taken++]));
+      other_remaining--;
+    }
+  }
+
+  rows_ = std::move(rows);
+  seen_count_ += other.seen_count_;
+  other.rows_.clear();
+  other.seen_count_ = 0;
+
+  // Continue sampling as if the merged rows had been offered here, the
+  // acceptance threshold is set to its expected value
+  if (rows_.size() == capacity_) {
+    weight_ = static_cast<double>(capacity_) / (seen_count_ + 1);
+    DrawGap();
+  }
+}
 
 } /* namespace optimizer */
 } /* namespace peloton */
@@ -16,12 +16,50 @@
 #include "parser/parser.h"
 #include "parser/sql_parser.h"
 #include "parser/sql_scanner.h"
+#include "common/arena.h"
 #include "common/exception.h"
 #include "type/types.h"
 
+// Defined in the user code section of sql_scanner.l
+void parser_reset_scanner(yyscan_t scanner);
+
 namespace peloton {
 namespace parser {
 
+namespace {
+
+// The scanner of a thread, set up by its first parse and reused after that
+class ThreadScanner {
+ public:
+  ThreadScanner() {
+    if (yylex_init(&scanner_)) {
+      scanner_ = nullptr;
+    }
+  }
+
+  ~ThreadScanner() {
+    if (scanner_ != nullptr) {
+      yylex_destroy(scanner_);
+    }
+  }
+
+  yyscan_t Get() const { return scanner_; }
+
+ private:
+  yyscan_t scanner_ = nullptr;
+};
+
+yyscan_t GetScanner() {
+  static thread_local ThreadScanner thread_scanner;
+  if (thread_scanner.Get() == nullptr) {
+    // couldn't initialize
+    throw ParserException("Parser :: Error when initializing lexer!\n");
+  }
+  return thread_scanner.Get();
+}
+
+}  // namespace
+
 Parser::Parser(){
 
 }
@@ -31,27 +69,27 @@ Parser::~Parser(){
 }
 
 SQLStatementList* Parser::ParseSQLString(const char* text) {
-  SQLStatementList* result;
-  yyscan_t scanner;
+  SQLStatementList* result = nullptr;
+  yyscan_t scanner = GetScanner();
   YY_BUFFER_STATE state;
 
-  if (yylex_init(&scanner)) {
-    // couldn't initialize
-    throw ParserException("Parser :: Error when initializing lexer!\n");
-    return NULL;
-  }
+  // All nodes built by the grammar go to one arena, which the statement
+  // list releases in one go
+  std::unique_ptr<Arena> arena(new Arena());
+  {
+    Arena::Scope arena_scope(arena.get());
+    parser_reset_scanner(scanner);
+    state = yy_scan_string(text, scanner);
 
-  state = yy_scan_string(text, scanner);
-
-  if (parser_parse(&result, scanner)) {
-    // Returns an error stmt object
+    // Returns an error stmt object on failure
+    parser_parse(&result, scanner);
     yy_delete_buffer(state, scanner);
-    yylex_destroy(scanner);
-    return result;
   }
 
-  yy_delete_buffer(state, scanner);
-  yylex_destroy(scanner);
+  if (result != nullptr) {
+    LOG_TRACE("Parse tree arena: %lu bytes", arena->GetAllocatedBytes());
+    result->arena = std::move(arena);
+  }
   return result;
 }
 
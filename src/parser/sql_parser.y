@@ -158,6 +158,7 @@ struct PARSER_CUST_LTYPE {
 	peloton::parser::ExecuteStatement*     exec_stmt;
 	peloton::parser::TransactionStatement* txn_stmt;
 	peloton::parser::CopyStatement* 	   copy_stmt;
+	peloton::parser::AnalyzeStatement*     analyze_stmt;
 
 	peloton::parser::TableRef* table;
 	peloton::parser::TableInfo* table_info;
@@ -196,7 +197,7 @@ struct PARSER_CUST_LTYPE {
 %token DATABASE SMALLINT VARCHAR FOREIGN TINYINT CASCADE COLUMNS CONTROL DEFAULT EXECUTE EXPLAIN EXTRACT
 %token INTEGER NATURAL PREPARE PRIMARY SCHEMAS DECIMAL
 %token SPATIAL VIRTUAL BEFORE COLUMN CREATE DELETE DIRECT 
-%token BIGINT DOUBLE ESCAPE EXCEPT EXISTS GLOBAL HAVING
+%token BIGINT BINARY DOUBLE ESCAPE EXCEPT EXISTS GLOBAL HAVING
 %token INSERT ISNULL OFFSET RENAME SCHEMA SELECT SORTED
 %token COMMIT TABLES UNIQUE UNLOAD UPDATE VALUES AFTER ALTER CROSS STATS
 %token FLOAT BEGIN DELTA GROUP INDEX INNER LIMIT LOCAL MERGE MINUS ORDER COUNT
@@ -222,6 +223,7 @@ struct PARSER_CUST_LTYPE {
 %type <drop_stmt>	drop_statement
 %type <txn_stmt>    transaction_statement
 %type <copy_stmt>   copy_statement
+%type <analyze_stmt> analyze_statement
 %type <sval> 		opt_alias alias
 %type <bval> 		opt_not_exists opt_exists opt_distinct opt_notnull opt_primary opt_unique opt_update
 %type <uval>		opt_join_type column_type opt_column_width opt_index_type
@@ -308,6 +310,7 @@ preparable_statement:
 	|	execute_statement { $$ = $1; }
 	|	transaction_statement { $$ = $1; }	
 	|	copy_statement { $$ = $1; }
+	|	analyze_statement { $$ = $1; }
 	;
 
 
@@ -842,7 +845,7 @@ parameter_expr:
 table_ref:
 		table_ref_atomic
 	|	table_ref_atomic ',' table_ref_commalist {
-			$3->push_back($1);
+			$3->insert($3->begin(), $1);
 			auto tbl = new TableRef(peloton::TableReferenceType::CROSS_PRODUCT);
 			tbl->list = $3;
 			$$ = tbl;
@@ -918,6 +921,15 @@ join_clause:
 			$$->join->right = $4;
 			$$->join->condition = $6;
 		}
+	|	join_clause opt_join_type JOIN join_table ON join_condition
+		{
+			$$ = new TableRef(peloton::TableReferenceType::JOIN);
+			$$->join = new JoinDefinition();
+			$$->join->type = (peloton::JoinType) $2;
+			$$->join->left = $1;
+			$$->join->right = $4;
+			$$->join->condition = $6;
+		}
 		;
 
 opt_join_type:
@@ -948,6 +960,8 @@ join_condition:
 /******************************
  * Copy Statement
  * COPY catalog_db.query_metric TO '/home/user/query_metric.csv' DELIMITER ','
+ * COPY foo FROM '/home/user/foo.csv' DELIMITER ','
+ * COPY foo TO '/home/user/foo.dump' WITH BINARY
  * TODO: Nested query like below is not supported yet
  * COPY (SELECT id FROM A WHERE val = 1) TO '/path/file.csv' DELIMITER ';'
  ******************************/
@@ -962,6 +976,35 @@ copy_statement:
 			$$->delimiter = *($6);
 			delete $6;
 		}
+	|	COPY table_ref_name TO STRING WITH BINARY {
+			$$ = new CopyStatement(peloton::CopyType::EXPORT_BINARY);
+			$$->cpy_table = $2;
+			$$->file_path = $4;
+		}
+	|	COPY table_ref_name FROM STRING DELIMITER STRING {
+			$$ = new CopyStatement(peloton::CopyType::IMPORT_CSV);
+			$$->cpy_table = $2;
+			$$->file_path = $4;
+			$$->delimiter = *($6);
+			delete $6;
+		}
+	;
+
+
+/******************************
+ * Analyze Statement
+ * ANALYZE foo
+ * ANALYZE
+ ******************************/
+
+analyze_statement:
+		ANALYZE table_name {
+			$$ = new AnalyzeStatement();
+			$$->table_info_ = $2;
+		}
+	|	ANALYZE {
+			$$ = new AnalyzeStatement();
+		}
 	;
 
 
@@ -19,7 +19,7 @@ namespace stats {
 void AccessMetric::Aggregate(AbstractMetric &source) {
   PL_ASSERT(source.GetType() == ACCESS_METRIC);
 
-  auto access_metric = static_cast<AccessMetric &>(source);
+  auto &access_metric = static_cast<AccessMetric &>(source);
   for (size_t i = 0; i < NUM_COUNTERS; ++i) {
     access_counters_[i].Aggregate(
         static_cast<CounterMetric &>(access_metric.GetAccessCounter(i)));
@@ -21,6 +21,7 @@
 #include "statistics/counter_metric.h"
 #include "storage/database.h"
 #include "storage/tile_group.h"
+#include "util/string_util.h"
 
 namespace peloton {
 namespace stats {
@@ -33,21 +34,25 @@ CuckooMap<std::thread::id, std::shared_ptr<BackendStatsContext>> &
 }
 
 BackendStatsContext* BackendStatsContext::GetInstance() {
+  // Fast path: the context of this thread has already been resolved
+  static thread_local BackendStatsContext* thread_context = nullptr;
+  if (thread_context != nullptr) {
+    return thread_context;
+  }
 
   // Each thread gets a backend stats context
   std::thread::id this_id = std::this_thread::get_id();
   std::shared_ptr<BackendStatsContext> result(nullptr);
   auto &stats_context_map = GetBackendContextMap();
   if (stats_context_map.Find(this_id, result) == false) {
-    result.reset(new BackendStatsContext(LATENCY_MAX_HISTORY_THREAD, true));
+    result.reset(new BackendStatsContext(true));
     stats_context_map.Insert(this_id, result);
   }
-  return result.get();
+  thread_context = result.get();
+  return thread_context;
 }
 
-BackendStatsContext::BackendStatsContext(size_t max_latency_history,
-                                         bool regiser_to_aggregator)
-    : txn_latencies_(LATENCY_METRIC, max_latency_history) {
+BackendStatsContext::BackendStatsContext(bool regiser_to_aggregator) {
   std::thread::id this_id = std::this_thread::get_id();
   thread_id_ = this_id;
 
@@ -67,20 +72,31 @@ BackendStatsContext::~BackendStatsContext() {}
 // Returns the table metric with the given database ID and table ID
 TableMetric* BackendStatsContext::GetTableMetric(oid_t database_id,
                                                  oid_t table_id) {
-  if (table_metrics_.find(table_id) == table_metrics_.end()) {
-    table_metrics_[table_id] = std::unique_ptr<TableMetric>(
-        new TableMetric{TABLE_METRIC, database_id, table_id});
+  // Only the owning thread inserts, so the lookup itself needs no lock
+  auto table_itr = table_metrics_.find(table_id);
+  if (table_itr != table_metrics_.end()) {
+    return table_itr->second.get();
   }
-  return table_metrics_[table_id].get();
+  TableMetric* table_metric =
+      new TableMetric{TABLE_METRIC, database_id, table_id};
+  metric_map_lock_.Lock();
+  table_metrics_[table_id].reset(table_metric);
+  metric_map_lock_.Unlock();
+  return table_metric;
 }
 
 // Returns the database metric with the given database ID
 DatabaseMetric* BackendStatsContext::GetDatabaseMetric(oid_t database_id) {
-  if (database_metrics_.find(database_id) == database_metrics_.end()) {
-    database_metrics_[database_id] = std::unique_ptr<DatabaseMetric>(
-        new DatabaseMetric{DATABASE_METRIC, database_id});
+  auto database_itr = database_metrics_.find(database_id);
+  if (database_itr != database_metrics_.end()) {
+    return database_itr->second.get();
   }
-  return database_metrics_[database_id].get();
+  DatabaseMetric* database_metric =
+      new DatabaseMetric{DATABASE_METRIC, database_id};
+  metric_map_lock_.Lock();
+  database_metrics_[database_id].reset(database_metric);
+  metric_map_lock_.Unlock();
+  return database_metric;
 }
 
 // Returns the index metric with the given database ID, table ID, and
@@ -107,60 +123,14 @@ LatencyMetric& BackendStatsContext::GetTxnLatencyMetric() {
   return txn_latencies_;
 }
 
-void BackendStatsContext::IncrementTableReads(oid_t tile_group_id) {
-  oid_t table_id =
-      catalog::Manager::GetInstance().GetTileGroup(tile_group_id)->GetTableId();
-  oid_t database_id = catalog::Manager::GetInstance()
-                          .GetTileGroup(tile_group_id)
-                          ->GetDatabaseId();
-  auto table_metric = GetTableMetric(database_id, table_id);
-  PL_ASSERT(table_metric != nullptr);
-  table_metric->GetTableAccess().IncrementReads();
-  if (ongoing_query_metric_ != nullptr) {
-    ongoing_query_metric_->GetQueryAccess().IncrementReads();
-  }
-}
-
-void BackendStatsContext::IncrementTableInserts(oid_t tile_group_id) {
-  oid_t table_id =
-      catalog::Manager::GetInstance().GetTileGroup(tile_group_id)->GetTableId();
-  oid_t database_id = catalog::Manager::GetInstance()
-                          .GetTileGroup(tile_group_id)
-                          ->GetDatabaseId();
-  auto table_metric = GetTableMetric(database_id, table_id);
+TableMetric* BackendStatsContext::LookupTableMetric(oid_t tile_group_id) {
+  auto tile_group =
+      catalog::Manager::GetInstance().GetTileGroup(tile_group_id);
+  PL_ASSERT(tile_group != nullptr);
+  auto table_metric =
+      GetTableMetric(tile_group->GetDatabaseId(), tile_group->GetTableId());
   PL_ASSERT(table_metric != nullptr);
-  table_metric->GetTableAccess().IncrementInserts();
-  if (ongoing_query_metric_ != nullptr) {
-    ongoing_query_metric_->GetQueryAccess().IncrementInserts();
-  }
-}
-
-void BackendStatsContext::IncrementTableUpdates(oid_t tile_group_id) {
-  oid_t table_id =
-      catalog::Manager::GetInstance().GetTileGroup(tile_group_id)->GetTableId();
-  oid_t database_id = catalog::Manager::GetInstance()
-                          .GetTileGroup(tile_group_id)
-                          ->GetDatabaseId();
-  auto table_metric = GetTableMetric(database_id, table_id);
-  PL_ASSERT(table_metric != nullptr);
-  table_metric->GetTableAccess().IncrementUpdates();
-  if (ongoing_query_metric_ != nullptr) {
-    ongoing_query_metric_->GetQueryAccess().IncrementUpdates();
-  }
-}
-
-void BackendStatsContext::IncrementTableDeletes(oid_t tile_group_id) {
-  oid_t table_id =
-      catalog::Manager::GetInstance().GetTileGroup(tile_group_id)->GetTableId();
-  oid_t database_id = catalog::Manager::GetInstance()
-                          .GetTileGroup(tile_group_id)
-                          ->GetDatabaseId();
-  auto table_metric = GetTableMetric(database_id, table_id);
-  PL_ASSERT(table_metric != nullptr);
-  table_metric->GetTableAccess().IncrementDeletes();
-  if (ongoing_query_metric_ != nullptr) {
-    ongoing_query_metric_->GetQueryAccess().IncrementDeletes();
-  }
+  return table_metric;
 }
 
 void BackendStatsContext::IncrementIndexReads(size_t read_count,
@@ -223,6 +193,19 @@ void BackendStatsContext::InitQueryMetric(
   // TODO currently all queries belong to DEFAULT_DB
   ongoing_query_metric_.reset(new QueryMetric(
       QUERY_METRIC, statement->GetQueryString(), params, DEFAULT_DB_ID));
+
+  auto query_type = StringUtil::Upper(statement->GetQueryType());
+  if (query_type == "SELECT") {
+    ongoing_query_type_ = QUERY_LATENCY_SELECT;
+  } else if (query_type == "INSERT") {
+    ongoing_query_type_ = QUERY_LATENCY_INSERT;
+  } else if (query_type == "UPDATE") {
+    ongoing_query_type_ = QUERY_LATENCY_UPDATE;
+  } else if (query_type == "DELETE") {
+    ongoing_query_type_ = QUERY_LATENCY_DELETE;
+  } else {
+    ongoing_query_type_ = QUERY_LATENCY_OTHER;
+  }
 }
 
 //===--------------------------------------------------------------------===//
@@ -231,20 +214,30 @@ void BackendStatsContext::InitQueryMetric(
 
 void BackendStatsContext::Aggregate(BackendStatsContext& source) {
   // Aggregate all global metrics
-  txn_latencies_.Aggregate(source.txn_latencies_);
-  txn_latencies_.ComputeLatencies();
-
-  // Aggregate all per-database metrics
+  auto latency_metrics = GetLatencyMetrics();
+  auto source_latency_metrics = source.GetLatencyMetrics();
+  for (size_t i = 0; i < latency_metrics.size(); ++i) {
+    latency_metrics[i]->Aggregate(*source_latency_metrics[i]);
+    latency_metrics[i]->ComputeLatencies();
+  }
+  version_chain_lengths_.Merge(source.version_chain_lengths_);
+  gc_background_reclaimed_.Aggregate(source.gc_background_reclaimed_);
+  gc_inline_reclaimed_.Aggregate(source.gc_inline_reclaimed_);
+
+  // Aggregate all per-database and per-table metrics. The counters are read
+  // without synchronization; the lock only keeps the source maps stable
+  // while its worker may be adding new entries.
+  source.metric_map_lock_.Lock();
   for (auto& database_item : source.database_metrics_) {
     GetDatabaseMetric(database_item.first)->Aggregate(*database_item.second);
   }
 
-  // Aggregate all per-table metrics
   for (auto& table_item : source.table_metrics_) {
     GetTableMetric(table_item.second->GetDatabaseId(),
                    table_item.second->GetTableId())
         ->Aggregate(*table_item.second);
   }
+  source.metric_map_lock_.Unlock();
 
   // Aggregate all per-index metrics
   for (auto id : index_ids_) {
@@ -266,7 +259,12 @@ void BackendStatsContext::Aggregate(BackendStatsContext& source) {
 }
 
 void BackendStatsContext::Reset() {
-  txn_latencies_.Reset();
+  for (auto latency_metric : GetLatencyMetrics()) {
+    latency_metric->Reset();
+  }
+  version_chain_lengths_.Reset();
+  gc_background_reclaimed_.Reset();
+  gc_inline_reclaimed_.Reset();
 
   for (auto& database_item : database_metrics_) {
     database_item.second->Reset();
@@ -286,10 +284,7 @@ void BackendStatsContext::Reset() {
     oid_t database_id = database->GetOid();
 
     // Reset database metrics
-    if (database_metrics_.find(database_id) == database_metrics_.end()) {
-      database_metrics_[database_id] = std::unique_ptr<DatabaseMetric>(
-          new DatabaseMetric{DATABASE_METRIC, database_id});
-    }
+    GetDatabaseMetric(database_id);
 
     // Reset table metrics
     oid_t num_tables = database->GetTableCount();
@@ -297,10 +292,7 @@ void BackendStatsContext::Reset() {
       auto table = database->GetTable(j);
       oid_t table_id = table->GetOid();
 
-      if (table_metrics_.find(table_id) == table_metrics_.end()) {
-        table_metrics_[table_id] = std::unique_ptr<TableMetric>(
-            new TableMetric{TABLE_METRIC, database_id, table_id});
-      }
+      GetTableMetric(database_id, table_id);
 
       // Reset indexes metrics
       oid_t num_indexes = table->GetIndexCount();
@@ -321,7 +313,23 @@ void BackendStatsContext::Reset() {
 std::string BackendStatsContext::ToString() const {
   std::stringstream ss;
 
-  ss << txn_latencies_.GetInfo() << std::endl;
+  ss << txn_latencies_.GetInfo();
+  for (auto& query_latency : query_latencies_) {
+    ss << query_latency.GetInfo();
+  }
+  ss << commit_latencies_.GetInfo();
+  ss << fsync_latencies_.GetInfo();
+  ss << gc_pause_latencies_.GetInfo();
+  ss << "VERSION CHAIN LENGTH: [ ";
+  ss << "count=" << version_chain_lengths_.GetCount();
+  ss << ", average=" << version_chain_lengths_.GetMean();
+  ss << ", 99th-%-tile=" << version_chain_lengths_.GetPercentile(99);
+  ss << ", max=" << version_chain_lengths_.GetMax();
+  ss << " ]" << std::endl;
+  ss << "GC RECLAIMED VERSIONS: [ ";
+  ss << "background=" << gc_background_reclaimed_.GetInfo();
+  ss << ", inline=" << gc_inline_reclaimed_.GetInfo();
+  ss << " ]" << std::endl << std::endl;
 
   for (auto& database_item : database_metrics_) {
     oid_t database_id = database_item.second->GetDatabaseId();
@@ -359,12 +367,23 @@ std::string BackendStatsContext::ToString() const {
 void BackendStatsContext::CompleteQueryMetric() {
   if (ongoing_query_metric_ != nullptr) {
     ongoing_query_metric_->GetProcessorMetric().RecordTime();
-    ongoing_query_metric_->GetQueryLatency().RecordLatency();
+    double latency = ongoing_query_metric_->GetQueryLatency().RecordLatency();
+    query_latencies_[ongoing_query_type_].RecordLatency(latency);
     completed_query_metrics_.Enqueue(ongoing_query_metric_);
     ongoing_query_metric_.reset();
     LOG_TRACE("Ongoing query completed");
   }
 }
 
+std::vector<LatencyMetric*> BackendStatsContext::GetLatencyMetrics() {
+  std::vector<LatencyMetric*> latency_metrics{
+      &txn_latencies_, &commit_latencies_, &fsync_latencies_,
+      &gc_pause_latencies_};
+  for (auto& query_latency : query_latencies_) {
+    latency_metrics.push_back(&query_latency);
+  }
+  return latency_metrics;
+}
+
 }  // namespace stats
 }  // namespace peloton
@@ -16,13 +16,15 @@
 namespace peloton {
 namespace stats {
 
-CounterMetric::CounterMetric(MetricType type) : AbstractMetric(type) {
-  count_ = 0;
-}
+CounterMetric::CounterMetric(MetricType type)
+    : AbstractMetric(type), count_(0) {}
+
+CounterMetric::CounterMetric(const CounterMetric &other)
+    : AbstractMetric(other.GetType()), count_(other.GetCounter()) {}
 
 void CounterMetric::Aggregate(AbstractMetric &source) {
   PL_ASSERT(source.GetType() == COUNTER_METRIC);
-  count_ += static_cast<CounterMetric &>(source).GetCounter();
+  Increment(static_cast<CounterMetric &>(source).GetCounter());
 }
 
 }  // namespace stats
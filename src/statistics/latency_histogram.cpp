@@ -0,0 +1,158 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// latency_histogram.cpp
+//
+// Identification: src/statistics/latency_histogram.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cmath>
+
+#include "statistics/latency_histogram.h"
+#include "common/macros.h"
+
+namespace peloton {
+namespace stats {
+
+const int LatencyHistogram::SUB_BUCKET_BITS;
+const uint64_t LatencyHistogram::SUB_BUCKET_COUNT;
+const uint64_t LatencyHistogram::LINEAR_BUCKET_COUNT;
+const int LatencyHistogram::MAX_EXPONENT;
+const size_t LatencyHistogram::BUCKET_COUNT;
+
+LatencyHistogram::LatencyHistogram() { Reset(); }
+
+LatencyHistogram::LatencyHistogram(const LatencyHistogram &other) {
+  Reset();
+  Merge(other);
+}
+
+LatencyHistogram &LatencyHistogram::operator=(const LatencyHistogram &other) {
+  if (this != &other) {
+    Reset();
+    Merge(other);
+  }
+  return *this;
+}
+
+uint64_t LatencyHistogram::GetBucketLowerBound(size_t index) {
+  if (index < LINEAR_BUCKET_COUNT) {
+    return index;
+  }
+  size_t octave = (index - LINEAR_BUCKET_COUNT) / SUB_BUCKET_COUNT;
+  size_t sub_bucket = (index - LINEAR_BUCKET_COUNT) % SUB_BUCKET_COUNT;
+  return (SUB_BUCKET_COUNT + sub_bucket) << (octave + 1);
+}
+
+uint64_t LatencyHistogram::GetBucketUpperBound(size_t index) {
+  if (index < LINEAR_BUCKET_COUNT) {
+    return index;
+  }
+  size_t octave = (index - LINEAR_BUCKET_COUNT) / SUB_BUCKET_COUNT;
+  return GetBucketLowerBound(index) + (1UL << (octave + 1)) - 1;
+}
+
+uint64_t LatencyHistogram::GetMin() const {
+  for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+    if (buckets_[i].load(std::memory_order_relaxed) != 0) {
+      return GetBucketLowerBound(i);
+    }
+  }
+  return 0;
+}
+
+double LatencyHistogram::GetMean() const {
+  auto count = GetCount();
+  if (count == 0) {
+    return 0.0;
+  }
+  return (double)GetSum() / count;
+}
+
+uint64_t LatencyHistogram::GetPercentile(double percentile) const {
+  PL_ASSERT(percentile >= 0.0 && percentile <= 100.0);
+
+  // Sum the buckets instead of trusting count_ so that a concurrently
+  // updated histogram still yields a consistent answer
+  uint64_t total = 0;
+  for (auto &bucket : buckets_) {
+    total += bucket.load(std::memory_order_relaxed);
+  }
+  if (total == 0) {
+    return 0;
+  }
+
+  uint64_t rank = (uint64_t)std::ceil(percentile / 100.0 * total);
+  if (rank == 0) {
+    rank = 1;
+  }
+
+  uint64_t seen = 0;
+  for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+    seen += buckets_[i].load(std::memory_order_relaxed);
+    if (seen >= rank) {
+      // Report the middle of the bucket, but never beyond the exact max
+      uint64_t lower = GetBucketLowerBound(i);
+      uint64_t value = lower + (GetBucketUpperBound(i) - lower) / 2;
+      uint64_t max = GetMax();
+      return (max != 0 && value > max) ? max : value;
+    }
+  }
+  return GetMax();
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram &source) {
+  for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+    Bump(buckets_[i], source.buckets_[i].load(std::memory_order_relaxed));
+  }
+  Bump(count_, source.GetCount());
+  Bump(sum_, source.GetSum());
+  if (source.GetMax() > GetMax()) {
+    max_.store(source.GetMax(), std::memory_order_relaxed);
+  }
+}
+
+void LatencyHistogram::Subtract(const LatencyHistogram &older) {
+  size_t highest_bucket = BUCKET_COUNT;
+  for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+    uint64_t current = buckets_[i].load(std::memory_order_relaxed);
+    uint64_t previous = older.buckets_[i].load(std::memory_order_relaxed);
+    uint64_t delta = (current > previous) ? current - previous : 0;
+    buckets_[i].store(delta, std::memory_order_relaxed);
+    if (delta != 0) {
+      highest_bucket = i;
+    }
+  }
+
+  uint64_t count = GetCount(), older_count = older.GetCount();
+  uint64_t sum = GetSum(), older_sum = older.GetSum();
+  count_.store(count > older_count ? count - older_count : 0,
+               std::memory_order_relaxed);
+  sum_.store(sum > older_sum ? sum - older_sum : 0, std::memory_order_relaxed);
+
+  // The exact max of a window is unknown, so bound it by its highest bucket
+  uint64_t max = 0;
+  if (highest_bucket != BUCKET_COUNT) {
+    max = GetBucketUpperBound(highest_bucket);
+    if (GetMax() < max) {
+      max = GetMax();
+    }
+  }
+  max_.store(max, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::Reset() {
+  for (auto &bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  count_.store(0, std::memory_order_relaxed);
+  sum_.store(0, std::memory_order_relaxed);
+  max_.store(0, std::memory_order_relaxed);
+}
+
+}  // namespace stats
+}  // namespace peloton
@@ -17,6 +17,7 @@
 
 #include "catalog/catalog.h"
 #include "catalog/catalog_util.h"
+#include "optimizer/stats_storage.h"
 #include "statistics/backend_stats_context.h"
 #include "statistics/stats_aggregator.h"
 
@@ -24,8 +25,8 @@ namespace peloton {
 namespace stats {
 
 StatsAggregator::StatsAggregator(int64_t aggregation_interval_ms)
-    : stats_history_(0, false),
-      aggregated_stats_(LATENCY_MAX_HISTORY_AGGREGATOR, false),
+    : stats_history_(false),
+      aggregated_stats_(false),
       aggregation_interval_ms_(aggregation_interval_ms),
       thread_number_(0),
       total_prev_txn_committed_(0) {
@@ -106,16 +107,32 @@ void StatsAggregator::Aggregate(int64_t &interval_cnt, double &alpha,
   LOG_TRACE("Moving avg. throughput: %lf txn/s", weighted_avg_throughput);
   LOG_TRACE("Current throughput:     %lf txn/s", throughput_);
 
+  // Latencies of the txns finished during this interval only
+  auto &txn_latencies = aggregated_stats_.GetTxnLatencyMetric();
+  auto interval_latencies = txn_latencies.ComputeWindow(prev_txn_latencies_);
+  prev_txn_latencies_ = txn_latencies.GetHistogram();
+  LOG_TRACE("Interval txn latency:   p50=%lf p99=%lf p99.9=%lf max=%lf ms",
+            interval_latencies.median_, interval_latencies.perc_99th_,
+            interval_latencies.perc_999th_, interval_latencies.max_);
+
   // Write the stats to metric tables
   UpdateMetrics();
 
+  if (interval_cnt % STATS_ANALYZE_INTERVALS == 0) {
+    RefreshTableStats();
+  }
+
   if (interval_cnt % STATS_LOG_INTERVALS == 0) {
     try {
       ofs_ << "At interval: " << interval_cnt << std::endl;
       ofs_ << aggregated_stats_.ToString();
       ofs_ << "Weighted avg. throughput=" << weighted_avg_throughput << std::endl;
       ofs_ << "Average throughput=" << avg_throughput_ << std::endl;
-      ofs_ << "Current throughput=" << throughput_;
+      ofs_ << "Current throughput=" << throughput_ << std::endl;
+      ofs_ << "Interval txn latency (ms): p50=" << interval_latencies.median_
+           << ", p99=" << interval_latencies.perc_99th_
+           << ", p99.9=" << interval_latencies.perc_999th_
+           << ", max=" << interval_latencies.max_;
     } catch (std::ofstream::failure &e) {
       LOG_ERROR("Error when writing to the stats log file %s", e.what());
     }
@@ -136,7 +153,7 @@ void StatsAggregator::UpdateQueryMetrics(int64_t time_stamp, concurrency::Transa
     auto updates = table_access.GetUpdates();
     auto deletes = table_access.GetDeletes();
     auto inserts = table_access.GetInserts();
-    auto latency = query_metric->GetQueryLatency().GetFirstLatencyValue();
+    auto latency = query_metric->GetQueryLatency().GetLatency();
     auto cpu_system = query_metric->GetProcessorMetric().GetSystemDuration();
     auto cpu_user = query_metric->GetProcessorMetric().GetUserDuration();
 
@@ -261,6 +278,15 @@ void StatsAggregator::UpdateIndexMetrics(storage::Database *database, storage::D
   }
 }
 
+void StatsAggregator::RefreshTableStats() {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  UNUSED_ATTRIBUTE auto analyzed_count =
+      optimizer::StatsStorage::GetInstance().AnalyzeStaleTables(txn);
+  txn_manager.CommitTransaction(txn);
+  LOG_TRACE("Refreshed the statistics of %lu tables", analyzed_count);
+}
+
 void StatsAggregator::RunAggregator() {
   LOG_DEBUG("Aggregator is now running.");
   std::mutex mtx;
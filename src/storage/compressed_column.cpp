@@ -0,0 +1,454 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// compressed_column.cpp
+//
+// Identification: src/storage/compressed_column.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/compressed_column.h"
+
+#include <algorithm>
+
+#include "catalog/schema.h"
+#include "common/logger.h"
+#include "common/macros.h"
+#include "storage/tile.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace storage {
+
+namespace {
+
+const uint64_t sign_bit = 1ULL << 63;
+
+bool IsVarlen(const type::Type::TypeId type_id) {
+  return type_id == type::Type::VARCHAR || type_id == type::Type::VARBINARY;
+}
+
+bool IsInteger(const type::Type::TypeId type_id) {
+  switch (type_id) {
+    case type::Type::TINYINT:
+    case type::Type::SMALLINT:
+    case type::Type::INTEGER:
+    case type::Type::BIGINT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool IsNumeric(const type::Type::TypeId type_id) {
+  return IsInteger(type_id) || type_id == type::Type::DECIMAL;
+}
+
+int64_t GetIntegerAs64(const type::Value &value) {
+  switch (value.GetTypeId()) {
+    case type::Type::TINYINT:
+      return value.GetAs<int8_t>();
+    case type::Type::SMALLINT:
+      return value.GetAs<int16_t>();
+    case type::Type::INTEGER:
+      return value.GetAs<int32_t>();
+    default:
+      return value.GetAs<int64_t>();
+  }
+}
+
+// Number of bits needed to store the value
+uint32_t GetBitWidth(uint64_t value) {
+  uint32_t bit_width = 0;
+  while (value != 0) {
+    bit_width++;
+    value >>= 1;
+  }
+  return bit_width;
+}
+
+bool ValueLess(const type::Value &left, const type::Value &right) {
+  return left.CompareLessThan(right) == type::CMP_TRUE;
+}
+
+}  // namespace
+
+CompressedColumn::CompressedColumn(Tile *tile, const oid_t column_id,
+                                   const oid_t tuple_count)
+    : type_id_(tile->GetSchema()->GetType(column_id)),
+      tuple_count_(tuple_count) {
+  std::vector<type::Value> values;
+  values.reserve(tuple_count);
+  for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+    values.push_back(tile->GetValue(tuple_itr, column_id));
+  }
+
+  std::vector<uint64_t> codes(tuple_count, 0);
+  bool has_nulls = false;
+
+  // Frame of reference, unless the range of the keys needs all 64 bits
+  is_dictionary_ = true;
+  if (IsInteger(type_id_) || type_id_ == type::Type::TIMESTAMP) {
+    bool has_values = false;
+    uint64_t min_key = 0, max_key = 0;
+    for (auto &value : values) {
+      if (value.IsNull() == true) {
+        has_nulls = true;
+        continue;
+      }
+      auto key = GetKey(value);
+      if (has_values == false || key < min_key) min_key = key;
+      if (has_values == false || key > max_key) max_key = key;
+      has_values = true;
+    }
+
+    if (max_key - min_key != UINT64_MAX) {
+      is_dictionary_ = false;
+      base_key_ = min_key;
+      null_code_ = has_values ? max_key - min_key + 1 : 0;
+      for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+        codes[tuple_itr] = values[tuple_itr].IsNull()
+                               ? null_code_
+                               : GetKey(values[tuple_itr]) - base_key_;
+      }
+    }
+  }
+
+  if (is_dictionary_ == true) {
+    dictionary_entry_size_ = IsVarlen(type_id_)
+                                 ? sizeof(const char *)
+                                 : tile->GetSchema()->GetLength(column_id);
+    BuildDictionary(values, codes);
+    has_nulls = std::find(codes.begin(), codes.end(), null_code_) !=
+                codes.end();
+  }
+
+  bit_width_ = GetBitWidth(has_nulls ? null_code_ : null_code_ - 1);
+  if (null_code_ == 0) {
+    bit_width_ = 0;
+  }
+
+  // Runs pay off if they are long on average
+  size_t run_count = 0;
+  for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+    if (tuple_itr == 0 || codes[tuple_itr] != codes[tuple_itr - 1]) {
+      run_count++;
+    }
+  }
+
+  if (run_count * run_length_factor <= tuple_count) {
+    std::vector<uint64_t> run_codes;
+    for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+      if (tuple_itr + 1 == tuple_count ||
+          codes[tuple_itr] != codes[tuple_itr + 1]) {
+        run_codes.push_back(codes[tuple_itr]);
+        run_ends_.push_back(tuple_itr + 1);
+      }
+    }
+    PackCodes(run_codes);
+  } else {
+    PackCodes(codes);
+  }
+
+  LOG_TRACE("Compressed column %u of %u values to %lu bytes", column_id,
+            tuple_count, GetSize());
+}
+
+void CompressedColumn::BuildDictionary(const std::vector<type::Value> &values,
+                                       std::vector<uint64_t> &codes) {
+  std::vector<type::Value> distinct_values;
+  for (auto &value : values) {
+    if (value.IsNull() == false) {
+      distinct_values.push_back(value);
+    }
+  }
+  std::sort(distinct_values.begin(), distinct_values.end(), ValueLess);
+  distinct_values.erase(
+      std::unique(distinct_values.begin(), distinct_values.end(),
+                  [](const type::Value &left, const type::Value &right) {
+                    return left.CompareEquals(right) == type::CMP_TRUE;
+                  }),
+      distinct_values.end());
+  null_code_ = distinct_values.size();
+
+  for (size_t value_itr = 0; value_itr < values.size(); value_itr++) {
+    auto &value = values[value_itr];
+    if (value.IsNull() == true) {
+      codes[value_itr] = null_code_;
+      continue;
+    }
+    codes[value_itr] =
+        std::lower_bound(distinct_values.begin(), distinct_values.end(),
+                         value, ValueLess) -
+        distinct_values.begin();
+  }
+
+  // The values are stored as in a tile, varlen ones point to their length
+  // prefixed data
+  dictionary_.resize(distinct_values.size() * dictionary_entry_size_);
+  if (IsVarlen(type_id_) == true) {
+    size_t data_size = 0;
+    for (auto &value : distinct_values) {
+      data_size += sizeof(uint32_t) + value.GetLength();
+    }
+    varlen_data_.resize(data_size);
+
+    size_t data_offset = 0;
+    for (size_t value_itr = 0; value_itr < distinct_values.size();
+         value_itr++) {
+      auto &value = distinct_values[value_itr];
+      uint32_t length = value.GetLength();
+      const char *entry = varlen_data_.data() + data_offset;
+      PL_MEMCPY(varlen_data_.data() + data_offset, &length, sizeof(length));
+      PL_MEMCPY(varlen_data_.data() + data_offset + sizeof(length),
+                value.GetData(), length);
+      PL_MEMCPY(dictionary_.data() + value_itr * dictionary_entry_size_,
+                &entry, sizeof(entry));
+      data_offset += sizeof(length) + length;
+    }
+  } else {
+    for (size_t value_itr = 0; value_itr < distinct_values.size();
+         value_itr++) {
+      distinct_values[value_itr].SerializeTo(
+          dictionary_.data() + value_itr * dictionary_entry_size_, true,
+          nullptr);
+    }
+  }
+}
+
+void CompressedColumn::PackCodes(const std::vector<uint64_t> &codes) {
+  packed_codes_.assign((codes.size() * bit_width_ + 63) / 64, 0);
+  if (bit_width_ == 0) {
+    return;
+  }
+
+  for (size_t code_itr = 0; code_itr < codes.size(); code_itr++) {
+    size_t bit_offset = code_itr * bit_width_;
+    size_t word_offset = bit_offset / 64;
+    size_t shift = bit_offset % 64;
+    packed_codes_[word_offset] |= codes[code_itr] << shift;
+    if (shift + bit_width_ > 64) {
+      packed_codes_[word_offset + 1] |= codes[code_itr] >> (64 - shift);
+    }
+  }
+}
+
+uint64_t CompressedColumn::GetPackedCode(const size_t code_offset) const {
+  if (bit_width_ == 0) {
+    return 0;
+  }
+
+  size_t bit_offset = code_offset * bit_width_;
+  size_t word_offset = bit_offset / 64;
+  size_t shift = bit_offset % 64;
+  uint64_t code = packed_codes_[word_offset] >> shift;
+  if (shift + bit_width_ > 64) {
+    code |= packed_codes_[word_offset + 1] << (64 - shift);
+  }
+  if (bit_width_ < 64) {
+    code &= (1ULL << bit_width_) - 1;
+  }
+  return code;
+}
+
+uint64_t CompressedColumn::GetCode(const oid_t tuple_offset) const {
+  if (run_ends_.empty() == true) {
+    return GetPackedCode(tuple_offset);
+  }
+  auto run = std::upper_bound(run_ends_.begin(), run_ends_.end(),
+                              tuple_offset);
+  return GetPackedCode(run - run_ends_.begin());
+}
+
+type::Value CompressedColumn::GetValue(const oid_t tuple_offset) const {
+  PL_ASSERT(tuple_offset < tuple_count_);
+
+  auto code = GetCode(tuple_offset);
+  if (code == null_code_) {
+    return type::ValueFactory::GetNullValueByType(type_id_);
+  }
+  if (is_dictionary_ == true) {
+    return type::Value::DeserializeFrom(
+        dictionary_.data() + code * dictionary_entry_size_, type_id_,
+        IsVarlen(type_id_) == false);
+  }
+  return GetKeyValue(base_key_ + code);
+}
+
+uint64_t CompressedColumn::GetKey(const type::Value &value) const {
+  if (value.GetTypeId() == type::Type::TIMESTAMP) {
+    return value.GetAs<uint64_t>();
+  }
+  return static_cast<uint64_t>(GetIntegerAs64(value)) ^ sign_bit;
+}
+
+type::Value CompressedColumn::GetKeyValue(const uint64_t key) const {
+  auto integer = static_cast<int64_t>(key ^ sign_bit);
+  switch (type_id_) {
+    case type::Type::TINYINT:
+      return type::ValueFactory::GetTinyIntValue(integer);
+    case type::Type::SMALLINT:
+      return type::ValueFactory::GetSmallIntValue(integer);
+    case type::Type::INTEGER:
+      return type::ValueFactory::GetIntegerValue(integer);
+    case type::Type::BIGINT:
+      return type::ValueFactory::GetBigIntValue(integer);
+    default:
+      return type::ValueFactory::GetTimestampValue(key);
+  }
+}
+
+bool CompressedColumn::GetCodeRange(const ExpressionType comparison,
+                                    const type::Value &constant,
+                                    uint64_t &low_code, uint64_t &high_code,
+                                    bool &negate) const {
+  if (constant.IsNull() == true) {
+    return false;
+  }
+
+  // The codes of the values equal to the constant are [equal_low,
+  // equal_high), the ones below are [0, equal_low)
+  uint64_t equal_low, equal_high;
+  if (is_dictionary_ == true) {
+    auto constant_type = constant.GetTypeId();
+    bool comparable = (constant_type == type_id_) ||
+                      (IsNumeric(constant_type) && IsNumeric(type_id_));
+    if (comparable == false) {
+      return false;
+    }
+
+    // Binary search over the sorted dictionary
+    equal_low = 0;
+    uint64_t search_high = null_code_;
+    while (equal_low < search_high) {
+      uint64_t middle = (equal_low + search_high) / 2;
+      auto entry = type::Value::DeserializeFrom(
+          dictionary_.data() + middle * dictionary_entry_size_, type_id_,
+          IsVarlen(type_id_) == false);
+      if (entry.CompareLessThan(constant) == type::CMP_TRUE) {
+        equal_low = middle + 1;
+      } else {
+        search_high = middle;
+      }
+    }
+    equal_high = equal_low;
+    if (equal_high < null_code_) {
+      auto entry = type::Value::DeserializeFrom(
+          dictionary_.data() + equal_high * dictionary_entry_size_, type_id_,
+          IsVarlen(type_id_) == false);
+      if (entry.CompareEquals(constant) == type::CMP_TRUE) {
+        equal_high++;
+      }
+    }
+  } else {
+    bool comparable = (type_id_ == type::Type::TIMESTAMP)
+                          ? constant.GetTypeId() == type::Type::TIMESTAMP
+                          : IsInteger(constant.GetTypeId());
+    if (comparable == false) {
+      return false;
+    }
+
+    auto key = GetKey(constant);
+    if (null_code_ == 0 || key < base_key_) {
+      equal_low = equal_high = 0;
+    } else if (key - base_key_ >= null_code_) {
+      equal_low = equal_high = null_code_;
+    } else {
+      equal_low = key - base_key_;
+      equal_high = equal_low + 1;
+    }
+  }
+
+  negate = false;
+  switch (comparison) {
+    case ExpressionType::COMPARE_EQUAL:
+      low_code = equal_low;
+      high_code = equal_high;
+      break;
+    case ExpressionType::COMPARE_NOTEQUAL:
+      low_code = equal_low;
+      high_code = equal_high;
+      negate = true;
+      break;
+    case ExpressionType::COMPARE_LESSTHAN:
+      low_code = 0;
+      high_code = equal_low;
+      break;
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      low_code = 0;
+      high_code = equal_high;
+      break;
+    case ExpressionType::COMPARE_GREATERTHAN:
+      low_code = equal_high;
+      high_code = null_code_;
+      break;
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      low_code = equal_low;
+      high_code = null_code_;
+      break;
+    default:
+      return false;
+  }
+  return true;
+}
+
+bool CompressedColumn::Filter(const ExpressionType comparison,
+                              const type::Value &constant,
+                              std::vector<bool> &matches) const {
+  uint64_t low_code, high_code;
+  bool negate;
+  if (GetCodeRange(comparison, constant, low_code, high_code, negate) ==
+      false) {
+    return false;
+  }
+
+  // NULLs never satisfy a comparison
+  auto code_matches = [&](uint64_t code) {
+    bool in_range = (code >= low_code && code < high_code);
+    return (negate ? !in_range && code != null_code_ : in_range);
+  };
+
+  oid_t tuple_count = std::min<oid_t>(tuple_count_, matches.size());
+  if (run_ends_.empty() == true) {
+    for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+      if (matches[tuple_itr] == true &&
+          code_matches(GetPackedCode(tuple_itr)) == false) {
+        matches[tuple_itr] = false;
+      }
+    }
+    return true;
+  }
+
+  // Every run is decided at once
+  oid_t run_begin = 0;
+  for (size_t run_itr = 0;
+       run_itr < run_ends_.size() && run_begin < tuple_count; run_itr++) {
+    oid_t run_end = std::min(run_ends_[run_itr], tuple_count);
+    if (code_matches(GetPackedCode(run_itr)) == false) {
+      std::fill(matches.begin() + run_begin, matches.begin() + run_end,
+                false);
+    }
+    run_begin = run_end;
+  }
+  return true;
+}
+
+ColumnEncodingType CompressedColumn::GetEncodingType() const {
+  if (run_ends_.empty() == false) {
+    return ColumnEncodingType::RUN_LENGTH;
+  }
+  return is_dictionary_ ? ColumnEncodingType::DICTIONARY
+                        : ColumnEncodingType::FRAME_OF_REFERENCE;
+}
+
+size_t CompressedColumn::GetSize() const {
+  return dictionary_.size() + varlen_data_.size() +
+         packed_codes_.size() * sizeof(uint64_t) +
+         run_ends_.size() * sizeof(oid_t);
+}
+
+}  // End storage namespace
+}  // End peloton namespace
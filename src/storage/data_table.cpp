@@ -10,13 +10,16 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <mutex>
+#include <numeric>
 #include <utility>
 
 #include "brain/clusterer.h"
 #include "brain/sample.h"
 #include "catalog/catalog.h"
 #include "catalog/foreign_key.h"
+#include "common/container_tuple.h"
 #include "common/exception.h"
 #include "common/exception.h"
 #include "common/logger.h"
@@ -218,6 +221,40 @@ ItemPointer DataTable::GetEmptyTupleSlot(const storage::Tuple *tuple) {
   return location;
 }
 
+// batched counterpart of GetEmptyTupleSlot(). recycled slots are left to
+// single-tuple inserts, a batch always claims fresh runs of slots.
+void DataTable::GetEmptyTupleSlots(
+    const std::vector<const storage::Tuple *> &tuples,
+    std::vector<ItemPointer> &locations) {
+  size_t tuple_itr = 0;
+  while (tuple_itr < tuples.size()) {
+    size_t active_tile_group_id = number_of_tuples_ % active_tilegroup_count_;
+    std::shared_ptr<storage::TileGroup> tile_group =
+        active_tile_groups_[active_tile_group_id];
+
+    oid_t first_slot = INVALID_OID;
+    oid_t slot_count = tile_group->GetHeader()->GetNextEmptyTupleSlots(
+        tuples.size() - tuple_itr, first_slot);
+
+    // some other thread is adding the next tile group
+    if (slot_count == 0) {
+      continue;
+    }
+
+    oid_t tile_group_id = tile_group->GetTileGroupId();
+    for (oid_t tuple_slot = first_slot; tuple_slot < first_slot + slot_count;
+         tuple_slot++) {
+      tile_group->CopyTuple(tuples[tuple_itr++], tuple_slot);
+      locations.push_back(ItemPointer(tile_group_id, tuple_slot));
+    }
+
+    // whoever gets the last tuple slot creates a new tile group
+    if (first_slot + slot_count == tile_group->GetAllocatedTupleCount()) {
+      AddDefaultTileGroup(active_tile_group_id);
+    }
+  }
+}
+
 //===--------------------------------------------------------------------===//
 // INSERT
 //===--------------------------------------------------------------------===//
@@ -326,25 +363,100 @@ ItemPointer DataTable::InsertTuple(const storage::Tuple *tuple) {
   return location;
 }
 
-/**
- * @brief Insert a tuple into all indexes. If index is primary/unique,
- * check visibility of existing
- * index entries.
- * @warning This still doesn't guarantee serializability.
- *
- * @returns True on success, false if a visible entry exists (in case of
- *primary/unique).
- */
-bool DataTable::InsertInIndexes(const storage::Tuple *tuple,
-                                ItemPointer location,
-                                concurrency::Transaction *transaction,
-                                ItemPointer **index_entry_ptr) {
-  int index_count = GetIndexCount();
+bool DataTable::InsertTuples(
+    const std::vector<const storage::Tuple *> &tuples,
+    concurrency::Transaction *transaction,
+    std::vector<ItemPointer *> *deferred_index_entries) {
+  std::vector<ItemPointer> locations;
+  locations.reserve(tuples.size());
+  GetEmptyTupleSlots(tuples, locations);
+  IncreaseTupleCount(tuples.size());
+
+  auto &transaction_manager =
+      concurrency::TransactionManagerFactory::GetInstance();
+  auto index_count = GetIndexCount();
+
+  // register the inserts first, so that the unique checks below see the
+  // earlier tuples of the batch
+  std::vector<ItemPointer *> index_entry_ptrs(tuples.size(), nullptr);
+  for (size_t tuple_itr = 0; tuple_itr < tuples.size(); tuple_itr++) {
+    if (index_count > 0) {
+      index_entry_ptrs[tuple_itr] = AllocateIndirection(locations[tuple_itr]);
+    }
+    transaction_manager.PerformInsert(transaction, locations[tuple_itr],
+                                      index_entry_ptrs[tuple_itr]);
+  }
 
+  if (index_count == 0) {
+    return true;
+  }
+
+  // Index checks and updates
+  if (deferred_index_entries != nullptr) {
+    deferred_index_entries->insert(deferred_index_entries->end(),
+                                   index_entry_ptrs.begin(),
+                                   index_entry_ptrs.end());
+  } else {
+    std::vector<const AbstractTuple *> index_tuples(tuples.begin(),
+                                                    tuples.end());
+    if (InsertInIndexes(index_tuples, index_entry_ptrs, transaction) ==
+        false) {
+      LOG_TRACE("Index constraint violated");
+      return false;
+    }
+  }
+
+  // ForeignKey checks
+  for (auto tuple : tuples) {
+    if (CheckForeignKeyConstraints(tuple) == false) {
+      LOG_TRACE("ForeignKey constraint violated");
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool DataTable::BuildIndexes(const std::vector<ItemPointer *> &index_entry_ptrs,
+                             concurrency::Transaction *transaction) {
+  if (GetIndexCount() == 0 || index_entry_ptrs.empty()) {
+    return true;
+  }
+
+  // read the keys back from the tuples the entries point to
+  typedef expression::ContainerTuple<storage::TileGroup> TileGroupTuple;
+  std::vector<TileGroupTuple> container_tuples;
+  std::vector<std::shared_ptr<storage::TileGroup>> tile_groups;
+  container_tuples.reserve(index_entry_ptrs.size());
+  for (auto index_entry_ptr : index_entry_ptrs) {
+    ItemPointer location = *index_entry_ptr;
+    if (tile_groups.empty() ||
+        tile_groups.back()->GetTileGroupId() != location.block) {
+      tile_groups.push_back(GetTileGroupById(location.block));
+    }
+    container_tuples.push_back(
+        TileGroupTuple(tile_groups.back().get(), location.offset));
+  }
+
+  std::vector<const AbstractTuple *> tuples;
+  tuples.reserve(container_tuples.size());
+  for (auto &container_tuple : container_tuples) {
+    tuples.push_back(&container_tuple);
+  }
+
+  if (InsertInIndexes(tuples, index_entry_ptrs, transaction) == false) {
+    LOG_TRACE("Index constraint violated");
+    return false;
+  }
+  return true;
+}
+
+ItemPointer *DataTable::AllocateIndirection(const ItemPointer &location) {
   size_t active_indirection_array_id =
       number_of_tuples_ % active_indirection_array_count_;
 
   size_t indirection_offset = INVALID_INDIRECTION_OFFSET;
+  ItemPointer *index_entry_ptr = nullptr;
 
   while (true) {
     auto active_indirection_array =
@@ -352,19 +464,39 @@ bool DataTable::InsertInIndexes(const storage::Tuple *tuple,
     indirection_offset = active_indirection_array->AllocateIndirection();
 
     if (indirection_offset != INVALID_INDIRECTION_OFFSET) {
-      *index_entry_ptr =
+      index_entry_ptr =
           active_indirection_array->GetIndirectionByOffset(indirection_offset);
       break;
     }
   }
 
-  (*index_entry_ptr)->block = location.block;
-  (*index_entry_ptr)->offset = location.offset;
+  index_entry_ptr->block = location.block;
+  index_entry_ptr->offset = location.offset;
 
   if (indirection_offset == INDIRECTION_ARRAY_MAX_SIZE - 1) {
     AddDefaultIndirectionArray(active_indirection_array_id);
   }
 
+  return index_entry_ptr;
+}
+
+/**
+ * @brief Insert a tuple into all indexes. If index is primary/unique,
+ * check visibility of existing
+ * index entries.
+ * @warning This still doesn't guarantee serializability.
+ *
+ * @returns True on success, false if a visible entry exists (in case of
+ *primary/unique).
+ */
+bool DataTable::InsertInIndexes(const storage::Tuple *tuple,
+                                ItemPointer location,
+                                concurrency::Transaction *transaction,
+                                ItemPointer **index_entry_ptr) {
+  int index_count = GetIndexCount();
+
+  *index_entry_ptr = AllocateIndirection(location);
+
   auto &transaction_manager =
       concurrency::TransactionManagerFactory::GetInstance();
 
@@ -414,6 +546,72 @@ bool DataTable::InsertInIndexes(const storage::Tuple *tuple,
   return true;
 }
 
+/**
+ * @brief Insert a batch of tuples into all indexes. The keys of each index
+ * are inserted in sorted order, so that consecutive inserts touch the same
+ * index nodes.
+ *
+ * @returns True on success, false if a visible entry exists (in case of
+ *primary/unique).
+ */
+bool DataTable::InsertInIndexes(
+    const std::vector<const AbstractTuple *> &tuples,
+    const std::vector<ItemPointer *> &index_entry_ptrs,
+    concurrency::Transaction *transaction) {
+  int index_count = GetIndexCount();
+
+  auto &transaction_manager =
+      concurrency::TransactionManagerFactory::GetInstance();
+
+  std::function<bool(const void *)> fn =
+      std::bind(&concurrency::TransactionManager::IsOccupied,
+                &transaction_manager, transaction, std::placeholders::_1);
+
+  std::vector<std::unique_ptr<storage::Tuple>> keys(tuples.size());
+  std::vector<size_t> key_order(tuples.size());
+
+  for (int index_itr = index_count - 1; index_itr >= 0; --index_itr) {
+    auto index = GetIndex(index_itr);
+    auto index_schema = index->GetKeySchema();
+    auto indexed_columns = index_schema->GetIndexedColumns();
+
+    for (size_t tuple_itr = 0; tuple_itr < tuples.size(); tuple_itr++) {
+      keys[tuple_itr].reset(new storage::Tuple(index_schema, true));
+      keys[tuple_itr]->SetFromTuple(tuples[tuple_itr], indexed_columns,
+                                    index->GetPool());
+    }
+    std::iota(key_order.begin(), key_order.end(), 0);
+    std::sort(key_order.begin(), key_order.end(),
+              [&keys](const size_t &lhs, const size_t &rhs) {
+                return keys[lhs]->Compare(*keys[rhs]) < 0;
+              });
+
+    for (auto tuple_itr : key_order) {
+      bool res = true;
+      switch (index->GetIndexType()) {
+        case IndexConstraintType::PRIMARY_KEY:
+        case IndexConstraintType::UNIQUE: {
+          res = index->CondInsertEntry(keys[tuple_itr].get(),
+                                       index_entry_ptrs[tuple_itr], fn);
+        } break;
+
+        case IndexConstraintType::DEFAULT:
+        default:
+          index->InsertEntry(keys[tuple_itr].get(),
+                             index_entry_ptrs[tuple_itr]);
+          break;
+      }
+
+      if (res == false) {
+        return false;
+      }
+    }
+    LOG_TRACE("Index constraint check on %s passed.", index->GetName().c_str());
+  }
+
+  return true;
+}
+
 bool DataTable::InsertInSecondaryIndexes(const AbstractTuple *tuple,
                                          const TargetList *targets_ptr,
                                          concurrency::Transaction *transaction,
@@ -549,6 +747,7 @@ bool DataTable::CheckForeignKeyConstraints(
  */
 void DataTable::IncreaseTupleCount(const size_t &amount) {
   number_of_tuples_ += amount;
+  modification_count_ += amount;
   dirty_ = true;
 }
 
@@ -558,6 +757,7 @@ void DataTable::IncreaseTupleCount(const size_t &amount) {
  */
 void DataTable::DecreaseTupleCount(const size_t &amount) {
   number_of_tuples_ -= amount;
+  modification_count_ += amount;
   dirty_ = true;
 }
 
@@ -587,6 +787,12 @@ bool DataTable::IsDirty() const { return dirty_; }
  */
 void DataTable::ResetDirty() { dirty_ = false; }
 
+/**
+ * @brief Get the number of tuple versions added or removed so far
+ * @return modification count
+ */
+size_t DataTable::GetModificationCount() const { return modification_count_; }
+
 //===--------------------------------------------------------------------===//
 // TILE GROUP
 //===--------------------------------------------------------------------===//
@@ -967,14 +1173,17 @@ void SetTransformedTileGroup(storage::TileGroup *orig_tile_group,
     }
   }
 
-  // Finally, copy over the tile header
-  auto header = orig_tile_group->GetHeader();
-  auto new_header = new_tile_group->GetHeader();
-  *new_header = *header;
+  // The two tile groups share the header
 }
 
 storage::TileGroup *DataTable::TransformTileGroup(
     const oid_t &tile_group_offset, const double &theta) {
+  return TransformTileGroup(tile_group_offset, default_partition_, theta);
+}
+
+storage::TileGroup *DataTable::TransformTileGroup(
+    const oid_t &tile_group_offset, const column_map_type &column_map,
+    const double &theta) {
   // First, check if the tile group is in this table
   if (tile_group_offset >= tile_groups_.GetSize()) {
     LOG_ERROR("Tile group offset not found in table : %u ", tile_group_offset);
@@ -987,37 +1196,126 @@ storage::TileGroup *DataTable::TransformTileGroup(
   // Get orig tile group from catalog
   auto &catalog_manager = catalog::Manager::GetInstance();
   auto tile_group = catalog_manager.GetTileGroup(tile_group_id);
-  auto diff = tile_group->GetSchemaDifference(default_partition_);
+  if (tile_group == nullptr) {
+    return nullptr;
+  }
+
+  // Frozen tile groups keep their layout, tile groups that still get
+  // inserts are not transformed
+  auto tile_group_header = tile_group->GetHeader();
+  auto tuple_count = tile_group->GetAllocatedTupleCount();
+  if (tile_group_header->IsFrozen() == true ||
+      tile_group_header->GetCurrentNextTupleSlot() < tuple_count) {
+    return nullptr;
+  }
+
+  auto diff = tile_group->GetSchemaDifference(column_map);
 
   // Check threshold for transformation
   if (diff < theta) {
     return nullptr;
   }
 
+  if (tile_group_header->StartTransforming() == false) {
+    return nullptr;
+  }
+  if (tile_group_header->IsFrozen() == true) {
+    tile_group_header->StopTransforming();
+    return nullptr;
+  }
+
+  // Only committed versions are copied, their data does not change any
+  // more. Uncommitted versions may still be written in place, and recycled
+  // slots get new tuples.
+  for (oid_t tuple_slot = 0; tuple_slot < tuple_count; tuple_slot++) {
+    if (tile_group_header->GetBeginCommitId(tuple_slot) == MAX_CID) {
+      tile_group_header->StopTransforming();
+      return nullptr;
+    }
+  }
+
   LOG_TRACE("Transforming tile group : %u", tile_group_offset);
 
   // Get the schema for the new transformed tile group
-  auto new_schema =
-      TransformTileGroupSchema(tile_group.get(), default_partition_);
+  auto new_schema = TransformTileGroupSchema(tile_group.get(), column_map);
 
   // Allocate space for the transformed tile group
   std::shared_ptr<storage::TileGroup> new_tile_group(
-      TileGroupFactory::GetTileGroup(
-          tile_group->GetDatabaseId(), tile_group->GetTableId(),
-          tile_group->GetTileGroupId(), tile_group->GetAbstractTable(),
-          new_schema, default_partition_,
-          tile_group->GetAllocatedTupleCount()));
+      TileGroupFactory::GetTransformedTileGroup(tile_group.get(), new_schema,
+                                                column_map));
 
   // Set the transformed tile group column-at-a-time
   SetTransformedTileGroup(tile_group.get(), new_tile_group.get());
 
-  // Set the location of the new tile group
-  // and clean up the orig tile group
+  // Set the location of the new tile group, readers that still hold the
+  // orig tile group keep using it
+  tile_group_header->SetTileGroup(new_tile_group.get());
   catalog_manager.AddTileGroup(tile_group_id, new_tile_group);
 
+  tile_group_header->StopTransforming();
+
   return new_tile_group.get();
 }
 
+storage::TileGroup *DataTable::FreezeTileGroup(const oid_t &tile_group_offset,
+                                               const cid_t &max_cid) {
+  if (tile_group_offset >= tile_groups_.GetSize()) {
+    LOG_ERROR("Tile group offset not found in table : %u ", tile_group_offset);
+    return nullptr;
+  }
+
+  auto tile_group_id =
+      tile_groups_.FindValid(tile_group_offset, invalid_tile_group_id);
+
+  auto &catalog_manager = catalog::Manager::GetInstance();
+  auto tile_group = catalog_manager.GetTileGroup(tile_group_id);
+  if (tile_group == nullptr) {
+    return nullptr;
+  }
+  auto tile_group_header = tile_group->GetHeader();
+  auto tuple_count = tile_group->GetAllocatedTupleCount();
+  if (tile_group_header->IsFrozen() == true ||
+      tile_group_header->GetCurrentNextTupleSlot() < tuple_count) {
+    return nullptr;
+  }
+
+  // The GC does not recycle the slots of a transforming tile group. A slot
+  // the GC reset before it saw the flag is empty below and the tile group
+  // stays hot.
+  if (tile_group_header->StartTransforming() == false) {
+    return nullptr;
+  }
+  if (tile_group_header->IsFrozen() == true) {
+    tile_group_header->StopTransforming();
+    return nullptr;
+  }
+  for (oid_t tuple_slot = 0; tuple_slot < tuple_count; tuple_slot++) {
+    auto begin_cid = tile_group_header->GetBeginCommitId(tuple_slot);
+    auto end_cid = tile_group_header->GetEndCommitId(tuple_slot);
+    bool is_cold =
+        tile_group_header->GetTransactionId(tuple_slot) == INITIAL_TXN_ID &&
+        begin_cid < max_cid && (end_cid == MAX_CID || end_cid < max_cid);
+    if (is_cold == false) {
+      tile_group_header->StopTransforming();
+      return nullptr;
+    }
+  }
+  tile_group_header->SetFrozen(true);
+
+  LOG_TRACE("Freezing tile group : %u", tile_group_offset);
+
+  // Writers keep working on the shared header. Readers that still hold the
+  // uncompressed tile group see the same values.
+  std::shared_ptr<storage::TileGroup> compressed_tile_group(
+      TileGroupFactory::GetCompressedTileGroup(tile_group.get()));
+  tile_group_header->SetTileGroup(compressed_tile_group.get());
+  catalog_manager.AddTileGroup(tile_group_id, compressed_tile_group);
+
+  tile_group_header->StopTransforming();
+
+  return compressed_tile_group.get();
+}
+
 void DataTable::RecordLayoutSample(const brain::Sample &sample) {
   // Add layout sample
   {
@@ -19,6 +19,7 @@
 #include "storage/database.h"
 #include "storage/table_factory.h"
 #include "gc/gc_manager_factory.h"
+#include "tcop/plan_cache.h"
 
 namespace peloton {
 namespace storage {
@@ -75,6 +76,9 @@ void Database::DropTableWithOid(const oid_t table_oid) {
     assert(gc_manager != nullptr);
     gc_manager->DeregisterTable(table_oid);
 
+    // Forget the cached plans over this table
+    tcop::PlanCache::GetInstance().InvalidateTable(table_oid);
+
     oid_t table_offset = 0;
     for (auto table : tables) {
       if (table->GetOid() == table_oid) {
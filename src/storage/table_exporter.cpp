@@ -0,0 +1,374 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// table_exporter.cpp
+//
+// Identification: src/storage/table_exporter.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table_exporter.h"
+
+#include <cerrno>
+#include <cstring>
+#include <unordered_map>
+
+#include "catalog/schema.h"
+#include "common/logger.h"
+#include "concurrency/transaction.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "logging/logging_util.h"
+#include "storage/data_table.h"
+#include "storage/tile.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+
+namespace peloton {
+namespace storage {
+
+namespace {
+
+// Output is written once this much has been buffered
+const size_t export_buffer_size = 1 << 20;
+
+// Where a column of a tile group lives
+struct ColumnLocation {
+  Tile *tile;
+  size_t offset;
+  type::Type::TypeId type;
+  bool is_inlined;
+};
+
+void LocateColumns(TileGroup *tile_group, oid_t column_count,
+                   std::vector<ColumnLocation> &columns) {
+  columns.clear();
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    oid_t tile_offset, tile_column;
+    tile_group->LocateTileAndColumn(column_itr, tile_offset, tile_column);
+    auto tile = tile_group->GetTile(tile_offset);
+    auto tile_schema = tile->GetSchema();
+    columns.push_back({tile, tile_schema->GetOffset(tile_column),
+                       tile_schema->GetType(tile_column),
+                       tile_schema->IsInlined(tile_column)});
+  }
+}
+
+inline bool IsVarlen(type::Type::TypeId type) {
+  return type == type::Type::VARCHAR || type == type::Type::VARBINARY;
+}
+
+// Length of the content of a varlen value, without the terminator
+inline size_t GetContentLength(const type::Value &value) {
+  size_t length = value.GetLength();
+  if (value.GetTypeId() == type::Type::VARCHAR && length > 0) {
+    length--;
+  }
+  return length;
+}
+
+}  // namespace
+
+const char TableExporter::binary_magic[8] = {'P', 'L', 'T', 'N',
+                                             'D', 'U', 'M', 'P'};
+
+TableExporter::TableExporter(DataTable *table, CopyType format,
+                             char delimiter)
+    : table_(table), format_(format), delimiter_(delimiter) {
+  buffer_.reserve(export_buffer_size * 2);
+}
+
+TableExporter::~TableExporter() { Close(); }
+
+bool TableExporter::Open(const std::string &file_path) {
+  Close();
+  if (logging::LoggingUtil::InitFileHandle(file_path.c_str(), file_handle_,
+                                           "w") == false) {
+    return false;
+  }
+  LOG_DEBUG("Created export file: %s", file_path.c_str());
+  return true;
+}
+
+bool TableExporter::Close() {
+  bool success = true;
+  if (file_handle_.file != nullptr) {
+    if (fclose(file_handle_.file) != 0) {
+      LOG_ERROR("Failed to close the export file: %s", strerror(errno));
+      success = false;
+    }
+    file_handle_ = INVALID_FILE_HANDLE;
+  }
+  return success;
+}
+
+bool TableExporter::ExportSnapshot(const std::string &file_path) {
+  if (Open(file_path) == false) {
+    return false;
+  }
+
+  auto &transaction_manager =
+      concurrency::TransactionManagerFactory::GetInstance();
+  auto transaction = transaction_manager.BeginReadonlyTransaction();
+  bool success = Export(transaction);
+  transaction_manager.CommitTransaction(transaction);
+  return success;
+}
+
+bool TableExporter::Export(concurrency::Transaction *transaction) {
+  PL_ASSERT(file_handle_.file != nullptr);
+  auto &transaction_manager =
+      concurrency::TransactionManagerFactory::GetInstance();
+
+  // Read-only transactions are never validated, the others have to record
+  // what they read
+  bool perform_reads = transaction->IsDeclaredReadOnly() == false;
+
+  if (format_ == CopyType::EXPORT_BINARY) {
+    WriteBinaryHeader();
+  }
+
+  std::vector<oid_t> tuple_ids;
+  auto tile_group_count = table_->GetTileGroupCount();
+  for (size_t tile_group_itr = 0; tile_group_itr < tile_group_count;
+       tile_group_itr++) {
+    auto tile_group = table_->GetTileGroup(tile_group_itr);
+    auto tile_group_id = tile_group->GetTileGroupId();
+    auto tile_group_header = tile_group->GetHeader();
+    oid_t active_tuple_count = tile_group->GetNextTupleSlot();
+
+    tuple_ids.clear();
+    for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
+      if (transaction_manager.IsVisible(transaction, tile_group_header,
+                                        tuple_id) != VisibilityType::OK) {
+        continue;
+      }
+      if (perform_reads == true &&
+          transaction_manager.PerformRead(
+              transaction, ItemPointer(tile_group_id, tuple_id), false) ==
+              false) {
+        Close();
+        return false;
+      }
+      tuple_ids.push_back(tuple_id);
+    }
+
+    if (tuple_ids.empty() == true) {
+      continue;
+    }
+    if (format_ == CopyType::EXPORT_BINARY) {
+      WriteBinaryBlock(tile_group.get(), tuple_ids);
+    } else {
+      WriteRows(tile_group.get(), tuple_ids);
+    }
+    row_count_ += tuple_ids.size();
+
+    if (buffer_.size() >= export_buffer_size && Flush() == false) {
+      Close();
+      return false;
+    }
+  }
+
+  if (format_ == CopyType::EXPORT_BINARY) {
+    AppendUInt32(0);
+  }
+  bool success = Flush() && logging::LoggingUtil::FFlushFsync(file_handle_);
+  success = Close() && success;
+  if (success == false) {
+    LOG_ERROR("Export ended after %lu bytes", bytes_written_);
+    return false;
+  }
+
+  LOG_DEBUG("Exported %lu rows in %lu bytes", row_count_, bytes_written_);
+  return true;
+}
+
+void TableExporter::WriteBinaryHeader() {
+  auto schema = table_->GetSchema();
+  auto column_count = schema->GetColumnCount();
+
+  buffer_.append(binary_magic, sizeof(binary_magic));
+  AppendUInt32(binary_version);
+  AppendUInt32(column_count);
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    auto column_name = schema->GetColumn(column_itr).GetName();
+    AppendUInt32(static_cast<uint32_t>(schema->GetType(column_itr)));
+    AppendUInt32(column_name.size());
+    buffer_ += column_name;
+  }
+}
+
+void TableExporter::WriteRows(TileGroup *tile_group,
+                              const std::vector<oid_t> &tuple_ids) {
+  std::vector<ColumnLocation> columns;
+  LocateColumns(tile_group, table_->GetSchema()->GetColumnCount(), columns);
+
+  for (auto tuple_id : tuple_ids) {
+    for (size_t column_itr = 0; column_itr < columns.size(); column_itr++) {
+      if (column_itr > 0) {
+        buffer_ += delimiter_;
+      }
+
+      auto &column = columns[column_itr];
+      auto value = column.tile->GetValueFast(tuple_id, column.offset,
+                                             column.type, column.is_inlined);
+      if (value.IsNull() == true) {
+        buffer_ += "\\N";
+        continue;
+      }
+
+      switch (column.type) {
+        case type::Type::TINYINT:
+          AppendInteger(value.GetAs<int8_t>());
+          break;
+        case type::Type::SMALLINT:
+          AppendInteger(value.GetAs<int16_t>());
+          break;
+        case type::Type::INTEGER:
+          AppendInteger(value.GetAs<int32_t>());
+          break;
+        case type::Type::BIGINT:
+          AppendInteger(value.GetAs<int64_t>());
+          break;
+        case type::Type::VARCHAR:
+        case type::Type::VARBINARY:
+          AppendEscaped(value.GetData(), GetContentLength(value));
+          break;
+        default: {
+          auto str = value.ToString();
+          AppendEscaped(str.c_str(), str.length());
+        } break;
+      }
+    }
+    buffer_ += '\n';
+  }
+}
+
+void TableExporter::WriteBinaryBlock(TileGroup *tile_group,
+                                     const std::vector<oid_t> &tuple_ids) {
+  auto schema = table_->GetSchema();
+  std::vector<ColumnLocation> columns;
+  LocateColumns(tile_group, schema->GetColumnCount(), columns);
+
+  size_t row_count = tuple_ids.size();
+  AppendUInt32(row_count);
+
+  std::string null_bitmap;
+  std::string column_data;
+  for (oid_t column_itr = 0; column_itr < columns.size(); column_itr++) {
+    auto &column = columns[column_itr];
+    null_bitmap.assign((row_count + 7) / 8, '\0');
+    column_data.clear();
+
+    if (IsVarlen(column.type) == true) {
+      // Dictionary of the distinct values, in order of appearance
+      std::unordered_map<std::string, uint32_t> codes;
+      std::vector<const std::string *> dictionary;
+      std::vector<uint32_t> row_codes(row_count, 0);
+      for (size_t row_itr = 0; row_itr < row_count; row_itr++) {
+        auto value = column.tile->GetValueFast(
+            tuple_ids[row_itr], column.offset, column.type, column.is_inlined);
+        if (value.IsNull() == true) {
+          null_bitmap[row_itr / 8] |= 1 << (row_itr % 8);
+          continue;
+        }
+        auto entry = codes.emplace(
+            std::string(value.GetData(), GetContentLength(value)),
+            dictionary.size());
+        if (entry.second == true) {
+          dictionary.push_back(&entry.first->first);
+        }
+        row_codes[row_itr] = entry.first->second;
+      }
+
+      buffer_ += null_bitmap;
+      AppendUInt32(dictionary.size());
+      for (auto dictionary_entry : dictionary) {
+        AppendUInt32(dictionary_entry->size());
+        buffer_ += *dictionary_entry;
+      }
+      buffer_.append(reinterpret_cast<const char *>(row_codes.data()),
+                     row_codes.size() * sizeof(uint32_t));
+    } else {
+      // Fixed length values are copied as they are stored
+      size_t length = schema->GetLength(column_itr);
+      for (size_t row_itr = 0; row_itr < row_count; row_itr++) {
+        auto tuple_id = tuple_ids[row_itr];
+        auto value = column.tile->GetValueFast(tuple_id, column.offset,
+                                               column.type, column.is_inlined);
+        if (value.IsNull() == true) {
+          null_bitmap[row_itr / 8] |= 1 << (row_itr % 8);
+        }
+        if (column.tile->IsCompressed() == true) {
+          // Same bytes as the value has in an uncompressed tile
+          char field[sizeof(uint64_t)] = {0};
+          PL_ASSERT(length <= sizeof(field));
+          value.SerializeTo(field, true, nullptr);
+          column_data.append(field, length);
+          continue;
+        }
+        column_data.append(
+            column.tile->GetTupleLocation(tuple_id) + column.offset, length);
+      }
+
+      buffer_ += null_bitmap;
+      buffer_ += column_data;
+    }
+  }
+}
+
+void TableExporter::AppendUInt32(uint32_t value) {
+  buffer_.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+void TableExporter::AppendInteger(int64_t value) {
+  char digits[20];
+  size_t digit_count = 0;
+  uint64_t magnitude =
+      (value < 0) ? 0 - static_cast<uint64_t>(value) : value;
+  do {
+    digits[digit_count++] = '0' + magnitude % 10;
+    magnitude /= 10;
+  } while (magnitude > 0);
+
+  if (value < 0) {
+    buffer_ += '-';
+  }
+  while (digit_count > 0) {
+    buffer_ += digits[--digit_count];
+  }
+}
+
+void TableExporter::AppendEscaped(const char *data, size_t length) {
+  for (size_t char_itr = 0; char_itr < length; char_itr++) {
+    char ch = data[char_itr];
+    if (ch == delimiter_ || ch == '\n' || ch == '\\') {
+      buffer_ += '\\';
+    }
+    buffer_ += ch;
+  }
+}
+
+bool TableExporter::Flush() {
+  size_t buffer_ptr = 0;
+  bool success = true;
+  while (buffer_ptr < buffer_.size()) {
+    size_t bytes_written =
+        fwrite(buffer_.data() + buffer_ptr, sizeof(char),
+               buffer_.size() - buffer_ptr, file_handle_.file);
+    if (bytes_written == 0) {
+      LOG_ERROR("Failed to write the export file: %s", strerror(errno));
+      success = false;
+      break;
+    }
+    buffer_ptr += bytes_written;
+  }
+  bytes_written_ += buffer_ptr;
+  buffer_.clear();
+  return success;
+}
+
+}  // namespace storage
+}  // namespace peloton
@@ -20,6 +20,7 @@
 #include "type/types.h"
 #include "type/ephemeral_pool.h"
 #include "concurrency/transaction_manager_factory.h"
+#include "storage/compressed_column.h"
 #include "storage/storage_manager.h"
 #include "storage/tile.h"
 #include "storage/tile_group_header.h"
@@ -67,11 +68,41 @@ Tile::Tile(BackendType backend_type, TileGroupHeader *tile_header,
   //}
 }
 
+Tile::Tile(Tile *tile, TileGroup *tile_group, int tuple_count)
+    : database_id(INVALID_OID),
+      table_id(INVALID_OID),
+      tile_group_id(INVALID_OID),
+      tile_id(INVALID_OID),
+      backend_type(tile->backend_type),
+      schema(tile->schema),
+      data(NULL),
+      tile_group(tile_group),
+      pool(NULL),
+      num_tuple_slots(tuple_count),
+      column_count(tile->column_count),
+      tuple_length(tile->tuple_length),
+      tile_size(0),
+      uninlined_data_size(0),
+      column_header(NULL),
+      column_header_size(INVALID_OID),
+      tile_group_header(tile->tile_group_header) {
+  PL_ASSERT(tuple_count > 0);
+  PL_ASSERT(tile->IsCompressed() == false);
+
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    compressed_columns.emplace_back(
+        new CompressedColumn(tile, column_itr, tuple_count));
+    tile_size += compressed_columns.back()->GetSize();
+  }
+}
+
 Tile::~Tile() {
   // reclaim the tile memory (INLINED data)
-  auto &storage_manager = storage::StorageManager::GetInstance();
-  storage_manager.Release(backend_type, data);
-  data = NULL;
+  if (data != NULL) {
+    auto &storage_manager = storage::StorageManager::GetInstance();
+    storage_manager.Release(backend_type, data);
+    data = NULL;
+  }
 
   // reclaim the tile memory (UNINLINED data)
   // if (schema.IsInlined() == false) {
@@ -94,6 +125,7 @@ Tile::~Tile() {
  */
 void Tile::InsertTuple(const oid_t tuple_offset, Tuple *tuple) {
   PL_ASSERT(tuple_offset < GetAllocatedTupleCount());
+  PL_ASSERT(IsCompressed() == false);
 
   // Find slot location
   char *location = tuple_offset * tuple_length + data;
@@ -110,6 +142,10 @@ type::Value Tile::GetValue(const oid_t tuple_offset, const oid_t column_id) {
   PL_ASSERT(tuple_offset < GetAllocatedTupleCount());
   PL_ASSERT(column_id < schema.GetColumnCount());
 
+  if (IsCompressed() == true) {
+    return compressed_columns[column_id]->GetValue(tuple_offset);
+  }
+
   const type::Type::TypeId column_type = schema.GetType(column_id);
 
   const char *tuple_location = GetTupleLocation(tuple_offset);
@@ -132,6 +168,11 @@ type::Value Tile::GetValueFast(const oid_t tuple_offset,
   PL_ASSERT(tuple_offset < GetAllocatedTupleCount());
   PL_ASSERT(column_offset < schema.GetLength());
 
+  if (IsCompressed() == true) {
+    return compressed_columns[GetColumnIdAtOffset(column_offset)]->GetValue(
+        tuple_offset);
+  }
+
   const char *tuple_location = GetTupleLocation(tuple_offset);
   const char *field_location = tuple_location + column_offset;
 
@@ -139,6 +180,21 @@ type::Value Tile::GetValueFast(const oid_t tuple_offset,
                                         is_inlined);
 }
 
+// The columns are laid out in order, the offsets only grow
+oid_t Tile::GetColumnIdAtOffset(const size_t column_offset) const {
+  oid_t low = 0, high = column_count - 1;
+  while (low < high) {
+    oid_t middle = (low + high + 1) / 2;
+    if (schema.GetOffset(middle) <= column_offset) {
+      low = middle;
+    } else {
+      high = middle - 1;
+    }
+  }
+  PL_ASSERT(schema.GetOffset(low) == column_offset);
+  return low;
+}
+
 /**
  * Sets value at tuple slot.
  */
@@ -147,6 +203,7 @@ void Tile::SetValue(const type::Value &value, const oid_t tuple_offset,
                     const oid_t column_id) {
   PL_ASSERT(tuple_offset < num_tuple_slots);
   PL_ASSERT(column_id < schema.GetColumnCount());
+  PL_ASSERT(IsCompressed() == false);
 
   char *tuple_location = GetTupleLocation(tuple_offset);
   char *field_location = tuple_location + schema.GetOffset(column_id);
@@ -169,6 +226,7 @@ void Tile::SetValueFast(const type::Value &value, const oid_t tuple_offset,
                         UNUSED_ATTRIBUTE const size_t column_length) {
   PL_ASSERT(tuple_offset < num_tuple_slots);
   PL_ASSERT(column_offset < schema.GetLength());
+  PL_ASSERT(IsCompressed() == false);
 
   char *tuple_location = GetTupleLocation(tuple_offset);
   char *field_location = tuple_location + column_offset;
@@ -229,6 +287,20 @@ const std::string Tile::GetInfo() const {
   // Tuples
   os << GETINFO_SINGLE_LINE << std::endl;
 
+  if (IsCompressed() == true) {
+    for (oid_t tuple_itr = 0; tuple_itr < num_tuple_slots; tuple_itr++) {
+      if (tuple_itr > 0) os << std::endl;
+      os << std::setfill('0') << std::setw(TUPLE_ID_WIDTH) << tuple_itr
+         << ": ";
+      for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+        os << "(" << compressed_columns[column_itr]->GetValue(tuple_itr)
+                         .ToString()
+           << ")";
+      }
+    }
+    return os.str();
+  }
+
   TupleIterator tile_itr(this);
   Tuple tuple(&schema);
 
@@ -23,6 +23,7 @@
 #include "storage/tile.h"
 #include "storage/tile_group_header.h"
 #include "storage/tuple.h"
+#include "storage/zone_map.h"
 
 namespace peloton {
 namespace storage {
@@ -37,6 +38,7 @@ TileGroup::TileGroup(BackendType backend_type,
       backend_type(backend_type),
       tile_schemas(schemas),
       tile_group_header(tile_group_header),
+      tile_group_header_owner(tile_group_header),
       table(table),
       num_tuple_slots(tuple_count),
       column_map(column_map) {
@@ -53,13 +55,75 @@ TileGroup::TileGroup(BackendType backend_type,
     // Add a reference to the tile in the tile group
     tiles.push_back(tile);
   }
+
+  zone_map.reset(new ZoneMap(GetColumnTypes()));
 }
 
-TileGroup::~TileGroup() {
-  // Drop references on all tiles
+TileGroup::TileGroup(TileGroup *tile_group)
+    : database_id(INVALID_OID),
+      table_id(INVALID_OID),
+      tile_group_id(INVALID_OID),
+      backend_type(tile_group->backend_type),
+      tile_schemas(tile_group->tile_schemas),
+      tile_group_header(tile_group->tile_group_header),
+      tile_group_header_owner(tile_group->tile_group_header_owner),
+      table(tile_group->table),
+      num_tuple_slots(tile_group->num_tuple_slots),
+      tile_count(tile_group->tile_count),
+      column_map(tile_group->column_map) {
+  for (oid_t tile_itr = 0; tile_itr < tile_count; tile_itr++) {
+    auto &manager = catalog::Manager::GetInstance();
+    oid_t tile_id = manager.GetNextTileId();
 
-  // clean up tile group header
-  delete tile_group_header;
+    std::shared_ptr<Tile> tile(storage::TileFactory::GetCompressedTile(
+        tile_id, tile_group->GetTile(tile_itr), this, num_tuple_slots));
+
+    tiles.push_back(tile);
+  }
+
+  // The values do not change any more, the ranges get exact
+  zone_map.reset(new ZoneMap(GetColumnTypes()));
+  oid_t column_count = column_map.size();
+  for (oid_t tuple_itr = 0; tuple_itr < num_tuple_slots; tuple_itr++) {
+    for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+      zone_map->UpdateColumn(column_itr,
+                             tile_group->GetValue(tuple_itr, column_itr));
+    }
+  }
+}
+
+TileGroup::TileGroup(TileGroup *tile_group,
+                     const std::vector<catalog::Schema> &schemas,
+                     const column_map_type &column_map)
+    : database_id(INVALID_OID),
+      table_id(INVALID_OID),
+      tile_group_id(INVALID_OID),
+      backend_type(tile_group->backend_type),
+      tile_schemas(schemas),
+      tile_group_header(tile_group->tile_group_header),
+      tile_group_header_owner(tile_group->tile_group_header_owner),
+      table(tile_group->table),
+      num_tuple_slots(tile_group->num_tuple_slots),
+      column_map(column_map),
+      zone_map(tile_group->zone_map) {
+  tile_count = tile_schemas.size();
+
+  for (oid_t tile_itr = 0; tile_itr < tile_count; tile_itr++) {
+    auto &manager = catalog::Manager::GetInstance();
+    oid_t tile_id = manager.GetNextTileId();
+
+    std::shared_ptr<Tile> tile(storage::TileFactory::GetTile(
+        backend_type, tile_group->database_id, tile_group->table_id,
+        tile_group->tile_group_id, tile_id, tile_group_header,
+        tile_schemas[tile_itr], this, num_tuple_slots));
+
+    tiles.push_back(tile);
+  }
+}
+
+TileGroup::~TileGroup() {
+  // Drop references on all tiles, the header goes with the last tile group
+  // sharing it
 }
 
 oid_t TileGroup::GetTileId(const oid_t tile_id) const {
@@ -118,6 +182,7 @@ void TileGroup::CopyTuple(const Tuple *tuple, const oid_t &tuple_slot_id) {
          tile_column_itr++) {
       type::Value val = (tuple->GetValue(column_itr));
       tile_tuple.SetValue(tile_column_itr, val, tile->GetPool());
+      zone_map->UpdateColumn(column_itr, val);
       column_itr++;
     }
   }
@@ -201,6 +266,7 @@ oid_t TileGroup::InsertTupleFromRecovery(cid_t commit_id, oid_t tuple_slot_id,
          tile_column_itr++) {
       type::Value val = (tuple->GetValue(column_itr));
       tile_tuple.SetValue(tile_column_itr, val, tile->GetPool());
+      zone_map->UpdateColumn(column_itr, val);
       column_itr++;
     }
   }
@@ -301,6 +367,7 @@ oid_t TileGroup::InsertTupleFromCheckpoint(oid_t tuple_slot_id,
          tile_column_itr++) {
       type::Value val = (tuple->GetValue(column_itr));
       tile_tuple.SetValue(tile_column_itr, val, tile->GetPool());
+      zone_map->UpdateColumn(column_itr, val);
       column_itr++;
     }
   }
@@ -339,6 +406,16 @@ void TileGroup::SetValue(type::Value &value, oid_t tuple_id,
   oid_t tile_column_id, tile_offset;
   LocateTileAndColumn(column_id, tile_offset, tile_column_id);
   GetTile(tile_offset)->SetValue(value, tuple_id, tile_column_id);
+  zone_map->UpdateColumn(column_id, value);
+}
+
+std::vector<type::Type::TypeId> TileGroup::GetColumnTypes() const {
+  std::vector<type::Type::TypeId> column_types;
+  for (auto &entry : column_map) {
+    auto &tile_schema = tile_schemas[entry.second.first];
+    column_types.push_back(tile_schema.GetType(entry.second.second));
+  }
+  return column_types;
 }
 
 
@@ -45,5 +45,32 @@ TileGroup *TileGroupFactory::GetTileGroup(
   return tile_group;
 }
 
+TileGroup *TileGroupFactory::GetCompressedTileGroup(TileGroup *tile_group) {
+  PL_ASSERT(tile_group->GetHeader()->IsFrozen() == true);
+
+  TileGroup *compressed_tile_group = new TileGroup(tile_group);
+
+  compressed_tile_group->database_id = tile_group->database_id;
+  compressed_tile_group->tile_group_id = tile_group->tile_group_id;
+  compressed_tile_group->table_id = tile_group->table_id;
+
+  return compressed_tile_group;
+}
+
+TileGroup *TileGroupFactory::GetTransformedTileGroup(
+    TileGroup *tile_group, const std::vector<catalog::Schema> &schemas,
+    const column_map_type &column_map) {
+  PL_ASSERT(tile_group->GetHeader()->IsTransforming() == true);
+
+  TileGroup *transformed_tile_group =
+      new TileGroup(tile_group, schemas, column_map);
+
+  transformed_tile_group->database_id = tile_group->database_id;
+  transformed_tile_group->tile_group_id = tile_group->tile_group_id;
+  transformed_tile_group->table_id = tile_group->table_id;
+
+  return transformed_tile_group;
+}
+
 }  // End storage namespace
 }  // End peloton namespace
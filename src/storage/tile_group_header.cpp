@@ -35,7 +35,11 @@ TileGroupHeader::TileGroupHeader(const BackendType &backend_type,
       data(nullptr),
       num_tuple_slots(tuple_count),
       next_tuple_slot(0),
-      tile_header_lock() {
+      tile_header_lock(),
+      frozen(false),
+      transforming(false),
+      read_count(0),
+      write_count(0) {
   header_size = num_tuple_slots * header_entry_size;
 
   // allocate storage space for header
@@ -165,6 +169,11 @@ void TileGroupHeader::Sync() {
   storage_manager.Sync(backend_type, data, header_size);
 }
 
+void TileGroupHeader::DecayAccessCounts() {
+  read_count.store(GetReadCount() / 2, std::memory_order_relaxed);
+  write_count.store(GetWriteCount() / 2, std::memory_order_relaxed);
+}
+
 void TileGroupHeader::PrintVisibility(txn_id_t txn_id, cid_t at_cid) {
   oid_t active_tuple_slots = GetCurrentNextTupleSlot();
   std::stringstream os;
@@ -0,0 +1,224 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// zone_map.cpp
+//
+// Identification: src/storage/zone_map.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/zone_map.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "common/macros.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace storage {
+
+namespace {
+
+const uint64_t sign_bit = 1ULL << 63;
+
+bool IsNumeric(const type::Type::TypeId type_id) {
+  switch (type_id) {
+    case type::Type::TINYINT:
+    case type::Type::SMALLINT:
+    case type::Type::INTEGER:
+    case type::Type::BIGINT:
+    case type::Type::DECIMAL:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Keys order like the values as unsigned integers
+uint64_t GetKey(const type::Value &value) {
+  switch (value.GetTypeId()) {
+    case type::Type::TINYINT:
+      return static_cast<uint64_t>(int64_t(value.GetAs<int8_t>())) ^ sign_bit;
+    case type::Type::SMALLINT:
+      return static_cast<uint64_t>(int64_t(value.GetAs<int16_t>())) ^
+             sign_bit;
+    case type::Type::INTEGER:
+      return static_cast<uint64_t>(int64_t(value.GetAs<int32_t>())) ^
+             sign_bit;
+    case type::Type::BIGINT:
+      return static_cast<uint64_t>(value.GetAs<int64_t>()) ^ sign_bit;
+    case type::Type::DECIMAL: {
+      double decimal = value.GetAs<double>();
+      uint64_t bits;
+      std::memcpy(&bits, &decimal, sizeof(bits));
+      return (bits & sign_bit) ? ~bits : bits | sign_bit;
+    }
+    default:
+      return value.GetAs<uint64_t>();
+  }
+}
+
+type::Value GetKeyValue(const type::Type::TypeId type_id, const uint64_t key) {
+  auto integer = static_cast<int64_t>(key ^ sign_bit);
+  switch (type_id) {
+    case type::Type::TINYINT:
+      return type::ValueFactory::GetTinyIntValue(integer);
+    case type::Type::SMALLINT:
+      return type::ValueFactory::GetSmallIntValue(integer);
+    case type::Type::INTEGER:
+      return type::ValueFactory::GetIntegerValue(integer);
+    case type::Type::BIGINT:
+      return type::ValueFactory::GetBigIntValue(integer);
+    case type::Type::DECIMAL: {
+      uint64_t bits = (key & sign_bit) ? key ^ sign_bit : ~key;
+      double decimal;
+      std::memcpy(&decimal, &bits, sizeof(decimal));
+      return type::ValueFactory::GetDecimalValue(decimal);
+    }
+    default:
+      return type::ValueFactory::GetTimestampValue(key);
+  }
+}
+
+void AtomicMin(std::atomic<uint64_t> &target, const uint64_t key) {
+  auto current = target.load();
+  while (key < current && target.compare_exchange_weak(current, key) == false)
+    ;
+}
+
+void AtomicMax(std::atomic<uint64_t> &target, const uint64_t key) {
+  auto current = target.load();
+  while (key > current && target.compare_exchange_weak(current, key) == false)
+    ;
+}
+
+bool IsTrue(const type::CmpBool result) { return result == type::CMP_TRUE; }
+
+}  // namespace
+
+ZoneMap::ZoneMap(const std::vector<type::Type::TypeId> &column_types)
+    : column_count_(column_types.size()),
+      columns_(new ColumnZone[column_types.size()]) {
+  for (oid_t column_itr = 0; column_itr < column_count_; column_itr++) {
+    auto &column = columns_[column_itr];
+    column.type_id = column_types[column_itr];
+    column.min_key = std::numeric_limits<uint64_t>::max();
+    column.max_key = 0;
+    column.unbounded = false;
+    column.null_count = 0;
+  }
+}
+
+bool ZoneMap::HasRange(const type::Type::TypeId type_id) {
+  return IsNumeric(type_id) || type_id == type::Type::TIMESTAMP;
+}
+
+void ZoneMap::UpdateColumn(const oid_t column_id, const type::Value &value) {
+  PL_ASSERT(column_id < column_count_);
+  auto &column = columns_[column_id];
+
+  if (value.IsNull() == true) {
+    column.null_count++;
+    return;
+  }
+  if (HasRange(column.type_id) == false) {
+    return;
+  }
+
+  // NaNs do not order, no range covers them
+  if (value.GetTypeId() == type::Type::DECIMAL &&
+      std::isnan(value.GetAs<double>())) {
+    column.unbounded = true;
+    return;
+  }
+
+  auto key = GetKey(value);
+  AtomicMin(column.min_key, key);
+  AtomicMax(column.max_key, key);
+}
+
+bool ZoneMap::MayMatch(const oid_t column_id, const ExpressionType comparison,
+                       const type::Value &constant) const {
+  if (column_id >= column_count_) {
+    return true;
+  }
+  auto &column = columns_[column_id];
+
+  if (comparison == ExpressionType::OPERATOR_IS_NULL) {
+    return column.null_count > 0;
+  }
+
+  if (HasRange(column.type_id) == false) {
+    return true;
+  }
+  // Comparisons with NULL are never true
+  if (constant.IsNull() == true) {
+    return false;
+  }
+  if (column.unbounded == true) {
+    return true;
+  }
+  auto min_value = type::ValueFactory::GetNullValueByType(column.type_id);
+  auto max_value = type::ValueFactory::GetNullValueByType(column.type_id);
+  if (GetRange(column_id, min_value, max_value) == false) {
+    return false;
+  }
+
+  auto constant_type = constant.GetTypeId();
+  bool comparable = (constant_type == column.type_id) ||
+                    (IsNumeric(constant_type) && IsNumeric(column.type_id));
+  if (comparable == false) {
+    return true;
+  }
+
+  switch (comparison) {
+    case ExpressionType::COMPARE_EQUAL:
+      return IsTrue(min_value.CompareLessThanEquals(constant)) &&
+             IsTrue(max_value.CompareGreaterThanEquals(constant));
+    case ExpressionType::COMPARE_NOTEQUAL:
+      return !(IsTrue(min_value.CompareEquals(constant)) &&
+               IsTrue(max_value.CompareEquals(constant)));
+    case ExpressionType::COMPARE_LESSTHAN:
+      return IsTrue(min_value.CompareLessThan(constant));
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      return IsTrue(min_value.CompareLessThanEquals(constant));
+    case ExpressionType::COMPARE_GREATERTHAN:
+      return IsTrue(max_value.CompareGreaterThan(constant));
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      return IsTrue(max_value.CompareGreaterThanEquals(constant));
+    default:
+      return true;
+  }
+}
+
+bool ZoneMap::GetRange(const oid_t column_id, type::Value &min_value,
+                       type::Value &max_value) const {
+  PL_ASSERT(column_id < column_count_);
+  auto &column = columns_[column_id];
+  if (HasRange(column.type_id) == false || column.unbounded == true) {
+    return false;
+  }
+
+  uint64_t min_key = column.min_key;
+  uint64_t max_key = column.max_key;
+  if (min_key > max_key) {
+    return false;
+  }
+
+  min_value = GetKeyValue(column.type_id, min_key);
+  max_value = GetKeyValue(column.type_id, max_key);
+  return true;
+}
+
+oid_t ZoneMap::GetNullCount(const oid_t column_id) const {
+  PL_ASSERT(column_id < column_count_);
+  return columns_[column_id].null_count;
+}
+
+}  // End storage namespace
+}  // End peloton namespace
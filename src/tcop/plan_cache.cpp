@@ -0,0 +1,341 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// plan_cache.cpp
+//
+// Identification: src/tcop/plan_cache.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "tcop/plan_cache.h"
+
+#include <cctype>
+#include <cstdlib>
+
+#include "common/logger.h"
+#include "type/value_factory.h"
+#include "util/string_util.h"
+
+namespace peloton {
+namespace tcop {
+
+namespace {
+
+enum class TokenType { WORD, QUOTED_WORD, STRING, NUMBER, SYMBOL };
+
+struct Token {
+  TokenType type;
+  std::string text;
+};
+
+inline bool IsWordChar(char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+inline bool IsDigit(char c) {
+  return std::isdigit(static_cast<unsigned char>(c));
+}
+
+// Splits the query like the SQL scanner does. Returns false for anything the
+// fingerprint could not represent faithfully (comments, placeholders,
+// unterminated quotes).
+bool Tokenize(const std::string &query, std::vector<Token> &tokens) {
+  size_t itr = 0;
+  size_t length = query.size();
+  while (itr < length) {
+    char c = query[itr];
+    size_t start = itr;
+
+    if (std::isspace(static_cast<unsigned char>(c))) {
+      ++itr;
+    } else if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+      while (itr < length && IsWordChar(query[itr])) ++itr;
+      tokens.push_back({TokenType::WORD, query.substr(start, itr - start)});
+    } else if (IsDigit(c) ||
+               (c == '.' && itr + 1 < length && IsDigit(query[itr + 1]))) {
+      while (itr < length && IsDigit(query[itr])) ++itr;
+      if (itr < length && query[itr] == '.') {
+        ++itr;
+        while (itr < length && IsDigit(query[itr])) ++itr;
+      }
+      if (itr < length && IsWordChar(query[itr])) {
+        return false;
+      }
+      tokens.push_back({TokenType::NUMBER, query.substr(start, itr - start)});
+    } else if (c == '\'' || c == '"') {
+      auto end = query.find(c, itr + 1);
+      if (end == std::string::npos) {
+        return false;
+      }
+      itr = end + 1;
+      tokens.push_back(
+          {c == '\'' ? TokenType::STRING : TokenType::QUOTED_WORD,
+           query.substr(start, itr - start)});
+    } else if (c == '$' || c == '?' ||
+               (c == '-' && itr + 1 < length && query[itr + 1] == '-')) {
+      return false;
+    } else {
+      char next = (itr + 1 < length) ? query[itr + 1] : '\0';
+      if ((c == '<' && (next == '=' || next == '>')) ||
+          (c == '>' && next == '=') || (c == '!' && next == '=')) {
+        itr += 2;
+      } else {
+        ++itr;
+      }
+      tokens.push_back({TokenType::SYMBOL, query.substr(start, itr - start)});
+    }
+  }
+  return true;
+}
+
+// Converts a literal the way the parser would. Returns false for literals
+// that have to stay in the query text.
+bool LiftLiteral(const Token &token, std::vector<type::Value> &params) {
+  if (token.type == TokenType::STRING) {
+    params.push_back(type::ValueFactory::GetVarcharValue(
+        token.text.substr(1, token.text.size() - 2)));
+    return true;
+  }
+
+  if (token.text.find('.') != std::string::npos) {
+    params.push_back(
+        type::ValueFactory::GetDecimalValue(std::atof(token.text.c_str())));
+    return true;
+  }
+
+  auto value = std::strtoll(token.text.c_str(), nullptr, 10);
+  if (value > type::PELOTON_INT32_MAX) {
+    return false;
+  }
+  params.push_back(
+      type::ValueFactory::GetIntegerValue(static_cast<int32_t>(value)));
+  return true;
+}
+
+// Where we are in the VALUES list of an INSERT
+enum class InsertState {
+  BEFORE_VALUES,
+  EXPECT_OPEN,
+  EXPECT_LITERAL,
+  EXPECT_SEPARATOR,
+  DONE
+};
+
+}  // namespace
+
+PlanCache::PlanCache() : version_(0) {}
+
+PlanCache &PlanCache::GetInstance() {
+  static PlanCache plan_cache;
+  return plan_cache;
+}
+
+std::shared_ptr<Statement> PlanCache::Acquire(const std::string &fingerprint,
+                                              bool &cacheable,
+                                              size_t &version) {
+  cacheable = true;
+  version = version_.load();
+
+  auto &partition = GetPartition(fingerprint);
+  std::lock_guard<std::mutex> lock(partition.mutex_);
+  auto query_itr = partition.queries_.find(fingerprint);
+  if (query_itr == partition.queries_.end()) {
+    return nullptr;
+  }
+
+  auto query = *query_itr;
+  if (query->cacheable_ == false) {
+    cacheable = false;
+    return nullptr;
+  }
+  if (query->idle_statements_.empty()) {
+    return nullptr;
+  }
+
+  auto statement = query->idle_statements_.back();
+  query->idle_statements_.pop_back();
+  return statement;
+}
+
+void PlanCache::Release(const std::string &fingerprint,
+                        const std::shared_ptr<Statement> &statement,
+                        const size_t version) {
+  auto &partition = GetPartition(fingerprint);
+  std::lock_guard<std::mutex> lock(partition.mutex_);
+
+  // The plan might reference a table that has been dropped since
+  if (version != version_.load()) {
+    return;
+  }
+
+  std::shared_ptr<CachedQuery> query;
+  auto query_itr = partition.queries_.find(fingerprint);
+  if (query_itr == partition.queries_.end()) {
+    query.reset(new CachedQuery(fingerprint, statement->GetReferencedTables(),
+                                true));
+    partition.queries_.insert(std::make_pair(fingerprint, query));
+  } else {
+    query = *query_itr;
+  }
+
+  if (query->cacheable_ == true &&
+      query->idle_statements_.size() < PLAN_CACHE_MAX_IDLE_STATEMENTS) {
+    query->idle_statements_.push_back(statement);
+  }
+}
+
+void PlanCache::MarkUncacheable(const std::string &fingerprint,
+                                const size_t version) {
+  LOG_TRACE("Query can not be cached: %s", fingerprint.c_str());
+  auto &partition = GetPartition(fingerprint);
+  std::lock_guard<std::mutex> lock(partition.mutex_);
+  if (version != version_.load()) {
+    return;
+  }
+
+  std::shared_ptr<CachedQuery> query(
+      new CachedQuery(fingerprint, std::set<oid_t>(), false));
+  partition.queries_.insert(std::make_pair(fingerprint, query));
+}
+
+void PlanCache::InvalidateTable(oid_t table_id) {
+  LOG_TRACE("Invalidating cached plans of table %u", table_id);
+  Invalidate([table_id](const CachedQuery &query) {
+    return query.table_ids_.find(table_id) != query.table_ids_.end();
+  });
+}
+
+void PlanCache::Clear() {
+  Invalidate([](const CachedQuery &) { return true; });
+}
+
+template <typename Predicate>
+void PlanCache::Invalidate(Predicate predicate) {
+  // Bump the version first, so that no plan that is being built or executed
+  // right now makes it back into the cache
+  version_++;
+
+  for (auto &partition : partitions_) {
+    std::lock_guard<std::mutex> lock(partition.mutex_);
+    std::vector<std::string> fingerprints;
+    for (auto query_itr = partition.queries_.begin();
+         query_itr != partition.queries_.end(); ++query_itr) {
+      auto query = *query_itr;
+      if (predicate(*query)) {
+        fingerprints.push_back(query->fingerprint_);
+      }
+    }
+    for (auto &fingerprint : fingerprints) {
+      partition.queries_.delete_key(fingerprint);
+    }
+  }
+}
+
+size_t PlanCache::GetSize() {
+  size_t size = 0;
+  for (auto &partition : partitions_) {
+    std::lock_guard<std::mutex> lock(partition.mutex_);
+    size += partition.queries_.size();
+  }
+  return size;
+}
+
+bool PlanCache::Parameterize(const std::string &query, std::string &fingerprint,
+                             std::vector<type::Value> &params) {
+  std::vector<Token> tokens;
+  if (Tokenize(query, tokens) == false || tokens.empty() ||
+      tokens[0].type != TokenType::WORD) {
+    return false;
+  }
+
+  auto query_type = StringUtil::Upper(tokens[0].text);
+  bool is_insert = (query_type == "INSERT");
+  if (is_insert == false && query_type != "SELECT" && query_type != "UPDATE" &&
+      query_type != "DELETE") {
+    return false;
+  }
+
+  // Literals are only lifted where the planner binds parameters: in the
+  // WHERE and SET clauses, but not in LIMIT / OFFSET, and in a single-row
+  // VALUES list made of literals only. Signed literals stay in the query.
+  bool lifting = false;
+  auto insert_state = InsertState::BEFORE_VALUES;
+  std::string previous_word;
+  std::string previous_text;
+
+  fingerprint.clear();
+  params.clear();
+  for (auto &token : tokens) {
+    std::string text = token.text;
+
+    if (token.type == TokenType::WORD) {
+      auto word = StringUtil::Upper(text);
+      if (is_insert == true) {
+        if (insert_state != InsertState::BEFORE_VALUES) {
+          return false;
+        }
+        if (word == "VALUES") {
+          insert_state = InsertState::EXPECT_OPEN;
+        }
+      } else if (word == "WHERE" || word == "SET") {
+        lifting = true;
+      } else if (word == "SELECT" || word == "GROUP" || word == "ORDER" ||
+                 word == "HAVING") {
+        lifting = false;
+      }
+      previous_word = word;
+    } else if (token.type == TokenType::NUMBER ||
+               token.type == TokenType::STRING) {
+      bool lift = lifting == true && previous_word != "LIMIT" &&
+                  previous_word != "OFFSET" && previous_text != "-" &&
+                  previous_text != "+";
+      if (is_insert == true) {
+        if (insert_state != InsertState::EXPECT_LITERAL) {
+          return false;
+        }
+        insert_state = InsertState::EXPECT_SEPARATOR;
+        lift = true;
+      }
+
+      if (lift == true && LiftLiteral(token, params) == true) {
+        text = "$" + std::to_string(params.size());
+      } else if (is_insert == true) {
+        return false;
+      }
+      previous_word.clear();
+    } else {
+      if (is_insert == true) {
+        if (insert_state == InsertState::EXPECT_OPEN && text == "(") {
+          insert_state = InsertState::EXPECT_LITERAL;
+        } else if (insert_state == InsertState::EXPECT_SEPARATOR &&
+                   text == ",") {
+          insert_state = InsertState::EXPECT_LITERAL;
+        } else if (insert_state == InsertState::EXPECT_SEPARATOR &&
+                   text == ")") {
+          insert_state = InsertState::DONE;
+        } else if (insert_state != InsertState::BEFORE_VALUES &&
+                   (insert_state != InsertState::DONE || text != ";")) {
+          return false;
+        }
+      }
+      previous_word.clear();
+    }
+
+    previous_text = token.text;
+    if (fingerprint.empty() == false) {
+      fingerprint += ' ';
+    }
+    fingerprint += text;
+  }
+
+  if (is_insert == true && insert_state != InsertState::DONE) {
+    return false;
+  }
+  return true;
+}
+
+}  // End tcop namespace
+}  // End peloton namespace
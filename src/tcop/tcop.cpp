@@ -33,6 +33,8 @@
 #include "optimizer/simple_optimizer.h"
 
 #include "planner/plan_util.h"
+#include "statistics/backend_stats_context.h"
+#include "tcop/plan_cache.h"
 
 #include <boost/algorithm/string.hpp>
 
@@ -135,6 +137,18 @@ ResultType TrafficCop::ExecuteStatement(
     std::string &error_message) {
   LOG_TRACE("Received %s", query.c_str());
 
+  // Queries that only differ in their literals share a cached plan
+  std::string fingerprint;
+  std::vector<type::Value> cached_params;
+  if (PlanCache::Parameterize(query, fingerprint, cached_params) == true) {
+    ResultType status;
+    if (ExecuteCachedStatement(fingerprint, cached_params, result,
+                               tuple_descriptor, rows_changed, error_message,
+                               status) == true) {
+      return status;
+    }
+  }
+
   // Prepare the statement
   std::string unnamed_statement = "unnamed";
   auto statement = PrepareStatement(unnamed_statement, query, error_message);
@@ -154,6 +168,14 @@ ResultType TrafficCop::ExecuteStatement(
   if (status == ResultType::SUCCESS) {
     LOG_TRACE("Execution succeeded!");
     tuple_descriptor = std::move(statement->GetTupleDescriptor());
+
+    // Cached plans may depend on the schema that just changed
+    auto query_type = statement->GetQueryType();
+    if (boost::iequals(query_type, "CREATE") ||
+        boost::iequals(query_type, "DROP") ||
+        boost::iequals(query_type, "ALTER")) {
+      PlanCache::GetInstance().Clear();
+    }
   } else {
     LOG_TRACE("Execution failed!");
   }
@@ -161,6 +183,51 @@ ResultType TrafficCop::ExecuteStatement(
   return status;
 }
 
+bool TrafficCop::ExecuteCachedStatement(
+    const std::string &fingerprint, std::vector<type::Value> &params,
+    std::vector<StatementResult> &result,
+    std::vector<FieldInfo> &tuple_descriptor, int &rows_changed,
+    std::string &error_message, ResultType &status) {
+  auto &plan_cache = PlanCache::GetInstance();
+  bool cacheable;
+  size_t version;
+  auto statement = plan_cache.Acquire(fingerprint, cacheable, version);
+  if (cacheable == false) {
+    return false;
+  }
+
+  if (statement.get() == nullptr) {
+    std::string prepare_error;
+    statement = PrepareStatement("unnamed", fingerprint, prepare_error);
+    // Only plans over tables can be invalidated when the catalog changes
+    if (statement.get() == nullptr ||
+        statement->GetPlanTree().get() == nullptr ||
+        statement->GetReferencedTables().empty()) {
+      plan_cache.MarkUncacheable(fingerprint, version);
+      return false;
+    }
+  }
+
+  try {
+    statement->GetPlanTree()->SetParameterValues(&params);
+  } catch (Exception &e) {
+    // The literals do not fit the plan, e.g. a string for an integer column
+    LOG_TRACE("Binding cached plan failed: %s", e.what());
+    plan_cache.MarkUncacheable(fingerprint, version);
+    return false;
+  }
+
+  std::vector<int> result_format(statement->GetTupleDescriptor().size(), 0);
+  status = ExecuteStatement(statement, params, true, nullptr, result_format,
+                            result, rows_changed, error_message);
+  if (status == ResultType::SUCCESS) {
+    tuple_descriptor = statement->GetTupleDescriptor();
+  }
+
+  plan_cache.Release(fingerprint, statement, version);
+  return true;
+}
+
 ResultType TrafficCop::ExecuteStatement(
     const std::shared_ptr<Statement> &statement,
     const std::vector<type::Value> &params, UNUSED_ATTRIBUTE const bool unnamed,
@@ -185,9 +252,12 @@ ResultType TrafficCop::ExecuteStatement(
       return CommitQueryHelper();
     else if (statement->GetQueryType() == "ROLLBACK")
       return AbortQueryHelper();
+    else if (boost::iequals(statement->GetQueryType(), "EXPLAIN"))
+      return ExplainQueryHelper(statement, params, result, rows_changed);
     else {
       auto status = ExecuteStatementPlan(statement->GetPlanTree().get(), params,
-                                         result, result_format);
+                                         result, result_format, nullptr,
+                                         statement->GetExecutorTreeCache());
       LOG_TRACE("Statement executed. Result: %s",
                 ResultTypeToString(status.m_result).c_str());
       rows_changed = status.m_processed;
@@ -201,7 +271,8 @@ ResultType TrafficCop::ExecuteStatement(
 
 bridge::peloton_status TrafficCop::ExecuteStatementPlan(
     const planner::AbstractPlan *plan, const std::vector<type::Value> &params,
-    std::vector<StatementResult> &result, const std::vector<int> &result_format) {
+    std::vector<StatementResult> &result, const std::vector<int> &result_format,
+    std::string *profile_info, bridge::ExecutorTreeCache *tree_cache) {
   concurrency::Transaction *txn;
   bool single_statement_txn = false, init_failure = false;
   bridge::peloton_status p_status;
@@ -222,8 +293,8 @@ bridge::peloton_status TrafficCop::ExecuteStatementPlan(
   // skip if already aborted
   if (curr_state.second != ResultType::ABORTED) {
     PL_ASSERT(txn);
-    p_status = bridge::PlanExecutor::ExecutePlan(plan, txn, params, result,
-                                                 result_format);
+    p_status = bridge::PlanExecutor::ExecutePlan(
+        plan, txn, params, result, result_format, profile_info, tree_cache);
 
     if (p_status.m_result == ResultType::FAILURE) {
       // only possible if init failed
@@ -261,6 +332,75 @@ bridge::peloton_status TrafficCop::ExecuteStatementPlan(
   return p_status;
 }
 
+ResultType TrafficCop::ExplainQueryHelper(
+    const std::shared_ptr<Statement> &statement,
+    const std::vector<type::Value> &params,
+    std::vector<StatementResult> &result, int &rows_changed) {
+  std::string explained_query;
+  bool analyze = false;
+  ParseExplain(statement->GetQueryString(), explained_query, analyze);
+
+  std::string plan_info;
+  ResultType status = ResultType::SUCCESS;
+  if (analyze == true) {
+    std::vector<StatementResult> query_result;
+    std::vector<int> result_format;
+    auto p_status =
+        ExecuteStatementPlan(statement->GetPlanTree().get(), params,
+                             query_result, result_format, &plan_info);
+    status = p_status.m_result;
+
+    if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
+      auto query_metric =
+          stats::BackendStatsContext::GetInstance()->GetOnGoingQueryMetric();
+      if (query_metric != nullptr) {
+        query_metric->SetExecutorProfile(plan_info);
+      }
+    }
+  } else {
+    plan_info =
+        planner::PlanUtil::GetExplainInfo(statement->GetPlanTree().get());
+  }
+
+  // One row per line of the annotated plan
+  std::vector<std::string> lines;
+  boost::split(lines, plan_info, boost::is_any_of("\n"));
+  result.clear();
+  for (auto &line : lines) {
+    if (line.empty()) continue;
+    auto res = StatementResult();
+    bridge::PlanExecutor::copyFromTo(line, res.second);
+    result.push_back(std::move(res));
+  }
+  rows_changed = result.size();
+
+  return status;
+}
+
+bool TrafficCop::ParseExplain(const std::string &query,
+                              std::string &explained_query, bool &analyze) {
+  std::istringstream stream(query);
+  std::string token;
+  stream >> token;
+  if (boost::iequals(token, "EXPLAIN") == false) {
+    return false;
+  }
+
+  auto position = stream.tellg();
+  token.clear();
+  stream >> token;
+  analyze = boost::iequals(token, "ANALYZE");
+  if (analyze == true) {
+    position = stream.tellg();
+  }
+
+  explained_query.clear();
+  if (position != std::istringstream::pos_type(-1)) {
+    explained_query = query.substr(position);
+  }
+  return true;
+}
+
 std::shared_ptr<Statement> TrafficCop::PrepareStatement(
     const std::string &statement_name, const std::string &query_string,
     UNUSED_ATTRIBUTE std::string &error_message) {
@@ -270,8 +410,14 @@ std::shared_ptr<Statement> TrafficCop::PrepareStatement(
   std::shared_ptr<Statement> statement(
       new Statement(statement_name, query_string));
   try {
+    // EXPLAIN [ANALYZE] plans the statement that follows it
+    std::string explained_query;
+    bool analyze = false;
+    bool explain = ParseExplain(query_string, explained_query, analyze);
+
     auto &peloton_parser = parser::Parser::GetInstance();
-    auto sql_stmt = peloton_parser.BuildParseTree(query_string);
+    auto sql_stmt = peloton_parser.BuildParseTree(
+        explain == true ? explained_query : query_string);
     if (sql_stmt->is_valid == false) {
       throw ParserException("Error parsing SQL statement");
     }
@@ -286,7 +432,11 @@ std::shared_ptr<Statement> TrafficCop::PrepareStatement(
 
     for (auto stmt : sql_stmt->GetStatements()) {
       LOG_TRACE("SQLStatement: %s", stmt->GetInfo().c_str());
-      if (stmt->GetType() == StatementType::SELECT) {
+      if (explain == true) {
+        std::vector<FieldInfo> tuple_descriptor = {GetColumnFieldForValueType(
+            "QUERY PLAN", type::Type::VARCHAR)};
+        statement->SetTupleDescriptor(tuple_descriptor);
+      } else if (stmt->GetType() == StatementType::SELECT) {
         auto tuple_descriptor = GenerateTupleDescriptor(stmt);
         statement->SetTupleDescriptor(tuple_descriptor);
       }
@@ -306,6 +456,30 @@ std::shared_ptr<Statement> TrafficCop::PrepareStatement(
   }
 }
 
+// Collects the tables a FROM clause joins, in order
+static void CollectTables(parser::TableRef *table_ref,
+                          std::vector<storage::DataTable *> &target_tables) {
+  switch (table_ref->type) {
+    case TableReferenceType::NAME:
+      target_tables.push_back(static_cast<storage::DataTable *>(
+          catalog::Catalog::GetInstance()->GetTableWithName(
+              table_ref->GetDatabaseName(),
+              table_ref->table_info_->table_name)));
+      break;
+    case TableReferenceType::JOIN:
+      CollectTables(table_ref->join->left, target_tables);
+      CollectTables(table_ref->join->right, target_tables);
+      break;
+    case TableReferenceType::CROSS_PRODUCT:
+      for (auto list_ref : *table_ref->list) {
+        CollectTables(list_ref, target_tables);
+      }
+      break;
+    default:
+      break;
+  }
+}
+
 std::vector<FieldInfo> TrafficCop::GenerateTupleDescriptor(
     parser::SQLStatement *sql_stmt) {
   std::vector<FieldInfo> tuple_descriptor;
@@ -323,46 +497,9 @@ std::vector<FieldInfo> TrafficCop::GenerateTupleDescriptor(
   // Set up the table
   std::vector<storage::DataTable *> target_tables;
 
-  // Check if query only has one Table
-  // Example : SELECT * FROM A;
-  if (select_stmt->from_table->list == NULL) {
-    if (select_stmt->from_table->join == NULL) {
-      auto *target_table = static_cast<storage::DataTable *>(
-          catalog::Catalog::GetInstance()->GetTableWithName(
-              select_stmt->from_table->GetDatabaseName(),
-              select_stmt->from_table->GetTableName()));
-      target_tables.push_back(target_table);
-    }
-    // TODO: Only consider the simplest case by joining a regular table
-    // to the other regular table.
-    // Example: SELECT * FROM A JOIN B ON A.id=B.id
-    else {
-      auto *left_table = static_cast<storage::DataTable *>(
-          catalog::Catalog::GetInstance()->GetTableWithName(
-              select_stmt->from_table->join->left->GetDatabaseName(),
-              select_stmt->from_table->join->left->GetTableName()));
-      target_tables.push_back(left_table);
-      auto *right_table = static_cast<storage::DataTable *>(
-          catalog::Catalog::GetInstance()->GetTableWithName(
-              select_stmt->from_table->join->right->GetDatabaseName(),
-              select_stmt->from_table->join->right->GetTableName()));
-      target_tables.push_back(right_table);
-    }
-  }
-
-  // Query has multiple tables
-  // Example: SELECT COUNT(ID) FROM A,B <Condition>
-  // For now we only pick the first table in the list
-  // FIX: Better handle for queries with multiple tables
-  else {
-    for (auto table : *select_stmt->from_table->list) {
-      auto *target_table = static_cast<storage::DataTable *>(
-          catalog::Catalog::GetInstance()->GetTableWithName(
-              table->GetDatabaseName(), table->GetTableName()));
-      target_tables.push_back(target_table);
-      break;
-    }
-  }
+  // Example : SELECT * FROM A, B JOIN C ON B.id = C.id;
+  // The columns of all tables are returned in the order of the FROM clause
+  CollectTables(select_stmt->from_table, target_tables);
 
   int count = 0;
   for (auto expr : *select_stmt->select_list) {
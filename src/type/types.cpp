@@ -344,6 +344,9 @@ std::string StatementTypeToString(StatementType type) {
     case StatementType::COPY: {
       return "COPY";
     }
+    case StatementType::ANALYZE: {
+      return "ANALYZE";
+    }
     case StatementType::INSERT: {
       return "INSERT";
     }
@@ -399,6 +402,8 @@ StatementType StringToStatementType(const std::string& str) {
     return StatementType::TRANSACTION;
   } else if (upper_str == "COPY") {
     return StatementType::COPY;
+  } else if (upper_str == "ANALYZE") {
+    return StatementType::ANALYZE;
   } else {
     throw ConversionException(StringUtil::Format(
         "No StatementType conversion from string '%s'", upper_str.c_str()));
@@ -1028,6 +1033,9 @@ std::string PlanNodeTypeToString(PlanNodeType type) {
     case PlanNodeType::COPY: {
       return ("COPY");
     }
+    case PlanNodeType::ANALYZE: {
+      return ("ANALYZE");
+    }
     case PlanNodeType::MOCK: {
       return ("MOCK");
     }
@@ -1100,6 +1108,8 @@ PlanNodeType StringToPlanNodeType(const std::string& str) {
     return PlanNodeType::RESULT;
   } else if (upper_str == "COPY") {
     return PlanNodeType::COPY;
+  } else if (upper_str == "ANALYZE") {
+    return PlanNodeType::ANALYZE;
   } else if (upper_str == "MOCK") {
     return PlanNodeType::MOCK;
   } else {
@@ -12,6 +12,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <errno.h>
 #include <unistd.h>
 #include "wire/libevent_server.h"
 #include "common/macros.h"
@@ -19,47 +20,55 @@
 namespace peloton {
 namespace wire {
 
-void WorkerHandleNewConn(evutil_socket_t new_conn_recv_fd,
-                         UNUSED_ATTRIBUTE short ev_flags, void *arg) {
-  // buffer used to receive messages from the main thread
-  char m_buf[1];
+namespace {
+
+// Packets that plan or execute a statement
+inline bool IsStatementPacket(NetworkMessageType msg_type) {
+  return msg_type == NetworkMessageType::SIMPLE_QUERY_COMMAND ||
+         msg_type == NetworkMessageType::PARSE_COMMAND ||
+         msg_type == NetworkMessageType::EXECUTE_COMMAND;
+}
+
+}  // namespace
+
+void WorkerHandleNotify(evutil_socket_t notify_fd,
+                        UNUSED_ATTRIBUTE short ev_flags, void *arg) {
+  // number of notifications since the last read, they may have coalesced
+  uint64_t notify_count;
   std::shared_ptr<NewConnQueueItem> item;
   LibeventSocket *conn;
   LibeventWorkerThread *thread = static_cast<LibeventWorkerThread *>(arg);
 
-  // pipe fds should match
-  PL_ASSERT(new_conn_recv_fd == thread->new_conn_receive_fd);
+  // eventfds should match
+  PL_ASSERT(notify_fd == thread->notify_fd);
 
-  // read the operation that needs to be performed
-  if (read(new_conn_recv_fd, m_buf, 1) != 1) {
-    LOG_ERROR("Can't read from the libevent pipe");
+  if (read(notify_fd, &notify_count, sizeof(notify_count)) !=
+      sizeof(notify_count)) {
+    LOG_ERROR("Can't read from the libevent notify eventfd");
     return;
   }
 
-  switch (m_buf[0]) {
-    /* new connection case */
-    case 'c': {
-      // fetch the new connection fd from the queue
-      thread->new_conn_queue.Dequeue(item);
-      conn = LibeventServer::GetConn(item->new_conn_fd);
-      if (conn == nullptr) {
-        LOG_DEBUG("Creating new socket fd:%d", item->new_conn_fd);
-        /* create a new connection object */
-        LibeventServer::CreateNewConn(item->new_conn_fd, item->event_flags,
-                                      static_cast<LibeventThread *>(thread),
-                                      CONN_READ);
-      } else {
-        LOG_DEBUG("Reusing socket fd:%d", item->new_conn_fd);
-        /* otherwise reset and reuse the existing conn object */
-        conn->Reset();
-        conn->Init(item->event_flags, static_cast<LibeventThread *>(thread),
-                    CONN_READ);
-      }
-      break;
+  // fetch the new connection fds from the queue
+  while (thread->new_conn_queue.Dequeue(item) == true) {
+    conn = LibeventServer::GetConn(item->new_conn_fd);
+    if (conn == nullptr) {
+      LOG_DEBUG("Creating new socket fd:%d", item->new_conn_fd);
+      /* create a new connection object */
+      LibeventServer::CreateNewConn(item->new_conn_fd, item->event_flags,
+                                    static_cast<LibeventThread *>(thread),
+                                    item->init_state);
+    } else {
+      LOG_DEBUG("Reusing socket fd:%d", item->new_conn_fd);
+      /* otherwise reset and reuse the existing conn object */
+      conn->Reset();
+      conn->Init(item->event_flags, static_cast<LibeventThread *>(thread),
+                 item->init_state);
     }
+  }
 
-    default:
-      LOG_ERROR("Unexpected message. Shouldn't reach here");
+  // continue with the connections the query threads are done with
+  while (thread->executed_conn_queue.Dequeue(conn) == true) {
+    conn->ResumeAfterExecute();
   }
 }
 
@@ -83,10 +92,14 @@ void StateMachine(LibeventSocket *conn) {
         int new_conn_fd =
             accept(conn->sock_fd, (struct sockaddr *)&addr, &addrlen);
         if (new_conn_fd == -1) {
-          LOG_ERROR("Failed to accept");
+          // another acceptor may have taken the connection
+          if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            LOG_ERROR("Failed to accept");
+          }
+        } else {
+          LibeventMasterThread::DispatchConnection(new_conn_fd,
+                                                   EV_READ | EV_PERSIST);
         }
-        (static_cast<LibeventMasterThread *>(conn->thread))
-            ->DispatchConnection(new_conn_fd, EV_READ | EV_PERSIST);
         done = true;
         break;
       }
@@ -113,7 +126,8 @@ void StateMachine(LibeventSocket *conn) {
       }
 
       case CONN_WAIT : {
-        if (conn->UpdateEvent(EV_READ | EV_PERSIST) == false) {
+        if ((conn->event_flags & EV_WRITE) != 0 &&
+            conn->UpdateEvent(EV_READ | EV_PERSIST) == false) {
           LOG_ERROR("Failed to update event, closing");
           conn->TransitState(CONN_CLOSING);
           break;
@@ -125,7 +139,6 @@ void StateMachine(LibeventSocket *conn) {
       }
 
       case CONN_PROCESS : {
-        bool status;
         if (conn->rpkt.header_parsed == false) {
           // parse out the header first
           if (conn->ReadPacketHeader() == false) {
@@ -148,15 +161,30 @@ void StateMachine(LibeventSocket *conn) {
 
         if (conn->pkt_manager.is_started == false) {
           // We need to handle startup packet first
-          status = conn->pkt_manager.ProcessStartupPacket(&conn->rpkt);
+          conn->process_status =
+              conn->pkt_manager.ProcessStartupPacket(&conn->rpkt);
           conn->pkt_manager.is_started = true;
+        } else if (IsStatementPacket(conn->rpkt.msg_type) == true) {
+          // Statements can run for long, they are executed on a query
+          // thread so that the other connections of this worker are served
+          // in the meantime. The state machine continues in CONN_EXECUTE
+          // once the thread is done.
+          conn->ExecutePacket();
+          done = true;
+          break;
         } else {
           // Process all other packets
-          status = conn->pkt_manager.ProcessPacket(&conn->rpkt);
+          conn->process_status = conn->pkt_manager.ProcessPacket(&conn->rpkt);
         }
+        conn->TransitState(CONN_EXECUTE);
+        break;
+      }
 
-        if (status == false) {
-          // packet processing can't proceed further
+      case CONN_EXECUTE: {
+        if (conn->process_status == false) {
+          // packet processing can't proceed further. Responses to earlier
+          // messages of a pipelined batch may still be buffered.
+          conn->FlushWriteBuffer();
           conn->TransitState(CONN_CLOSING);
         } else {
           // We should have responses ready to send
@@ -171,7 +199,11 @@ void StateMachine(LibeventSocket *conn) {
           case WRITE_COMPLETE: {
             // Input Packet can now be reset, before we parse the next packet
             conn->rpkt.Reset();
-            conn->UpdateEvent(EV_READ | EV_PERSIST);
+            // Only touch the event if we were waiting for the socket to
+            // drain, re-arming it costs two syscalls per message
+            if ((conn->event_flags & EV_WRITE) != 0) {
+              conn->UpdateEvent(EV_READ | EV_PERSIST);
+            }
             conn->TransitState(CONN_PROCESS);
             break;
           }
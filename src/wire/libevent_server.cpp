@@ -15,6 +15,7 @@
 #include <fcntl.h>
 #include <inttypes.h>
 #include <sys/socket.h>
+#include <algorithm>
 #include <fstream>
 
 #include "common/init.h"
@@ -27,8 +28,10 @@ namespace wire {
 std::vector<std::unique_ptr<LibeventSocket>>
     &LibeventServer::GetGlobalSocketList() {
   static std::vector<std::unique_ptr<LibeventSocket>>
-      // 2 fd's per thread for pipe and 1 listening socket
-      global_socket_list(FLAGS_max_connections + QUERY_THREAD_COUNT * 2 + 1);
+      // 2 fd's per worker thread for the event base and the notify eventfd,
+      // and the listening sockets
+      global_socket_list(FLAGS_max_connections + QUERY_THREAD_COUNT * 2 +
+                         FLAGS_acceptor_count);
   return global_socket_list;
 }
 
@@ -55,6 +58,33 @@ void Signal_Callback(UNUSED_ATTRIBUTE evutil_socket_t fd,
   event_base_loopexit(base, NULL);
 }
 
+int LibeventServer::CreateListenSocket(const struct sockaddr_in &sin,
+                                       bool reuse_port) {
+  int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+
+  if (listen_fd < 0) {
+    throw ConnectionException("Failed to create listen socket");
+  }
+
+  int reuse = 1;
+  setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+  if (reuse_port == true &&
+      setsockopt(listen_fd, SOL_SOCKET, SO_REUSEPORT, &reuse,
+                 sizeof(reuse)) < 0) {
+    throw ConnectionException("Failed to set SO_REUSEPORT on listen socket");
+  }
+
+  if (bind(listen_fd, (struct sockaddr *)&sin, sizeof(sin)) < 0) {
+    throw ConnectionException("Failed to bind socket to port: " +
+                              std::to_string(port_));
+  }
+
+  if (listen(listen_fd, conn_backlog) < 0) {
+    throw ConnectionException("Failed to listen to socket");
+  }
+  return listen_fd;
+}
+
 LibeventServer::LibeventServer() {
   struct event_base *base = event_base_new();
   struct event *evstop;
@@ -94,29 +124,23 @@ LibeventServer::LibeventServer() {
     sin.sin_addr.s_addr = INADDR_ANY;
     sin.sin_port = htons(port_);
 
-    int listen_fd;
-
-    listen_fd = socket(AF_INET, SOCK_STREAM, 0);
-
-    if (listen_fd < 0) {
-      throw ConnectionException("Failed to create listen socket");
+    // With several acceptors every one listens on its own socket bound to
+    // the port, and the kernel spreads the incoming connections over them.
+    // The master thread accepts on the first socket, the others are handed
+    // to the worker threads.
+    size_t acceptor_count = std::max<size_t>(
+        1, std::min<size_t>(FLAGS_acceptor_count, QUERY_THREAD_COUNT + 1));
+    for (size_t acceptor_itr = 0; acceptor_itr < acceptor_count;
+         acceptor_itr++) {
+      int listen_fd = CreateListenSocket(sin, acceptor_count > 1);
+      if (acceptor_itr == 0) {
+        LibeventServer::CreateNewConn(listen_fd, EV_READ | EV_PERSIST,
+                                      master_thread.get(), CONN_LISTENING);
+      } else {
+        LibeventMasterThread::DispatchListener(listen_fd, acceptor_itr - 1);
+      }
     }
 
-    int reuse = 1;
-    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
-
-    if (bind(listen_fd, (struct sockaddr *)&sin, sizeof(sin)) < 0) {
-      throw ConnectionException("Failed to bind socket to port: " + std::to_string(port_));
-    }
-
-    int conn_backlog = 12;
-    if (listen(listen_fd, conn_backlog) < 0) {
-      throw ConnectionException("Failed to listen to socket");
-    }
-
-    LibeventServer::CreateNewConn(listen_fd, EV_READ | EV_PERSIST,
-                                  master_thread.get(), CONN_LISTENING);
-
     LOG_INFO("Listening on port %lu", port_);
     event_base_dispatch(base);
     event_free(evstop);
@@ -10,7 +10,10 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <sys/uio.h>
 #include <unistd.h>
+#include "common/init.h"
+#include "common/thread_pool.h"
 #include "wire/libevent_server.h"
 
 namespace peloton {
@@ -168,11 +171,36 @@ bool LibeventSocket::ReadPacket() {
   return true;
 }
 
+bool LibeventSocket::IsPacketBuffered() {
+  // the startup packet is never pipelined
+  if (pkt_manager.is_started == false) {
+    return false;
+  }
+
+  size_t header_size = 1 + sizeof(int32_t);
+  if (IsReadDataAvailable(header_size) == false) {
+    return false;
+  }
+
+  // the size in the header includes the size field itself
+  size_t len = 0;
+  for (size_t i = rbuf_.buf_ptr + 1; i < rbuf_.buf_ptr + header_size; i++) {
+    len = (len << 8) | rbuf_.GetByte(i);
+  }
+  return IsReadDataAvailable(1 + len);
+}
+
 /**
  * Public Functions
  */
 
 WriteState LibeventSocket::WritePackets() {
+  // finish a flush that the socket could not take earlier
+  if (wbuf_.buf_flush_ptr > 0) {
+    auto result = FlushWriteBuffer();
+    if (result == WRITE_NOT_READY || result == WRITE_ERROR) return result;
+  }
+
   // iterate through all the packets
   for (; next_response_ < pkt_manager.responses.size(); next_response_++) {
     auto pkt = pkt_manager.responses[next_response_].get();
@@ -187,8 +215,16 @@ WriteState LibeventSocket::WritePackets() {
   pkt_manager.responses.clear();
   next_response_ = 0;
 
-  if (pkt_manager.force_flush == true) {
-    return FlushWriteBuffer();
+  // Pipelining clients send many messages (and Syncs) at once. As long as
+  // the next one is already here, keep buffering, so that the responses of
+  // the whole batch leave with as few writes as possible.
+  if (pkt_manager.force_flush == true && IsPacketBuffered() == false) {
+    auto result = FlushWriteBuffer();
+    if (result == WRITE_COMPLETE) {
+      // we have flushed, disable force flush now
+      pkt_manager.force_flush = false;
+    }
+    return result;
   }
   return WRITE_COMPLETE;
 }
@@ -367,9 +403,6 @@ WriteState LibeventSocket::FlushWriteBuffer() {
   // buffer is empty
   wbuf_.Reset();
 
-  // we have flushed, disable force flush now
-  pkt_manager.force_flush = false;
-
   // we are ok
   return WRITE_COMPLETE;
 }
@@ -430,51 +463,71 @@ WriteState LibeventSocket::BufferWriteBytesHeader(OutputPacket *pkt) {
 // Writes a packet's content into the write buffer
 // Return false when the socket is not ready for write
 WriteState LibeventSocket::BufferWriteBytesContent(OutputPacket *pkt) {
-  // the packet content to write
-  ByteBuf &pkt_buf = pkt->buf;
   // the length of remaining content to write
-  size_t len = pkt->len;
+  size_t len = pkt->len - pkt->write_ptr;
   // window is the size of remaining space in socket's wbuf
-  size_t window = 0;
-
-  // fill the contents
-  while (len) {
-    // calculate the remaining space in wbuf
-    window = wbuf_.GetMaxSize() - wbuf_.buf_ptr;
-    if (len <= window) {
-      // contents fit in the window, range copy "len" bytes
-      std::copy(std::begin(pkt_buf) + pkt->write_ptr,
-                std::begin(pkt_buf) + pkt->write_ptr + len,
-                std::begin(wbuf_.buf) + wbuf_.buf_ptr);
-
-      // Move the cursor and update size of socket buffer
-      wbuf_.buf_ptr += len;
-      wbuf_.buf_size = wbuf_.buf_ptr;
-      LOG_TRACE("Content fit in window. Write content successful");
-      return WRITE_COMPLETE;
-    } else {
-      // contents longer than socket buffer size, fill up the socket buffer
-      // with "window" bytes
-
-      std::copy(std::begin(pkt_buf) + pkt->write_ptr,
-                std::begin(pkt_buf) + pkt->write_ptr + window,
-                std::begin(wbuf_.buf) + wbuf_.buf_ptr);
-
-      // move the packet's cursor
-      pkt->write_ptr += window;
-      len -= window;
-      // Now the wbuf is full
-      wbuf_.buf_size = wbuf_.GetMaxSize();
-
-      LOG_TRACE("Content doesn't fit in window. Try flushing");
-      auto result = FlushWriteBuffer();
-      // flush before write the remaining content
-      if (result == WRITE_NOT_READY || result == WRITE_ERROR) {
-        // need to retry or close connection
-        return result;
+  size_t window = wbuf_.GetMaxSize() - wbuf_.buf_ptr;
+
+  if (len <= window) {
+    // contents fit in the window, range copy "len" bytes
+    std::copy(std::begin(pkt->buf) + pkt->write_ptr,
+              std::begin(pkt->buf) + pkt->write_ptr + len,
+              std::begin(wbuf_.buf) + wbuf_.buf_ptr);
+
+    // Move the cursors and update size of socket buffer
+    pkt->write_ptr += len;
+    wbuf_.buf_ptr += len;
+    wbuf_.buf_size = wbuf_.buf_ptr;
+    LOG_TRACE("Content fit in window. Write content successful");
+    return WRITE_COMPLETE;
+  }
+
+  // contents longer than the space left, send them along with the buffer
+  // instead of copying them through it
+  LOG_TRACE("Content doesn't fit in window. Flushing with the packet");
+  return FlushWriteBufferAndPacket(pkt);
+}
+
+WriteState LibeventSocket::FlushWriteBufferAndPacket(OutputPacket *pkt) {
+  while (wbuf_.buf_size > 0 || pkt->write_ptr < pkt->len) {
+    struct iovec iov[2];
+    int iov_count = 0;
+    if (wbuf_.buf_size > 0) {
+      iov[iov_count].iov_base = wbuf_.GetPtr(wbuf_.buf_flush_ptr);
+      iov[iov_count].iov_len = wbuf_.buf_size;
+      iov_count++;
+    }
+    if (pkt->write_ptr < pkt->len) {
+      iov[iov_count].iov_base = &pkt->buf[pkt->write_ptr];
+      iov[iov_count].iov_len = pkt->len - pkt->write_ptr;
+      iov_count++;
+    }
+
+    ssize_t written_bytes = writev(sock_fd, iov, iov_count);
+    if (written_bytes < 0) {
+      if (errno == EINTR) {
+        // interrupts are ok, try again
+        continue;
+      } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        // Listen for socket being enabled for write
+        UpdateEvent(EV_WRITE | EV_PERSIST);
+        return WRITE_NOT_READY;
+      } else {
+        LOG_ERROR("Fatal error during write, errno %d", errno);
+        return WRITE_ERROR;
       }
     }
+
+    // the buffered bytes go out first
+    size_t buffered_bytes =
+        std::min(static_cast<size_t>(written_bytes), wbuf_.buf_size);
+    wbuf_.buf_flush_ptr += buffered_bytes;
+    wbuf_.buf_size -= buffered_bytes;
+    pkt->write_ptr += written_bytes - buffered_bytes;
   }
+
+  // buffer is empty
+  wbuf_.Reset();
   return WRITE_COMPLETE;
 }
 
@@ -482,6 +535,7 @@ void LibeventSocket::CloseSocket() {
   LOG_DEBUG("Attempt to close the connection %d", sock_fd);
   // Remove listening event
   event_del(event);
+  thread->RemoveConnection();
 
   TransitState(CONN_CLOSED);
   Reset();
@@ -498,6 +552,26 @@ void LibeventSocket::CloseSocket() {
   }
 }
 
+void LibeventSocket::ExecutePacket() {
+  TransitState(CONN_EXECUTE);
+  // Data arriving in the meantime must not run the state machine
+  event_del(event);
+
+  thread_pool.SubmitTask([this] {
+    process_status = pkt_manager.ProcessPacket(&rpkt);
+    static_cast<LibeventWorkerThread *>(thread)->NotifyExecuted(this);
+  });
+}
+
+void LibeventSocket::ResumeAfterExecute() {
+  PL_ASSERT(state == CONN_EXECUTE);
+  if (event_add(event, nullptr) == -1) {
+    LOG_ERROR("Failed to add event, closing");
+    TransitState(CONN_CLOSING);
+  }
+  StateMachine(this);
+}
+
 void LibeventSocket::Reset() {
   rbuf_.Reset();
   wbuf_.Reset();
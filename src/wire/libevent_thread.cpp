@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 #include "wire/libevent_thread.h"
+#include <sys/eventfd.h>
 #include <sys/file.h>
 #include <fstream>
 #include <vector>
@@ -30,14 +31,15 @@ std::vector<std::shared_ptr<LibeventWorkerThread>>
   return worker_threads;
 }
 
+std::atomic<size_t> LibeventMasterThread::next_thread_id_(0);
+
 /*
  * The libevent master thread initialize num_threads worker threads on
  * constructor.
  */
 LibeventMasterThread::LibeventMasterThread(const int num_threads,
                                            struct event_base *libevent_base)
-    : LibeventThread(MASTER_THREAD_ID, libevent_base),
-      num_threads_(num_threads) {
+    : LibeventThread(MASTER_THREAD_ID, libevent_base) {
   auto &threads = GetWorkerThreads();
   for (int thread_id = 0; thread_id < num_threads; thread_id++) {
     threads.push_back(std::shared_ptr<LibeventWorkerThread>(
@@ -58,56 +60,90 @@ void LibeventMasterThread::StartWorker(LibeventWorkerThread *worker_thread) {
 }
 
 /*
-* The worker thread creates a pipe for master-worker communication on
+* The worker thread creates an eventfd for master-worker communication on
 * constructor.
 */
 LibeventWorkerThread::LibeventWorkerThread(const int thread_id)
-    : LibeventThread(thread_id, event_base_new()), new_conn_queue(QUEUE_SIZE) {
-  int fds[2];
-  if (pipe(fds)) {
-    LOG_ERROR("Can't create notify pipe to accept connections");
+    : LibeventThread(thread_id, event_base_new()),
+      new_conn_queue(QUEUE_SIZE),
+      executed_conn_queue(QUEUE_SIZE) {
+  notify_fd = eventfd(0, EFD_NONBLOCK);
+  if (notify_fd < 0) {
+    LOG_ERROR("Can't create notify eventfd to accept connections");
     exit(1);
   }
-  // send_fd is used by the master thread, received_fd used by worker thread
-  new_conn_receive_fd = fds[0];
-  new_conn_send_fd = fds[1];
 
-  // Listen for notifications from the master thread
-  new_conn_event_ = event_new(libevent_base_, new_conn_receive_fd,
-                              EV_READ | EV_PERSIST, WorkerHandleNewConn, this);
+  // Listen for notifications from the acceptors and the query threads
+  notify_event_ = event_new(libevent_base_, notify_fd, EV_READ | EV_PERSIST,
+                            WorkerHandleNotify, this);
 
-  if (event_add(new_conn_event_, 0) == -1) {
-    LOG_ERROR("Can't monitor libevent notify pipe\n");
+  if (event_add(notify_event_, 0) == -1) {
+    LOG_ERROR("Can't monitor libevent notify eventfd\n");
     exit(1);
   }
 }
 
+void LibeventWorkerThread::Notify() {
+  uint64_t count = 1;
+  if (write(notify_fd, &count, sizeof(count)) != sizeof(count)) {
+    LOG_ERROR("Failed to write to thread notify eventfd");
+  }
+}
+
+void LibeventWorkerThread::NotifyExecuted(LibeventSocket *conn) {
+  executed_conn_queue.Enqueue(conn);
+  Notify();
+}
+
 /*
-* Dispatch a new connection event to a random worker thread by
-* writing to the worker's pipe
+* Dispatch a new connection to the worker thread that serves the fewest
+* connections. The search starts at a rotating worker, so equally loaded
+* workers take turns.
 */
 void LibeventMasterThread::DispatchConnection(int new_conn_fd,
                                               short event_flags) {
-  char buf[1];
-  buf[0] = 'c';
   auto &threads = GetWorkerThreads();
+  size_t num_threads = threads.size();
+  size_t start_thread_id = next_thread_id_.fetch_add(1) % num_threads;
 
-  // Dispatch by rand number
-  int thread_id = next_thread_id_;
-
-  // update next threadID
-  next_thread_id_ = (next_thread_id_ + 1) % num_threads_;
+  size_t thread_id = start_thread_id;
+  size_t min_connection_count = threads[thread_id]->GetConnectionCount();
+  for (size_t thread_itr = 1;
+       thread_itr < num_threads && min_connection_count > 0; thread_itr++) {
+    size_t candidate_id = (start_thread_id + thread_itr) % num_threads;
+    size_t connection_count = threads[candidate_id]->GetConnectionCount();
+    if (connection_count < min_connection_count) {
+      thread_id = candidate_id;
+      min_connection_count = connection_count;
+    }
+  }
 
   std::shared_ptr<LibeventWorkerThread> worker_thread = threads[thread_id];
-  LOG_DEBUG("Dispatching connection to worker %d", thread_id);
+  LOG_DEBUG("Dispatching connection to worker %lu (%lu connections)",
+            thread_id, min_connection_count);
+
+  // Count the connection right away, so concurrent dispatches see it
+  worker_thread->AddConnection();
 
   std::shared_ptr<NewConnQueueItem> item(
       new NewConnQueueItem(new_conn_fd, event_flags, CONN_READ));
   worker_thread->new_conn_queue.Enqueue(item);
+  worker_thread->Notify();
+}
 
-  if (write(worker_thread->new_conn_send_fd, buf, 1) != 1) {
-    LOG_ERROR("Failed to write to thread notify pipe");
-  }
+/*
+* Listening sockets go through the queue as well, the event of the socket
+* has to be created by the thread running the event base.
+*/
+void LibeventMasterThread::DispatchListener(int listen_fd, int thread_id) {
+  auto &threads = GetWorkerThreads();
+  std::shared_ptr<LibeventWorkerThread> worker_thread = threads[thread_id];
+  LOG_DEBUG("Worker %d accepts on socket fd:%d", thread_id, listen_fd);
+
+  std::shared_ptr<NewConnQueueItem> item(
+      new NewConnQueueItem(listen_fd, EV_READ | EV_PERSIST, CONN_LISTENING));
+  worker_thread->new_conn_queue.Enqueue(item);
+  worker_thread->Notify();
 }
 }
 }
@@ -24,6 +24,7 @@
 #include "concurrency/transaction_manager_factory.h"
 #include "storage/data_table.h"
 #include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
 
 namespace peloton {
 namespace test {
@@ -34,6 +35,12 @@ namespace test {
 
 class LayoutTunerTests : public PelotonTest {};
 
+// Runs the tile group transformations without the tuner thread
+class TestingLayoutTuner : public brain::LayoutTuner {
+ public:
+  using brain::LayoutTuner::TransformTileGroups;
+};
+
 TEST_F(LayoutTunerTests, BasicTest) {
 
   const int tuple_count = TESTS_TUPLES_PER_TILEGROUP;
@@ -128,5 +135,75 @@ TEST_F(LayoutTunerTests, BasicTest) {
 
 }
 
+TEST_F(LayoutTunerTests, TransformTileGroupsTest) {
+  const int tuple_count = TESTS_TUPLES_PER_TILEGROUP;
+
+  // Two full tile groups in the row layout
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(tuple_count, false));
+  TestingExecutorUtil::PopulateTable(data_table.get(), tuple_count * 2, false,
+                                     false, true, txn);
+  txn_manager.CommitTransaction(txn);
+
+  oid_t column_count = data_table->GetSchema()->GetColumnCount();
+  storage::column_map_type row_layout, column_layout;
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    row_layout[column_itr] = std::make_pair(0, column_itr);
+    column_layout[column_itr] = std::make_pair(column_itr, 0);
+  }
+
+  auto first_header = data_table->GetTileGroup(0)->GetHeader();
+  auto second_header = data_table->GetTileGroup(1)->GetHeader();
+  EXPECT_EQ(tuple_count, first_header->GetWriteCount());
+  EXPECT_EQ(tuple_count, second_header->GetWriteCount());
+
+  // The inserts keep the tile groups hot until their counts decay
+  TestingLayoutTuner layout_tuner;
+  layout_tuner.TransformTileGroups(data_table.get(), true);
+  EXPECT_EQ(tuple_count / 2, first_header->GetWriteCount());
+  while (first_header->GetWriteCount() > 0) {
+    layout_tuner.TransformTileGroups(data_table.get(), true);
+  }
+  EXPECT_EQ(0, second_header->GetWriteCount());
+  EXPECT_EQ(row_layout, data_table->GetTileGroup(0)->GetColumnMap());
+  EXPECT_EQ(row_layout, data_table->GetTileGroup(1)->GetColumnMap());
+
+  // The first tile group is scanned once, the second one is cold
+  first_header->IncrementReadCount();
+  for (int read_itr = 0; read_itr < 4; read_itr++) {
+    second_header->IncrementReadCount();
+  }
+  layout_tuner.TransformTileGroups(data_table.get(), false);
+  EXPECT_EQ(row_layout, data_table->GetTileGroup(0)->GetColumnMap());
+  EXPECT_EQ(column_layout, data_table->GetTileGroup(1)->GetColumnMap());
+  EXPECT_EQ(column_count, data_table->GetTileGroup(1)->GetTileCount());
+
+  // The transformed copy shares the header and keeps the counts
+  EXPECT_EQ(second_header, data_table->GetTileGroup(1)->GetHeader());
+  EXPECT_EQ(4, second_header->GetReadCount());
+
+  // Now the first tile group is cold and the second one is written to
+  for (int read_itr = 0; read_itr < 4; read_itr++) {
+    first_header->IncrementReadCount();
+  }
+  second_header->IncrementWriteCount();
+  layout_tuner.TransformTileGroups(data_table.get(), false);
+  EXPECT_EQ(column_layout, data_table->GetTileGroup(0)->GetColumnMap());
+  EXPECT_EQ(row_layout, data_table->GetTileGroup(1)->GetColumnMap());
+
+  // The values survive both transformations
+  for (oid_t tile_group_offset = 0; tile_group_offset < 2;
+       tile_group_offset++) {
+    auto tile_group = data_table->GetTileGroup(tile_group_offset);
+    for (oid_t tuple_id = 0; tuple_id < 4; tuple_id++) {
+      auto row_id = tile_group_offset * tuple_count + tuple_id;
+      EXPECT_EQ(TestingExecutorUtil::PopulatedValue(row_id, 1),
+                tile_group->GetValue(tuple_id, 1).GetAs<int32_t>());
+    }
+  }
+}
+
 }  // End test namespace
 }  // End peloton namespace
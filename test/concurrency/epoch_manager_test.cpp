@@ -0,0 +1,131 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// epoch_manager_test.cpp
+//
+// Identification: test/concurrency/epoch_manager_test.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <future>
+#include <memory>
+#include <thread>
+
+#include "common/harness.h"
+#include "concurrency/epoch_manager.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Epoch Manager Tests
+//===--------------------------------------------------------------------===//
+
+class EpochManagerTests : public PelotonTest {};
+
+TEST_F(EpochManagerTests, RunningTxnTest) {
+  concurrency::EpochManager epoch_manager;
+
+  auto epoch_id = epoch_manager.EnterEpoch(5);
+  epoch_manager.Reset(10);
+
+  // The running txn holds back both tails
+  EXPECT_EQ(0, epoch_manager.GetMaxDeadTxnCid());
+  EXPECT_EQ(READ_ONLY_START_CID, epoch_manager.GetReadOnlyTxnCid());
+
+  epoch_manager.ExitEpoch(epoch_id);
+  EXPECT_EQ(5, epoch_manager.GetMaxDeadTxnCid());
+  EXPECT_EQ(5, epoch_manager.GetReadOnlyTxnCid());
+}
+
+TEST_F(EpochManagerTests, ReadOnlyTxnTest) {
+  concurrency::EpochManager epoch_manager;
+
+  epoch_manager.ExitEpoch(epoch_manager.EnterEpoch(5));
+  epoch_manager.Reset(4);
+  EXPECT_EQ(5, epoch_manager.GetReadOnlyTxnCid());
+  EXPECT_EQ(0, epoch_manager.GetMaxDeadTxnCid());
+
+  auto ro_epoch_id = epoch_manager.EnterReadOnlyEpoch(5);
+  epoch_manager.ExitEpoch(epoch_manager.EnterEpoch(9));
+  epoch_manager.Reset(20);
+
+  // Read-only txns only hold back the GC
+  EXPECT_EQ(9, epoch_manager.GetReadOnlyTxnCid());
+  EXPECT_EQ(5, epoch_manager.GetMaxDeadTxnCid());
+
+  epoch_manager.ExitReadOnlyEpoch(ro_epoch_id);
+  EXPECT_EQ(9, epoch_manager.GetMaxDeadTxnCid());
+}
+
+TEST_F(EpochManagerTests, MultiThreadTest) {
+  concurrency::EpochManager epoch_manager;
+  std::atomic<cid_t> next_cid(1);
+  const size_t thread_count = 8;
+  const size_t txn_count = 1000;
+
+  // One txn of every thread ends on the main thread
+  std::vector<size_t> leftover_epoch_ids(thread_count);
+  std::vector<std::thread> threads;
+  for (size_t thread_itr = 0; thread_itr < thread_count; ++thread_itr) {
+    threads.emplace_back([&, thread_itr] {
+      for (size_t txn_itr = 0; txn_itr < txn_count; ++txn_itr) {
+        epoch_manager.ExitEpoch(epoch_manager.EnterEpoch(next_cid++));
+      }
+      leftover_epoch_ids[thread_itr] = epoch_manager.EnterEpoch(next_cid++);
+    });
+  }
+  for (size_t epoch = 1; epoch <= 10; ++epoch) {
+    epoch_manager.Reset(epoch);
+    epoch_manager.GetMaxDeadTxnCid();
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  epoch_manager.Reset(100);
+  EXPECT_GT(next_cid - 1, epoch_manager.GetMaxDeadTxnCid());
+
+  for (auto epoch_id : leftover_epoch_ids) {
+    epoch_manager.ExitEpoch(epoch_id);
+  }
+  epoch_manager.Reset(200);
+  EXPECT_EQ(next_cid - 1, epoch_manager.GetMaxDeadTxnCid());
+}
+
+TEST_F(EpochManagerTests, SlotReleaseTest) {
+  concurrency::EpochManager first_manager, second_manager;
+
+  // Moving on to another manager releases the slot of the first one
+  auto epoch_id = first_manager.EnterEpoch(1);
+  EXPECT_EQ(0, epoch_id % EPOCH_MAX_SLOT_COUNT);
+  first_manager.ExitEpoch(epoch_id);
+  second_manager.ExitEpoch(second_manager.EnterEpoch(1));
+
+  std::thread thread([&] {
+    auto epoch_id = first_manager.EnterEpoch(2);
+    EXPECT_EQ(0, epoch_id % EPOCH_MAX_SLOT_COUNT);
+    first_manager.ExitEpoch(epoch_id);
+  });
+  thread.join();
+
+  // A thread outliving its manager releases its slot when it exits
+  std::unique_ptr<concurrency::EpochManager> third_manager(
+      new concurrency::EpochManager());
+  std::promise<void> entered, destroyed;
+  std::thread outliving_thread([&] {
+    third_manager->ExitEpoch(third_manager->EnterEpoch(1));
+    entered.set_value();
+    destroyed.get_future().wait();
+  });
+  entered.get_future().wait();
+  third_manager.reset();
+  destroyed.set_value();
+  outliving_thread.join();
+}
+
+}  // End test namespace
+}  // End peloton namespace
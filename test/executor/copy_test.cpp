@@ -11,19 +11,25 @@
 //===----------------------------------------------------------------------===//
 
 #include <cstdio>
+#include <fstream>
+#include <set>
+#include <thread>
 
 #include "catalog/catalog.h"
 #include "common/harness.h"
 #include "common/logger.h"
 #include "common/statement.h"
 #include "executor/copy_executor.h"
+#include "executor/copy_from_executor.h"
 #include "executor/seq_scan_executor.h"
+#include "storage/table_exporter.h"
 #include "optimizer/simple_optimizer.h"
 #include "parser/parser.h"
 #include "planner/seq_scan_plan.h"
 #include "tcop/tcop.h"
 
 #include "gtest/gtest.h"
+#include "sql/testing_sql_util.h"
 #include "statistics/testing_stats_util.h"
 
 namespace peloton {
@@ -59,7 +65,7 @@ TEST_F(CopyTests, Copying) {
   size_t num_bytes_to_write = 0;
   size_t integer_len = 5;
   size_t default_delimiter_len = 2;
-  size_t extra_delimiter_len = 6;
+  size_t extra_delimiter_len = 3;
   for (int i = 0; i < num_tuples; i++) {
     // Choose a string and calculate the number of bytes to write
     std::string insert_str;
@@ -112,10 +118,6 @@ TEST_F(CopyTests, Copying) {
   auto copy_executor =
       new executor::CopyExecutor(copy_plan.get(), context.get());
   std::unique_ptr<executor::AbstractExecutor> root_executor(copy_executor);
-  std::unique_ptr<executor::AbstractExecutor> seq_scan_executor(
-      new executor::SeqScanExecutor(copy_plan->GetChildren()[0].get(),
-                                    context.get()));
-  copy_executor->AddChild(seq_scan_executor.get());
 
   LOG_INFO("Executing plan...");
   // Initialize the executor tree
@@ -136,5 +138,189 @@ TEST_F(CopyTests, Copying) {
   txn_manager.CommitTransaction(txn);
 }
 
+TEST_F(CopyTests, CopyFromTest) {
+  catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, nullptr);
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE test(a INT PRIMARY KEY, b INT, c VARCHAR(32));");
+
+  // Big enough to be cut into a chunk per parser
+  executor::CopyFromExecutor::SetParserCount(4);
+  int num_rows = 20000;
+  std::string file_path = "./copy_from_input.csv";
+  {
+    std::ofstream out(file_path);
+    for (int i = 0; i < num_rows; i++) {
+      if (i == 7) {
+        // NULL and an escaped delimiter
+        out << i << ",,one\\,two\n";
+      } else {
+        out << i << "," << i * 10 << ",row" << i << "\n";
+      }
+    }
+  }
+
+  std::vector<StatementResult> result;
+  std::vector<FieldInfo> tuple_descriptor;
+  std::string error_message;
+  int rows_changed;
+  TestingSQLUtil::ExecuteSQLQuery(
+      "COPY test FROM '" + file_path + "' DELIMITER ',';", result,
+      tuple_descriptor, rows_changed, error_message);
+  EXPECT_EQ(num_rows, rows_changed);
+
+  TestingSQLUtil::ExecuteSQLQuery("SELECT COUNT(*) FROM test;", result);
+  EXPECT_EQ(std::to_string(num_rows),
+            TestingSQLUtil::GetResultValueAsString(result, 0));
+  TestingSQLUtil::ExecuteSQLQuery("SELECT b, c FROM test WHERE a = 12345;",
+                                  result);
+  EXPECT_EQ("123450", TestingSQLUtil::GetResultValueAsString(result, 0));
+  EXPECT_EQ("row12345", TestingSQLUtil::GetResultValueAsString(result, 1));
+  TestingSQLUtil::ExecuteSQLQuery("SELECT c FROM test WHERE a = 7;", result);
+  EXPECT_EQ("one,two", TestingSQLUtil::GetResultValueAsString(result, 0));
+
+  // A key that is already loaded fails the whole copy
+  {
+    std::ofstream out(file_path);
+    out << "100000,1,new\n" << "5,1,dup\n";
+  }
+  TestingSQLUtil::ExecuteSQLQuery(
+      "COPY test FROM '" + file_path + "' DELIMITER ',';");
+  TestingSQLUtil::ExecuteSQLQuery("SELECT b FROM test WHERE a = 100000;",
+                                  result);
+  EXPECT_EQ(0, result.size());
+
+  // So does a malformed row
+  {
+    std::ofstream out(file_path);
+    out << "100000,1,new\n" << "100001,abc,bad\n";
+  }
+  TestingSQLUtil::ExecuteSQLQuery(
+      "COPY test FROM '" + file_path + "' DELIMITER ',';");
+  TestingSQLUtil::ExecuteSQLQuery("SELECT COUNT(*) FROM test;", result);
+  EXPECT_EQ(std::to_string(num_rows),
+            TestingSQLUtil::GetResultValueAsString(result, 0));
+
+  std::remove(file_path.c_str());
+  executor::CopyFromExecutor::SetParserCount(
+      std::thread::hardware_concurrency());
+
+  // free the database just created
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+}
+
+TEST_F(CopyTests, ExportTest) {
+  catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, nullptr);
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE test(a INT PRIMARY KEY, b INT, c VARCHAR(32));");
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE test_copy(a INT PRIMARY KEY, b INT, c VARCHAR(32));");
+  int num_rows = 1500;
+  for (int i = 0; i < num_rows; i++) {
+    TestingSQLUtil::ExecuteSQLQuery(
+        "INSERT INTO test VALUES (" + std::to_string(i) + ", " +
+        std::to_string(-i) + ", 'v" + std::to_string(i % 10) + "');");
+  }
+  TestingSQLUtil::ExecuteSQLQuery("UPDATE test SET c = 'x,y' WHERE a = 3;");
+  TestingSQLUtil::ExecuteSQLQuery("DELETE FROM test WHERE a = 4;");
+  TestingSQLUtil::ExecuteSQLQuery(
+      "INSERT INTO test VALUES (" + std::to_string(num_rows) + ", 1, NULL);");
+
+  // Text exports load back with COPY FROM
+  std::string file_path = "./copy_export_output";
+  TestingSQLUtil::ExecuteSQLQuery("COPY test TO '" + file_path +
+                                  "' DELIMITER ',';");
+  TestingSQLUtil::ExecuteSQLQuery("COPY test_copy FROM '" + file_path +
+                                  "' DELIMITER ',';");
+
+  std::vector<StatementResult> result;
+  TestingSQLUtil::ExecuteSQLQuery("SELECT COUNT(*) FROM test_copy;",
+                                  result);
+  EXPECT_EQ(std::to_string(num_rows),
+            TestingSQLUtil::GetResultValueAsString(result, 0));
+  TestingSQLUtil::ExecuteSQLQuery("SELECT b, c FROM test_copy WHERE a = 3;",
+                                  result);
+  EXPECT_EQ("-3", TestingSQLUtil::GetResultValueAsString(result, 0));
+  EXPECT_EQ("x,y", TestingSQLUtil::GetResultValueAsString(result, 1));
+  TestingSQLUtil::ExecuteSQLQuery("SELECT a FROM test_copy WHERE a = 4;",
+                                  result);
+  EXPECT_EQ(0, result.size());
+  TestingSQLUtil::ExecuteSQLQuery(
+      "SELECT COUNT(*) FROM test_copy WHERE c = 'v7';", result);
+  EXPECT_EQ(std::to_string(num_rows / 10),
+            TestingSQLUtil::GetResultValueAsString(result, 0));
+
+  // Binary dumps have one block per tile group with visible rows
+  TestingSQLUtil::ExecuteSQLQuery("COPY test TO '" + file_path +
+                                  "' WITH BINARY;");
+  std::ifstream in(file_path, std::ios::binary);
+  std::string dump((std::istreambuf_iterator<char>(in)),
+                   std::istreambuf_iterator<char>());
+  size_t ptr = 0;
+  auto read_uint32 = [&dump, &ptr]() {
+    uint32_t value = 0;
+    memcpy(&value, dump.data() + ptr, sizeof(value));
+    ptr += sizeof(value);
+    return value;
+  };
+  ASSERT_LT(8, dump.size());
+  EXPECT_EQ(std::string(storage::TableExporter::binary_magic, 8),
+            dump.substr(0, 8));
+  ptr = 8;
+  EXPECT_EQ(storage::TableExporter::binary_version, read_uint32());
+  ASSERT_EQ(3, read_uint32());
+  for (int column_itr = 0; column_itr < 3; column_itr++) {
+    read_uint32();
+    ptr += read_uint32();
+  }
+
+  size_t dump_row_count = 0;
+  size_t null_count = 0;
+  std::set<std::string> dictionary_values;
+  uint32_t row_count;
+  while ((row_count = read_uint32()) > 0) {
+    dump_row_count += row_count;
+    size_t bitmap_size = (row_count + 7) / 8;
+    // a and b are integers
+    ptr += 2 * (bitmap_size + row_count * sizeof(int32_t));
+    // c is dictionary encoded
+    for (size_t byte_itr = 0; byte_itr < bitmap_size; byte_itr++) {
+      null_count += __builtin_popcount((unsigned char)dump[ptr + byte_itr]);
+    }
+    ptr += bitmap_size;
+    auto dictionary_size = read_uint32();
+    EXPECT_GE(11, dictionary_size);
+    for (uint32_t entry_itr = 0; entry_itr < dictionary_size; entry_itr++) {
+      auto length = read_uint32();
+      dictionary_values.insert(dump.substr(ptr, length));
+      ptr += length;
+    }
+    ptr += row_count * sizeof(uint32_t);
+    ASSERT_LE(ptr, dump.size());
+  }
+  EXPECT_EQ(dump.size(), ptr);
+  EXPECT_EQ(num_rows, dump_row_count);
+  EXPECT_EQ(1, null_count);
+  EXPECT_EQ(11, dictionary_values.size());
+
+  std::remove(file_path.c_str());
+
+  // Exports to a full disk fail instead of leaving a truncated file
+  auto table = catalog::Catalog::GetInstance()->GetTableWithName(
+      DEFAULT_DB_NAME, "test");
+  for (auto format : {CopyType::EXPORT_OTHER, CopyType::EXPORT_BINARY}) {
+    storage::TableExporter exporter(table, format);
+    EXPECT_FALSE(exporter.ExportSnapshot("/dev/full"));
+  }
+
+  // free the database just created
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+}
+
 }  // End test namespace
 }  // End peloton namespace
@@ -10,7 +10,9 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <map>
 #include <memory>
+#include <thread>
 
 #include "executor/testing_executor_util.h"
 #include "executor/testing_join_util.h"
@@ -25,9 +27,11 @@
 #include "executor/index_scan_executor.h"
 #include "executor/merge_join_executor.h"
 #include "executor/nested_loop_join_executor.h"
+#include "executor/seq_scan_executor.h"
 
 #include "expression/abstract_expression.h"
 #include "expression/expression_util.h"
+#include "expression/operator_expression.h"
 #include "expression/tuple_value_expression.h"
 
 #include "planner/hash_join_plan.h"
@@ -35,6 +39,7 @@
 #include "planner/index_scan_plan.h"
 #include "planner/merge_join_plan.h"
 #include "planner/nested_loop_join_plan.h"
+#include "planner/seq_scan_plan.h"
 
 #include "storage/data_table.h"
 #include "storage/tile.h"
@@ -79,7 +84,11 @@ std::vector<JoinType> join_types = {JoinType::INNER, JoinType::LEFT,
 
 void ExecuteJoinTest(PlanNodeType join_algorithm, JoinType join_type,
                      oid_t join_test_type);
-void ExecuteNestedLoopJoinTest(JoinType join_type);
+void ExecuteNestedLoopJoinTest(
+    JoinType join_type,
+    ExpressionType left_expr_type = ExpressionType::COMPARE_EQUAL,
+    oid_t expected_tuple_count = 1, oid_t expected_tuples_with_null = 0,
+    ExpressionType right_expr_type = ExpressionType::COMPARE_EQUAL);
 
 void PopulateTable(storage::DataTable *table, int num_rows, bool random,
                    concurrency::Transaction *current_txn);
@@ -219,6 +228,178 @@ TEST_F(JoinTests, BasicNestedLoopTest) {
   ExecuteNestedLoopJoinTest(JoinType::INNER);
 }
 
+TEST_F(JoinTests, BatchedNestedLoopTest) {
+  // LEFT ATTR 0 >= 50 spans several left tiles, all keys of each of them are
+  // looked up with one multi-key probe of the right primary key
+  ExecuteNestedLoopJoinTest(JoinType::INNER,
+                            ExpressionType::COMPARE_GREATERTHANOREQUALTO, 2);
+
+  // The 8 of the 10 left rows without a match are padded with NULLs
+  ExecuteNestedLoopJoinTest(JoinType::LEFT,
+                            ExpressionType::COMPARE_GREATERTHANOREQUALTO, 10,
+                            8);
+
+  // RIGHT ATTR 0 >= key can not be probed, the right index scan runs once
+  // per distinct key and the join predicate drops the larger keys
+  ExecuteNestedLoopJoinTest(JoinType::INNER,
+                            ExpressionType::COMPARE_GREATERTHANOREQUALTO, 2, 0,
+                            ExpressionType::COMPARE_GREATERTHANOREQUALTO);
+  ExecuteNestedLoopJoinTest(JoinType::LEFT,
+                            ExpressionType::COMPARE_GREATERTHANOREQUALTO, 10,
+                            8, ExpressionType::COMPARE_GREATERTHANOREQUALTO);
+}
+
+TEST_F(JoinTests, SortMergeJoinTest) {
+  // Unsorted inputs with duplicate keys, partitioned over several threads
+  executor::MergeJoinExecutor::SetSortThreadCount(4);
+  const int left_rows = 6000, right_rows = 3000;
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> left_table(
+      TestingExecutorUtil::CreateTable(1000, false));
+  TestingExecutorUtil::PopulateTable(left_table.get(), left_rows, false, true,
+                                     false, txn);
+  std::unique_ptr<storage::DataTable> right_table(
+      TestingExecutorUtil::CreateTable(1000, false));
+  TestingExecutorUtil::PopulateTable(right_table.get(), right_rows, false,
+                                     true, false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  // Rows per key of the second column
+  auto count_keys = [](storage::DataTable *table) {
+    std::map<int32_t, size_t> key_counts;
+    for (oid_t offset = 0; offset < table->GetTileGroupCount(); offset++) {
+      auto tile_group = table->GetTileGroup(offset);
+      for (oid_t row = 0; row < tile_group->GetNextTupleSlot(); row++) {
+        key_counts[tile_group->GetValue(row, 1).GetAs<int32_t>()]++;
+      }
+    }
+    return key_counts;
+  };
+  auto left_keys = count_keys(left_table.get());
+  auto right_keys = count_keys(right_table.get());
+  size_t inner_rows = 0, left_only_rows = 0, right_only_rows = 0;
+  for (auto &left_key : left_keys) {
+    auto right_key = right_keys.find(left_key.first);
+    if (right_key == right_keys.end()) {
+      left_only_rows += left_key.second;
+    } else {
+      inner_rows += left_key.second * right_key->second;
+    }
+  }
+  for (auto &right_key : right_keys) {
+    if (left_keys.count(right_key.first) == 0) {
+      right_only_rows += right_key.second;
+    }
+  }
+
+  for (auto join_type : join_types) {
+    txn = txn_manager.BeginTransaction();
+    std::unique_ptr<executor::ExecutorContext> context(
+        new executor::ExecutorContext(txn));
+    std::vector<oid_t> column_ids({0, 1, 2, 3});
+    planner::SeqScanPlan left_scan_node(left_table.get(), nullptr,
+                                        column_ids);
+    executor::SeqScanExecutor left_scan(&left_scan_node, context.get());
+    planner::SeqScanPlan right_scan_node(right_table.get(), nullptr,
+                                         column_ids);
+    executor::SeqScanExecutor right_scan(&right_scan_node, context.get());
+
+    std::vector<planner::MergeJoinPlan::JoinClause> join_clauses;
+    join_clauses.emplace_back(
+        new expression::TupleValueExpression(type::Type::INTEGER, 0, 1),
+        new expression::TupleValueExpression(type::Type::INTEGER, 1, 1),
+        false);
+    std::shared_ptr<const catalog::Schema> schema;
+    planner::MergeJoinPlan merge_join_node(join_type, nullptr, nullptr, schema,
+                                           join_clauses, true);
+    executor::MergeJoinExecutor merge_join_executor(&merge_join_node,
+                                                    context.get());
+    merge_join_executor.AddChild(&left_scan);
+    merge_join_executor.AddChild(&right_scan);
+
+    size_t result_rows = 0, null_rows = 0;
+    EXPECT_TRUE(merge_join_executor.Init());
+    while (merge_join_executor.Execute()) {
+      std::unique_ptr<executor::LogicalTile> result_tile(
+          merge_join_executor.GetOutput());
+      for (oid_t row : *result_tile) {
+        auto left_key = result_tile->GetValue(row, 1);
+        auto right_key = result_tile->GetValue(row, 5);
+        if (left_key.IsNull() || right_key.IsNull()) {
+          null_rows++;
+        } else {
+          EXPECT_EQ(left_key.GetAs<int32_t>(), right_key.GetAs<int32_t>());
+        }
+        result_rows++;
+      }
+    }
+    txn_manager.CommitTransaction(txn);
+
+    size_t expected_null_rows = 0;
+    if (join_type == JoinType::LEFT || join_type == JoinType::OUTER) {
+      expected_null_rows += left_only_rows;
+    }
+    if (join_type == JoinType::RIGHT || join_type == JoinType::OUTER) {
+      expected_null_rows += right_only_rows;
+    }
+    EXPECT_EQ(inner_rows + expected_null_rows, result_rows);
+    EXPECT_EQ(expected_null_rows, null_rows);
+  }
+  executor::MergeJoinExecutor::SetSortThreadCount(
+      std::thread::hardware_concurrency());
+}
+
+TEST_F(JoinTests, SortMergeJoinExceptionTest) {
+  // A join key that fails to evaluate on a sort thread fails the join
+  executor::MergeJoinExecutor::SetSortThreadCount(4);
+  const int rows = 1 << 14;
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> left_table(
+      TestingExecutorUtil::CreateTable(1000, false));
+  TestingExecutorUtil::PopulateTable(left_table.get(), rows, false, true,
+                                     false, txn);
+  std::unique_ptr<storage::DataTable> right_table(
+      TestingExecutorUtil::CreateTable(1000, false));
+  TestingExecutorUtil::PopulateTable(right_table.get(), rows, false, true,
+                                     false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+  std::vector<oid_t> column_ids({0, 1, 2, 3});
+  planner::SeqScanPlan left_scan_node(left_table.get(), nullptr, column_ids);
+  executor::SeqScanExecutor left_scan(&left_scan_node, context.get());
+  planner::SeqScanPlan right_scan_node(right_table.get(), nullptr, column_ids);
+  executor::SeqScanExecutor right_scan(&right_scan_node, context.get());
+
+  // LEFT.B / 0 = RIGHT.B
+  std::vector<planner::MergeJoinPlan::JoinClause> join_clauses;
+  join_clauses.emplace_back(
+      new expression::OperatorExpression(
+          ExpressionType::OPERATOR_DIVIDE, type::Type::INTEGER,
+          new expression::TupleValueExpression(type::Type::INTEGER, 0, 1),
+          expression::ExpressionUtil::ConstantValueFactory(
+              type::ValueFactory::GetIntegerValue(0))),
+      new expression::TupleValueExpression(type::Type::INTEGER, 1, 1), false);
+  std::shared_ptr<const catalog::Schema> schema;
+  planner::MergeJoinPlan merge_join_node(JoinType::INNER, nullptr, nullptr,
+                                         schema, join_clauses, true);
+  executor::MergeJoinExecutor merge_join_executor(&merge_join_node,
+                                                  context.get());
+  merge_join_executor.AddChild(&left_scan);
+  merge_join_executor.AddChild(&right_scan);
+
+  EXPECT_TRUE(merge_join_executor.Init());
+  EXPECT_THROW(merge_join_executor.Execute(), Exception);
+  txn_manager.CommitTransaction(txn);
+
+  executor::MergeJoinExecutor::SetSortThreadCount(
+      std::thread::hardware_concurrency());
+}
+
 void PopulateTable(storage::DataTable *table, int num_rows, bool random,
                    concurrency::Transaction *current_txn) {
   // Random values
@@ -263,7 +444,11 @@ void PopulateTable(storage::DataTable *table, int num_rows, bool random,
   }
 }
 
-void ExecuteNestedLoopJoinTest(JoinType join_type) {
+void ExecuteNestedLoopJoinTest(JoinType join_type,
+                               ExpressionType left_expr_type,
+                               oid_t expected_tuple_count,
+                               oid_t expected_tuples_with_null,
+                               ExpressionType right_expr_type) {
   //===--------------------------------------------------------------------===//
   // Create Table
   //===--------------------------------------------------------------------===//
@@ -315,7 +500,7 @@ void ExecuteNestedLoopJoinTest(JoinType join_type) {
   std::vector<expression::AbstractExpression *> runtime_keys;
 
   key_column_ids.push_back(0);
-  expr_types.push_back(ExpressionType::COMPARE_EQUAL);
+  expr_types.push_back(left_expr_type);
   values.push_back(type::ValueFactory::GetIntegerValue(50).Copy());
 
   // Create index scan desc
@@ -341,7 +526,7 @@ void ExecuteNestedLoopJoinTest(JoinType join_type) {
   std::vector<expression::AbstractExpression *> runtime_keys_right;
 
   key_column_ids_right.push_back(0);
-  expr_types_right.push_back(ExpressionType::COMPARE_EQUAL);
+  expr_types_right.push_back(right_expr_type);
   // values_right.push_back(type::ValueFactory::GetIntegerValue(100).Copy());
   values_right.push_back(type::ValueFactory::GetParameterOffsetValue(0).Copy());
 
@@ -418,6 +603,8 @@ void ExecuteNestedLoopJoinTest(JoinType join_type) {
       LOG_INFO("Nothing find out");
     }
   }
+  EXPECT_EQ(expected_tuple_count, result_tuple_count);
+  EXPECT_EQ(expected_tuples_with_null, tuples_with_null);
 
   txn_manager.CommitTransaction(txn);
 }
@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 #include <memory>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -206,5 +207,55 @@ TEST_F(LogicalTileTests, TileMaterializationTest) {
   LOG_TRACE("%s", logical_tile->GetInfo().c_str());
 }
 
+TEST_F(LogicalTileTests, MaterializeColumnsTest) {
+  const int tuple_count = 4;
+  std::shared_ptr<storage::TileGroup> tile_group(
+      TestingExecutorUtil::CreateTileGroup(tuple_count));
+  TestingExecutorUtil::PopulateTiles(tile_group, tuple_count);
+
+  // The rows of the first base tile come from an outer join, one is NULL
+  std::unique_ptr<executor::LogicalTile> logical_tile(
+      executor::LogicalTileFactory::GetTile());
+  logical_tile->AddPositionList({3, NULL_OID, 0});
+  logical_tile->AddPositionList({1, 2, 0});
+  auto base_tile_ref1 = tile_group->GetTileReference(0);
+  auto base_tile_ref2 = tile_group->GetTileReference(1);
+  logical_tile->AddColumn(base_tile_ref1, 0, 0);
+  logical_tile->AddColumn(base_tile_ref1, 1, 0);
+  logical_tile->AddColumn(base_tile_ref2, 0, 1);
+  logical_tile->AddColumn(base_tile_ref2, 1, 1);
+  logical_tile->RemoveVisibility(2);
+
+  // Reverse the columns
+  std::unique_ptr<catalog::Schema> physical_schema(
+      logical_tile->GetPhysicalSchema());
+  std::vector<catalog::Column> columns;
+  std::unordered_map<oid_t, oid_t> old_to_new_cols;
+  for (oid_t column_itr = 0; column_itr < 4; column_itr++) {
+    columns.push_back(physical_schema->GetColumn(3 - column_itr));
+    old_to_new_cols[3 - column_itr] = column_itr;
+  }
+  catalog::Schema dest_schema(columns);
+  std::unique_ptr<storage::Tile> dest_tile(
+      storage::TileFactory::GetTempTile(dest_schema, 2));
+  logical_tile->MaterializeColumns(old_to_new_cols, dest_tile.get());
+
+  EXPECT_EQ(TestingExecutorUtil::PopulatedValue(3, 0),
+            dest_tile->GetValue(0, 3).GetAs<int32_t>());
+  EXPECT_EQ(TestingExecutorUtil::PopulatedValue(3, 1),
+            dest_tile->GetValue(0, 2).GetAs<int32_t>());
+  EXPECT_EQ(TestingExecutorUtil::PopulatedValue(1, 2),
+            dest_tile->GetValue(0, 1).GetAs<double>());
+  EXPECT_EQ(std::to_string(TestingExecutorUtil::PopulatedValue(1, 3)),
+            dest_tile->GetValue(0, 0).ToString());
+
+  EXPECT_TRUE(dest_tile->GetValue(1, 3).IsNull());
+  EXPECT_TRUE(dest_tile->GetValue(1, 2).IsNull());
+  EXPECT_EQ(TestingExecutorUtil::PopulatedValue(2, 2),
+            dest_tile->GetValue(1, 1).GetAs<double>());
+  EXPECT_EQ(std::to_string(TestingExecutorUtil::PopulatedValue(2, 3)),
+            dest_tile->GetValue(1, 0).ToString());
+}
+
 }  // End test namespace
 }  // End peloton namespace
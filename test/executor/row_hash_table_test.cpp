@@ -0,0 +1,195 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// row_hash_table_test.cpp
+//
+// Identification: test/executor/row_hash_table_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "common/harness.h"
+
+#include "common/container_tuple.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/executor_context.h"
+#include "executor/hash_executor.h"
+#include "executor/logical_tile.h"
+#include "executor/row_hash_table.h"
+#include "executor/seq_scan_executor.h"
+#include "executor/testing_executor_util.h"
+#include "expression/tuple_value_expression.h"
+#include "planner/hash_plan.h"
+#include "planner/seq_scan_plan.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+class RowHashTableTests : public PelotonTest {};
+
+TEST_F(RowHashTableTests, KeyTest) {
+  executor::RowHashTable table(
+      {type::Type::INTEGER, type::Type::VARCHAR, type::Type::DECIMAL},
+      sizeof(int64_t));
+  std::vector<oid_t> column_ids({0, 1, 2});
+
+  std::vector<type::Value> key({type::ValueFactory::GetIntegerValue(1),
+                                type::ValueFactory::GetVarcharValue("abc"),
+                                type::ValueFactory::GetDecimalValue(0.5)});
+  expression::ContainerTuple<std::vector<type::Value>> tuple(&key);
+
+  bool inserted;
+  auto entry = table.Insert(&tuple, column_ids, nullptr, inserted);
+  ASSERT_NE(nullptr, entry);
+  EXPECT_TRUE(inserted);
+  EXPECT_EQ(0, *reinterpret_cast<int64_t *>(entry->GetPayload()));
+  *reinterpret_cast<int64_t *>(entry->GetPayload()) = 42;
+
+  // Integers of other widths are the same key
+  key[0] = type::ValueFactory::GetBigIntValue(1);
+  EXPECT_EQ(entry, table.Insert(&tuple, column_ids, nullptr, inserted));
+  EXPECT_FALSE(inserted);
+  EXPECT_EQ(42, *reinterpret_cast<int64_t *>(entry->GetPayload()));
+
+  key[1] = type::ValueFactory::GetVarcharValue("abd");
+  EXPECT_EQ(nullptr, table.Find(&tuple, column_ids));
+
+  // NULLs equal each other
+  key[0] = type::ValueFactory::GetNullValueByType(type::Type::INTEGER);
+  auto null_entry = table.Insert(&tuple, column_ids, nullptr, inserted);
+  EXPECT_TRUE(inserted);
+  EXPECT_EQ(null_entry, table.Find(&tuple, column_ids));
+  EXPECT_EQ(2, table.GetEntryCount());
+
+  std::vector<type::Value> values;
+  table.GetKey(entry, values);
+  EXPECT_EQ(1, values[0].GetAs<int32_t>());
+  EXPECT_EQ("abc", values[1].ToString());
+  EXPECT_EQ(0.5, values[2].GetAs<double>());
+  table.GetKey(null_entry, values);
+  EXPECT_TRUE(values[0].IsNull());
+  EXPECT_EQ("abd", values[1].ToString());
+  EXPECT_FALSE(table.IsSpilling());
+}
+
+TEST_F(RowHashTableTests, SpillTest) {
+  const int key_count = 1000;
+  auto memory_limit = executor::RowHashTable::GetMemoryLimit();
+  executor::RowHashTable::SetMemoryLimit(1 << 12);
+  executor::RowHashTable table({type::Type::INTEGER}, sizeof(int64_t),
+                               sizeof(int));
+  executor::RowHashTable::SetMemoryLimit(memory_limit);
+
+  // Every key is added twice, each time with its record
+  std::vector<oid_t> column_ids({0});
+  std::vector<type::Value> key(1);
+  expression::ContainerTuple<std::vector<type::Value>> tuple(&key);
+  for (int round = 0; round < 2; round++) {
+    for (int value = 0; value < key_count; value++) {
+      key[0] = type::ValueFactory::GetIntegerValue(value);
+      bool inserted;
+      auto entry = table.Insert(&tuple, column_ids, &value, inserted);
+      if (entry != nullptr) {
+        EXPECT_EQ(round == 0, inserted);
+        (*reinterpret_cast<int64_t *>(entry->GetPayload()))++;
+      }
+    }
+  }
+  EXPECT_TRUE(table.IsSpilling());
+  EXPECT_LT(0, table.GetEntryCount());
+  EXPECT_GT(key_count, table.GetEntryCount());
+
+  std::set<int> keys;
+  for (auto entry : table.GetEntries()) {
+    EXPECT_EQ(2, *reinterpret_cast<int64_t *>(entry->GetPayload()));
+    std::vector<type::Value> values;
+    table.GetKey(entry, values);
+    keys.insert(values[0].GetAs<int32_t>());
+  }
+
+  // Both records of every spilled key are in the same partition
+  for (size_t partition = 0;
+       partition < executor::RowHashTable::partition_count; partition++) {
+    if (table.IsPartitionSpilled(partition) == false) continue;
+
+    table.LoadPartition(partition);
+    executor::RowHashTable::Entry *entry;
+    const char *record;
+    bool inserted;
+    while ((entry = table.NextRecord(record, inserted)) != nullptr) {
+      int value = *reinterpret_cast<const int *>(record);
+      EXPECT_EQ(inserted, keys.count(value) == 0);
+      keys.insert(value);
+      (*reinterpret_cast<int64_t *>(entry->GetPayload()))++;
+    }
+    for (auto entry : table.GetEntries()) {
+      EXPECT_EQ(2, *reinterpret_cast<int64_t *>(entry->GetPayload()));
+    }
+  }
+  EXPECT_EQ(key_count, keys.size());
+}
+
+TEST_F(RowHashTableTests, DistinctSpillTest) {
+  const int tuple_count = 1000;
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(tuple_count / 4, false));
+  TestingExecutorUtil::PopulateTable(table.get(), tuple_count, false, true,
+                                     false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  // The second column has duplicates
+  std::set<int> distinct_values;
+  for (oid_t offset = 0; offset < table->GetTileGroupCount(); offset++) {
+    auto tile_group = table->GetTileGroup(offset);
+    for (oid_t row = 0; row < tile_group->GetNextTupleSlot(); row++) {
+      distinct_values.insert(tile_group->GetValue(row, 1).GetAs<int32_t>());
+    }
+  }
+
+  auto memory_limit = executor::RowHashTable::GetMemoryLimit();
+  executor::RowHashTable::SetMemoryLimit(1 << 12);
+
+  txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+  planner::SeqScanPlan scan_node(table.get(), nullptr, {0, 1});
+  executor::SeqScanExecutor scan_executor(&scan_node, context.get());
+
+  std::vector<std::unique_ptr<const expression::AbstractExpression>> hash_keys;
+  hash_keys.emplace_back(
+      new expression::TupleValueExpression(type::Type::INTEGER, 0, 1));
+  planner::HashPlan hash_node(hash_keys);
+  executor::HashExecutor hash_executor(&hash_node, context.get());
+  hash_executor.AddChild(&scan_executor);
+
+  EXPECT_TRUE(hash_executor.Init());
+  std::set<int> result_values;
+  size_t result_count = 0;
+  while (hash_executor.Execute()) {
+    std::unique_ptr<executor::LogicalTile> result_tile(
+        hash_executor.GetOutput());
+    for (oid_t tuple_id : *result_tile) {
+      result_values.insert(result_tile->GetValue(tuple_id, 1).GetAs<int32_t>());
+      result_count++;
+    }
+  }
+  txn_manager.CommitTransaction(txn);
+  executor::RowHashTable::SetMemoryLimit(memory_limit);
+
+  EXPECT_EQ(distinct_values.size(), result_count);
+  EXPECT_EQ(distinct_values, result_values);
+}
+
+}  // namespace test
+}  // namespace peloton
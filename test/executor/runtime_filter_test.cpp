@@ -0,0 +1,152 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// runtime_filter_test.cpp
+//
+// Identification: test/executor/runtime_filter_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <vector>
+
+#include "common/harness.h"
+
+#include "common/container_tuple.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/executor_context.h"
+#include "executor/hash_executor.h"
+#include "executor/hash_join_executor.h"
+#include "executor/logical_tile.h"
+#include "executor/runtime_filter.h"
+#include "executor/seq_scan_executor.h"
+#include "executor/testing_executor_util.h"
+#include "expression/tuple_value_expression.h"
+#include "planner/hash_join_plan.h"
+#include "planner/hash_plan.h"
+#include "planner/seq_scan_plan.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+class RuntimeFilterTests : public PelotonTest {};
+
+TEST_F(RuntimeFilterTests, FilterTest) {
+  const int key_count = 1000;
+  executor::RuntimeFilter filter({type::Type::INTEGER}, key_count);
+  std::vector<oid_t> key_column_ids({0});
+
+  // Even keys are inserted
+  std::vector<type::Value> key(1);
+  expression::ContainerTuple<std::vector<type::Value>> tuple(&key);
+  for (int value = 0; value < key_count * 2; value += 2) {
+    key[0] = type::ValueFactory::GetIntegerValue(value);
+    filter.Insert(&tuple, key_column_ids);
+  }
+  key[0] = type::ValueFactory::GetNullValueByType(type::Type::INTEGER);
+  filter.Insert(&tuple, key_column_ids);
+  EXPECT_EQ(key_count, filter.GetKeyCount());
+
+  // No false negatives, few false positives
+  int false_positives = 0;
+  for (int value = 0; value < key_count * 2; value++) {
+    key[0] = type::ValueFactory::GetIntegerValue(value);
+    if (value % 2 == 0) {
+      EXPECT_TRUE(filter.MayContain(&tuple, key_column_ids));
+    } else if (filter.MayContain(&tuple, key_column_ids)) {
+      false_positives++;
+    }
+  }
+  EXPECT_GT(key_count / 20, false_positives);
+
+  // Other integer types hash like the keys, NULL never matches
+  key[0] = type::ValueFactory::GetBigIntValue(42);
+  EXPECT_TRUE(filter.MayContain(&tuple, key_column_ids));
+  key[0] = type::ValueFactory::GetNullValueByType(type::Type::INTEGER);
+  EXPECT_FALSE(filter.MayContain(&tuple, key_column_ids));
+  EXPECT_TRUE(filter.IsCompatible(0, type::Type::SMALLINT));
+  EXPECT_FALSE(filter.IsCompatible(0, type::Type::DECIMAL));
+
+  type::Value min_value, max_value;
+  EXPECT_TRUE(filter.GetRange(0, min_value, max_value));
+  EXPECT_EQ(0, min_value.GetAs<int32_t>());
+  EXPECT_EQ(key_count * 2 - 2, max_value.GetAs<int32_t>());
+
+  // An empty filter matches nothing
+  executor::RuntimeFilter empty_filter({type::Type::INTEGER}, 0);
+  key[0] = type::ValueFactory::GetIntegerValue(0);
+  EXPECT_FALSE(empty_filter.MayContain(&tuple, key_column_ids));
+  EXPECT_FALSE(empty_filter.GetRange(0, min_value, max_value));
+}
+
+TEST_F(RuntimeFilterTests, HashJoinPushdownTest) {
+  const int tuple_count = 5;
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+
+  // The first column of the left table is ten times the row, the right
+  // table only holds the keys of the first left tile group
+  std::unique_ptr<storage::DataTable> left_table(
+      TestingExecutorUtil::CreateTable(tuple_count, false));
+  TestingExecutorUtil::PopulateTable(left_table.get(), tuple_count * 4, false,
+                                     false, false, txn);
+  std::unique_ptr<storage::DataTable> right_table(
+      TestingExecutorUtil::CreateTable(tuple_count, false));
+  TestingExecutorUtil::PopulateTable(right_table.get(), tuple_count, false,
+                                     false, false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  planner::SeqScanPlan left_scan_node(left_table.get(), nullptr, {0, 1});
+  executor::SeqScanExecutor left_scan(&left_scan_node, context.get());
+  planner::SeqScanPlan right_scan_node(right_table.get(), nullptr, {0, 1});
+  executor::SeqScanExecutor right_scan(&right_scan_node, context.get());
+
+  std::vector<std::unique_ptr<const expression::AbstractExpression>> hash_keys;
+  hash_keys.emplace_back(
+      new expression::TupleValueExpression(type::Type::INTEGER, 1, 0));
+  planner::HashPlan hash_node(hash_keys);
+  executor::HashExecutor hash_executor(&hash_node, context.get());
+  hash_executor.AddChild(&right_scan);
+
+  std::shared_ptr<const catalog::Schema> schema;
+  planner::HashJoinPlan hash_join_node(JoinType::INNER, nullptr, nullptr,
+                                       schema, {0});
+  executor::HashJoinExecutor hash_join_executor(&hash_join_node,
+                                                context.get());
+  hash_join_executor.AddChild(&left_scan);
+  hash_join_executor.AddChild(&hash_executor);
+
+  EXPECT_TRUE(hash_join_executor.Init());
+  size_t result_count = 0;
+  while (hash_join_executor.Execute()) {
+    std::unique_ptr<executor::LogicalTile> result_tile(
+        hash_join_executor.GetOutput());
+    for (oid_t tuple_id : *result_tile) {
+      EXPECT_EQ(result_tile->GetValue(tuple_id, 0).GetAs<int32_t>(),
+                result_tile->GetValue(tuple_id, 2).GetAs<int32_t>());
+      result_count++;
+    }
+  }
+  txn_manager.CommitTransaction(txn);
+  EXPECT_EQ(tuple_count, result_count);
+
+  // The left tile groups out of the range of the right keys were skipped
+  EXPECT_LT(0, left_table->GetTileGroup(0)->GetHeader()->GetReadCount());
+  for (oid_t offset = 1; offset < 4; offset++) {
+    EXPECT_EQ(0, left_table->GetTileGroup(offset)->GetHeader()->GetReadCount());
+  }
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,242 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// spill_test.cpp
+//
+// Identification: test/executor/spill_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "common/harness.h"
+
+#include "common/container_tuple.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/aggregate_executor.h"
+#include "executor/executor_context.h"
+#include "executor/hash_executor.h"
+#include "executor/hash_join_executor.h"
+#include "executor/logical_tile.h"
+#include "executor/seq_scan_executor.h"
+#include "executor/spill_file.h"
+#include "executor/testing_executor_util.h"
+#include "executor/testing_join_util.h"
+#include "expression/expression_util.h"
+#include "expression/tuple_value_expression.h"
+#include "planner/aggregate_plan.h"
+#include "planner/hash_join_plan.h"
+#include "planner/hash_plan.h"
+#include "planner/seq_scan_plan.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+class SpillTests : public PelotonTest {};
+
+namespace {
+
+// Number of rows of every value of the column
+std::map<int, size_t> CountValues(storage::DataTable *table, oid_t column_id) {
+  std::map<int, size_t> counts;
+  for (oid_t offset = 0; offset < table->GetTileGroupCount(); offset++) {
+    auto tile_group = table->GetTileGroup(offset);
+    for (oid_t row = 0; row < tile_group->GetNextTupleSlot(); row++) {
+      counts[tile_group->GetValue(row, column_id).GetAs<int32_t>()]++;
+    }
+  }
+  return counts;
+}
+
+}  // namespace
+
+TEST_F(SpillTests, SpillFileTest) {
+  const int row_count = 10000;
+  executor::SpillFile file;
+
+  std::vector<type::Value> row(3);
+  expression::ContainerTuple<std::vector<type::Value>> tuple(&row);
+  for (int value = 0; value < row_count; value++) {
+    row[0] = type::ValueFactory::GetIntegerValue(value);
+    row[1] = type::ValueFactory::GetVarcharValue(std::to_string(value));
+    row[2] = value % 2 == 0
+                 ? type::ValueFactory::GetNullValueByType(type::Type::DECIMAL)
+                 : type::ValueFactory::GetDecimalValue(value / 2.0);
+    file.WriteRow(&tuple, row.size());
+  }
+  EXPECT_LT(executor::SpillFile::buffer_size, file.GetSize());
+
+  // The rows read back the same, also the second time
+  std::vector<type::Type::TypeId> types(
+      {type::Type::INTEGER, type::Type::VARCHAR, type::Type::DECIMAL});
+  for (int pass = 0; pass < 2; pass++) {
+    file.Rewind();
+    int value = 0;
+    while (file.ReadRow(types, row)) {
+      EXPECT_EQ(value, row[0].GetAs<int32_t>());
+      EXPECT_EQ(std::to_string(value), row[1].ToString());
+      if (value % 2 == 0) {
+        EXPECT_TRUE(row[2].IsNull());
+      } else {
+        EXPECT_EQ(value / 2.0, row[2].GetAs<double>());
+      }
+      value++;
+    }
+    EXPECT_EQ(row_count, value);
+  }
+}
+
+TEST_F(SpillTests, HashJoinSpillTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> left_table(
+      TestingExecutorUtil::CreateTable(250, false));
+  TestingExecutorUtil::PopulateTable(left_table.get(), 1000, false, true,
+                                     false, txn);
+  std::unique_ptr<storage::DataTable> right_table(
+      TestingExecutorUtil::CreateTable(100, false));
+  TestingExecutorUtil::PopulateTable(right_table.get(), 300, false, true,
+                                     false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  // The tables join on their second columns
+  auto left_counts = CountValues(left_table.get(), 1);
+  auto right_counts = CountValues(right_table.get(), 1);
+  size_t inner_count = 0, left_only_count = 0, right_only_count = 0;
+  for (auto &left_count : left_counts) {
+    auto right_count = right_counts.find(left_count.first);
+    if (right_count == right_counts.end()) {
+      left_only_count += left_count.second;
+    } else {
+      inner_count += left_count.second * right_count->second;
+    }
+  }
+  for (auto &right_count : right_counts) {
+    if (left_counts.count(right_count.first) == 0) {
+      right_only_count += right_count.second;
+    }
+  }
+
+  for (auto join_type : {JoinType::INNER, JoinType::LEFT, JoinType::RIGHT,
+                         JoinType::OUTER}) {
+    txn = txn_manager.BeginTransaction();
+    std::unique_ptr<executor::ExecutorContext> context(
+        new executor::ExecutorContext(txn));
+    context->SetMemoryBudget(1 << 13);
+
+    size_t result_count = 0;
+    {
+      planner::SeqScanPlan left_scan_node(left_table.get(), nullptr,
+                                          {0, 1, 2, 3});
+      executor::SeqScanExecutor left_scan_executor(&left_scan_node,
+                                                   context.get());
+      planner::SeqScanPlan right_scan_node(right_table.get(), nullptr,
+                                           {0, 1, 2, 3});
+      executor::SeqScanExecutor right_scan_executor(&right_scan_node,
+                                                    context.get());
+
+      std::vector<std::unique_ptr<const expression::AbstractExpression>>
+          hash_keys;
+      hash_keys.emplace_back(
+          new expression::TupleValueExpression(type::Type::INTEGER, 1, 1));
+      planner::HashPlan hash_node(hash_keys);
+      executor::HashExecutor hash_executor(&hash_node, context.get());
+      hash_executor.AddChild(&right_scan_executor);
+
+      std::shared_ptr<const catalog::Schema> schema(new catalog::Schema(
+          {TestingExecutorUtil::GetColumnInfo(1),
+           TestingExecutorUtil::GetColumnInfo(1),
+           TestingExecutorUtil::GetColumnInfo(0),
+           TestingExecutorUtil::GetColumnInfo(0)}));
+      planner::HashJoinPlan hash_join_node(join_type, nullptr,
+                                           TestingJoinUtil::CreateProjection(),
+                                           schema);
+      executor::HashJoinExecutor hash_join_executor(&hash_join_node,
+                                                    context.get());
+      hash_join_executor.AddChild(&left_scan_executor);
+      hash_join_executor.AddChild(&hash_executor);
+
+      EXPECT_TRUE(hash_join_executor.Init());
+      while (hash_join_executor.Execute()) {
+        std::unique_ptr<executor::LogicalTile> result_tile(
+            hash_join_executor.GetOutput());
+        result_count += result_tile->GetTupleCount();
+      }
+      EXPECT_TRUE(hash_executor.HasOverflowed());
+    }
+    txn_manager.CommitTransaction(txn);
+
+    size_t expected_count = inner_count;
+    if (join_type == JoinType::LEFT || join_type == JoinType::OUTER) {
+      expected_count += left_only_count;
+    }
+    if (join_type == JoinType::RIGHT || join_type == JoinType::OUTER) {
+      expected_count += right_only_count;
+    }
+    EXPECT_EQ(expected_count, result_count);
+    EXPECT_EQ(0, context->GetMemoryUsage());
+  }
+}
+
+TEST_F(SpillTests, HashAggregateSpillTest) {
+  // SELECT b, COUNT(*) FROM table GROUP BY b
+  const int tuple_count = 3000;
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(tuple_count / 4, false));
+  TestingExecutorUtil::PopulateTable(table.get(), tuple_count, false, true,
+                                     false, txn);
+  txn_manager.CommitTransaction(txn);
+  auto counts = CountValues(table.get(), 1);
+
+  DirectMapList direct_map_list = {{0, {0, 1}}, {1, {1, 0}}};
+  std::unique_ptr<const planner::ProjectInfo> proj_info(
+      new planner::ProjectInfo(TargetList(), std::move(direct_map_list)));
+  std::vector<planner::AggregatePlan::AggTerm> agg_terms;
+  agg_terms.emplace_back(ExpressionType::AGGREGATE_COUNT_STAR, nullptr);
+  std::shared_ptr<const catalog::Schema> output_table_schema(
+      new catalog::Schema({TestingExecutorUtil::GetColumnInfo(1),
+                           TestingExecutorUtil::GetColumnInfo(1)}));
+  planner::AggregatePlan node(std::move(proj_info), nullptr,
+                              std::move(agg_terms), {1}, output_table_schema,
+                              AggregateType::HASH);
+
+  txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+  context->SetMemoryBudget(1 << 12);
+
+  std::map<int, size_t> result_counts;
+  {
+    planner::SeqScanPlan scan_node(table.get(), nullptr, {0, 1, 2, 3});
+    executor::SeqScanExecutor scan_executor(&scan_node, context.get());
+    executor::AggregateExecutor executor(&node, context.get());
+    executor.AddChild(&scan_executor);
+
+    EXPECT_TRUE(executor.Init());
+    while (executor.Execute()) {
+      std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+      for (oid_t tuple_id : *result_tile) {
+        int value = result_tile->GetValue(tuple_id, 0).GetAs<int32_t>();
+        EXPECT_EQ(0, result_counts.count(value));
+        result_counts[value] = result_tile->GetValue(tuple_id, 1).GetAs<int32_t>();
+      }
+    }
+  }
+  txn_manager.CommitTransaction(txn);
+
+  EXPECT_EQ(counts, result_counts);
+  EXPECT_EQ(0, context->GetMemoryUsage());
+}
+
+}  // namespace test
+}  // namespace peloton
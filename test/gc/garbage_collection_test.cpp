@@ -16,6 +16,8 @@
 #include "gc/gc_manager.h"
 #include "gc/gc_manager_factory.h"
 #include "concurrency/epoch_manager.h"
+#include "configuration/configuration.h"
+#include "statistics/backend_stats_context.h"
 
 
 #include "catalog/catalog.h"
@@ -197,6 +199,115 @@ TEST_F(GarbageCollectionTests, SimpleTest) {
   }
 }
 
+TEST_F(GarbageCollectionTests, CooperativeTest) {
+
+  std::vector<std::unique_ptr<std::thread>> gc_threads;
+
+  FLAGS_stats_mode = STATS_TYPE_ENABLE;
+
+  gc::GCManagerFactory::Configure(1);
+  auto &gc_manager = gc::GCManagerFactory::GetInstance();
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+
+  // Epoch slots remember the largest cid per epoch, so stay above the epochs
+  // of the previous test
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  const size_t epoch = 100;
+  epoch_manager.Reset(epoch);
+
+  auto catalog = catalog::Catalog::GetInstance();
+  // create database
+  auto database = TestingExecutorUtil::InitializeDatabase(DEFAULT_DB_NAME);
+  oid_t db_id = database->GetOid();
+  EXPECT_TRUE(catalog->HasDatabase(db_id));
+
+  // create a table with only one key
+  const int num_key = 1;
+  std::unique_ptr<storage::DataTable> table(
+    TestingTransactionUtil::CreateTable(num_key, "TEST_TABLE", db_id, INVALID_OID, 1234, true));
+
+  // only the lookups below may collect garbage
+  gc_manager.StartGC(gc_threads);
+  gc_manager.PauseGC();
+
+  // All txns run on this thread, so they share one epoch slot
+  auto update = [&](int value) {
+    auto txn = txn_manager.BeginTransaction();
+    EXPECT_TRUE(TestingTransactionUtil::ExecuteUpdate(txn, table.get(), 0,
+                                                      value, false));
+    EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+  };
+  auto empty_txn = [&]() {
+    auto txn = txn_manager.BeginTransaction();
+    EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+  };
+  // versions each reader walks, one more than a lookup passes without help
+  const int chain_length = COOPERATIVE_GC_CHAIN_LENGTH + 1;
+
+  // this is the garbage the lookups have to collect
+  epoch_manager.Reset(epoch + 1);
+  update(1);
+  // txns of older epochs bound what the GC may collect
+  epoch_manager.Reset(epoch + 2);
+  empty_txn();
+
+  // The first reader walks past the newer versions to the one it sees,
+  // which unlinks the garbage
+  epoch_manager.Reset(epoch + 5);
+  auto reader = txn_manager.BeginTransaction();
+  epoch_manager.Reset(epoch + 7);
+  for (int value = 2; value < chain_length + 1; value++) {
+    update(value);
+  }
+  int result;
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteRead(reader, table.get(), 0,
+                                                  result, false));
+  EXPECT_EQ(1, result);
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(reader));
+  EXPECT_EQ(0, RecycledNum(table.get()));
+
+  // and the second one reclaims it
+  epoch_manager.Reset(epoch + 8);
+  empty_txn();
+  epoch_manager.Reset(epoch + 11);
+  reader = txn_manager.BeginTransaction();
+  epoch_manager.Reset(epoch + 13);
+  for (int value = chain_length + 1; value < 2 * chain_length; value++) {
+    update(value);
+  }
+  auto old_num = GarbageNum(table.get());
+  EXPECT_EQ(2 * chain_length - 1, old_num);
+
+  auto &inline_reclaimed = stats::BackendStatsContext::GetInstance()
+                               ->GetInlineGCReclaimedMetric();
+  auto inline_reclaimed_count = inline_reclaimed.GetCounter();
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteRead(reader, table.get(), 0,
+                                                  result, false));
+  EXPECT_EQ(chain_length, result);
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(reader));
+
+  // the lookup itself recycled the garbage, exactly once
+  EXPECT_LT(inline_reclaimed_count, inline_reclaimed.GetCounter());
+  EXPECT_EQ(old_num - 1, GarbageNum(table.get()));
+  EXPECT_EQ(1, RecycledNum(table.get()));
+
+  gc_manager.ResumeGC();
+  gc_manager.StopGC();
+
+  table.release();
+
+  // DROP!
+  TestingExecutorUtil::DeleteDatabase(DEFAULT_DB_NAME);
+  EXPECT_FALSE(catalog->HasDatabase(db_id));
+
+  gc::GCManagerFactory::Configure(0);
+  FLAGS_stats_mode = STATS_TYPE_INVALID;
+
+  for (auto &gc_thread : gc_threads) {
+    gc_thread->join();
+  }
+}
+
 
 }  // End test namespace
 }  // End peloton namespace
@@ -45,6 +45,10 @@ TEST_F(BwTreeIndexTests, NonUniqueKeyDeleteTest) {
   TestingIndexUtil::NonUniqueKeyDeleteTest(IndexType::BWTREE);
 }
 
+TEST_F(BwTreeIndexTests, ScanKeysTest) {
+  TestingIndexUtil::ScanKeysTest(IndexType::BWTREE);
+}
+
 TEST_F(BwTreeIndexTests, MultiThreadedInsertTest) {
   TestingIndexUtil::MultiThreadedInsertTest(IndexType::BWTREE);
 }
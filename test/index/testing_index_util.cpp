@@ -12,6 +12,8 @@
 
 #include "index/testing_index_util.h"
 
+#include <algorithm>
+
 #include "gtest/gtest.h"
 
 #include "common/harness.h"
@@ -217,6 +219,65 @@ void TestingIndexUtil::NonUniqueKeyDeleteTest(const IndexType index_type) {
   delete index->GetMetadata()->GetTupleSchema();
 }
 
+void TestingIndexUtil::ScanKeysTest(const IndexType index_type) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+
+  // INDEX
+  std::unique_ptr<index::Index> index(
+      TestingIndexUtil::BuildIndex(index_type, false));
+  const catalog::Schema *key_schema = index->GetKeySchema();
+
+  // Even keys from 0 to 998, key 500 has two entries
+  const int key_count = 1000;
+  std::vector<ItemPointer> items;
+  for (int key_itr = 0; key_itr <= key_count; key_itr++) {
+    items.emplace_back(key_itr, 0);
+  }
+  auto make_key = [&](int key_value) {
+    std::unique_ptr<storage::Tuple> key(new storage::Tuple(key_schema, true));
+    key->SetValue(0, type::ValueFactory::GetIntegerValue(key_value), pool);
+    key->SetValue(1, type::ValueFactory::GetVarcharValue("a"), pool);
+    return key;
+  };
+  for (int key_itr = 0; key_itr < key_count; key_itr += 2) {
+    auto key = make_key(key_itr);
+    index->InsertEntry(key.get(), &items[key_itr]);
+  }
+  auto key500 = make_key(500);
+  index->InsertEntry(key500.get(), &items[key_count]);
+
+  // Unsorted, repeated, missing and far apart keys, and keys past the end
+  std::vector<int> key_values = {998, 4,  6,   500, 2,    500, 3,
+                                 0,   12, 900, 4,   1000, 1200};
+  std::vector<std::unique_ptr<storage::Tuple>> keys;
+  std::vector<const storage::Tuple *> key_ptrs;
+  for (auto key_value : key_values) {
+    keys.push_back(make_key(key_value));
+    key_ptrs.push_back(keys.back().get());
+  }
+
+  std::vector<std::vector<ItemPointer *>> results;
+  index->ScanKeys(key_ptrs, results);
+  EXPECT_EQ(key_values.size(), results.size());
+
+  // Every key finds the same entries as a single key lookup
+  std::vector<ItemPointer *> location_ptrs;
+  for (size_t key_itr = 0; key_itr < key_values.size(); key_itr++) {
+    index->ScanKey(key_ptrs[key_itr], location_ptrs);
+    std::sort(location_ptrs.begin(), location_ptrs.end());
+    std::sort(results[key_itr].begin(), results[key_itr].end());
+    EXPECT_EQ(location_ptrs, results[key_itr]);
+
+    int key_value = key_values[key_itr];
+    size_t expected_count = (key_value == 500) ? 2 : 1;
+    if (key_value % 2 != 0 || key_value >= key_count) expected_count = 0;
+    EXPECT_EQ(expected_count, results[key_itr].size());
+    location_ptrs.clear();
+  }
+
+  delete index->GetMetadata()->GetTupleSchema();
+}
+
 void TestingIndexUtil::MultiThreadedInsertTest(const IndexType index_type) {
   auto pool = TestingHarness::GetInstance().GetTestingPool();
   std::vector<ItemPointer *> location_ptrs;
@@ -0,0 +1,181 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// column_stats_test.cpp
+//
+// Identification: test/optimizer/column_stats_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <vector>
+
+#include "common/harness.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/testing_executor_util.h"
+#include "optimizer/hyperloglog.h"
+#include "optimizer/stats.h"
+#include "optimizer/stats_collector.h"
+#include "optimizer/tuple_sample.h"
+#include "storage/data_table.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Column Stats Tests
+//===--------------------------------------------------------------------===//
+
+class ColumnStatsTests : public PelotonTest {};
+
+TEST_F(ColumnStatsTests, HyperLogLogTest) {
+  const int value_count = 100000;
+  optimizer::HyperLogLog sketch;
+  optimizer::HyperLogLog first_half, second_half;
+  for (int value = 0; value < value_count; value++) {
+    auto integer_value = type::ValueFactory::GetIntegerValue(value);
+    sketch.Add(integer_value);
+    sketch.Add(integer_value);
+    if (value < value_count / 2) {
+      first_half.Add(integer_value);
+    } else {
+      second_half.Add(integer_value);
+    }
+  }
+  sketch.Add(type::ValueFactory::GetNullValueByType(type::Type::INTEGER));
+
+  // Duplicates and NULLs are not counted, the error is about 1.6%
+  EXPECT_NEAR(value_count, sketch.Estimate(), value_count * 0.05);
+
+  first_half.Merge(second_half);
+  EXPECT_NEAR(value_count, first_half.Estimate(), value_count * 0.05);
+
+  // Small counts are exact in practice
+  optimizer::HyperLogLog small_sketch;
+  for (int value = 0; value < 10; value++) {
+    small_sketch.Add(type::ValueFactory::GetVarcharValue(std::to_string(value)));
+  }
+  EXPECT_NEAR(10, small_sketch.Estimate(), 0.5);
+}
+
+TEST_F(ColumnStatsTests, TupleSampleTest) {
+  const size_t capacity = 200;
+  const int row_count = 20000;
+  optimizer::TupleSample sample(capacity, 1);
+  optimizer::TupleSample other_sample(capacity, 2);
+  for (int row_itr = 0; row_itr < row_count; row_itr++) {
+    auto &target = (row_itr % 4 == 0) ? other_sample : sample;
+    auto slot = target.Offer();
+    if (slot >= 0) {
+      target.SetRow(slot, {type::ValueFactory::GetIntegerValue(row_itr)});
+    }
+  }
+  EXPECT_EQ(capacity, sample.GetRows().size());
+  EXPECT_EQ(row_count / 4, other_sample.GetSeenCount());
+
+  sample.Merge(other_sample);
+  EXPECT_EQ(row_count, sample.GetSeenCount());
+  EXPECT_EQ(capacity, sample.GetRows().size());
+
+  // A uniform sample has about the mean of the population
+  double sum = 0;
+  size_t other_count = 0;
+  for (auto &row : sample.GetRows()) {
+    auto value = row[0].GetAs<int32_t>();
+    sum += value;
+    if (value % 4 == 0) {
+      other_count++;
+    }
+  }
+  EXPECT_NEAR(row_count / 2, sum / capacity, row_count * 0.1);
+  EXPECT_NEAR(capacity / 4, other_count, capacity * 0.15);
+}
+
+TEST_F(ColumnStatsTests, SelectivityTest) {
+  // 1000 distinct values, one of them is a third of the rows
+  std::vector<type::Value> values;
+  for (int value = 0; value < 1000; value++) {
+    values.push_back(type::ValueFactory::GetIntegerValue(value));
+  }
+  for (int value_itr = 0; value_itr < 500; value_itr++) {
+    values.push_back(type::ValueFactory::GetIntegerValue(7));
+  }
+
+  optimizer::ColumnStats column_stats(0, type::Type::INTEGER);
+  column_stats.Build(values, 1500, 0, 1000);
+  EXPECT_EQ(0, column_stats.null_fraction);
+  EXPECT_EQ(1000, column_stats.num_distinct);
+  ASSERT_FALSE(column_stats.most_common_values.empty());
+  EXPECT_EQ(7, column_stats.most_common_values[0].GetAs<int32_t>());
+  EXPECT_FALSE(column_stats.histogram_bounds.empty());
+
+  auto seven = type::ValueFactory::GetIntegerValue(7);
+  EXPECT_NEAR(501.0 / 1500, column_stats.EstimateEqualSelectivity(seven),
+              0.01);
+  EXPECT_NEAR(1.0 / 1500, column_stats.EstimateEqualSelectivity(
+                              type::ValueFactory::GetIntegerValue(500)),
+              0.001);
+
+  // Half of the other values and the common one
+  auto five_hundred = type::ValueFactory::GetIntegerValue(500);
+  EXPECT_NEAR(1000.0 / 1500,
+              column_stats.EstimateSelectivity(
+                  ExpressionType::COMPARE_LESSTHAN, five_hundred),
+              0.03);
+  EXPECT_NEAR(500.0 / 1500,
+              column_stats.EstimateSelectivity(
+                  ExpressionType::COMPARE_GREATERTHANOREQUALTO, five_hundred),
+              0.03);
+  EXPECT_EQ(0, column_stats.EstimateSelectivity(
+                   ExpressionType::COMPARE_LESSTHAN,
+                   type::ValueFactory::GetIntegerValue(-1)));
+}
+
+TEST_F(ColumnStatsTests, CollectTest) {
+  const int row_count = 5000;
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(50, false));
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  // The first column has two distinct values, the others are unique
+  TestingExecutorUtil::PopulateTable(table.get(), row_count, false, false,
+                                     true, txn);
+  txn_manager.CommitTransaction(txn);
+
+  optimizer::StatsCollector::SetThreadCount(4);
+  optimizer::StatsCollector::SetSampleSize(1000);
+  txn = txn_manager.BeginReadonlyTransaction();
+  auto table_stats = optimizer::StatsCollector(table.get()).Collect(txn);
+  txn_manager.CommitTransaction(txn);
+  optimizer::StatsCollector::SetSampleSize(
+      optimizer::StatsCollector::default_sample_size);
+
+  EXPECT_EQ(row_count, table_stats->num_rows);
+  EXPECT_EQ(table->GetModificationCount(), table_stats->modification_count);
+  ASSERT_EQ(4, table_stats->column_stats.size());
+
+  auto group_column = table_stats->GetColumnStats(0);
+  EXPECT_EQ(2, group_column->num_distinct);
+  EXPECT_EQ(2, group_column->most_common_values.size());
+  EXPECT_NEAR(0.5, group_column->most_common_frequencies[0], 0.1);
+
+  auto unique_column = table_stats->GetColumnStats(1);
+  EXPECT_NEAR(row_count, unique_column->num_distinct, row_count * 0.05);
+  EXPECT_TRUE(unique_column->most_common_values.empty());
+  auto middle = type::ValueFactory::GetIntegerValue(
+      TestingExecutorUtil::PopulatedValue(row_count / 2, 1));
+  EXPECT_NEAR(0.5, unique_column->EstimateSelectivity(
+                       ExpressionType::COMPARE_LESSTHAN, middle),
+              0.1);
+
+  auto string_column = table_stats->GetColumnStats(3);
+  EXPECT_EQ(0, string_column->null_fraction);
+  EXPECT_NEAR(row_count, string_column->num_distinct, row_count * 0.05);
+}
+
+}  // namespace test
+}  // namespace peloton
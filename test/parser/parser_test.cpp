@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -381,6 +382,8 @@ TEST_F(ParserTests, CopyTest) {
   std::string file_path = "/home/user/output.csv";
   queries.push_back("COPY catalog_db.query_metric TO '" + file_path +
                     "' DELIMITER ',';");
+  queries.push_back("COPY foo FROM '" + file_path + "' DELIMITER ',';");
+  queries.push_back("COPY foo TO '" + file_path + "' WITH BINARY;");
 
   // Parsing
   UNUSED_ATTRIBUTE int ii = 0;
@@ -407,5 +410,24 @@ TEST_F(ParserTests, CopyTest) {
   }
 }
 
+TEST_F(ParserTests, AnalyzeTest) {
+  std::unique_ptr<parser::SQLStatementList> result(
+      parser::Parser::ParseSQLString("ANALYZE test_db.foo;"));
+  EXPECT_TRUE(result->is_valid);
+  EXPECT_EQ(StatementType::ANALYZE, result->GetStatement(0)->GetType());
+  auto analyze_stmt =
+      static_cast<parser::AnalyzeStatement*>(result->GetStatement(0));
+  EXPECT_TRUE(analyze_stmt->HasTable());
+  EXPECT_EQ("foo", analyze_stmt->GetTableName());
+  EXPECT_EQ("test_db", analyze_stmt->GetDatabaseName());
+
+  // Without a table the stale tables are analyzed
+  result.reset(parser::Parser::ParseSQLString("ANALYZE;"));
+  EXPECT_TRUE(result->is_valid);
+  analyze_stmt =
+      static_cast<parser::AnalyzeStatement*>(result->GetStatement(0));
+  EXPECT_FALSE(analyze_stmt->HasTable());
+}
+
 }  // End test namespace
 }  // End peloton namespace
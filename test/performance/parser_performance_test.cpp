@@ -0,0 +1,162 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// parser_performance_test.cpp
+//
+// Identification: test/performance/parser_performance_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "common/harness.h"
+#include "common/timer.h"
+#include "parser/parser.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Parser Performance Tests
+//===--------------------------------------------------------------------===//
+
+class ParserPerformanceTests : public PelotonTest {};
+
+namespace {
+
+// The statements of the five TPC-C transactions
+const std::vector<std::string> tpcc_transaction_queries = {
+    // New Order
+    "SELECT w_tax FROM warehouse WHERE w_id = $1;",
+    "SELECT d_tax, d_next_o_id FROM district WHERE d_id = $1 AND d_w_id = $2;",
+    "UPDATE district SET d_next_o_id = $1 WHERE d_id = $2 AND d_w_id = $3;",
+    "SELECT c_discount, c_last, c_credit FROM customer "
+    "WHERE c_w_id = $1 AND c_d_id = $2 AND c_id = $3;",
+    "INSERT INTO orders (o_id, o_d_id, o_w_id, o_c_id, o_entry_d, "
+    "o_ol_cnt, o_all_local) VALUES ($1, $2, $3, $4, $5, $6, $7);",
+    "INSERT INTO new_order (no_o_id, no_d_id, no_w_id) VALUES ($1, $2, $3);",
+    "SELECT i_price, i_name, i_data FROM item WHERE i_id = $1;",
+    "SELECT s_quantity, s_data, s_ytd, s_order_cnt, s_remote_cnt, "
+    "s_dist_01 FROM stock WHERE s_i_id = $1 AND s_w_id = $2;",
+    "UPDATE stock SET s_quantity = $1, s_ytd = $2, s_order_cnt = $3, "
+    "s_remote_cnt = $4 WHERE s_i_id = $5 AND s_w_id = $6;",
+    "INSERT INTO order_line (ol_o_id, ol_d_id, ol_w_id, ol_number, ol_i_id, "
+    "ol_supply_w_id, ol_delivery_d, ol_quantity, ol_amount, ol_dist_info) "
+    "VALUES ($1, $2, $3, $4, $5, $6, $7, $8, $9, $10);",
+    // Payment
+    "UPDATE warehouse SET w_ytd = w_ytd + $1 WHERE w_id = $2;",
+    "SELECT w_name, w_street_1, w_street_2, w_city, w_state, w_zip "
+    "FROM warehouse WHERE w_id = $1;",
+    "UPDATE district SET d_ytd = d_ytd + $1 WHERE d_w_id = $2 AND d_id = $3;",
+    "SELECT c_id FROM customer WHERE c_w_id = $1 AND c_d_id = $2 "
+    "AND c_last = $3 ORDER BY c_first;",
+    "UPDATE customer SET c_balance = $1, c_ytd_payment = $2, "
+    "c_payment_cnt = $3 WHERE c_w_id = $4 AND c_d_id = $5 AND c_id = $6;",
+    "INSERT INTO history VALUES ($1, $2, $3, $4, $5, $6, $7, $8);",
+    // Order Status
+    "SELECT c_balance, c_first, c_middle, c_last FROM customer "
+    "WHERE c_w_id = $1 AND c_d_id = $2 AND c_id = $3;",
+    "SELECT o_id, o_carrier_id, o_entry_d FROM orders WHERE o_w_id = $1 "
+    "AND o_d_id = $2 AND o_c_id = $3 ORDER BY o_id DESC LIMIT 1;",
+    "SELECT ol_supply_w_id, ol_i_id, ol_quantity, ol_amount, ol_delivery_d "
+    "FROM order_line WHERE ol_w_id = $1 AND ol_d_id = $2 AND ol_o_id = $3;",
+    // Delivery
+    "SELECT no_o_id FROM new_order WHERE no_d_id = $1 AND no_w_id = $2 "
+    "AND no_o_id > -1 LIMIT 1;",
+    "DELETE FROM new_order WHERE no_d_id = $1 AND no_w_id = $2 "
+    "AND no_o_id = $3;",
+    "SELECT o_c_id FROM orders WHERE o_id = $1 AND o_d_id = $2 "
+    "AND o_w_id = $3;",
+    "UPDATE orders SET o_carrier_id = $1 WHERE o_id = $2 AND o_d_id = $3 "
+    "AND o_w_id = $4;",
+    "UPDATE order_line SET ol_delivery_d = $1 WHERE ol_o_id = $2 "
+    "AND ol_d_id = $3 AND ol_w_id = $4;",
+    "SELECT SUM(ol_amount) FROM order_line WHERE ol_o_id = $1 "
+    "AND ol_d_id = $2 AND ol_w_id = $3;",
+    "UPDATE customer SET c_balance = c_balance + $1 WHERE c_id = $2 "
+    "AND c_d_id = $3 AND c_w_id = $4;",
+    // Stock Level
+    "SELECT d_next_o_id FROM district WHERE d_w_id = $1 AND d_id = $2;",
+    "SELECT COUNT(DISTINCT s_i_id) FROM order_line, stock "
+    "WHERE ol_w_id = $1 AND ol_d_id = $2 AND ol_o_id < $3 "
+    "AND ol_o_id >= $4 AND s_w_id = $5 AND s_i_id = ol_i_id "
+    "AND s_quantity < $6;"};
+
+// The statements of the TPC-C schema script, comment lines are dropped
+std::vector<std::string> ReadTPCCSchema() {
+  std::string source_file = __FILE__;
+  auto test_dir_pos = source_file.rfind("test/performance/");
+  std::vector<std::string> statements;
+  if (test_dir_pos == std::string::npos) {
+    return statements;
+  }
+  std::ifstream schema_file(source_file.substr(0, test_dir_pos) +
+                            "src/include/benchmark/tpcc/tpcc.sql");
+
+  std::string line, statement;
+  while (std::getline(schema_file, line)) {
+    if (line.compare(0, 2, "--") == 0) {
+      continue;
+    }
+    statement += line + "\n";
+    if (line.find(';') != std::string::npos) {
+      statements.push_back(statement);
+      statement.clear();
+    }
+  }
+  return statements;
+}
+
+void ParseStatements(const std::vector<std::string> *statements,
+                     size_t round_count, UNUSED_ATTRIBUTE uint64_t thread_itr) {
+  for (size_t round_itr = 0; round_itr < round_count; round_itr++) {
+    for (auto &statement : *statements) {
+      std::unique_ptr<parser::SQLStatementList> stmt_list(
+          parser::Parser::ParseSQLString(statement));
+      PL_ASSERT(stmt_list != nullptr);
+    }
+  }
+}
+
+}  // namespace
+
+TEST_F(ParserPerformanceTests, TPCCStatementTest) {
+  // Every statement of the transactions has to parse
+  for (auto &query : tpcc_transaction_queries) {
+    std::unique_ptr<parser::SQLStatementList> stmt_list(
+        parser::Parser::ParseSQLString(query));
+    EXPECT_TRUE(stmt_list->is_valid) << query;
+  }
+
+  // The schema script uses constructs the grammar does not know, those
+  // statements are still timed on their way to the parse error
+  auto statements = tpcc_transaction_queries;
+  auto schema_statements = ReadTPCCSchema();
+  statements.insert(statements.end(), schema_statements.begin(),
+                    schema_statements.end());
+  LOG_INFO("Statements: %lu (%lu from the schema script)", statements.size(),
+           schema_statements.size());
+
+  const size_t round_count = 2000;
+  for (uint64_t thread_count : {1, 4}) {
+    Timer<> timer;
+    timer.Start();
+    LaunchParallelTest(thread_count, ParseStatements, &statements,
+                       round_count);
+    timer.Stop();
+
+    double parse_count = round_count * statements.size() * thread_count;
+    LOG_INFO("%lu threads: %.0lf statements/s", thread_count,
+             parse_count / timer.GetDuration());
+  }
+}
+
+}  // namespace test
+}  // namespace peloton
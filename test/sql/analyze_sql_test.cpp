@@ -0,0 +1,77 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// analyze_sql_test.cpp
+//
+// Identification: test/sql/analyze_sql_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+
+#include "sql/testing_sql_util.h"
+#include "catalog/catalog.h"
+#include "common/harness.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "optimizer/stats_storage.h"
+#include "storage/data_table.h"
+
+namespace peloton {
+namespace test {
+
+class AnalyzeSQLTests : public PelotonTest {};
+
+TEST_F(AnalyzeSQLTests, AnalyzeTableTest) {
+  catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, nullptr);
+
+  TestingSQLUtil::ExecuteSQLQuery("CREATE TABLE test(a INT PRIMARY KEY, b INT);");
+  for (int row_itr = 0; row_itr < 20; row_itr++) {
+    TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (" +
+                                    std::to_string(row_itr) + ", " +
+                                    std::to_string(row_itr % 4) + ");");
+  }
+  auto table = catalog::Catalog::GetInstance()->GetTableWithName(
+      DEFAULT_DB_NAME, "test");
+  auto &stats_storage = optimizer::StatsStorage::GetInstance();
+  EXPECT_TRUE(stats_storage.IsStale(table));
+
+  EXPECT_EQ(TestingSQLUtil::ExecuteSQLQuery("ANALYZE test;"),
+            ResultType::SUCCESS);
+
+  auto table_stats = stats_storage.GetTableStats(table->GetOid());
+  ASSERT_NE(nullptr, table_stats);
+  EXPECT_EQ(20, table_stats->num_rows);
+  ASSERT_EQ(2, table_stats->column_stats.size());
+  EXPECT_EQ(20, table_stats->GetColumnStats(0)->num_distinct);
+  EXPECT_EQ(4, table_stats->GetColumnStats(1)->num_distinct);
+  EXPECT_FALSE(stats_storage.IsStale(table));
+
+  // A row per column is stored in the catalog
+  auto column_stats_table = catalog::Catalog::GetInstance()->GetTableWithName(
+      CATALOG_DATABASE_NAME, COLUMN_STATS_NAME);
+  EXPECT_LE(2, column_stats_table->GetTupleCount());
+
+  // Enough modifications make the statistics stale, a bare ANALYZE refreshes
+  // all stale tables
+  for (int row_itr = 20; row_itr < 80; row_itr++) {
+    TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (" +
+                                    std::to_string(row_itr) + ", 0);");
+  }
+  EXPECT_TRUE(stats_storage.IsStale(table));
+  EXPECT_EQ(TestingSQLUtil::ExecuteSQLQuery("ANALYZE;"), ResultType::SUCCESS);
+  EXPECT_FALSE(stats_storage.IsStale(table));
+  table_stats = stats_storage.GetTableStats(table->GetOid());
+  EXPECT_EQ(80, table_stats->num_rows);
+
+  // free the database just created
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,77 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// explain_sql_test.cpp
+//
+// Identification: test/sql/explain_sql_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+
+#include "sql/testing_sql_util.h"
+#include "catalog/catalog.h"
+#include "common/harness.h"
+#include "concurrency/transaction_manager_factory.h"
+
+namespace peloton {
+namespace test {
+
+class ExplainSQLTests : public PelotonTest {};
+
+void CreateAndLoadExplainTable() {
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE test(a INT PRIMARY KEY, b INT, c INT);");
+
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (1, 22, 333);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (2, 22, 333);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (3, 11, 222);");
+}
+
+TEST_F(ExplainSQLTests, ExplainAnalyzeTest) {
+  catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, nullptr);
+
+  CreateAndLoadExplainTable();
+
+  std::vector<StatementResult> result;
+  std::vector<FieldInfo> tuple_descriptor;
+  std::string error_message;
+  int rows_changed;
+
+  // The profiled tree replaces the result of the query
+  auto status = TestingSQLUtil::ExecuteSQLQuery(
+      "EXPLAIN ANALYZE SELECT * FROM test;", result, tuple_descriptor,
+      rows_changed, error_message);
+  EXPECT_EQ(ResultType::SUCCESS, status);
+  EXPECT_EQ(1, tuple_descriptor.size());
+  EXPECT_EQ("QUERY PLAN", std::get<0>(tuple_descriptor[0]));
+  EXPECT_LE(1, result.size());
+
+  std::string root = TestingSQLUtil::GetResultValueAsString(result, 0);
+  EXPECT_EQ(0, root.find("-> SEQSCAN"));
+  EXPECT_NE(std::string::npos, root.find("rows_out=3"));
+
+  // Plain EXPLAIN does not run the statement
+  status = TestingSQLUtil::ExecuteSQLQuery(
+      "explain INSERT INTO test VALUES (4, 44, 444);", result,
+      tuple_descriptor, rows_changed, error_message);
+  EXPECT_EQ(ResultType::SUCCESS, status);
+  EXPECT_EQ("-> INSERT", TestingSQLUtil::GetResultValueAsString(result, 0));
+
+  TestingSQLUtil::ExecuteSQLQuery("SELECT * FROM test;", result,
+                                  tuple_descriptor, rows_changed,
+                                  error_message);
+  EXPECT_EQ(3, result.size() / tuple_descriptor.size());
+
+  // free the database just created
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -16,7 +16,11 @@
 #include "catalog/catalog.h"
 #include "common/harness.h"
 #include "executor/create_executor.h"
+#include "index/index.h"
+#include "optimizer/simple_optimizer.h"
 #include "planner/create_plan.h"
+#include "planner/index_scan_plan.h"
+#include "storage/data_table.h"
 
 
 namespace peloton {
@@ -155,5 +159,130 @@ TEST_F(IndexScanSQLTests, SQLTest) {
   txn_manager.CommitTransaction(txn);
 }
 
+// Returns the index scan of a single-table plan, nullptr if there is none
+const planner::IndexScanPlan *GetIndexScanPlan(
+    const planner::AbstractPlan *plan) {
+  while (plan != nullptr) {
+    if (plan->GetPlanNodeType() == PlanNodeType::INDEXSCAN) {
+      return static_cast<const planner::IndexScanPlan *>(plan);
+    }
+    if (plan->GetChildren().empty()) break;
+    plan = plan->GetChildren()[0].get();
+  }
+  return nullptr;
+}
+
+TEST_F(IndexScanSQLTests, PointLookupTest) {
+  catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, nullptr);
+
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE department_table(dept_id INT PRIMARY KEY, dept_name "
+      "VARCHAR);");
+  TestingSQLUtil::ExecuteSQLQuery(
+      "INSERT INTO department_table(dept_id,dept_name) VALUES (1,'hello_1');");
+  TestingSQLUtil::ExecuteSQLQuery(
+      "INSERT INTO department_table(dept_id,dept_name) VALUES (2,'hello_2');");
+
+  // Only an equality on the whole primary key is a point lookup
+  std::unique_ptr<optimizer::AbstractOptimizer> optimizer(
+      new optimizer::SimpleOptimizer());
+  auto plan = TestingSQLUtil::GeneratePlanWithOptimizer(
+      optimizer, "SELECT dept_name FROM department_table WHERE dept_id = 2;");
+  auto index_scan_plan = GetIndexScanPlan(plan.get());
+  ASSERT_NE(nullptr, index_scan_plan);
+  EXPECT_TRUE(index_scan_plan->IsPointLookup());
+
+  plan = TestingSQLUtil::GeneratePlanWithOptimizer(
+      optimizer,
+      "UPDATE department_table SET dept_name = 'x' WHERE dept_id = 2;");
+  index_scan_plan = GetIndexScanPlan(plan.get());
+  ASSERT_NE(nullptr, index_scan_plan);
+  EXPECT_TRUE(index_scan_plan->IsPointLookup());
+
+  plan = TestingSQLUtil::GeneratePlanWithOptimizer(
+      optimizer, "SELECT dept_name FROM department_table WHERE dept_id > 1;");
+  index_scan_plan = GetIndexScanPlan(plan.get());
+  ASSERT_NE(nullptr, index_scan_plan);
+  EXPECT_FALSE(index_scan_plan->IsPointLookup());
+
+  std::vector<StatementResult> result;
+  TestingSQLUtil::ExecuteSQLQuery(
+      "SELECT dept_name FROM department_table WHERE dept_id = 2;", result);
+  ASSERT_EQ(1, result.size());
+  EXPECT_EQ("hello_2", TestingSQLUtil::GetResultValueAsString(result, 0));
+
+  // The remaining predicate still filters the tuple
+  TestingSQLUtil::ExecuteSQLQuery(
+      "SELECT dept_name FROM department_table WHERE dept_id = 2 and dept_name "
+      "= 'hello_1';",
+      result);
+  EXPECT_EQ(0, result.size());
+
+  TestingSQLUtil::ExecuteSQLQuery(
+      "UPDATE department_table SET dept_name = 'hahaha' WHERE dept_id = 2;");
+  TestingSQLUtil::ExecuteSQLQuery(
+      "SELECT dept_name FROM department_table WHERE dept_id = 2;", result);
+  ASSERT_EQ(1, result.size());
+  EXPECT_EQ("hahaha", TestingSQLUtil::GetResultValueAsString(result, 0));
+
+  TestingSQLUtil::ExecuteSQLQuery(
+      "DELETE FROM department_table WHERE dept_id = 2;");
+  TestingSQLUtil::ExecuteSQLQuery(
+      "SELECT dept_name FROM department_table WHERE dept_id = 2;", result);
+  EXPECT_EQ(0, result.size());
+
+  // Missing keys find nothing
+  TestingSQLUtil::ExecuteSQLQuery(
+      "SELECT dept_name FROM department_table WHERE dept_id = 3;", result);
+  EXPECT_EQ(0, result.size());
+
+  // free the database just created
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+}
+
+TEST_F(IndexScanSQLTests, PointLookupReinsertTest) {
+  catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, nullptr);
+
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE department_table(dept_id INT PRIMARY KEY, dept_name "
+      "VARCHAR);");
+  TestingSQLUtil::ExecuteSQLQuery(
+      "INSERT INTO department_table(dept_id,dept_name) VALUES (1,'hello_1');");
+  TestingSQLUtil::ExecuteSQLQuery(
+      "DELETE FROM department_table WHERE dept_id = 1;");
+  TestingSQLUtil::ExecuteSQLQuery(
+      "INSERT INTO department_table(dept_id,dept_name) VALUES (1,'hello_2');");
+
+  // The GC is off under test, so the index still has the deleted version
+  auto table = catalog::Catalog::GetInstance()->GetTableWithName(
+      DEFAULT_DB_NAME, "department_table");
+  std::vector<ItemPointer *> tuple_location_ptrs;
+  table->GetIndex(0)->ScanAllKeys(tuple_location_ptrs);
+  EXPECT_EQ(2, tuple_location_ptrs.size());
+
+  std::unique_ptr<optimizer::AbstractOptimizer> optimizer(
+      new optimizer::SimpleOptimizer());
+  auto plan = TestingSQLUtil::GeneratePlanWithOptimizer(
+      optimizer, "SELECT dept_name FROM department_table WHERE dept_id = 1;");
+  auto index_scan_plan = GetIndexScanPlan(plan.get());
+  ASSERT_NE(nullptr, index_scan_plan);
+  EXPECT_TRUE(index_scan_plan->IsPointLookup());
+
+  std::vector<StatementResult> result;
+  TestingSQLUtil::ExecuteSQLQuery(
+      "SELECT dept_name FROM department_table WHERE dept_id = 1;", result);
+  ASSERT_EQ(1, result.size());
+  EXPECT_EQ("hello_2", TestingSQLUtil::GetResultValueAsString(result, 0));
+
+  // free the database just created
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+}
+
 }  // namespace test
 }  // namespace peloton
@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// insert_sql_test.cpp
+//
+// Identification: test/sql/insert_sql_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+
+#include "sql/testing_sql_util.h"
+#include "catalog/catalog.h"
+#include "common/harness.h"
+#include "concurrency/transaction_manager_factory.h"
+
+namespace peloton {
+namespace test {
+
+class InsertSQLTests : public PelotonTest {};
+
+TEST_F(InsertSQLTests, MultiRowInsertTest) {
+  catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, nullptr);
+
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE test(a INT PRIMARY KEY, b INT);");
+
+  std::vector<StatementResult> result;
+  std::vector<FieldInfo> tuple_descriptor;
+  std::string error_message;
+  int rows_changed;
+
+  // One batch that spans several tile groups, keys in descending order
+  const int row_count = 2500;
+  std::string query = "INSERT INTO test VALUES ";
+  for (int key = row_count - 1; key >= 0; key--) {
+    query += "(" + std::to_string(key) + ", " + std::to_string(key * 10) + ")";
+    query += (key > 0) ? ", " : ";";
+  }
+  TestingSQLUtil::ExecuteSQLQuery(query, result, tuple_descriptor,
+                                  rows_changed, error_message);
+  EXPECT_EQ(row_count, rows_changed);
+
+  TestingSQLUtil::ExecuteSQLQuery("SELECT COUNT(*) FROM test;", result);
+  EXPECT_EQ(std::to_string(row_count),
+            TestingSQLUtil::GetResultValueAsString(result, 0));
+  for (int key : {0, 999, 1000, row_count - 1}) {
+    TestingSQLUtil::ExecuteSQLQuery(
+        "SELECT b FROM test WHERE a = " + std::to_string(key) + ";", result);
+    EXPECT_EQ(std::to_string(key * 10),
+              TestingSQLUtil::GetResultValueAsString(result, 0));
+  }
+
+  // A duplicate inside the batch aborts all of it
+  TestingSQLUtil::ExecuteSQLQuery(
+      "INSERT INTO test VALUES (5000, 1), (5001, 2), (5000, 3);");
+  TestingSQLUtil::ExecuteSQLQuery("SELECT b FROM test WHERE a = 5001;",
+                                  result);
+  EXPECT_EQ(0, result.size());
+
+  // So does a key that is already in the table
+  TestingSQLUtil::ExecuteSQLQuery(
+      "INSERT INTO test VALUES (6000, 1), (1, 2);");
+  TestingSQLUtil::ExecuteSQLQuery("SELECT b FROM test WHERE a = 6000;",
+                                  result);
+  EXPECT_EQ(0, result.size());
+  TestingSQLUtil::ExecuteSQLQuery("SELECT b FROM test WHERE a = 1;", result);
+  EXPECT_EQ("10", TestingSQLUtil::GetResultValueAsString(result, 0));
+
+  // free the database just created
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,194 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// join_sql_test.cpp
+//
+// Identification: test/sql/join_sql_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <memory>
+
+#include "sql/testing_sql_util.h"
+#include "catalog/catalog.h"
+#include "common/harness.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "optimizer/simple_optimizer.h"
+#include "planner/abstract_plan.h"
+
+namespace peloton {
+namespace test {
+
+class JoinSQLTests : public PelotonTest {};
+
+// Ten customers with four orders each, every order has two items
+void CreateAndLoadJoinTables() {
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE customer(c_id INT PRIMARY KEY, c_name VARCHAR);");
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE orders(o_id INT PRIMARY KEY, o_c_id INT, o_total INT);");
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE item(i_id INT PRIMARY KEY, i_o_id INT, i_price INT);");
+
+  for (int c_id = 0; c_id < 10; c_id++) {
+    TestingSQLUtil::ExecuteSQLQuery("INSERT INTO customer VALUES (" +
+                                    std::to_string(c_id) + ", 'name_" +
+                                    std::to_string(c_id) + "');");
+  }
+  for (int o_id = 0; o_id < 40; o_id++) {
+    TestingSQLUtil::ExecuteSQLQuery(
+        "INSERT INTO orders VALUES (" + std::to_string(o_id) + ", " +
+        std::to_string(o_id % 10) + ", " + std::to_string(o_id * 10) + ");");
+  }
+  for (int i_id = 0; i_id < 80; i_id++) {
+    TestingSQLUtil::ExecuteSQLQuery(
+        "INSERT INTO item VALUES (" + std::to_string(i_id) + ", " +
+        std::to_string(i_id % 40) + ", " + std::to_string(i_id) + ");");
+  }
+}
+
+// Counts the nodes of a type in a plan tree
+size_t CountPlanNodes(const planner::AbstractPlan *plan, PlanNodeType type) {
+  size_t count = plan->GetPlanNodeType() == type ? 1 : 0;
+  for (auto &child : plan->GetChildren()) {
+    count += CountPlanNodes(child.get(), type);
+  }
+  return count;
+}
+
+// Whether the plan has a nested loop join that probes an index
+bool HasIndexNestedLoopJoin(const planner::AbstractPlan *plan) {
+  if (plan->GetPlanNodeType() == PlanNodeType::NESTLOOP &&
+      plan->GetChildren()[1]->GetPlanNodeType() == PlanNodeType::INDEXSCAN) {
+    return true;
+  }
+  for (auto &child : plan->GetChildren()) {
+    if (HasIndexNestedLoopJoin(child.get())) return true;
+  }
+  return false;
+}
+
+TEST_F(JoinSQLTests, MultiWayJoinTest) {
+  catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, nullptr);
+  CreateAndLoadJoinTables();
+
+  std::vector<StatementResult> result;
+  std::vector<FieldInfo> tuple_descriptor;
+  std::string error_message;
+  int rows_affected;
+
+  // Two tables, the filter on the customer is pushed into its scan
+  TestingSQLUtil::ExecuteSQLQuery(
+      "SELECT c_name, o_id FROM customer, orders WHERE c_id = o_c_id AND "
+      "c_id = 3;",
+      result, tuple_descriptor, rows_affected, error_message);
+  ASSERT_EQ(8, result.size());
+  EXPECT_EQ(2, tuple_descriptor.size());
+  std::vector<std::string> order_ids;
+  for (size_t row = 0; row < 4; row++) {
+    EXPECT_EQ("name_3",
+              TestingSQLUtil::GetResultValueAsString(result, row * 2));
+    order_ids.push_back(
+        TestingSQLUtil::GetResultValueAsString(result, row * 2 + 1));
+  }
+  std::sort(order_ids.begin(), order_ids.end());
+  EXPECT_EQ(std::vector<std::string>({"13", "23", "3", "33"}), order_ids);
+
+  // Chained joins with aliases
+  TestingSQLUtil::ExecuteSQLQuery(
+      "SELECT c.c_id, i.i_id FROM customer c JOIN orders o ON c.c_id = "
+      "o.o_c_id JOIN item i ON o.o_id = i.i_o_id WHERE i.i_price < 20;",
+      result, tuple_descriptor, rows_affected, error_message);
+  ASSERT_EQ(40, result.size());
+  for (size_t row = 0; row < 20; row++) {
+    auto c_id =
+        std::stoi(TestingSQLUtil::GetResultValueAsString(result, row * 2));
+    auto i_id =
+        std::stoi(TestingSQLUtil::GetResultValueAsString(result, row * 2 + 1));
+    EXPECT_EQ(i_id % 10, c_id);
+  }
+
+  // All columns of all tables, in the order of the FROM clause
+  TestingSQLUtil::ExecuteSQLQuery(
+      "SELECT * FROM customer, orders, item WHERE c_id = o_c_id AND o_id = "
+      "i_o_id AND i_id = 45;",
+      result, tuple_descriptor, rows_affected, error_message);
+  EXPECT_EQ(8, tuple_descriptor.size());
+  ASSERT_EQ(8, result.size());
+  EXPECT_EQ("5", TestingSQLUtil::GetResultValueAsString(result, 0));
+  EXPECT_EQ("name_5", TestingSQLUtil::GetResultValueAsString(result, 1));
+  EXPECT_EQ("5", TestingSQLUtil::GetResultValueAsString(result, 2));
+  EXPECT_EQ("50", TestingSQLUtil::GetResultValueAsString(result, 4));
+  EXPECT_EQ("45", TestingSQLUtil::GetResultValueAsString(result, 5));
+
+  // Expressions over the columns of several tables
+  TestingSQLUtil::ExecuteSQLQuery(
+      "SELECT o_total + i_price FROM orders, item WHERE o_id = i_o_id AND "
+      "i_id = 41;",
+      result, tuple_descriptor, rows_affected, error_message);
+  ASSERT_EQ(1, result.size());
+  EXPECT_EQ("51", TestingSQLUtil::GetResultValueAsString(result, 0));
+
+  // free the database just created
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+}
+
+TEST_F(JoinSQLTests, JoinOrderTest) {
+  catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, nullptr);
+  CreateAndLoadJoinTables();
+  EXPECT_EQ(TestingSQLUtil::ExecuteSQLQuery("ANALYZE;"), ResultType::SUCCESS);
+
+  // A single item is found first and the other tables are probed through
+  // their primary keys, whatever the order of the FROM clause
+  std::unique_ptr<optimizer::AbstractOptimizer> optimizer(
+      new optimizer::SimpleOptimizer());
+  auto plan = TestingSQLUtil::GeneratePlanWithOptimizer(
+      optimizer,
+      "SELECT c_name, i_price FROM customer, orders, item WHERE c_id = o_c_id "
+      "AND o_id = i_o_id AND i_id = 7;");
+  ASSERT_NE(nullptr, plan);
+  EXPECT_EQ(PlanNodeType::PROJECTION, plan->GetPlanNodeType());
+  EXPECT_TRUE(HasIndexNestedLoopJoin(plan.get()));
+  EXPECT_EQ(0, CountPlanNodes(plan.get(), PlanNodeType::SEQSCAN));
+
+  std::vector<StatementResult> result;
+  TestingSQLUtil::ExecuteSQLQuery(
+      "SELECT c_name, i_price FROM customer, orders, item WHERE c_id = o_c_id "
+      "AND o_id = i_o_id AND i_id = 7;",
+      result);
+  ASSERT_EQ(2, result.size());
+  EXPECT_EQ("name_7", TestingSQLUtil::GetResultValueAsString(result, 0));
+  EXPECT_EQ("7", TestingSQLUtil::GetResultValueAsString(result, 1));
+
+  // Without a selective filter every table is still joined exactly once
+  plan = TestingSQLUtil::GeneratePlanWithOptimizer(
+      optimizer,
+      "SELECT c_name, i_price FROM item JOIN orders ON i_o_id = o_id JOIN "
+      "customer ON o_c_id = c_id;");
+  ASSERT_NE(nullptr, plan);
+  EXPECT_EQ(2, CountPlanNodes(plan.get(), PlanNodeType::HASHJOIN) +
+                   CountPlanNodes(plan.get(), PlanNodeType::MERGEJOIN) +
+                   CountPlanNodes(plan.get(), PlanNodeType::NESTLOOP));
+
+  TestingSQLUtil::ExecuteSQLQuery(
+      "SELECT c_name, i_price FROM item JOIN orders ON i_o_id = o_id JOIN "
+      "customer ON o_c_id = c_id;",
+      result);
+  EXPECT_EQ(160, result.size());
+
+  // free the database just created
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,116 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// plan_cache_sql_test.cpp
+//
+// Identification: test/sql/plan_cache_sql_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+
+#include "sql/testing_sql_util.h"
+#include "catalog/catalog.h"
+#include "common/harness.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "tcop/plan_cache.h"
+
+namespace peloton {
+namespace test {
+
+class PlanCacheSQLTests : public PelotonTest {};
+
+TEST_F(PlanCacheSQLTests, ParameterizeTest) {
+  std::string fingerprint;
+  std::vector<type::Value> params;
+
+  EXPECT_TRUE(tcop::PlanCache::Parameterize(
+      "SELECT a, 5 FROM test WHERE b = 'x' AND c>=2.5 LIMIT 10;", fingerprint,
+      params));
+  EXPECT_EQ("SELECT a , 5 FROM test WHERE b = $1 AND c >= $2 LIMIT 10 ;",
+            fingerprint);
+  ASSERT_EQ(2, params.size());
+  EXPECT_EQ("x", params[0].ToString());
+  EXPECT_EQ(type::Type::DECIMAL, params[1].GetTypeId());
+
+  EXPECT_TRUE(tcop::PlanCache::Parameterize(
+      "UPDATE test SET b = 7 WHERE a = 1", fingerprint, params));
+  EXPECT_EQ("UPDATE test SET b = $1 WHERE a = $2", fingerprint);
+  ASSERT_EQ(2, params.size());
+  EXPECT_EQ(7, params[0].GetAs<int32_t>());
+  EXPECT_EQ(1, params[1].GetAs<int32_t>());
+
+  EXPECT_TRUE(tcop::PlanCache::Parameterize(
+      "INSERT INTO test VALUES (1, 'it', 3);", fingerprint, params));
+  EXPECT_EQ("INSERT INTO test VALUES ( $1 , $2 , $3 ) ;", fingerprint);
+  EXPECT_EQ(3, params.size());
+
+  // Shapes the cache does not handle
+  EXPECT_FALSE(tcop::PlanCache::Parameterize(
+      "INSERT INTO test VALUES (1, 2, 3), (4, 5, 6);", fingerprint, params));
+  EXPECT_FALSE(tcop::PlanCache::Parameterize(
+      "SELECT * FROM test WHERE a = $1;", fingerprint, params));
+  EXPECT_FALSE(tcop::PlanCache::Parameterize(
+      "SELECT * FROM test WHERE b = 'x", fingerprint, params));
+  EXPECT_FALSE(tcop::PlanCache::Parameterize("CREATE TABLE t(a INT);",
+                                             fingerprint, params));
+}
+
+TEST_F(PlanCacheSQLTests, CachedQueryTest) {
+  catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, nullptr);
+  auto &plan_cache = tcop::PlanCache::GetInstance();
+
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE test(a INT PRIMARY KEY, b INT, c INT);");
+  EXPECT_EQ(0, plan_cache.GetSize());
+
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (1, 22, 333);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (2, 22, 333);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (3, 11, 222);");
+  EXPECT_EQ(1, plan_cache.GetSize());
+
+  std::vector<StatementResult> result;
+  std::vector<FieldInfo> tuple_descriptor;
+  std::string error_message;
+  int rows_changed;
+
+  // Both lookups share one plan but see their own literal
+  TestingSQLUtil::ExecuteSQLQuery("SELECT c FROM test WHERE a = 1;", result,
+                                  tuple_descriptor, rows_changed,
+                                  error_message);
+  EXPECT_EQ(1, result.size());
+  EXPECT_EQ("333", TestingSQLUtil::GetResultValueAsString(result, 0));
+
+  TestingSQLUtil::ExecuteSQLQuery("SELECT c FROM test WHERE a = 3;", result,
+                                  tuple_descriptor, rows_changed,
+                                  error_message);
+  EXPECT_EQ(1, result.size());
+  EXPECT_EQ("222", TestingSQLUtil::GetResultValueAsString(result, 0));
+  EXPECT_EQ(2, plan_cache.GetSize());
+
+  TestingSQLUtil::ExecuteSQLQuery("UPDATE test SET c = 444 WHERE b = 22;",
+                                  result, tuple_descriptor, rows_changed,
+                                  error_message);
+  EXPECT_EQ(2, rows_changed);
+  TestingSQLUtil::ExecuteSQLQuery("SELECT c FROM test WHERE a = 2;", result,
+                                  tuple_descriptor, rows_changed,
+                                  error_message);
+  EXPECT_EQ("444", TestingSQLUtil::GetResultValueAsString(result, 0));
+  EXPECT_EQ(3, plan_cache.GetSize());
+
+  // Dropping the table drops its plans
+  TestingSQLUtil::ExecuteSQLQuery("DROP TABLE test;");
+  EXPECT_EQ(0, plan_cache.GetSize());
+
+  // free the database just created
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,114 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// prepared_statement_sql_test.cpp
+//
+// Identification: test/sql/prepared_statement_sql_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+
+#include "sql/testing_sql_util.h"
+#include "catalog/catalog.h"
+#include "common/harness.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/plan_executor.h"
+#include "planner/abstract_plan.h"
+#include "tcop/tcop.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+class PreparedStatementSQLTests : public PelotonTest {};
+
+// Binds the params and runs the statement like the extended protocol does
+ResultType ExecutePrepared(tcop::TrafficCop &traffic_cop,
+                           const std::shared_ptr<Statement> &statement,
+                           std::vector<type::Value> params,
+                           std::vector<StatementResult> &result,
+                           int &rows_changed) {
+  std::string error_message;
+  std::vector<int> result_format(statement->GetTupleDescriptor().size(), 0);
+  if (params.size() > 0) {
+    statement->GetPlanTree()->SetParameterValues(&params);
+  }
+  return traffic_cop.ExecuteStatement(statement, params, false, nullptr,
+                                      result_format, result, rows_changed,
+                                      error_message);
+}
+
+TEST_F(PreparedStatementSQLTests, ReusedExecutorTreeTest) {
+  catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, nullptr);
+
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE test(a INT PRIMARY KEY, b INT, c INT);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (1, 22, 333);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (2, 11, 333);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (3, 33, 222);");
+
+  tcop::TrafficCop traffic_cop;
+  std::string error_message;
+  std::vector<StatementResult> result;
+  int rows_changed;
+
+  // Point lookups, every execution sees its own parameter
+  auto select_statement = traffic_cop.PrepareStatement(
+      "select", "SELECT b FROM test WHERE a = $1", error_message);
+  ASSERT_NE(nullptr, select_statement.get());
+  for (int a = 1; a <= 3; a++) {
+    EXPECT_EQ(ResultType::SUCCESS,
+              ExecutePrepared(traffic_cop, select_statement,
+                              {type::ValueFactory::GetIntegerValue(a)}, result,
+                              rows_changed));
+    EXPECT_EQ(1, result.size());
+    EXPECT_EQ(std::to_string(a * 11),
+              TestingSQLUtil::GetResultValueAsString(result, 0));
+  }
+  EXPECT_EQ(1, select_statement->GetExecutorTreeCache()->GetSize());
+
+  // Sorts restart from scratch
+  auto order_statement = traffic_cop.PrepareStatement(
+      "order", "SELECT a FROM test ORDER BY b DESC LIMIT 2", error_message);
+  ASSERT_NE(nullptr, order_statement.get());
+  for (int i = 0; i < 2; i++) {
+    EXPECT_EQ(ResultType::SUCCESS,
+              ExecutePrepared(traffic_cop, order_statement, {}, result,
+                              rows_changed));
+    EXPECT_EQ(2, result.size());
+    EXPECT_EQ("3", TestingSQLUtil::GetResultValueAsString(result, 0));
+    EXPECT_EQ("1", TestingSQLUtil::GetResultValueAsString(result, 1));
+  }
+
+  // Writes count their own rows
+  auto update_statement = traffic_cop.PrepareStatement(
+      "update", "UPDATE test SET c = $1 WHERE c = 333", error_message);
+  ASSERT_NE(nullptr, update_statement.get());
+  EXPECT_EQ(ResultType::SUCCESS,
+            ExecutePrepared(traffic_cop, update_statement,
+                            {type::ValueFactory::GetIntegerValue(444)}, result,
+                            rows_changed));
+  EXPECT_EQ(2, rows_changed);
+  EXPECT_EQ(ResultType::SUCCESS,
+            ExecutePrepared(traffic_cop, update_statement,
+                            {type::ValueFactory::GetIntegerValue(555)}, result,
+                            rows_changed));
+  EXPECT_EQ(0, rows_changed);
+
+  // A new plan drops the trees of the old one
+  select_statement->SetPlanTree(order_statement->GetPlanTree());
+  EXPECT_EQ(0, select_statement->GetExecutorTreeCache()->GetSize());
+
+  // free the database just created
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,86 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// latency_histogram_test.cpp
+//
+// Identification: test/statistics/latency_histogram_test.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "statistics/latency_histogram.h"
+
+#include "common/harness.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// LatencyHistogram Test
+//===--------------------------------------------------------------------===//
+
+class LatencyHistogramTests : public PelotonTest {};
+
+// Every value must fall into a bucket whose bounds contain it
+TEST_F(LatencyHistogramTests, BucketBoundsTest) {
+  for (uint64_t value = 0; value < (1UL << 20); value += 7) {
+    auto index = stats::LatencyHistogram::GetBucketIndex(value);
+    EXPECT_LT(index, stats::LatencyHistogram::BUCKET_COUNT);
+    EXPECT_LE(stats::LatencyHistogram::GetBucketLowerBound(index), value);
+    EXPECT_GE(stats::LatencyHistogram::GetBucketUpperBound(index), value);
+  }
+
+  // Huge values are clamped into the last bucket
+  EXPECT_EQ(stats::LatencyHistogram::BUCKET_COUNT - 1,
+            stats::LatencyHistogram::GetBucketIndex(UINT64_MAX));
+}
+
+TEST_F(LatencyHistogramTests, PercentileTest) {
+  stats::LatencyHistogram histogram;
+  for (uint64_t value = 1; value <= 10000; value++) {
+    histogram.Record(value);
+  }
+
+  EXPECT_EQ(10000, histogram.GetCount());
+  EXPECT_EQ(10000, histogram.GetMax());
+  EXPECT_EQ(1, histogram.GetMin());
+
+  // Percentiles are within the relative error of the bucketing
+  double error = 1.0 / stats::LatencyHistogram::SUB_BUCKET_COUNT;
+  EXPECT_NEAR(5000, histogram.GetPercentile(50), 5000 * error);
+  EXPECT_NEAR(9900, histogram.GetPercentile(99), 9900 * error);
+  EXPECT_NEAR(9990, histogram.GetPercentile(99.9), 9990 * error);
+  EXPECT_LE(histogram.GetPercentile(100), 10000);
+}
+
+TEST_F(LatencyHistogramTests, MergeAndWindowTest) {
+  stats::LatencyHistogram first, second;
+  for (uint64_t value = 0; value < 100; value++) {
+    first.Record(10);
+    second.Record(1000);
+  }
+
+  stats::LatencyHistogram merged;
+  merged.Merge(first);
+  merged.Merge(second);
+  EXPECT_EQ(200, merged.GetCount());
+  EXPECT_EQ(1000, merged.GetMax());
+  EXPECT_EQ(10, merged.GetPercentile(50));
+
+  // The window between the two snapshots only contains the second batch
+  stats::LatencyHistogram window(merged);
+  window.Subtract(first);
+  EXPECT_EQ(100, window.GetCount());
+  EXPECT_EQ(stats::LatencyHistogram::GetBucketLowerBound(
+                stats::LatencyHistogram::GetBucketIndex(1000)),
+            window.GetMin());
+
+  merged.Reset();
+  EXPECT_EQ(0, merged.GetCount());
+  EXPECT_EQ(0, merged.GetPercentile(99));
+}
+
+}  // End test namespace
+}  // End peloton namespace
@@ -0,0 +1,341 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// compressed_column_test.cpp
+//
+// Identification: test/storage/compressed_column_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+
+#include "brain/tile_group_freezer.h"
+#include "catalog/manager.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/executor_context.h"
+#include "executor/logical_tile.h"
+#include "executor/seq_scan_executor.h"
+#include "executor/testing_executor_util.h"
+#include "executor/update_executor.h"
+#include "expression/expression_util.h"
+#include "planner/seq_scan_plan.h"
+#include "planner/update_plan.h"
+#include "storage/compressed_column.h"
+#include "storage/data_table.h"
+#include "storage/tile.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Compressed Column Tests
+//===--------------------------------------------------------------------===//
+
+class CompressedColumnTests : public PelotonTest {};
+
+const int compressed_tuple_count = 64;
+
+// Two full tile groups, the first column is constant in each of them
+storage::DataTable *CreateColdTable() {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  auto table = TestingExecutorUtil::CreateTable(compressed_tuple_count, false);
+  TestingExecutorUtil::PopulateTable(table, compressed_tuple_count * 2, false,
+                                     false, true, txn);
+  txn_manager.CommitTransaction(txn);
+  return table;
+}
+
+expression::AbstractExpression *CreateComparison(ExpressionType comparison,
+                                                 type::Type::TypeId type,
+                                                 oid_t column_id,
+                                                 const type::Value &constant) {
+  return expression::ExpressionUtil::ComparisonFactory(
+      comparison,
+      expression::ExpressionUtil::TupleValueFactory(type, 0, column_id),
+      expression::ExpressionUtil::ConstantValueFactory(constant));
+}
+
+// Returns the number of tuples the seq scan finds, the plan takes the
+// predicate
+int ScanCount(storage::DataTable *table,
+              expression::AbstractExpression *predicate) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  std::vector<oid_t> column_ids = {0, 1, 3};
+  planner::SeqScanPlan seq_scan_node(table, predicate, column_ids);
+  executor::SeqScanExecutor seq_scan_executor(&seq_scan_node, context.get());
+
+  EXPECT_TRUE(seq_scan_executor.Init());
+  int tuple_count = 0;
+  while (seq_scan_executor.Execute()) {
+    std::unique_ptr<executor::LogicalTile> result_tile(
+        seq_scan_executor.GetOutput());
+    tuple_count += result_tile->GetTupleCount();
+  }
+
+  txn_manager.CommitTransaction(txn);
+  return tuple_count;
+}
+
+TEST_F(CompressedColumnTests, EncodingTest) {
+  std::unique_ptr<storage::DataTable> table(CreateColdTable());
+  auto tile_group = table->GetTileGroup(0);
+  auto tile = tile_group->GetTile(0);
+
+  std::vector<storage::ColumnEncodingType> encodings = {
+      storage::ColumnEncodingType::RUN_LENGTH,
+      storage::ColumnEncodingType::FRAME_OF_REFERENCE,
+      storage::ColumnEncodingType::DICTIONARY,
+      storage::ColumnEncodingType::DICTIONARY};
+
+  for (oid_t column_id = 0; column_id < encodings.size(); column_id++) {
+    storage::CompressedColumn column(tile, column_id, compressed_tuple_count);
+    EXPECT_EQ(encodings[column_id], column.GetEncodingType());
+
+    for (oid_t tuple_id = 0; tuple_id < compressed_tuple_count; tuple_id++) {
+      auto expected = tile->GetValue(tuple_id, column_id);
+      auto actual = column.GetValue(tuple_id);
+      EXPECT_EQ(type::CMP_TRUE, expected.CompareEquals(actual));
+    }
+  }
+
+  // The integer columns take a few bits per value
+  for (oid_t column_id = 0; column_id < 2; column_id++) {
+    storage::CompressedColumn column(tile, column_id, compressed_tuple_count);
+    EXPECT_LT(column.GetSize(), compressed_tuple_count * sizeof(int32_t) / 2);
+  }
+}
+
+TEST_F(CompressedColumnTests, FilterTest) {
+  std::unique_ptr<storage::DataTable> table(CreateColdTable());
+  auto tile = table->GetTileGroup(0)->GetTile(0);
+
+  // Frame of reference
+  storage::CompressedColumn int_column(tile, 1, compressed_tuple_count);
+  std::vector<bool> matches(compressed_tuple_count, true);
+  EXPECT_TRUE(int_column.Filter(
+      ExpressionType::COMPARE_LESSTHAN,
+      type::ValueFactory::GetIntegerValue(
+          TestingExecutorUtil::PopulatedValue(10, 1)),
+      matches));
+  for (oid_t tuple_id = 0; tuple_id < compressed_tuple_count; tuple_id++) {
+    EXPECT_EQ(tuple_id < 10, matches[tuple_id]);
+  }
+
+  // Dictionary, on top of the previous matches
+  storage::CompressedColumn varchar_column(tile, 3, compressed_tuple_count);
+  EXPECT_TRUE(varchar_column.Filter(
+      ExpressionType::COMPARE_NOTEQUAL,
+      type::ValueFactory::GetVarcharValue(
+          std::to_string(TestingExecutorUtil::PopulatedValue(3, 3))),
+      matches));
+  for (oid_t tuple_id = 0; tuple_id < compressed_tuple_count; tuple_id++) {
+    EXPECT_EQ(tuple_id < 10 && tuple_id != 3, matches[tuple_id]);
+  }
+
+  // Run length, the single run does not match
+  storage::CompressedColumn run_column(tile, 0, compressed_tuple_count);
+  matches.assign(compressed_tuple_count, true);
+  EXPECT_TRUE(run_column.Filter(ExpressionType::COMPARE_GREATERTHAN,
+                                type::ValueFactory::GetIntegerValue(0),
+                                matches));
+  for (oid_t tuple_id = 0; tuple_id < compressed_tuple_count; tuple_id++) {
+    EXPECT_FALSE(matches[tuple_id]);
+  }
+
+  // Comparisons that can not be evaluated on the codes
+  EXPECT_FALSE(varchar_column.Filter(ExpressionType::COMPARE_LIKE,
+                                     type::ValueFactory::GetVarcharValue("3%"),
+                                     matches));
+  EXPECT_FALSE(int_column.Filter(
+      ExpressionType::COMPARE_EQUAL,
+      type::ValueFactory::GetVarcharValue("11"), matches));
+}
+
+TEST_F(CompressedColumnTests, FreezeTileGroupTest) {
+  std::unique_ptr<storage::DataTable> table(CreateColdTable());
+  auto tile_group = table->GetTileGroup(0);
+  auto tile_group_id = tile_group->GetTileGroupId();
+  auto column_count = table->GetSchema()->GetColumnCount();
+
+  // Transactions that started before the inserts committed may still not
+  // see them
+  EXPECT_EQ(nullptr, table->FreezeTileGroup(0, 0));
+  EXPECT_FALSE(tile_group->GetHeader()->IsFrozen());
+
+  // Only full tile groups are frozen
+  EXPECT_EQ(2, brain::TileGroupFreezer::FreezeTable(table.get(), MAX_CID));
+  EXPECT_EQ(0, brain::TileGroupFreezer::FreezeTable(table.get(), MAX_CID));
+
+  auto frozen_tile_group = table->GetTileGroup(0);
+  EXPECT_NE(tile_group.get(), frozen_tile_group.get());
+  EXPECT_EQ(tile_group_id, frozen_tile_group->GetTileGroupId());
+  EXPECT_EQ(tile_group->GetHeader(), frozen_tile_group->GetHeader());
+  EXPECT_TRUE(frozen_tile_group->GetHeader()->IsFrozen());
+  EXPECT_EQ(frozen_tile_group.get(),
+            frozen_tile_group->GetHeader()->GetTileGroup());
+
+  auto tile = tile_group->GetTile(0);
+  auto frozen_tile = frozen_tile_group->GetTile(0);
+  EXPECT_FALSE(tile->IsCompressed());
+  EXPECT_TRUE(frozen_tile->IsCompressed());
+
+  // The old tile group is still readable and has the same values
+  for (oid_t tuple_id = 0; tuple_id < compressed_tuple_count; tuple_id++) {
+    for (oid_t column_id = 0; column_id < column_count; column_id++) {
+      auto expected = tile_group->GetValue(tuple_id, column_id);
+      auto actual = frozen_tile_group->GetValue(tuple_id, column_id);
+      EXPECT_EQ(type::CMP_TRUE, expected.CompareEquals(actual));
+    }
+  }
+
+  // Frozen tile groups keep their layout
+  EXPECT_EQ(nullptr, table->TransformTileGroup(0, 0.0));
+}
+
+TEST_F(CompressedColumnTests, SeqScanTest) {
+  std::unique_ptr<storage::DataTable> table(CreateColdTable());
+
+  // The frozen tile groups must give the same results as the hot ones
+  for (bool frozen : {false, true}) {
+    if (frozen == true) {
+      EXPECT_EQ(2, brain::TileGroupFreezer::FreezeTable(table.get(), MAX_CID));
+      EXPECT_TRUE(table->GetTileGroup(0)->GetTile(0)->IsCompressed());
+      EXPECT_TRUE(table->GetTileGroup(1)->GetTile(0)->IsCompressed());
+    }
+
+    // WHERE ATTR_1 < 101, the codes decide alone
+    EXPECT_EQ(10, ScanCount(table.get(),
+                            CreateComparison(
+                                ExpressionType::COMPARE_LESSTHAN,
+                                type::Type::INTEGER, 1,
+                                type::ValueFactory::GetIntegerValue(
+                                    TestingExecutorUtil::PopulatedValue(
+                                        10, 1)))));
+
+    // WHERE ATTR_0 = 10 AND 1001 <= ATTR_1, a run length column and a
+    // mirrored comparison
+    auto run_comparison = CreateComparison(
+        ExpressionType::COMPARE_EQUAL, type::Type::INTEGER, 0,
+        type::ValueFactory::GetIntegerValue(
+            TestingExecutorUtil::PopulatedValue(1, 0)));
+    auto mirrored_comparison = expression::ExpressionUtil::ComparisonFactory(
+        ExpressionType::COMPARE_LESSTHANOREQUALTO,
+        expression::ExpressionUtil::ConstantValueFactory(
+            type::ValueFactory::GetIntegerValue(
+                TestingExecutorUtil::PopulatedValue(100, 1))),
+        expression::ExpressionUtil::TupleValueFactory(type::Type::INTEGER, 0,
+                                                      1));
+    EXPECT_EQ(28, ScanCount(table.get(),
+                            expression::ExpressionUtil::ConjunctionFactory(
+                                ExpressionType::CONJUNCTION_AND,
+                                run_comparison, mirrored_comparison)));
+
+    // WHERE ATTR_1 >= 601 AND (ATTR_1 = 611 OR ATTR_3 = '703'), the
+    // disjunction is still evaluated on the tuples the codes leave
+    auto range_comparison = CreateComparison(
+        ExpressionType::COMPARE_GREATERTHANOREQUALTO, type::Type::INTEGER, 1,
+        type::ValueFactory::GetIntegerValue(
+            TestingExecutorUtil::PopulatedValue(60, 1)));
+    auto disjunction = expression::ExpressionUtil::ConjunctionFactory(
+        ExpressionType::CONJUNCTION_OR,
+        CreateComparison(ExpressionType::COMPARE_EQUAL, type::Type::INTEGER,
+                         1, type::ValueFactory::GetIntegerValue(
+                                TestingExecutorUtil::PopulatedValue(61, 1))),
+        CreateComparison(ExpressionType::COMPARE_EQUAL, type::Type::VARCHAR,
+                         3, type::ValueFactory::GetVarcharValue(std::to_string(
+                                TestingExecutorUtil::PopulatedValue(70, 3)))));
+    EXPECT_EQ(2, ScanCount(table.get(),
+                           expression::ExpressionUtil::ConjunctionFactory(
+                               ExpressionType::CONJUNCTION_AND,
+                               range_comparison, disjunction)));
+  }
+}
+
+TEST_F(CompressedColumnTests, UpdateFrozenTupleTest) {
+  std::unique_ptr<storage::DataTable> table(CreateColdTable());
+  EXPECT_EQ(2, brain::TileGroupFreezer::FreezeTable(table.get(), MAX_CID));
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  // UPDATE SET ATTR_2 = 23.5 WHERE ATTR_1 = 51
+  TargetList target_list;
+  DirectMapList direct_map_list;
+  target_list.emplace_back(
+      2, expression::ExpressionUtil::ConstantValueFactory(
+             type::ValueFactory::GetDecimalValue(23.5)));
+  direct_map_list.emplace_back(0, std::pair<oid_t, oid_t>(0, 0));
+  direct_map_list.emplace_back(1, std::pair<oid_t, oid_t>(0, 1));
+  direct_map_list.emplace_back(3, std::pair<oid_t, oid_t>(0, 3));
+  std::unique_ptr<const planner::ProjectInfo> project_info(
+      new planner::ProjectInfo(std::move(target_list),
+                               std::move(direct_map_list)));
+  planner::UpdatePlan update_node(table.get(), std::move(project_info));
+  executor::UpdateExecutor update_executor(&update_node, context.get());
+
+  std::vector<oid_t> column_ids = {0};
+  std::unique_ptr<planner::SeqScanPlan> seq_scan_node(new planner::SeqScanPlan(
+      table.get(),
+      CreateComparison(ExpressionType::COMPARE_EQUAL, type::Type::INTEGER, 1,
+                       type::ValueFactory::GetIntegerValue(
+                           TestingExecutorUtil::PopulatedValue(5, 1))),
+      column_ids));
+  executor::SeqScanExecutor seq_scan_executor(seq_scan_node.get(),
+                                              context.get());
+  update_node.AddChild(std::move(seq_scan_node));
+  update_executor.AddChild(&seq_scan_executor);
+
+  EXPECT_TRUE(update_executor.Init());
+  while (update_executor.Execute())
+    ;
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+
+  // The new version is in a hot tile group, the frozen one is unchanged
+  auto frozen_tile_group = table->GetTileGroup(0);
+  auto frozen_header = frozen_tile_group->GetHeader();
+  EXPECT_TRUE(frozen_header->IsFrozen());
+  EXPECT_TRUE(frozen_tile_group->GetTile(0)->IsCompressed());
+  EXPECT_NE(MAX_CID, frozen_header->GetEndCommitId(5));
+
+  auto new_location = frozen_header->GetPrevItemPointer(5);
+  EXPECT_FALSE(new_location.IsNull());
+  EXPECT_NE(frozen_tile_group->GetTileGroupId(), new_location.block);
+  auto new_tile_group =
+      catalog::Manager::GetInstance().GetTileGroup(new_location.block);
+  EXPECT_FALSE(new_tile_group->GetHeader()->IsFrozen());
+  EXPECT_FALSE(new_tile_group->GetTile(0)->IsCompressed());
+  EXPECT_EQ(type::CMP_TRUE,
+            new_tile_group->GetValue(new_location.offset, 1)
+                .CompareEquals(type::ValueFactory::GetIntegerValue(
+                    TestingExecutorUtil::PopulatedValue(5, 1))));
+
+  // Scans see the new version only
+  EXPECT_EQ(1, ScanCount(table.get(),
+                         CreateComparison(
+                             ExpressionType::COMPARE_EQUAL,
+                             type::Type::DECIMAL, 2,
+                             type::ValueFactory::GetDecimalValue(23.5))));
+  EXPECT_EQ(1, ScanCount(table.get(),
+                         CreateComparison(
+                             ExpressionType::COMPARE_EQUAL,
+                             type::Type::INTEGER, 1,
+                             type::ValueFactory::GetIntegerValue(
+                                 TestingExecutorUtil::PopulatedValue(5, 1)))));
+  EXPECT_EQ(compressed_tuple_count * 2, ScanCount(table.get(), nullptr));
+}
+
+}  // End test namespace
+}  // End peloton namespace
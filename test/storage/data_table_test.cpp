@@ -16,6 +16,7 @@
 
 #include "executor/testing_executor_util.h"
 #include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
 #include "storage/database.h"
 
 #include "concurrency/transaction_manager_factory.h"
@@ -72,6 +73,52 @@ TEST_F(DataTableTests, TransformTileGroupTest) {
   data_table->TransformTileGroup(0, theta);
 }
 
+TEST_F(DataTableTests, TransformTileGroupLayoutTest) {
+  const int tuple_count = TESTS_TUPLES_PER_TILEGROUP;
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(tuple_count, false));
+  TestingExecutorUtil::PopulateTable(data_table.get(), tuple_count, false,
+                                     false, true, txn);
+
+  storage::column_map_type column_layout;
+  auto column_count = data_table->GetSchema()->GetColumnCount();
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    column_layout[column_itr] = std::make_pair(column_itr, 0);
+  }
+
+  // Uncommitted versions may still change
+  EXPECT_EQ(nullptr, data_table->TransformTileGroup(0, column_layout, 0.0));
+  txn_manager.CommitTransaction(txn);
+
+  // The next tile group still gets inserts
+  EXPECT_EQ(nullptr, data_table->TransformTileGroup(1, column_layout, 0.0));
+
+  auto tile_group = data_table->GetTileGroup(0);
+  auto new_tile_group =
+      data_table->TransformTileGroup(0, column_layout, 0.0);
+  ASSERT_NE(nullptr, new_tile_group);
+  EXPECT_EQ(column_count, new_tile_group->GetTileCount());
+  EXPECT_EQ(new_tile_group, data_table->GetTileGroup(0).get());
+
+  // Both tile groups share the header and have the same values
+  EXPECT_EQ(tile_group->GetHeader(), new_tile_group->GetHeader());
+  EXPECT_EQ(new_tile_group, new_tile_group->GetHeader()->GetTileGroup());
+  EXPECT_FALSE(new_tile_group->GetHeader()->IsTransforming());
+  for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+    for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+      auto expected = tile_group->GetValue(tuple_itr, column_itr);
+      auto actual = new_tile_group->GetValue(tuple_itr, column_itr);
+      EXPECT_EQ(type::CMP_TRUE, expected.CompareEquals(actual));
+    }
+  }
+
+  // Already in the layout
+  EXPECT_EQ(nullptr, data_table->TransformTileGroup(0, column_layout, 0.1));
+}
+
 std::unique_ptr<storage::DataTable> data_table_test_table;
 
 TEST_F(DataTableTests, GlobalTableTest) {
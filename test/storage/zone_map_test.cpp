@@ -0,0 +1,233 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// zone_map_test.cpp
+//
+// Identification: test/storage/zone_map_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <limits>
+
+#include "common/harness.h"
+
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/executor_context.h"
+#include "executor/logical_tile.h"
+#include "executor/seq_scan_executor.h"
+#include "executor/testing_executor_util.h"
+#include "expression/expression_util.h"
+#include "planner/seq_scan_plan.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+#include "storage/tuple.h"
+#include "storage/zone_map.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Zone Map Tests
+//===--------------------------------------------------------------------===//
+
+class ZoneMapTests : public PelotonTest {};
+
+TEST_F(ZoneMapTests, RangeTest) {
+  storage::ZoneMap zone_map({type::Type::INTEGER, type::Type::DECIMAL,
+                             type::Type::VARCHAR});
+  EXPECT_EQ(3, zone_map.GetColumnCount());
+
+  // Nothing matches a column without values
+  type::Value min_value, max_value;
+  EXPECT_FALSE(zone_map.GetRange(0, min_value, max_value));
+  EXPECT_FALSE(zone_map.MayMatch(0, ExpressionType::COMPARE_EQUAL,
+                                 type::ValueFactory::GetIntegerValue(0)));
+
+  for (int value : {-20, 5, 30}) {
+    zone_map.UpdateColumn(0, type::ValueFactory::GetIntegerValue(value));
+    zone_map.UpdateColumn(1, type::ValueFactory::GetDecimalValue(value / 4.0));
+    zone_map.UpdateColumn(2, type::ValueFactory::GetVarcharValue("abc"));
+  }
+  zone_map.UpdateColumn(
+      0, type::ValueFactory::GetNullValueByType(type::Type::INTEGER));
+
+  EXPECT_TRUE(zone_map.GetRange(0, min_value, max_value));
+  EXPECT_EQ(-20, min_value.GetAs<int32_t>());
+  EXPECT_EQ(30, max_value.GetAs<int32_t>());
+  EXPECT_TRUE(zone_map.GetRange(1, min_value, max_value));
+  EXPECT_EQ(-5.0, min_value.GetAs<double>());
+  EXPECT_EQ(7.5, max_value.GetAs<double>());
+  EXPECT_EQ(1, zone_map.GetNullCount(0));
+  EXPECT_EQ(0, zone_map.GetNullCount(1));
+
+  // Varchar columns have no range and may match anything
+  EXPECT_FALSE(zone_map.GetRange(2, min_value, max_value));
+  EXPECT_TRUE(zone_map.MayMatch(2, ExpressionType::COMPARE_EQUAL,
+                                type::ValueFactory::GetVarcharValue("xyz")));
+
+  auto integer = [](int value) {
+    return type::ValueFactory::GetIntegerValue(value);
+  };
+  EXPECT_TRUE(zone_map.MayMatch(0, ExpressionType::COMPARE_EQUAL, integer(0)));
+  EXPECT_FALSE(
+      zone_map.MayMatch(0, ExpressionType::COMPARE_EQUAL, integer(31)));
+  EXPECT_FALSE(
+      zone_map.MayMatch(0, ExpressionType::COMPARE_LESSTHAN, integer(-20)));
+  EXPECT_TRUE(zone_map.MayMatch(0, ExpressionType::COMPARE_LESSTHANOREQUALTO,
+                                integer(-20)));
+  EXPECT_FALSE(
+      zone_map.MayMatch(0, ExpressionType::COMPARE_GREATERTHAN, integer(30)));
+  EXPECT_TRUE(zone_map.MayMatch(
+      0, ExpressionType::COMPARE_GREATERTHANOREQUALTO, integer(30)));
+  EXPECT_TRUE(
+      zone_map.MayMatch(0, ExpressionType::COMPARE_NOTEQUAL, integer(5)));
+
+  // Constants of other numeric types are compared by value
+  EXPECT_FALSE(zone_map.MayMatch(0, ExpressionType::COMPARE_GREATERTHAN,
+                                 type::ValueFactory::GetDecimalValue(30.5)));
+  EXPECT_TRUE(zone_map.MayMatch(0, ExpressionType::COMPARE_LESSTHAN,
+                                type::ValueFactory::GetDecimalValue(-19.5)));
+  EXPECT_FALSE(zone_map.MayMatch(1, ExpressionType::COMPARE_LESSTHAN,
+                                 type::ValueFactory::GetBigIntValue(-5)));
+
+  // Comparisons with NULL are never true
+  EXPECT_FALSE(zone_map.MayMatch(
+      0, ExpressionType::COMPARE_EQUAL,
+      type::ValueFactory::GetNullValueByType(type::Type::INTEGER)));
+
+  type::Value no_constant;
+  EXPECT_TRUE(zone_map.MayMatch(0, ExpressionType::OPERATOR_IS_NULL,
+                                no_constant));
+  EXPECT_FALSE(zone_map.MayMatch(1, ExpressionType::OPERATOR_IS_NULL,
+                                 no_constant));
+}
+
+TEST_F(ZoneMapTests, SkipTileGroupTest) {
+  const int tuple_count = 5;
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(tuple_count, false));
+  TestingExecutorUtil::PopulateTable(table.get(), tuple_count * 4, false,
+                                     false, false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  // The first column is ten times the row, so every tile group holds its
+  // own range of it
+  for (oid_t offset = 0; offset < 4; offset++) {
+    auto zone_map = table->GetTileGroup(offset)->GetZoneMap();
+    type::Value min_value, max_value;
+    EXPECT_TRUE(zone_map->GetRange(0, min_value, max_value));
+    EXPECT_EQ(TestingExecutorUtil::PopulatedValue(offset * tuple_count, 0),
+              min_value.GetAs<int32_t>());
+    EXPECT_EQ(
+        TestingExecutorUtil::PopulatedValue((offset + 1) * tuple_count - 1, 0),
+        max_value.GetAs<int32_t>());
+  }
+
+  // Only the last tile group may hold values of the first column >= 150
+  auto predicate = expression::ExpressionUtil::ComparisonFactory(
+      ExpressionType::COMPARE_GREATERTHANOREQUALTO,
+      expression::ExpressionUtil::TupleValueFactory(type::Type::INTEGER, 0, 0),
+      expression::ExpressionUtil::ConstantValueFactory(
+          type::ValueFactory::GetIntegerValue(150)));
+  planner::SeqScanPlan node(table.get(), predicate, {0, 1});
+
+  txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+  executor::SeqScanExecutor executor(&node, context.get());
+  EXPECT_TRUE(executor.Init());
+
+  size_t result_count = 0;
+  while (executor.Execute()) {
+    std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+    for (oid_t tuple_id : *result_tile) {
+      EXPECT_LE(150, result_tile->GetValue(tuple_id, 0).GetAs<int32_t>());
+      result_count++;
+    }
+  }
+  txn_manager.CommitTransaction(txn);
+  EXPECT_EQ(tuple_count, result_count);
+
+  // The skipped tile groups were not read
+  for (oid_t offset = 0; offset < 3; offset++) {
+    EXPECT_EQ(0, table->GetTileGroup(offset)->GetHeader()->GetReadCount());
+  }
+  EXPECT_LT(0, table->GetTileGroup(3)->GetHeader()->GetReadCount());
+}
+
+TEST_F(ZoneMapTests, NaNTest) {
+  storage::ZoneMap zone_map({type::Type::DECIMAL});
+  zone_map.UpdateColumn(0, type::ValueFactory::GetDecimalValue(1.0));
+  zone_map.UpdateColumn(
+      0, type::ValueFactory::GetDecimalValue(
+             std::numeric_limits<double>::quiet_NaN()));
+
+  // A column with a NaN has no range and may match anything
+  type::Value min_value, max_value;
+  EXPECT_FALSE(zone_map.GetRange(0, min_value, max_value));
+  EXPECT_TRUE(zone_map.MayMatch(0, ExpressionType::COMPARE_GREATERTHAN,
+                                type::ValueFactory::GetDecimalValue(5.0)));
+  EXPECT_TRUE(zone_map.MayMatch(0, ExpressionType::COMPARE_LESSTHAN,
+                                type::ValueFactory::GetDecimalValue(-5.0)));
+
+  // Scans still find the values of a tile group with a NaN
+  const int tuple_count = 5;
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(tuple_count, false));
+  auto schema = table->GetSchema();
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+  for (int row = 0; row < tuple_count; row++) {
+    storage::Tuple tuple(schema, true);
+    tuple.SetValue(0, type::ValueFactory::GetIntegerValue(row), pool);
+    tuple.SetValue(1, type::ValueFactory::GetIntegerValue(row), pool);
+    tuple.SetValue(2, type::ValueFactory::GetDecimalValue(
+                          row == 0 ? std::numeric_limits<double>::quiet_NaN()
+                                   : row),
+                   pool);
+    tuple.SetValue(3, type::ValueFactory::GetVarcharValue("abc"), pool);
+    ItemPointer *index_entry_ptr = nullptr;
+    auto location = table->InsertTuple(&tuple, txn, &index_entry_ptr);
+    txn_manager.PerformInsert(txn, location, index_entry_ptr);
+  }
+  txn_manager.CommitTransaction(txn);
+
+  auto count_rows = [&](ExpressionType comparison, double constant) {
+    auto predicate = expression::ExpressionUtil::ComparisonFactory(
+        comparison, expression::ExpressionUtil::TupleValueFactory(
+                        type::Type::DECIMAL, 0, 2),
+        expression::ExpressionUtil::ConstantValueFactory(
+            type::ValueFactory::GetDecimalValue(constant)));
+    planner::SeqScanPlan node(table.get(), predicate, {0, 2});
+
+    auto txn = txn_manager.BeginTransaction();
+    std::unique_ptr<executor::ExecutorContext> context(
+        new executor::ExecutorContext(txn));
+    executor::SeqScanExecutor executor(&node, context.get());
+    EXPECT_TRUE(executor.Init());
+
+    size_t result_count = 0;
+    while (executor.Execute()) {
+      std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+      result_count += result_tile->GetTupleCount();
+    }
+    txn_manager.CommitTransaction(txn);
+    return result_count;
+  };
+  EXPECT_EQ(2, count_rows(ExpressionType::COMPARE_GREATERTHAN, 2.5));
+
+  // The NaN differs from every value
+  EXPECT_EQ(tuple_count - 1,
+            count_rows(ExpressionType::COMPARE_NOTEQUAL, 1.0));
+}
+
+}  // End test namespace
+}  // End peloton namespace
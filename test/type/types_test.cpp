@@ -136,7 +136,7 @@ TEST_F(TypesTests, StatementTypeTest) {
       StatementType::DROP,    StatementType::PREPARE,
       StatementType::EXECUTE, StatementType::RENAME,
       StatementType::ALTER,   StatementType::TRANSACTION,
-      StatementType::COPY};
+      StatementType::COPY,    StatementType::ANALYZE};
 
   // Make sure that ToString and FromString work
   for (auto val : list) {
@@ -367,7 +367,8 @@ TEST_F(TypesTests, PlanNodeTypeTest) {
       PlanNodeType::DISTINCT,    PlanNodeType::SETOP,
       PlanNodeType::APPEND,      PlanNodeType::AGGREGATE_V2,
       PlanNodeType::HASH,        PlanNodeType::RESULT,
-      PlanNodeType::COPY,        PlanNodeType::MOCK};
+      PlanNodeType::COPY,        PlanNodeType::ANALYZE,
+      PlanNodeType::MOCK};
 
   // Make sure that ToString and FromString work
   for (auto val : list) {